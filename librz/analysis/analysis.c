@@ -148,6 +148,19 @@ RZ_API void rz_analysis_plugin_free (RzAnalysisPlugin *p) {
 
 void __block_free_rb(RBNode *node, void *user);
 
+static void plugin_ctx_fini(RzAnalysis *analysis) {
+	if (analysis->cur && analysis->cur->ctx_fini && analysis->plugin_data) {
+		analysis->cur->ctx_fini (analysis->plugin_data);
+	}
+	analysis->plugin_data = NULL;
+}
+
+static void plugin_ctx_init(RzAnalysis *analysis) {
+	if (analysis->cur && analysis->cur->ctx_init) {
+		analysis->plugin_data = analysis->cur->ctx_init (analysis);
+	}
+}
+
 RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	if (!a) {
 		return NULL;
@@ -162,9 +175,12 @@ RZ_API RzAnalysis *rz_analysis_free(RzAnalysis *a) {
 	free (a->cpu);
 	free (a->os);
 	free (a->zign_path);
+	plugin_ctx_fini (a);
+	rz_analysis_op_cache_set_size (a, 0);
 	rz_list_free (a->plugins);
 	rz_rbtree_free (a->bb_tree, __block_free_rb, NULL);
 	rz_spaces_fini (&a->meta_spaces);
+	rz_sign_index_free (a->zign_index);
 	rz_spaces_fini (&a->zign_spaces);
 	rz_analysis_pin_fini (a);
 	rz_syscall_free (a->syscall);
@@ -211,7 +227,11 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 				return true;
 			}
 #endif
-			analysis->cur = h;
+			if (analysis->cur != h) {
+				plugin_ctx_fini (analysis);
+				analysis->cur = h;
+				plugin_ctx_init (analysis);
+			}
 			rz_analysis_set_reg_profile (analysis);
 			return true;
 		}
@@ -219,6 +239,38 @@ RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name) {
 	return false;
 }
 
+// Makes local a shallow copy of analysis with its own decoder state and
+// registers, so that a reentrant plugin can decode on it in another thread.
+// Nothing else is duplicated: the copy is only meant for
+// rz_analysis_op_decode (). The io is not reachable from the copy, the caller
+// may set its own read_at.
+RZ_API bool rz_analysis_thread_init(RzAnalysis *local, RzAnalysis *analysis) {
+	rz_return_val_if_fail (local && analysis, false);
+	*local = *analysis;
+	local->op_table = NULL;
+	local->op_cache = NULL;
+	local->plugin_data = NULL;
+	local->read_at = NULL;
+	memset (&local->iob, 0, sizeof (local->iob));
+	local->reg = rz_reg_new ();
+	if (!local->reg) {
+		return false;
+	}
+	if (analysis->reg && analysis->reg->reg_profile_str) {
+		rz_reg_set_profile_string (local->reg, analysis->reg->reg_profile_str);
+	}
+	plugin_ctx_init (local);
+	return !local->cur || !local->cur->ctx_init || local->plugin_data;
+}
+
+RZ_API void rz_analysis_thread_fini(RzAnalysis *local) {
+	if (local) {
+		plugin_ctx_fini (local);
+		rz_reg_free (local->reg);
+		local->reg = NULL;
+	}
+}
+
 RZ_API char *rz_analysis_get_reg_profile(RzAnalysis *analysis) {
 	return (analysis && analysis->cur && analysis->cur->get_reg_profile)
 		? analysis->cur->get_reg_profile (analysis) : NULL;
@@ -293,6 +345,10 @@ RZ_API bool rz_analysis_set_bits(RzAnalysis *analysis, int bits) {
 }
 
 RZ_API void rz_analysis_set_cpu(RzAnalysis *analysis, const char *cpu) {
+	if (rz_str_cmp (analysis->cpu, cpu, -1)) {
+		// the cached ops are only keyed by plugin, bits and endianness
+		rz_analysis_op_cache_clear (analysis);
+	}
 	free (analysis->cpu);
 	analysis->cpu = cpu ? strdup (cpu) : NULL;
 	int v = rz_analysis_archinfo (analysis, RZ_ANALYSIS_ARCHINFO_ALIGN);
@@ -417,6 +473,7 @@ RZ_API void rz_analysis_purge(RzAnalysis *analysis) {
 	rz_interval_tree_init (&analysis->meta, rz_meta_item_free);
 	sdb_reset (analysis->sdb_types);
 	sdb_reset (analysis->sdb_zigns);
+	rz_sign_index_invalidate (analysis);
 	sdb_reset (analysis->sdb_classes);
 	sdb_reset (analysis->sdb_classes_attrs);
 	rz_analysis_pin_fini (analysis);
@@ -3,6 +3,7 @@
 #include <rz_analysis.h>
 #include <rz_util.h>
 #include <rz_diff.h>
+#include <rz_th.h>
 
 RZ_API RzAnalysisDiff *rz_analysis_diff_new(void) {
 	RzAnalysisDiff *diff = RZ_NEW0 (RzAnalysisDiff);
@@ -106,6 +107,31 @@ RZ_API size_t rz_analysis_diff_fingerprint_fcn(RzAnalysis *analysis, RzAnalysisF
 	return fcn->fingerprint_size;
 }
 
+// Fingerprints that rz_diff_buffers_distance () would rate 1
+static bool fingerprint_equal(const ut8 *a, size_t la, const ut8 *b, size_t lb) {
+	return la == lb && (!la || (a && b && !memcmp (a, b, la)));
+}
+
+// Exact above th, only known to be below it otherwise
+static double fingerprint_similarity(const ut8 *a, size_t la, const ut8 *b, size_t lb, double th) {
+	RzDiff diff = { .threshold = th };
+	double t = 0;
+	if (!la && !lb) {
+		return 1;
+	}
+	if (!rz_diff_buffers_distance (&diff, a, la, b, lb, NULL, &t)) {
+		return 0;
+	}
+	return t;
+}
+
+// The edit distance is at least the difference in length, so two buffers
+// cannot be more similar than min/max
+static bool fingerprint_can_reach(size_t la, size_t lb, double th) {
+	size_t max = RZ_MAX (la, lb);
+	return !max || (double)RZ_MIN (la, lb) / max > th;
+}
+
 RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2) {
 	RzAnalysisBlock *bb, *bb2, *mbb, *mbb2;
 	RzListIter *iter, *iter2;
@@ -124,17 +150,29 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 		}
 		ot = 0;
 		mbb = mbb2 = NULL;
+		// an identical block wins anyway, look for it before any distance
 		rz_list_foreach (fcn2->bbs, iter2, bb2) {
-			if (!bb2->diff || bb2->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				rz_diff_buffers_distance (NULL, bb->fingerprint, bb->size,
-						bb2->fingerprint, bb2->size, NULL, &t);
+			if ((!bb2->diff || bb2->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL) &&
+				fingerprint_equal (bb->fingerprint, bb->size, bb2->fingerprint, bb2->size)) {
+				ot = 1;
+				mbb = bb;
+				mbb2 = bb2;
+				break;
+			}
+		}
+		if (!mbb) {
+			rz_list_foreach (fcn2->bbs, iter2, bb2) {
+				if (bb2->diff && bb2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+					continue;
+				}
+				if (!fingerprint_can_reach (bb->size, bb2->size, RZ_MAX (analysis->diff_thbb, ot))) {
+					continue;
+				}
+				t = fingerprint_similarity (bb->fingerprint, bb->size, bb2->fingerprint, bb2->size, RZ_MAX (analysis->diff_thbb, ot));
 				if (t > analysis->diff_thbb && t > ot) {
 					ot = t;
 					mbb = bb;
 					mbb2 = bb2;
-					if (t == 1) {
-						break;
-					}
 				}
 			}
 		}
@@ -148,7 +186,7 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 			if (!mbb->diff || !mbb2->diff) {
 				return false;
 			}
-			if (ot == 1 || t > analysis->diff_thfcn) {
+			if (ot == 1 || ot > analysis->diff_thfcn) {
 				mbb->diff->type = mbb2->diff->type = RZ_ANALYSIS_DIFF_TYPE_MATCH;
 			} else {
 				mbb->diff->type = mbb2->diff->type = \
@@ -170,11 +208,245 @@ RZ_API bool rz_analysis_diff_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, R
 	return true;
 }
 
+// Distances computed for one unmatched function, at most this many
+#define DIFF_CANDIDATES 16
+#define DIFF_THREADS 16
+
+// What the function matching needs to know about a function, computed once
+typedef struct {
+	RzAnalysisFunction *fcn;
+	ut64 hash; // of the fingerprint
+	ut64 shape; // basic blocks, edges and calls
+	ut64 size; // linear size
+	size_t idx; // position in the list, keeps the list order on ties
+	bool named; // already paired by name
+} DiffFcn;
+
+typedef struct {
+	DiffFcn *a;
+	DiffFcn *cand[DIFF_CANDIDATES];
+	double t[DIFF_CANDIDATES];
+	int ncand;
+} DiffJob;
+
+typedef struct {
+	DiffJob *jobs;
+	size_t njobs;
+	size_t next;
+	RzThreadLock *lock;
+	double threshold; // below it only the fact that it is below matters
+} DiffWork;
+
+static ut64 fingerprint_hash(const ut8 *buf, size_t len) {
+	ut64 h = 0xcbf29ce484222325ULL;
+	size_t i;
+	for (i = 0; buf && i < len; i++) {
+		h = (h ^ buf[i]) * 0x100000001b3ULL;
+	}
+	return h ^ len;
+}
+
+static void diff_fcn_init(DiffFcn *d, RzAnalysisFunction *fcn, size_t idx) {
+	RzAnalysisRef *ref;
+	RzListIter *iter;
+	ut64 calls = 0;
+	RzList *refs = rz_analysis_function_get_refs (fcn);
+	rz_list_foreach (refs, iter, ref) {
+		calls += ref->type == RZ_ANALYSIS_REF_TYPE_CALL;
+	}
+	rz_list_free (refs);
+	ut64 bbs = rz_list_length (fcn->bbs);
+	ut64 edges = rz_analysis_function_count_edges (fcn, NULL);
+	d->fcn = fcn;
+	d->hash = fingerprint_hash (fcn->fingerprint, fcn->fingerprint_size);
+	d->shape = RZ_MIN (bbs, 0xfffff) | (RZ_MIN (edges, 0xfffff) << 20) | (RZ_MIN (calls, 0xffffff) << 40);
+	d->size = rz_analysis_function_linear_size (fcn);
+	d->idx = idx;
+	d->named = false;
+}
+
+static bool diff_fcn_free(const DiffFcn *d) {
+	return d->fcn->diff->type == RZ_ANALYSIS_DIFF_TYPE_NULL;
+}
+
+// Functions too different in size are never compared
+static bool diff_fcn_size_ok(RzAnalysis *analysis, const DiffFcn *a, const DiffFcn *b) {
+	ut64 maxsize = RZ_MAX (a->size, b->size);
+	ut64 minsize = RZ_MIN (a->size, b->size);
+	return !(maxsize * analysis->diff_thfcn > minsize);
+}
+
+static int diff_fcn_cmp_hash(const void *x, const void *y) {
+	const DiffFcn *a = *(const DiffFcn **)x, *b = *(const DiffFcn **)y;
+	if (a->hash != b->hash) {
+		return a->hash < b->hash ? -1 : 1;
+	}
+	return a->idx < b->idx ? -1 : a->idx > b->idx;
+}
+
+static int diff_fcn_cmp_size(const void *x, const void *y) {
+	const DiffFcn *a = *(const DiffFcn **)x, *b = *(const DiffFcn **)y;
+	if (a->fcn->fingerprint_size != b->fcn->fingerprint_size) {
+		return a->fcn->fingerprint_size < b->fcn->fingerprint_size ? -1 : 1;
+	}
+	return a->idx < b->idx ? -1 : a->idx > b->idx;
+}
+
+static int diff_fcn_cmp_shape(const void *x, const void *y) {
+	const DiffFcn *a = *(const DiffFcn **)x, *b = *(const DiffFcn **)y;
+	if (a->shape != b->shape) {
+		return a->shape < b->shape ? -1 : 1;
+	}
+	return diff_fcn_cmp_size (x, y);
+}
+
+static int diff_fcn_cmp_shape_key(const void *x, const void *y) {
+	const DiffFcn *a = *(const DiffFcn **)x, *b = *(const DiffFcn **)y;
+	return a->shape < b->shape ? -1 : a->shape > b->shape;
+}
+
+static int diff_cand_cmp_idx(const void *x, const void *y) {
+	const DiffFcn *a = *(const DiffFcn **)x, *b = *(const DiffFcn **)y;
+	return a->idx < b->idx ? -1 : a->idx > b->idx;
+}
+
+// First index in sorted[lo, hi) whose key is not below d's
+static size_t diff_lower_bound(DiffFcn **sorted, size_t lo, size_t hi, const DiffFcn *d, int (*cmp)(const void *, const void *)) {
+	while (lo < hi) {
+		size_t m = lo + (hi - lo) / 2;
+		if (cmp (&sorted[m], &d) < 0) {
+			lo = m + 1;
+		} else {
+			hi = m;
+		}
+	}
+	return lo;
+}
+
+static bool diff_job_has(DiffJob *job, DiffFcn *d) {
+	int i;
+	for (i = 0; i < job->ncand; i++) {
+		if (job->cand[i] == d) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Adds to job the functions of sorted[lo, hi), which is sorted by
+// fingerprint size, closest in size to job->a first, up to max of them
+static void diff_job_gather(RzAnalysis *analysis, DiffJob *job, DiffFcn **sorted, size_t lo, size_t hi, int max) {
+	size_t size = job->a->fcn->fingerprint_size;
+	size_t r = diff_lower_bound (sorted, lo, hi, job->a, diff_fcn_cmp_size);
+	size_t l = r;
+	while (job->ncand < max && (l > lo || r < hi)) {
+		DiffFcn *d;
+		if (l > lo && (r >= hi || size - sorted[l - 1]->fcn->fingerprint_size <= sorted[r]->fcn->fingerprint_size - size)) {
+			d = sorted[--l];
+		} else {
+			d = sorted[r++];
+		}
+		if (!fingerprint_can_reach (size, d->fcn->fingerprint_size, analysis->diff_thfcn)) {
+			// sizes only get further away on this side
+			if (d->fcn->fingerprint_size < size) {
+				l = lo;
+			} else {
+				r = hi;
+			}
+			continue;
+		}
+		if (diff_fcn_size_ok (analysis, job->a, d) && !diff_job_has (job, d)) {
+			job->cand[job->ncand++] = d;
+		}
+	}
+}
+
+static void diff_work(DiffWork *w) {
+	for (;;) {
+		if (w->lock) {
+			rz_th_lock_enter (w->lock);
+		}
+		size_t i = w->next++;
+		if (w->lock) {
+			rz_th_lock_leave (w->lock);
+		}
+		if (i >= w->njobs) {
+			break;
+		}
+		DiffJob *job = &w->jobs[i];
+		RzAnalysisFunction *fcn = job->a->fcn;
+		int j;
+		for (j = 0; j < job->ncand; j++) {
+			RzAnalysisFunction *fcn2 = job->cand[j]->fcn;
+			job->t[j] = fingerprint_similarity (fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, w->threshold);
+		}
+	}
+}
+
+static RzThreadFunctionRet diff_work_th(RzThread *th) {
+	diff_work (th->user);
+	return RZ_TH_STOP;
+}
+
+// Computes the similarity of every candidate of every job, the jobs are
+// spread over threads since they only read the fingerprints
+static void diff_jobs_run(DiffJob *jobs, size_t njobs, double threshold) {
+	RzThread *threads[DIFF_THREADS] = { 0 };
+	DiffWork w = { jobs, njobs, 0, NULL, threshold };
+	// the calling thread works too
+	int i, nthreads = RZ_MIN (rz_th_cpu_count (), DIFF_THREADS) - 1;
+	if ((size_t)nthreads >= njobs) {
+		nthreads = njobs ? njobs - 1 : 0;
+	}
+	if (nthreads > 0) {
+		w.lock = rz_th_lock_new (false);
+	}
+	for (i = 0; w.lock && i < nthreads; i++) {
+		threads[i] = rz_th_new (diff_work_th, &w, 0);
+	}
+	diff_work (&w);
+	for (i = 0; i < nthreads; i++) {
+		if (threads[i]) {
+			rz_th_wait (threads[i]);
+			rz_th_free (threads[i]);
+		}
+	}
+	rz_th_lock_free (w.lock);
+}
+
+static void diff_fcn_match(RzAnalysis *analysis, RzAnalysisFunction *fcn, RzAnalysisFunction *fcn2, double t) {
+	/* Set flag in matched functions */
+	fcn->diff->type = fcn2->diff->type = (t >= 1)
+		? RZ_ANALYSIS_DIFF_TYPE_MATCH
+		: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
+	fcn->diff->dist = fcn2->diff->dist = t;
+	RZ_FREE (fcn->fingerprint);
+	RZ_FREE (fcn2->fingerprint);
+	fcn->diff->addr = fcn2->addr;
+	fcn2->diff->addr = fcn->addr;
+	fcn->diff->size = rz_analysis_function_linear_size (fcn2);
+	fcn2->diff->size = rz_analysis_function_linear_size (fcn);
+	RZ_FREE (fcn->diff->name);
+	if (fcn2->name) {
+		fcn->diff->name = strdup (fcn2->name);
+	}
+	RZ_FREE (fcn2->diff->name);
+	if (fcn->name) {
+		fcn2->diff->name = strdup (fcn->name);
+	}
+	rz_analysis_diff_bb (analysis, fcn, fcn2);
+}
+
+/*
+ * Functions are paired by name first, then by identical fingerprint, and
+ * the rest against a few candidates: the ones with the same number of
+ * blocks, edges and calls and the closest in fingerprint size. Only those
+ * pairs get an edit distance, computed in parallel.
+ */
 RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns2) {
-	RzAnalysisFunction *fcn, *fcn2, *mfcn, *mfcn2;
-	RzListIter *iter, *iter2;
-	ut64 maxsize, minsize;
-	double t, ot;
+	RzAnalysisFunction *fcn;
+	RzListIter *iter;
+	size_t i, j, na, nb, nfree, njobs;
 
 	if (!analysis) {
 		return false;
@@ -182,110 +454,136 @@ RZ_API int rz_analysis_diff_fcn(RzAnalysis *analysis, RzList *fcns, RzList *fcns
 	if (analysis->cur && analysis->cur->diff_fcn) {
 		return (analysis->cur->diff_fcn (analysis, fcns, fcns2));
 	}
+	na = fcns ? rz_list_length (fcns) : 0;
+	nb = fcns2 ? rz_list_length (fcns2) : 0;
+	if (!na || !nb) {
+		return true;
+	}
+	DiffFcn *fa = RZ_NEWS0 (DiffFcn, na);
+	DiffFcn *fb = RZ_NEWS0 (DiffFcn, nb);
+	DiffFcn **by_hash = RZ_NEWS0 (DiffFcn *, nb);
+	DiffFcn **by_size = RZ_NEWS0 (DiffFcn *, nb);
+	DiffFcn **by_shape = RZ_NEWS0 (DiffFcn *, nb);
+	DiffJob *jobs = RZ_NEWS0 (DiffJob, na);
+	HtPP *names = ht_pp_new0 ();
+	bool ret = false;
+	if (!fa || !fb || !by_hash || !by_size || !by_shape || !jobs || !names) {
+		goto beach;
+	}
+	i = 0;
+	rz_list_foreach (fcns, iter, fcn) {
+		diff_fcn_init (&fa[i], fcn, i);
+		i++;
+	}
+	i = 0;
+	rz_list_foreach (fcns2, iter, fcn) {
+		diff_fcn_init (&fb[i], fcn, i);
+		if (fcn->name) {
+			// the first one wins, like the list walk it replaces
+			ht_pp_insert (names, fcn->name, &fb[i]);
+		}
+		i++;
+	}
+
 	/* Compare functions with the same name */
-	if (fcns) {
-		rz_list_foreach (fcns, iter, fcn) {
-			rz_list_foreach (fcns2, iter2, fcn2) {
-				if (fcn->name && fcn2->name && strcmp (fcn->name, fcn2->name)) {
-					continue;
-				}
-				rz_diff_buffers_distance (NULL, fcn->fingerprint, fcn->fingerprint_size,
-						fcn2->fingerprint, fcn2->fingerprint_size,
-						NULL, &t);
-				/* Set flag in matched functions */
-				fcn->diff->type = fcn2->diff->type = (t >= 1)
-					? RZ_ANALYSIS_DIFF_TYPE_MATCH
-					: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-				fcn->diff->dist = fcn2->diff->dist = t;
-				RZ_FREE (fcn->fingerprint);
-				RZ_FREE (fcn2->fingerprint);
-				fcn->diff->addr = fcn2->addr;
-				fcn2->diff->addr = fcn->addr;
-				fcn->diff->size = rz_analysis_function_linear_size (fcn2);
-				fcn2->diff->size = rz_analysis_function_linear_size (fcn);
-				RZ_FREE (fcn->diff->name);
-				if (fcn2->name) {
-					fcn->diff->name = strdup (fcn2->name);
-				}
-				RZ_FREE (fcn2->diff->name);
-				if (fcn->name) {
-					fcn2->diff->name = strdup (fcn->name);
-				}
-				rz_analysis_diff_bb (analysis, fcn, fcn2);
-				break;
-			}
+	njobs = 0;
+	for (i = 0; i < na; i++) {
+		if (!fa[i].fcn->name) {
+			continue;
+		}
+		DiffFcn *b = ht_pp_find (names, fa[i].fcn->name, NULL);
+		if (!b || b->named) {
+			continue;
 		}
+		fa[i].named = b->named = true;
+		DiffJob *job = &jobs[njobs++];
+		job->a = &fa[i];
+		job->cand[0] = b;
+		job->ncand = 1;
+	}
+	// the distance of a name pair is kept in diff->dist, it must be exact
+	diff_jobs_run (jobs, njobs, 0);
+	for (i = 0; i < njobs; i++) {
+		diff_fcn_match (analysis, jobs[i].a->fcn, jobs[i].cand[0]->fcn, jobs[i].t[0]);
 	}
+
 	/* Compare remaining functions */
-	rz_list_foreach (fcns, iter, fcn) {
-/*
-		if ((fcn->type != RZ_ANALYSIS_FCN_TYPE_FCN &&
-			fcn->type != RZ_ANALYSIS_FCN_TYPE_SYM) ||
-			fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-			continue;
+	nfree = 0;
+	for (i = 0; i < nb; i++) {
+		RzAnalysisFunction *fcn2 = fb[i].fcn;
+		if (diff_fcn_free (&fb[i]) && (fcn2->type == RZ_ANALYSIS_FCN_TYPE_FCN || fcn2->type == RZ_ANALYSIS_FCN_TYPE_SYM)) {
+			by_hash[nfree++] = &fb[i];
 		}
-*/
-		if (fcn->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
+	}
+	qsort (by_hash, nfree, sizeof (DiffFcn *), diff_fcn_cmp_hash);
+	// identical fingerprints are paired without any distance
+	for (i = 0; i < na; i++) {
+		if (!diff_fcn_free (&fa[i])) {
 			continue;
 		}
-		ot = 0;
-		mfcn = mfcn2 = NULL;
-		rz_list_foreach (fcns2, iter2, fcn2) {
-			ut64 fcn_size = rz_analysis_function_linear_size (fcn);
-			ut64 fcn2_size = rz_analysis_function_linear_size (fcn2);
-			if (fcn_size > fcn2_size) {
-				maxsize = fcn_size;
-				minsize = fcn2_size;
-			} else {
-				maxsize = fcn2_size;
-				minsize = fcn_size;
-			}
-			if (maxsize * analysis->diff_thfcn > minsize) {
-				eprintf ("Exceeded analysis threshold while diffing %s and %s\n", fcn->name, fcn2->name);
-				continue;
-			}
-			if (fcn2->diff->type != RZ_ANALYSIS_DIFF_TYPE_NULL) {
-				eprintf ("Function %s already diffed\n", fcn2->name);
-				continue;
-			}
-			if ((fcn2->type != RZ_ANALYSIS_FCN_TYPE_FCN && fcn2->type != RZ_ANALYSIS_FCN_TYPE_SYM)) {
-				eprintf ("Function %s type not supported\n", fcn2->name);
-				continue;
-			}
-			rz_diff_buffers_distance (NULL, fcn->fingerprint, fcn->fingerprint_size, fcn2->fingerprint, fcn2->fingerprint_size, NULL, &t);
-			fcn->diff->dist = fcn2->diff->dist = t;
-			if (t > analysis->diff_thfcn && t > ot) {
-				ot = t;
-				mfcn = fcn;
-				mfcn2 = fcn2;
-				if (t == 1) {
-					break;
-				}
+		for (j = diff_lower_bound (by_hash, 0, nfree, &fa[i], diff_fcn_cmp_hash); j < nfree && by_hash[j]->hash == fa[i].hash; j++) {
+			DiffFcn *b = by_hash[j];
+			if (diff_fcn_free (b) && diff_fcn_size_ok (analysis, &fa[i], b) &&
+				fingerprint_equal (fa[i].fcn->fingerprint, fa[i].fcn->fingerprint_size, b->fcn->fingerprint, b->fcn->fingerprint_size)) {
+				diff_fcn_match (analysis, fa[i].fcn, b->fcn, 1);
+				break;
 			}
 		}
-		if (mfcn && mfcn2) {
-			/* Set flag in matched functions */
-			mfcn->diff->type = mfcn2->diff->type = (ot == 1)
-				? RZ_ANALYSIS_DIFF_TYPE_MATCH
-				: RZ_ANALYSIS_DIFF_TYPE_UNMATCH;
-			RZ_FREE (mfcn->fingerprint);
-			RZ_FREE (mfcn2->fingerprint);
-			mfcn->diff->addr = mfcn2->addr;
-			mfcn2->diff->addr = mfcn->addr;
-			mfcn->diff->size = rz_analysis_function_linear_size (mfcn2);
-			mfcn2->diff->size = rz_analysis_function_linear_size (mfcn);
-			RZ_FREE (mfcn->diff->name);
-			if (mfcn2->name) {
-				mfcn->diff->name = strdup (mfcn2->name);
-			}
-			RZ_FREE (mfcn2->diff->name);
-			if (mfcn->name) {
-				mfcn2->diff->name = strdup (mfcn->name);
+	}
+	j = 0;
+	for (i = 0; i < nfree; i++) {
+		if (diff_fcn_free (by_hash[i])) {
+			by_size[j] = by_shape[j] = by_hash[i];
+			j++;
+		}
+	}
+	nfree = j;
+	qsort (by_size, nfree, sizeof (DiffFcn *), diff_fcn_cmp_size);
+	qsort (by_shape, nfree, sizeof (DiffFcn *), diff_fcn_cmp_shape);
+	njobs = 0;
+	for (i = 0; i < na; i++) {
+		if (!diff_fcn_free (&fa[i])) {
+			continue;
+		}
+		DiffJob *job = &jobs[njobs];
+		memset (job, 0, sizeof (*job));
+		job->a = &fa[i];
+		// half from the same shape, the rest from anywhere
+		DiffFcn next = { .shape = fa[i].shape + 1 };
+		size_t lo = diff_lower_bound (by_shape, 0, nfree, &fa[i], diff_fcn_cmp_shape_key);
+		size_t hi = diff_lower_bound (by_shape, lo, nfree, &next, diff_fcn_cmp_shape_key);
+		diff_job_gather (analysis, job, by_shape, lo, hi, DIFF_CANDIDATES / 2);
+		diff_job_gather (analysis, job, by_size, 0, nfree, DIFF_CANDIDATES);
+		if (job->ncand) {
+			qsort (job->cand, job->ncand, sizeof (DiffFcn *), diff_cand_cmp_idx);
+			njobs++;
+		}
+	}
+	diff_jobs_run (jobs, njobs, analysis->diff_thfcn);
+	for (i = 0; i < njobs; i++) {
+		DiffJob *job = &jobs[i];
+		double ot = 0;
+		int best = -1, k;
+		for (k = 0; k < job->ncand; k++) {
+			if (diff_fcn_free (job->cand[k]) && job->t[k] > analysis->diff_thfcn && job->t[k] > ot) {
+				ot = job->t[k];
+				best = k;
 			}
-			rz_analysis_diff_bb (analysis, mfcn, mfcn2);
+		}
+		if (best >= 0) {
+			diff_fcn_match (analysis, job->a->fcn, job->cand[best]->fcn, ot);
 		}
 	}
-	return true;
+	ret = true;
+beach:
+	ht_pp_free (names);
+	free (jobs);
+	free (by_shape);
+	free (by_size);
+	free (by_hash);
+	free (fb);
+	free (fa);
+	return ret;
 }
 
 RZ_API int rz_analysis_diff_eval(RzAnalysis *analysis) {
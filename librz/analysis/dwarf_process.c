@@ -11,7 +11,7 @@ typedef struct dwarf_parse_context_t {
 	const RzBinDwarfDie *all_dies;
 	const ut64 count;
 	Sdb *sdb;
-	HtUP/*<ut64 offset, DwarfDie *die>*/ *die_map;
+	RzBinDwarfDebugInfo *info; // DIEs referenced by offset
 	HtUP/*<offset, RzBinDwarfLocList*>*/  *locations;
 	char *lang; // for demangling
 } Context;
@@ -256,7 +256,7 @@ static st32 parse_array_type(Context *ctx, ut64 idx, RzStrBuf *strbuf) {
  */
 static st32 parse_type (Context *ctx, const ut64 offset, RzStrBuf *strbuf, ut64 *size) {
 	rz_return_val_if_fail (strbuf, -1);
-	RzBinDwarfDie *die = ht_up_find (ctx->die_map, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_info_get_die (ctx->info, offset);
 	if (!die) {
 		return -1;
 	}
@@ -513,7 +513,7 @@ static void parse_structure_type(Context *ctx, ut64 idx) {
 	// if it is definition of previous declaration (TODO Fix, big ugly hotfix addition)
 	st32 spec_attr_idx = find_attr_idx (die, DW_AT_specification);
 	if (spec_attr_idx != -1) {
-		RzBinDwarfDie *decl_die = ht_up_find (ctx->die_map, die->attr_values[spec_attr_idx].reference, NULL);
+		RzBinDwarfDie *decl_die = rz_bin_dwarf_info_get_die (ctx->info, die->attr_values[spec_attr_idx].reference);
 		if (!decl_die) {
 			goto cleanup;
 		}
@@ -757,7 +757,7 @@ static bool prefer_linkage_name(char *lang) {
 }
 
 static void parse_abstract_origin(Context *ctx, ut64 offset, RzStrBuf *type, const char **name) {
-	RzBinDwarfDie *die = ht_up_find (ctx->die_map, offset, NULL);
+	RzBinDwarfDie *die = rz_bin_dwarf_info_get_die (ctx->info, offset);
 	if (die) {
 		size_t i;
 		ut64 size = 0;
@@ -1354,7 +1354,7 @@ static void parse_function(Context *ctx, ut64 idx) {
 			break;
 		case DW_AT_specification: /* reference to declaration DIE with more info */
 		{
-			RzBinDwarfDie *spec_die = ht_up_find (ctx->die_map, val->reference, NULL);
+			RzBinDwarfDie *spec_die = rz_bin_dwarf_info_get_die (ctx->info, val->reference);
 			if (spec_die) {
 				fcn.name = get_specification_die_name (spec_die); /* I assume that if specification has a name, this DIE hasn't */
 				get_spec_die_type (ctx, spec_die, &ret_type);
@@ -1529,14 +1529,19 @@ RZ_API void rz_analysis_dwarf_process_info(const RzAnalysis *analysis, RzAnalysi
 	rz_return_if_fail (ctx && analysis);
 	Sdb *dwarf_sdb =  sdb_ns (analysis->sdb, "dwarf", 1);
 	size_t i, j;
-	const RzBinDwarfDebugInfo *info = ctx->info;
+	RzBinDwarfDebugInfo *info = ctx->info;
+	// the units are parsed in parallel before walking them
+	rz_bin_dwarf_info_load_all (info);
 	for (i = 0; i < info->count; i++) {
 		RzBinDwarfCompUnit *unit = &info->comp_units[i];
+		if (!unit->dies) {
+			continue;
+		}
 		Context dw_context = { // context per unit?
 			.analysis = analysis,
 			.all_dies = unit->dies,
 			.count = unit->count,
-			.die_map = info->lookup_table,
+			.info = info,
 			.sdb = dwarf_sdb,
 			.locations = ctx->loc,
 			.lang = NULL
@@ -61,16 +61,7 @@ static bool isregornum(RzAnalysisEsil *esil, const char *str, ut64 *num) {
 	return true;
 }
 
-/* pop Register or Number */
-static bool popRN(RzAnalysisEsil *esil, ut64 *n) {
-	char *str = rz_analysis_esil_pop (esil);
-	if (str) {
-		bool ret = isregornum (esil, str, n);
-		free (str);
-		return ret;
-	}
-	return false;
-}
+static void esil_code_cache_flush(RzAnalysisEsil *esil);
 
 /* RZ_ANALYSIS_ESIL API */
 
@@ -88,7 +79,7 @@ RZ_API RzAnalysisEsil *rz_analysis_esil_new(int stacksize, int iotrap, unsigned
 		free (esil);
 		return NULL;
 	}
-	if (!(esil->stack = calloc (sizeof (char *), stacksize))) {
+	if (!(esil->stack = calloc (sizeof (RzAnalysisEsilValue), stacksize))) {
 		free (esil);
 		return NULL;
 	}
@@ -122,6 +113,8 @@ RZ_API bool rz_analysis_esil_set_op(RzAnalysisEsil *esil, const char *op, RzAnal
 	eop->pop = pop;
 	eop->type = type;
 	eop->code = code;
+	// the word may have been compiled as a push
+	esil_code_cache_flush (esil);
 	return true;
 }
 
@@ -171,6 +164,7 @@ RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil) {
 	esil->stats = NULL;
 	rz_analysis_esil_stack_free (esil);
 	free (esil->stack);
+	ht_pp_free (esil->code_cache);
 	if (esil->analysis && esil->analysis->cur && esil->analysis->cur->esil_fini) {
 		esil->analysis->cur->esil_fini (esil);
 	}
@@ -414,26 +408,86 @@ static int internal_esil_reg_write_no_null (RzAnalysisEsil *esil, const char *re
 	return false;
 }
 
+/* Stack values. Numbers are kept as such and only turned into strings when
+ * popped with rz_analysis_esil_pop, registers pushed by compiled code carry
+ * the RzRegItem they were resolved to. */
+
+static void esil_value_fini(RzAnalysisEsilValue *v) {
+	if (v->owned) {
+		free (v->str);
+	}
+	v->type = RZ_ANALYSIS_ESIL_VALUE_NONE;
+	v->owned = false;
+	v->str = NULL;
+	v->reg = NULL;
+}
+
+// the string form of v, as the string only stack used to hold it
+static const char *esil_value_str(RzAnalysisEsilValue *v) {
+	if (!v->str && v->type == RZ_ANALYSIS_ESIL_VALUE_NUM) {
+		v->str = rz_str_newf ("0x%" PFMT64x, v->num);
+		v->owned = true;
+	}
+	return v->str;
+}
+
+// makes v independent from the code that pushed it
+static void esil_value_own(RzAnalysisEsilValue *v) {
+	if (v->str && !v->owned) {
+		v->str = strdup (v->str);
+		v->owned = true;
+	}
+	v->reg = NULL;
+}
+
+static bool esil_push_value(RzAnalysisEsil *esil, const RzAnalysisEsilValue *v) {
+	if (esil->stackptr > (esil->stacksize - 1)) {
+		return false;
+	}
+	esil->stack[esil->stackptr++] = *v;
+	return true;
+}
+
+static bool esil_pop_value(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	if (esil->stackptr < 1) {
+		memset (v, 0, sizeof (*v));
+		return false;
+	}
+	*v = esil->stack[--esil->stackptr];
+	return true;
+}
+
+// register items resolved by compiled code are still valid
+static inline bool esil_reg_fresh(RzAnalysisEsil *esil) {
+	return esil->analysis && esil->analysis->reg && esil->analysis->reg->gen == esil->code_gen;
+}
+
+static inline RzRegItem *esil_value_reg(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	return v->type == RZ_ANALYSIS_ESIL_VALUE_REG && v->reg && esil_reg_fresh (esil)? v->reg: NULL;
+}
+
 RZ_API bool rz_analysis_esil_pushnum(RzAnalysisEsil *esil, ut64 num) {
-	char str[64];
-	snprintf (str, sizeof (str) - 1, "0x%" PFMT64x, num);
-	return rz_analysis_esil_push (esil, str);
+	rz_return_val_if_fail (esil, false);
+	RzAnalysisEsilValue v = { RZ_ANALYSIS_ESIL_VALUE_NUM, false, num, NULL, NULL };
+	return esil_push_value (esil, &v);
 }
 
 RZ_API bool rz_analysis_esil_push(RzAnalysisEsil *esil, const char *str) {
 	if (!str || !esil || !*str || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
-	esil->stack[esil->stackptr++] = strdup (str);
-	return true;
+	RzAnalysisEsilValue v = { RZ_ANALYSIS_ESIL_VALUE_STR, true, 0, NULL, strdup (str) };
+	return v.str && esil_push_value (esil, &v);
 }
 
 RZ_API char *rz_analysis_esil_pop(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail (esil, NULL);
-	if (esil->stackptr < 1) {
+	RzAnalysisEsilValue v;
+	if (!esil_pop_value (esil, &v) || !esil_value_str (&v)) {
+		esil_value_fini (&v);
 		return NULL;
 	}
-	return esil->stack[--esil->stackptr];
+	return v.owned? v.str: strdup (v.str);
 }
 
 RZ_API int rz_analysis_esil_get_parm_type(RzAnalysisEsil *esil, const char *str) {
@@ -538,37 +592,156 @@ RZ_API int rz_analysis_esil_reg_read(RzAnalysisEsil *esil, const char *regname,
 	return ret;
 }
 
+/* Typed counterparts of the parameter helpers above, working on popped
+ * values. They only take shortcuts when the result is the same as going
+ * through the string form: numbers are not parsed again and registers
+ * resolved by compiled code are accessed directly as long as no hook nor
+ * custom callback is involved. */
+
+static int esil_value_type(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	switch (v->type) {
+	case RZ_ANALYSIS_ESIL_VALUE_NONE:
+		return RZ_ANALYSIS_ESIL_PARM_INVALID;
+	case RZ_ANALYSIS_ESIL_VALUE_NUM:
+		return RZ_ANALYSIS_ESIL_PARM_NUM;
+	default:
+		if (esil_value_reg (esil, v)) {
+			return RZ_ANALYSIS_ESIL_PARM_REG;
+		}
+		return rz_analysis_esil_get_parm_type (esil, v->str);
+	}
+}
+
+static bool esil_value_reg_read(RzAnalysisEsil *esil, RzAnalysisEsilValue *v, ut64 *num, int *size) {
+	RzRegItem *ri = esil_value_reg (esil, v);
+	if (ri && !esil->cb.hook_reg_read && esil->cb.reg_read == internal_esil_reg_read) {
+		*num = rz_reg_get_value (esil->analysis->reg, ri);
+		if (size) {
+			*size = ri->size;
+		}
+		return true;
+	}
+	const char *name = esil_value_str (v);
+	return name && rz_analysis_esil_reg_read (esil, name, num, size);
+}
+
+static bool esil_value_reg_read_nocallback(RzAnalysisEsil *esil, RzAnalysisEsilValue *v, ut64 *num, int *size) {
+	void *old_hook_reg_read = (void *) esil->cb.hook_reg_read;
+	esil->cb.hook_reg_read = NULL;
+	bool ret = esil_value_reg_read (esil, v, num, size);
+	esil->cb.hook_reg_read = old_hook_reg_read;
+	return ret;
+}
+
+static bool esil_value_reg_write(RzAnalysisEsil *esil, RzAnalysisEsilValue *v, ut64 num) {
+	RzRegItem *ri = esil_value_reg (esil, v);
+	if (ri && esil->verbose < 2 && !esil->cb.hook_reg_write && esil->cb.reg_write == internal_esil_reg_write) {
+		rz_reg_set_value (esil->analysis->reg, ri, num);
+		return true;
+	}
+	const char *name = esil_value_str (v);
+	return name && rz_analysis_esil_reg_write (esil, name, num);
+}
+
+// same as rz_analysis_esil_get_parm_size
+static bool esil_value_get(RzAnalysisEsil *esil, RzAnalysisEsilValue *v, ut64 *num, int *size) {
+	switch (v->type) {
+	case RZ_ANALYSIS_ESIL_VALUE_NONE:
+		return false;
+	case RZ_ANALYSIS_ESIL_VALUE_NUM:
+		*num = v->num;
+		if (size) {
+			*size = esil->analysis->bits;
+		}
+		return true;
+	default:
+		if (esil_value_reg (esil, v)) {
+			return esil_value_reg_read (esil, v, num, size);
+		}
+		return rz_analysis_esil_get_parm_size (esil, v->str, num, size);
+	}
+}
+
+// same as isregornum
+static bool esil_value_regornum(RzAnalysisEsil *esil, RzAnalysisEsilValue *v, ut64 *num) {
+	if (v->type == RZ_ANALYSIS_ESIL_VALUE_NONE) {
+		return false;
+	}
+	if (v->type == RZ_ANALYSIS_ESIL_VALUE_NUM && !esil->cb.hook_reg_read && esil->cb.reg_read == internal_esil_reg_read) {
+		*num = v->num;
+		return true;
+	}
+	if (esil_value_reg_read (esil, v, num, NULL)) {
+		return true;
+	}
+	return isnum (esil, esil_value_str (v), num);
+}
+
+static ut8 esil_value_reg_size(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	RzRegItem *ri = esil_value_reg (esil, v);
+	if (ri) {
+		return ri->size;
+	}
+	const char *name = esil_value_str (v);
+	return name? esil_internal_sizeof_reg (esil, name): 0;
+}
+
+static bool esil_value_is_reg(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	if (esil_value_reg (esil, v)) {
+		return true;
+	}
+	if (v->type == RZ_ANALYSIS_ESIL_VALUE_NONE || (v->type == RZ_ANALYSIS_ESIL_VALUE_NUM && !v->str)) {
+		return false;
+	}
+	return rz_reg_get (esil->analysis->reg, v->str, -1);
+}
+
+static bool esil_value_is_packed(RzAnalysisEsil *esil, RzAnalysisEsilValue *v) {
+	RzRegItem *ri = esil_value_reg (esil, v);
+	if (ri) {
+		return ri->packed_size > 0;
+	}
+	const char *name = esil_value_str (v);
+	return name && ispackedreg (esil, name);
+}
+
+/* pop Register or Number */
+static bool popRN(RzAnalysisEsil *esil, ut64 *n) {
+	RzAnalysisEsilValue v;
+	if (!esil_pop_value (esil, &v)) {
+		return false;
+	}
+	bool ret = esil_value_regornum (esil, &v, n);
+	esil_value_fini (&v);
+	return ret;
+}
+
 // sign extension operator for use in idiv, imul, movsx* 
 // and other instructions involving signed values, extends n bit value to 64 bit value
 // example : >"ae 8,0x81,~" ( <src bit width>,<value>,~ )
 // output  : 0xffffffffffffff81
 static bool esil_signext(RzAnalysisEsil *esil) {
 	ut64 src, dst;
+	RzAnalysisEsilValue p_src, p_dst;
 
-	char *p_src = rz_analysis_esil_pop (esil);
-	if (!p_src) {
+	if (!esil_pop_value (esil, &p_src)) {
 		return false;
 	}
-
-	if (!rz_analysis_esil_get_parm (esil, p_src, &src)) {
+	bool ok = esil_value_get (esil, &p_src, &src, NULL);
+	esil_value_fini (&p_src);
+	if (!ok) {
 		ERR ("esil_of: empty stack");
-		free (p_src);
 		return false;
-	} else {
-		free (p_src);
 	}
 
-	char *p_dst = rz_analysis_esil_pop (esil);
-	if (!p_dst) {
+	if (!esil_pop_value (esil, &p_dst)) {
 		return false;
 	}
-
-	if (!rz_analysis_esil_get_parm (esil, p_dst, &dst)) {
+	ok = esil_value_get (esil, &p_dst, &dst, NULL);
+	esil_value_fini (&p_dst);
+	if (!ok) {
 		ERR ("esil_of: empty stack");
-		free (p_dst);
 		return false;
-	} else {
-		free (p_dst);
 	}
 	
 	//Make sure the other bits are 0
@@ -589,19 +762,19 @@ static bool esil_zf(RzAnalysisEsil *esil) {
 
 // checks if there was a carry from bit x (x,$c)
 static bool esil_cf(RzAnalysisEsil *esil) {
-	char *src = rz_analysis_esil_pop (esil);
+	RzAnalysisEsilValue src;
 
-	if (!src) {
+	if (!esil_pop_value (esil, &src)) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type (esil, src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
-		free (src);
+	if (esil_value_type (esil, &src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+		esil_value_fini (&src);
 		return false;
 	}
 	ut64 bit;
-	rz_analysis_esil_get_parm (esil, src, &bit);
-	free (src);
+	esil_value_get (esil, &src, &bit, NULL);
+	esil_value_fini (&src);
 	//carry from bit <src>
 	//range of src goes from 0 to 63
 	//
@@ -612,19 +785,19 @@ static bool esil_cf(RzAnalysisEsil *esil) {
 
 // checks if there was a borrow from bit x (x,$b)
 static bool esil_bf(RzAnalysisEsil *esil) {
-	char *src = rz_analysis_esil_pop (esil);
+	RzAnalysisEsilValue src;
 
-	if (!src) {
+	if (!esil_pop_value (esil, &src)) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type (esil, src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
-		free (src);
+	if (esil_value_type (esil, &src) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+		esil_value_fini (&src);
 		return false;
 	}
 	ut64 bit;
-	rz_analysis_esil_get_parm (esil, src, &bit);
-	free (src);
+	esil_value_get (esil, &src, &bit, NULL);
+	esil_value_fini (&src);
 	//borrow from bit <src>
 	//range of src goes from 1 to 64
 	//	you cannot borrow from bit 0, bc bit -1 cannot not exist
@@ -649,24 +822,24 @@ static bool esil_pf(RzAnalysisEsil *esil) {
 // checks overflow from bit x (x,$o)
 //	x,$o ===> x,$c,x-1,$c,^
 static bool esil_of(RzAnalysisEsil *esil) {
-	char *p_bit = rz_analysis_esil_pop (esil);
+	RzAnalysisEsilValue p_bit;
 
-	if (!p_bit) {
+	if (!esil_pop_value (esil, &p_bit)) {
 		return false;
 	}
 
-	if (rz_analysis_esil_get_parm_type (esil, p_bit) != RZ_ANALYSIS_ESIL_PARM_NUM) {
-		free (p_bit);
+	if (esil_value_type (esil, &p_bit) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+		esil_value_fini (&p_bit);
 		return false;
 	}
 	ut64 bit;
 
-	if (!rz_analysis_esil_get_parm (esil, p_bit, &bit)) {
+	if (!esil_value_get (esil, &p_bit, &bit, NULL)) {
 		ERR ("esil_of: empty stack");
-		free (p_bit);
+		esil_value_fini (&p_bit);
 		return false;
 	}
-	free (p_bit);
+	esil_value_fini (&p_bit);
 
 	const ut64 m[2] = {genmask (bit & 0x3f), genmask ((bit + 0x3f) & 0x3f)};
 	const ut64 result = ((esil->cur & m[0]) < (esil->old & m[0])) ^ ((esil->cur & m[1]) < (esil->old & m[1]));
@@ -678,16 +851,16 @@ static bool esil_of(RzAnalysisEsil *esil) {
 static bool esil_sf(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail (esil, false);
 
-	char *p_size = rz_analysis_esil_pop (esil);
-	rz_return_val_if_fail (p_size, false);
+	RzAnalysisEsilValue p_size;
+	rz_return_val_if_fail (esil_pop_value (esil, &p_size), false);
 
-	if (rz_analysis_esil_get_parm_type (esil, p_size) != RZ_ANALYSIS_ESIL_PARM_NUM) {
-		free (p_size);
+	if (esil_value_type (esil, &p_size) != RZ_ANALYSIS_ESIL_PARM_NUM) {
+		esil_value_fini (&p_size);
 		return false;
 	}
 	ut64 size, num;
-	rz_analysis_esil_get_parm (esil, p_size, &size);
-	free (p_size);
+	esil_value_get (esil, &p_size, &size, NULL);
+	esil_value_fini (&p_size);
 
 	if (size > 63) {
 		num = 0;
@@ -727,56 +900,54 @@ static bool esil_address(RzAnalysisEsil *esil) {
 
 static bool esil_weak_eq(RzAnalysisEsil *esil) {
 	rz_return_val_if_fail (esil && esil->analysis, false);
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-
-	if (!(dst && src && (rz_analysis_esil_get_parm_type(esil, dst) == RZ_ANALYSIS_ESIL_PARM_REG))) {
-		free (dst);
-		free (src);
-		return false;
-	}
+	RzAnalysisEsilValue dst, src;
+	bool ret = false;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
 
-	ut64 src_num;
-	if (rz_analysis_esil_get_parm (esil, src, &src_num)) {
-		(void)rz_analysis_esil_reg_write (esil, dst, src_num);
-		free (src);
-		free (dst);
-		return true;
+	if (src.type && esil_value_type (esil, &dst) == RZ_ANALYSIS_ESIL_PARM_REG) {
+		ut64 src_num;
+		if (esil_value_get (esil, &src, &src_num, NULL)) {
+			(void)esil_value_reg_write (esil, &dst, src_num);
+			ret = true;
+		}
 	}
-
-	free (src);
-	free (dst);
-	return false;
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
+	return ret;
 }
 
 static bool esil_eq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (!src || !dst) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (!src.type || !dst.type) {
 		if (esil->verbose) {
 			eprintf ("Missing elements in the esil stack for '=' at 0x%08"PFMT64x"\n", esil->address);
 		}
+		esil_value_fini (&dst);
 		return false;
 	}
-	if (ispackedreg (esil, dst)) {
-		char *src2 = rz_analysis_esil_pop (esil);
-		char *newreg = rz_str_newf ("%sl", dst);
-		if (rz_analysis_esil_get_parm (esil, src2, &num2)) {
+	if (esil_value_is_packed (esil, &dst)) {
+		RzAnalysisEsilValue src2;
+		esil_pop_value (esil, &src2);
+		char *newreg = rz_str_newf ("%sl", esil_value_str (&dst));
+		if (esil_value_get (esil, &src2, &num2, NULL)) {
 			ret = rz_analysis_esil_reg_write (esil, newreg, num2);
 		}
 		free (newreg);
-		free (src2);
+		esil_value_fini (&src2);
 		goto beach;
 	}
 
-	if (src && dst && rz_analysis_esil_reg_read_nocallback (esil, dst, &num, NULL)) {
-		if (rz_analysis_esil_get_parm (esil, src, &num2)) {
-			ret = rz_analysis_esil_reg_write (esil, dst, num2);
+	if (esil_value_reg_read_nocallback (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
+			ret = esil_value_reg_write (esil, &dst, num2);
 			esil->cur = num2;
 			esil->old = num;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
 		} else {
 			ERR ("esil_eq: invalid src");
 		}
@@ -785,46 +956,47 @@ static bool esil_eq(RzAnalysisEsil *esil) {
 	}
 
 beach:
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_neg(RzAnalysisEsil *esil) {
 	bool ret = false;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src) {
+	RzAnalysisEsilValue src;
+	if (esil_pop_value (esil, &src)) {
 		ut64 num;
-		if (rz_analysis_esil_get_parm (esil, src, &num)) {
+		if (esil_value_get (esil, &src, &num, NULL)) {
 			rz_analysis_esil_pushnum (esil, !num);
 			ret = true;
 		} else {
-			if (isregornum (esil, src, &num)) {
+			if (esil_value_regornum (esil, &src, &num)) {
 				ret = true;
 				rz_analysis_esil_pushnum (esil, !num);
 			} else {
-				eprintf ("0x%08"PFMT64x" esil_neg: unknown reg %s\n", esil->address, src);
+				eprintf ("0x%08"PFMT64x" esil_neg: unknown reg %s\n", esil->address, esil_value_str (&src));
 			}
 		}
 	} else {
 		ERR ("esil_neg: empty stack");
 	}
-	free (src);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_negeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_reg_read (esil, src, &num, NULL)) {
+	RzAnalysisEsilValue src;
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &src, &num, NULL)) {
 		num = !num;
-		rz_analysis_esil_reg_write (esil, src, num);
+		esil_value_reg_write (esil, &src, num);
 		ret = true;
 	} else {
 		ERR ("esil_negeq: empty stack");
 	}
-	free (src);
+	esil_value_fini (&src);
 	//rz_analysis_esil_pushnum (esil, ret);
 	return ret;
 }
@@ -836,61 +1008,64 @@ static bool esil_nop(RzAnalysisEsil *esil) {
 static bool esil_andeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num & num2;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			rz_analysis_esil_reg_write (esil, dst, num & num2);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			esil_value_reg_write (esil, &dst, num & num2);
 			ret = true;
 		} else {
 			ERR ("esil_andeq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_oreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num | num2;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			ret = rz_analysis_esil_reg_write (esil, dst, num | num2);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			ret = esil_value_reg_write (esil, &dst, num | num2);
 		} else {
 			ERR ("esil_ordeq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_xoreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
-				esil->old = num;
-				esil->cur = num ^ num2;
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			ret = rz_analysis_esil_reg_write (esil, dst, num ^ num2);
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
+			esil->old = num;
+			esil->cur = num ^ num2;
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			ret = esil_value_reg_write (esil, &dst, num ^ num2);
 		} else {
 			ERR ("esil_xoreq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
@@ -981,29 +1156,35 @@ static bool esil_interrupt(RzAnalysisEsil *esil) {
 	return false;
 }
 
+// size of the operands of a comparison, used by the flags computed after it
+static ut8 esil_cmp_size(RzAnalysisEsil *esil, RzAnalysisEsilValue *dst, RzAnalysisEsilValue *src) {
+	if (esil_value_is_reg (esil, dst)) {
+		return esil_value_reg_size (esil, dst);
+	}
+	if (esil_value_is_reg (esil, src)) {
+		return esil_value_reg_size (esil, src);
+	}
+	// default size is set to 64 as internally operands are ut64
+	return 64;
+}
+
 // This function also sets internal vars which is used in flag calculations.
 static bool esil_cmp(RzAnalysisEsil *esil) {
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, src);
-			} else {
-				// default size is set to 64 as internally operands are ut64
-				esil->lastsz = 64;
-			}
+			esil->lastsz = esil_cmp_size (esil, &dst, &src);
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
@@ -1072,25 +1253,28 @@ static bool esil_if(RzAnalysisEsil *esil) {
 		esil->skip++;
 		return true;
 	}
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &num)) {
+	bool ret = false;
+	RzAnalysisEsilValue src;
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &num, NULL)) {
 		// condition not matching, skipping until
 		if (!num) {
 			esil->skip++;
 		}
-		free (src);
-		return true;
+		ret = true;
 	}
-	return false;
+	esil_value_fini (&src);
+	return ret;
 }
 
 static bool esil_lsl(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			if (num2 > sizeof (ut64) * 8) {
 				ERR ("esil_lsl: shift is too big");
 			} else {
@@ -1105,18 +1289,19 @@ static bool esil_lsl(RzAnalysisEsil *esil) {
 			ERR ("esil_lsl: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_lsleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			if (num2 > sizeof (ut64) * 8) {
 				ERR ("esil_lsleq: shift is too big");
 			} else {
@@ -1127,26 +1312,27 @@ static bool esil_lsleq(RzAnalysisEsil *esil) {
 					num <<= num2;
 				}
 				esil->cur = num;
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-				rz_analysis_esil_reg_write (esil, dst, num);
+				esil->lastsz = esil_value_reg_size (esil, &dst);
+				esil_value_reg_write (esil, &dst, num);
 				ret = true;
 			}
 		} else {
 			ERR ("esil_lsleq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_lsr(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			ut64 res = num >> RZ_MIN (num2, 63);
 			rz_analysis_esil_pushnum (esil, res);
 			ret = true;
@@ -1154,18 +1340,19 @@ static bool esil_lsr(RzAnalysisEsil *esil) {
 			ERR ("esil_lsr: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_lsreq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_reg_read (esil, dst, &num, NULL)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_reg_read (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			if (num2 > 63) {
 				if (esil->verbose) {
 					eprintf ("Invalid shift at 0x%08"PFMT64x"\n", esil->address);
@@ -1175,15 +1362,15 @@ static bool esil_lsreq(RzAnalysisEsil *esil) {
 			esil->old = num;
 			num >>= num2;
 			esil->cur = num;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			rz_analysis_esil_reg_write (esil, dst, num);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			esil_value_reg_write (esil, &dst, num);
 			ret = true;
 		} else {
 			ERR ("esil_lsreq: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
@@ -1357,10 +1544,11 @@ static bool esil_rol(RzAnalysisEsil *esil) {
 static bool esil_and(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			num &= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1368,18 +1556,19 @@ static bool esil_and(RzAnalysisEsil *esil) {
 			ERR ("esil_and: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_xor(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			num ^= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1387,18 +1576,19 @@ static bool esil_xor(RzAnalysisEsil *esil) {
 			ERR ("esil_xor: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_or(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 num, num2;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			num |= num2;
 			rz_analysis_esil_pushnum (esil, num);
 			ret = true;
@@ -1406,8 +1596,8 @@ static bool esil_or(RzAnalysisEsil *esil) {
 			ERR ("esil_xor: empty stack");
 		}
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
@@ -1446,7 +1636,7 @@ RZ_API bool rz_analysis_esil_dumpstack(RzAnalysisEsil *esil) {
 		return false;
 	}
 	for (i = esil->stackptr - 1; i >= 0; i--) {
-		esil->analysis->cb_printf ("%s\n", esil->stack[i]);
+		esil->analysis->cb_printf ("%s\n", esil_value_str (&esil->stack[i]));
 	}
 	return true;
 }
@@ -1471,11 +1661,12 @@ static bool esil_todo(RzAnalysisEsil *esil) {
 
 static bool esil_goto(RzAnalysisEsil *esil) {
 	ut64 num = 0;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && *src && rz_analysis_esil_get_parm (esil, src, &num)) {
+	RzAnalysisEsilValue src;
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &num, NULL)) {
 		esil->parse_goto = num;
 	}
-	free (src);
+	esil_value_fini (&src);
 	return 1;
 }
 
@@ -1661,10 +1852,11 @@ static bool esil_diveq(RzAnalysisEsil *esil) {
 static bool esil_mul(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
-		if (dst && rz_analysis_esil_get_parm (esil, dst, &d)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
+		if (esil_value_get (esil, &dst, &d, NULL)) {
 			rz_analysis_esil_pushnum (esil, d * s);
 			ret = true;
 		} else {
@@ -1673,165 +1865,174 @@ static bool esil_mul(RzAnalysisEsil *esil) {
 	} else {
 		ERR ("esil_mul: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_muleq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
+		if (esil_value_reg_read (esil, &dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d * s;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			ret = rz_analysis_esil_reg_write (esil, dst, s * d);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			ret = esil_value_reg_write (esil, &dst, s * d);
 		} else {
 			ERR ("esil_muleq: empty stack");
 		}
 	} else {
 		ERR ("esil_muleq: invalid parameters");
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_add(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if ((src && rz_analysis_esil_get_parm (esil, src, &s)) && (dst && rz_analysis_esil_get_parm (esil, dst, &d))) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL) && esil_value_get (esil, &dst, &d, NULL)) {
 		rz_analysis_esil_pushnum (esil, s + d);
 		ret = true;
 	} else {
 		ERR ("esil_add: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_addeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
+		if (esil_value_reg_read (esil, &dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d + s;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			ret = rz_analysis_esil_reg_write (esil, dst, s + d);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			ret = esil_value_reg_write (esil, &dst, s + d);
 		}
 	} else {
 		ERR ("esil_addeq: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_inc(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	RzAnalysisEsilValue src;
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
 		s++;
 		ret = rz_analysis_esil_pushnum (esil, s);
 	} else {
 		ERR ("esil_inc: invalid parameters");
 	}
-	free (src);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_inceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop (esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm (esil, src_dst, &sd)) {
+	RzAnalysisEsilValue src_dst;
+	esil_pop_value (esil, &src_dst);
+	if ((esil_value_type (esil, &src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_value_get (esil, &src_dst, &sd, NULL)) {
 		// inc rax
 		esil->old = sd++;
 		esil->cur = sd;
-		rz_analysis_esil_reg_write (esil, src_dst, sd);
-		esil->lastsz = esil_internal_sizeof_reg (esil, src_dst);
+		esil_value_reg_write (esil, &src_dst, sd);
+		esil->lastsz = esil_value_reg_size (esil, &src_dst);
 		ret = true;
 	} else {
 		ERR ("esil_inceq: invalid parameters");
 	}
-	free (src_dst);
+	esil_value_fini (&src_dst);
 	return ret;
 }
 
 static bool esil_sub(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if ((src && rz_analysis_esil_get_parm (esil, src, &s)) && (dst && rz_analysis_esil_get_parm (esil, dst, &d))) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL) && esil_value_get (esil, &dst, &d, NULL)) {
 		ret = rz_analysis_esil_pushnum (esil, d - s);
 	} else {
 		ERR ("esil_sub: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_subeq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s, d;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
-		if (dst && rz_analysis_esil_reg_read (esil, dst, &d, NULL)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
+		if (esil_value_reg_read (esil, &dst, &d, NULL)) {
 			esil->old = d;
 			esil->cur = d - s;
-			esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			ret = rz_analysis_esil_reg_write (esil, dst, d - s);
+			esil->lastsz = esil_value_reg_size (esil, &dst);
+			ret = esil_value_reg_write (esil, &dst, d - s);
 		}
 	} else {
 		ERR ("esil_subeq: invalid parameters");
 	}
-	free (src);
-	free (dst);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
 static bool esil_dec(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 s;
-	char *src = rz_analysis_esil_pop (esil);
-	if (src && rz_analysis_esil_get_parm (esil, src, &s)) {
+	RzAnalysisEsilValue src;
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &src, &s, NULL)) {
 		s--;
 		ret = rz_analysis_esil_pushnum (esil, s);
 	} else {
 		ERR ("esil_dec: invalid parameters");
 	}
-	free (src);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_deceq(RzAnalysisEsil *esil) {
 	bool ret = false;
 	ut64 sd;
-	char *src_dst = rz_analysis_esil_pop (esil);
-	if (src_dst && (rz_analysis_esil_get_parm_type (esil, src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && rz_analysis_esil_get_parm (esil, src_dst, &sd)) {
+	RzAnalysisEsilValue src_dst;
+	esil_pop_value (esil, &src_dst);
+	if ((esil_value_type (esil, &src_dst) == RZ_ANALYSIS_ESIL_PARM_REG) && esil_value_get (esil, &src_dst, &sd, NULL)) {
 		esil->old = sd;
 		sd--;
 		esil->cur = sd;
-		rz_analysis_esil_reg_write (esil, src_dst, sd);
-		esil->lastsz = esil_internal_sizeof_reg (esil, src_dst);
+		esil_value_reg_write (esil, &src_dst, sd);
+		esil->lastsz = esil_value_reg_size (esil, &src_dst);
 		ret = true;
 	} else {
 		ERR ("esil_deceq: invalid parameters");
 	}
-	free (src_dst);
+	esil_value_fini (&src_dst);
 	return ret;
 }
 
@@ -1841,22 +2042,22 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 	ut64 num, num2, addr;
 	ut8 b[8] = {0};
 	ut64 n;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
+	RzAnalysisEsilValue dst, src, src2 = { 0 };
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
 	int bytes = RZ_MIN (sizeof (b), bits / 8);
 	if (bits % 8) {
-		free (src);
-		free (dst);
+		esil_value_fini (&src);
+		esil_value_fini (&dst);
 		return false;
 	}
 	bool ret = false;
 	//eprintf ("GONA POKE %d src:%s dst:%s\n", bits, src, dst);
-	char *src2 = NULL;
-	if (src && rz_analysis_esil_get_parm (esil, src, &num)) {
-		if (dst && rz_analysis_esil_get_parm (esil, dst, &addr)) {
+	if (esil_value_get (esil, &src, &num, NULL)) {
+		if (esil_value_get (esil, &dst, &addr, NULL)) {
 			if (bits == 128) {
-				src2 = rz_analysis_esil_pop (esil);
-				if (src2 && rz_analysis_esil_get_parm (esil, src2, &num2)) {
+				esil_pop_value (esil, &src2);
+				if (esil_value_get (esil, &src2, &num2, NULL)) {
 					rz_write_ble (b, num, esil->analysis->big_endian, 64);
 					ret = rz_analysis_esil_mem_write (esil, addr, b, bytes);
 					if (ret == 0) {
@@ -1884,9 +2085,9 @@ static bool esil_poke_n(RzAnalysisEsil *esil, int bits) {
 		}
 	}
 out:
-	free (src2);
-	free (src);
-	free (dst);
+	esil_value_fini (&src2);
+	esil_value_fini (&src);
+	esil_value_fini (&dst);
 	return ret;
 }
 
@@ -1970,26 +2171,23 @@ static bool esil_peek_n(RzAnalysisEsil *esil, int bits) {
 		return false;
 	}
 	bool ret = false;
-	char res[32];
 	ut64 addr;
 	ut32 bytes = bits / 8;
-	char *dst = rz_analysis_esil_pop (esil);
-	if (!dst) {
+	RzAnalysisEsilValue dst;
+	if (!esil_pop_value (esil, &dst)) {
 		eprintf ("ESIL-ERROR at 0x%08"PFMT64x": Cannot peek memory without specifying an address\n", esil->address);
 		return false;
 	}
 	//eprintf ("GONA PEEK %d dst:%s\n", bits, dst);
-	if (dst && isregornum (esil, dst, &addr)) {
+	if (esil_value_regornum (esil, &dst, &addr)) {
 		if (bits == 128) {
 			ut8 a[sizeof(ut64) * 2] = {0};
 			ret = rz_analysis_esil_mem_read (esil, addr, a, bytes);
 			ut64 b = rz_read_ble64 (&a, 0); //esil->analysis->big_endian);
 			ut64 c = rz_read_ble64 (&a[8], 0); //esil->analysis->big_endian);
-			snprintf (res, sizeof (res), "0x%" PFMT64x, b);
-			rz_analysis_esil_push (esil, res);
-			snprintf (res, sizeof (res), "0x%" PFMT64x, c);
-			rz_analysis_esil_push (esil, res);
-			free (dst);
+			rz_analysis_esil_pushnum (esil, b);
+			rz_analysis_esil_pushnum (esil, c);
+			esil_value_fini (&dst);
 			return ret;
 		}
 		ut64 bitmask = genmask (bits - 1);
@@ -1999,11 +2197,10 @@ static bool esil_peek_n(RzAnalysisEsil *esil, int bits) {
 		if (esil->analysis->big_endian) {
 			rz_mem_swapendian ((ut8*)&b, (const ut8*)&b, bytes);
 		}
-		snprintf (res, sizeof (res), "0x%" PFMT64x, b & bitmask);
-		rz_analysis_esil_push (esil, res);
+		rz_analysis_esil_pushnum (esil, b & bitmask);
 		esil->lastsz = bits;
 	}
-	free (dst);
+	esil_value_fini (&dst);
 	return ret;
 }
 
@@ -2680,15 +2877,19 @@ static bool esil_dup(RzAnalysisEsil *esil) {
 	if (!esil || !esil->stack || esil->stackptr < 1 || esil->stackptr > (esil->stacksize - 1)) {
 		return false;
 	}
-	return rz_analysis_esil_push (esil, esil->stack[esil->stackptr-1]);
+	RzAnalysisEsilValue v = esil->stack[esil->stackptr-1];
+	if (v.owned && !(v.str = strdup (v.str))) {
+		return false;
+	}
+	return esil_push_value (esil, &v);
 }
 
 static bool esil_swap(RzAnalysisEsil *esil) {
-	char *tmp;
+	RzAnalysisEsilValue tmp;
 	if (!esil || !esil->stack || esil->stackptr < 2) {
 		return false;
 	}
-	if (!esil->stack[esil->stackptr-1] || !esil->stack[esil->stackptr-2]) {
+	if (!esil->stack[esil->stackptr-1].type || !esil->stack[esil->stackptr-2].type) {
 		return false;
 	}
 	tmp = esil->stack[esil->stackptr-1];
@@ -2725,106 +2926,82 @@ static int signed_compare_gt(ut64 a, ut64 b, ut64 size) {
 static bool esil_smaller(RzAnalysisEsil *esil) { // 'dst < src' => 'src,dst,<'
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, src);
-			} else {
-				// default size is set to 64 as internally operands are ut64
-				esil->lastsz = 64;
-			}
+			esil->lastsz = esil_cmp_size (esil, &dst, &src);
 			rz_analysis_esil_pushnum (esil, (num != num2) &
 			                           !signed_compare_gt (num, num2, esil->lastsz));
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_bigger(RzAnalysisEsil *esil) { // 'dst > src' => 'src,dst,>'
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, src);
-			} else {
-				// default size is set to 64 as internally operands are ut64
-				esil->lastsz = 64;
-			}
+			esil->lastsz = esil_cmp_size (esil, &dst, &src);
 			rz_analysis_esil_pushnum (esil, signed_compare_gt (num, num2, esil->lastsz));
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_smaller_equal(RzAnalysisEsil *esil) { // 'dst <= src' => 'src,dst,<='
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, src);
-			} else {
-				// default size is set to 64 as internally operands are ut64
-				esil->lastsz = 64;
-			}
+			esil->lastsz = esil_cmp_size (esil, &dst, &src);
 			rz_analysis_esil_pushnum (esil, !signed_compare_gt (num, num2, esil->lastsz));
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
 static bool esil_bigger_equal(RzAnalysisEsil *esil) { // 'dst >= src' => 'src,dst,>='
 	ut64 num, num2;
 	bool ret = false;
-	char *dst = rz_analysis_esil_pop (esil);
-	char *src = rz_analysis_esil_pop (esil);
-	if (dst && rz_analysis_esil_get_parm (esil, dst, &num)) {
-		if (src && rz_analysis_esil_get_parm (esil, src, &num2)) {
+	RzAnalysisEsilValue dst, src;
+	esil_pop_value (esil, &dst);
+	esil_pop_value (esil, &src);
+	if (esil_value_get (esil, &dst, &num, NULL)) {
+		if (esil_value_get (esil, &src, &num2, NULL)) {
 			esil->old = num;
 			esil->cur = num - num2;
 			ret = true;
-			if (rz_reg_get (esil->analysis->reg, dst, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, dst);
-			} else if (rz_reg_get (esil->analysis->reg, src, -1)) {
-				esil->lastsz = esil_internal_sizeof_reg (esil, src);
-			} else {
-				// default size is set to 64 as internally operands are ut64
-				esil->lastsz = 64;
-			}
+			esil->lastsz = esil_cmp_size (esil, &dst, &src);
 			rz_analysis_esil_pushnum (esil, (num == num2) |
 			                           signed_compare_gt (num, num2, esil->lastsz));
 		}
 	}
-	free (dst);
-	free (src);
+	esil_value_fini (&dst);
+	esil_value_fini (&src);
 	return ret;
 }
 
@@ -2945,11 +3122,10 @@ static bool runword(RzAnalysisEsil *esil, const char *word) {
 					return 1; // XXX cannot return != 1
 				}
 			}
-			esil->current_opstr = strdup (word);
+			esil->current_opstr = word;
 			//so this is basically just sharing what's the operation with the operation
 			//useful for wrappers
 			const bool ret = op->code (esil);
-			free (esil->current_opstr);
 			esil->current_opstr = NULL;
 			if (!ret) {
 				if (esil->verbose) {
@@ -3042,24 +3218,12 @@ static bool __stepOut(RzAnalysisEsil *esil, const char *cmd) {
 	return false;
 }
 
-RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
+static bool esil_parse_string(RzAnalysisEsil *esil, const char *str) {
 	int wordi = 0;
 	int dorunword;
 	char word[64];
 	const char *ostr = str;
-	rz_return_val_if_fail (esil && RZ_STR_ISNOTEMPTY (str), 0);
-
-	if (__stepOut (esil, esil->cmd_step)) {
-		(void)__stepOut (esil, esil->cmd_step_out);
-		return true;
-	}
 	const char *hashbang = strstr (str, "#!");
-	esil->trap = 0;
-	if (esil->cmd && esil->cmd_todo) {
-		if (!strncmp (str, "TODO", 4)) {
-			esil->cmd (esil, esil->cmd_todo, esil->address, 0);
-		}
-	}
 loop:
 	esil->repeat = 0;
 	esil->skip = 0;
@@ -3138,6 +3302,338 @@ repeat:
 	return 1;
 }
 
+/* Compiled expressions. The words of an expression are looked up once: ops
+ * are resolved to their RzAnalysisEsilOp, numbers are parsed and registers
+ * resolved to their RzRegItem, so running it again does not need to tokenize
+ * nor to hash anything. The string parser above remains the reference and
+ * is used for everything the compiler does not handle. */
+
+#define ESIL_CODE_CACHE_MAX 4096
+
+enum {
+	ESIL_CTL_NONE = 0,
+	ESIL_CTL_IF, // ?{
+	ESIL_CTL_ELSE, // }{
+	ESIL_CTL_END, // }
+};
+
+struct rz_analysis_esil_insn_t {
+	RzAnalysisEsilOp *op; // NULL to push value
+	RzAnalysisEsilValue value;
+	const char *word;
+	int ctl;
+};
+
+static bool esil_step_in(RzAnalysisEsil *esil, const char *str) {
+	if (__stepOut (esil, esil->cmd_step)) {
+		(void)__stepOut (esil, esil->cmd_step_out);
+		return true;
+	}
+	esil->trap = 0;
+	if (esil->cmd && esil->cmd_todo) {
+		if (!strncmp (str, "TODO", 4)) {
+			esil->cmd (esil, esil->cmd_todo, esil->address, 0);
+		}
+	}
+	return false;
+}
+
+static void esil_compile_word(RzAnalysisEsil *esil, RzAnalysisEsilInsn *in, const char *word) {
+	RzReg *reg = esil->analysis->reg;
+	in->word = word;
+	if (!strcmp (word, "?{")) {
+		in->ctl = ESIL_CTL_IF;
+	} else if (!strcmp (word, "}{")) {
+		in->ctl = ESIL_CTL_ELSE;
+	} else if (!strcmp (word, "}")) {
+		in->ctl = ESIL_CTL_END;
+	}
+	if (iscommand (esil, word, &in->op)) {
+		return;
+	}
+	in->value.str = (char *)word;
+	switch (rz_analysis_esil_get_parm_type (esil, word)) {
+	case RZ_ANALYSIS_ESIL_PARM_NUM:
+		// negative numbers go through rz_num_get at runtime
+		if (IS_DIGIT (*word)) {
+			in->value.type = RZ_ANALYSIS_ESIL_VALUE_NUM;
+			in->value.num = rz_num_get (NULL, word);
+			return;
+		}
+		break;
+	case RZ_ANALYSIS_ESIL_PARM_REG:
+		// role aliases (PC, SP...) can be remapped at any time
+		if (rz_reg_get_name_idx (word) == -1) {
+			in->value.type = RZ_ANALYSIS_ESIL_VALUE_REG;
+			in->value.reg = rz_reg_get (reg, word, -1);
+			return;
+		}
+		break;
+	}
+	in->value.type = RZ_ANALYSIS_ESIL_VALUE_STR;
+}
+
+/**
+ * Compiles str for rz_analysis_esil_run. Returns NULL for expressions that
+ * must be handled by the string parser: REIL output, hashbangs, ';' and
+ * empty words. The code refers to the ops of esil, it must not be run after
+ * they have been changed.
+ */
+RZ_API RzAnalysisEsilCode *rz_analysis_esil_compile(RzAnalysisEsil *esil, const char *str) {
+	rz_return_val_if_fail (esil && str, NULL);
+	if (!*str || *str == ',' || esil->Reil || !esil->analysis || !esil->analysis->reg) {
+		return NULL;
+	}
+	if (strchr (str, ';') || strstr (str, ",,") || strstr (str, "#!")) {
+		return NULL;
+	}
+	RzAnalysisEsilCode *code = RZ_NEW0 (RzAnalysisEsilCode);
+	if (!code) {
+		return NULL;
+	}
+	int count = 1;
+	const char *p;
+	for (p = str; *p; p++) {
+		if (*p == ',' && p[1]) {
+			count++;
+		}
+	}
+	code->expr = strdup (str);
+	code->words = strdup (str);
+	code->insns = RZ_NEWS0 (RzAnalysisEsilInsn, count);
+	if (!code->expr || !code->words || !code->insns) {
+		goto fail;
+	}
+	code->reg_gen = esil->analysis->reg->gen;
+	char *word = code->words;
+	while (code->count < count) {
+		char *next = strchr (word, ',');
+		if (next) {
+			*next++ = 0;
+		}
+		if (strlen (word) > 62) {
+			goto fail;
+		}
+		esil_compile_word (esil, &code->insns[code->count++], word);
+		word = next;
+	}
+	return code;
+fail:
+	rz_analysis_esil_code_free (code);
+	return NULL;
+}
+
+RZ_API void rz_analysis_esil_code_free(RzAnalysisEsilCode *code) {
+	if (!code) {
+		return;
+	}
+	free (code->insns);
+	free (code->words);
+	free (code->expr);
+	free (code);
+}
+
+// same as runword
+static bool esil_run_insn(RzAnalysisEsil *esil, RzAnalysisEsilInsn *in, bool regs) {
+	esil->parse_goto_count--;
+	if (esil->parse_goto_count < 1) {
+		ERR ("ESIL infinite loop detected\n");
+		esil->trap = 1;       // INTERNAL ERROR
+		esil->parse_stop = 1; // INTERNAL ERROR
+		return false;
+	}
+	switch (in->ctl) {
+	case ESIL_CTL_ELSE:
+		if (esil->skip == 1) {
+			esil->skip = 0;
+		} else if (esil->skip == 0) {
+			esil->skip = 1;
+		}
+		return true;
+	case ESIL_CTL_END:
+		if (esil->skip) {
+			esil->skip--;
+		}
+		return true;
+	case ESIL_CTL_IF:
+		break;
+	default:
+		if (esil->skip) {
+			return true;
+		}
+		break;
+	}
+	if (in->op) {
+		if (esil->cb.hook_command) {
+			if (esil->cb.hook_command (esil, in->word)) {
+				return 1; // XXX cannot return != 1
+			}
+		}
+		esil->current_opstr = in->word;
+		const bool ret = in->op->code (esil);
+		esil->current_opstr = NULL;
+		if (!ret) {
+			if (esil->verbose) {
+				eprintf ("%s returned 0\n", in->word);
+			}
+		}
+		return ret;
+	}
+	RzAnalysisEsilValue v = in->value;
+	if (!regs) {
+		v.reg = NULL;
+	}
+	if (!esil_push_value (esil, &v)) {
+		ERR ("ESIL stack is full");
+		esil->trap = 1;
+		esil->trap_code = 1;
+	}
+	return true;
+}
+
+// same as the loop of rz_analysis_esil_parse, with evalWord
+static bool esil_run_code(RzAnalysisEsil *esil, RzAnalysisEsilCode *code, bool regs) {
+	int i;
+loop:
+	esil->repeat = 0;
+	esil->skip = 0;
+	esil->parse_goto = -1;
+	esil->parse_stop = 0;
+	esil->parse_goto_count = esil->analysis? esil->analysis->esil_goto_limit: RZ_ANALYSIS_ESIL_GOTO_LIMIT;
+	for (i = 0; i < code->count; i++) {
+		if (!esil_run_insn (esil, &code->insns[i], regs)) {
+			return false;
+		}
+		if (esil->repeat) {
+			goto loop;
+		}
+		if (esil->parse_goto != -1) {
+			if (esil->parse_goto >= 0 && esil->parse_goto < code->count) {
+				i = esil->parse_goto - 1;
+				esil->parse_goto = -1;
+				continue;
+			}
+			if (esil->verbose) {
+				eprintf ("Cannot find word %d\n", esil->parse_goto);
+			}
+			return false;
+		}
+		if (esil->parse_stop) {
+			if (esil->parse_stop == 2) {
+				const char *rest = i + 1 < code->count
+					? code->expr + (code->insns[i + 1].word - code->words)
+					: "";
+				eprintf ("[esil at 0x%08"PFMT64x"] TODO: %s\n", esil->address, rest);
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Runs code compiled by rz_analysis_esil_compile, this is the same as
+ * rz_analysis_esil_parse with the expression it was compiled from.
+ */
+RZ_API bool rz_analysis_esil_run(RzAnalysisEsil *esil, RzAnalysisEsilCode *code) {
+	rz_return_val_if_fail (esil && code && code->insns, false);
+	if (esil_step_in (esil, code->expr)) {
+		return true;
+	}
+	if (esil->Reil) {
+		return esil_parse_string (esil, code->expr);
+	}
+	RzReg *reg = esil->analysis? esil->analysis->reg: NULL;
+	if (!esil->code_depth && reg) {
+		esil->code_gen = reg->gen;
+	}
+	// registers resolved with another profile are looked up by name
+	bool regs = reg && code->reg_gen == esil->code_gen;
+	esil->code_depth++;
+	bool ret = esil_run_code (esil, code, regs);
+	esil->code_depth--;
+	// the values pushed borrow the words of code
+	int i;
+	for (i = 0; i < esil->stackptr; i++) {
+		esil_value_own (&esil->stack[i]);
+	}
+	__stepOut (esil, esil->cmd_step_out);
+	return ret;
+}
+
+static void esil_code_kv_free(HtPPKv *kv) {
+	free (kv->key);
+	rz_analysis_esil_code_free (kv->value);
+}
+
+static void esil_code_cache_flush(RzAnalysisEsil *esil) {
+	if (esil->code_depth) {
+		// still running, flushed by the next esil_code_get at depth 0
+		esil->code_gen = 0;
+		return;
+	}
+	ht_pp_free (esil->code_cache);
+	esil->code_cache = NULL;
+}
+
+// the compiled code of str, cached by expression. Expressions that cannot be
+// compiled get an empty code so the string parser is used right away.
+static RzAnalysisEsilCode *esil_code_get(RzAnalysisEsil *esil, const char *str, bool *tmp) {
+	RzReg *reg = esil->analysis? esil->analysis->reg: NULL;
+	*tmp = false;
+	if (!reg) {
+		return NULL;
+	}
+	if (!esil->code_depth && esil->code_gen != reg->gen) {
+		esil_code_cache_flush (esil);
+		esil->code_gen = reg->gen;
+	}
+	RzAnalysisEsilCode *code = esil->code_cache? ht_pp_find (esil->code_cache, str, NULL): NULL;
+	if (code) {
+		return code;
+	}
+	code = rz_analysis_esil_compile (esil, str);
+	if (!code && !(code = RZ_NEW0 (RzAnalysisEsilCode))) {
+		return NULL;
+	}
+	if (esil->code_cache && esil->code_cache->count >= ESIL_CODE_CACHE_MAX) {
+		if (esil->code_depth) {
+			*tmp = true;
+			return code;
+		}
+		esil_code_cache_flush (esil);
+	}
+	if (!esil->code_cache) {
+		esil->code_cache = ht_pp_new (NULL, esil_code_kv_free, NULL);
+	}
+	if (!esil->code_cache || !ht_pp_insert (esil->code_cache, str, code)) {
+		*tmp = true;
+	}
+	return code;
+}
+
+RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str) {
+	rz_return_val_if_fail (esil && RZ_STR_ISNOTEMPTY (str), 0);
+	if (!esil->nocompile && !esil->Reil) {
+		bool tmp;
+		RzAnalysisEsilCode *code = esil_code_get (esil, str, &tmp);
+		if (code && code->insns) {
+			bool ret = rz_analysis_esil_run (esil, code);
+			if (tmp) {
+				rz_analysis_esil_code_free (code);
+			}
+			return ret;
+		}
+		if (tmp) {
+			rz_analysis_esil_code_free (code);
+		}
+	}
+	if (esil_step_in (esil, str)) {
+		return true;
+	}
+	return esil_parse_string (esil, str);
+}
+
 RZ_API bool rz_analysis_esil_runword(RzAnalysisEsil *esil, const char *word) {
 	const char *str = NULL;
 	(void)runword (esil, word);
@@ -3158,7 +3654,7 @@ RZ_API void rz_analysis_esil_stack_free(RzAnalysisEsil *esil) {
 	int i;
 	if (esil) {
 		for (i = 0; i < esil->stackptr; i++) {
-			RZ_FREE (esil->stack[i]);
+			esil_value_fini (&esil->stack[i]);
 		}
 		esil->stackptr = 0;
 	}
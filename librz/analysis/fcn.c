@@ -374,16 +374,14 @@ static RzAnalysisBlock *bbget(RzAnalysis *analysis, ut64 addr, bool jumpmid) {
 						if (addr <= at || off >= bb->size) {
 							continue;
 						}
-						RzAnalysisOp op;
-						int size = rz_analysis_op (analysis, &op, at, buf + off, bb->size - off, RZ_ANALYSIS_OP_MASK_BASIC);
+						RzAnalysisOpLite op;
+						int size = rz_analysis_op_lite (analysis, &op, at, buf + off, bb->size - off);
 						if (size > 0 && op.delay) {
 							if (op.delay >= last_instr_idx - i) {
 								in_delay_slot = true;
 							}
-							rz_analysis_op_fini (&op);
 							break;
 						}
-						rz_analysis_op_fini (&op);
 					}
 					if (in_delay_slot) {
 						free (buf);
@@ -1366,16 +1364,13 @@ RZ_API int rz_analysis_fcn_bb(RzAnalysis *analysis, RzAnalysisFunction *fcn, ut6
 }
 
 RZ_API bool rz_analysis_check_fcn(RzAnalysis *analysis, ut8 *buf, ut16 bufsz, ut64 addr, ut64 low, ut64 high) {
-	RzAnalysisOp op = {
-		0
-	};
+	RzAnalysisOpLite op;
 	int i, oplen, opcnt = 0, pushcnt = 0, movcnt = 0, brcnt = 0;
 	if (rz_analysis_is_prelude (analysis, buf, bufsz)) {
 		return true;
 	}
 	for (i = 0; i < bufsz && opcnt < 10; i += oplen, opcnt++) {
-		rz_analysis_op_fini (&op);
-		if ((oplen = rz_analysis_op (analysis, &op, addr + i, buf + i, bufsz - i, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT)) < 1) {
+		if ((oplen = rz_analysis_op_lite (analysis, &op, addr + i, buf + i, bufsz - i)) < 1) {
 			return false;
 		}
 		switch (op.type) {
@@ -1898,7 +1893,7 @@ RZ_API ut32 rz_analysis_function_cost(RzAnalysisFunction *fcn) {
 	}
 	RzAnalysis *analysis = fcn->analysis;
 	rz_list_foreach (fcn->bbs, iter, bb) {
-		RzAnalysisOp op;
+		RzAnalysisOpLite op;
 		ut64 at, end = bb->addr + bb->size;
 		ut8 *buf = malloc (bb->size);
 		if (!buf) {
@@ -1907,15 +1902,13 @@ RZ_API ut32 rz_analysis_function_cost(RzAnalysisFunction *fcn) {
 		(void)analysis->iob.read_at (analysis->iob.io, bb->addr, (ut8 *) buf, bb->size);
 		int idx = 0;
 		for (at = bb->addr; at < end;) {
-			memset (&op, 0, sizeof (op));
-			(void) rz_analysis_op (analysis, &op, at, buf + idx, bb->size - idx, RZ_ANALYSIS_OP_MASK_BASIC);
+			(void)rz_analysis_op_lite (analysis, &op, at, buf + idx, bb->size - idx);
 			if (op.size < 1) {
 				op.size = 1;
 			}
 			idx += op.size;
 			at += op.size;
 			totalCycles += op.cycles;
-			rz_analysis_op_fini (&op);
 		}
 		free (buf);
 	}
@@ -88,6 +88,403 @@ static int defaultCycles(RzAnalysisOp *op) {
 	}
 }
 
+// Decodes a single op with the current plugin, without asking the core for
+// the bits at addr nor applying hints. Reentrant plugins allow calling this
+// concurrently on shallow copies of analysis.
+RZ_API int rz_analysis_op_decode(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	rz_analysis_op_init (op);
+	rz_return_val_if_fail (analysis && analysis->cur && analysis->cur->op && op && data && len > 0, -1);
+	if (analysis->pcalign && addr % analysis->pcalign) {
+		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
+		op->addr = addr;
+		// eprintf ("Unaligned instruction for %d bits at 0x%"PFMT64x"\n", analysis->bits, addr);
+		op->size = 1;
+		return -1;
+	}
+	int ret = analysis->cur->op (analysis, op, addr, data, len, mask);
+	if (ret < 1) {
+		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
+	}
+	op->addr = addr;
+	/* consider at least 1 byte to be part of the opcode */
+	if (op->nopcode < 1) {
+		op->nopcode = 1;
+	}
+	return ret;
+}
+
+// the registers of table values belong to the RzReg of the thread that
+// decoded them, they are looked up again by name in the one of analysis
+static RzAnalysisValue *value_dup(RzAnalysis *analysis, RzAnalysisValue *v) {
+	RzAnalysisValue *nv = v ? rz_analysis_value_copy (v) : NULL;
+	if (nv) {
+		nv->seg = v->seg ? rz_reg_get (analysis->reg, v->seg->name, -1) : NULL;
+		nv->reg = v->reg ? rz_reg_get (analysis->reg, v->reg->name, -1) : NULL;
+		nv->regdelta = v->regdelta ? rz_reg_get (analysis->reg, v->regdelta->name, -1) : NULL;
+	}
+	return nv;
+}
+
+// fills op from analysis->op_table if it holds the very same decoding
+static bool op_table_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, int *ret) {
+	RzAnalysisOpTable *t = analysis->op_table;
+	if (!t || t->cur != analysis->cur || t->bits != analysis->bits || t->big_endian != analysis->big_endian
+		|| (mask & ~RZ_ANALYSIS_OP_MASK_HINT) != t->mask) {
+		return false;
+	}
+	// the table was decoded without hints, hinted code is decoded again
+	if (rz_analysis_hint_arch_at (analysis, addr, NULL) || rz_analysis_hint_bits_at (analysis, addr, NULL)) {
+		return false;
+	}
+	RzAnalysisOpTableEntry *e = ht_up_find (t->ops, addr, NULL);
+	if (!e || e->op.size > len || memcmp (e->bytes, data, e->op.size)) {
+		return false;
+	}
+	*op = e->op;
+	op->mnemonic = e->op.mnemonic ? strdup (e->op.mnemonic) : NULL;
+	op->src[0] = value_dup (analysis, e->op.src[0]);
+	op->src[1] = value_dup (analysis, e->op.src[1]);
+	op->src[2] = value_dup (analysis, e->op.src[2]);
+	op->dst = value_dup (analysis, e->op.dst);
+	if (e->op.access) {
+		RzListIter *it;
+		RzAnalysisValue *val;
+		op->access = rz_list_newf ((RzListFree)rz_analysis_value_free);
+		rz_list_foreach (e->op.access, it, val) {
+			rz_list_append (op->access, value_dup (analysis, val));
+		}
+	}
+	rz_strbuf_init (&op->esil);
+	rz_strbuf_copy (&op->esil, &e->op.esil);
+	rz_strbuf_init (&op->opex);
+	rz_strbuf_copy (&op->opex, &e->op.opex);
+	*ret = e->ret;
+	t->hits++;
+	return true;
+}
+
+#define OP_CACHE_BYTES 32
+// writes longer than this drop the whole cache instead of looking up every address
+#define OP_CACHE_INVALIDATE_MAX 0x1000
+
+typedef struct {
+	RzAnalysisValue v; // seg, reg and regdelta are NULL, looked up by name on a hit
+	const char *seg;
+	const char *reg;
+	const char *regdelta;
+} OpCacheValue;
+
+// A decoded op as rz_analysis_op returns it, before hints. The op owns
+// nothing: its strings are interned in the cache pool (and copied on every
+// hit) and its values are kept in vals, so the register items are resolved
+// again on every hit and never dangle after a register profile change.
+typedef struct {
+	RzAnalysisOp op;
+	const char *esil;
+	const char *opex;
+	RzAnalysisPlugin *cur;
+	int bits;
+	int big_endian;
+	RzAnalysisOpMask mask;
+	int ret;
+	size_t size;
+	ut8 bytes[OP_CACHE_BYTES];
+	ut8 vals_set; // bit i tells src[i] (dst for i == 3) is the next of vals
+	int nvals; // src and dst, then the access list
+	OpCacheValue vals[];
+} OpCacheEntry;
+
+typedef struct rz_analysis_op_cache_t {
+	HtUP *ops; // addr => OpCacheEntry
+	RzStrConstPool strings;
+	size_t strings_size;
+	RzAnalysisOpCacheStats stats;
+} RzAnalysisOpCache;
+
+static void op_cache_entry_free(HtUPKv *kv) {
+	free (kv->value);
+}
+
+static bool op_cache_init(RzAnalysisOpCache *c) {
+	c->ops = ht_up_new (NULL, op_cache_entry_free, NULL);
+	if (!c->ops) {
+		return false;
+	}
+	if (!rz_str_constpool_init (&c->strings)) {
+		ht_up_free (c->ops);
+		c->ops = NULL;
+		return false;
+	}
+	c->strings_size = 0;
+	c->stats.entries = 0;
+	c->stats.size = 0;
+	return true;
+}
+
+static void op_cache_fini(RzAnalysisOpCache *c) {
+	ht_up_free (c->ops);
+	c->ops = NULL;
+	rz_str_constpool_fini (&c->strings);
+}
+
+static void op_cache_flush(RzAnalysisOpCache *c) {
+	op_cache_fini (c);
+	op_cache_init (c);
+}
+
+static const char *op_cache_str(RzAnalysisOpCache *c, const char *s) {
+	if (!s) {
+		return NULL;
+	}
+	// counted on every insertion even when the pool already had it
+	c->strings_size += strlen (s) + 1;
+	c->stats.size += strlen (s) + 1;
+	return rz_str_constpool_get (&c->strings, s);
+}
+
+static void op_cache_remove(RzAnalysisOpCache *c, ut64 addr) {
+	OpCacheEntry *e = ht_up_find (c->ops, addr, NULL);
+	if (e) {
+		c->stats.size -= e->size;
+		c->stats.entries--;
+		ht_up_delete (c->ops, addr);
+	}
+}
+
+static OpCacheEntry *op_cache_find(RzAnalysis *analysis, ut64 addr, const ut8 *data, int len) {
+	OpCacheEntry *e = ht_up_find (analysis->op_cache->ops, addr, NULL);
+	if (!e || e->cur != analysis->cur || e->bits != analysis->bits || e->big_endian != analysis->big_endian) {
+		return NULL;
+	}
+	if (e->op.size > len || memcmp (e->bytes, data, e->op.size)) {
+		return NULL;
+	}
+	return e;
+}
+
+static RzAnalysisValue *op_cache_value(RzAnalysis *analysis, OpCacheValue *cv) {
+	RzAnalysisValue *v = rz_analysis_value_copy (&cv->v);
+	if (v) {
+		v->seg = cv->seg ? rz_reg_get (analysis->reg, cv->seg, -1) : NULL;
+		v->reg = cv->reg ? rz_reg_get (analysis->reg, cv->reg, -1) : NULL;
+		v->regdelta = cv->regdelta ? rz_reg_get (analysis->reg, cv->regdelta, -1) : NULL;
+	}
+	return v;
+}
+
+// fills op from analysis->op_cache if it holds the same bytes decoded with
+// at least the parts of mask
+static bool op_cache_get(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask, int *ret) {
+	RzAnalysisOpCache *c = analysis->op_cache;
+	mask &= ~RZ_ANALYSIS_OP_MASK_HINT;
+	OpCacheEntry *e = op_cache_find (analysis, addr, data, len);
+	if (!e || (e->mask & mask) != mask) {
+		c->stats.misses++;
+		return false;
+	}
+	*op = e->op;
+	op->mnemonic = (mask & RZ_ANALYSIS_OP_MASK_DISASM) && e->op.mnemonic ? strdup (e->op.mnemonic) : NULL;
+	if (e->esil && (mask & RZ_ANALYSIS_OP_MASK_ESIL)) {
+		rz_strbuf_set (&op->esil, e->esil);
+	}
+	if (e->opex && (mask & RZ_ANALYSIS_OP_MASK_OPEX)) {
+		rz_strbuf_set (&op->opex, e->opex);
+	}
+	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
+		RzAnalysisValue **slots[] = { &op->src[0], &op->src[1], &op->src[2], &op->dst };
+		int i, n = 0;
+		for (i = 0; i < RZ_ARRAY_SIZE (slots); i++) {
+			if (e->vals_set & (1 << i)) {
+				*slots[i] = op_cache_value (analysis, &e->vals[n++]);
+			}
+		}
+		if (n < e->nvals) {
+			op->access = rz_list_newf ((RzListFree)rz_analysis_value_free);
+			for (; n < e->nvals; n++) {
+				rz_list_append (op->access, op_cache_value (analysis, &e->vals[n]));
+			}
+		}
+	}
+	*ret = e->ret;
+	c->stats.hits++;
+	return true;
+}
+
+static void op_cache_value_set(RzAnalysisOpCache *c, OpCacheValue *cv, RzAnalysisValue *v) {
+	cv->v = *v;
+	cv->v.seg = cv->v.reg = cv->v.regdelta = NULL;
+	cv->seg = v->seg ? op_cache_str (c, v->seg->name) : NULL;
+	cv->reg = v->reg ? op_cache_str (c, v->reg->name) : NULL;
+	cv->regdelta = v->regdelta ? op_cache_str (c, v->regdelta->name) : NULL;
+}
+
+static void op_cache_add(RzAnalysis *analysis, RzAnalysisOp *op, const ut8 *data, int ret, RzAnalysisOpMask mask) {
+	RzAnalysisOpCache *c = analysis->op_cache;
+	if (ret < 1 || op->size < 1 || op->size > OP_CACHE_BYTES || op->switch_op) {
+		return;
+	}
+	RzAnalysisValue *vals[] = { op->src[0], op->src[1], op->src[2], op->dst };
+	int i, nvals = op->access ? rz_list_length (op->access) : 0;
+	for (i = 0; i < RZ_ARRAY_SIZE (vals); i++) {
+		nvals += vals[i] ? 1 : 0;
+	}
+	size_t size = sizeof (OpCacheEntry) + nvals * sizeof (OpCacheValue);
+	if (c->stats.size + size > c->stats.max_size) {
+		op_cache_flush (c);
+		c->stats.flushes++;
+	}
+	OpCacheEntry *e = calloc (1, size);
+	if (!e) {
+		return;
+	}
+	e->op = *op;
+	e->op.mnemonic = (char *)op_cache_str (c, op->mnemonic);
+	// reg and ireg are kept as they are: the plugins point them to static
+	// register names, and the ops handed out must not point into the pool
+	memset (&e->op.esil, 0, sizeof (e->op.esil));
+	memset (&e->op.opex, 0, sizeof (e->op.opex));
+	e->op.src[0] = e->op.src[1] = e->op.src[2] = e->op.dst = NULL;
+	e->op.access = NULL;
+	e->esil = rz_strbuf_length (&op->esil) ? op_cache_str (c, rz_strbuf_get (&op->esil)) : NULL;
+	e->opex = rz_strbuf_length (&op->opex) ? op_cache_str (c, rz_strbuf_get (&op->opex)) : NULL;
+	int n = 0;
+	for (i = 0; i < RZ_ARRAY_SIZE (vals); i++) {
+		if (vals[i]) {
+			e->vals_set |= 1 << i;
+			op_cache_value_set (c, &e->vals[n++], vals[i]);
+		}
+	}
+	if (op->access) {
+		RzListIter *it;
+		RzAnalysisValue *val;
+		rz_list_foreach (op->access, it, val) {
+			op_cache_value_set (c, &e->vals[n++], val);
+		}
+	}
+	e->nvals = n;
+	e->cur = analysis->cur;
+	e->bits = analysis->bits;
+	e->big_endian = analysis->big_endian;
+	e->mask = mask;
+	e->ret = ret;
+	e->size = size;
+	memcpy (e->bytes, data, op->size);
+	op_cache_remove (c, op->addr);
+	if (!ht_up_insert (c->ops, op->addr, e)) {
+		free (e);
+		return;
+	}
+	c->stats.size += size;
+	c->stats.entries++;
+}
+
+// Decodes a missed op into the cache. When the cache has a decoding of the
+// same bytes with other parts of the mask, both are decoded at once so that
+// e.g. pd (disasm) and af (esil and values) on the same code keep hitting.
+static int op_cache_decode(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
+	mask &= ~RZ_ANALYSIS_OP_MASK_HINT;
+	OpCacheEntry *e = op_cache_find (analysis, addr, data, len);
+	RzAnalysisOpMask dmask = e ? mask | e->mask : mask;
+	int ret = rz_analysis_op_decode (analysis, op, addr, data, len, dmask);
+	op_cache_add (analysis, op, data, ret, dmask);
+	if (dmask == mask) {
+		return ret;
+	}
+	// leave out what the caller did not ask for, as an uncached decoding would
+	if (!(mask & RZ_ANALYSIS_OP_MASK_DISASM)) {
+		RZ_FREE (op->mnemonic);
+	}
+	if (!(mask & RZ_ANALYSIS_OP_MASK_ESIL)) {
+		rz_strbuf_fini (&op->esil);
+	}
+	if (!(mask & RZ_ANALYSIS_OP_MASK_OPEX)) {
+		rz_strbuf_fini (&op->opex);
+	}
+	if (!(mask & RZ_ANALYSIS_OP_MASK_VAL)) {
+		RzAnalysisOp vals = { 0 };
+		vals.src[0] = op->src[0];
+		vals.src[1] = op->src[1];
+		vals.src[2] = op->src[2];
+		vals.dst = op->dst;
+		vals.access = op->access;
+		rz_analysis_op_fini (&vals);
+		op->src[0] = op->src[1] = op->src[2] = op->dst = NULL;
+		op->access = NULL;
+	}
+	return ret;
+}
+
+// Sets the memory cap of the decoded op cache in bytes, 0 disables it.
+// Only the ops of reentrant plugins are cached: the others keep state
+// across ops and may decode the same bytes differently.
+RZ_API bool rz_analysis_op_cache_set_size(RzAnalysis *analysis, size_t max_size) {
+	rz_return_val_if_fail (analysis, false);
+	RzAnalysisOpCache *c = analysis->op_cache;
+	if (!max_size) {
+		if (c) {
+			op_cache_fini (c);
+			free (c);
+			analysis->op_cache = NULL;
+		}
+		return true;
+	}
+	if (!c) {
+		c = RZ_NEW0 (RzAnalysisOpCache);
+		if (!c || !op_cache_init (c)) {
+			free (c);
+			return false;
+		}
+		analysis->op_cache = c;
+	}
+	c->stats.max_size = max_size;
+	if (c->stats.size > max_size) {
+		op_cache_flush (c);
+		c->stats.flushes++;
+	}
+	return true;
+}
+
+// Drops the ops overlapping [addr, addr + len), to be called on writes.
+// The bytes are compared on every hit anyway, this only releases the entries
+// and the ops of plugins that look at other memory while decoding.
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysis *analysis, ut64 addr, ut64 len) {
+	rz_return_if_fail (analysis);
+	RzAnalysisOpCache *c = analysis->op_cache;
+	if (!c || !c->stats.entries || !len) {
+		return;
+	}
+	if (len > OP_CACHE_INVALIDATE_MAX) {
+		op_cache_flush (c);
+		return;
+	}
+	ut64 from = addr > OP_CACHE_BYTES - 1 ? addr - (OP_CACHE_BYTES - 1) : 0;
+	ut64 to = addr + len;
+	ut64 at;
+	for (at = from; at != to; at++) {
+		OpCacheEntry *e = ht_up_find (c->ops, at, NULL);
+		if (e && at + e->op.size > addr) {
+			op_cache_remove (c, at);
+		}
+	}
+}
+
+RZ_API void rz_analysis_op_cache_clear(RzAnalysis *analysis) {
+	rz_return_if_fail (analysis);
+	if (analysis->op_cache) {
+		op_cache_flush (analysis->op_cache);
+	}
+}
+
+RZ_API bool rz_analysis_op_cache_stats(RzAnalysis *analysis, RzAnalysisOpCacheStats *stats) {
+	rz_return_val_if_fail (analysis && stats, false);
+	if (!analysis->op_cache) {
+		memset (stats, 0, sizeof (*stats));
+		return false;
+	}
+	*stats = analysis->op_cache->stats;
+	return true;
+}
+
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask) {
 	rz_analysis_op_init (op);
 	rz_return_val_if_fail (analysis && op && len > 0, -1);
@@ -100,20 +497,14 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 			analysis->coreb.archbits (analysis->coreb.core, addr);
 		}
 		if (analysis->pcalign && addr % analysis->pcalign) {
-			op->type = RZ_ANALYSIS_OP_TYPE_ILL;
-			op->addr = addr;
-			// eprintf ("Unaligned instruction for %d bits at 0x%"PFMT64x"\n", analysis->bits, addr);
-			op->size = 1;
-			return -1;
+			return rz_analysis_op_decode (analysis, op, addr, data, len, mask);
 		}
-		ret = analysis->cur->op (analysis, op, addr, data, len, mask);
-		if (ret < 1) {
-			op->type = RZ_ANALYSIS_OP_TYPE_ILL;
-		}
-		op->addr = addr;
-		/* consider at least 1 byte to be part of the opcode */
-		if (op->nopcode < 1) {
-			op->nopcode = 1;
+		if (op_table_get (analysis, op, addr, data, len, mask, &ret)) {
+			// decoded ahead
+		} else if (!analysis->op_cache || !analysis->cur->reentrant) {
+			ret = rz_analysis_op_decode (analysis, op, addr, data, len, mask);
+		} else if (!op_cache_get (analysis, op, addr, data, len, mask, &ret)) {
+			ret = op_cache_decode (analysis, op, addr, data, len, mask);
 		}
 	} else if (!memcmp (data, "\xff\xff\xff\xff", RZ_MIN (4, len))) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
@@ -138,6 +529,210 @@ RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, con
 	return ret;
 }
 
+RZ_API void rz_analysis_op_lite_init(RzAnalysisOpLite *op) {
+	if (op) {
+		memset (op, 0, sizeof (*op));
+		op->addr = UT64_MAX;
+		op->jump = UT64_MAX;
+		op->fail = UT64_MAX;
+		op->ptr = UT64_MAX;
+		op->val = UT64_MAX;
+		op->disp = UT64_MAX;
+	}
+}
+
+RZ_API void rz_analysis_op_to_lite(const RzAnalysisOp *op, RzAnalysisOpLite *lite) {
+	rz_return_if_fail (op && lite);
+	lite->addr = op->addr;
+	lite->type = op->type;
+	lite->stackop = op->stackop;
+	lite->cond = op->cond;
+	lite->size = op->size;
+	lite->cycles = op->cycles;
+	lite->family = op->family;
+	lite->eob = op->eob;
+	lite->delay = op->delay;
+	lite->jump = op->jump;
+	lite->fail = op->fail;
+	lite->ptr = op->ptr;
+	lite->val = op->val;
+	lite->stackptr = op->stackptr;
+	lite->refptr = op->refptr;
+	lite->disp = op->disp;
+}
+
+// Decodes the RzAnalysisOpLite fields of a single op, with the plugin op_lite
+// when it has one, and otherwise like rz_analysis_op_decode () with the basic
+// mask. Reentrant plugins allow calling this concurrently on thread copies.
+RZ_API int rz_analysis_op_lite_decode(RzAnalysis *analysis, RzAnalysisOpLite *op, ut64 addr, const ut8 *data, int len) {
+	rz_analysis_op_lite_init (op);
+	rz_return_val_if_fail (analysis && analysis->cur && analysis->cur->op && op && data && len > 0, -1);
+	if (!analysis->cur->op_lite || (analysis->pcalign && addr % analysis->pcalign)) {
+		RzAnalysisOp full;
+		int ret = rz_analysis_op_decode (analysis, &full, addr, data, len, RZ_ANALYSIS_OP_MASK_BASIC);
+		rz_analysis_op_to_lite (&full, op);
+		rz_analysis_op_fini (&full);
+		return ret;
+	}
+	int ret = analysis->cur->op_lite (analysis, op, addr, data, len);
+	if (ret < 1) {
+		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
+	}
+	op->addr = addr;
+	return ret;
+}
+
+// applies the address hints of op->addr that rz_analysis_op_hint () would,
+// reading the records in place instead of building a RzAnalysisHint
+static void op_lite_hint(RzAnalysis *analysis, RzAnalysisOpLite *op) {
+	const RzVector *records = rz_analysis_addr_hints_at (analysis, op->addr);
+	if (!records) {
+		return;
+	}
+	RzAnalysisAddrHintRecord *record;
+	rz_vector_foreach (records, record) {
+		switch (record->type) {
+		case RZ_ANALYSIS_ADDR_HINT_TYPE_VAL:
+			op->val = record->val;
+			break;
+		case RZ_ANALYSIS_ADDR_HINT_TYPE_OPTYPE:
+			if (record->optype > 0) {
+				op->type = record->optype;
+			}
+			break;
+		case RZ_ANALYSIS_ADDR_HINT_TYPE_JUMP:
+			op->jump = record->jump;
+			break;
+		case RZ_ANALYSIS_ADDR_HINT_TYPE_FAIL:
+			op->fail = record->fail;
+			break;
+		case RZ_ANALYSIS_ADDR_HINT_TYPE_SIZE:
+			if (record->size) {
+				op->size = record->size;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+// Same as rz_analysis_op () with the basic and hint masks, for loops that
+// only look at the type, size and targets of the ops: nothing is allocated
+// nor has to be freed, and the ops already in the op cache are reused.
+RZ_API int rz_analysis_op_lite(RzAnalysis *analysis, RzAnalysisOpLite *op, ut64 addr, const ut8 *data, int len) {
+	rz_analysis_op_lite_init (op);
+	rz_return_val_if_fail (analysis && op && data && len > 0, -1);
+	op->addr = addr;
+	if (!analysis->cur || !analysis->cur->op) {
+		op->type = !memcmp (data, "\xff\xff\xff\xff", RZ_MIN (4, len))
+			? RZ_ANALYSIS_OP_TYPE_ILL: RZ_ANALYSIS_OP_TYPE_MOV;
+		op->cycles = op->type == RZ_ANALYSIS_OP_TYPE_MOV ? 1 : 0;
+		return RZ_MIN (2, len);
+	}
+	if (analysis->coreb.archbits) {
+		analysis->coreb.archbits (analysis->coreb.core, addr);
+	}
+	if (analysis->pcalign && addr % analysis->pcalign) {
+		return rz_analysis_op_lite_decode (analysis, op, addr, data, len);
+	}
+	int ret;
+	OpCacheEntry *e = analysis->op_cache && analysis->cur->reentrant
+		? op_cache_find (analysis, addr, data, len) : NULL;
+	if (e) {
+		rz_analysis_op_to_lite (&e->op, op);
+		ret = e->ret;
+		analysis->op_cache->stats.hits++;
+	} else {
+		ret = rz_analysis_op_lite_decode (analysis, op, addr, data, len);
+	}
+	op_lite_hint (analysis, op);
+	return ret;
+}
+
+// Decodes up to n consecutive ops at addr into ops, returns how many were
+// decoded and sets *used to the bytes they span. Each op starts where the
+// previous one ended, or one byte after it when it could not be decoded;
+// size hints do not move the next op, as in the loops over rz_analysis_op ().
+// Unlike rz_analysis_op_lite () the arch and bits are not looked up per op,
+// so this is meant for code without arch or bits hints and can run on thread
+// copies with reentrant plugins.
+RZ_API int rz_analysis_op_lite_batch(RzAnalysis *analysis, RzAnalysisOpLite *ops, int n, ut64 addr, const ut8 *data, int len, int *used) {
+	rz_return_val_if_fail (analysis && analysis->cur && analysis->cur->op && ops && data, -1);
+	int i, off = 0;
+	for (i = 0; i < n && off < len; i++) {
+		int ret = rz_analysis_op_lite_decode (analysis, &ops[i], addr + off, data + off, len - off);
+		op_lite_hint (analysis, &ops[i]);
+		off += ret > 0 ? ret : 1;
+	}
+	if (used) {
+		*used = off;
+	}
+	return i;
+}
+
+static void op_table_entry_free(HtUPKv *kv) {
+	RzAnalysisOpTableEntry *e = kv->value;
+	rz_analysis_op_fini (&e->op);
+	free (e);
+}
+
+// the table remembers the plugin, bits and endianness of analysis, the ops
+// added to it must be decoded with them and without arch or bits hints
+RZ_API RzAnalysisOpTable *rz_analysis_op_table_new(RzAnalysis *analysis, RzAnalysisOpMask mask) {
+	rz_return_val_if_fail (analysis, NULL);
+	RzAnalysisOpTable *t = RZ_NEW0 (RzAnalysisOpTable);
+	if (!t) {
+		return NULL;
+	}
+	t->ops = ht_up_new (NULL, op_table_entry_free, NULL);
+	if (!t->ops) {
+		free (t);
+		return NULL;
+	}
+	t->cur = analysis->cur;
+	t->bits = analysis->bits;
+	t->big_endian = analysis->big_endian;
+	t->mask = mask & ~RZ_ANALYSIS_OP_MASK_HINT;
+	return t;
+}
+
+RZ_API void rz_analysis_op_table_free(RzAnalysisOpTable *t) {
+	if (t) {
+		ht_up_free (t->ops);
+		free (t);
+	}
+}
+
+// Moves op into the table, op is left empty. Ops that cannot be replayed
+// as they are (invalid, too long or carrying a switch) are not stored.
+RZ_API bool rz_analysis_op_table_add(RzAnalysisOpTable *t, RzAnalysisOp *op, const ut8 *data, int ret) {
+	rz_return_val_if_fail (t && op && data, false);
+	if (ret < 1 || op->size < 1 || op->size > sizeof (((RzAnalysisOpTableEntry *)0)->bytes) || op->switch_op) {
+		return false;
+	}
+	RzAnalysisOpTableEntry *e = RZ_NEW0 (RzAnalysisOpTableEntry);
+	if (!e) {
+		return false;
+	}
+	e->op = *op;
+	e->ret = ret;
+	memcpy (e->bytes, data, op->size);
+	if (!ht_up_insert (t->ops, op->addr, e)) {
+		free (e);
+		return false;
+	}
+	rz_analysis_op_init (op);
+	return true;
+}
+
+RZ_API bool rz_analysis_op_table_has(RzAnalysisOpTable *t, ut64 addr) {
+	rz_return_val_if_fail (t, false);
+	bool found = false;
+	ht_up_find (t->ops, addr, &found);
+	return found;
+}
+
 RZ_API RzAnalysisOp *rz_analysis_op_copy(RzAnalysisOp *op) {
 	RzAnalysisOp *nop = RZ_NEW0 (RzAnalysisOp);
 	if (!nop) {
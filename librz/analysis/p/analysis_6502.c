@@ -955,6 +955,7 @@ RzAnalysisPlugin rz_analysis_plugin_6502 = {
 	.arch = "6502",
 	.bits = 8,
 	.op = &_6502_op,
+	.reentrant = true,
 	.set_reg_profile = &set_reg_profile,
 	.esil = true,
 	.esil_init = esil_6502_init,
@@ -16,45 +16,16 @@
 #if CAPSTONE_HAS_MOS65XX
 #include <mos65xx.h>
 
-static csh handle = 0;
+#include "analysis_cs.inc"
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static int omode = 0;
-#if USE_ITERZ_API
-	static
-#endif
-	cs_insn *insn = NULL;
-	int mode = 0;
-	int n, ret;
-
-	if (handle && mode != omode) {
-		cs_close (&handle);
-		handle = 0;
-	}
-	omode = mode;
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_MOS65XX, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			handle = 0;
-			return 0;
-		}
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_MOS65XX, 0);
+	if (!ctx) {
+		return 0;
 	}
+	cs_insn *insn = ctx->insn;
 	op->cycles = 1; // aprox
-	cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
-	// capstone-next
-#if USE_ITERZ_API
-	{
-		ut64 naddr = addr;
-		size_t size = len;
-		if (!insn) {
-			insn = cs_malloc (handle);
-		}
-		n = cs_disasm_iter (handle, (const uint8_t**)&buf,
-			&size, (uint64_t*)&naddr, insn);
-	}
-#else
-	n = cs_disasm (handle, (const ut8*)buf, len, addr, 1, &insn);
-#endif
+	int n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 	} else {
@@ -161,10 +132,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 			break;
 		}
 	}
-#if !USE_ITERZ_API
-	cs_free (insn, n);
-#endif
-	//cs_close (&handle);
 	return op->size;
 }
 
@@ -200,6 +167,9 @@ RzAnalysisPlugin rz_analysis_plugin_6502_cs = {
 	.arch = "6502",
 	.bits = 8,
 	.op = &analop,
+	.reentrant = true,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 	.set_reg_profile = &set_reg_profile,
 };
 
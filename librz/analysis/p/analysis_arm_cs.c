@@ -8,6 +8,7 @@
 #include <arm.h>
 #include <rz_util/rz_assert.h>
 #include "./analysis_arm_hacks.inc"
+#include "analysis_cs.inc"
 
 
 #define esilprintf(op, fmt, ...) rz_strbuf_setf (&op->esil, fmt, ##__VA_ARGS__)
@@ -63,8 +64,11 @@
 #define ISPREINDEX64() ((OPCOUNT64() == 3) && (ISMEM64(2)) && (ISWRITEBACK64()))
 #define ISPOSTINDEX64() ((OPCOUNT64() == 4) && (ISIMM64(3)) && (ISWRITEBACK64()))
 
-static HtUU *ht_itblock = NULL;
-static HtUU *ht_it = NULL;
+typedef struct {
+	CsCtx cs; // first, for cs_ctx_get ()
+	HtUU *ht_itblock;
+	HtUU *ht_it;
+} ArmCtx;
 
 static const ut64 bitmask_by_width[] = {
 	0x1, 0x3, 0x7, 0xf, 0x1f, 0x3f, 0x7f, 0xff, 0x1ff, 0x3ff, 0x7ff,
@@ -3075,16 +3079,16 @@ static void anop64(csh handle, RzAnalysisOp *op, cs_insn *insn) {
 	}
 }
 
-static void analysis_itblock(cs_insn *insn) {
+static void analysis_itblock(ArmCtx *ctx, cs_insn *insn) {
 	size_t i, size =  rz_str_nlen (insn->mnemonic, 5);
-	ht_uu_update (ht_itblock, insn->address,  size);
+	ht_uu_update (ctx->ht_itblock, insn->address,  size);
 	for (i = 1; i < size; i++) {
 		switch (insn->mnemonic[i]) {
 		case 0x74: //'t'
-			ht_uu_update (ht_it, insn->address + (i * insn->size), insn->detail->arm.cc);
+			ht_uu_update (ctx->ht_it, insn->address + (i * insn->size), insn->detail->arm.cc);
 			break;
 		case 0x65: //'e'
-			ht_uu_update (ht_it, insn->address + (i * insn->size), (insn->detail->arm.cc % 2)?
+			ht_uu_update (ctx->ht_it, insn->address + (i * insn->size), (insn->detail->arm.cc % 2)?
 				insn->detail->arm.cc + 1: insn->detail->arm.cc - 1);
 			break;
 		default:
@@ -3093,19 +3097,20 @@ static void analysis_itblock(cs_insn *insn) {
 	}
 }
 
-static void check_itblock(cs_insn *insn) {
+static void check_itblock(ArmCtx *ctx, cs_insn *insn) {
 	size_t x;
 	bool found;
-	ut64 itlen = ht_uu_find (ht_itblock, insn->address, &found);
+	ut64 itlen = ht_uu_find (ctx->ht_itblock, insn->address, &found);
 	if (found) {
 		for (x = 1; x < itlen; x++) {
-			ht_uu_delete (ht_it, insn->address + (x*insn->size));
+			ht_uu_delete (ctx->ht_it, insn->address + (x*insn->size));
 		}
-		ht_uu_delete (ht_itblock, insn->address);
+		ht_uu_delete (ctx->ht_itblock, insn->address);
 	}
 }
 
 static void anop32(RzAnalysis *a, csh handle, RzAnalysisOp *op, cs_insn *insn, bool thumb, const ut8 *buf, int len) {
+	ArmCtx *ctx = a->plugin_data;
 	const ut64 addr = op->addr;
 	const int pcdelta = thumb? 4: 8;
 	int i;
@@ -3140,7 +3145,7 @@ static void anop32(RzAnalysis *a, csh handle, RzAnalysisOp *op, cs_insn *insn, b
 	}
 
 	if (insn->id != ARM_INS_IT) {
-		check_itblock (insn);
+		check_itblock (ctx, insn);
 	}
 
 	switch (insn->id) {
@@ -3178,7 +3183,7 @@ jmp $$ + 4 + ( [delta] * 2 )
 		}
 		break;
 	case ARM_INS_IT:
-		analysis_itblock (insn);
+		analysis_itblock (ctx, insn);
 		op->cycles = 2;
 		break;
 	case ARM_INS_BKPT:
@@ -3571,7 +3576,7 @@ jmp $$ + 4 + ( [delta] * 2 )
 		RZ_LOG_DEBUG ("ARM analysis: Op type %d at 0x%" PFMT64x " not handled\n", insn->id, op->addr);
 		break;
 	}
-	itcond = ht_uu_find (ht_it,  addr, &found);
+	itcond = ht_uu_find (ctx->ht_it,  addr, &found);
 	if (found) {
 		insn->detail->arm.cc = itcond;
 		insn->detail->arm.update_flags = 0;
@@ -3795,41 +3800,25 @@ static void op_fillval(RzAnalysis *analysis, RzAnalysisOp *op, csh handle, cs_in
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static csh handle = 0;
-	static int omode = -1;
-	static int obits = 32;
-	cs_insn *insn = NULL;
 	int mode = (a->bits==16)? CS_MODE_THUMB: CS_MODE_ARM;
-	int n, ret;
 	mode |= (a->big_endian)? CS_MODE_BIG_ENDIAN: CS_MODE_LITTLE_ENDIAN;
 	if (a->cpu && strstr (a->cpu, "cortex")) {
 		mode |= CS_MODE_MCLASS;
 	}
-
-	if (mode != omode || a->bits != obits) {
-		cs_close (&handle);
-		handle = 0; // unnecessary
-		omode = mode;
-		obits = a->bits;
-	}
 	op->size = (a->bits==16)? 2: 4;
 	op->addr = addr;
-	if (handle == 0) {
-		ret = (a->bits == 64)?
-			cs_open (CS_ARCH_ARM64, mode, &handle):
-			cs_open (CS_ARCH_ARM, mode, &handle);
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
-		if (ret != CS_ERR_OK) {
-			handle = 0;
-			return -1;
-		}
+	CsCtx *ctx = cs_ctx_get (a, (a->bits == 64)? CS_ARCH_ARM64: CS_ARCH_ARM, mode);
+	if (!ctx) {
+		return -1;
 	}
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
 	int haa = hackyArmAnal (a, op, buf, len);
 	if (haa > 0) {
 		return haa;
 	}
 
-	n = cs_disasm (handle, (ut8*)buf, len, addr, 1, &insn);
+	int n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
@@ -3867,9 +3856,7 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval (a, op, handle, insn, a->bits);
 		}
-		cs_free (insn, n);
 	}
-//		cs_close (&handle);
 	return op->size;
 }
 
@@ -4429,22 +4416,28 @@ static RzList *analysis_preludes(RzAnalysis *analysis) {
 	return l;
 }
 
-static int init(void* user) {
-	if (!ht_it) {
-		ht_it = ht_uu_new0 ();
+static void arm_ctx_fini(void *user) {
+	ArmCtx *ctx = user;
+	if (ctx) {
+		cs_ctx_close (&ctx->cs);
+		ht_uu_free (ctx->ht_itblock);
+		ht_uu_free (ctx->ht_it);
+		free (ctx);
 	}
-	if (!ht_itblock) {
-		ht_itblock = ht_uu_new0 ();
-	}
-	return 0;
 }
 
-static int fini(void* user) {
-	ht_uu_free (ht_itblock);
-	ht_uu_free (ht_it);
-	ht_itblock = NULL;
-	ht_it = NULL;
-	return 0;
+static void *arm_ctx_init(RzAnalysis *analysis) {
+	ArmCtx *ctx = RZ_NEW0 (ArmCtx);
+	if (!ctx) {
+		return NULL;
+	}
+	ctx->ht_itblock = ht_uu_new0 ();
+	ctx->ht_it = ht_uu_new0 ();
+	if (!ctx->ht_itblock || !ctx->ht_it) {
+		arm_ctx_fini (ctx);
+		return NULL;
+	}
+	return ctx;
 }
 
 RzAnalysisPlugin rz_analysis_plugin_arm_cs = {
@@ -4459,8 +4452,8 @@ RzAnalysisPlugin rz_analysis_plugin_arm_cs = {
 	.preludes = analysis_preludes,
 	.bits = 16 | 32 | 64,
 	.op = &analop,
-	.init = &init,
-	.fini = &fini,
+	.ctx_init = arm_ctx_init,
+	.ctx_fini = arm_ctx_fini,
 };
 
 #ifndef RZ_PLUGIN_INCORE
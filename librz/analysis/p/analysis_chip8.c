@@ -157,6 +157,7 @@ RzAnalysisPlugin rz_analysis_plugin_chip8 = {
 	.arch = "chip8",
 	.bits = 32,
 	.op = &chip8_anop,
+	.reentrant = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
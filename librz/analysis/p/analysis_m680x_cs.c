@@ -20,6 +20,7 @@
 
 #if CAPSTONE_HAS_M680X
 #include <m680x.h>
+#include "analysis_cs.inc"
 
 static int m680xmode(const char *str) {
 	if (!str) {
@@ -60,40 +61,24 @@ static int m680xmode(const char *str) {
 #define REL(x) insn->detail->m680x.operands[x].rel
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	int n, ret, opsize = -1;
-	static csh handle = 0;
-	static int omode = -1;
-	static int obits = 32;
-	cs_insn* insn;
-
+	int n, opsize = -1;
 	int mode = m680xmode (a->cpu);
-
-	if (mode != omode || a->bits != obits) {
-		cs_close (&handle);
-		handle = 0;
-		omode = mode;
-		obits = a->bits;
-	}
 	op->size = 4;
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_M680X, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			goto fin;
-		}
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_M680X, mode);
+	if (!ctx) {
+		return opsize;
 	}
-	n = cs_disasm (handle, (ut8*)buf, len, addr, 1, &insn);
+	cs_insn *insn = ctx->insn;
+	n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1 || insn->size < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		op->size = 2;
-		opsize = -1;
-		goto beach;
+		return -1;
 	}
 	if (!memcmp (buf, "\xff\xff", RZ_MIN (len, 2))) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		op->size = 2;
-		opsize = -1;
-		goto beach;
+		return -1;
 	}
 	op->id = insn->id;
 	opsize = op->size = insn->size;
@@ -507,10 +492,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 	case M680X_INS_XGDY:
 		break;
 	}
-beach:
-	cs_free (insn, n);
-	//cs_close (&handle);
-fin:
 	return opsize;
 }
 
@@ -537,6 +518,9 @@ RzAnalysisPlugin rz_analysis_plugin_m680x_cs = {
 	.set_reg_profile = &set_reg_profile,
 	.bits = 16 | 32,
 	.op = &analop,
+	.reentrant = true,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 };
 #else
 RzAnalysisPlugin rz_analysis_plugin_m680x_cs = {
@@ -17,6 +17,7 @@
 
 #if CAPSTONE_HAS_M68K
 #include <m68k.h>
+#include "analysis_cs.inc"
 // http://www.mrc.uidaho.edu/mrc/people/jff/digital/M68Kir.html
 
 #define OPERAND(x) insn->detail->m68k.operands[x]
@@ -158,23 +159,13 @@ static void op_fillval(RzAnalysisOp *op, csh handle, cs_insn *insn) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	int n, ret, opsize = -1;
-	static csh handle = 0;
-	static int omode = -1;
-	static int obits = 32;
-	cs_insn* insn;
+	int n, opsize = -1;
 	cs_m68k *m68k;
 	cs_detail *detail;
 
 	int mode = a->big_endian? CS_MODE_BIG_ENDIAN: CS_MODE_LITTLE_ENDIAN;
 
 	//mode |= (a->bits==64)? CS_MODE_64: CS_MODE_32;
-	if (mode != omode || a->bits != obits) {
-		cs_close (&handle);
-		handle = 0;
-		omode = mode;
-		obits = a->bits;
-	}
 // XXX no arch->cpu ?!?! CS_MODE_MICRO, N64
 	// replace this with the asm.features?
 	if (a->cpu && strstr (a->cpu, "68000")) {
@@ -196,14 +187,13 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		mode |= CS_MODE_M68K_060;
 	}
 	op->size = 4;
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_M68K, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			goto fin;
-		}
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_M68K, mode);
+	if (!ctx) {
+		return opsize;
 	}
-	n = cs_disasm (handle, (ut8*)buf, len, addr, 1, &insn);
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
+	n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1 || insn->size < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		op->size = 2;
@@ -696,9 +686,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		op_fillval (op, handle, insn);
 	}
 beach:
-	cs_free (insn, n);
-	//cs_close (&handle);
-fin:
 	return opsize;
 }
 
@@ -769,6 +756,8 @@ RzAnalysisPlugin rz_analysis_plugin_m68k_cs = {
 	.set_reg_profile = &set_reg_profile,
 	.bits = 32,
 	.op = &analop,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 };
 #else
 RzAnalysisPlugin rz_analysis_plugin_m68k_cs = {
@@ -4,6 +4,7 @@
 #include <rz_lib.h>
 #include <capstone.h>
 #include <mips.h>
+#include "analysis_cs.inc"
 
 static ut64 t9_pre = UT64_MAX;
 // http://www.mrc.uidaho.edu/mrc/people/jff/digital/MIPSir.html
@@ -722,11 +723,7 @@ static void set_opdir(RzAnalysisOp *op) {
 }
 
 static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	int n, ret, opsize = -1;
-	static csh hndl = 0;
-	static int omode = -1;
-	static int obits = 32;
-	cs_insn* insn;
+	int n, opsize = -1;
 	int mode = analysis->big_endian? CS_MODE_BIG_ENDIAN: CS_MODE_LITTLE_ENDIAN;
 
 	if (analysis->cpu && *analysis->cpu) {
@@ -743,27 +740,20 @@ static int analop(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *
 		}
 	}
 	mode |= (analysis->bits==64)? CS_MODE_MIPS64: CS_MODE_MIPS32;
-	if (mode != omode || analysis->bits != obits) {
-		cs_close (&hndl);
-		hndl = 0;
-		omode = mode;
-		obits = analysis->bits;
-	}
 // XXX no arch->cpu ?!?! CS_MODE_MICRO, N64
 	op->addr = addr;
 	if (len < 4) {
 		return -1;
 	}
 	op->size = 4;
-	if (hndl == 0) {
-		ret = cs_open (CS_ARCH_MIPS, mode, &hndl);
-		if (ret != CS_ERR_OK) {
-			goto fin;
-		}
-		cs_option (hndl, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (analysis, CS_ARCH_MIPS, mode);
+	if (!ctx) {
+		return opsize;
 	}
-	n = cs_disasm (hndl, (ut8*)buf, len, addr, 1, &insn);
-	if (n < 1 || insn->size < 1) {
+	csh hndl = ctx->handle;
+	n = cs_ctx_disasm (ctx, buf, len, addr);
+	cs_insn *insn = n > 0? ctx->insn: NULL;
+	if (!insn || insn->size < 1) {
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
 			op->mnemonic = strdup ("invalid");
 		}
@@ -1092,9 +1082,6 @@ beach:
 	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 		op_fillval (analysis, op, &hndl, insn);
 	}
-	cs_free (insn, n);
-	//cs_close (&handle);
-fin:
 	return opsize;
 }
 
@@ -1224,6 +1211,8 @@ RzAnalysisPlugin rz_analysis_plugin_mips_cs = {
 	.preludes = analysis_preludes,
 	.bits = 16|32|64,
 	.op = &analop,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 };
 
 #ifndef RZ_PLUGIN_INCORE
@@ -5,6 +5,7 @@
 #include <capstone.h>
 #include <ppc.h>
 #include "../../asm/arch/ppc/libvle/vle.h"
+#include "analysis_cs.inc"
 
 #define SPR_HID0 0x3f0 /* Hardware Implementation Register 0 */
 #define SPR_HID1 0x3f1 /* Hardware Implementation Register 1 */
@@ -579,10 +580,7 @@ static void op_fillval(RzAnalysisOp *op, csh handle, cs_insn *insn) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static csh handle = 0;
-	static int omode = -1, obits = -1;
 	int n, ret;
-	cs_insn *insn;
 	char *op1;
 	int mode = (a->bits == 64) ? CS_MODE_64 : (a->bits == 32) ? CS_MODE_32 : 0;
 	mode |= a->big_endian ? CS_MODE_BIG_ENDIAN : CS_MODE_LITTLE_ENDIAN;
@@ -598,23 +596,15 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		}
 	}
 
-	if (mode != omode || a->bits != obits) {
-		cs_close (&handle);
-		handle = 0;
-		omode = mode;
-		obits = a->bits;
-	}
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_PPC, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			return -1;
-		}
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_PPC, mode);
+	if (!ctx) {
+		return -1;
 	}
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
 	op->size = 4;
 
-	// capstone-next
-	n = cs_disasm (handle, (const ut8*)buf, len, addr, 1, &insn);
+	n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 	} else {
@@ -1248,8 +1238,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		if (!(mask & RZ_ANALYSIS_OP_MASK_ESIL)) {
 			rz_strbuf_fini (&op->esil);
 		}
-		cs_free (insn, n);
-		//cs_close (&handle);
 	}
 	return op->size;
 }
@@ -1278,6 +1266,8 @@ RzAnalysisPlugin rz_analysis_plugin_ppc_cs = {
 	.archinfo = archinfo,
 	.preludes = analysis_preludes,
 	.op = &analop,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 	.set_reg_profile = &set_reg_profile,
 };
 
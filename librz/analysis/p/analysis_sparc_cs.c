@@ -4,6 +4,7 @@
 #include <rz_lib.h>
 #include <capstone.h>
 #include <sparc.h>
+#include "analysis_cs.inc"
 
 #if CS_API_MAJOR < 2
 #error Old Capstone not supported
@@ -95,10 +96,7 @@ static void op_fillval(RzAnalysisOp *op, csh handle, cs_insn *insn) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static csh handle = 0;
-	static int omode;
-	cs_insn *insn;
-	int mode, n, ret;
+	int mode, n;
 
 	if (!a->big_endian) {
 		return -1;
@@ -108,20 +106,13 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 	if (!strcmp (a->cpu, "v9")) {
 		mode |= CS_MODE_V9;
 	}
-	if (mode != omode) {
-		cs_close (&handle);
-		handle = 0;
-		omode = mode;
-	}
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_SPARC, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			return -1;
-		}
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_SPARC, mode);
+	if (!ctx) {
+		return -1;
 	}
-	// capstone-next
-	n = cs_disasm (handle, (const ut8*)buf, len, addr, 1, &insn);
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
+	n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 	} else {
@@ -313,7 +304,6 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval (op, handle, insn);
 		}
-		cs_free (insn, n);
 	}
 	return op->size;
 }
@@ -389,6 +379,8 @@ RzAnalysisPlugin rz_analysis_plugin_sparc_cs = {
 	.bits = 32|64,
 	.archinfo = archinfo,
 	.op = &analop,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 	.set_reg_profile = &set_reg_profile,
 };
 
@@ -4,6 +4,7 @@
 #include <rz_lib.h>
 #include <capstone.h>
 #include <x86.h>
+#include "analysis_cs.inc"
 
 #if 0
 CYCLES:
@@ -26,8 +27,6 @@ call = 4
 #define HAVE_CSGRP_PRIVILEGE 0
 #endif
 
-#define USE_ITERZ_API 0
-
 #if CS_API_MAJOR < 2
 #error Old Capstone not supported
 #endif
@@ -58,10 +57,9 @@ struct Getarg {
 	csh handle;
 	cs_insn *insn;
 	int bits;
+	char buf[AR_DIM][BUF_SZ]; // where getarg () builds the operands
 };
 
-static csh handle = 0;
-
 static void hidden_op(cs_insn *insn, cs_x86 *x, int mode) {
 	unsigned int id = insn->id;
 	int regsz = 4;
@@ -106,7 +104,7 @@ static void hidden_op(cs_insn *insn, cs_x86 *x, int mode) {
 	}
 }
 
-static void opex(RzStrBuf *buf, cs_insn *insn, int mode) {
+static void opex(RzStrBuf *buf, csh handle, cs_insn *insn, int mode) {
 	int i;
 	rz_strbuf_init (buf);
 	rz_strbuf_append (buf, "{");
@@ -226,12 +224,11 @@ static bool is_xmm_reg(cs_x86_op op) {
  * @param  n       Operand index
  * @param  set     if 1 it adds set (=) to the operand
  * @param  setoper Extra operation for the set (^, -, +, etc...)
- * @param  sel     Selector for output buffer in staic array
- * @return         Pointer to esil operand in static array
+ * @param  sel     Selector for output buffer in gop
+ * @return         Pointer to esil operand in gop
  */
 static char *getarg(struct Getarg* gop, int n, int set, char *setop, int sel, ut32 *bitsize) {
-	static char buf[AR_DIM][BUF_SZ];
-	char *out = buf[sel];
+	char *out = gop->buf[sel];
 	char *setarg = setop ? setop : "";
 	cs_insn *insn = gop->insn;
 	csh handle = gop->handle;
@@ -3166,46 +3163,17 @@ static int cs_len_prefix_opcode(uint8_t *item) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static int omode = 0;
-#if USE_ITERZ_API
-	static
-#endif
-	cs_insn *insn = NULL;
 	int mode = (a->bits==64)? CS_MODE_64:
 		(a->bits==32)? CS_MODE_32:
 		(a->bits==16)? CS_MODE_16: 0;
-	int n, ret;
-
-	if (handle && mode != omode) {
-		if (handle != 0) {
-			cs_close (&handle);
-			handle = 0;
-		}
-	}
-	omode = mode;
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_X86, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			handle = 0;
-			return 0;
-		}
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_X86, mode);
+	if (!ctx) {
+		return 0;
 	}
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
 	op->cycles = 1; // aprox
-	cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
-	// capstone-next
-#if USE_ITERZ_API
-	{
-		ut64 naddr = addr;
-		size_t size = len;
-		if (!insn) {
-			insn = cs_malloc (handle);
-		}
-		n = cs_disasm_iter (handle, (const uint8_t**)&buf,
-			&size, (uint64_t*)&naddr, insn);
-	}
-#else
-	n = cs_disasm (handle, (const ut8*)buf, len, addr, 1, &insn);
-#endif
+	int n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 		if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
@@ -3247,27 +3215,56 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 			anop_esil (a, op, addr, buf, len, &handle, insn);
 		}
 		if (mask & RZ_ANALYSIS_OP_MASK_OPEX) {
-			opex (&op->opex, insn, mode);
+			opex (&op->opex, handle, insn, mode);
 		}
 		if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
 			op_fillval (a, op, &handle, insn, mode);
 		}
 	}
-//#if X86_GRP_PRIVILEGE>0
-	if (insn) {
 #if HAVE_CSGRP_PRIVILEGE
-		if (cs_insn_group (handle, insn, X86_GRP_PRIVILEGE)) {
-			op->family = RZ_ANALYSIS_OP_FAMILY_PRIV;
-		}
-#endif
-#if !USE_ITERZ_API
-		cs_free (insn, n);
-#endif
+	if (n > 0 && cs_insn_group (handle, insn, X86_GRP_PRIVILEGE)) {
+		op->family = RZ_ANALYSIS_OP_FAMILY_PRIV;
 	}
-	//cs_close (&handle);
+#endif
 	return op->size;
 }
 
+// Fills only what RzAnalysisOpLite keeps: no mnemonic, prefixes, opcode
+// length nor operand directions, on a RzAnalysisOp that never owns anything
+static int analop_lite(RzAnalysis *a, RzAnalysisOpLite *lite, ut64 addr, const ut8 *buf, int len) {
+	int mode = (a->bits==64)? CS_MODE_64:
+		(a->bits==32)? CS_MODE_32:
+		(a->bits==16)? CS_MODE_16: 0;
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_X86, mode);
+	if (!ctx) {
+		return 0;
+	}
+	lite->cycles = 1;
+	if (cs_ctx_disasm (ctx, buf, len, addr) < 1) {
+		lite->type = RZ_ANALYSIS_OP_TYPE_ILL;
+		return 0;
+	}
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
+	RzAnalysisOp op;
+	rz_analysis_op_init (&op);
+	op.cycles = 1;
+	op.size = insn->size;
+	op.family = insn->detail->x86.prefix[0] == X86_PREFIX_LOCK
+		? RZ_ANALYSIS_OP_FAMILY_THREAD: RZ_ANALYSIS_OP_FAMILY_CPU;
+	op.cond = cond_x862r2 (insn->id);
+	anop (a, &op, addr, buf, len, &handle, insn);
+#if HAVE_CSGRP_PRIVILEGE
+	if (cs_insn_group (handle, insn, X86_GRP_PRIVILEGE)) {
+		op.family = RZ_ANALYSIS_OP_FAMILY_PRIV;
+	}
+#endif
+	rz_analysis_op_to_lite (&op, lite);
+	int size = op.size;
+	rz_analysis_op_fini (&op);
+	return size;
+}
+
 #if 0
 static int x86_int_0x80(RzAnalysisEsil *esil, int interrupt) {
 	int syscall;
@@ -3321,20 +3318,6 @@ static int esil_x86_cs_init(RzAnalysisEsil *esil) {
 	return true;
 }
 
-static int init(void *p) {
-	handle = 0;
-	return true;
-}
-
-static int fini(void *p) {
-	if (handle != 0) {
-		// SEGFAULTS RANDOMLY, better leak on exit
-		// cs_close (&handle);
-		handle = 0;
-	}
-	return true;
-}
-
 static int esil_x86_cs_fini(RzAnalysisEsil *esil) {
 	return true;
 }
@@ -3779,11 +3762,13 @@ RzAnalysisPlugin rz_analysis_plugin_x86_cs = {
 	.arch = "x86",
 	.bits = 16|32|64,
 	.op = &analop,
+	.op_lite = &analop_lite,
 	.preludes = analysis_preludes,
 	.archinfo = archinfo,
 	.get_reg_profile = &get_reg_profile,
-	.init = init,
-	.fini = fini,
+	.reentrant = true,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 	.esil_init = esil_x86_cs_init,
 	.esil_fini = esil_x86_cs_fini,
 //	.esil_intr = esil_x86_cs_intr,
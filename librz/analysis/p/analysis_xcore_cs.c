@@ -4,6 +4,7 @@
 #include <rz_lib.h>
 #include <capstone.h>
 #include <xcore.h>
+#include "analysis_cs.inc"
 
 #if CS_API_MAJOR < 2
 #error Old Capstone not supported
@@ -51,30 +52,18 @@ static void opex(RzStrBuf *buf, csh handle, cs_insn *insn) {
 }
 
 static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
-	static csh handle = 0;
-	static int omode = 0;
-	cs_insn *insn;
-	int mode, n, ret;
+	int mode, n;
 	mode = CS_MODE_BIG_ENDIAN;
 	if (!strcmp (a->cpu, "v9")) {
 		mode |= CS_MODE_V9;
 	}
-	if (mode != omode) {
-		if (handle) {
-			cs_close (&handle);
-			handle = 0;
-		}
-		omode = mode;
-	}
-	if (handle == 0) {
-		ret = cs_open (CS_ARCH_XCORE, mode, &handle);
-		if (ret != CS_ERR_OK) {
-			return -1;
-		}
-		cs_option (handle, CS_OPT_DETAIL, CS_OPT_ON);
+	CsCtx *ctx = cs_ctx_get (a, CS_ARCH_XCORE, mode);
+	if (!ctx) {
+		return -1;
 	}
-	// capstone-next
-	n = cs_disasm (handle, (const ut8*)buf, len, addr, 1, &insn);
+	csh handle = ctx->handle;
+	cs_insn *insn = ctx->insn;
+	n = cs_ctx_disasm (ctx, buf, len, addr);
 	if (n < 1) {
 		op->type = RZ_ANALYSIS_OP_TYPE_ILL;
 	} else {
@@ -116,9 +105,7 @@ static int analop(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, in
 			op->type = RZ_ANALYSIS_OP_TYPE_ADD;
 			break;
 		}
-		cs_free (insn, n);
 	}
-	//	cs_close (&handle);
 	return op->size;
 }
 
@@ -130,6 +117,9 @@ RzAnalysisPlugin rz_analysis_plugin_xcore_cs = {
 	.arch = "xcore",
 	.bits = 32,
 	.op = &analop,
+	.reentrant = true,
+	.ctx_init = cs_ctx_init,
+	.ctx_fini = cs_ctx_fini,
 	//.set_reg_profile = &set_reg_profile,
 };
 
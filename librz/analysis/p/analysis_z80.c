@@ -422,6 +422,7 @@ RzAnalysisPlugin rz_analysis_plugin_z80 = {
 	.desc = "Z80 CPU code analysis plugin",
 	.archinfo = archinfo,
 	.op = &z80_analysis_op,
+	.reentrant = true,
 };
 
 #ifndef RZ_PLUGIN_INCORE
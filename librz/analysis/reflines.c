@@ -362,7 +362,7 @@ RZ_API RzAnalysisRefStr *rz_analysis_reflines_str(void *_core, ut64 addr, int op
 		return NULL;
 	}
 	rz_list_foreach (analysis->reflines, iter, ref) {
-		if (core->cons && core->cons->context->breaked) {
+		if (core->cons && rz_cons_context ()->breaked) {
 			rz_list_free (lvls);
 			return NULL;
 		}
@@ -375,7 +375,7 @@ RZ_API RzAnalysisRefStr *rz_analysis_reflines_str(void *_core, ut64 addr, int op
 	rz_buf_append_string (c, " ");
 	rz_buf_append_string (b, " ");
 	rz_list_foreach (lvls, iter, ref) {
-		if (core->cons && core->cons->context->breaked) {
+		if (core->cons && rz_cons_context ()->breaked) {
 			rz_list_free (lvls);
 			rz_buf_free (b);
 			rz_buf_free (c);
@@ -1968,6 +1968,7 @@ RZ_API void rz_serialize_analysis_sign_save(RZ_NONNULL Sdb *db, RZ_NONNULL RzAna
 }
 
 RZ_API bool rz_serialize_analysis_sign_load(RZ_NONNULL Sdb *db, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_sign_index_invalidate (analysis);
 	sdb_reset (analysis->sdb_zigns);
 	sdb_copy (db, analysis->sdb_zigns);
 	Sdb *spaces_db = sdb_ns (db, "spaces", false);
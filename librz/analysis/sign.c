@@ -4,6 +4,7 @@
 #include <rz_sign.h>
 #include <rz_search.h>
 #include <rz_core.h>
+#include "sign_private.h"
 
 RZ_LIB_VERSION (rz_sign);
 
@@ -671,6 +672,7 @@ RZ_API bool rz_sign_add_item(RzAnalysis *a, RzSignItem *it) {
 		serialize (a, curit, key, val);
 	}
 	sdb_set (a->sdb_zigns, key, val, 0);
+	rz_sign_index_invalidate (a);
 
 out:
 	rz_sign_item_free (curit);
@@ -833,16 +835,21 @@ static int bb_sort_by_addr(const void *x, const void *y) {
 	return 0;
 }
 
-static RzSignBytes *rz_sign_fcn_bytes(RzAnalysis *a, RzAnalysisFunction *fcn) {
-	rz_return_val_if_fail (a && fcn && fcn->bbs && fcn->bbs->head, false);
-
-	// get size
+// size of the bytes zignature of fcn, sorts its blocks
+static int fcn_bytes_size(RzAnalysis *a, RzAnalysisFunction *fcn) {
 	RzCore *core = a->coreb.core;
 	int maxsz = a->coreb.cfggeti (core, "zign.maxsz");
 	rz_list_sort (fcn->bbs, &bb_sort_by_addr);
-	ut64 ea = fcn->addr;
 	RzAnalysisBlock *bb = (RzAnalysisBlock *)fcn->bbs->tail->data;
-	int size = RZ_MIN (bb->addr + bb->size - ea, maxsz);
+	return RZ_MIN (bb->addr + bb->size - fcn->addr, maxsz);
+}
+
+static RzSignBytes *rz_sign_fcn_bytes(RzAnalysis *a, RzAnalysisFunction *fcn) {
+	rz_return_val_if_fail (a && fcn && fcn->bbs && fcn->bbs->head, false);
+
+	ut64 ea = fcn->addr;
+	int size = fcn_bytes_size (a, fcn);
+	RzAnalysisBlock *bb;
 
 	// alloc space for signature
 	RzSignBytes *sig = RZ_NEW0 (RzSignBytes);
@@ -1140,6 +1147,7 @@ RZ_API bool rz_sign_delete(RzAnalysis *a, const char *name) {
 	if (!a || !name) {
 		return false;
 	}
+	rz_sign_index_invalidate (a);
 	// Remove all zigns
 	if (*name == '*') {
 		if (!rz_spaces_current (&a->zign_spaces)) {
@@ -1259,69 +1267,81 @@ typedef struct {
 	double infimum;
 } ClosestMatchData;
 
-static bool closest_match_update(ClosestMatchData *data, RzSignItem *it) {
-	// quantify how close the signature matches
-	int div = 0;
-	double score = 0.0;
-	double gscore = -1.0;
-	if (it->graph && data->test->graph) {
-		gscore = matchGraph (it, data->test);
-		score += gscore;
-		div++;
-	}
-	double bscore = -1.0;
-	bool list_full = (rz_list_length (data->output) == data->count);
-
-	// value to beat to enter the list
+// value to beat to enter the list
+static double closest_match_pivot(ClosestMatchData *data) {
 	double pivot = data->score_threshold;
-	if (list_full) {
+	if (rz_list_length (data->output) == data->count) {
 		pivot = RZ_MAX (pivot, data->infimum);
 	}
+	return pivot;
+}
 
-	if (it->bytes && data->bytes_combined) {
-		int sizea = it->bytes->size;
+static double closest_match_graph(ClosestMatchData *data, RzSignItem *it, int *div) {
+	if (it->graph && data->test->graph) {
+		(*div)++;
+		return matchGraph (it, data->test);
+	}
+	return -1.0;
+}
+
+// bytes distance is slow. To avoid it, we can do quick maths to see if the
+// highest possible score would be good enough to change results
+static bool closest_match_bytes_hopeless(ClosestMatchData *data, double score, int div, int sizea) {
+	double pivot = closest_match_pivot (data);
+	if (pivot > 0.0) {
 		int sizeb = data->test->bytes->size;
-		if (pivot > 0.0) {
-			// bytes distance is slow. To avoid it, we can do quick maths to
-			// see if the highest possible score would be good enough to change
-			// results
-			double maxscore = RZ_MIN (sizea, sizeb) / RZ_MAX (sizea, sizeb);
-			if (div > 0) {
-				maxscore = (maxscore + score) / div;
-			}
-			if (maxscore < pivot) {
-				rz_sign_item_free (it);
-				return true;
-			}
+		double maxscore = RZ_MIN (sizea, sizeb) / RZ_MAX (sizea, sizeb);
+		if (div > 0) {
+			maxscore = (maxscore + score) / div;
+		}
+		if (maxscore < pivot) {
+			return true;
 		}
+	}
+	return false;
+}
 
+// quantify how close the signature matches, false if it would not enter the list
+static bool closest_match_score(ClosestMatchData *data, RzSignItem *it, RzSignCloseMatch *row) {
+	int div = 0;
+	double gscore = closest_match_graph (data, it, &div);
+	double score = div? gscore: 0.0;
+	double bscore = -1.0;
+	double pivot = closest_match_pivot (data);
+
+	if (it->bytes && data->bytes_combined) {
+		if (closest_match_bytes_hopeless (data, score, div, it->bytes->size)) {
+			return false;
+		}
 		// get true byte score
-		bscore = cmp_bytesig_to_buff (it->bytes, data->bytes_combined, sizeb);
+		bscore = cmp_bytesig_to_buff (it->bytes, data->bytes_combined, data->test->bytes->size);
 		score += bscore;
 		div++;
 	}
 	if (div == 0) {
-		rz_sign_item_free (it);
-		return true;
+		return false;
 	}
 	score /= div;
 
 	// score is too low, don't bother doing any more work
 	if (score < pivot) {
-		rz_sign_item_free (it);
-		return true;
-	}
-
-	// add new element
-	RzSignCloseMatch *row = RZ_NEW (RzSignCloseMatch);
-	if (!row) {
-		rz_sign_item_free (it);
 		return false;
 	}
 	row->score = score;
 	row->gscore = gscore;
 	row->bscore = bscore;
 	row->item = it;
+	return true;
+}
+
+static bool closest_match_insert(ClosestMatchData *data, RzSignCloseMatch *match) {
+	bool list_full = (rz_list_length (data->output) == data->count);
+	RzSignCloseMatch *row = RZ_NEW (RzSignCloseMatch);
+	if (!row) {
+		rz_sign_item_free (match->item);
+		return false;
+	}
+	*row = *match;
 	rz_list_add_sorted (data->output, (void *)row, &score_cmpr);
 
 	if (list_full) {
@@ -1335,20 +1355,25 @@ static bool closest_match_update(ClosestMatchData *data, RzSignItem *it) {
 	return true;
 }
 
-static bool closest_match_callback(void *a, const char *name, const char *value) {
-	ClosestMatchData *data = (ClosestMatchData *)a;
-
-	// get signature in usable format
-	RzSignItem *it = rz_sign_item_new ();
-	if (!it) {
-		return false;
-	}
-	if (!rz_sign_deserialize (a, it, name, value)) {
+// takes ownership of it
+static bool closest_match_update(ClosestMatchData *data, RzSignItem *it) {
+	RzSignCloseMatch match;
+	if (!closest_match_score (data, it, &match)) {
 		rz_sign_item_free (it);
-		return false;
+		return true;
 	}
+	return closest_match_insert (data, &match);
+}
 
-	return closest_match_update (data, it);
+static RzSignItem *item_dup(RzSignItem *it) {
+	RzSignItem *dup = rz_sign_item_new ();
+	if (!dup) {
+		return NULL;
+	}
+	dup->name = rz_str_new (it->name);
+	dup->space = it->space;
+	mergeItem (dup, it);
+	return dup;
 }
 
 RZ_API void rz_sign_close_match_free(RzSignCloseMatch *match) {
@@ -1382,9 +1407,20 @@ RZ_API RzList *rz_sign_find_closest_sig(RzAnalysis *a, RzSignItem *it, int count
 	}
 
 	// TODO: handle sign spaces
-	if (!sdb_foreach (a->sdb_zigns, &closest_match_callback, (void *)&data)) {
-		rz_list_free (output);
-		output = NULL;
+	RzSignIndex *idx = rz_sign_index_get (a);
+	size_t i, n = idx? rz_sign_index_count (idx): 0;
+	for (i = 0; i < n; i++) {
+		RzSignItem *sig = rz_sign_index_item (idx, i);
+		RzSignCloseMatch match;
+		if (!sig || !closest_match_score (&data, sig, &match)) {
+			continue;
+		}
+		// the index keeps its items, the output gets copies
+		if (!(match.item = item_dup (sig)) || !closest_match_insert (&data, &match)) {
+			rz_list_free (output);
+			output = NULL;
+			break;
+		}
 	}
 
 	free (data.bytes_combined);
@@ -1421,12 +1457,19 @@ RZ_API RzList *rz_sign_find_closest_fcn(RzAnalysis *a, RzSignItem *it, int count
 			rz_list_free (output);
 			return NULL;
 		}
-		if (data.bytes_combined) {
-			rz_sign_addto_item (a, fsig, fcn, RZ_SIGN_BYTES);
-		}
 		if (it->graph) {
 			rz_sign_addto_item (a, fsig, fcn, RZ_SIGN_GRAPH);
 		}
+		if (data.bytes_combined) {
+			// skip reading and masking the function if its size alone rules it out
+			int div = 0;
+			double gscore = closest_match_graph (&data, fsig, &div);
+			if (!rz_list_empty (fcn->bbs) && closest_match_bytes_hopeless (&data, div? gscore: 0.0, div, fcn_bytes_size (a, fcn))) {
+				rz_sign_item_free (fsig);
+				continue;
+			}
+			rz_sign_addto_item (a, fsig, fcn, RZ_SIGN_BYTES);
+		}
 		rz_sign_addto_item (a, fsig, fcn, RZ_SIGN_OFFSET);
 		fsig->name = rz_str_new (fcn->name);
 
@@ -2167,6 +2210,7 @@ static bool unsetForCB(void *user, const char *k, const char *v) {
 RZ_API void rz_sign_space_unset_for(RzAnalysis *a, const RzSpace *space) {
 	rz_return_if_fail (a);
 	struct ctxUnsetForCB ctx = { a, space };
+	rz_sign_index_invalidate (a);
 	sdb_foreach (a->sdb_zigns, unsetForCB, &ctx);
 }
 
@@ -2197,6 +2241,7 @@ RZ_API void rz_sign_space_rename_for(RzAnalysis *a, const RzSpace *space, const
 	struct ctxRenameForCB ctx = {.analysis = a};
 	serializeKeySpaceStr (a, oname, "", ctx.oprefix);
 	serializeKeySpaceStr (a, nname, "", ctx.nprefix);
+	rz_sign_index_invalidate (a);
 	sdb_foreach (a->sdb_zigns, renameForCB, &ctx);
 }
 
@@ -2495,10 +2540,102 @@ static int match_metrics(RzSignItem *it, void *user) {
 	return count? 0: 1;
 }
 
+static int ut32_cmp(const void *a, const void *b) {
+	ut32 x = *(const ut32 *)a, y = *(const ut32 *)b;
+	return x < y? -1: x > y;
+}
+
+// Collects from the index the zignatures that may match the function for any
+// of the requested types, in the order rz_sign_foreach would visit them.
+// RZ_SIGN_TYPES looks up vars and RZ_SIGN_VARS types, like match_metrics.
+static void match_candidates(RzSignIndex *idx, struct metric_ctx *ctx, RzVector *cands) {
+	RzSignSearchMetrics *sm = ctx->sm;
+	RzAnalysisFunction *fcn = sm->fcn;
+	RzSignType type;
+	int i = 0;
+	while ((type = sm->types[i++])) {
+		RzSignType key_type = type == RZ_SIGN_TYPES? RZ_SIGN_VARS: type == RZ_SIGN_VARS? RZ_SIGN_TYPES: type;
+		if (!rz_sign_index_has (idx, key_type)) {
+			// don't compute metrics no zignature has
+			continue;
+		}
+		switch (type) {
+		case RZ_SIGN_GRAPH: {
+			int ebbs = -1;
+			int cc = rz_analysis_function_complexity (fcn);
+			int nbbs = rz_list_length (fcn->bbs);
+			int edges = rz_analysis_function_count_edges (fcn, &ebbs);
+			rz_sign_index_find (idx, type, rz_sign_index_key_graph (cc, nbbs, edges, ebbs), cands);
+			break;
+		}
+		case RZ_SIGN_OFFSET:
+			rz_sign_index_find (idx, type, fcn->addr, cands);
+			break;
+		case RZ_SIGN_BBHASH:
+			if (!ctx->digest_hex) {
+				ctx->digest_hex = rz_sign_calc_bbhash (sm->analysis, fcn);
+			}
+			if (ctx->digest_hex) {
+				rz_sign_index_find (idx, type, rz_sign_index_key_str (ctx->digest_hex), cands);
+			}
+			break;
+		case RZ_SIGN_REFS:
+			if (!ctx->refs) {
+				ctx->refs = rz_sign_fcn_refs (sm->analysis, fcn);
+			}
+			if (ctx->refs) {
+				rz_sign_index_find (idx, RZ_SIGN_REFS, rz_sign_index_key_list (ctx->refs), cands);
+			}
+			break;
+		case RZ_SIGN_TYPES:
+			if (!ctx->vars) {
+				ctx->vars = rz_sign_fcn_vars (sm->analysis, fcn);
+			}
+			if (ctx->vars) {
+				rz_sign_index_find (idx, RZ_SIGN_VARS, rz_sign_index_key_list (ctx->vars), cands);
+			}
+			break;
+		case RZ_SIGN_VARS:
+			if (!ctx->types) {
+				ctx->types = rz_sign_fcn_types (sm->analysis, fcn);
+			}
+			if (ctx->types) {
+				rz_sign_index_find (idx, RZ_SIGN_TYPES, rz_sign_index_key_list (ctx->types), cands);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	if (!rz_vector_empty (cands)) {
+		qsort (cands->a, cands->len, cands->elem_size, ut32_cmp);
+	}
+}
+
 RZ_API int rz_sign_fcn_match_metrics(RzSignSearchMetrics *sm) {
 	rz_return_val_if_fail (sm && sm->mincc >= 0 && sm->analysis && sm->fcn, false);
 	struct metric_ctx ctx = { 0, sm, NULL, NULL, NULL, NULL };
-	rz_sign_foreach (sm->analysis, match_metrics, (void *)&ctx);
+	RzSignIndex *idx = rz_sign_index_get (sm->analysis);
+	if (idx) {
+		const RzSpace *cur = rz_spaces_current (&sm->analysis->zign_spaces);
+		RzVector cands;
+		rz_vector_init (&cands, sizeof (ut32), NULL, NULL);
+		match_candidates (idx, &ctx, &cands);
+		ut32 *n, last = UT32_MAX;
+		rz_vector_foreach (&cands, n) {
+			if (*n == last) {
+				continue;
+			}
+			last = *n;
+			RzSignItem *it = rz_sign_index_item (idx, *n);
+			if (it && it->space == cur) {
+				match_metrics (it, &ctx);
+			}
+		}
+		rz_vector_fini (&cands);
+	} else {
+		rz_sign_foreach (sm->analysis, match_metrics, (void *)&ctx);
+	}
 	rz_list_free (ctx.refs);
 	rz_list_free (ctx.types);
 	rz_list_free (ctx.vars);
@@ -2607,12 +2744,25 @@ RZ_API bool rz_sign_load(RzAnalysis *a, const char *file) {
 		free (path);
 		return false;
 	}
+	int n = 0;
+	char *magic = rz_file_slurp_range (path, 0, 8, &n);
+	bool is_index = magic && rz_sign_index_check ((const ut8 *)magic, n);
+	free (magic);
+	if (is_index) {
+		size_t size = 0;
+		char *buf = rz_file_slurp (path, &size);
+		bool ret = buf && rz_sign_index_load (a, (const ut8 *)buf, size);
+		free (buf);
+		free (path);
+		return ret;
+	}
 	Sdb *db = sdb_new (NULL, path, 0);
 	if (!db) {
 		free (path);
 		return false;
 	}
 	sdb_foreach (db, loadCB, a);
+	rz_sign_index_invalidate (a);
 	sdb_close (db);
 	sdb_free (db);
 	free (path);
@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include <rz_sign.h>
+#include "sign_private.h"
+
+// Compiled view of sdb_zigns. Every zignature gets an ordinal (its position in
+// sdb_foreach order) and the metrics used to match functions are stored as
+// (key, ordinal) pairs sorted by key, so matching a function is a handful of
+// binary searches instead of deserializing the whole database. Items are only
+// deserialized when they are looked at, and kept until the index is dropped.
+//
+// The same tables can be saved to disk (rz-sign -c) as fixed-width little
+// endian records followed by the sdb key/value pairs, and loaded back by
+// rz_sign_load without sorting or deserializing anything.
+
+#define SIGN_INDEX_MAGIC "RZZIGIDX"
+#define SIGN_INDEX_VERSION 1
+#define SIGN_INDEX_HDR 24
+#define SIGN_INDEX_REC 16
+
+enum {
+	SIGN_INDEX_OFFSET,
+	SIGN_INDEX_BBHASH,
+	SIGN_INDEX_GRAPH,
+	SIGN_INDEX_REFS,
+	SIGN_INDEX_VARS,
+	SIGN_INDEX_TYPES,
+	SIGN_INDEX_TABLES
+};
+
+typedef struct {
+	ut64 key;
+	ut32 idx;
+} SignIndexKey;
+
+struct rz_sign_index_t {
+	RzAnalysis *analysis;
+	RzPVector keys; // char *, sdb key of each ordinal
+	RzSignItem **items; // deserialized on demand
+	RzVector tables[SIGN_INDEX_TABLES]; // SignIndexKey, sorted by key
+};
+
+static int table_of(RzSignType type) {
+	switch (type) {
+	case RZ_SIGN_OFFSET: return SIGN_INDEX_OFFSET;
+	case RZ_SIGN_BBHASH: return SIGN_INDEX_BBHASH;
+	case RZ_SIGN_GRAPH: return SIGN_INDEX_GRAPH;
+	case RZ_SIGN_REFS: return SIGN_INDEX_REFS;
+	case RZ_SIGN_VARS: return SIGN_INDEX_VARS;
+	case RZ_SIGN_TYPES: return SIGN_INDEX_TYPES;
+	default: return -1;
+	}
+}
+
+static ut64 fnv1a(ut64 h, const void *data, size_t len) {
+	const ut8 *p = data;
+	size_t i;
+	for (i = 0; i < len; i++) {
+		h ^= p[i];
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+#define FNV_INIT 0xcbf29ce484222325ULL
+
+RZ_IPI ut64 rz_sign_index_key_str(const char *s) {
+	return fnv1a (FNV_INIT, s, strlen (s));
+}
+
+RZ_IPI ut64 rz_sign_index_key_list(RzList *list) {
+	RzListIter *iter;
+	const char *s;
+	ut64 h = FNV_INIT;
+	rz_list_foreach (list, iter, s) {
+		h = fnv1a (h, s, strlen (s) + 1);
+	}
+	return h;
+}
+
+RZ_IPI ut64 rz_sign_index_key_graph(int cc, int nbbs, int edges, int ebbs) {
+	if (cc == -1 || nbbs == -1 || edges == -1 || ebbs == -1) {
+		return RZ_SIGN_INDEX_ANY;
+	}
+	int v[4] = { cc, nbbs, edges, ebbs };
+	ut64 h = fnv1a (FNV_INIT, v, sizeof (v));
+	return h == RZ_SIGN_INDEX_ANY? 0: h;
+}
+
+static void add_key(RzSignIndex *idx, int table, ut64 key, ut32 n) {
+	SignIndexKey k = { key, n };
+	rz_vector_push (&idx->tables[table], &k);
+}
+
+static void index_item(RzSignIndex *idx, RzSignItem *it, ut32 n) {
+	if (it->addr != UT64_MAX) {
+		add_key (idx, SIGN_INDEX_OFFSET, it->addr, n);
+	}
+	if (it->hash && it->hash->bbhash && *it->hash->bbhash) {
+		add_key (idx, SIGN_INDEX_BBHASH, rz_sign_index_key_str (it->hash->bbhash), n);
+	}
+	if (it->graph) {
+		RzSignGraph *g = it->graph;
+		add_key (idx, SIGN_INDEX_GRAPH, rz_sign_index_key_graph (g->cc, g->nbbs, g->edges, g->ebbs), n);
+	}
+	if (it->refs) {
+		add_key (idx, SIGN_INDEX_REFS, rz_sign_index_key_list (it->refs), n);
+	}
+	if (it->vars) {
+		add_key (idx, SIGN_INDEX_VARS, rz_sign_index_key_list (it->vars), n);
+	}
+	if (it->types) {
+		add_key (idx, SIGN_INDEX_TYPES, rz_sign_index_key_list (it->types), n);
+	}
+}
+
+static int key_cmp(const void *a, const void *b) {
+	const SignIndexKey *ka = a, *kb = b;
+	if (ka->key != kb->key) {
+		return ka->key < kb->key? -1: 1;
+	}
+	return ka->idx < kb->idx? -1: ka->idx > kb->idx;
+}
+
+static RzSignIndex *index_new(RzAnalysis *a) {
+	RzSignIndex *idx = RZ_NEW0 (RzSignIndex);
+	if (!idx) {
+		return NULL;
+	}
+	idx->analysis = a;
+	rz_pvector_init (&idx->keys, free);
+	int i;
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		rz_vector_init (&idx->tables[i], sizeof (SignIndexKey), NULL, NULL);
+	}
+	return idx;
+}
+
+static bool index_items_alloc(RzSignIndex *idx) {
+	size_t count = rz_pvector_len (&idx->keys);
+	idx->items = RZ_NEWS0 (RzSignItem *, RZ_MAX (count, 1));
+	return idx->items != NULL;
+}
+
+static bool build_cb(void *user, const char *k, const char *v) {
+	RzSignIndex *idx = user;
+	RzSignItem *it = rz_sign_item_new ();
+	if (!it) {
+		return false;
+	}
+	if (rz_sign_deserialize (idx->analysis, it, k, v)) {
+		char *key = strdup (k);
+		if (!key || !rz_pvector_push (&idx->keys, key)) {
+			free (key);
+			rz_sign_item_free (it);
+			return false;
+		}
+		index_item (idx, it, rz_pvector_len (&idx->keys) - 1);
+	} else {
+		eprintf ("error: cannot deserialize zign\n");
+	}
+	rz_sign_item_free (it);
+	return true;
+}
+
+// Builds the index of every zignature in a->sdb_zigns, in all zignspaces.
+RZ_API RzSignIndex *rz_sign_index_new(RzAnalysis *a) {
+	rz_return_val_if_fail (a, NULL);
+	RzSignIndex *idx = index_new (a);
+	if (!idx) {
+		return NULL;
+	}
+	if (!sdb_foreach (a->sdb_zigns, build_cb, idx) || !index_items_alloc (idx)) {
+		rz_sign_index_free (idx);
+		return NULL;
+	}
+	int i;
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		RzVector *t = &idx->tables[i];
+		if (!rz_vector_empty (t)) {
+			qsort (t->a, t->len, t->elem_size, key_cmp);
+		}
+	}
+	return idx;
+}
+
+RZ_API void rz_sign_index_free(RzSignIndex *idx) {
+	if (!idx) {
+		return;
+	}
+	size_t i;
+	for (i = 0; idx->items && i < rz_pvector_len (&idx->keys); i++) {
+		rz_sign_item_free (idx->items[i]);
+	}
+	free (idx->items);
+	rz_pvector_fini (&idx->keys);
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		rz_vector_fini (&idx->tables[i]);
+	}
+	free (idx);
+}
+
+// Returns the index of a->sdb_zigns, building it if the zignatures changed
+// since it was last used.
+RZ_API RzSignIndex *rz_sign_index_get(RzAnalysis *a) {
+	rz_return_val_if_fail (a, NULL);
+	if (!a->zign_index) {
+		a->zign_index = rz_sign_index_new (a);
+	}
+	return a->zign_index;
+}
+
+// Must be called whenever sdb_zigns or the zignspaces are modified.
+RZ_API void rz_sign_index_invalidate(RzAnalysis *a) {
+	rz_return_if_fail (a);
+	rz_sign_index_free (a->zign_index);
+	a->zign_index = NULL;
+}
+
+RZ_API size_t rz_sign_index_count(RzSignIndex *idx) {
+	rz_return_val_if_fail (idx, 0);
+	return rz_pvector_len (&idx->keys);
+}
+
+// Returns the n-th zignature, owned by the index.
+RZ_API RzSignItem *rz_sign_index_item(RzSignIndex *idx, size_t n) {
+	rz_return_val_if_fail (idx, NULL);
+	if (n >= rz_pvector_len (&idx->keys)) {
+		return NULL;
+	}
+	if (!idx->items[n]) {
+		const char *k = rz_pvector_at (&idx->keys, n);
+		const char *v = sdb_const_get (idx->analysis->sdb_zigns, k, 0);
+		RzSignItem *it = v? rz_sign_item_new (): NULL;
+		if (it && !rz_sign_deserialize (idx->analysis, it, k, v)) {
+			rz_sign_item_free (it);
+			it = NULL;
+		}
+		idx->items[n] = it;
+	}
+	return idx->items[n];
+}
+
+static void find_key(RzVector *t, ut64 key, RzVector *out) {
+	size_t lo = 0, hi = rz_vector_len (t);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		SignIndexKey *k = rz_vector_index_ptr (t, mid);
+		if (k->key < key) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	for (; lo < rz_vector_len (t); lo++) {
+		SignIndexKey *k = rz_vector_index_ptr (t, lo);
+		if (k->key != key) {
+			break;
+		}
+		rz_vector_push (out, &k->idx);
+	}
+}
+
+// Appends to out (ut32) the ordinals of the zignatures whose metric of the
+// given type has this key. Graphs with unknown (-1) fields match any key.
+RZ_IPI void rz_sign_index_find(RzSignIndex *idx, RzSignType type, ut64 key, RzVector *out) {
+	int table = table_of (type);
+	if (table < 0) {
+		return;
+	}
+	find_key (&idx->tables[table], key, out);
+	if (table == SIGN_INDEX_GRAPH && key != RZ_SIGN_INDEX_ANY) {
+		find_key (&idx->tables[table], RZ_SIGN_INDEX_ANY, out);
+	}
+}
+
+RZ_IPI bool rz_sign_index_has(RzSignIndex *idx, RzSignType type) {
+	int table = table_of (type);
+	return table >= 0 && !rz_vector_empty (&idx->tables[table]);
+}
+
+static size_t align8(size_t n) {
+	return (n + 7) & ~(size_t)7;
+}
+
+// Writes the index of all zignatures in a to file.
+RZ_API bool rz_sign_index_save(RzAnalysis *a, const char *file) {
+	rz_return_val_if_fail (a && file, false);
+	RzSignIndex *idx = rz_sign_index_get (a);
+	if (!idx || !rz_sign_index_count (idx)) {
+		eprintf ("WARNING: no zignatures to save\n");
+		return false;
+	}
+	size_t count = rz_sign_index_count (idx);
+	size_t i, size = SIGN_INDEX_HDR + SIGN_INDEX_TABLES * 8;
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		size += rz_vector_len (&idx->tables[i]) * SIGN_INDEX_REC;
+	}
+	for (i = 0; i < count; i++) {
+		const char *k = rz_pvector_at (&idx->keys, i);
+		const char *v = sdb_const_get (a->sdb_zigns, k, 0);
+		size += align8 (8 + strlen (k) + (v? strlen (v): 0));
+	}
+	if (size > ST32_MAX) {
+		eprintf ("error: zignature index too big\n");
+		return false;
+	}
+	ut8 *buf = calloc (1, size);
+	if (!buf) {
+		return false;
+	}
+	memcpy (buf, SIGN_INDEX_MAGIC, 8);
+	rz_write_le32 (buf + 8, SIGN_INDEX_VERSION);
+	rz_write_le32 (buf + 12, (ut32)count);
+	rz_write_le32 (buf + 16, SIGN_INDEX_TABLES);
+	ut8 *p = buf + SIGN_INDEX_HDR;
+	for (i = 0; i < SIGN_INDEX_TABLES; i++, p += 8) {
+		rz_write_le64 (p, rz_vector_len (&idx->tables[i]));
+	}
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		SignIndexKey *k;
+		rz_vector_foreach (&idx->tables[i], k) {
+			rz_write_le64 (p, k->key);
+			rz_write_le32 (p + 8, k->idx);
+			p += SIGN_INDEX_REC;
+		}
+	}
+	for (i = 0; i < count; i++) {
+		const char *k = rz_pvector_at (&idx->keys, i);
+		const char *v = sdb_const_get (a->sdb_zigns, k, 0);
+		size_t klen = strlen (k), vlen = v? strlen (v): 0;
+		rz_write_le32 (p, (ut32)klen);
+		rz_write_le32 (p + 4, (ut32)vlen);
+		memcpy (p + 8, k, klen);
+		if (vlen) {
+			memcpy (p + 8 + klen, v, vlen);
+		}
+		p += align8 (8 + klen + vlen);
+	}
+	bool ret = rz_file_dump (file, buf, (int)size, false);
+	free (buf);
+	return ret;
+}
+
+RZ_IPI bool rz_sign_index_check(const ut8 *buf, size_t len) {
+	return buf && len >= 8 && !memcmp (buf, SIGN_INDEX_MAGIC, 8);
+}
+
+static bool load_tables(RzSignIndex *idx, const ut8 **pp, const ut8 *end, ut32 ntables, ut32 count) {
+	const ut8 *p = *pp;
+	ut64 lens[SIGN_INDEX_TABLES] = { 0 };
+	ut32 i;
+	if (end - p < (st64)ntables * 8) {
+		return false;
+	}
+	for (i = 0; i < ntables; i++, p += 8) {
+		if (i < SIGN_INDEX_TABLES) {
+			lens[i] = rz_read_le64 (p);
+		}
+	}
+	for (i = 0; i < SIGN_INDEX_TABLES; i++) {
+		if (lens[i] > (ut64)(end - p) / SIGN_INDEX_REC) {
+			return false;
+		}
+		RzVector *t = &idx->tables[i];
+		if (lens[i] && !rz_vector_reserve (t, lens[i])) {
+			return false;
+		}
+		ut64 j;
+		for (j = 0; j < lens[i]; j++, p += SIGN_INDEX_REC) {
+			SignIndexKey k = { rz_read_le64 (p), rz_read_le32 (p + 8) };
+			if (k.idx >= count) {
+				return false;
+			}
+			rz_vector_push (t, &k);
+		}
+	}
+	*pp = p;
+	return true;
+}
+
+// adds the zignspace of a zign|space|name key, as rz_sign_deserialize does
+static bool key_space_add(RzAnalysis *a, const char *k) {
+	if (strncmp (k, "zign|", 5)) {
+		return false;
+	}
+	const char *space = k + 5;
+	const char *end = strchr (space, '|');
+	if (!end || strchr (end + 1, '|')) {
+		return false;
+	}
+	if (end > space) {
+		char *name = rz_str_ndup (space, end - space);
+		if (!name) {
+			return false;
+		}
+		rz_spaces_add (&a->zign_spaces, name);
+		free (name);
+	}
+	return true;
+}
+
+// Loads a file written by rz_sign_index_save into a, creating the zignspaces
+// of its keys. The loaded tables become the index of a when there were no
+// zignatures before.
+RZ_IPI bool rz_sign_index_load(RzAnalysis *a, const ut8 *buf, size_t len) {
+	rz_return_val_if_fail (a && buf, false);
+	const ut8 *p = buf + SIGN_INDEX_HDR, *end = buf + len;
+	if (len < SIGN_INDEX_HDR || !rz_sign_index_check (buf, len) || rz_read_le32 (buf + 8) != SIGN_INDEX_VERSION) {
+		eprintf ("error: invalid zignature index\n");
+		return false;
+	}
+	ut32 count = rz_read_le32 (buf + 12);
+	ut32 ntables = rz_read_le32 (buf + 16);
+	bool adopt = sdb_isempty (a->sdb_zigns);
+	rz_sign_index_invalidate (a);
+	RzSignIndex *idx = index_new (a);
+	if (!idx || !load_tables (idx, &p, end, ntables, count)) {
+		eprintf ("error: invalid zignature index\n");
+		rz_sign_index_free (idx);
+		return false;
+	}
+	ut32 i;
+	for (i = 0; i < count; i++) {
+		if (end - p < 8) {
+			break;
+		}
+		ut32 klen = rz_read_le32 (p);
+		ut32 vlen = rz_read_le32 (p + 4);
+		if ((ut64)(end - p) - 8 < (ut64)klen + vlen) {
+			break;
+		}
+		char *k = rz_str_ndup ((const char *)p + 8, klen);
+		char *v = rz_str_ndup ((const char *)p + 8 + klen, vlen);
+		if (!k || !v || !key_space_add (a, k)) {
+			free (k);
+			free (v);
+			break;
+		}
+		sdb_set (a->sdb_zigns, k, v, 0);
+		free (v);
+		rz_pvector_push (&idx->keys, k);
+		p += RZ_MIN (align8 (8 + klen + vlen), (size_t)(end - p));
+	}
+	if (i < count) {
+		eprintf ("error: truncated or invalid zignature index\n");
+		rz_sign_index_free (idx);
+		return false;
+	}
+	if (adopt && index_items_alloc (idx)) {
+		a->zign_index = idx;
+	} else {
+		rz_sign_index_free (idx);
+	}
+	return true;
+}
@@ -0,0 +1,17 @@
+#ifndef _SIGN_PRIVATE_H_
+#define _SIGN_PRIVATE_H_
+
+#include <rz_sign.h>
+
+// graph key of zignatures with unknown metrics, they match any function
+#define RZ_SIGN_INDEX_ANY UT64_MAX
+
+RZ_IPI ut64 rz_sign_index_key_str(const char *s);
+RZ_IPI ut64 rz_sign_index_key_list(RzList *list);
+RZ_IPI ut64 rz_sign_index_key_graph(int cc, int nbbs, int edges, int ebbs);
+RZ_IPI bool rz_sign_index_has(RzSignIndex *idx, RzSignType type);
+RZ_IPI void rz_sign_index_find(RzSignIndex *idx, RzSignType type, ut64 key, RzVector *out);
+RZ_IPI bool rz_sign_index_check(const ut8 *buf, size_t len);
+RZ_IPI bool rz_sign_index_load(RzAnalysis *a, const ut8 *buf, size_t len);
+
+#endif
@@ -28,11 +28,11 @@ static char *create_type_name_from_offset(ut64 offset) {
  * @brief Parses class/struct/union member
  *
  * @param type_info Current type info (member)
- * @param types List of all types
+ * @param tpi Stream of all the types
  * @return RzAnalysisStructMember* parsed member, NULL if fail
  */
-static RzAnalysisStructMember *parse_member(STypeInfo *type_info, RzList *types) {
-	rz_return_val_if_fail (type_info && types, NULL);
+static RzAnalysisStructMember *parse_member(STypeInfo *type_info, STpiStream *tpi) {
+	rz_return_val_if_fail (type_info && tpi, NULL);
 	if (type_info->leaf_type != eLF_MEMBER) {
 		return NULL;
 	}
@@ -62,11 +62,11 @@ cleanup:
  * @brief Parse enum case
  *
  * @param type_info Current type info (enum case)
- * @param types List of all types
+ * @param tpi Stream of all the types
  * @return RzAnalysisEnumCase* parsed enum case, NULL if fail
  */
-static RzAnalysisEnumCase *parse_enumerate(STypeInfo *type_info, RzList *types) {
-	rz_return_val_if_fail (type_info && types && type_info->leaf_type == eLF_ENUMERATE, NULL);
+static RzAnalysisEnumCase *parse_enumerate(STypeInfo *type_info, STpiStream *tpi) {
+	rz_return_val_if_fail (type_info && tpi && type_info->leaf_type == eLF_ENUMERATE, NULL);
 	rz_return_val_if_fail (type_info->get_val && type_info->get_name, NULL);
 
 	char *name = NULL;
@@ -91,10 +91,10 @@ cleanup:
  *
  * @param analysis
  * @param type Current type
- * @param types List of all types
+ * @param tpi Stream of all the types
  */
-static void parse_enum(const RzAnalysis *analysis, SType *type, RzList *types) {
-	rz_return_if_fail (analysis && type && types);
+static void parse_enum(const RzAnalysis *analysis, SType *type, STpiStream *tpi) {
+	rz_return_if_fail (analysis && type && tpi);
 	STypeInfo *type_info = &type->type_data;
 	// assert all member functions we need info from
 	rz_return_if_fail (type_info->get_members &&
@@ -127,7 +127,7 @@ static void parse_enum(const RzAnalysis *analysis, SType *type, RzList *types) {
 	RzListIter *it = rz_list_iterator (members);
 	while (rz_list_iter_next (it)) {
 		STypeInfo *member_info = rz_list_iter_get (it);
-		RzAnalysisEnumCase *enum_case = parse_enumerate (member_info, types);
+		RzAnalysisEnumCase *enum_case = parse_enumerate (member_info, tpi);
 		if (!enum_case) {
 			continue; // skip it, move forward
 		}
@@ -155,10 +155,10 @@ cleanup:
  *
  * @param analysis
  * @param type Current type
- * @param types List of all types
+ * @param tpi Stream of all the types
  */
-static void parse_structure(const RzAnalysis *analysis, SType *type, RzList *types) {
-	rz_return_if_fail (analysis && type && types);
+static void parse_structure(const RzAnalysis *analysis, SType *type, STpiStream *tpi) {
+	rz_return_if_fail (analysis && type && tpi);
 	STypeInfo *type_info = &type->type_data;
 	// assert all member functions we need info from
 	rz_return_if_fail (type_info->get_members &&
@@ -187,7 +187,7 @@ static void parse_structure(const RzAnalysis *analysis, SType *type, RzList *typ
 	RzListIter *it = rz_list_iterator (members);
 	while (rz_list_iter_next (it)) {
 		STypeInfo *member_info = rz_list_iter_get (it);
-		RzAnalysisStructMember *struct_member = parse_member (member_info, types);
+		RzAnalysisStructMember *struct_member = parse_member (member_info, tpi);
 		if (!struct_member) {
 			continue; // skip the failure
 		}
@@ -218,10 +218,10 @@ cleanup:
  *
  * @param analysis
  * @param type Current type
- * @param types List of all types
+ * @param tpi Stream of all the types
  */
-static void parse_type (const RzAnalysis *analysis, SType *type, RzList *types) {
-	rz_return_if_fail (analysis && type && types);
+static void parse_type (const RzAnalysis *analysis, SType *type, STpiStream *tpi) {
+	rz_return_if_fail (analysis && type && tpi);
 
 	int is_forward_decl;
 	if (type->type_data.is_fwdref) {
@@ -234,10 +234,10 @@ static void parse_type (const RzAnalysis *analysis, SType *type, RzList *types)
 	case eLF_CLASS:
 	case eLF_STRUCTURE:
 	case eLF_UNION:
-		parse_structure (analysis, type, types);
+		parse_structure (analysis, type, tpi);
 		break;
 	case eLF_ENUM:
-		parse_enum (analysis, type, types);
+		parse_enum (analysis, type, tpi);
 		break;
 	default:
 		// shouldn't happen, happens when someone modifies leafs that get here
@@ -262,11 +262,15 @@ RZ_API void rz_parse_pdb_types(const RzAnalysis *analysis, const RzPdb *pdb) {
 		return;
 	}
 	// Types should be DAC - only references previous records
-	RzListIter *iter = rz_list_iterator (tpi_stream->types);
-	while (rz_list_iter_next (iter)) { // iterate all types
-		SType *type = rz_list_iter_get (iter);
-		if (type && is_parsable_type (type->type_data.leaf_type)) {
-			parse_type (analysis, type, tpi_stream->types);
+	ut32 idx, end = tpi_stream->header.idx_begin + tpi_stream->types_count;
+	for (idx = tpi_stream->header.idx_begin; idx < end; idx++) { // iterate all types
+		// records are parsed by get_type, skip the others before
+		if (!is_parsable_type (tpi_stream->get_leaf_type (tpi_stream, idx))) {
+			continue;
+		}
+		SType *type = tpi_stream->get_type (tpi_stream, idx);
+		if (type) {
+			parse_type (analysis, type, tpi_stream);
 		}
 	}
 }
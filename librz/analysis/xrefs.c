@@ -214,10 +214,12 @@ RZ_API void rz_analysis_xrefs_list(RzAnalysis *analysis, int rad) {
 		if (!pj) {
 			return;
 		}
+		rz_cons_pj_stream (pj);
 		pj_a (pj);
 	}
 	rz_list_foreach (list, iter, ref) {
 		int t = ref->type ? ref->type: ' ';
+		rz_cons_stream_flush ();
 		switch (rad) {
 		case '*':
 			analysis->cb_printf ("ax%c 0x%"PFMT64x" 0x%"PFMT64x"\n", t, ref->addr, ref->at);
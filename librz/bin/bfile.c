@@ -2,6 +2,7 @@
 
 #include <rz_bin.h>
 #include <rz_hash.h>
+#include <rz_th.h>
 #include "i/private.h"
 
 // maybe too big sometimes? 2KB of stack eaten here..
@@ -112,48 +113,142 @@ static void print_string(RzBinFile *bf, RzBinString *string, int raw, PJ *pj) {
 	}
 }
 
-static int string_scan_range(RzList *list, RzBinFile *bf, int min,
-			      const ut64 from, const ut64 to, int type, int raw, RzBinSection *section) {
-	RzBin *bin = bf->rbin;
-	ut8 tmp[RZ_STRING_SCAN_BUFFER_SIZE];
-	ut64 str_start, needle = from;
-	int count = 0, i, rc, runes;
-	int str_type = RZ_STRING_TYPE_DETECT;
-
-	// if list is null it means its gonna dump
-	rz_return_val_if_fail (bf, -1);
-
-	if (type == -1) {
-		type = RZ_STRING_TYPE_DETECT;
+// The range is scanned in chunks, several at once on their own threads. A
+// string starting in a chunk may run into the next one, so each chunk reads
+// up to RZ_STRING_SCAN_OVERLAP bytes past its end, enough for the longest
+// string a scan can produce.
+#define RZ_STRING_SCAN_CHUNK (1024 * 1024)
+#define RZ_STRING_SCAN_OVERLAP (4 * RZ_STRING_SCAN_BUFFER_SIZE + 16)
+#define RZ_STRING_SCAN_THREADS 16
+
+typedef struct str_scan_t StrScan;
+
+typedef struct {
+	const StrScan *scan;
+	ut64 from; // first address of the chunk
+	ut64 limit; // strings starting here or after belong to the next chunk
+	ut64 base; // address of buf[0], a few bytes before from for the BOM
+	ut64 end; // address after the last byte of buf
+	ut8 *buf;
+	RzList *strings; // paddr, size and string are set, the rest when merging
+	ut64 next; // first position at or after limit the scan looked at
+	// positions in [from, from + RZ_STRING_SCAN_OVERLAP) the scan looked
+	// for a string at, a scan reaching any of them goes on the same way
+	ut8 tops[RZ_STRING_SCAN_OVERLAP / 8];
+	bool breaked;
+	RzThread *thread;
+} StrChunk;
+
+struct str_scan_t {
+	RzBinFile *bf;
+	int min;
+	int type;
+	ut64 from; // the range being scanned
+	ut64 to;
+	// bytes no string can start with, which are skipped without decoding
+	bool boring[256];
+	// state while merging the chunks
+	RzList *list;
+	int raw;
+	PJ *pj;
+	int count;
+	RzBinSection *section;
+	RzBinSection *s;
+	st64 vdelta;
+	st64 pdelta;
+};
+
+static void scan_boring_init(StrScan *sc) {
+	int i;
+	for (i = 0; i < 256; i++) {
+		// these never decode, whatever the encoding
+		sc->boring[i] = (i >= 0x80 && i < 0xc0) || i >= 0xf8;
+	}
+	if (sc->type != RZ_STRING_TYPE_DETECT && sc->type != RZ_STRING_TYPE_ASCII && sc->type != RZ_STRING_TYPE_UTF8) {
+		// wide runes take the following bytes too
+		return;
 	}
-	if (from == to) {
-		return 0;
+	// control characters are neither printable nor escaped. In the wide
+	// cases the scan jumps over zeros only, so it still stops at the
+	// first byte that is not one of these.
+	for (i = 0; i < 0x20; i++) {
+		sc->boring[i] = !strchr ("\b\v\f\n\r\t\a\033", i) || !i;
 	}
-	if (from > to) {
-		eprintf ("Invalid range to find strings 0x%"PFMT64x" .. 0x%"PFMT64x"\n", from, to);
-		return -1;
+	sc->boring[0x7f] = true;
+}
+
+static inline void scan_top_set(StrChunk *c, ut64 at) {
+	if (at >= c->from && at - c->from < RZ_STRING_SCAN_OVERLAP) {
+		ut64 i = at - c->from;
+		c->tops[i / 8] |= 1 << (i % 8);
 	}
-	int len = to - from;
-	ut8 *buf = calloc (len, 1);
-	if (!buf || !min) {
-		free (buf);
-		return -1;
+}
+
+static inline bool scan_top_get(const StrChunk *c, ut64 at) {
+	if (at >= c->from && at - c->from < RZ_STRING_SCAN_OVERLAP) {
+		ut64 i = at - c->from;
+		return c->tops[i / 8] & (1 << (i % 8));
 	}
-	st64 vdelta = 0, pdelta = 0;
-	RzBinSection *s = NULL;
-	bool ascii_only = false;
-	PJ *pj = NULL;
-	if (bf->strmode == RZ_MODE_JSON && !list) {
-		pj = pj_new ();
-		if (pj) {
-			pj_a (pj);
+	return false;
+}
+
+// Returns the first position from needle on that is not boring
+static ut64 scan_skip(const StrScan *sc, const StrChunk *c, ut64 needle, ut64 limit) {
+	const ut8 *p = c->buf + needle - c->base;
+	const ut8 *end = c->buf + limit - c->base;
+	// zero and 0xff padding is most of what is not strings, eight bytes at a time
+	ut64 pad = sc->boring[0]? 0: UT64_MAX;
+	while (p + 8 <= end) {
+		ut64 w;
+		memcpy (&w, p, sizeof (w));
+		if (w != UT64_MAX && w != pad) {
+			break;
 		}
+		p += 8;
 	}
-	rz_buf_read_at (bf->buf, from, buf, len);
-	// may oobread
-	while (needle < to) {
-		if (bin && bin->consb.is_breaked) {
-			if (bin->consb.is_breaked ()) {
+	while (p < end && sc->boring[*p]) {
+		p++;
+	}
+	return c->base + (p - c->buf);
+}
+
+/* Scans the strings starting in [needle, c->limit) into out, returns where
+ * it stopped. With sync, it stops as soon as it looks for a string at one
+ * of the positions the scan of the chunk did, from there they are the same. */
+static ut64 scan_strings(const StrScan *sc, StrChunk *c, ut64 needle, RzList *out, const StrChunk *sync) {
+	RzBinFile *bf = sc->bf;
+	RzBin *bin = bf->rbin;
+	ut8 tmp[RZ_STRING_SCAN_BUFFER_SIZE];
+	// buf + needle - from is the byte at needle
+	const ut64 from = c->base, to = c->end;
+	const ut8 *buf = c->buf;
+	ut64 str_start;
+	int i, rc, runes;
+	int type = sc->type, min = sc->min;
+	int str_type = RZ_STRING_TYPE_DETECT;
+	bool ascii_only = false;
+
+	while (needle < c->limit) {
+		// after a retry for ascii only, the scan is not where any other could be
+		if (!ascii_only) {
+			if (sync && needle != sync->from && scan_top_get (sync, needle)) {
+				break;
+			}
+			if (sc->boring[buf[needle - from]]) {
+				ut64 next = scan_skip (sc, c, needle, c->limit);
+				if (!sync) {
+					for (; needle < next && needle - c->from < RZ_STRING_SCAN_OVERLAP; needle++) {
+						scan_top_set (c, needle);
+					}
+				}
+				needle = next;
+				continue;
+			}
+			if (!sync) {
+				scan_top_set (c, needle);
+			}
+			if (bin && bin->consb.is_breaked && bin->consb.is_breaked ()) {
+				c->breaked = true;
 				break;
 			}
 		}
@@ -250,16 +345,6 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			// reduce false positives
 			int j, num_blocks, *block_list;
 			int *freq_list = NULL, expected_ascii, actual_ascii, num_chars;
-			if (str_type == RZ_STRING_TYPE_ASCII) {
-				for (j = 0; j < i; j++) {
-					char ch = tmp[j];
-					if (ch != '\n' && ch != '\r' && ch != '\t') {
-						if (!IS_PRINTABLE (tmp[j])) {
-							continue;
-						}
-					}
-				}
-			}
 			switch (str_type) {
 			case RZ_STRING_TYPE_UTF8:
 			case RZ_STRING_TYPE_WIDE:
@@ -302,7 +387,8 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 			bs->type = str_type;
 			bs->length = runes;
 			bs->size = needle - str_start;
-			bs->ordinal = count++;
+			// where the scan found it, for the merge, see scan_merge
+			bs->ordinal = str_start - c->from;
 			// TODO: move into adjust_offset
 			switch (str_type) {
 			case RZ_STRING_TYPE_WIDE:
@@ -322,45 +408,199 @@ static int string_scan_range(RzList *list, RzBinFile *bf, int min,
 				}
 				break;
 			}
-			if (!s) {
-				if (section) {
-					s = section;
-				} else if (bf->o) {
-					s = rz_bin_get_section_at (bf->o, str_start, false);
-				}
-				if (s) {
-					vdelta = s->vaddr;
-					pdelta = s->paddr;
-				}
-			}
 			bs->paddr = str_start;
-			bs->vaddr = str_start - pdelta + vdelta;
 			bs->string = rz_str_ndup ((const char *)tmp, i);
-			if (list) {
-				rz_list_append (list, bs);
-				if (bf->o) {
-					ht_up_insert (bf->o->strings_db, bs->vaddr, bs);
+			rz_list_append (out, bs);
+		}
+		ascii_only = false;
+	}
+	return needle;
+}
+
+static void scan_chunk(StrChunk *c) {
+	c->next = scan_strings (c->scan, c, c->from, c->strings, NULL);
+}
+
+static RzThreadFunctionRet scan_chunk_th(RzThread *th) {
+	scan_chunk (th->user);
+	return RZ_TH_STOP;
+}
+
+static void scan_emit(StrScan *sc, RzBinString *bs) {
+	RzBinFile *bf = sc->bf;
+	bs->ordinal = sc->count++;
+	if (!sc->s) {
+		if (sc->section) {
+			sc->s = sc->section;
+		} else if (bf->o) {
+			sc->s = rz_bin_get_section_at (bf->o, bs->paddr, false);
+		}
+		if (sc->s) {
+			sc->vdelta = sc->s->vaddr;
+			sc->pdelta = sc->s->paddr;
+		}
+	}
+	bs->vaddr = bs->paddr - sc->pdelta + sc->vdelta;
+	if (sc->list) {
+		rz_list_append (sc->list, bs);
+		if (bf->o) {
+			ht_up_insert (bf->o->strings_db, bs->vaddr, bs);
+		}
+	} else {
+		print_string (bf, bs, sc->raw, sc->pj);
+		rz_bin_string_free (bs);
+	}
+	if (sc->from == 0 && sc->to == bf->size) {
+		/* force lookup section at the next one */
+		sc->s = NULL;
+	}
+}
+
+/* Emits the strings of c in address order, *at is where the scan of the
+ * previous chunk stopped, which may be past the start of this one when its
+ * last string ran into it. Returns false when the scan was interrupted. */
+static bool scan_merge(StrScan *sc, StrChunk *c, ut64 *at) {
+	ut64 sync = c->from;
+	if (*at != c->from && !scan_top_get (c, *at)) {
+		// scan from there until it meets the scan of the chunk
+		RzList *head = rz_list_new ();
+		if (!head) {
+			return false;
+		}
+		sync = scan_strings (sc, c, *at, head, c);
+		RzBinString *bs;
+		while ((bs = rz_list_pop_head (head))) {
+			scan_emit (sc, bs);
+		}
+		rz_list_free (head);
+		if (sync >= c->limit) {
+			// they never met, all the strings come from the scan above
+			*at = sync;
+			return !c->breaked;
+		}
+	} else if (*at != c->from) {
+		sync = *at;
+	}
+	RzBinString *bs;
+	while ((bs = rz_list_pop_head (c->strings))) {
+		if (c->from + bs->ordinal < sync) {
+			rz_bin_string_free (bs);
+			continue;
+		}
+		scan_emit (sc, bs);
+	}
+	*at = c->next;
+	return !c->breaked;
+}
+
+static int string_scan_range(RzList *list, RzBinFile *bf, int min,
+			      const ut64 from, const ut64 to, int type, int raw, RzBinSection *section) {
+	RzBin *bin = bf->rbin;
+
+	// if list is null it means its gonna dump
+	rz_return_val_if_fail (bf, -1);
+
+	if (type == -1) {
+		type = RZ_STRING_TYPE_DETECT;
+	}
+	if (from == to) {
+		return 0;
+	}
+	if (from > to) {
+		eprintf ("Invalid range to find strings 0x%"PFMT64x" .. 0x%"PFMT64x"\n", from, to);
+		return -1;
+	}
+	if (!min) {
+		return -1;
+	}
+	StrScan *sc = RZ_NEW0 (StrScan);
+	ut64 nchunks = (to - from + RZ_STRING_SCAN_CHUNK - 1) / RZ_STRING_SCAN_CHUNK;
+	int i, nthreads = RZ_MIN (RZ_MIN (rz_th_cpu_count (), RZ_STRING_SCAN_THREADS), nchunks);
+	StrChunk *chunks = RZ_NEWS0 (StrChunk, nthreads);
+	if (!sc || !chunks) {
+		free (sc);
+		free (chunks);
+		return -1;
+	}
+	sc->bf = bf;
+	sc->min = min;
+	sc->type = type;
+	sc->from = from;
+	sc->to = to;
+	sc->list = list;
+	sc->raw = raw;
+	sc->section = section;
+	scan_boring_init (sc);
+	if (bf->strmode == RZ_MODE_JSON && !list) {
+		sc->pj = pj_new ();
+		if (sc->pj) {
+			pj_a (sc->pj);
+		}
+	}
+	bool ok = true;
+	for (i = 0; i < nthreads && ok; i++) {
+		StrChunk *c = &chunks[i];
+		c->scan = sc;
+		c->strings = rz_list_newf (rz_bin_string_free);
+		c->buf = malloc (RZ_STRING_SCAN_CHUNK + RZ_STRING_SCAN_OVERLAP + 4);
+		ok = c->strings && c->buf;
+	}
+	// at most nthreads chunks are in memory, the next round starts when
+	// all of them are merged
+	ut64 at = from, chunk_from = from;
+	while (ok && chunk_from < to) {
+		int n;
+		for (n = 0; n < nthreads && chunk_from < to; n++) {
+			StrChunk *c = &chunks[n];
+			c->from = chunk_from;
+			c->limit = RZ_MIN (to, chunk_from + RZ_STRING_SCAN_CHUNK);
+			c->base = RZ_MAX (from, chunk_from >= 4? chunk_from - 4: 0);
+			c->end = RZ_MIN (to, c->limit + RZ_STRING_SCAN_OVERLAP);
+			c->next = c->limit;
+			c->breaked = false;
+			memset (c->tops, 0, sizeof (c->tops));
+			// rz_buf is not thread safe, the chunks are read here
+			st64 len = c->end - c->base;
+			st64 r = rz_buf_read_at (bf->buf, c->base, c->buf, len);
+			memset (c->buf + RZ_MAX (r, 0), 0, len - RZ_MAX (r, 0));
+			chunk_from = c->limit;
+		}
+		if (n == 1) {
+			scan_chunk (&chunks[0]);
+		} else {
+			for (i = 0; i < n; i++) {
+				chunks[i].thread = rz_th_new (scan_chunk_th, &chunks[i], 0);
+				if (!chunks[i].thread) {
+					scan_chunk (&chunks[i]);
 				}
-			} else {
-				print_string (bf, bs, raw, pj);
-				rz_bin_string_free (bs);
 			}
-			if (from == 0 && to == bf->size) {
-				/* force lookup section at the next one */
-				s = NULL;
+			for (i = 0; i < n; i++) {
+				if (chunks[i].thread) {
+					rz_th_wait (chunks[i].thread);
+					rz_th_free (chunks[i].thread);
+					chunks[i].thread = NULL;
+				}
 			}
 		}
-		ascii_only = false;
+		for (i = 0; i < n && ok; i++) {
+			ok = scan_merge (sc, &chunks[i], &at);
+		}
 	}
-	free (buf);
-	if (pj) {
-		pj_end (pj);
+	for (i = 0; i < nthreads; i++) {
+		rz_list_free (chunks[i].strings);
+		free (chunks[i].buf);
+	}
+	free (chunks);
+	if (sc->pj) {
+		pj_end (sc->pj);
 		RzIO *io = bin->iob.io;
 		if (io) {
-			io->cb_printf ("%s\n", pj_string (pj));
+			io->cb_printf ("%s\n", pj_string (sc->pj));
 		}
-		pj_free (pj);
+		pj_free (sc->pj);
 	}
+	int count = sc->count;
+	free (sc);
 	return count;
 }
 
@@ -725,6 +965,7 @@ RZ_API void rz_bin_file_free(void /*RzBinFile*/ *_bf) {
 		sdb_free (bf->sdb_addrinfo);
 		bf->sdb_addrinfo = NULL;
 	}
+	rz_bin_dwarf_line_table_free (bf->addrline);
 	free (bf->file);
 	rz_bin_object_free (bf->o);
 	rz_list_free (bf->xtr_data);
@@ -791,7 +1032,7 @@ RZ_API RzBinPlugin *rz_bin_file_cur_plugin(RzBinFile *bf) {
 }
 
 // TODO: searchStrings() instead
-RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *bf, int min, int dump, int raw) {
+RZ_IPI RzList *rz_bin_file_strings(RzBinFile *bf, int min, int dump, int raw) {
 	rz_return_val_if_fail (bf, NULL);
 	RzListIter *iter;
 	RzBinSection *section;
@@ -1064,8 +1305,70 @@ RZ_API RzList *rz_bin_file_get_trycatch(RzBinFile *bf) {
 	return NULL;
 }
 
+static RzBinObject *file_load(RzBinFile *bf, ut64 item) {
+	RzBinObject *o = bf->o;
+	if (o && !(o->loaded & item)) {
+		rz_bin_object_load_items (bf, o, item);
+	}
+	return o;
+}
+
 RZ_API RzList *rz_bin_file_get_symbols(RzBinFile *bf) {
 	rz_return_val_if_fail (bf, NULL);
-	RzBinObject *o = bf->o;
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_SYMBOLS);
 	return o? o->symbols: NULL;
 }
+
+RZ_API RzList *rz_bin_file_get_entries(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_ENTRIES);
+	return o? o->entries: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_fields(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_FIELDS);
+	return o? o->fields: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_imports(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_IMPORTS);
+	return o? o->imports: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_libs(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_LIBS);
+	return o? o->libs: NULL;
+}
+
+RZ_API RBNode *rz_bin_file_get_relocs(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_RELOCS);
+	return o? o->relocs: NULL;
+}
+
+// sections are always loaded with the object, this is here for symmetry
+RZ_API RzList *rz_bin_file_get_sections(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	return bf->o? bf->o->sections: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_strings(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_STRINGS);
+	return o? o->strings: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_classes(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_CLASSES);
+	return o? o->classes: NULL;
+}
+
+RZ_API RzList *rz_bin_file_get_lines(RzBinFile *bf) {
+	rz_return_val_if_fail (bf, NULL);
+	RzBinObject *o = file_load (bf, RZ_BIN_REQ_SRCLINE);
+	return o? o->lines: NULL;
+}
@@ -97,12 +97,12 @@ RZ_API void rz_bin_xtrdata_free(void /*RzBinXtrData*/ *data_) {
 
 RZ_API RzList *rz_bin_raw_strings(RzBinFile *bf, int min) {
 	rz_return_val_if_fail (bf, NULL);
-	return rz_bin_file_get_strings (bf, min, 0, 2);
+	return rz_bin_file_strings (bf, min, 0, 2);
 }
 
 RZ_API RzList *rz_bin_dump_strings(RzBinFile *bf, int min, int raw) {
 	rz_return_val_if_fail (bf, NULL);
-	return rz_bin_file_get_strings (bf, min, 1, raw);
+	return rz_bin_file_strings (bf, min, 1, raw);
 }
 
 RZ_API void rz_bin_options_init(RzBinOptions *opt, int fd, ut64 baseaddr, ut64 loadaddr, int rawstr) {
@@ -663,20 +663,20 @@ RZ_API RzBinAddr *rz_bin_get_sym(RzBin *bin, int sym) {
 // XXX: those accessors are redundant
 RZ_API RzList *rz_bin_get_entries(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->entries : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_entries (bf): NULL;
 }
 
 RZ_API RzList *rz_bin_get_fields(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->fields : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_fields (bf): NULL;
 }
 
 RZ_API RzList *rz_bin_get_imports(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->imports : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_imports (bf): NULL;
 }
 
 RZ_API RzBinInfo *rz_bin_get_info(RzBin *bin) {
@@ -687,8 +687,8 @@ RZ_API RzBinInfo *rz_bin_get_info(RzBin *bin) {
 
 RZ_API RzList *rz_bin_get_libs(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->libs : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_libs (bf): NULL;
 }
 
 static RzList *relocs_rbtree2list(RBNode *root) {
@@ -717,8 +717,8 @@ RZ_API RzList *rz_bin_patch_relocs_list(RzBin *bin) {
 
 RZ_API RBNode *rz_bin_get_relocs(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->relocs : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_relocs (bf): NULL;
 }
 
 // return a list of <const RzBinReloc> that needs to be freed by the caller
@@ -766,12 +766,13 @@ RZ_API RzList *rz_bin_reset_strings(RzBin *bin) {
 	}
 
 	bf->rawstr = bin->rawstr;
+	bf->o->loaded |= RZ_BIN_REQ_STRINGS;
 	RzBinPlugin *plugin = rz_bin_file_cur_plugin (bf);
 
 	if (plugin && plugin->strings) {
 		bf->o->strings = plugin->strings (bf);
 	} else {
-		bf->o->strings = rz_bin_file_get_strings (bf, bin->minstrlen, 0, bf->rawstr);
+		bf->o->strings = rz_bin_file_strings (bf, bin->minstrlen, 0, bf->rawstr);
 	}
 	if (bin->debase64) {
 		rz_bin_object_filter_strings (bf->o);
@@ -781,8 +782,8 @@ RZ_API RzList *rz_bin_reset_strings(RzBin *bin) {
 
 RZ_API RzList *rz_bin_get_strings(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->strings : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_strings (bf): NULL;
 }
 
 RZ_API int rz_bin_is_string(RzBin *bin, ut64 va) {
@@ -805,8 +806,8 @@ RZ_API int rz_bin_is_string(RzBin *bin, ut64 va) {
 
 RZ_API RzList *rz_bin_get_symbols(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o? o->symbols: NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_symbols (bf): NULL;
 }
 
 RZ_API RzList *rz_bin_get_mem(RzBin *bin) {
@@ -824,7 +825,8 @@ RZ_API int rz_bin_is_big_endian(RzBin *bin) {
 RZ_API int rz_bin_is_static(RzBin *bin) {
 	rz_return_val_if_fail (bin, false);
 	RzBinObject *o = rz_bin_cur_object (bin);
-	if (o && o->libs && rz_list_length (o->libs) > 0) {
+	RzList *libs = rz_bin_get_libs (bin);
+	if (o && libs && rz_list_length (libs) > 0) {
 		return RZ_BIN_DBG_STATIC & o->info->dbg_info;
 	}
 	return true;
@@ -1272,8 +1274,8 @@ RZ_API RzBuffer *rz_bin_package(RzBin *bin, const char *type, const char *file,
 
 RZ_API RzList * /*<RzBinClass>*/ rz_bin_get_classes(RzBin *bin) {
 	rz_return_val_if_fail (bin, NULL);
-	RzBinObject *o = rz_bin_cur_object (bin);
-	return o ? o->classes : NULL;
+	RzBinFile *bf = rz_bin_cur (bin);
+	return bf? rz_bin_file_get_classes (bf): NULL;
 }
 
 /* returns vaddr, rebased with the baseaddr of bin, if va is enabled for bin,
@@ -68,8 +68,7 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 	rz_return_val_if_fail (binfile, RZ_BIN_NM_NONE);
 	rz_return_val_if_fail (binfile->o, RZ_BIN_NM_NONE);
 	rz_return_val_if_fail (binfile->o->info, RZ_BIN_NM_NONE);
-	RzBinObject *o = binfile->o;
-	RzBinInfo *info = o->info;
+	RzBinInfo *info = binfile->o->info;
 	RzBinSymbol *sym;
 	RzListIter *iter, *iter2;
 	Langs cantbe = {0};
@@ -90,9 +89,10 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 	if (unknownType || !(isMacho || isElf || isPe)) {
 		return RZ_BIN_NM_NONE;
 	}
+	RzList *libs = rz_bin_file_get_libs (binfile);
 
 	// check in imports . can be slow
-	rz_list_foreach (o->imports, iter, sym) {
+	rz_list_foreach (rz_bin_file_get_imports (binfile), iter, sym) {
 		const char *name = sym->name;
 		if (!strcmp (name, "_NSConcreteGlobalBlock")) {
 			isBlocks = true;
@@ -102,7 +102,7 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 		}
 	}
 
-	rz_list_foreach (o->symbols, iter, sym) {
+	rz_list_foreach (rz_bin_file_get_symbols (binfile), iter, sym) {
 		char *lib;
 		if (!cantbe.rust) {
 			if (check_rust (sym)) {
@@ -117,7 +117,7 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 		if (!cantbe.swift) {
 			bool hasswift = false;
 			if (!swiftIsChecked) {
-				rz_list_foreach (o->libs, iter2, lib) {
+				rz_list_foreach (libs, iter2, lib) {
 					if (strstr (lib, "swift")) {
 						hasswift = true;
 						break;
@@ -133,7 +133,7 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 		if (!cantbe.cxx) {
 			bool hascxx = false;
 			if (!cxxIsChecked) {
-				rz_list_foreach (o->libs, iter2, lib) {
+				rz_list_foreach (libs, iter2, lib) {
 					if (strstr (lib, "stdc++") ||
 					    strstr (lib, "c++")) {
 						hascxx = true;
@@ -160,7 +160,7 @@ RZ_API int rz_bin_load_languages(RzBinFile *binfile) {
 		if (!cantbe.dlang) {
 			bool hasdlang = false;
 			if (!phobosIsChecked) {
-				rz_list_foreach (o->libs, iter2, lib) {
+				rz_list_foreach (libs, iter2, lib) {
 					if (strstr (lib, "phobos")) {
 						hasdlang = true;
 						break;
@@ -267,15 +267,147 @@ static void rz_bin_object_rebuild_classes_ht(RzBinObject *o) {
 	}
 }
 
+// Items loaded by rz_bin_object_load_items, the others are loaded on open
+#define OBJECT_ITEMS (RZ_BIN_REQ_ENTRIES | RZ_BIN_REQ_FIELDS | RZ_BIN_REQ_IMPORTS \
+	| RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_LIBS | RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_STRINGS \
+	| RZ_BIN_REQ_CLASSES | RZ_BIN_REQ_SRCLINE)
+
+static bool object_want(RzBinObject *o, ut64 items, ut64 item) {
+	if (!(items & item) || (o->loaded & item)) {
+		return false;
+	}
+	// set before loading, so that a plugin asking for it gets what there is
+	o->loaded |= item;
+	return true;
+}
+
+static void object_load_classes(RzBinFile *bf, RzBinObject *o) {
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	// swift and plugins without classes get them from the symbols
+	rz_bin_object_load_items (bf, o, RZ_BIN_REQ_SYMBOLS);
+	if (p->classes) {
+		RzList *classes = p->classes (bf);
+		if (classes) {
+			// XXX we should probably merge them instead
+			rz_list_free (o->classes);
+			o->classes = classes;
+			rz_bin_object_rebuild_classes_ht (o);
+		}
+		if (rz_bin_lang_swift (bf)) {
+			o->lang = RZ_BIN_NM_SWIFT;
+			o->classes = classes_from_symbols (bf);
+		}
+	} else {
+		RzList *classes = classes_from_symbols (bf);
+		if (classes) {
+			o->classes = classes;
+		}
+	}
+	if (bin->filter) {
+		filter_classes (bf, o->classes);
+	}
+	// cache addr=class+method
+	if (o->classes) {
+		RzList *klasses = o->classes;
+		RzListIter *iter, *iter2;
+		RzBinClass *klass;
+		RzBinSymbol *method;
+		if (!o->addrzklassmethod) {
+			// this is slow. must be optimized, but at least its cached
+			o->addrzklassmethod = sdb_new0 ();
+			rz_list_foreach (klasses, iter, klass) {
+				rz_list_foreach (klass->methods, iter2, method) {
+					char *km = sdb_fmt ("method.%s.%s", klass->name, method->name);
+					char *at = sdb_fmt ("0x%08"PFMT64x, method->vaddr);
+					sdb_set (o->addrzklassmethod, at, km, 0);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * \brief Load the items of \p o in \p items (RZ_BIN_REQ_*) that are not loaded yet
+ *
+ * With bin.lazy set, rz_bin_object_set_items leaves them for the accessors
+ * (rz_bin_file_get_symbols and friends) to load on first access.
+ */
+RZ_API void rz_bin_object_load_items(RzBinFile *bf, RzBinObject *o, ut64 items) {
+	rz_return_if_fail (bf && o && o->plugin);
+	RzBin *bin = bf->rbin;
+	RzBinPlugin *p = o->plugin;
+	if (object_want (o, items, RZ_BIN_REQ_ENTRIES) && p->entries) {
+		o->entries = p->entries (bf);
+		REBASE_PADDR (o, o->entries, RzBinAddr);
+	}
+	if (object_want (o, items, RZ_BIN_REQ_FIELDS) && p->fields) {
+		o->fields = p->fields (bf);
+		if (o->fields) {
+			o->fields->free = rz_bin_field_free;
+			REBASE_PADDR (o, o->fields, RzBinField);
+		}
+	}
+	if (object_want (o, items, RZ_BIN_REQ_IMPORTS) && p->imports) {
+		rz_list_free (o->imports);
+		o->imports = p->imports (bf);
+		if (o->imports) {
+			o->imports->free = rz_bin_import_free;
+		}
+	}
+	if (object_want (o, items, RZ_BIN_REQ_SYMBOLS) && p->symbols) {
+		o->symbols = p->symbols (bf); // 5s
+		if (o->symbols) {
+			o->symbols->free = rz_bin_symbol_free;
+			REBASE_PADDR (o, o->symbols, RzBinSymbol);
+			if (bin->filter) {
+				rz_bin_filter_symbols (bf, o->symbols); // 5s
+			}
+		}
+		if (bin->lazy && o->info && !o->lang) {
+			// the language is guessed from the symbols, so it is known only now
+			rz_bin_object_load_items (bf, o, RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_LIBS);
+			o->lang = rz_bin_load_languages (bf);
+		}
+	}
+	if (object_want (o, items, RZ_BIN_REQ_LIBS) && p->libs) {
+		o->libs = p->libs (bf);
+	}
+	if (object_want (o, items, RZ_BIN_REQ_RELOCS) && p->relocs) {
+		RzList *l = p->relocs (bf);
+		if (l) {
+			REBASE_PADDR (o, l, RzBinReloc);
+			o->relocs = list2rbtree (l);
+			l->free = NULL;
+			rz_list_free (l);
+		}
+	}
+	if (object_want (o, items, RZ_BIN_REQ_STRINGS)) {
+		int minlen = (bin->minstrlen > 0) ? bin->minstrlen : p->minstrlen;
+		o->strings = p->strings
+			? p->strings (bf)
+			: rz_bin_file_strings (bf, minlen, 0, bf->rawstr);
+		if (bin->debase64) {
+			rz_bin_object_filter_strings (o);
+		}
+		REBASE_PADDR (o, o->strings, RzBinString);
+	}
+	if (object_want (o, items, RZ_BIN_REQ_CLASSES)) {
+		object_load_classes (bf, o);
+	}
+	if (object_want (o, items, RZ_BIN_REQ_SRCLINE) && p->lines) {
+		o->lines = p->lines (bf);
+	}
+}
+
 RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	rz_return_val_if_fail (bf && o && o->plugin, false);
 
 	int i;
-	bool isSwift = false;
 	RzBin *bin = bf->rbin;
 	RzBinPlugin *p = o->plugin;
-	int minlen = (bf->rbin->minstrlen > 0) ? bf->rbin->minstrlen : p->minstrlen;
 	bf->o = o;
+	o->loaded = 0;
 
 	if (p->file_type) {
 		int type = p->file_type (bf);
@@ -307,38 +439,19 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			}
 		}
 	}
-	if (p->entries) {
-		o->entries = p->entries (bf);
-		REBASE_PADDR (o, o->entries, RzBinAddr);
-	}
-	if (p->fields) {
-		o->fields = p->fields (bf);
-		if (o->fields) {
-			o->fields->free = rz_bin_field_free;
-			REBASE_PADDR (o, o->fields, RzBinField);
-		}
-	}
-	if (p->imports) {
-		rz_list_free (o->imports);
-		o->imports = p->imports (bf);
-		if (o->imports) {
-			o->imports->free = rz_bin_import_free;
-		}
-	}
-	if (p->symbols) {
-		o->symbols = p->symbols (bf); // 5s
-		if (o->symbols) {
-			o->symbols->free = rz_bin_symbol_free;
-			REBASE_PADDR (o, o->symbols, RzBinSymbol);
-			if (bin->filter) {
-				rz_bin_filter_symbols (bf, o->symbols); // 5s
-			}
+	ut64 items = 0;
+	if (!bin->lazy) {
+		items = OBJECT_ITEMS;
+		if (!(bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS))) {
+			items &= ~RZ_BIN_REQ_RELOCS;
 		}
+		items &= ~(~bin->filter_rules & (RZ_BIN_REQ_STRINGS | RZ_BIN_REQ_CLASSES));
+		// keep the order plugins expect: symbols before info, libs before sections
+		rz_bin_object_load_items (bf, o, items & (RZ_BIN_REQ_ENTRIES | RZ_BIN_REQ_FIELDS
+			| RZ_BIN_REQ_IMPORTS | RZ_BIN_REQ_SYMBOLS));
 	}
 	o->info = p->info? p->info (bf): NULL;
-	if (p->libs) {
-		o->libs = p->libs (bf);
-	}
+	rz_bin_object_load_items (bf, o, items & RZ_BIN_REQ_LIBS);
 	if (p->sections) {
 		// XXX sections are populated by call to size
 		if (!o->sections) {
@@ -349,69 +462,10 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 			rz_bin_filter_sections (bf, o->sections);
 		}
 	}
-	if (bin->filter_rules & (RZ_BIN_REQ_RELOCS | RZ_BIN_REQ_IMPORTS)) {
-		if (p->relocs) {
-			RzList *l = p->relocs (bf);
-			if (l) {
-				REBASE_PADDR (o, l, RzBinReloc);
-				o->relocs = list2rbtree (l);
-				l->free = NULL;
-				rz_list_free (l);
-			}
-		}
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_STRINGS) {
-		o->strings = p->strings
-			? p->strings (bf)
-			: rz_bin_file_get_strings (bf, minlen, 0, bf->rawstr);
-		if (bin->debase64) {
-			rz_bin_object_filter_strings (o);
-		}
-		REBASE_PADDR (o, o->strings, RzBinString);
-	}
-	if (bin->filter_rules & RZ_BIN_REQ_CLASSES) {
-		if (p->classes) {
-			RzList *classes = p->classes (bf);
-			if (classes) {
-				// XXX we should probably merge them instead
-				rz_list_free (o->classes);
-				o->classes = classes;
-				rz_bin_object_rebuild_classes_ht (o);
-			}
-			isSwift = rz_bin_lang_swift (bf);
-			if (isSwift) {
-				o->classes = classes_from_symbols (bf);
-			}
-		} else {
-			RzList *classes = classes_from_symbols (bf);
-			if (classes) {
-				o->classes = classes;
-			}
-		}
-		if (bin->filter) {
-			filter_classes (bf, o->classes);
-		}
-		// cache addr=class+method
-		if (o->classes) {
-			RzList *klasses = o->classes;
-			RzListIter *iter, *iter2;
-			RzBinClass *klass;
-			RzBinSymbol *method;
-			if (!o->addrzklassmethod) {
-				// this is slow. must be optimized, but at least its cached
-				o->addrzklassmethod = sdb_new0 ();
-				rz_list_foreach (klasses, iter, klass) {
-					rz_list_foreach (klass->methods, iter2, method) {
-						char *km = sdb_fmt ("method.%s.%s", klass->name, method->name);
-						char *at = sdb_fmt ("0x%08"PFMT64x, method->vaddr);
-						sdb_set (o->addrzklassmethod, at, km, 0);
-					}
-				}
-			}
-		}
-	}
-	if (p->lines) {
-		o->lines = p->lines (bf);
+	if (!bin->lazy) {
+		rz_bin_object_load_items (bf, o, items);
+		// what is filtered out stays out, as it always did
+		o->loaded = OBJECT_ITEMS;
 	}
 	if (p->get_sdb) {
 		Sdb* new_kv = p->get_sdb (bf);
@@ -423,8 +477,8 @@ RZ_API int rz_bin_object_set_items(RzBinFile *bf, RzBinObject *o) {
 	if (p->mem)  {
 		o->mem = p->mem (bf);
 	}
-	if (o->info && bin->filter_rules & (RZ_BIN_REQ_INFO | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS)) {
-		o->lang = isSwift? RZ_BIN_NM_SWIFT: rz_bin_load_languages (bf);
+	if (!bin->lazy && !o->lang && o->info && bin->filter_rules & (RZ_BIN_REQ_INFO | RZ_BIN_REQ_SYMBOLS | RZ_BIN_REQ_IMPORTS)) {
+		o->lang = rz_bin_load_languages (bf);
 	}
 	return true;
 }
@@ -436,6 +490,7 @@ RZ_IPI RBNode *rz_bin_object_patch_relocs(RzBin *bin, RzBinObject *o) {
 	// rz_bin_object_set_items set o->relocs but there we don't have access
 	// to io so we need to be run from bin_relocs, free the previous reloc and get
 	// the patched ones
+	rz_bin_object_load_items (bin->cur, o, RZ_BIN_REQ_RELOCS);
 	if (first && o->plugin && o->plugin->patch_relocs) {
 		RzList *tmp = o->plugin->patch_relocs (bin);
 		first = false;
@@ -11,12 +11,20 @@ RZ_API bool rz_bin_addr2line(RzBin *bin, ut64 addr, char *file, int len, int *li
 	ut64 baddr = rz_bin_get_baddr (bin);
 	if (cp && cp->dbginfo) {
 		if (o && addr >= baddr && addr < baddr + bin->cur->o->size) {
-			if (cp->dbginfo->get_line) {
-				return cp->dbginfo->get_line (
-					bin->cur, addr, file, len, line);
+			if (cp->dbginfo->get_line && cp->dbginfo->get_line (bin->cur, addr, file, len, line)) {
+				return true;
 			}
 		}
 	}
+	// DWARF line programs, any format can have them
+	if (binfile && binfile->addrline) {
+		const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (binfile->addrline, addr);
+		if (e) {
+			rz_str_ncpy (file, binfile->addrline->files[e->file], len);
+			*line = e->line;
+			return true;
+		}
+	}
 	return false;
 }
 
@@ -82,7 +82,8 @@ RZ_API char *rz_bin_demangle(RzBinFile *bf, const char *def, const char *str, ut
 	}
 	if (o) {
 		bool found = false;
-		rz_list_foreach (o->libs, iter, lib) {
+		RzList *bin_libs = rz_bin_file_get_libs (bf);
+		rz_list_foreach (bin_libs, iter, lib) {
 			size_t len = strlen (lib);
 			if (!rz_str_ncasecmp (str, lib, len)) {
 				str += len;
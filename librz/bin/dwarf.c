@@ -16,6 +16,7 @@
 #include <rz_bin.h>
 #include <rz_bin_dwarf.h>
 #include <rz_core.h>
+#include <rz_th.h>
 
 #define STANDARD_OPERAND_COUNT_DWARF2 9
 #define STANDARD_OPERAND_COUNT_DWARF3 12
@@ -670,47 +671,73 @@ static const ut8 *parse_line_header (
 	return buf;
 }
 
-static inline void add_sdb_addrline(Sdb *s, ut64 addr, const char *file, ut64 line, int mode, PrintfCallback print) {
-	const char *p;
-	char *fileline;
-	char offset[64];
-	char *offset_ptr;
+static ut32 line_table_file(RzBinDwarfLineTable *table, const char *file) {
+	bool found = false;
+	ut32 idx = (ut32)(size_t)ht_pp_find (table->files_idx, file, &found);
+	if (found) {
+		return idx - 1;
+	}
+	if (table->files_count == table->files_capacity) {
+		size_t cap = table->files_capacity ? table->files_capacity * 2 : 16;
+		char **tmp = realloc (table->files, cap * sizeof (char *));
+		if (!tmp) {
+			return UT32_MAX;
+		}
+		table->files = tmp;
+		table->files_capacity = cap;
+	}
+	char *dup = strdup (file);
+	if (!dup) {
+		return UT32_MAX;
+	}
+	idx = table->files_count++;
+	table->files[idx] = dup;
+	ht_pp_insert (table->files_idx, file, (void *)(size_t)(idx + 1));
+	return idx;
+}
 
-	if (!s || !file) {
+static inline void add_line_entry(RzBinDwarfLineTable *table, const RzBinDwarfLineHeader *hdr,
+		const RzBinDwarfSMRegisters *regs, int mode, PrintfCallback print) {
+	if (!table || !hdr->file_names) {
 		return;
 	}
-	p = rz_str_rchr (file, NULL, '/');
-	if (p) {
-		p++;
-	} else {
-		p = file;
+	ut64 fnidx = regs->file - 1;
+	if (fnidx >= hdr->file_names_count || !hdr->file_names[fnidx].name) {
+		return;
 	}
-	// includedirs and properly check full paths
+	const char *file = hdr->file_names[fnidx].name;
 	switch (mode) {
 	case 1:
 	case 'r':
-	case '*':
-		print ("CL %s:%d 0x%08"PFMT64x"\n", p, (int)line, addr);
+	case '*': {
+		const char *p = rz_str_rchr (file, NULL, '/');
+		print ("CL %s:%d 0x%08"PFMT64x"\n", p ? p + 1 : file, (int)regs->line, regs->address);
 		break;
 	}
-#if 0
-	/* THIS IS TOO SLOW */
-	if (rz_file_exists (file)) {
-		p = file;
 	}
-#else
-	p = file;
-#endif
-	fileline = rz_str_newf ("%s|%"PFMT64d, p, line);
-	offset_ptr = sdb_itoa (addr, offset, 16);
-	sdb_add (s, offset_ptr, fileline, 0);
-	sdb_add (s, fileline, offset_ptr, 0);
-	free (fileline);
+	if (table->count == table->capacity) {
+		size_t cap = table->capacity ? table->capacity * 2 : 256;
+		RzBinDwarfLineEntry *tmp = realloc (table->entries, cap * sizeof (RzBinDwarfLineEntry));
+		if (!tmp) {
+			return;
+		}
+		table->entries = tmp;
+		table->capacity = cap;
+	}
+	ut32 idx = line_table_file (table, file);
+	if (idx == UT32_MAX) {
+		return;
+	}
+	RzBinDwarfLineEntry *e = &table->entries[table->count++];
+	e->address = regs->address;
+	e->file = idx;
+	e->line = regs->line;
+	e->column = regs->column;
 }
 
 static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 	size_t len, const RzBinDwarfLineHeader *hdr,
-	RzBinDwarfSMRegisters *regs, int mode) {
+	RzBinDwarfSMRegisters *regs, RzBinDwarfLineTable *table, int mode) {
 
 	rz_return_val_if_fail (bin && bin->cur && obuf && hdr && regs, NULL);
 
@@ -741,14 +768,7 @@ static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 	switch (opcode) {
 	case DW_LNE_end_sequence:
 		regs->end_sequence = DWARF_TRUE;
-
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file - 1;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline(binfile->sdb_addrinfo, regs->address,
-						hdr->file_names[fnidx].name, regs->line, mode, print);
-			}
-		}
+		add_line_entry (table, hdr, regs, mode, print);
 
 		if (mode == RZ_MODE_PRINT) {
 			print ("End of Sequence\n");
@@ -807,13 +827,12 @@ static const ut8 *parse_ext_opcode(const RzBin *bin, const ut8 *obuf,
 static const ut8 *parse_spec_opcode(
 	const RzBin *bin, const ut8 *obuf, size_t len,
 	const RzBinDwarfLineHeader *hdr,
-	RzBinDwarfSMRegisters *regs,
+	RzBinDwarfSMRegisters *regs, RzBinDwarfLineTable *table,
 	ut8 opcode, int mode) {
 
 	rz_return_val_if_fail (bin && obuf && hdr && regs, NULL);
 
 	PrintfCallback print = bin->cb_printf;
-	RzBinFile *binfile = bin->cur;
 	const ut8 *buf = obuf;
 	ut8 adj_opcode = 0;
 	ut64 advance_adr;
@@ -832,14 +851,7 @@ static const ut8 *parse_spec_opcode(
 		print ("advance Address by %"PFMT64d" to 0x%"PFMT64x" and Line by %d to %"PFMT64d"\n",
 			advance_adr, regs->address, line_increment, regs->line);
 	}
-	if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-		int idx = regs->file -1;
-		if (idx >= 0 && idx < hdr->file_names_count) {
-			add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
-					hdr->file_names[idx].name,
-					regs->line, mode, print);
-		}
-	}
+	add_line_entry (table, hdr, regs, mode, print);
 	regs->basic_block = DWARF_FALSE;
 	regs->prologue_end = DWARF_FALSE;
 	regs->epilogue_begin = DWARF_FALSE;
@@ -851,12 +863,11 @@ static const ut8 *parse_spec_opcode(
 static const ut8 *parse_std_opcode(
 	const RzBin *bin, const ut8 *obuf, size_t len,
 	const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegisters *regs,
-	ut8 opcode, int mode) {
+	RzBinDwarfLineTable *table, ut8 opcode, int mode) {
 
 	rz_return_val_if_fail (bin && bin->cur && obuf && hdr && regs, NULL);
 
 	PrintfCallback print = bin->cb_printf;
-	RzBinFile *binfile = bin->cur;
 	const ut8* buf = obuf;
 	const ut8* buf_end = obuf + len;
 	ut64 addr = 0LL;
@@ -873,15 +884,7 @@ static const ut8 *parse_std_opcode(
 		if (mode == RZ_MODE_PRINT) {
 			print ("Copy\n");
 		}
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file - 1;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline (binfile->sdb_addrinfo,
-					regs->address,
-					hdr->file_names[fnidx].name,
-					regs->line, mode, print);
-			}
-		}
+		add_line_entry (table, hdr, regs, mode, print);
 		regs->basic_block = DWARF_FALSE;
 		break;
 	case DW_LNS_advance_pc:
@@ -989,7 +992,7 @@ static void set_regs_default(const RzBinDwarfLineHeader *hdr, RzBinDwarfSMRegist
 // Passing bin should be unnecessary (after we stop printing inside bin_dwarf)
 static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 		size_t len, const RzBinDwarfLineHeader *hdr,
-		RzBinDwarfSMRegisters *regs, int mode) {
+		RzBinDwarfSMRegisters *regs, RzBinDwarfLineTable *table, int mode) {
 	const ut8 *buf, *buf_end;
 	ut8 opcode, ext_opcode;
 
@@ -1004,15 +1007,15 @@ static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 		len--;
 		if (!opcode) {
 			ext_opcode = *buf;
-			buf = parse_ext_opcode (bin, buf, len, hdr, regs, mode);
+			buf = parse_ext_opcode (bin, buf, len, hdr, regs, table, mode);
 			if (!buf || ext_opcode == DW_LNE_end_sequence) {
 				set_regs_default (hdr, regs); // end_sequence should reset regs to default
 				break;
 			}
 		} else if (opcode >= hdr->opcode_base) {
-			buf = parse_spec_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_spec_opcode (bin, buf, len, hdr, regs, table, opcode, mode);
 		} else {
-			buf = parse_std_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_std_opcode (bin, buf, len, hdr, regs, table, opcode, mode);
 		}
 		len = (size_t)(buf_end - buf);
 	}
@@ -1026,7 +1029,7 @@ static size_t parse_opcodes(const RzBin *bin, const ut8 *obuf,
 }
 
 static int parse_line_raw(const RzBin *a, const ut8 *obuf,
-				       ut64 len, int mode) {
+		ut64 len, RzBinDwarfLineTable *table, int mode) {
 
 	RzBinFile *binfile = a ? a->cur : NULL;
 	rz_return_val_if_fail(binfile && obuf, false);
@@ -1086,7 +1089,7 @@ static int parse_line_raw(const RzBin *a, const ut8 *obuf,
 		// we read the whole compilation unit (that might be composed of more sequences)
 		do {
 			// reads one whole sequence
-			tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, mode);
+			tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, table, mode);
 			bytes_read += tmp_read;
 			buf += tmp_read; // Move in the buffer forward
 		} while (bytes_read < buf_size && tmp_read != 0); // if nothing is read -> error, exit
@@ -1182,9 +1185,6 @@ static int init_debug_info(RzBinDwarfDebugInfo *inf) {
 		return -1;
 	}
 	inf->comp_units = calloc (sizeof (RzBinDwarfCompUnit), DEBUG_INFO_CAPACITY);
-
-	inf->lookup_table = ht_up_new0 ();
-
 	if (!inf->comp_units) {
 		return -1;
 	}
@@ -1414,9 +1414,10 @@ RZ_API void rz_bin_dwarf_free_debug_info(RzBinDwarfDebugInfo *inf) {
 	for (i = 0; i < inf->count; i++) {
 		free_comp_unit (&inf->comp_units[i]);
 	}
-	ht_up_free (inf->lookup_table);
 	free (inf->comp_units);
-	free(inf);
+	free (inf->buf);
+	free (inf->debug_str);
+	free (inf);
 }
 
 static void print_attr_value(const RzBinDwarfAttrValue *val, PrintfCallback print) {
@@ -1860,26 +1861,13 @@ static const ut8 *parse_attr_value(const ut8 *obuf, int obuf_len,
  * @return const ut8* Updated buffer
  */
 static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrevDecl *abbrev,
-		RzBinDwarfCompUnitHdr *hdr, RzBinDwarfDie *die, const ut8 *debug_str, size_t debug_str_len, Sdb *sdb) {
+		RzBinDwarfCompUnitHdr *hdr, RzBinDwarfDie *die, const ut8 *debug_str, size_t debug_str_len) {
 	size_t i;
 	for (i = 0; i < abbrev->count - 1; i++) {
 		memset (&die->attr_values[i], 0, sizeof (die->attr_values[i]));
 
 		buf = parse_attr_value (buf, buf_end - buf, &abbrev->defs[i],
 			&die->attr_values[i], hdr, debug_str, debug_str_len);
-
-		RzBinDwarfAttrValue *attribute = &die->attr_values[i];
-
-		bool is_valid_string_form = (attribute->attr_form == DW_FORM_strp ||
-			attribute->attr_form == DW_FORM_string) &&
-			attribute->string.content;
-		// TODO  does this have a purpose anymore?
-		// Or atleast it needs to rework becase there will be
-		// more comp units -> more comp dirs and only the last one will be kept
-		if (attribute->attr_name == DW_AT_comp_dir && is_valid_string_form) {
-			const char *name = attribute->string.content;
-			sdb_set (sdb, "DW_AT_comp_dir", name, 0);
-		}
 		die->count++;
 	}
 
@@ -1889,7 +1877,6 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrev
 /**
  * @brief Reads throught comp_unit buffer and parses all its DIEntries
  *
- * @param sdb
  * @param buf_start Start of the compilation unit data
  * @param unit Unit to store the newly parsed information
  * @param abbrevs Parsed abbrev section info of *all* abbreviations
@@ -1899,7 +1886,7 @@ static const ut8 *parse_die(const ut8 *buf, const ut8 *buf_end, RzBinDwarfAbbrev
  *
  * @return const ut8* Update buffer
  */
-static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, Sdb *sdb, const ut8 *buf_start,
+static const ut8 *parse_comp_unit(const ut8 *buf_start,
 		RzBinDwarfCompUnit *unit, const RzBinDwarfDebugAbbrev *abbrevs,
 		size_t first_abbr_idx, const ut8 *debug_str, size_t debug_str_len) {
 
@@ -1945,7 +1932,7 @@ static const ut8 *parse_comp_unit(RzBinDwarfDebugInfo *info, Sdb *sdb, const ut8
 		die->tag = abbrev->tag;
 		die->has_children = abbrev->has_children;
 
-		buf = parse_die (buf, buf_end, abbrev, &unit->hdr, die, debug_str, debug_str_len, sdb);
+		buf = parse_die (buf, buf_end, abbrev, &unit->hdr, die, debug_str, debug_str_len);
 		if (!buf) {
 			return NULL;
 		}
@@ -2009,23 +1996,25 @@ static int expand_info(RzBinDwarfDebugInfo *info) {
 	return 0;
 }
 
+static inline ut64 unit_end_offset(const RzBinDwarfCompUnit *unit) {
+	return unit->offset + unit->hdr.length + (unit->hdr.is_64bit ? 12 : 4);
+}
+
+static inline const ut8 *unit_data(const RzBinDwarfDebugInfo *info, const RzBinDwarfCompUnit *unit) {
+	return info->buf + unit->offset + unit->hdr.header_size + (unit->hdr.is_64bit ? 12 : 4);
+}
+
 /**
- * @brief Parses whole .debug_info section
+ * @brief Indexes the compilation units of .debug_info, only their headers
+ *        are read, the DIEs are parsed when the unit is loaded
  *
- * @param sdb Sdb to store line related information into
  * @param da Parsed Abbreviations
  * @param obuf .debug_info section buffer start
  * @param len length of the section buffer
- * @param debug_str start of the .debug_str section
- * @param debug_str_len length of the debug_str section
- * @param mode
- * @return RZ_API* parse_info_raw Parsed information
+ * @return RzBinDwarfDebugInfo* Index of the units, NULL if error
  */
-static RzBinDwarfDebugInfo *parse_info_raw(Sdb *sdb, RzBinDwarfDebugAbbrev *da,
-		const ut8 *obuf, size_t len,
-		const ut8 *debug_str, size_t debug_str_len) {
-
-	rz_return_val_if_fail (da && sdb && obuf, false);
+static RzBinDwarfDebugInfo *index_info_raw(const RzBinDwarfDebugAbbrev *da, const ut8 *obuf, size_t len) {
+	rz_return_val_if_fail (da && obuf, NULL);
 
 	const ut8 *buf = obuf;
 	const ut8 *buf_end = obuf + len;
@@ -2037,32 +2026,25 @@ static RzBinDwarfDebugInfo *parse_info_raw(Sdb *sdb, RzBinDwarfDebugAbbrev *da,
 	if (init_debug_info (info) < 0) {
 		goto cleanup;
 	}
-	int unit_idx = 0;
-
 	while (buf < buf_end) {
 		if (info->count >= info->capacity) {
 			if (expand_info (info)) {
 				break;
 			}
 		}
-
-		RzBinDwarfCompUnit *unit = &info->comp_units[unit_idx];
-		if (init_comp_unit (unit) < 0) {
-			unit_idx--;
-			goto cleanup;
-		}
-		info->count++;
-
+		RzBinDwarfCompUnit *unit = &info->comp_units[info->count];
 		unit->offset = buf - obuf;
 		// small redundancy, because it was easiest solution at a time
 		unit->hdr.unit_offset = buf - obuf;
 
 		buf = info_comp_unit_read_hdr (buf, buf_end, &unit->hdr);
-
 		if (unit->hdr.length > len) {
 			goto cleanup;
 		}
-
+		if (unit_end_offset (unit) > len) {
+			// truncated, the previous units are still fine
+			break;
+		}
 		if (da->decls->count >= da->capacity) {
 			eprintf ("WARNING: malformed dwarf have not enough buckets for decls.\n");
 		}
@@ -2077,22 +2059,171 @@ static RzBinDwarfDebugInfo *parse_info_raw(Sdb *sdb, RzBinDwarfDebugAbbrev *da,
 			goto cleanup;
 		}
 		// They point to the same array object, so should be def. behaviour
-		size_t first_abbr_idx = abbrev_start - da->decls;
+		unit->first_abbr_idx = abbrev_start - da->decls;
+		info->count++;
+		buf = obuf + unit_end_offset (unit);
+	}
+	return info;
 
-		buf = parse_comp_unit (info, sdb, buf, unit, da, first_abbr_idx, debug_str, debug_str_len);
+cleanup:
+	rz_bin_dwarf_free_debug_info (info);
+	return NULL;
+}
 
-		if (!buf) {
-			goto cleanup;
+static bool load_unit(const RzBinDwarfDebugInfo *info, RzBinDwarfCompUnit *unit) {
+	if (unit->loaded) {
+		return unit->dies != NULL;
+	}
+	unit->loaded = true;
+	if (unit->hdr.header_size > unit->hdr.length || init_comp_unit (unit) < 0) {
+		return false;
+	}
+	if (!parse_comp_unit (unit_data (info, unit), unit, info->abbrevs,
+		    unit->first_abbr_idx, info->debug_str, info->debug_str_len)) {
+		free_comp_unit (unit);
+		unit->count = unit->capacity = 0;
+		return false;
+	}
+	return true;
+}
+
+// DW_AT_comp_dir of the unit DIE, the line programs resolve their paths with it
+static char *unit_comp_dir(const RzBinDwarfDebugInfo *info, RzBinDwarfCompUnit *unit) {
+	const ut8 *buf = unit_data (info, unit);
+	const ut8 *buf_end = info->buf + unit_end_offset (unit);
+	ut64 abbr_code;
+	if (unit->hdr.header_size > unit->hdr.length || buf >= buf_end) {
+		return NULL;
+	}
+	buf = rz_uleb128 (buf, buf_end - buf, &abbr_code, NULL);
+	if (!buf || buf >= buf_end || !abbr_code || unit->first_abbr_idx + abbr_code > info->abbrevs->count) {
+		return NULL;
+	}
+	RzBinDwarfAbbrevDecl *abbrev = &info->abbrevs->decls[unit->first_abbr_idx + abbr_code - 1];
+	RzBinDwarfDie die = { 0 };
+	if (init_die (&die, abbr_code, abbrev->count)) {
+		return NULL;
+	}
+	char *dir = NULL;
+	size_t i;
+	if (parse_die (buf, buf_end, abbrev, &unit->hdr, &die, info->debug_str, info->debug_str_len)) {
+		for (i = 0; i < die.count; i++) {
+			RzBinDwarfAttrValue *val = &die.attr_values[i];
+			if (val->attr_name == DW_AT_comp_dir && val->string.content &&
+				(val->attr_form == DW_FORM_strp || val->attr_form == DW_FORM_string)) {
+				dir = strdup (val->string.content);
+			}
 		}
+	}
+	free_die (&die);
+	return dir;
+}
+
+#define DWARF_THREADS 16
 
-		unit_idx++;
+typedef struct {
+	RzBinDwarfDebugInfo *info;
+	size_t next;
+	bool ok;
+	RzThreadLock *lock;
+} DwarfLoadWork;
+
+static void load_work(DwarfLoadWork *w) {
+	for (;;) {
+		if (w->lock) {
+			rz_th_lock_enter (w->lock);
+		}
+		size_t i = w->next++;
+		if (w->lock) {
+			rz_th_lock_leave (w->lock);
+		}
+		if (i >= w->info->count) {
+			break;
+		}
+		if (!load_unit (w->info, &w->info->comp_units[i])) {
+			w->ok = false;
+		}
 	}
+}
 
-	return info;
+static RzThreadFunctionRet load_work_th(RzThread *th) {
+	load_work (th->user);
+	return RZ_TH_STOP;
+}
 
-cleanup:
-	rz_bin_dwarf_free_debug_info (info);
-	return NULL;
+/**
+ * @brief Loads the DIEs of the unit at \p idx, if not loaded yet
+ *
+ * @return bool true if the unit has been parsed successfully
+ */
+RZ_API bool rz_bin_dwarf_info_load_unit(RzBinDwarfDebugInfo *info, size_t idx) {
+	rz_return_val_if_fail (info && idx < info->count, false);
+	big_end = info->big_endian;
+	return load_unit (info, &info->comp_units[idx]);
+}
+
+/**
+ * @brief Loads the DIEs of all the units, the units are independent
+ *        so they are parsed in parallel
+ *
+ * @return bool true if every unit has been parsed successfully
+ */
+RZ_API bool rz_bin_dwarf_info_load_all(RzBinDwarfDebugInfo *info) {
+	rz_return_val_if_fail (info, false);
+	RzThread *threads[DWARF_THREADS] = { 0 };
+	DwarfLoadWork w = { info, 0, true, NULL };
+	// the calling thread works too
+	int i, nthreads = RZ_MIN (rz_th_cpu_count (), DWARF_THREADS) - 1;
+	if ((size_t)nthreads >= info->count) {
+		nthreads = info->count ? info->count - 1 : 0;
+	}
+	big_end = info->big_endian;
+	if (nthreads > 0) {
+		w.lock = rz_th_lock_new (false);
+	}
+	for (i = 0; w.lock && i < nthreads; i++) {
+		threads[i] = rz_th_new (load_work_th, &w, 0);
+	}
+	load_work (&w);
+	for (i = 0; i < nthreads; i++) {
+		if (threads[i]) {
+			rz_th_wait (threads[i]);
+			rz_th_free (threads[i]);
+		}
+	}
+	rz_th_lock_free (w.lock);
+	return w.ok;
+}
+
+static int die_offset_cmp(const void *a, const void *b) {
+	ut64 off = *(const ut64 *)a;
+	const RzBinDwarfDie *die = b;
+	return off < die->offset ? -1 : off > die->offset;
+}
+
+/**
+ * @brief Finds the DIE at \p offset of .debug_info, loading its unit if needed
+ */
+RZ_API RzBinDwarfDie *rz_bin_dwarf_info_get_die(RzBinDwarfDebugInfo *info, ut64 offset) {
+	rz_return_val_if_fail (info, NULL);
+	size_t lo = 0, hi = info->count;
+	// last unit starting before offset
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (info->comp_units[mid].offset <= offset) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (!lo) {
+		return NULL;
+	}
+	RzBinDwarfCompUnit *unit = &info->comp_units[lo - 1];
+	if (offset >= unit_end_offset (unit) || !rz_bin_dwarf_info_load_unit (info, lo - 1)) {
+		return NULL;
+	}
+	return bsearch (&offset, unit->dies, unit->count, sizeof (RzBinDwarfDie), die_offset_cmp);
 }
 
 static RzBinDwarfDebugAbbrev *parse_abbrev_raw(const ut8 *obuf, size_t len) {
@@ -2187,6 +2318,67 @@ static ut8 *get_section_bytes(RzBin *bin, const char *sect_name, size_t *len) {
 	return buf;
 }
 
+/**
+ * @brief Indexes the compilation units of .debug_info without parsing their DIEs,
+ *        units are loaded with rz_bin_dwarf_info_load_unit or on a lookup
+ *
+ * @param da Parsed abbreviations, must outlive the returned info
+ * @param bin
+ * @return RzBinDwarfDebugInfo* Indexed units, NULL if error
+ */
+RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_index_info(RzBinDwarfDebugAbbrev *da, RzBin *bin) {
+	rz_return_val_if_fail (bin, NULL);
+	RzBinSection *section = getsection (bin, "debug_info");
+	RzBinFile *binfile = bin->cur;
+	if (!da || !binfile || !section) {
+		return NULL;
+	}
+	ut64 len = section->size;
+	// what is this checking for?
+	if (len > (UT32_MAX >> 1) || len < 1) {
+		return NULL;
+	}
+	ut8 *buf = calloc (1, len);
+	if (!buf) {
+		return NULL;
+	}
+	if (!rz_buf_read_at (binfile->buf, section->paddr, buf, len)) {
+		free (buf);
+		return NULL;
+	}
+	/* set the endianity global [HOTFIX] */
+	big_end = rz_bin_is_big_endian (bin);
+	RzBinDwarfDebugInfo *info = index_info_raw (da, buf, len);
+	if (!info) {
+		free (buf);
+		return NULL;
+	}
+	info->buf = buf;
+	info->len = len;
+	info->abbrevs = da;
+	info->big_endian = big_end;
+
+	RzBinSection *debug_str = getsection (bin, "debug_str");
+	if (debug_str) {
+		info->debug_str_len = debug_str->size;
+		info->debug_str = calloc (1, info->debug_str_len + 1);
+		if (!info->debug_str || !rz_buf_read_at (binfile->buf, debug_str->paddr, info->debug_str, info->debug_str_len)) {
+			rz_bin_dwarf_free_debug_info (info);
+			return NULL;
+		}
+	}
+	// the last one wins, as when the whole section was parsed at once
+	size_t i;
+	for (i = 0; i < info->count; i++) {
+		char *dir = unit_comp_dir (info, &info->comp_units[i]);
+		if (dir) {
+			sdb_set (binfile->sdb_addrinfo, "DW_AT_comp_dir", dir, 0);
+			free (dir);
+		}
+	}
+	return info;
+}
+
 /**
  * @brief Parses .debug_info section
  *
@@ -2196,68 +2388,18 @@ static ut8 *get_section_bytes(RzBin *bin, const char *sect_name, size_t *len) {
  * @return RzBinDwarfDebugInfo* Parsed information, NULL if error
  */
 RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinDwarfDebugAbbrev *da, RzBin *bin, int mode) {
-	RzBinDwarfDebugInfo *info = NULL;
-	RzBinSection *debug_str;
-	RzBinSection *section = getsection (bin, "debug_info");
-	RzBinFile *binfile = bin ? bin->cur : NULL;
-
-	ut64 debug_str_len = 0;
-	ut8 *debug_str_buf = NULL;
-
-	if (binfile && section) {
-		debug_str = getsection (bin, "debug_str");
-		if (debug_str) {
-			debug_str_len = debug_str->size;
-			debug_str_buf = calloc (1, debug_str_len + 1);
-			if (!debug_str_buf) {
-				goto cleanup;
-			}
-			st64 ret = rz_buf_read_at (binfile->buf, debug_str->paddr,
-				debug_str_buf, debug_str_len);
-			if (!ret) {
-				goto cleanup;
-			}
-		}
-
-		ut64 len = section->size;
-		// what is this checking for?
-		if (len > (UT32_MAX >> 1) || len < 1) {
-			goto cleanup;
-		}
-		ut8 *buf = calloc (1, len);
-		if (!buf) {
-			goto cleanup;
-		}
-		if (!rz_buf_read_at (binfile->buf, section->paddr, buf, len)) {
-			free (buf);
-			goto cleanup;
-		}
-		/* set the endianity global [HOTFIX] */
-		big_end = rz_bin_is_big_endian (bin);
-		info = parse_info_raw (binfile->sdb_addrinfo, da, buf, len,
-			debug_str_buf, debug_str_len);
-
-		if (mode == RZ_MODE_PRINT && info) {
-			print_debug_info (info, bin->cb_printf);
-		}
-		// build hashtable after whole parsing because of possible relocations
-		if (info) {
-			size_t i, j;
-			for (i = 0; i < info->count; i++) {
-				RzBinDwarfCompUnit *unit = &info->comp_units[i];
-				for (j = 0; j < unit->count; j++) {
-					RzBinDwarfDie *die = &unit->dies[j];
-					ht_up_insert (info->lookup_table, die->offset, die); // optimization for further processing}
-				}
-			}
-		}
-		free (debug_str_buf);
-		free (buf);
-		return info;
+	RzBinDwarfDebugInfo *info = rz_bin_dwarf_index_info (da, bin);
+	if (!info) {
+		return NULL;
 	}
-cleanup:
-	free (debug_str_buf);
-	return NULL;
+	if (!rz_bin_dwarf_info_load_all (info)) {
+		rz_bin_dwarf_free_debug_info (info);
+		return NULL;
+	}
+	if (mode == RZ_MODE_PRINT) {
+		print_debug_info (info, bin->cb_printf);
+	}
+	return info;
 }
 
 static RzBinDwarfRow *row_new(ut64 addr, const char *file, int line, int col) {
@@ -2268,7 +2410,7 @@ static RzBinDwarfRow *row_new(ut64 addr, const char *file, int line, int col) {
 	row->file = strdup (file);
 	row->address = addr;
 	row->line = line;
-	row->column = 0;
+	row->column = col;
 	return row;
 }
 
@@ -2278,65 +2420,170 @@ static void row_free(void *p) {
 	free (row);
 }
 
-RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *bin, int mode) {
-	ut8 *buf;
-	RzList *list = NULL;
-	int len, ret;
-	RzBinSection *section = getsection (bin, "debug_line");
-	RzBinFile *binfile = bin ? bin->cur: NULL;
-	if (binfile && section) {
-		len = section->size;
-		if (len < 1) {
-			return NULL;
+static int line_entry_cmp(const RzBinDwarfLineEntry *a, const RzBinDwarfLineEntry *b) {
+	return a->address < b->address ? -1 : a->address > b->address;
+}
+
+// stable, so that the first row of an address wins like it did with sdb_add
+static void line_entries_sort(RzBinDwarfLineEntry *entries, RzBinDwarfLineEntry *tmp, size_t count) {
+	RzBinDwarfLineEntry *src = entries, *dst = tmp;
+	size_t width, i;
+	for (width = 1; width < count; width *= 2) {
+		for (i = 0; i < count; i += 2 * width) {
+			size_t mid = RZ_MIN (i + width, count);
+			size_t end = RZ_MIN (i + 2 * width, count);
+			size_t l = i, r = mid, k = i;
+			while (l < mid && r < end) {
+				dst[k++] = line_entry_cmp (&src[r], &src[l]) < 0 ? src[r++] : src[l++];
+			}
+			while (l < mid) {
+				dst[k++] = src[l++];
+			}
+			while (r < end) {
+				dst[k++] = src[r++];
+			}
 		}
-		buf = calloc (1, len + 1);
-		if (!buf) {
-			return NULL;
+		RzBinDwarfLineEntry *swap = src;
+		src = dst;
+		dst = swap;
+	}
+	if (src != entries) {
+		memcpy (entries, src, count * sizeof (RzBinDwarfLineEntry));
+	}
+}
+
+static void line_table_finish(RzBinDwarfLineTable *table) {
+	size_t i, n = 0;
+	for (i = 1; i < table->count; i++) {
+		if (table->entries[i - 1].address > table->entries[i].address) {
+			break;
 		}
-		ret = rz_buf_read_at (binfile->buf, section->paddr, buf, len);
-		if (ret != len) {
-			free (buf);
-			return NULL;
+	}
+	if (i < table->count) {
+		RzBinDwarfLineEntry *tmp = malloc (table->count * sizeof (RzBinDwarfLineEntry));
+		if (!tmp) {
+			return;
 		}
-		list = rz_list_newf (row_free);
-		if (!list) {
-			free (buf);
-			return NULL;
+		line_entries_sort (table->entries, tmp, table->count);
+		free (tmp);
+	}
+	for (i = 0; i < table->count; i++) {
+		if (!n || table->entries[n - 1].address != table->entries[i].address) {
+			table->entries[n++] = table->entries[i];
 		}
-		/* set the endianity global [HOTFIX] */
-		big_end = rz_bin_is_big_endian (bin);
-		// Actually parse the section
-		parse_line_raw (bin, buf, len, mode);
-		// k bin/cur/addrinfo/*
-		SdbListIter *iter;
-		SdbKv *kv;
-		SdbList *ls = sdb_foreach_list (binfile->sdb_addrinfo, false);
-		// Use the parsed information from _raw and transform it to more useful format
-		ls_foreach (ls, iter, kv) {
-			if (!strncmp (sdbkv_key (kv), "0x", 2)) {
-				ut64 addr;
-				RzBinDwarfRow *row;
-				int line;
-				char *file = strdup (sdbkv_value (kv));
-				if (!file) {
-					free (buf);
-					ls_free (ls);
-					rz_list_free (list);
-					return NULL;
-				}
-				char *tok = strchr (file, '|');
-				if (tok) {
-					*tok++ = 0;
-					line = atoi (tok);
-					addr = rz_num_math (NULL, sdbkv_key (kv));
-					row = row_new (addr, file, line, 0);
-					rz_list_append (list, row);
-				}
-				free (file);
-			}
+	}
+	table->count = n;
+	ht_pp_free (table->files_idx);
+	table->files_idx = NULL;
+}
+
+RZ_API void rz_bin_dwarf_line_table_free(RzBinDwarfLineTable *table) {
+	size_t i;
+	if (!table) {
+		return;
+	}
+	for (i = 0; i < table->files_count; i++) {
+		free (table->files[i]);
+	}
+	free (table->files);
+	free (table->entries);
+	ht_pp_free (table->files_idx);
+	free (table);
+}
+
+/**
+ * @brief Finds the line table entry starting exactly at \p addr
+ */
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_get(const RzBinDwarfLineTable *table, ut64 addr) {
+	rz_return_val_if_fail (table, NULL);
+	size_t lo = 0, hi = table->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (table->entries[mid].address < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
-		ls_free (ls);
+	}
+	if (lo < table->count && table->entries[lo].address == addr) {
+		return &table->entries[lo];
+	}
+	return NULL;
+}
+
+RZ_API bool rz_bin_dwarf_line_table_del(RzBinDwarfLineTable *table, ut64 addr) {
+	rz_return_val_if_fail (table, false);
+	const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (table, addr);
+	if (!e) {
+		return false;
+	}
+	size_t idx = e - table->entries;
+	memmove (table->entries + idx, table->entries + idx + 1, (table->count - idx - 1) * sizeof (RzBinDwarfLineEntry));
+	table->count--;
+	return true;
+}
+
+/**
+ * @brief Parses .debug_line into a line table of the current bin file,
+ *        replacing the previous one
+ *
+ * @param bin
+ * @param mode RZ_MODE_PRINT to print the line programs
+ * @return RzBinDwarfLineTable* Table owned by the bin file, NULL if error
+ */
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_parse_line_table(RzBin *bin, int mode) {
+	RzBinSection *section = getsection (bin, "debug_line");
+	RzBinFile *binfile = bin ? bin->cur : NULL;
+	if (!binfile || !section) {
+		return NULL;
+	}
+	size_t len = section->size;
+	if (len < 1 || len > binfile->size) {
+		return NULL;
+	}
+	// the file names of the header are read as strings, keep it terminated
+	ut8 *buf = calloc (1, len + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (rz_buf_read_at (binfile->buf, section->paddr, buf, len) != len) {
+		free (buf);
+		return NULL;
+	}
+	RzBinDwarfLineTable *table = RZ_NEW0 (RzBinDwarfLineTable);
+	if (!table || !(table->files_idx = ht_pp_new0 ())) {
+		free (table);
 		free (buf);
+		return NULL;
+	}
+	/* set the endianity global [HOTFIX] */
+	big_end = rz_bin_is_big_endian (bin);
+	parse_line_raw (bin, buf, len, table, mode);
+	free (buf);
+	line_table_finish (table);
+	rz_bin_dwarf_line_table_free (binfile->addrline);
+	binfile->addrline = table;
+	return table;
+}
+
+RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *bin, int mode) {
+	RzBinDwarfLineTable *table = rz_bin_dwarf_parse_line_table (bin, mode);
+	if (!table) {
+		return NULL;
+	}
+	RzList *list = rz_list_newf (row_free);
+	if (!list) {
+		return NULL;
+	}
+	size_t i;
+	for (i = 0; i < table->count; i++) {
+		RzBinDwarfLineEntry *e = &table->entries[i];
+		RzBinDwarfRow *row = row_new (e->address, table->files[e->file], e->line, e->column);
+		if (!row) {
+			rz_list_free (list);
+			return NULL;
+		}
+		rz_list_append (list, row);
 	}
 	return list;
 }
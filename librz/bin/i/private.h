@@ -7,7 +7,7 @@
 
 RZ_IPI RzBinFile *rz_bin_file_new(RzBin *bin, const char *file, ut64 file_sz, int rawstr, int fd, const char *xtrname, Sdb *sdb, bool steal_ptr);
 RZ_IPI RzBinObject *rz_bin_file_object_find_by_id(RzBinFile *binfile, ut32 binobj_id);
-RZ_IPI RzList *rz_bin_file_get_strings(RzBinFile *a, int min, int dump, int raw);
+RZ_IPI RzList *rz_bin_file_strings(RzBinFile *a, int min, int dump, int raw);
 RZ_IPI RzBinFile *rz_bin_file_find_by_object_id(RzBin *bin, ut32 binobj_id);
 RZ_IPI RzBinFile *rz_bin_file_find_by_id(RzBin *bin, ut32 binfile_id);
 RZ_IPI RzBinFile *rz_bin_file_find_by_name_n(RzBin *bin, const char *name, int idx);
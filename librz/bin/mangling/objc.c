@@ -4,7 +4,7 @@
 #include "../i/private.h"
 
 RZ_API char *rz_bin_demangle_objc(RzBinFile *bf, const char *sym) {
-	rz_return_val_if_fail ((!bf || (bf && bf->o && bf->o->classes)) && sym, NULL);
+	rz_return_val_if_fail ((!bf || (bf->o && rz_bin_file_get_classes (bf))) && sym, NULL);
 	char *ret = NULL;
 	char *clas = NULL;
 	char *name = NULL;
@@ -12,7 +12,7 @@ RZ_API char *rz_bin_demangle_objc(RzBinFile *bf, const char *sym) {
 	int i, nargs = 0;
 	const char *type = NULL;
 
-	if (bf && bf->o && bf->o->classes) {
+	if (bf && bf->o && rz_bin_file_get_classes (bf)) {
 		bf = NULL;
 	}
 	/* classes */
@@ -2,6 +2,7 @@
 
 #include <rz_pdb.h>
 #include <rz_bin.h>
+#include <rz_th.h>
 #include <string.h>
 
 #include "types.h"
@@ -27,8 +28,18 @@ typedef struct {
 	void *stream;
 	EStream type;
 	free_func free;
+	RZ_STREAM_FILE stream_file; // pages of the stream, set when found in the root
 } SStreamParseFunc;
 
+#define PDB_THREADS 16
+
+typedef struct {
+	SStreamParseFunc **funcs;
+	size_t count;
+	size_t next;
+	RzThreadLock *lock;
+} SStreamParseWork;
+
 ///////////////////////////////////////////////////////////////////////////////
 static void free_pdb_stream(void *stream) {
 	RZ_PDB_STREAM *pdb_stream = (RZ_PDB_STREAM *) stream;
@@ -66,9 +77,9 @@ static char *create_type_name_from_offset(ut64 offset) {
 /// size - default value = -1
 /// page_size - default value = 0x1000
 ///////////////////////////////////////////////////////////////////////////////
-static int init_r_pdb_stream(RZ_PDB_STREAM *pdb_stream, RzBuffer *buf /*FILE *fp*/, int *pages,
+static int init_r_pdb_stream(RZ_PDB_STREAM *pdb_stream, RzPdb *pdb /*FILE *fp*/, int *pages,
 			     int pages_amount, int index, int size, int page_size) {
-	pdb_stream->buf = buf;
+	pdb_stream->buf = pdb->buf;
 	pdb_stream->pages = pages;
 	pdb_stream->indx = index;
 	pdb_stream->page_size = page_size;
@@ -78,7 +89,7 @@ static int init_r_pdb_stream(RZ_PDB_STREAM *pdb_stream, RzBuffer *buf /*FILE *fp
 	} else {
 		pdb_stream->size = size;
 	}
-	init_r_stream_file (&(pdb_stream->stream_file), buf, pages, pages_amount, size, page_size);
+	init_r_stream_file (&(pdb_stream->stream_file), pdb->data, pdb->data_size, pages, pages_amount, size, page_size);
 	pdb_stream->free_ = free_pdb_stream;
 
 	return 1;
@@ -127,7 +138,7 @@ static int init_pdb7_root_stream(RzPdb *pdb, int *root_page_list, int pages_amou
 	RZ_PDB7_ROOT_STREAM *root_stream7;
 
 	pdb->root_stream = RZ_NEW0 (RZ_PDB7_ROOT_STREAM);
-	init_r_pdb_stream (&pdb->root_stream->pdb_stream, pdb->buf, root_page_list, pages_amount,
+	init_r_pdb_stream (&pdb->root_stream->pdb_stream, pdb, root_page_list, pages_amount,
 		indx, root_size, page_size);
 
 	root_stream7 = pdb->root_stream;
@@ -332,6 +343,62 @@ static void find_indx_in_list(RzList *l, int index, SStreamParseFunc **res) {
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+static void parse_work(SStreamParseWork *w) {
+	for (;;) {
+		if (w->lock) {
+			rz_th_lock_enter (w->lock);
+		}
+		size_t i = w->next++;
+		if (w->lock) {
+			rz_th_lock_leave (w->lock);
+		}
+		if (i >= w->count) {
+			break;
+		}
+		SStreamParseFunc *stream_parse_func = w->funcs[i];
+		stream_parse_func->parse_stream (stream_parse_func->stream, &stream_parse_func->stream_file);
+	}
+}
+
+static RzThreadFunctionRet parse_work_th(RzThread *th) {
+	parse_work (th->user);
+	return RZ_TH_STOP;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// the streams listed in the dbi stream do not depend on each other,
+// they only read the file so they are parsed in parallel
+static int parse_streams(SStreamParseFunc **funcs, size_t count) {
+	RzThread *threads[PDB_THREADS] = { 0 };
+	SStreamParseWork w = { funcs, count, 0, NULL };
+	// the calling thread works too
+	int i, nthreads = RZ_MIN (rz_th_cpu_count (), PDB_THREADS) - 1;
+	if ((size_t)nthreads >= count) {
+		nthreads = count ? count - 1 : 0;
+	}
+	if (nthreads > 0) {
+		w.lock = rz_th_lock_new (false);
+	}
+	for (i = 0; w.lock && i < nthreads; i++) {
+		threads[i] = rz_th_new (parse_work_th, &w, 0);
+	}
+	parse_work (&w);
+	for (i = 0; i < nthreads; i++) {
+		if (threads[i]) {
+			rz_th_wait (threads[i]);
+			rz_th_free (threads[i]);
+		}
+	}
+	rz_th_lock_free (w.lock);
+	for (i = 0; i < count; i++) {
+		if (funcs[i]->stream_file.error) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 static int pdb_read_root(RzPdb *pdb) {
 	int i = 0;
@@ -344,6 +411,9 @@ static int pdb_read_root(RzPdb *pdb) {
 	RzListIter *it;
 	SPage *page = 0;
 	SStreamParseFunc *stream_parse_func = 0;
+	SStreamParseFunc **funcs = NULL;
+	size_t funcs_count = 0;
+	int ret = 0;
 
 	it = rz_list_iterator (root_stream->streams_list);
 	while (rz_list_iter_next (it)) {
@@ -354,7 +424,7 @@ static int pdb_read_root(RzPdb *pdb) {
 			i++;
 			continue;
 		}
-		init_r_stream_file (&stream_file, pdb->buf, (int *) page->stream_pages,
+		init_r_stream_file (&stream_file, pdb->data, pdb->data_size, (int *) page->stream_pages,
 			page->num_pages	/*root_stream->pdb_stream.pages_amount*/,
 			page->stream_size,
 			root_stream->pdb_stream.page_size);
@@ -364,7 +434,7 @@ static int pdb_read_root(RzPdb *pdb) {
 		case ePDB_STREAM_PDB:
 			pdb_info_stream = RZ_NEW0 (SPDBInfoStream);
 			if (!pdb_info_stream) {
-				return 0;
+				goto beach;
 			}
 			pdb_info_stream->free_ = free_info_stream;
 			parse_pdb_info_stream (pdb_info_stream, &stream_file);
@@ -373,12 +443,13 @@ static int pdb_read_root(RzPdb *pdb) {
 		case ePDB_STREAM_TPI:
 			tpi_stream = RZ_NEW0 (STpiStream);
 			if (!tpi_stream) {
-				return 0;
+				goto beach;
 			}
 			init_tpi_stream (tpi_stream);
 			if (!parse_tpi_stream (tpi_stream, &stream_file)) {
+				tpi_stream->free_ (tpi_stream);
 				free (tpi_stream);
-				return 0;
+				goto beach;
 			}
 			rz_list_append (pList, tpi_stream);
 			break;
@@ -386,38 +457,47 @@ static int pdb_read_root(RzPdb *pdb) {
 		{
 			SDbiStream *dbi_stream = RZ_NEW0 (SDbiStream);
 			if (!dbi_stream) {
-				return 0;
+				goto beach;
 			}
 			init_dbi_stream (dbi_stream);
 			parse_dbi_stream (dbi_stream, &stream_file);
 			rz_list_append (pList, dbi_stream);
 			pdb->pdb_streams2 = rz_list_new ();
 			fill_list_for_stream_parsing (pdb->pdb_streams2, dbi_stream);
+			funcs = calloc (rz_list_length (pdb->pdb_streams2) + 1, sizeof (SStreamParseFunc *));
+			if (!funcs) {
+				goto beach;
+			}
 			break;
 		}
 		default:
 			find_indx_in_list (pdb->pdb_streams2, i, &stream_parse_func);
 			if (stream_parse_func && stream_parse_func->parse_stream) {
-				stream_parse_func->parse_stream (stream_parse_func->stream, &stream_file);
+				// parsed with the others once the root is read
+				stream_parse_func->stream_file = stream_file;
+				funcs[funcs_count++] = stream_parse_func;
 				break;
 			}
 
 			pdb_stream = RZ_NEW0 (RZ_PDB_STREAM);
 			if (!pdb_stream) {
-				return 0;
+				goto beach;
 			}
-			init_r_pdb_stream (pdb_stream, pdb->buf, (int *) page->stream_pages,
+			init_r_pdb_stream (pdb_stream, pdb, (int *) page->stream_pages,
 				root_stream->pdb_stream.pages_amount, i,
 				page->stream_size, root_stream->pdb_stream.page_size);
 			rz_list_append (pList, pdb_stream);
 			break;
 		}
 		if (stream_file.error) {
-			return 0;
+			goto beach;
 		}
 		i++;
 	}
-	return 1;
+	ret = parse_streams (funcs, funcs_count);
+beach:
+	free (funcs);
+	return ret;
 }
 
 static bool pdb7_parse(RzPdb *pdb) {
@@ -570,17 +650,23 @@ static void finish_pdb_parse(RzPdb *pdb) {
 		switch (i) {
 		case 1:
 			pdb_info_stream = (SPDBInfoStream *) rz_list_iter_get (it);
-			free_pdb_stream (pdb_info_stream);
+			if (pdb_info_stream) {
+				pdb_info_stream->free_ (pdb_info_stream);
+			}
 			free (pdb_info_stream);
 			break;
 		case 2:
 			tpi_stream = (STpiStream *) rz_list_iter_get (it);
-			free_pdb_stream (tpi_stream);
+			if (tpi_stream) {
+				tpi_stream->free_ (tpi_stream);
+			}
 			free (tpi_stream);
 			break;
 		case 3:
 			dbi_stream = (SDbiStream *) rz_list_iter_get (it);
-			free_pdb_stream (dbi_stream);
+			if (dbi_stream) {
+				dbi_stream->free_ (dbi_stream);
+			}
 			free (dbi_stream);
 			break;
 		default:
@@ -616,6 +702,9 @@ static void finish_pdb_parse(RzPdb *pdb) {
 
 	free (pdb->stream_map);
 	rz_buf_free (pdb->buf);
+	pdb->buf = NULL;
+	rz_file_mmap_free (pdb->mmap);
+	pdb->mmap = NULL;
 
 // fclose(pdb->fp);
 // printf("finish_pdb_parse()\n");
@@ -1037,14 +1126,18 @@ static void print_enum(const char *name, const char *type, const RzList *members
  * @brief Prints out types in a default format "idpi" command
  * 
  * @param pdb pdb structure for printing function
- * @param types List of types
+ * @param tpi Stream of the types
  */
-static void print_types_regular(const RzPdb *pdb, const RzList *types) {
-	rz_return_if_fail (pdb && types);
-	RzListIter *it = rz_list_iterator (types);
+static void print_types_regular(const RzPdb *pdb, STpiStream *tpi) {
+	rz_return_if_fail (pdb && tpi);
+	ut32 idx;
 
-	while (rz_list_iter_next (it)) {
-		SType *type = rz_list_iter_get (it);
+	for (idx = tpi->header.idx_begin; idx < tpi->header.idx_begin + tpi->types_count; idx++) {
+		// only the printable records are parsed
+		if (!is_printable_type (tpi->get_leaf_type (tpi, idx))) {
+			continue;
+		}
+		SType *type = tpi->get_type (tpi, idx);
 		STypeInfo *type_info = &type->type_data;
 		// skip unprintable types
 		if (!type || !is_printable_type (type_info->leaf_type)) {
@@ -1094,16 +1187,20 @@ static void print_types_regular(const RzPdb *pdb, const RzList *types) {
  * @brief Prints out types in a json format - "idpij" command
  * 
  * @param pdb pdb structure for printing function
- * @param types List of types
+ * @param tpi Stream of the types
  */
-static void print_types_json(const RzPdb *pdb, PJ *pj, const RzList *types) {
-	rz_return_if_fail (pdb && types && pj);
+static void print_types_json(const RzPdb *pdb, PJ *pj, STpiStream *tpi) {
+	rz_return_if_fail (pdb && tpi && pj);
 
-	RzListIter *it = rz_list_iterator (types);
+	ut32 idx;
 	pj_ka (pj, "types");
 
-	while (rz_list_iter_next (it)) {
-		SType *type = rz_list_iter_get (it);
+	for (idx = tpi->header.idx_begin; idx < tpi->header.idx_begin + tpi->types_count; idx++) {
+		// only the printable records are parsed
+		if (!is_printable_type (tpi->get_leaf_type (tpi, idx))) {
+			continue;
+		}
+		SType *type = tpi->get_type (tpi, idx);
 		STypeInfo *type_info = &type->type_data;
 		// skip unprintable types
 		if (!type || !is_printable_type (type_info->leaf_type)) {
@@ -1212,14 +1309,18 @@ static void print_types_json(const RzPdb *pdb, PJ *pj, const RzList *types) {
  * @brief Creates pf commands from PDB types - "idpi*" command
  * 
  * @param pdb pdb structure for printing function
- * @param types List of types
+ * @param tpi Stream of the types
  */
-static void print_types_format(const RzPdb *pdb, const RzList *types) {
-	rz_return_if_fail (pdb && types);
-	RzListIter *it = rz_list_iterator (types);
+static void print_types_format(const RzPdb *pdb, STpiStream *tpi) {
+	rz_return_if_fail (pdb && tpi);
+	ut32 idx;
 	bool to_free_name = false;
-	while (rz_list_iter_next (it)) {
-		SType *type = rz_list_iter_get (it);
+	for (idx = tpi->header.idx_begin; idx < tpi->header.idx_begin + tpi->types_count; idx++) {
+		// only the printable records are parsed
+		if (!is_printable_type (tpi->get_leaf_type (tpi, idx))) {
+			continue;
+		}
+		SType *type = tpi->get_type (tpi, idx);
 		STypeInfo *type_info = &type->type_data;
 		// skip unprintable types and enums
 		if (!type || !is_printable_type (type_info->leaf_type) || type_info->leaf_type == eLF_ENUM) {
@@ -1312,9 +1413,9 @@ static void print_types(const RzPdb *pdb, PJ *pj, const int mode) {
 		return;
 	}
 	switch (mode) {
-	case 'd': print_types_regular (pdb, tpi_stream->types); return;
-	case 'j': print_types_json (pdb, pj, tpi_stream->types); return;
-	case 'r': print_types_format (pdb, tpi_stream->types); return;
+	case 'd': print_types_regular (pdb, tpi_stream); return;
+	case 'j': print_types_json (pdb, pj, tpi_stream); return;
+	case 'r': print_types_format (pdb, tpi_stream); return;
 	}
 }
 
@@ -1446,6 +1547,12 @@ RZ_API bool init_pdb_parser_with_buf(RzPdb *pdb, RzBuffer* buf) {
 	}
 
 	rz_buf_seek (pdb->buf, 0, RZ_BUF_SET);
+	// the streams are copied from here, without seeking the buffer
+	pdb->data = rz_buf_data (pdb->buf, &pdb->data_size);
+	if (!pdb->data) {
+		eprintf ("PDB reading error.\n");
+		goto error;
+	}
 
 	if (!memcmp (signature, PDB7_SIGNATURE, PDB7_SIGNATURE_LEN)) {
 		pdb->pdb_parse = pdb7_parse;
@@ -1468,10 +1575,27 @@ error:
 }
 
 RZ_API bool init_pdb_parser(RzPdb *pdb, const char *filename) {
-	RzBuffer *buf = rz_buf_new_slurp (filename);
+	// big pdbs are not read in memory: the mapping is kept in pdb and buf
+	// only points to it
+	RMmap *mmap = rz_file_mmap (filename, false, 0);
+	if (mmap && !mmap->buf) {
+		rz_file_mmap_free (mmap);
+		mmap = NULL;
+	}
+	RzBuffer *buf = mmap
+		? rz_buf_new_with_pointers (mmap->buf, mmap->len, false)
+		: rz_buf_new_slurp (filename);
 	if (!buf) {
 		eprintf ("%s: Error reading file \"%s\"\n", __func__, filename);
+		rz_file_mmap_free (mmap);
 		return false;
 	}
-	return init_pdb_parser_with_buf (pdb, buf);
+	if (!init_pdb_parser_with_buf (pdb, buf)) {
+		rz_buf_free (buf);
+		pdb->buf = NULL;
+		rz_file_mmap_free (mmap);
+		return false;
+	}
+	pdb->mmap = mmap;
+	return true;
 }
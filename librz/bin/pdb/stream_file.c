@@ -5,9 +5,10 @@
 /// size = -1 (default value)
 /// pages_size = 0x1000 (default value)
 ////////////////////////////////////////////////////////////////////////////////
-int init_r_stream_file(RZ_STREAM_FILE *stream_file, RzBuffer *buf, int *pages, int pages_amount, int size, int page_size) {
+int init_r_stream_file(RZ_STREAM_FILE *stream_file, const ut8 *data, ut64 data_size, int *pages, int pages_amount, int size, int page_size) {
 	stream_file->error = 0;
-	stream_file->buf = buf;
+	stream_file->data = data;
+	stream_file->data_size = data_size;
 	stream_file->pages = pages;
 	stream_file->pages_amount = pages_amount;
 	stream_file->page_size = page_size;
@@ -21,24 +22,31 @@ int init_r_stream_file(RZ_STREAM_FILE *stream_file, RzBuffer *buf, int *pages, i
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-static void stream_file_read_pages(RZ_STREAM_FILE *stream_file, int start_indx, int end_indx, char *res) {
-	int i, page_offset;
-
-	if ((end_indx - start_indx) > stream_file->end) {
-		stream_file->error = READ_PAGE_FAIL;
-		return;
-	}
-	end_indx = RZ_MIN (end_indx, stream_file->pages_amount);
-
-	for (i = start_indx; i < end_indx; i++) {
-		page_offset = stream_file->pages[i] * stream_file->page_size;
-		if (page_offset < 1) {
+// copies len bytes at offset pos of the stream, what is not in the file is zeroed
+// the file is only read, so the streams can be read from different threads
+static void stream_file_copy(RZ_STREAM_FILE *stream_file, int pos, char *res, int len) {
+	int pn, off;
+	GET_PAGE(pn, off, pos, stream_file->page_size);
+	while (len > 0) {
+		if (pn >= stream_file->pages_amount || stream_file->pages[pn] < 1) {
+			memset (res, 0, len);
 			return;
 		}
-		rz_buf_seek (stream_file->buf, page_offset, RZ_BUF_SET);
-		rz_buf_read_at (stream_file->buf, page_offset,
-			(ut8 *)res, stream_file->page_size);
-		res += stream_file->page_size;
+		int n = RZ_MIN (stream_file->page_size - off, len);
+		ut64 page_offset = (ut64)stream_file->pages[pn] * stream_file->page_size + off;
+		if (page_offset + n <= stream_file->data_size) {
+			memcpy (res, stream_file->data + page_offset, n);
+		} else {
+			ut64 avail = page_offset < stream_file->data_size ? stream_file->data_size - page_offset : 0;
+			if (avail) {
+				memcpy (res, stream_file->data + page_offset, avail);
+			}
+			memset (res + avail, 0, n - avail);
+		}
+		res += n;
+		len -= n;
+		pn++;
+		off = 0;
 	}
 }
 
@@ -46,27 +54,36 @@ static void stream_file_read_pages(RZ_STREAM_FILE *stream_file, int start_indx,
 ///////////////////////////////////////////////////////////////////////////////
 void stream_file_read(RZ_STREAM_FILE *stream_file, int size, char *res) {
 	int pn_start, off_start, pn_end, off_end;
+	if (stream_file->page_size < 1) {
+		stream_file->error = READ_PAGE_FAIL;
+		return;
+	}
+	// the result is zeroed when the pages can not be read
 	if (size == -1) {
-		char *pdata = (char *) malloc(stream_file->pages_amount * stream_file->page_size);
-		if (pdata) {
-			GET_PAGE(pn_start, off_start, stream_file->pos, stream_file->page_size);
-			(void)off_end; // hack to remove unused warning
-			stream_file_read_pages (stream_file, 0, stream_file->pages_amount, pdata);
+		GET_PAGE(pn_start, off_start, stream_file->pos, stream_file->page_size);
+		size = stream_file->end - off_start;
+		if (size <= 0) {
 			stream_file->pos = stream_file->end;
-			memcpy (res, pdata + off_start, stream_file->end - off_start);
-			free (pdata);
+			return;
 		}
-	} else {
+		if (stream_file->pages_amount > stream_file->end) {
+			stream_file->error = READ_PAGE_FAIL;
+			memset (res, 0, size);
+		} else {
+			stream_file_copy (stream_file, off_start, res, size);
+		}
+		stream_file->pos = stream_file->end;
+	} else if (size > 0) {
 		GET_PAGE(pn_start, off_start, stream_file->pos, stream_file->page_size);
 		GET_PAGE(pn_end, off_end, stream_file->pos + size, stream_file->page_size);
 		(void)off_end; // hack to remove unused warning
-		char *pdata = (char *) calloc(stream_file->page_size * (pn_end + 1 - pn_start), 1);
-		if (pdata) {
-			stream_file_read_pages(stream_file, pn_start, pn_end + 1, pdata);
-			stream_file->pos += size;
-			memcpy(res, pdata + off_start, size);
-			free (pdata);
+		if ((pn_end + 1 - pn_start) > stream_file->end) {
+			stream_file->error = READ_PAGE_FAIL;
+			memset (res, 0, size);
+		} else {
+			stream_file_copy (stream_file, stream_file->pos, res, size);
 		}
+		stream_file->pos += size;
 	}
 }
 
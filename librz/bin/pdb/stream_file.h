@@ -7,7 +7,7 @@
 /// size = -1 (default value)
 /// pages_size = 0x1000 (default value)
 ////////////////////////////////////////////////////////////////////////////////
-int init_r_stream_file(RZ_STREAM_FILE *stream_file, RzBuffer *buf, int *pages,
+int init_r_stream_file(RZ_STREAM_FILE *stream_file, const ut8 *data, ut64 data_size, int *pages,
 							  int pages_amount, int size, int page_size);
 
 // size by default = -1
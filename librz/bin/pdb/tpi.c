@@ -3,7 +3,14 @@
 #include "stream_file.h"
 
 static unsigned int base_idx = 0;
-static RzList *p_types_list;
+static STpiStream *p_tpi; // stream the type indexes are resolved in
+
+static SType *tpi_type_at(STpiStream *tpi, ut32 n);
+
+// record n of the stream (type index - base_idx), parsed on first use
+static SType *types_get_n(int n) {
+	return p_tpi && n >= 0 ? tpi_type_at (p_tpi, n) : NULL;
+}
 
 static bool is_simple_type(int idx) {
 	ut32 value = (ut32) idx;
@@ -818,7 +825,7 @@ static int get_array_element_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -844,7 +851,7 @@ static int get_array_index_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -871,7 +878,7 @@ static int get_bitfield_base_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -885,7 +892,7 @@ static int get_class_struct_derived(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -900,7 +907,7 @@ static int get_class_struct_vshape(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -927,7 +934,7 @@ static int get_mfunction_return_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -940,7 +947,7 @@ static int get_mfunction_class_type(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -955,7 +962,7 @@ static int get_mfunction_this_type(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -971,7 +978,7 @@ static int get_mfunction_arglist(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -999,7 +1006,7 @@ static int get_modifier_modified_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1025,7 +1032,7 @@ static int get_pointer_utype(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1050,7 +1057,7 @@ static int get_procedure_return_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1075,7 +1082,7 @@ static int get_procedure_arglist(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1100,7 +1107,7 @@ static int get_member_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1125,7 +1132,7 @@ static int get_nesttype_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1150,7 +1157,7 @@ static int get_onemethod_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1175,7 +1182,7 @@ static int get_method_mlist(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1200,7 +1207,7 @@ static int get_enum_utype(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = rz_list_get_n(p_types_list, curr_idx);
+		*ret_type = types_get_n (curr_idx);
 	}
 
 	return curr_idx;
@@ -1223,7 +1230,7 @@ static void get_union_members(void *type, RzList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf_union->field_list - base_idx;
-		tmp = (SType *)rz_list_get_n(p_types_list, indx);
+		tmp = (SType *)types_get_n (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1238,7 +1245,7 @@ static void get_struct_class_members(void *type, RzList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)rz_list_get_n(p_types_list, indx);
+		tmp = (SType *)types_get_n (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1253,7 +1260,7 @@ static void get_enum_members(void *type, RzList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)rz_list_get_n(p_types_list, indx);
+		tmp = (SType *)types_get_n (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1640,12 +1647,11 @@ static void free_lf_vtshape(void *type) {
 
 static void free_tpi_stream(void *stream) {
 	STpiStream *tpi_stream = (STpiStream *)stream;
-	RzListIter *it;
 	SType *type = NULL;
+	ut32 i;
 
-	it = rz_list_iterator (tpi_stream->types);
-	while (rz_list_iter_next (it)) {
-		type = (SType *) rz_list_iter_get (it);
+	for (i = 0; tpi_stream->types && i < tpi_stream->types_count; i++) {
+		type = tpi_stream->types[i];
 		if (!type) {
 			continue;
 		}
@@ -1660,7 +1666,12 @@ static void free_tpi_stream(void *stream) {
 		}
 		RZ_FREE (type);
 	}
-	rz_list_free (tpi_stream->types);
+	RZ_FREE (tpi_stream->types);
+	RZ_FREE (tpi_stream->offsets);
+	RZ_FREE (tpi_stream->data);
+	if (p_tpi == tpi_stream) {
+		p_tpi = NULL;
+	}
 }
 
 static void get_array_print_type(void *type, char **name) {
@@ -2869,19 +2880,22 @@ static int parse_lf_vtshape(SLF_VTSHAPE *lf_vtshape, uint8_t *leaf_data, unsigne
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-static int parse_tpi_stypes(RZ_STREAM_FILE *stream, SType *type) {
+static int parse_tpi_stypes(const ut8 *record, ut32 size, SType *type) {
 	uint8_t *leaf_data;
 	unsigned int read_bytes = 0;
 
-	stream_file_read(stream, 2, (char *)&type->length);
-	if (type->length < 1) {
+	if (size < 2) {
+		return 0;
+	}
+	type->length = rz_read_le16 (record);
+	if (type->length < 2 || type->length > size - 2) {
 		return 0;
 	}
 	leaf_data = (uint8_t *) malloc(type->length);
 	if (!leaf_data) {
 		return 0;
 	}
-	stream_file_read (stream, type->length, (char *)leaf_data);
+	memcpy (leaf_data, record + 2, type->length);
 	type->type_data.leaf_type = *(uint16_t *)leaf_data;
 	read_bytes += 2;
 	switch (type->type_data.leaf_type) {
@@ -2947,34 +2961,103 @@ static int parse_tpi_stypes(RZ_STREAM_FILE *stream, SType *type) {
 	return read_bytes;
 }
 
+static SType *tpi_type_at(STpiStream *tpi, ut32 n) {
+	if (n >= tpi->types_count) {
+		return NULL;
+	}
+	if (tpi->types[n] || tpi->offsets[n] == UT32_MAX) {
+		return tpi->types[n];
+	}
+	SType *type = RZ_NEW0 (SType);
+	if (!type) {
+		return NULL;
+	}
+	type->tpi_idx = tpi->header.idx_begin + n;
+	type->type_data.type_info = 0;
+	type->type_data.leaf_type = eLF_MAX;
+	init_stype_info (&type->type_data);
+	ut32 offset = tpi->offsets[n];
+	if (!parse_tpi_stypes (tpi->data + offset, tpi->data_size - offset, type)) {
+		RZ_FREE (type);
+		// not parsed again on the next lookups
+		tpi->offsets[n] = UT32_MAX;
+		return NULL;
+	}
+	tpi->types[n] = type;
+	return type;
+}
+
+static SType *tpi_get_type(void *stream, ut32 idx) {
+	STpiStream *tpi = (STpiStream *) stream;
+	if (idx < tpi->header.idx_begin) {
+		return NULL;
+	}
+	return tpi_type_at (tpi, idx - tpi->header.idx_begin);
+}
+
+// leaf type of a record without parsing it
+static ELeafType tpi_get_leaf_type(void *stream, ut32 idx) {
+	STpiStream *tpi = (STpiStream *) stream;
+	ut32 n = idx - tpi->header.idx_begin;
+	if (idx < tpi->header.idx_begin || n >= tpi->types_count) {
+		return eLF_MAX;
+	}
+	if (tpi->types[n]) {
+		return tpi->types[n]->type_data.leaf_type;
+	}
+	ut32 offset = tpi->offsets[n];
+	if (offset == UT32_MAX || tpi->data_size - offset < 4 || rz_read_le16 (tpi->data + offset) < 2) {
+		return eLF_MAX;
+	}
+	return rz_read_le16 (tpi->data + offset + 2);
+}
+
 int parse_tpi_stream(void *parsed_pdb_stream, RZ_STREAM_FILE *stream) {
-	int i;
-	SType *type = 0;
+	ut32 i, pos = 0;
 	STpiStream *tpi_stream = (STpiStream *) parsed_pdb_stream;
-	tpi_stream->types = rz_list_new ();
-	p_types_list = tpi_stream->types;
+	p_tpi = tpi_stream;
 
 	stream_file_read(stream, sizeof(STPIHeader), (char *)&tpi_stream->header);
 
 	base_idx = tpi_stream->header.idx_begin;
 
-	for (i = tpi_stream->header.idx_begin; i < tpi_stream->header.idx_end; i++) {
-		type = (SType *) malloc (sizeof (SType));
-		if (!type) {
+	// the records are only indexed here, they are parsed by tpi_get_type ()
+	int size = stream->end - stream_file_tell (stream);
+	if (size > 0) {
+		tpi_stream->data = (ut8 *) malloc (size);
+		if (!tpi_stream->data) {
 			return 0;
 		}
-		type->tpi_idx = i;
-		type->type_data.type_info = 0;
-		type->type_data.leaf_type = eLF_MAX;
-		init_stype_info(&type->type_data);
-		if (!parse_tpi_stypes(stream, type)) {
-			RZ_FREE (type);
+		stream_file_read (stream, size, (char *)tpi_stream->data);
+		tpi_stream->data_size = size;
+	}
+	if (tpi_stream->header.idx_end <= tpi_stream->header.idx_begin) {
+		return 1;
+	}
+	// a record takes 2 bytes at least
+	tpi_stream->types_count = RZ_MIN (tpi_stream->header.idx_end - tpi_stream->header.idx_begin,
+		tpi_stream->data_size / 2);
+	if (!tpi_stream->types_count) {
+		return 1;
+	}
+	tpi_stream->offsets = (ut32 *) malloc (tpi_stream->types_count * sizeof (ut32));
+	tpi_stream->types = (SType **) calloc (tpi_stream->types_count, sizeof (SType *));
+	if (!tpi_stream->offsets || !tpi_stream->types) {
+		return 0;
+	}
+	for (i = 0; i < tpi_stream->types_count; i++) {
+		if (pos + 2 > tpi_stream->data_size) {
+			tpi_stream->offsets[i] = UT32_MAX;
+			continue;
 		}
-		rz_list_append(tpi_stream->types, type);
+		tpi_stream->offsets[i] = pos;
+		pos += 2 + rz_read_le16 (tpi_stream->data + pos);
 	}
 	return 1;
 }
 
 void init_tpi_stream(STpiStream *tpi_stream) {
+	tpi_stream->get_type = tpi_get_type;
+	tpi_stream->get_leaf_type = tpi_get_leaf_type;
 	tpi_stream->free_ = free_tpi_stream;
 }
@@ -92,7 +92,8 @@
 
 typedef struct RZ_STREAM_FILE_{
 //	FILE *fp;
-	RzBuffer *buf;
+	const ut8 *data; // whole file, the pages are copied from here
+	ut64 data_size;
 	int *pages;
 	int page_size;
 	int pages_amount;
@@ -1147,10 +1148,20 @@ typedef struct {
 //	free_func free_;
 }) SType;
 
+typedef SType *(*get_tpi_type_)(void *stream, ut32 idx);
+typedef ELeafType (*get_tpi_leaf_type_)(void *stream, ut32 idx);
+
 typedef struct {
 	STPIHeader header;
-	RzList *types;
-
+	// records are parsed the first time their type index is asked for
+	ut8 *data;
+	ut32 data_size;
+	ut32 *offsets; // of the records in data, by type index - idx_begin
+	SType **types; // parsed records, NULL until then
+	ut32 types_count;
+
+	get_tpi_type_ get_type;
+	get_tpi_leaf_type_ get_leaf_type;
 	free_func free_;
 } STpiStream;
 
@@ -49,20 +49,19 @@ static char* utf8_line_horiz (int dot_style) {
 
 static void apply_line_style(RzConsCanvas *c, int x, int y, int x2, int y2,
 		RzCanvasLineStyle *style, int isvert) {
-	RzCons *cons = rz_cons_singleton ();
 	switch (style->color) {
 	case LINE_UNCJMP:
-		c->attr = cons->context->pal.graph_trufae;
+		c->attr = rz_cons_context ()->pal.graph_trufae;
 		break;
 	case LINE_TRUE:
-		c->attr = cons->context->pal.graph_true;
+		c->attr = rz_cons_context ()->pal.graph_true;
 		break;
 	case LINE_FALSE:
-		c->attr = cons->context->pal.graph_false;
+		c->attr = rz_cons_context ()->pal.graph_false;
 		break;
 	case LINE_NONE:
 	default:
-		c->attr = cons->context->pal.graph_trufae;
+		c->attr = rz_cons_context ()->pal.graph_trufae;
 		break;
 	}
 	if (!c->color) {
@@ -1,6 +1,7 @@
 /* rizin - LGPL - Copyright 2008-2020 - pancake, Jody Frankowski */
 
 #include <rz_cons.h>
+#include <rz_th.h>
 #include <rz_util.h>
 #include <rz_util/rz_print.h>
 #include <limits.h>
@@ -10,13 +11,17 @@
 #include <stdarg.h>
 
 #define COUNT_LINES 1
-#define CTX(x) I.context->x
+#define CTX(x) CONTEXT->x
 
 RZ_LIB_VERSION (rz_cons);
 
 static RzConsContext rz_cons_context_default = {{{{0}}}};
 static RzCons rz_cons_instance = {0};
 #define I rz_cons_instance
+// Context loaded by the calling thread with rz_cons_context_load_local (),
+// tasks running in parallel each print through their own
+static RZ_TH_LOCAL RzConsContext *cons_context_local = NULL;
+#define CONTEXT (cons_context_local ? cons_context_local : I.context)
 
 //this structure goes into cons_stack when rz_cons_push/pop
 typedef struct {
@@ -60,20 +65,20 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 		}
 		data->grep = RZ_NEW0 (RzConsGrep);
 		if (data->grep) {
-			memcpy (data->grep, &I.context->grep, sizeof (RzConsGrep));
-			if (I.context->grep.str) {
-				data->grep->str = strdup (I.context->grep.str);
+			memcpy (data->grep, &CONTEXT->grep, sizeof (RzConsGrep));
+			if (CONTEXT->grep.str) {
+				data->grep->str = strdup (CONTEXT->grep.str);
 			}
 		}
-		if (recreate && I.context->buffer_sz > 0) {
-			I.context->buffer = malloc (I.context->buffer_sz);
-			if (!I.context->buffer) {
-				I.context->buffer = data->buf;
+		if (recreate && CONTEXT->buffer_sz > 0) {
+			CONTEXT->buffer = malloc (CONTEXT->buffer_sz);
+			if (!CONTEXT->buffer) {
+				CONTEXT->buffer = data->buf;
 				free (data);
 				return NULL;
 			}
 		} else {
-			I.context->buffer = NULL;
+			CONTEXT->buffer = NULL;
 		}
 	}
 	return data;
@@ -82,15 +87,15 @@ static RzConsStack *cons_stack_dump(bool recreate) {
 static void cons_stack_load(RzConsStack *data, bool free_current) {
 	rz_return_if_fail (data);
 	if (free_current) {
-		free (I.context->buffer);
+		free (CONTEXT->buffer);
 	}
-	I.context->buffer = data->buf;
+	CONTEXT->buffer = data->buf;
 	data->buf = NULL;
-	I.context->buffer_len = data->buf_len;
-	I.context->buffer_sz = data->buf_size;
+	CONTEXT->buffer_len = data->buf_len;
+	CONTEXT->buffer_sz = data->buf_size;
 	if (data->grep) {
-		free (I.context->grep.str);
-		memcpy (&I.context->grep, data->grep, sizeof (RzConsGrep));
+		free (CONTEXT->grep.str);
+		memcpy (&CONTEXT->grep, data->grep, sizeof (RzConsGrep));
 	}
 }
 
@@ -167,7 +172,7 @@ static inline void __cons_write(const char *obuf, int olen) {
 
 RZ_API RzColor rz_cons_color_random(ut8 alpha) {
 	RzColor rcolor = {0};
-	if (I.context->color_mode > COLOR_MODE_16) {
+	if (CONTEXT->color_mode > COLOR_MODE_16) {
 		rcolor.r = rz_num_rand (0xff);
 		rcolor.g = rz_num_rand (0xff);
 		rcolor.b = rz_num_rand (0xff);
@@ -279,7 +284,7 @@ RZ_API RzCons *rz_cons_singleton(void) {
 }
 
 RZ_API void rz_cons_break_clear(void) {
-	I.context->breaked = false;
+	CONTEXT->breaked = false;
 }
 
 RZ_API void rz_cons_context_break_push(RzConsContext *context, RzConsBreak cb, void *user, bool sig) {
@@ -332,15 +337,15 @@ RZ_API void rz_cons_context_break_pop(RzConsContext *context, bool sig) {
 }
 
 RZ_API void rz_cons_break_push(RzConsBreak cb, void *user) {
-	rz_cons_context_break_push (I.context, cb, user, true);
+	rz_cons_context_break_push (CONTEXT, cb, user, true);
 }
 
 RZ_API void rz_cons_break_pop(void) {
-	rz_cons_context_break_pop (I.context, true);
+	rz_cons_context_break_pop (CONTEXT, true);
 }
 
 RZ_API bool rz_cons_is_interactive(void) {
-	return I.context->is_interactive;
+	return CONTEXT->is_interactive;
 }
 
 RZ_API bool rz_cons_default_context_is_interactive(void) {
@@ -353,12 +358,12 @@ RZ_API bool rz_cons_is_breaked(void) {
 	}
 	if (I.timeout) {
 		if (rz_time_now_mono () > I.timeout) {
-			I.context->breaked = true;
+			CONTEXT->breaked = true;
 			eprintf ("\nTimeout!\n");
 			I.timeout = 0;
 		}
 	}
-	return I.context->breaked;
+	return CONTEXT->breaked;
 }
 
 RZ_API int rz_cons_get_cur_line(void) {
@@ -399,18 +404,18 @@ RZ_API void rz_cons_break_timeout(int timeout) {
 }
 
 RZ_API void rz_cons_break_end(void) {
-	I.context->breaked = false;
+	CONTEXT->breaked = false;
 	I.timeout = 0;
 #if __UNIX__
 	rz_sys_signal (SIGINT, SIG_IGN);
 #endif
-	if (!rz_stack_is_empty (I.context->break_stack)) {
+	if (!rz_stack_is_empty (CONTEXT->break_stack)) {
 		// free all the stack
-		rz_stack_free (I.context->break_stack);
+		rz_stack_free (CONTEXT->break_stack);
 		// create another one
-		I.context->break_stack = rz_stack_newf (6, break_stack_free);
-		I.context->event_interrupt_data = NULL;
-		I.context->event_interrupt = NULL;
+		CONTEXT->break_stack = rz_stack_newf (6, break_stack_free);
+		CONTEXT->event_interrupt_data = NULL;
+		CONTEXT->event_interrupt = NULL;
 	}
 }
 
@@ -543,7 +548,7 @@ RZ_API RzCons *rz_cons_new(void) {
 	I.lines = 0;
 
 	I.context = &rz_cons_context_default;
-	cons_context_init (I.context, NULL);
+	cons_context_init (CONTEXT, NULL);
 
 	rz_cons_get_size (&I.pagesize);
 	I.num = NULL;
@@ -601,11 +606,11 @@ RZ_API RzCons *rz_cons_free(void) {
 		rz_line_free ();
 		I.line = NULL;
 	}
-	RZ_FREE (I.context->buffer);
+	RZ_FREE (CONTEXT->buffer);
 	RZ_FREE (I.break_word);
-	cons_context_deinit (I.context);
-	RZ_FREE (I.context->lastOutput);
-	I.context->lastLength = 0;
+	cons_context_deinit (CONTEXT);
+	RZ_FREE (CONTEXT->lastOutput);
+	CONTEXT->lastLength = 0;
 	RZ_FREE (I.pager);
 	return NULL;
 }
@@ -616,7 +621,7 @@ static bool palloc(int moar) {
 	if (moar <= 0) {
 		return false;
 	}
-	if (!I.context->buffer) {
+	if (!CONTEXT->buffer) {
 		int new_sz;
 		if ((INT_MAX - MOAR) < moar) {
 			return false;
@@ -624,22 +629,22 @@ static bool palloc(int moar) {
 		new_sz = moar + MOAR;
 		temp = calloc (1, new_sz);
 		if (temp) {
-			I.context->buffer_sz = new_sz;
-			I.context->buffer = temp;
-			I.context->buffer[0] = '\0';
+			CONTEXT->buffer_sz = new_sz;
+			CONTEXT->buffer = temp;
+			CONTEXT->buffer[0] = '\0';
 		}
-	} else if (moar + I.context->buffer_len > I.context->buffer_sz) {
+	} else if (moar + CONTEXT->buffer_len > CONTEXT->buffer_sz) {
 		char *new_buffer;
-		int old_buffer_sz = I.context->buffer_sz;
-		if ((INT_MAX - MOAR - moar) < I.context->buffer_sz) {
+		int old_buffer_sz = CONTEXT->buffer_sz;
+		if ((INT_MAX - MOAR - moar) < CONTEXT->buffer_sz) {
 			return false;
 		}
-		I.context->buffer_sz += moar + MOAR;
-		new_buffer = realloc (I.context->buffer, I.context->buffer_sz);
+		CONTEXT->buffer_sz += moar + MOAR;
+		new_buffer = realloc (CONTEXT->buffer, CONTEXT->buffer_sz);
 		if (new_buffer) {
-			I.context->buffer = new_buffer;
+			CONTEXT->buffer = new_buffer;
 		} else {
-			I.context->buffer_sz = old_buffer_sz;
+			CONTEXT->buffer_sz = old_buffer_sz;
 			return false;
 		}
 	}
@@ -729,40 +734,44 @@ static void cons_grep_reset(RzConsGrep *grep) {
 }
 
 RZ_API void rz_cons_reset(void) {
-	if (I.context->buffer) {
-		I.context->buffer[0] = '\0';
+	if (CONTEXT->buffer) {
+		CONTEXT->buffer[0] = '\0';
 	}
-	I.context->buffer_len = 0;
+	CONTEXT->buffer_len = 0;
 	I.lines = 0;
-	I.lastline = I.context->buffer;
-	cons_grep_reset (&I.context->grep);
+	I.lastline = CONTEXT->buffer;
+	cons_grep_reset (&CONTEXT->grep);
 	CTX (pageable) = true;
 }
 
 RZ_API const char *rz_cons_get_buffer(void) {
 	//check len otherwise it will return trash
-	return I.context->buffer_len? I.context->buffer : NULL;
+	return CONTEXT->buffer_len? CONTEXT->buffer : NULL;
 }
 
 RZ_API int rz_cons_get_buffer_len(void) {
-	return I.context->buffer_len;
+	return CONTEXT->buffer_len;
+}
+
+static bool cons_grep_active(void) {
+	return I.filter || CONTEXT->grep.nstrings > 0 || CONTEXT->grep.tokens_used || CONTEXT->grep.less || CONTEXT->grep.json;
 }
 
 RZ_API void rz_cons_filter(void) {
 	/* grep */
-	if (I.filter || I.context->grep.nstrings > 0 || I.context->grep.tokens_used || I.context->grep.less || I.context->grep.json) {
+	if (cons_grep_active ()) {
 		(void)rz_cons_grepbuf ();
 		I.filter = false;
 	}
 	/* html */
 	if (I.is_html) {
 		int newlen = 0;
-		char *input = rz_str_ndup (I.context->buffer, I.context->buffer_len);
+		char *input = rz_str_ndup (CONTEXT->buffer, CONTEXT->buffer_len);
 		char *res = rz_cons_html_filter (input, &newlen);
-		free (I.context->buffer);
-		I.context->buffer = res;
-		I.context->buffer_len = newlen;
-		I.context->buffer_sz = newlen;
+		free (CONTEXT->buffer);
+		CONTEXT->buffer = res;
+		CONTEXT->buffer_len = newlen;
+		CONTEXT->buffer_sz = newlen;
 		free (input);
 	}
 	if (I.was_html) {
@@ -772,25 +781,25 @@ RZ_API void rz_cons_filter(void) {
 }
 
 RZ_API void rz_cons_push(void) {
-	if (!I.context->cons_stack) {
+	if (!CONTEXT->cons_stack) {
 		return;
 	}
 	RzConsStack *data = cons_stack_dump (true);
 	if (!data) {
 		return;
 	}
-	rz_stack_push (I.context->cons_stack, data);
-	I.context->buffer_len = 0;
-	if (I.context->buffer) {
-		memset (I.context->buffer, 0, I.context->buffer_sz);
+	rz_stack_push (CONTEXT->cons_stack, data);
+	CONTEXT->buffer_len = 0;
+	if (CONTEXT->buffer) {
+		memset (CONTEXT->buffer, 0, CONTEXT->buffer_sz);
 	}
 }
 
 RZ_API void rz_cons_pop(void) {
-	if (!I.context->cons_stack) {
+	if (!CONTEXT->cons_stack) {
 		return;
 	}
-	RzConsStack *data = (RzConsStack *)rz_stack_pop (I.context->cons_stack);
+	RzConsStack *data = (RzConsStack *)rz_stack_pop (CONTEXT->cons_stack);
 	if (!data) {
 		return;
 	}
@@ -819,12 +828,33 @@ RZ_API void rz_cons_context_load(RzConsContext *context) {
 	I.context = context;
 }
 
+/* Loads context for the calling thread only, while the others keep using
+ * the one of rz_cons_context_load (). NULL unloads it. */
+RZ_API void rz_cons_context_load_local(RZ_NULLABLE RzConsContext *context) {
+	cons_context_local = context;
+}
+
+/* Context the calling thread prints to */
+RZ_API RzConsContext *rz_cons_context(void) {
+	return CONTEXT;
+}
+
+/* Sends everything flushed while context is loaded to cb, in chunks of size
+ * bytes as it is produced (see rz_cons_stream_flush ()) and the rest at the
+ * final rz_cons_flush (). A NULL cb writes to fdout again. */
+RZ_API void rz_cons_context_stream(RzConsContext *context, size_t size, RZ_NULLABLE RzConsStreamCallback cb, void *user) {
+	rz_return_if_fail (context);
+	context->stream = cb? size: 0;
+	context->stream_cb = cb;
+	context->stream_user = user;
+}
+
 RZ_API void rz_cons_context_reset(void) {
 	I.context = &rz_cons_context_default;
 }
 
 RZ_API bool rz_cons_context_is_main(void) {
-	return I.context == &rz_cons_context_default;
+	return CONTEXT == &rz_cons_context_default;
 }
 
 RZ_API void rz_cons_context_break(RzConsContext *context) {
@@ -846,10 +876,10 @@ RZ_API void rz_cons_last(void) {
 }
 
 static bool lastMatters(void) {
-	return (I.context->buffer_len > 0) \
-		&& (CTX (lastEnabled) && !I.filter && I.context->grep.nstrings < 1 && \
-		!I.context->grep.tokens_used && !I.context->grep.less && \
-		!I.context->grep.json && !I.is_html);
+	return (CONTEXT->buffer_len > 0) \
+		&& (CTX (lastEnabled) && !I.filter && CONTEXT->grep.nstrings < 1 && \
+		!CONTEXT->grep.tokens_used && !CONTEXT->grep.less && \
+		!CONTEXT->grep.json && !I.is_html);
 }
 
 RZ_API void rz_cons_echo(const char *msg) {
@@ -872,8 +902,131 @@ RZ_API void rz_cons_echo(const char *msg) {
 	}
 }
 
-RZ_API void rz_cons_flush(void) {
+static void cons_tee(const char *buf, size_t len) {
 	const char *tee = I.teefile;
+	if (tee && *tee) {
+		FILE *d = rz_sandbox_fopen (tee, "a+");
+		if (d) {
+			if (len != fwrite (buf, 1, len, d)) {
+				eprintf ("rz_cons_flush: fwrite: error (%s)\n", tee);
+			}
+			fclose (d);
+		} else {
+			eprintf ("Cannot write on '%s'\n", tee);
+		}
+	}
+}
+
+static size_t cons_stream_size(void) {
+	return CTX (stream_cb)? CTX (stream): I.stream;
+}
+
+static void cons_write_out(const char *buf, size_t len) {
+	if (CTX (stream_cb)) {
+		CTX (stream_cb) (buf, len, CTX (stream_user));
+		return;
+	}
+	cons_tee (buf, len);
+	__cons_write (buf, len);
+}
+
+// Whether the output can be written before the command is done. Filters
+// that need all of it (sort, json, less, zoom, negative line indexes) and
+// anything that captures or post-processes the buffer keep it in memory.
+static bool cons_streamable(void) {
+	RzConsGrep *grep = &CONTEXT->grep;
+	if (I.noflush || I.null || I.filter || I.is_html || I.was_html || I.linesleep || RZ_STR_ISNOTEMPTY (I.highlight)) {
+		return false;
+	}
+	if (CONTEXT->cons_stack && !rz_stack_is_empty (CONTEXT->cons_stack)) {
+		return false;
+	}
+	if (rz_cons_is_interactive () && I.fdout == 1 && CTX (pageable) && RZ_STR_ISNOTEMPTY (I.pager)) {
+		return false;
+	}
+	if (!cons_grep_active ()) {
+		return true;
+	}
+	if (grep->less || grep->hud || grep->json || grep->zoom || grep->sort != -1 || grep->charCounter) {
+		return false;
+	}
+	if (!grep->range_line && grep->line < 0) {
+		return false;
+	}
+	return grep->range_line != 1 || (grep->f_line >= 0 && grep->l_line > 0);
+}
+
+// Writes out the buffered output of the current command. Only complete lines
+// can go through a grep, the rest stays in the buffer for the next call or
+// the final rz_cons_flush (). With partial set and no grep, an unterminated
+// line is written too.
+static void cons_stream(bool partial) {
+	char *buf = CTX (buffer);
+	size_t len = CTX (buffer_len);
+	bool grep = cons_grep_active ();
+	if (grep || !partial) {
+		while (len > 0 && buf[len - 1] != '\n') {
+			len--;
+		}
+	}
+	if (!len) {
+		return;
+	}
+	if (grep) {
+		if (!CTX (grep.streamed)) {
+			I.lines = 0;
+		}
+		RzStrBuf *ob = rz_strbuf_new ("");
+		if (!ob) {
+			return;
+		}
+		if (!rz_cons_grep_lines (buf, len, ob)) {
+			rz_strbuf_free (ob);
+			return;
+		}
+		if (!CTX (grep.counter)) {
+			cons_write_out (rz_strbuf_get (ob), rz_strbuf_length (ob));
+		}
+		rz_strbuf_free (ob);
+	} else {
+		cons_write_out (buf, len);
+	}
+	CTX (buffer_len) -= len;
+	memmove (buf, buf + len, CTX (buffer_len));
+	buf[CTX (buffer_len)] = 0;
+	I.lastline = buf;
+	CTX (grep.streamed) = true;
+}
+
+/* Writes out the complete lines the current command printed so far when
+ * scr.stream is set and more than that many bytes are buffered, instead of
+ * holding all of the output until rz_cons_flush (). Producers of big outputs
+ * call it between lines. */
+RZ_API void rz_cons_stream_flush(void) {
+	size_t size = cons_stream_size ();
+	if (size && CTX (buffer_len) >= size && cons_streamable ()) {
+		cons_stream (false);
+	}
+}
+
+static void cons_pj_flush(const char *buf, size_t len, void *user) {
+	rz_cons_memcat (buf, len);
+	if (cons_streamable ()) {
+		cons_stream (true);
+	}
+}
+
+// Makes pj pass the document to the console in chunks when the output is
+// streamed, the caller still prints what pj_string () returns at the end.
+RZ_API void rz_cons_pj_stream(PJ *pj) {
+	rz_return_if_fail (pj);
+	size_t size = cons_stream_size ();
+	if (size && cons_streamable ()) {
+		pj_set_flush (pj, size, cons_pj_flush, NULL);
+	}
+}
+
+RZ_API void rz_cons_flush(void) {
 	if (I.noflush) {
 		return;
 	}
@@ -881,7 +1034,11 @@ RZ_API void rz_cons_flush(void) {
 		rz_cons_reset ();
 		return;
 	}
-	if (lastMatters () && !CTX (lastMode)) {
+	if (CTX (grep.streamed)) {
+		// only the tail is left, there is nothing to snapshot for `_`
+		CTX (lastLength) = 0;
+		CTX (lastMode) = false;
+	} else if (lastMatters () && !CTX (lastMode)) {
 		// snapshot of the output
 		if (CTX (buffer_len) > CTX (lastLength)) {
 			free (CTX (lastOutput));
@@ -893,10 +1050,17 @@ RZ_API void rz_cons_flush(void) {
 		CTX (lastMode) = false;
 	}
 	rz_cons_filter ();
-	if (rz_cons_is_interactive () && I.fdout == 1) {
+	if (CTX (stream_cb)) {
+		if (CTX (buffer_len)) {
+			CTX (stream_cb) (CTX (buffer), CTX (buffer_len), CTX (stream_user));
+		}
+		rz_cons_reset ();
+		return;
+	}
+	if (rz_cons_is_interactive () && I.fdout == 1 && !CTX (grep.streamed)) {
 		/* Use a pager if the output doesn't fit on the terminal window. */
 		if (CTX (pageable) && CTX (buffer) && I.pager && *I.pager && CTX (buffer_len) > 0 && rz_str_char_count (CTX (buffer), '\n') >= I.rows) {
-			I.context->buffer[I.context->buffer_len - 1] = 0;
+			CONTEXT->buffer[CONTEXT->buffer_len - 1] = 0;
 			if (!strcmp (I.pager, "..")) {
 				char *str = rz_str_ndup (CTX (buffer), CTX (buffer_len));
 				CTX (pageable) = false;
@@ -908,11 +1072,11 @@ RZ_API void rz_cons_flush(void) {
 				rz_sys_cmd_str_full (I.pager, CTX (buffer), NULL, NULL, NULL);
 				rz_cons_reset ();
 			}
-		} else if (I.context->buffer_len > CONS_MAX_USER) {
+		} else if (CONTEXT->buffer_len > CONS_MAX_USER) {
 #if COUNT_LINES
 			int i, lines = 0;
-			for (i = 0; I.context->buffer[i]; i++) {
-				if (I.context->buffer[i] == '\n') {
+			for (i = 0; CONTEXT->buffer[i]; i++) {
+				if (CONTEXT->buffer[i] == '\n') {
 					lines ++;
 				}
 			}
@@ -922,7 +1086,7 @@ RZ_API void rz_cons_flush(void) {
 			}
 #else
 			char buf[8];
-			rz_num_units (buf, sizeof (buf), I.context->buffer_len);
+			rz_num_units (buf, sizeof (buf), CONTEXT->buffer_len);
 			if (!rz_cons_yesno ('n', "Do you want to print %s chars? (y/N)", buf)) {
 				rz_cons_reset ();
 				return;
@@ -932,17 +1096,7 @@ RZ_API void rz_cons_flush(void) {
 			rz_cons_set_raw (true);
 		}
 	}
-	if (tee && *tee) {
-		FILE *d = rz_sandbox_fopen (tee, "a+");
-		if (d) {
-			if (I.context->buffer_len != fwrite (I.context->buffer, 1, I.context->buffer_len, d)) {
-				eprintf ("rz_cons_flush: fwrite: error (%s)\n", tee);
-			}
-			fclose (d);
-		} else {
-			eprintf ("Cannot write on '%s'\n", tee);
-		}
-	}
+	cons_tee (CONTEXT->buffer, CONTEXT->buffer_len);
 	rz_cons_highlight (I.highlight);
 
 	// is_html must be a filter, not a write endpoint
@@ -950,10 +1104,10 @@ RZ_API void rz_cons_flush(void) {
 		if (I.linesleep > 0 && I.linesleep < 1000) {
 			int i = 0;
 			int pagesize = RZ_MAX (1, I.pagesize);
-			char *ptr = I.context->buffer;
+			char *ptr = CONTEXT->buffer;
 			char *nl = strchr (ptr, '\n');
-			int len = I.context->buffer_len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			int len = CONTEXT->buffer_len;
+			CONTEXT->buffer[CONTEXT->buffer_len] = 0;
 			rz_cons_break_push (NULL, NULL);
 			while (nl && !rz_cons_is_breaked ()) {
 				__cons_write (ptr, nl - ptr + 1);
@@ -964,13 +1118,13 @@ RZ_API void rz_cons_flush(void) {
 				nl = strchr (ptr, '\n');
 				i++;
 			}
-			__cons_write (ptr, I.context->buffer + len - ptr);
+			__cons_write (ptr, CONTEXT->buffer + len - ptr);
 			rz_cons_break_pop ();
 		} else {
-			__cons_write (I.context->buffer, I.context->buffer_len);
+			__cons_write (CONTEXT->buffer, CONTEXT->buffer_len);
 		}
 	} else {
-		__cons_write (I.context->buffer, I.context->buffer_len);
+		__cons_write (CONTEXT->buffer, CONTEXT->buffer_len);
 	}
 
 	rz_cons_reset ();
@@ -989,12 +1143,12 @@ RZ_API void rz_cons_visual_flush(void) {
 /* TODO: this ifdef must go in the function body */
 #if __WINDOWS__
 		if (I.vtmode) {
-			rz_cons_visual_write (I.context->buffer);
+			rz_cons_visual_write (CONTEXT->buffer);
 		} else {
-			rz_cons_w32_print (I.context->buffer, I.context->buffer_len, true);
+			rz_cons_w32_print (CONTEXT->buffer, CONTEXT->buffer_len, true);
 		}
 #else
-		rz_cons_visual_write (I.context->buffer);
+		rz_cons_visual_write (CONTEXT->buffer);
 #endif
 	}
 	rz_cons_reset ();
@@ -1132,8 +1286,8 @@ RZ_API void rz_cons_printf_list(const char *format, va_list ap) {
 	if (strchr (format, '%')) {
 		if (palloc (MOAR + strlen (format) * 20)) {
 club:
-			size = I.context->buffer_sz - I.context->buffer_len - 1; /* remaining space in I.context->buffer */
-			written = vsnprintf (I.context->buffer + I.context->buffer_len, size, format, ap3);
+			size = CONTEXT->buffer_sz - CONTEXT->buffer_len - 1; /* remaining space in CONTEXT->buffer */
+			written = vsnprintf (CONTEXT->buffer + CONTEXT->buffer_len, size, format, ap3);
 			if (written >= size) { /* not all bytes were written */
 				if (palloc (written)) {
 					va_end (ap3);
@@ -1141,8 +1295,8 @@ club:
 					goto club;
 				}
 			}
-			I.context->buffer_len += written;
-			I.context->buffer[I.context->buffer_len] = 0;
+			CONTEXT->buffer_len += written;
+			CONTEXT->buffer[CONTEXT->buffer_len] = 0;
 		}
 	} else {
 		rz_cons_strcat (format);
@@ -1164,11 +1318,11 @@ RZ_API int rz_cons_printf(const char *format, ...) {
 }
 
 RZ_API int rz_cons_get_column(void) {
-	char *line = strrchr (I.context->buffer, '\n');
+	char *line = strrchr (CONTEXT->buffer, '\n');
 	if (!line) {
-		line = I.context->buffer;
+		line = CONTEXT->buffer;
 	}
-	I.context->buffer[I.context->buffer_len] = 0;
+	CONTEXT->buffer[CONTEXT->buffer_len] = 0;
 	return rz_str_ansi_len (line);
 }
 
@@ -1186,9 +1340,9 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 	}
 	if (str && len > 0 && !I.null) {
 		if (palloc (len + 1)) {
-			memcpy (I.context->buffer + I.context->buffer_len, str, len);
-			I.context->buffer_len += len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			memcpy (CONTEXT->buffer + CONTEXT->buffer_len, str, len);
+			CONTEXT->buffer_len += len;
+			CONTEXT->buffer[CONTEXT->buffer_len] = 0;
 		}
 	}
 	if (I.flush) {
@@ -1196,7 +1350,7 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 	}
 	if (I.break_word && str && len > 0) {
 		if (rz_mem_mem ((const ut8*)str, len, (const ut8*)I.break_word, I.break_word_len)) {
-			I.context->breaked = true;
+			CONTEXT->breaked = true;
 		}
 	}
 	return len;
@@ -1205,9 +1359,9 @@ RZ_API int rz_cons_memcat(const char *str, int len) {
 RZ_API void rz_cons_memset(char ch, int len) {
 	if (!I.null && len > 0) {
 		if (palloc (len + 1)) {
-			memset (I.context->buffer + I.context->buffer_len, ch, len);
-			I.context->buffer_len += len;
-			I.context->buffer[I.context->buffer_len] = 0;
+			memset (CONTEXT->buffer + CONTEXT->buffer_len, ch, len);
+			CONTEXT->buffer_len += len;
+			CONTEXT->buffer[CONTEXT->buffer_len] = 0;
 		}
 	}
 }
@@ -1248,11 +1402,11 @@ RZ_API int rz_cons_get_cursor(int *rows) {
 	int i, col = 0;
 	int row = 0;
 	// TODO: we need to handle GOTOXY and CLRSCR ansi escape code too
-	for (i = 0; i < I.context->buffer_len; i++) {
+	for (i = 0; i < CONTEXT->buffer_len; i++) {
 		// ignore ansi chars, copypasta from rz_str_ansi_len
-		if (I.context->buffer[i] == 0x1b) {
-			char ch2 = I.context->buffer[i + 1];
-			char *str = I.context->buffer;
+		if (CONTEXT->buffer[i] == 0x1b) {
+			char ch2 = CONTEXT->buffer[i + 1];
+			char *str = CONTEXT->buffer;
 			if (ch2 == '\\') {
 				i++;
 			} else if (ch2 == ']') {
@@ -1264,7 +1418,7 @@ RZ_API int rz_cons_get_cursor(int *rows) {
 					;
 				}
 			}
-		} else if (I.context->buffer[i] == '\n') {
+		} else if (CONTEXT->buffer[i] == '\n') {
 			row++;
 			col = 0;
 		} else {
@@ -1654,12 +1808,12 @@ RZ_API bool rz_cons_set_cup(bool enable) {
 }
 
 RZ_API void rz_cons_column(int c) {
-	char *b = malloc (I.context->buffer_len + 1);
+	char *b = malloc (CONTEXT->buffer_len + 1);
 	if (!b) {
 		return;
 	}
-	memcpy (b, I.context->buffer, I.context->buffer_len);
-	b[I.context->buffer_len] = 0;
+	memcpy (b, CONTEXT->buffer, CONTEXT->buffer_len);
+	b[CONTEXT->buffer_len] = 0;
 	rz_cons_reset ();
 	// align current buffer N chars right
 	rz_cons_strcat_justify (b, c, 0);
@@ -1671,12 +1825,12 @@ RZ_API void rz_cons_column(int c) {
 static bool lasti = false; /* last interactive mode */
 
 RZ_API void rz_cons_set_interactive(bool x) {
-	lasti = rz_cons_singleton ()->context->is_interactive;
-	rz_cons_singleton ()->context->is_interactive = x;
+	lasti = CONTEXT->is_interactive;
+	CONTEXT->is_interactive = x;
 }
 
 RZ_API void rz_cons_set_last_interactive(void) {
-	rz_cons_singleton ()->context->is_interactive = lasti;
+	CONTEXT->is_interactive = lasti;
 }
 
 RZ_API void rz_cons_set_title(const char *str) {
@@ -1718,13 +1872,13 @@ RZ_API void rz_cons_highlight(const char *word) {
 		rz_cons_enable_highlight (true);
 		return;
 	}
-	if (word && *word && I.context->buffer) {
+	if (word && *word && CONTEXT->buffer) {
 		int word_len = strlen (word);
 		char *orig;
-		clean = rz_str_ndup (I.context->buffer, I.context->buffer_len);
+		clean = rz_str_ndup (CONTEXT->buffer, CONTEXT->buffer_len);
 		l = rz_str_ansi_filter (clean, &orig, &cpos, -1);
-		free (I.context->buffer);
-		I.context->buffer = orig;
+		free (CONTEXT->buffer);
+		CONTEXT->buffer = orig;
 		if (I.highlight) {
 			if (strcmp (word, I.highlight)) {
 				free (I.highlight);
@@ -1742,25 +1896,25 @@ RZ_API void rz_cons_highlight(const char *word) {
 		strcpy (rword, inv[0]);
 		strcpy (rword + linv[0], word);
 		strcpy (rword + linv[0] + word_len, inv[1]);
-		res = rz_str_replace_thunked (I.context->buffer, clean, cpos,
+		res = rz_str_replace_thunked (CONTEXT->buffer, clean, cpos,
 					l, word, rword, 1);
 		if (res) {
-			I.context->buffer = res;
-			I.context->buffer_len = I.context->buffer_sz = strlen (res);
+			CONTEXT->buffer = res;
+			CONTEXT->buffer_len = CONTEXT->buffer_sz = strlen (res);
 		}
 		free (rword);
 		free (clean);
 		free (cpos);
 		/* don't free orig - it's assigned
-		 * to I.context->buffer and possibly realloc'd */
+		 * to CONTEXT->buffer and possibly realloc'd */
 	} else {
 		RZ_FREE (I.highlight);
 	}
 }
 
 RZ_API char *rz_cons_lastline(int *len) {
-	char *b = I.context->buffer + I.context->buffer_len;
-	while (b > I.context->buffer) {
+	char *b = CONTEXT->buffer + CONTEXT->buffer_len;
+	while (b > CONTEXT->buffer) {
 		if (*b == '\n') {
 			b++;
 			break;
@@ -1768,8 +1922,8 @@ RZ_API char *rz_cons_lastline(int *len) {
 		b--;
 	}
 	if (len) {
-		int delta = b - I.context->buffer;
-		*len = I.context->buffer_len - delta;
+		int delta = b - CONTEXT->buffer;
+		*len = CONTEXT->buffer_len - delta;
 	}
 	return b;
 }
@@ -1781,12 +1935,12 @@ RZ_API char *rz_cons_lastline_utf8_ansi_len(int *len) {
 		return rz_cons_lastline (0);
 	}
 
-	char *b = I.context->buffer + I.context->buffer_len;
+	char *b = CONTEXT->buffer + CONTEXT->buffer_len;
 	int l = 0;
 	int last_possible_ansi_end = 0;
 	char ch = '\0';
 	char ch2;
-	while (b > I.context->buffer) {
+	while (b > CONTEXT->buffer) {
 		ch2 = ch;
 		ch = *b;
 
@@ -1837,21 +1991,21 @@ RZ_API char *rz_cons_swap_ground(const char *col) {
 }
 
 RZ_API bool rz_cons_drop(int n) {
-	if (n > I.context->buffer_len) {
-		I.context->buffer_len = 0;
+	if (n > CONTEXT->buffer_len) {
+		CONTEXT->buffer_len = 0;
 		return false;
 	}
-	I.context->buffer_len -= n;
+	CONTEXT->buffer_len -= n;
 	return true;
 }
 
 RZ_API void rz_cons_chop(void) {
-	while (I.context->buffer_len > 0) {
-		char ch = I.context->buffer[I.context->buffer_len - 1];
+	while (CONTEXT->buffer_len > 0) {
+		char ch = CONTEXT->buffer[CONTEXT->buffer_len - 1];
 		if (ch != '\n' && !IS_WHITESPACE (ch)) {
 			break;
 		}
-		I.context->buffer_len--;
+		CONTEXT->buffer_len--;
 	}
 }
 
@@ -1900,11 +2054,10 @@ RZ_API void rz_cons_breakword(RZ_NULLABLE const char *s) {
  * {"command", "args", "description",
  * "command2", "args2", "description"}; */
 RZ_API void rz_cons_cmd_help(const char *help[], bool use_color) {
-	RzCons *cons = rz_cons_singleton ();
-	const char *pal_args_color = use_color ? cons->context->pal.args : "",
-		   *pal_help_color = use_color ? cons->context->pal.help : "",
-		   *pal_input_color = use_color ? cons->context->pal.input : "",
-		   *pal_reset = use_color ? cons->context->pal.reset : "";
+	const char *pal_args_color = use_color ? CONTEXT->pal.args : "",
+		   *pal_help_color = use_color ? CONTEXT->pal.help : "",
+		   *pal_input_color = use_color ? CONTEXT->pal.input : "",
+		   *pal_reset = use_color ? CONTEXT->pal.reset : "";
 	int i, max_length = 0;
 	const char *usage_str = "Usage:";
 
@@ -546,8 +546,8 @@ static void selection_widget_draw(void) {
 	}
 	sel_widget->w = RZ_MIN (sel_widget->w, RZ_SELWIDGET_MAXW);
 
-	char *background_color = cons->context->color_mode ? cons->context->pal.widget_bg : Color_INVERT_RESET;
-	char *selected_color = cons->context->color_mode ? cons->context->pal.widget_sel : Color_INVERT;
+	char *background_color = rz_cons_context ()->color_mode ? rz_cons_context ()->pal.widget_bg : Color_INVERT_RESET;
+	char *selected_color = rz_cons_context ()->color_mode ? rz_cons_context ()->pal.widget_sel : Color_INVERT;
 	bool scrollbar = sel_widget->options_len > RZ_SELWIDGET_MAXH;
 	int scrollbar_y = 0, scrollbar_l = 0;
 	if (scrollbar) {
@@ -1094,23 +1094,22 @@ static inline void vi_cmd_e(void) {
 }
 
 static void __update_prompt_color (void) {
-	RzCons *cons = rz_cons_singleton ();
 	const char *BEGIN = "", *END = "";
-	if (cons->context->color_mode) {
+	if (rz_cons_context ()->color_mode) {
 		if (I.prompt_mode) {
 			switch (I.vi_mode) {
 			case CONTROL_MODE:
-				BEGIN = cons->context->pal.invalid;
+				BEGIN = rz_cons_context ()->pal.invalid;
 				break;
 			case INSERT_MODE:
 			default:
-				BEGIN = cons->context->pal.prompt;
+				BEGIN = rz_cons_context ()->pal.prompt;
 				break;
 			}
 		} else {
-			BEGIN = cons->context->pal.prompt;
+			BEGIN = rz_cons_context ()->pal.prompt;
 		}
-		END = cons->context->pal.reset;
+		END = rz_cons_context ()->pal.reset;
 	}
 	char *prompt = rz_str_escape (I.prompt);		// remote the color
 	free (I.prompt);
@@ -350,7 +350,7 @@ RZ_API int rz_cons_arrow_to_hjkl(int ch) {
 RZ_API int rz_cons_fgets(char *buf, int len, int argc, const char **argv) {
 #define RETURN(x) { ret=x; goto beach; }
 	RzCons *cons = rz_cons_singleton ();
-	int ret = 0, color = cons->context->pal.input && *cons->context->pal.input;
+	int ret = 0, color = rz_cons_context ()->pal.input && *rz_cons_context ()->pal.input;
 	if (cons->echo) {
 		rz_cons_set_raw (false);
 		rz_cons_show_cursor (true);
@@ -368,7 +368,7 @@ RZ_API int rz_cons_fgets(char *buf, int len, int argc, const char **argv) {
 	fflush (stdout);
 	*buf = '\0';
 	if (color) {
-		const char *p = cons->context->pal.input;
+		const char *p = rz_cons_context ()->pal.input;
 		if (RZ_STR_ISNOTEMPTY (p)) {
 			fwrite (p, strlen (p), 1, stdout);
 			fflush (stdout);
@@ -2,8 +2,8 @@
 
 #include <rz_cons.h>
 
-#define RCOLOR_AT(i) (RzColor *) (((ut8 *) &(rz_cons_singleton ()->context->cpal)) + keys[i].coff)
-#define COLOR_AT(i) (char **) (((ut8 *) &(rz_cons_singleton ()->context->pal)) + keys[i].off)
+#define RCOLOR_AT(i) (RzColor *) (((ut8 *) &(rz_cons_context ()->cpal)) + keys[i].coff)
+#define COLOR_AT(i) (char **) (((ut8 *) &(rz_cons_context ()->pal)) + keys[i].off)
 
 static struct {
 	const char *name;
@@ -508,7 +508,7 @@ RZ_API void rz_cons_pal_show(void) {
 			colors[i].bgcode,
 			colors[i].name);
 	}
-	switch (rz_cons_singleton ()->context->color_mode) {
+	switch (rz_cons_context ()->color_mode) {
 	case COLOR_MODE_256: // 256 color palette
 		rz_cons_pal_show_gs ();
 		rz_cons_pal_show_256 ();
@@ -653,7 +653,7 @@ RZ_API int rz_cons_pal_len(void) {
 }
 
 RZ_API void rz_cons_pal_update_event(void) {
-	__cons_pal_update_event (rz_cons_singleton ()->context);
+	__cons_pal_update_event (rz_cons_context ());
 }
 
 RZ_API void rz_cons_rainbow_new(RzConsContext *ctx, int sz) {
@@ -674,16 +674,15 @@ RZ_API void rz_cons_rainbow_free(RzConsContext *ctx) {
 }
 
 RZ_API char *rz_cons_rainbow_get(int idx, int last, bool bg) {
-	RzCons *cons = rz_cons_singleton ();
 	if (last < 0) {
-		last = cons->context->pal.rainbow_sz;
+		last = rz_cons_context ()->pal.rainbow_sz;
 	}
-	if (idx < 0 || idx >= last || !cons->context->pal.rainbow) {
+	if (idx < 0 || idx >= last || !rz_cons_context ()->pal.rainbow) {
 		return NULL;
 	}
-	int x = (last == cons->context->pal.rainbow_sz)
-		? idx : (cons->context->pal.rainbow_sz * idx) / (last + 1);
-	const char *a = cons->context->pal.rainbow[x];
+	int x = (last == rz_cons_context ()->pal.rainbow_sz)
+		? idx : (rz_cons_context ()->pal.rainbow_sz * idx) / (last + 1);
+	const char *a = rz_cons_context ()->pal.rainbow[x];
 	if (bg) {
 		char *dup = rz_str_newf ("%s %s", a, a);
 		char *res = rz_cons_pal_parse (dup, NULL);
@@ -307,7 +307,7 @@ RZ_API char *rz_cons_rgb_str_mode(RzConsColorMode mode, char *outstr, size_t sz,
 
 /* Return the computed color string for the specified color */
 RZ_API char *rz_cons_rgb_str(char *outstr, size_t sz, RzColor *rcolor) {
-	return rz_cons_rgb_str_mode (rz_cons_singleton ()->context->color_mode, outstr, sz, rcolor);
+	return rz_cons_rgb_str_mode (rz_cons_context ()->color_mode, outstr, sz, rcolor);
 }
 
 RZ_API char *rz_cons_rgb_tostring(ut8 r, ut8 g, ut8 b) {
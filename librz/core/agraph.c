@@ -326,13 +326,12 @@ static void tiny_RzANode_print(const RzAGraph *g, const RzANode *n, int cur) {
 }
 
 static char *get_node_color (int color, int cur) {
-        RzCons *cons = rz_cons_singleton ();
         if (color == -1) {
-                return cur ? cons->context->pal.graph_box2 : cons->context->pal.graph_box;
+                return cur ? rz_cons_context ()->pal.graph_box2 : rz_cons_context ()->pal.graph_box;
         }
         return color ? (\
-                color==RZ_ANALYSIS_DIFF_TYPE_MATCH ? cons->context->pal.graph_diff_match:
-                color==RZ_ANALYSIS_DIFF_TYPE_UNMATCH? cons->context->pal.graph_diff_unmatch : cons->context->pal.graph_diff_new): cons->context->pal.graph_diff_unknown;
+                color==RZ_ANALYSIS_DIFF_TYPE_MATCH ? rz_cons_context ()->pal.graph_diff_match:
+                color==RZ_ANALYSIS_DIFF_TYPE_UNMATCH? rz_cons_context ()->pal.graph_diff_unmatch : rz_cons_context ()->pal.graph_diff_new): rz_cons_context ()->pal.graph_diff_unknown;
 }
 
 static void normal_RzANode_print(const RzAGraph *g, const RzANode *n, int cur) {
@@ -3645,12 +3644,11 @@ static void sdb_set_enc(Sdb *db, const char *key, const char *v, ut32 cas) {
 
 static void agraph_sdb_init(const RzAGraph *g) {
 	sdb_bool_set (g->db, "agraph.is_callgraph", g->is_callgraph, 0);
-	RzCons *cons = rz_cons_singleton ();
-	sdb_set_enc (g->db, "agraph.color_box", cons->context->pal.graph_box, 0);
-	sdb_set_enc (g->db, "agraph.color_box2", cons->context->pal.graph_box2, 0);
-	sdb_set_enc (g->db, "agraph.color_box3", cons->context->pal.graph_box3, 0);
-	sdb_set_enc (g->db, "agraph.color_true", cons->context->pal.graph_true, 0);
-	sdb_set_enc (g->db, "agraph.color_false", cons->context->pal.graph_false, 0);
+	sdb_set_enc (g->db, "agraph.color_box", rz_cons_context ()->pal.graph_box, 0);
+	sdb_set_enc (g->db, "agraph.color_box2", rz_cons_context ()->pal.graph_box2, 0);
+	sdb_set_enc (g->db, "agraph.color_box3", rz_cons_context ()->pal.graph_box3, 0);
+	sdb_set_enc (g->db, "agraph.color_true", rz_cons_context ()->pal.graph_true, 0);
+	sdb_set_enc (g->db, "agraph.color_false", rz_cons_context ()->pal.graph_false, 0);
 }
 
 RZ_API Sdb *rz_agraph_get_sdb(RzAGraph *g) {
@@ -0,0 +1,310 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_core.h>
+#include <rz_th.h>
+
+// Parallel op decoding ahead of aa (analysis.threads). Worker threads walk the
+// code reachable from every function entry point and decode it into a private
+// RzAnalysisOpTable, each working on its own copy of RzAnalysis (see
+// rz_analysis_thread_init). They never touch the io: the main thread copies
+// the code after each entry of the window beforehand, and the ops outside of
+// it are left to the analysis. The main thread then analyzes the entries in
+// the usual order with the table of the current entry installed, so every
+// change to RzAnalysis still happens serially and in the same order.
+
+#define PREFETCH_MASK (RZ_ANALYSIS_OP_MASK_ESIL | RZ_ANALYSIS_OP_MASK_VAL)
+#define PREFETCH_MAX_OPS 0x4000 // per entry
+#define PREFETCH_ENTRY_BYTES 0x10000 // copied after each entry of the window
+#define PREFETCH_OP_BYTES 32
+
+typedef struct {
+	ut64 addr;
+	ut8 *buf; // code at addr, only while the entry is in the window
+	ut64 size;
+	RzAnalysisOpTable *table;
+	bool done;
+} PrefetchEntry;
+
+typedef struct {
+	RzCoreAnalysisPrefetch *pf;
+	RzAnalysis analysis; // what the plugin gets in this worker
+	const PrefetchEntry *entry; // being decoded
+	bool read_miss; // the plugin read outside of the code of entry
+} PrefetchWorker;
+
+struct rz_core_analysis_prefetch_t {
+	RzAnalysis *analysis;
+	RzIO *io;
+	PrefetchEntry *entries;
+	size_t count;
+	size_t next; // next entry to decode
+	size_t cur; // entry being analyzed
+	size_t loaded; // entries before this one have their code
+	size_t window; // how many entries can be decoded ahead of cur
+	bool stop;
+	RzThreadLock *lock;
+	RzThreadCond *cond;
+	RzThread **threads;
+	PrefetchWorker *workers;
+	int nworkers;
+	int nthreads;
+};
+
+static const ut8 *entry_code_at(const PrefetchEntry *e, ut64 addr, int *len) {
+	if (addr < e->addr || addr - e->addr >= e->size) {
+		return NULL;
+	}
+	*len = (int)RZ_MIN (e->size - (addr - e->addr), PREFETCH_OP_BYTES);
+	return e->buf + (addr - e->addr);
+}
+
+// read_at of the worker copies, e.g. for the x86 call thunks. It only sees
+// the code of the entry: a read outside of it flags the op, which is then
+// left to the main thread to decode with the real io.
+static bool worker_read_at(RzAnalysis *analysis, ut64 addr, ut8 *buf, int len) {
+	PrefetchWorker *w = container_of (analysis, PrefetchWorker, analysis);
+	const PrefetchEntry *e = w->entry;
+	if (len >= 0 && addr >= e->addr && addr - e->addr < e->size && (ut64)len <= e->size - (addr - e->addr)) {
+		memcpy (buf, e->buf + (addr - e->addr), len);
+		return true;
+	}
+	w->read_miss = true;
+	return false;
+}
+
+// Copies the code of the entries that came into the window, up to the end of
+// the map they are in. Only the main thread calls this, without the lock.
+static void entries_load(RzCoreAnalysisPrefetch *pf) {
+	size_t end = RZ_MIN (pf->cur + pf->window, pf->count);
+	size_t i;
+	for (i = pf->loaded; i < end; i++) {
+		PrefetchEntry *e = &pf->entries[i];
+		RzIOMap *map = rz_io_map_get (pf->io, e->addr);
+		if (!map || !(map->perm & (RZ_PERM_R | RZ_PERM_X))) {
+			continue;
+		}
+		ut64 size = RZ_MIN (rz_itv_end (map->itv) - e->addr, PREFETCH_ENTRY_BYTES);
+		if (!size || !(e->buf = malloc (size))) {
+			continue;
+		}
+		rz_io_read_at (pf->io, e->addr, e->buf, (int)size);
+		e->size = size;
+	}
+	if (end > pf->loaded) {
+		rz_th_lock_enter (pf->lock);
+		pf->loaded = end;
+		rz_th_cond_signal_all (pf->cond);
+		rz_th_lock_leave (pf->lock);
+	}
+}
+
+static RzAnalysisOpTable *decode_entry(PrefetchWorker *w, const PrefetchEntry *e) {
+	RzCoreAnalysisPrefetch *pf = w->pf;
+	RzAnalysis *analysis = &w->analysis;
+	ut64 entry = e->addr;
+	w->entry = e;
+	RzAnalysisOpTable *t = rz_analysis_op_table_new (analysis, PREFETCH_MASK);
+	if (!t) {
+		return NULL;
+	}
+	RzVector todo;
+	rz_vector_init (&todo, sizeof (ut64), NULL, NULL);
+	rz_vector_push (&todo, &entry);
+	size_t n = 0;
+	while (n < PREFETCH_MAX_OPS && !pf->stop && !rz_vector_empty (&todo)) {
+		ut64 addr;
+		rz_vector_pop (&todo, &addr);
+		while (n < PREFETCH_MAX_OPS && !rz_analysis_op_table_has (t, addr)) {
+			int len = 0;
+			const ut8 *buf = entry_code_at (e, addr, &len);
+			if (!buf) {
+				break;
+			}
+			RzAnalysisOp op;
+			w->read_miss = false;
+			int ret = rz_analysis_op_decode (analysis, &op, addr, buf, len, PREFETCH_MASK);
+			ut32 type = op.type & RZ_ANALYSIS_OP_TYPE_MASK;
+			ut64 jump = op.jump;
+			int size = op.size;
+			if (w->read_miss || !rz_analysis_op_table_add (t, &op, buf, ret)) {
+				rz_analysis_op_fini (&op);
+				break;
+			}
+			n++;
+			bool end = false;
+			switch (type) {
+			case RZ_ANALYSIS_OP_TYPE_CJMP:
+			case RZ_ANALYSIS_OP_TYPE_CALL:
+			case RZ_ANALYSIS_OP_TYPE_CCALL:
+				if (jump != UT64_MAX) {
+					rz_vector_push (&todo, &jump);
+				}
+				break;
+			case RZ_ANALYSIS_OP_TYPE_JMP:
+				if (jump == UT64_MAX) {
+					end = true;
+				} else {
+					addr = jump;
+					continue;
+				}
+				break;
+			case RZ_ANALYSIS_OP_TYPE_RET:
+			case RZ_ANALYSIS_OP_TYPE_ILL:
+			case RZ_ANALYSIS_OP_TYPE_TRAP:
+			case RZ_ANALYSIS_OP_TYPE_UJMP:
+			case RZ_ANALYSIS_OP_TYPE_RJMP:
+			case RZ_ANALYSIS_OP_TYPE_IJMP:
+			case RZ_ANALYSIS_OP_TYPE_IRJMP:
+			case RZ_ANALYSIS_OP_TYPE_MJMP:
+				end = true;
+				break;
+			}
+			if (end) {
+				break;
+			}
+			addr += size;
+		}
+	}
+	rz_vector_fini (&todo);
+	w->entry = NULL;
+	return t;
+}
+
+static RzThreadFunctionRet prefetch_worker(RzThread *th) {
+	PrefetchWorker *w = th->user;
+	RzCoreAnalysisPrefetch *pf = w->pf;
+	rz_th_lock_enter (pf->lock);
+	for (;;) {
+		while (!pf->stop && pf->next < pf->count && pf->next >= pf->loaded) {
+			rz_th_cond_wait (pf->cond, pf->lock);
+		}
+		if (pf->stop || pf->next >= pf->count) {
+			break;
+		}
+		size_t idx = pf->next++;
+		rz_th_lock_leave (pf->lock);
+		RzAnalysisOpTable *t = decode_entry (w, &pf->entries[idx]);
+		rz_th_lock_enter (pf->lock);
+		pf->entries[idx].table = t;
+		pf->entries[idx].done = true;
+		rz_th_cond_signal_all (pf->cond);
+	}
+	rz_th_lock_leave (pf->lock);
+	return RZ_TH_STOP;
+}
+
+// Starts decoding the code of addrs ahead of their analysis with the given
+// number of threads. Returns NULL when there is nothing to gain, e.g. with a
+// single thread or an analysis plugin that is not reentrant.
+RZ_API RzCoreAnalysisPrefetch *rz_core_analysis_prefetch_new(RzCore *core, const ut64 *addrs, size_t count, int threads) {
+	rz_return_val_if_fail (core && (addrs || !count), NULL);
+	RzAnalysis *analysis = core->analysis;
+	if (threads < 2 || !count || !core->io->va || !analysis->cur || !analysis->cur->op || !analysis->cur->reentrant) {
+		return NULL;
+	}
+	threads = RZ_MIN (threads, 64);
+	RzCoreAnalysisPrefetch *pf = RZ_NEW0 (RzCoreAnalysisPrefetch);
+	if (!pf) {
+		return NULL;
+	}
+	pf->analysis = analysis;
+	pf->io = core->io;
+	pf->entries = RZ_NEWS0 (PrefetchEntry, count);
+	pf->threads = RZ_NEWS0 (RzThread *, threads);
+	pf->workers = RZ_NEWS0 (PrefetchWorker, threads);
+	pf->lock = rz_th_lock_new (false);
+	pf->cond = rz_th_cond_new ();
+	if (!pf->entries || !pf->threads || !pf->workers || !pf->lock || !pf->cond) {
+		goto fail;
+	}
+	size_t i;
+	for (i = 0; i < threads; i++) {
+		pf->workers[i].pf = pf;
+		if (!rz_analysis_thread_init (&pf->workers[i].analysis, analysis)) {
+			rz_analysis_thread_fini (&pf->workers[i].analysis);
+			break;
+		}
+		pf->workers[i].analysis.read_at = worker_read_at;
+		pf->nworkers++;
+	}
+	for (i = 0; i < count; i++) {
+		pf->entries[i].addr = addrs[i];
+	}
+	pf->count = count;
+	pf->window = threads * 4;
+	entries_load (pf);
+	for (i = 0; i < pf->nworkers; i++) {
+		pf->threads[i] = rz_th_new (prefetch_worker, &pf->workers[i], 0);
+		if (!pf->threads[i]) {
+			break;
+		}
+		pf->nthreads++;
+	}
+	if (!pf->nthreads) {
+		goto fail;
+	}
+	return pf;
+fail:
+	rz_core_analysis_prefetch_free (pf);
+	return NULL;
+}
+
+// Installs the ops decoded for the idx-th address as analysis->op_table,
+// waiting for them if needed. Entries are expected in increasing order.
+RZ_API void rz_core_analysis_prefetch_use(RzCoreAnalysisPrefetch *pf, size_t idx) {
+	if (!pf || idx >= pf->count) {
+		return;
+	}
+	pf->analysis->op_table = NULL;
+	rz_th_lock_enter (pf->lock);
+	while (pf->cur < idx) {
+		while (!pf->entries[pf->cur].done) {
+			rz_th_cond_wait (pf->cond, pf->lock);
+		}
+		rz_analysis_op_table_free (pf->entries[pf->cur].table);
+		pf->entries[pf->cur].table = NULL;
+		RZ_FREE (pf->entries[pf->cur].buf);
+		pf->cur++;
+		// the window moved, copy the code of the new slot for the workers
+		rz_th_lock_leave (pf->lock);
+		entries_load (pf);
+		rz_th_lock_enter (pf->lock);
+	}
+	while (!pf->entries[idx].done) {
+		rz_th_cond_wait (pf->cond, pf->lock);
+	}
+	pf->analysis->op_table = pf->entries[idx].table;
+	rz_th_lock_leave (pf->lock);
+}
+
+RZ_API void rz_core_analysis_prefetch_free(RzCoreAnalysisPrefetch *pf) {
+	if (!pf) {
+		return;
+	}
+	pf->analysis->op_table = NULL;
+	int i;
+	if (pf->lock && pf->cond) {
+		rz_th_lock_enter (pf->lock);
+		pf->stop = true;
+		rz_th_cond_signal_all (pf->cond);
+		rz_th_lock_leave (pf->lock);
+	}
+	for (i = 0; i < pf->nthreads; i++) {
+		rz_th_wait (pf->threads[i]);
+		rz_th_free (pf->threads[i]);
+	}
+	size_t j;
+	for (j = 0; pf->entries && j < pf->count; j++) {
+		rz_analysis_op_table_free (pf->entries[j].table);
+		free (pf->entries[j].buf);
+	}
+	for (i = 0; i < pf->nworkers; i++) {
+		rz_analysis_thread_fini (&pf->workers[i].analysis);
+	}
+	rz_th_lock_free (pf->lock);
+	rz_th_cond_free (pf->cond);
+	free (pf->workers);
+	free (pf->threads);
+	free (pf->entries);
+	free (pf);
+}
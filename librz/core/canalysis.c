@@ -7,6 +7,7 @@
 #include <rz_bin.h>
 #include <ht_uu.h>
 #include <rz_util/rz_graph_drawable.h>
+#include <rz_th.h>
 
 #include <string.h>
 
@@ -93,6 +94,7 @@ static int cmpaddr (const void *_a, const void *_b) {
 static char *getFunctionName(RzCore *core, ut64 addr) {
 	RzBinFile *bf = rz_bin_cur (core->bin);
 	if (bf && bf->o) {
+		// with bin.lazy the methods are known once the classes are loaded
 		Sdb *kv = bf->o->addrzklassmethod;
 		char *at = sdb_fmt ("0x%08"PFMT64x, addr);
 		char *res = sdb_get (kv, at, 0);
@@ -2321,7 +2323,8 @@ RZ_API RzGraph *rz_core_analysis_importxrefs(RzCore *core) {
 	if (!graph) {
 		return NULL;
 	}
-	rz_list_foreach (obj->imports, iter, imp) {
+	RzList *imports = rz_bin_get_imports (core->bin);
+	rz_list_foreach (imports, iter, imp) {
 		ut64 addr = lit ? rz_core_bin_impaddr (core->bin, va, imp->name): 0;
 		if (addr) {
 			add_single_addr_xrefs (core, addr, graph);
@@ -3983,13 +3986,210 @@ static bool found_xref(RzCore *core, ut64 at, ut64 xref_to, RzAnalysisRefType ty
 	return true;
 }
 
+// aar scans the range in fixed chunks, so the result does not depend on the
+// number of threads. Decoding starts XREFS_OVERLAP bytes before a chunk to get
+// back in sync with the instruction stream, but only the ops starting inside
+// the chunk are collected. Workers only decode and collect the candidate refs,
+// found_xref () runs on the main thread in chunk order.
+#define XREFS_CHUNK 0x10000
+#define XREFS_OVERLAP 64
+#define XREFS_TAIL 32 // bytes read past the chunk for its last op
+#define XREFS_PAD_MIN 64 // runs of 0x00 or 0xff skipped without decoding
+#define XREFS_BATCH 64 // ops decoded per rz_analysis_op_lite_batch () call
+
+typedef struct {
+	ut64 at;
+	ut64 to;
+	RzAnalysisRefType type;
+} XrefsHit;
+
+typedef struct {
+	ut64 addr;
+	int size;
+	int pre; // overlap bytes before addr in buf
+	int len;
+	ut8 *buf;
+	RzVector hits; // XrefsHit
+} XrefsChunk;
+
+typedef struct xrefs_worker_t XrefsWorker;
+
+typedef struct {
+	RzAnalysis *analysis;
+	bool serial; // decode with rz_analysis_op_lite (), one op at a time
+	st64 varmin;
+	XrefsChunk *chunks;
+	int count;
+	int next;
+	RzThreadLock *lock;
+	XrefsWorker *workers;
+	int nworkers;
+} XrefsJob;
+
+struct xrefs_worker_t {
+	XrefsJob *job;
+	RzAnalysis analysis; // copy with its own decoder state
+};
+
+// length of the run of buf[0] bytes, compared a word at a time
+static int uniform_run(const ut8 *buf, int len) {
+	const ut64 pattern = 0x0101010101010101ULL * buf[0];
+	int i = 0;
+	while (i + 8 <= len) {
+		ut64 w;
+		memcpy (&w, buf + i, sizeof (w));
+		if (w != pattern) {
+			break;
+		}
+		i += 8;
+	}
+	while (i < len && buf[i] == buf[0]) {
+		i++;
+	}
+	return i;
+}
+
+static void xrefs_hit(XrefsChunk *c, ut64 at, ut64 to, RzAnalysisRefType type) {
+	XrefsHit h = { at, to, type };
+	rz_vector_push (&c->hits, &h);
+}
+
+static void xrefs_collect(XrefsChunk *c, RzAnalysisOpLite *op, st64 varmin) {
+	if ((st64)op->val > varmin && op->val != UT64_MAX && op->val != UT32_MAX) {
+		xrefs_hit (c, op->addr, op->val, RZ_ANALYSIS_REF_TYPE_DATA);
+	}
+	if (op->ptr && op->ptr != UT64_MAX && op->ptr != UT32_MAX) {
+		xrefs_hit (c, op->addr, op->ptr, RZ_ANALYSIS_REF_TYPE_DATA);
+	}
+	if (op->addr > 512 && op->disp > 512 && op->disp && op->disp != UT64_MAX) {
+		xrefs_hit (c, op->addr, op->disp, RZ_ANALYSIS_REF_TYPE_DATA);
+	}
+	switch (op->type) {
+	case RZ_ANALYSIS_OP_TYPE_JMP:
+	case RZ_ANALYSIS_OP_TYPE_CJMP:
+		xrefs_hit (c, op->addr, op->jump, RZ_ANALYSIS_REF_TYPE_CODE);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_CALL:
+	case RZ_ANALYSIS_OP_TYPE_CCALL:
+		xrefs_hit (c, op->addr, op->jump, RZ_ANALYSIS_REF_TYPE_CALL);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_UJMP:
+	case RZ_ANALYSIS_OP_TYPE_IJMP:
+	case RZ_ANALYSIS_OP_TYPE_RJMP:
+	case RZ_ANALYSIS_OP_TYPE_IRJMP:
+	case RZ_ANALYSIS_OP_TYPE_MJMP:
+	case RZ_ANALYSIS_OP_TYPE_UCJMP:
+		xrefs_hit (c, op->addr, op->ptr, RZ_ANALYSIS_REF_TYPE_CODE);
+		break;
+	case RZ_ANALYSIS_OP_TYPE_UCALL:
+	case RZ_ANALYSIS_OP_TYPE_ICALL:
+	case RZ_ANALYSIS_OP_TYPE_RCALL:
+	case RZ_ANALYSIS_OP_TYPE_IRCALL:
+	case RZ_ANALYSIS_OP_TYPE_UCCALL:
+		xrefs_hit (c, op->addr, op->ptr, RZ_ANALYSIS_REF_TYPE_CALL);
+		break;
+	default:
+		break;
+	}
+}
+
+// offset of the run of padding at buf[i] worth skipping, or 0
+static int xrefs_pad(XrefsChunk *c, int i, int end) {
+	if (c->buf[i] == 0x00 || c->buf[i] == 0xff) {
+		int run = uniform_run (c->buf + i, end - i);
+		if (run >= XREFS_PAD_MIN) {
+			return run;
+		}
+	}
+	return 0;
+}
+
+static void xrefs_scan(XrefsJob *job, RzAnalysis *analysis, XrefsChunk *c) {
+	const ut64 base = c->addr - c->pre;
+	const int end = c->pre + c->size;
+	RzAnalysisOpLite ops[XREFS_BATCH];
+	int i = 0;
+	while (i < end) {
+		int pad = xrefs_pad (c, i, end);
+		if (pad) {
+			i += pad;
+			continue;
+		}
+		if (job->serial) {
+			int ret = rz_analysis_op_lite (analysis, &ops[0], base + i, c->buf + i, c->len - i);
+			if (i >= c->pre) {
+				xrefs_collect (c, &ops[0], job->varmin);
+			}
+			i += ret > 0 ? ret : 1;
+			continue;
+		}
+		// same as rz_analysis_op_lite () without archbits, there are no arch or bits hints
+		int used, k;
+		int n = rz_analysis_op_lite_batch (analysis, ops, XREFS_BATCH, base + i, c->buf + i, c->len - i, &used);
+		if (n < 1) {
+			break;
+		}
+		for (k = 0; k < n; k++) {
+			int at = (int)(ops[k].addr - base);
+			if (at >= end || (k && xrefs_pad (c, at, end))) {
+				// the rest of the batch is past the chunk or in padding
+				used = at - i;
+				break;
+			}
+			if (at >= c->pre) {
+				xrefs_collect (c, &ops[k], job->varmin);
+			}
+		}
+		i += used;
+	}
+}
+
+static RzThreadFunctionRet xrefs_worker(RzThread *th) {
+	XrefsWorker *w = th->user;
+	XrefsJob *job = w->job;
+	for (;;) {
+		rz_th_lock_enter (job->lock);
+		int idx = job->next++;
+		rz_th_lock_leave (job->lock);
+		if (idx >= job->count) {
+			break;
+		}
+		xrefs_scan (job, &w->analysis, &job->chunks[idx]);
+	}
+	return RZ_TH_STOP;
+}
+
+static void xrefs_run(XrefsJob *job) {
+	RzThread *th[64];
+	int i, n = 0;
+	job->next = 0;
+	if (!job->serial && job->lock) {
+		int threads = RZ_MIN (job->nworkers, job->count);
+		for (i = 0; i < threads; i++) {
+			th[n] = rz_th_new (xrefs_worker, &job->workers[i], 0);
+			if (th[n]) {
+				n++;
+			}
+		}
+	}
+	if (!n) {
+		for (i = 0; i < job->count; i++) {
+			xrefs_scan (job, job->analysis, &job->chunks[i]);
+		}
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		rz_th_wait (th[i]);
+		rz_th_free (th[i]);
+	}
+}
+
 RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, int rad) {
 	int cfg_debug = rz_config_get_i (core->config, "cfg.debug");
 	bool cfg_analysis_strings = rz_config_get_i (core->config, "analysis.strings");
-	ut64 at;
-	int count = 0;
-	const int bsz = 8096;
-	RzAnalysisOp op = { 0 };
+	int threads = rz_config_get_i (core->config, "analysis.threads");
+	RzAnalysis *analysis = core->analysis;
+	int i, count = 0;
 
 	if (from == to) {
 		return -1;
@@ -4004,106 +4204,85 @@ RZ_API int rz_core_analysis_search_xrefs(RzCore *core, ut64 from, ut64 to, int r
 		eprintf ("Error: block size too small\n");
 		return -1;
 	}
-	ut8 *buf = malloc (bsz);
-	if (!buf) {
+	// the workers decode on copies of RzAnalysis and skip archbits, so they
+	// are only used when nothing can switch the arch or bits on the way
+	XrefsJob job = { 0 };
+	job.analysis = analysis;
+	job.serial = threads < 2 || !analysis->cur || !analysis->cur->op || !analysis->cur->reentrant
+		|| analysis->arch_hints || analysis->bits_hints;
+	job.varmin = rz_config_get_i (core->config, "asm.sub.varmin");
+	if (job.serial) {
+		threads = 1;
+	} else {
+		threads = RZ_MIN (threads, 64);
+		job.workers = RZ_NEWS0 (XrefsWorker, threads);
+		for (i = 0; job.workers && i < threads; i++) {
+			job.workers[i].job = &job;
+			if (!rz_analysis_thread_init (&job.workers[i].analysis, analysis)) {
+				rz_analysis_thread_fini (&job.workers[i].analysis);
+				break;
+			}
+			job.nworkers++;
+		}
+	}
+	const int batch = RZ_MIN (threads, 64) * 4;
+	job.chunks = RZ_NEWS0 (XrefsChunk, batch);
+	if (!job.chunks) {
 		eprintf ("Error: cannot allocate a block\n");
 		return -1;
 	}
-	ut8 *block = malloc (bsz);
-	if (!block) {
-		eprintf ("Error: cannot allocate a temp block\n");
-		free (buf);
-		return -1;
+	for (i = 0; i < batch; i++) {
+		rz_vector_init (&job.chunks[i].hits, sizeof (XrefsHit), NULL, NULL);
+	}
+	if (!job.serial) {
+		job.lock = rz_th_lock_new (false);
 	}
 	rz_cons_break_push (NULL, NULL);
-	at = from;
-	st64 asm_sub_varmin = rz_config_get_i (core->config, "asm.sub.varmin");
-	while (at < to && !rz_cons_is_breaked ()) {
-		int i = 0, ret = bsz;
-		if (!rz_io_is_valid_offset (core->io, at, RZ_PERM_X)) {
-			break;
-		}
-		(void)rz_io_read_at (core->io, at, buf, bsz);
-		memset (block, -1, bsz);
-		if (!memcmp (buf, block, bsz)) {
-		//	eprintf ("Error: skipping uninitialized block \n");
-			at += ret;
-			continue;
-		}
-		memset (block, 0, bsz);
-		if (!memcmp (buf, block, bsz)) {
-		//	eprintf ("Error: skipping uninitialized block \n");
-			at += ret;
-			continue;
-		}
-		while (i < bsz && !rz_cons_is_breaked ()) {
-			ret = rz_analysis_op (core->analysis, &op, at + i, buf + i, bsz - i, RZ_ANALYSIS_OP_MASK_BASIC | RZ_ANALYSIS_OP_MASK_HINT);
-			ret = ret > 0 ? ret : 1;
-			i += ret;
-			if (ret <= 0 || i > bsz) {
+	ut64 at = from;
+	bool done = false;
+	while (!done && at < to && !rz_cons_is_breaked ()) {
+		for (job.count = 0; job.count < batch && at < to; job.count++) {
+			if (!rz_io_is_valid_offset (core->io, at, RZ_PERM_X)) {
+				done = true;
 				break;
 			}
-			// find references
-			if ((st64)op.val > asm_sub_varmin && op.val != UT64_MAX && op.val != UT32_MAX) {
-				if (found_xref (core, op.addr, op.val, RZ_ANALYSIS_REF_TYPE_DATA, count, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-			}
-			// find references
-			if (op.ptr && op.ptr != UT64_MAX && op.ptr != UT32_MAX) {
-				if (found_xref (core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_DATA, count, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-			}
-			// find references
-			if (op.addr > 512 && op.disp > 512 && op.disp && op.disp != UT64_MAX) {
-				if (found_xref (core, op.addr, op.disp, RZ_ANALYSIS_REF_TYPE_DATA, count, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
+			XrefsChunk *c = &job.chunks[job.count];
+			c->addr = at;
+			c->size = (int)RZ_MIN (to - at, XREFS_CHUNK);
+			c->pre = (int)RZ_MIN (at - from, XREFS_OVERLAP);
+			c->len = c->pre + c->size + XREFS_TAIL;
+			if (!c->buf) {
+				c->buf = malloc (XREFS_OVERLAP + XREFS_CHUNK + XREFS_TAIL);
+				if (!c->buf) {
+					done = true;
+					break;
 				}
 			}
-			switch (op.type) {
-			case RZ_ANALYSIS_OP_TYPE_JMP:
-			case RZ_ANALYSIS_OP_TYPE_CJMP:
-				if (found_xref (core, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CODE, count, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_CALL:
-			case RZ_ANALYSIS_OP_TYPE_CCALL:
-				if (found_xref (core, op.addr, op.jump, RZ_ANALYSIS_REF_TYPE_CALL, count, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UJMP:
-			case RZ_ANALYSIS_OP_TYPE_IJMP:
-			case RZ_ANALYSIS_OP_TYPE_RJMP:
-			case RZ_ANALYSIS_OP_TYPE_IRJMP:
-			case RZ_ANALYSIS_OP_TYPE_MJMP:
-			case RZ_ANALYSIS_OP_TYPE_UCJMP:
-				if (found_xref (core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CODE, count++, rad, cfg_debug, cfg_analysis_strings)) {
-					count++;
-				}
-				break;
-			case RZ_ANALYSIS_OP_TYPE_UCALL:
-			case RZ_ANALYSIS_OP_TYPE_ICALL:
-			case RZ_ANALYSIS_OP_TYPE_RCALL:
-			case RZ_ANALYSIS_OP_TYPE_IRCALL:
-			case RZ_ANALYSIS_OP_TYPE_UCCALL:
-				if (found_xref (core, op.addr, op.ptr, RZ_ANALYSIS_REF_TYPE_CALL, count, rad, cfg_debug, cfg_analysis_strings)) {
+			(void)rz_io_read_at (core->io, at - c->pre, c->buf, c->len);
+			at += c->size;
+		}
+		xrefs_run (&job);
+		for (i = 0; i < job.count; i++) {
+			XrefsHit *h;
+			rz_vector_foreach (&job.chunks[i].hits, h) {
+				if (found_xref (core, h->at, h->to, h->type, count, rad, cfg_debug, cfg_analysis_strings)) {
 					count++;
 				}
-				break;
-			default:
-				break;
 			}
-			rz_analysis_op_fini (&op);
+			rz_vector_clear (&job.chunks[i].hits);
 		}
-		at += bsz;
-		rz_analysis_op_fini (&op);
 	}
 	rz_cons_break_pop ();
-	free (buf);
-	free (block);
+	for (i = 0; i < batch; i++) {
+		rz_vector_fini (&job.chunks[i].hits);
+		free (job.chunks[i].buf);
+	}
+	free (job.chunks);
+	for (i = 0; i < job.nworkers; i++) {
+		rz_analysis_thread_fini (&job.workers[i].analysis);
+	}
+	free (job.workers);
+	rz_th_lock_free (job.lock);
 	return count;
 }
 
@@ -4142,26 +4321,20 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 	RzBinSymbol *symbol;
 	int depth = core->analysis->opt.depth;
 	bool analysis_vars = rz_config_get_i (core->config, "analysis.vars");
+	int threads = rz_config_get_i (core->config, "analysis.threads");
 
-	/* Analyze Functions */
-	/* Entries */
+	/* Collect the starting points first, so their code can be decoded ahead
+	 * of time when analysis.threads > 1. Analysis itself stays serial. */
+	RzVector addrs;
+	rz_vector_init (&addrs, sizeof (ut64), NULL, NULL);
 	item = rz_flag_get (core->flags, "entry0");
 	if (item) {
-		rz_core_analysis_fcn (core, item->offset, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
-		rz_core_cmdf (core, "afn entry0 0x%08"PFMT64x, item->offset);
-	} else {
-		rz_core_cmd0 (core, "af");
+		rz_vector_push (&addrs, &item->offset);
 	}
-
-	rz_core_task_yield (&core->tasks);
-
-	rz_cons_break_push (NULL, NULL);
 	/* Symbols (Imports are already analyzed by rz_bin on init) */
+	size_t syms_from = rz_vector_len (&addrs);
 	if ((list = rz_bin_get_symbols (core->bin)) != NULL) {
 		rz_list_foreach (list, iter, symbol) {
-			if (rz_cons_is_breaked ()) {
-				break;
-			}
 			// Stop analyzing PE imports further
 			if (isSkippable (symbol)) {
 				continue;
@@ -4169,28 +4342,64 @@ RZ_API int rz_core_analysis_all(RzCore *core) {
 			if (isValidSymbol (symbol)) {
 				ut64 addr = rz_bin_get_vaddr (core->bin, symbol->paddr,
 					symbol->vaddr);
-				rz_core_analysis_fcn (core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+				rz_vector_push (&addrs, &addr);
 			}
 		}
 	}
-	rz_core_task_yield (&core->tasks);
+	size_t syms_to = rz_vector_len (&addrs);
 	/* Main */
 	if ((binmain = rz_bin_get_sym (core->bin, RZ_BIN_SYM_MAIN))) {
 		if (binmain->paddr != UT64_MAX) {
 			ut64 addr = rz_bin_get_vaddr (core->bin, binmain->paddr, binmain->vaddr);
-			rz_core_analysis_fcn (core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+			rz_vector_push (&addrs, &addr);
 		}
 	}
-	rz_core_task_yield (&core->tasks);
+	size_t main_to = rz_vector_len (&addrs);
 	if ((list = rz_bin_get_entries (core->bin))) {
 		rz_list_foreach (list, iter, entry) {
 			if (entry->paddr == UT64_MAX) {
 				continue;
 			}
 			ut64 addr = rz_bin_get_vaddr (core->bin, entry->paddr, entry->vaddr);
-			rz_core_analysis_fcn (core, addr, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+			rz_vector_push (&addrs, &addr);
 		}
 	}
+	size_t i, count = rz_vector_len (&addrs);
+	ut64 *at = count ? rz_vector_index_ptr (&addrs, 0) : NULL;
+	RzCoreAnalysisPrefetch *pf = rz_core_analysis_prefetch_new (core, at, count, threads);
+
+	/* Analyze Functions */
+	/* Entries */
+	if (item) {
+		rz_core_analysis_prefetch_use (pf, 0);
+		rz_core_analysis_fcn (core, item->offset, -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+		rz_core_cmdf (core, "afn entry0 0x%08"PFMT64x, item->offset);
+	} else {
+		rz_core_cmd0 (core, "af");
+	}
+
+	rz_core_task_yield (&core->tasks);
+
+	rz_cons_break_push (NULL, NULL);
+	for (i = syms_from; i < syms_to; i++) {
+		if (rz_cons_is_breaked ()) {
+			break;
+		}
+		rz_core_analysis_prefetch_use (pf, i);
+		rz_core_analysis_fcn (core, at[i], -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+	}
+	rz_core_task_yield (&core->tasks);
+	for (i = syms_to; i < main_to; i++) {
+		rz_core_analysis_prefetch_use (pf, i);
+		rz_core_analysis_fcn (core, at[i], -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+	}
+	rz_core_task_yield (&core->tasks);
+	for (i = main_to; i < count; i++) {
+		rz_core_analysis_prefetch_use (pf, i);
+		rz_core_analysis_fcn (core, at[i], -1, RZ_ANALYSIS_REF_TYPE_NULL, depth - 1);
+	}
+	rz_core_analysis_prefetch_free (pf);
+	rz_vector_fini (&addrs);
 	rz_core_task_yield (&core->tasks);
 	if (analysis_vars) {
 		/* Set fcn type to RZ_ANALYSIS_FCN_TYPE_SYM for symbols */
@@ -4226,7 +4435,7 @@ RZ_API int rz_core_analysis_data(RzCore *core, ut64 addr, int count, int depth,
 	rz_io_read_at (core->io, addr, buf, len);
 	buf[len - 1] = 0;
 
-	RzConsPrintablePalette *pal = rz_config_get_i (core->config, "scr.color")? &rz_cons_singleton ()->context->pal: NULL;
+	RzConsPrintablePalette *pal = rz_config_get_i (core->config, "scr.color")? &rz_cons_context ()->pal: NULL;
 	for (i = j = 0; j < count; j++) {
 		if (i >= len) {
 			rz_io_read_at (core->io, addr + i, buf, len);
@@ -92,10 +92,10 @@ RZ_API void rz_core_annotated_code_print_json(RzAnnotatedCode *code) {
 	pj_free (pj);
 }
 
-#define PALETTE(x) (cons && cons->context->pal.x) ? cons->context->pal.x
+#define PALETTE(x) (cons && rz_cons_context ()->pal.x) ? rz_cons_context ()->pal.x
 #define PRINT_COLOR(x)                             \
 	do {                                       \
-		if (cons->context->color_mode) {   \
+		if (rz_cons_context ()->color_mode) { \
 			rz_cons_printf ("%s", (x)); \
 		}                                  \
 	} while (0)
@@ -342,7 +342,14 @@ RZ_API int rz_core_bin_set_env(RzCore *r, RzBinFile *binfile) {
 			rz_config_set (r->config, "analysis.cpu", arch);
 		}
 		rz_asm_use (r->rasm, arch);
-		rz_core_bin_info (r, RZ_CORE_BIN_ACC_ALL, RZ_MODE_SET, va, NULL, NULL);
+		int action = RZ_CORE_BIN_ACC_ALL;
+		if (r->bin->lazy) {
+			// flagged when asked for, e.g. with .is* or .ii*
+			action &= ~(RZ_CORE_BIN_ACC_STRINGS | RZ_CORE_BIN_ACC_RELOCS | RZ_CORE_BIN_ACC_IMPORTS
+				| RZ_CORE_BIN_ACC_SYMBOLS | RZ_CORE_BIN_ACC_FIELDS | RZ_CORE_BIN_ACC_LIBS
+				| RZ_CORE_BIN_ACC_CLASSES | RZ_CORE_BIN_ACC_DWARF);
+		}
+		rz_core_bin_info (r, action, RZ_MODE_SET, va, NULL, NULL);
 		rz_core_bin_set_cur (r, binfile);
 		return true;
 	}
@@ -384,6 +391,7 @@ static void _print_strings(RzCore *r, RzList *list, int mode, int va) {
 	bin->maxstrlen = maxstr;
 	if (IS_MODE_JSON (mode)) {
 		pj = rz_core_pj_new (r);
+		rz_cons_pj_stream (pj);
 		pj_a (pj);
 	} else if (IS_MODE_RAD (mode)) {
 		rz_cons_println ("fs strings");
@@ -398,6 +406,7 @@ static void _print_strings(RzCore *r, RzList *list, int mode, int va) {
 	rz_list_foreach (list, iter, string) {
 		const char *section_name, *type_string;
 		ut64 paddr, vaddr;
+		rz_cons_stream_flush ();
 		paddr = string->paddr;
 		vaddr = rva (r->bin, paddr, string->vaddr, va);
 		if (!rz_bin_string_filter (bin, string->string, vaddr)) {
@@ -802,7 +811,7 @@ static int bin_info(RzCore *r, int mode, ut64 laddr) {
 		}
 		return false;
 	}
-	havecode = is_executable (obj) | (obj->entries != NULL);
+	havecode = is_executable (obj) | (rz_bin_file_get_entries (bf) != NULL);
 	compiled = get_compile_time (bf->sdb);
 
 	if (IS_MODE_SET (mode)) {
@@ -1100,7 +1109,11 @@ static int bin_dwarf(RzCore *core, int mode) {
 		// TODO: complete and speed-up support for dwarf
 		RzBinDwarfDebugAbbrev *da = NULL;
 		da = rz_bin_dwarf_parse_abbrev (core->bin, mode);
-		RzBinDwarfDebugInfo *info = rz_bin_dwarf_parse_info (da, core->bin, mode);
+		// only printing needs the DIEs now, rz_analysis_dwarf_process_info ()
+		// loads the units of the index itself
+		RzBinDwarfDebugInfo *info = mode == RZ_MODE_PRINT
+			? rz_bin_dwarf_parse_info (da, core->bin, mode)
+			: rz_bin_dwarf_index_info (da, core->bin);
 		HtUP /*<offset, List *<LocListEntry>*/ *loc_table = rz_bin_dwarf_parse_loc (core->bin, core->analysis->bits / 8);
 		// I suppose there is no reason the parse it for a printing purposes
 		if (info && mode != RZ_MODE_PRINT) {
@@ -1119,6 +1132,12 @@ static int bin_dwarf(RzCore *core, int mode) {
 		}
 		rz_bin_dwarf_free_debug_info (info);
 		rz_bin_dwarf_parse_aranges (core->bin, mode);
+		if (mode & RZ_MODE_SET) {
+			// the rows are not listed, the line table of the bin file is enough
+			bool ret = rz_bin_dwarf_parse_line_table (core->bin, mode) != NULL;
+			rz_bin_dwarf_free_debug_abbrev (da);
+			return ret;
+		}
 		list = ownlist = rz_bin_dwarf_parse_line (core->bin, mode);
 		rz_bin_dwarf_free_debug_abbrev (da);
 	}
@@ -1313,6 +1332,12 @@ static int bin_source(RzCore *r, int mode) {
 		}
 		rz_list_free (list);
 	}
+	if (binfile->addrline) {
+		size_t i;
+		for (i = 0; i < binfile->addrline->files_count; i++) {
+			rz_list_append (final_list, binfile->addrline->files[i]);
+		}
+	}
 	rz_cons_printf ("[Source file]\n");
 	RzList *uniqlist = rz_list_uniq (final_list, srclineCmp);
 	rz_list_foreach (uniqlist, iter2, srcline) {
@@ -1320,6 +1345,8 @@ static int bin_source(RzCore *r, int mode) {
 	}
 	rz_list_free (uniqlist);
 	rz_list_free (final_list);
+	// the source lines point into the values of ls
+	ls_free (ls);
 	return true;
 }
 
@@ -253,6 +253,12 @@ static bool cb_analdepth(void *user, void *data) {
 	return true;
 }
 
+static bool cb_analysis_opcache(void *user, void *data) {
+	RzCore *core = (RzCore *)user;
+	RzConfigNode *node = (RzConfigNode *)data;
+	return rz_analysis_op_cache_set_size (core->analysis, (size_t)node->i_value << 20);
+}
+
 static bool cb_analgraphdepth(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	RzConfigNode *node = (RzConfigNode *)data;
@@ -429,7 +435,7 @@ static bool cb_asmsubtail(void *user, void *data) {
 
 static bool cb_scrlast(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *) data;
-	rz_cons_singleton ()->context->lastEnabled = node->i_value;
+	rz_cons_context ()->lastEnabled = node->i_value;
 	return true;
 }
 
@@ -1313,7 +1319,7 @@ static bool cb_color(void *user, void *data) {
 	} else if (!strcmp (node->value, "false")) {
 		node->i_value = 0;
 	}
-	rz_cons_singleton ()->context->color_mode = (node->i_value > COLOR_MODE_16M)
+	rz_cons_context ()->color_mode = (node->i_value > COLOR_MODE_16M)
 		? COLOR_MODE_16M: node->i_value;
 	rz_cons_pal_update_event ();
 	rz_print_set_flags (core->print, core->print->flags);
@@ -1322,9 +1328,9 @@ static bool cb_color(void *user, void *data) {
 
 static bool cb_color_getter(void *user, RzConfigNode *node) {
 	(void)user;
-	node->i_value = rz_cons_singleton ()->context->color_mode;
+	node->i_value = rz_cons_context ()->color_mode;
 	char buf[128];
-	rz_config_node_value_format_i (buf, sizeof (buf), rz_cons_singleton ()->context->color_mode, node);
+	rz_config_node_value_format_i (buf, sizeof (buf), rz_cons_context ()->color_mode, node);
 	if (!node->value || strcmp (node->value, buf) != 0) {
 		free (node->value);
 		node->value = strdup (buf);
@@ -1733,6 +1739,16 @@ static bool cb_iopcache(void *user, void *data) {
 	return true;
 }
 
+static bool cb_iopcachesize(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	if (!rz_io_page_cache_resize (core->io, node->i_value)) {
+		eprintf ("Cannot allocate %" PFMT64u " bytes for the io page cache\n", node->i_value);
+		return false;
+	}
+	return true;
+}
+
 static bool cb_iopcacheread(void *user, void *data) {
 	RzCore *core = (RzCore *) user;
 	RzConfigNode *node = (RzConfigNode *) data;
@@ -1871,7 +1887,7 @@ static bool cb_cmddepth(void *user, void *data) {
 	RzCore *core = (RzCore *)user;
 	int c = RZ_MAX (((RzConfigNode*)data)->i_value, 0);
 	core->max_cmd_depth = c;
-	core->cons->context->cmd_depth = c;
+	rz_cons_context ()->cmd_depth = c;
 	return true;
 }
 
@@ -2171,6 +2187,12 @@ static bool cb_scrpagesize(void *user, void *data) {
 	return true;
 }
 
+static bool cb_scrstream(void *user, void *data) {
+	RzConfigNode *node = (RzConfigNode *) data;
+	rz_cons_singleton ()->stream = node->i_value;
+	return true;
+}
+
 static bool cb_scrflush(void *user, void *data) {
 	RzConfigNode *node = (RzConfigNode *) data;
 	rz_cons_singleton ()->flush = node->i_value;
@@ -2246,7 +2268,7 @@ static bool cb_scrint(void *user, void *data) {
 	if (node->i_value && rz_sandbox_enable (0)) {
 		return false;
 	}
-	rz_cons_singleton ()->context->is_interactive = node->i_value;
+	rz_cons_context ()->is_interactive = node->i_value;
 	return true;
 }
 
@@ -2428,6 +2450,13 @@ static bool cb_debase64(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binlazy(void *user, void *data) {
+	RzCore *core = (RzCore *) user;
+	RzConfigNode *node = (RzConfigNode *) data;
+	core->bin->lazy = node->i_value;
+	return true;
+}
+
 static bool cb_binstrings(void *user, void *data) {
 	const ut32 req = RZ_BIN_REQ_STRINGS;
 	RzCore *core = (RzCore *) user;
@@ -2916,6 +2945,8 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB ("analysis.delay", "true", &cb_analysis_delay, "Enable delay slot analysis if supported by the architecture");
 	SETICB ("analysis.depth", 64, &cb_analdepth, "Max depth at code analysis"); // XXX: warn if depth is > 50 .. can be problematic
 	SETICB ("analysis.graph_depth", 256, &cb_analgraphdepth, "Max depth for path search");
+	SETICB ("analysis.opcache", 0, &cb_analysis_opcache, "Megabytes of decoded ops kept across disassembly and analysis, 0 to disable (see aoC)");
+	SETI ("analysis.threads", 1, "Number of threads decoding code ahead of aa (needs a reentrant analysis plugin)");
 	SETICB ("analysis.sleep", 0, &cb_analsleep, "Sleep N usecs every so often during analysis. Avoid 100% CPU usage");
 	SETCB ("analysis.ignbithints", "false", &cb_analysis_ignbithints, "Ignore the ahb hints (only obey asm.bits)");
 	SETBPREF ("analysis.calls", "false", "Make basic af analysis walk into calls");
@@ -3198,10 +3229,12 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB ("bin.strings", "true", &cb_binstrings, "Load strings from rbin on startup");
 	SETCB ("bin.debase64", "false", &cb_debase64, "Try to debase64 all strings");
 	SETBPREF ("bin.classes", "true", "Load classes from rbin on startup");
+	SETCB ("bin.lazy", "false", &cb_binlazy, "Load symbols, imports, relocs, strings, classes and debug info on first use instead of on open");
 	SETCB ("bin.verbose", "false", &cb_binverbose, "Show RzBin warnings when loading binaries");
 
 	/* prj */
 	SETPREF ("prj.file", "", "Path of the currently opened project");
+	SETBPREF ("prj.lazy", "false", "Load binary projects piece by piece, the analysis and flags of each map when it is first seeked to");
 
 	/* cfg */
 	SETBPREF ("cfg.r2wars", "false", "Enable some tweaks for the r2wars game");
@@ -3470,6 +3503,9 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETBPREF ("http.sandbox", "true", "Sandbox the HTTP server");
 	SETI ("http.timeout", 3, "Disconnect clients after N seconds of inactivity");
 	SETI ("http.dietime", 0, "Kill server after N seconds with no client");
+	SETI ("http.workers", 0, "Serve clients from N threads, read-only commands run side by side (0 serves one request at a time)");
+	SETI ("http.keepalive", 5, "Seconds to keep idle connections open when http.workers is set");
+	SETI ("http.chunk", 0, "Stream /cmd/ output in chunks of N bytes when http.workers is set");
 	SETBPREF ("http.verbose", "false", "Output server logs to stdout");
 	SETBPREF ("http.upget", "false", "/up/ answers GET requests, in addition to POST");
 	SETBPREF ("http.upload", "false", "Enable file uploads to /up/<filename>");
@@ -3483,6 +3519,9 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	free (tmpdir);
 	rz_config_desc (cfg, "http.uproot", "Path where files are uploaded");
 
+	/* tasks */
+	SETI ("tasks.workers", 0, "Threads running the parallel tasks started with &r (0 for one per cpu)");
+
 	/* tcp */
 	SETBPREF ("tcp.islocal", "false", "Bind a loopback for tcp command server");
 
@@ -3552,6 +3591,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETICB ("scr.maxtab", 4096, &cb_completion_maxtab, "Change max number of auto completion suggestions");
 	SETICB ("scr.pagesize", 1, &cb_scrpagesize, "Flush in pages when scr.linesleep is != 0");
 	SETCB ("scr.flush", "false", &cb_scrflush, "Force flush to console in realtime (breaks scripting)");
+	SETICB ("scr.stream", 0, &cb_scrstream, "Write command output in chunks of this many bytes while it is printed (0: when done)");
 	SETBPREF ("scr.slow", "true", "Do slow stuff on visual mode like RzFlag.get_at(true)");
 	SETCB ("scr.prompt.popup", "false", &cb_scr_prompt_popup, "Show widget dropdown for autocomplete");
 #if __WINDOWS__
@@ -3660,6 +3700,7 @@ RZ_API int rz_core_config_init(RzCore *core) {
 	SETCB ("io.pcache", "false", &cb_iopcache, "io.cache for p-level");
 	SETCB ("io.pcache.write", "false", &cb_iopcachewrite, "Enable write-cache");
 	SETCB ("io.pcache.read", "false", &cb_iopcacheread, "Enable read-cache");
+	SETICB ("io.pcache.size", 0, &cb_iopcachesize, "Bytes of file contents kept in the page-granular read cache (0 to disable)");
 	SETCB ("io.ff", "true", &cb_ioff, "Fill invalid buffers with 0xff instead of returning error");
 	SETBPREF ("io.exec", "true", "See !!rizin -h~-x");
 	SETICB ("io.0xff", 0xff, &cb_io_oxff, "Use this value instead of 0xff to fill unallocated areas");
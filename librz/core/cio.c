@@ -1,6 +1,7 @@
 /* rizin - LGPL - Copyright 2009-2019 - pancake */
 
 #include "rz_core.h"
+#include "rz_project.h"
 
 RZ_API int rz_core_setup_debugger (RzCore *r, const char *debugbackend, bool attach) {
 	int pid, *p = NULL;
@@ -372,6 +373,7 @@ RZ_API void rz_core_seek_arch_bits(RzCore *core, ut64 addr) {
 
 RZ_API bool rz_core_seek(RzCore *core, ut64 addr, bool rb) {
 	core->offset = rz_io_seek (core->io, addr, RZ_IO_SEEK_SET);
+	rz_project_bin_load_at (core, core->offset);
 	if (rb) {
 		rz_core_block_read (core);
 	}
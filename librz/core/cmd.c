@@ -336,7 +336,7 @@ static void recursive_help(RzCore *core, int detail, const char *cmd_prefix) {
 static bool lastcmd_repeat(RzCore *core, int next) {
 	int res = -1;
 	// Fix for backtickbug px`~`
-	if (!core->lastcmd || core->cons->context->cmd_depth < 1) {
+	if (!core->lastcmd || rz_cons_context ()->cmd_depth < 1) {
 		return false;
 	}
 	switch (*core->lastcmd) {
@@ -382,8 +382,8 @@ static bool lastcmd_repeat(RzCore *core, int next) {
 
 static int rz_core_cmd_nullcallback(void *data) {
 	RzCore *core = (RzCore*) data;
-	if (core->cons->context->breaked) {
-		core->cons->context->breaked = false;
+	if (rz_cons_context ()->breaked) {
+		rz_cons_context ()->breaked = false;
 		return 0;
 	}
 	if (!core->cmdrepeat) {
@@ -2294,7 +2294,7 @@ static int rz_core_cmd_subst(RzCore *core, char *cmd) {
 		goto beach;
 	}
 
-	if (core->max_cmd_depth - core->cons->context->cmd_depth == 1) {
+	if (core->max_cmd_depth - rz_cons_context ()->cmd_depth == 1) {
 		core->prompt_offset = core->offset;
 	}
 	cmd = (char *)rz_str_trim_head_ro (icmd);
@@ -4010,7 +4010,7 @@ RZ_API int rz_core_cmd_foreach(RzCore *core, const char *cmd, char *each) {
 			RzAnalysisFunction *fcn;
 			RzListIter *iter;
 			if (core->analysis) {
-				RzConsGrep grep = core->cons->context->grep;
+				RzConsGrep grep = rz_cons_context ()->grep;
 				rz_list_foreach (core->analysis->fcns, iter, fcn) {
 					char *buf;
 					rz_core_seek (core, fcn->addr, true);
@@ -4027,7 +4027,7 @@ RZ_API int rz_core_cmd_foreach(RzCore *core, const char *cmd, char *each) {
 						break;
 					}
 				}
-				core->cons->context->grep = grep;
+				rz_cons_context ()->grep = grep;
 			}
 			goto out_finish;
 		}
@@ -6026,8 +6026,8 @@ DEFINE_HANDLE_TS_FCN(commands) {
 
 	RZ_LOG_DEBUG ("commands with %d childs\n", child_count);
 	if (child_count == 0 && !*state->input) {
-		if (core->cons->context->breaked) {
-			core->cons->context->breaked = false;
+		if (rz_cons_context ()->breaked) {
+			rz_cons_context ()->breaked = false;
 			return RZ_CMD_STATUS_INVALID;
 		}
 		if (!core->cmdrepeat) {
@@ -6039,12 +6039,12 @@ DEFINE_HANDLE_TS_FCN(commands) {
 		rz_cons_break_push (NULL, NULL);
 	}
 	for (i = 0; i < child_count; i++) {
-		if (core->cons->context->cmd_depth < 1) {
+		if (rz_cons_context ()->cmd_depth < 1) {
 			RZ_LOG_ERROR ("handle_ts_commands: That was too deep...\n");
 			return RZ_CMD_STATUS_INVALID;
 		}
-		core->cons->context->cmd_depth--;
-		if (core->max_cmd_depth - core->cons->context->cmd_depth == 1) {
+		rz_cons_context ()->cmd_depth--;
+		if (core->max_cmd_depth - rz_cons_context ()->cmd_depth == 1) {
 			core->prompt_offset = core->offset;
 		}
 
@@ -6058,7 +6058,7 @@ DEFINE_HANDLE_TS_FCN(commands) {
 			rz_cons_flush ();
 			rz_core_task_yield (&core->tasks);
 		}
-		core->cons->context->cmd_depth++;
+		rz_cons_context ()->cmd_depth++;
 		if (cmd_res == RZ_CMD_STATUS_INVALID) {
 			char *command_str = ts_node_sub_string (command, state->input);
 			eprintf ("Error while executing command: %s\n", command_str);
@@ -6165,11 +6165,11 @@ static int run_cmd_depth(RzCore *core, char *cmd) {
 	char *rcmd;
 	int ret = false;
 
-	if (core->cons->context->cmd_depth < 1) {
+	if (rz_cons_context ()->cmd_depth < 1) {
 		eprintf ("rz_core_cmd: That was too deep (%s)...\n", cmd);
 		return false;
 	}
-	core->cons->context->cmd_depth--;
+	rz_cons_context ()->cmd_depth--;
 	for (rcmd = cmd;;) {
 		char *ptr = strchr (rcmd, '\n');
 		if (ptr) {
@@ -6185,7 +6185,7 @@ static int run_cmd_depth(RzCore *core, char *cmd) {
 		}
 		rcmd = ptr + 1;
 	}
-	core->cons->context->cmd_depth++;
+	rz_cons_context ()->cmd_depth++;
 	return ret;
 }
 
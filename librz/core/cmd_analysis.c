@@ -641,6 +641,7 @@ static const char *help_msg_ao[] = {
 	"aod", " [mnemonic]", "describe opcode for asm.arch",
 	"aoda", "", "show all mnemonic descriptions",
 	"aoc", " [cycles]", "analyze which op could be executed in [cycles]",
+	"aoC", "[j-]", "show decoded op cache stats (in JSON), or clear it (see analysis.opcache)",
 	"ao", " 5", "display opcode analysis of 5 opcodes",
 	"ao*", "", "display opcode in r commands",
 	NULL
@@ -1730,7 +1731,7 @@ static void core_analysis_bytes(RzCore *core, const ut8 *buf, int len, int nops,
 
 	// Variables required for setting up ESIL to REIL conversion
 	if (use_color) {
-		color = core->cons->context->pal.label;
+		color = rz_cons_context ()->pal.label;
 	}
 	switch (fmt) {
 	case 'j': {
@@ -4335,7 +4336,7 @@ static void __analysis_reg_list(RzCore *core, int type, int bits, char mode) {
 	int use_colors = rz_config_get_i (core->config, "scr.color");
 	if (use_colors) {
 #undef ConsP
-#define ConsP(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
+#define ConsP(x) (core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 		use_color = ConsP (creg) : Color_BWHITE;
 	} else {
 		use_color = NULL;
@@ -4420,7 +4421,7 @@ void cmd_analysis_reg(RzCore *core, const char *str) {
 	char *arg;
 
 	if (use_colors) {
-#define ConsP(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
+#define ConsP(x) (core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 		use_color = ConsP (creg)
 		: Color_BWHITE;
 	} else {
@@ -6717,6 +6718,37 @@ static void cmd_analysis_opcode(RzCore *core, const char *input) {
 			rz_core_cmd0 (core, "ao~mnemonic[1]");
 		}
 		break;
+	case 'C': // "aoC"
+		if (input[1] == '-') {
+			rz_analysis_op_cache_clear (core->analysis);
+		} else {
+			RzAnalysisOpCacheStats st;
+			rz_analysis_op_cache_stats (core->analysis, &st);
+			if (input[1] == 'j') {
+				PJ *pj = pj_new ();
+				if (!pj) {
+					break;
+				}
+				pj_o (pj);
+				pj_kn (pj, "hits", st.hits);
+				pj_kn (pj, "misses", st.misses);
+				pj_kn (pj, "flushes", st.flushes);
+				pj_kn (pj, "entries", st.entries);
+				pj_kn (pj, "size", st.size);
+				pj_kn (pj, "max_size", st.max_size);
+				pj_end (pj);
+				rz_cons_println (pj_string (pj));
+				pj_free (pj);
+			} else {
+				rz_cons_printf ("hits      %" PFMT64u "\n", st.hits);
+				rz_cons_printf ("misses    %" PFMT64u "\n", st.misses);
+				rz_cons_printf ("flushes   %" PFMT64u "\n", st.flushes);
+				rz_cons_printf ("entries   %u\n", st.entries);
+				rz_cons_printf ("size      %" PFMT64u "\n", (ut64)st.size);
+				rz_cons_printf ("max_size  %" PFMT64u "\n", (ut64)st.max_size);
+			}
+		}
+		break;
 	case 'c': // "aoc"
 	{
 		RzList *hooks;
@@ -7463,7 +7495,7 @@ static char *get_buf_asm(RzCore *core, ut64 from, ut64 addr, RzAnalysisFunction
 	free (ba);
 	if (color && has_color) {
 		buf_asm = rz_print_colorize_opcode (core->print, str,
-				core->cons->context->pal.reg, core->cons->context->pal.num, false, fcn ? fcn->addr : 0);
+				rz_cons_context ()->pal.reg, rz_cons_context ()->pal.num, false, fcn ? fcn->addr : 0);
 	} else {
 		buf_asm = rz_str_new (str);
 	}
@@ -7822,7 +7854,7 @@ static bool cmd_analysis_refs(RzCore *core, const char *input) {
 							rz_analysis_hint_free (hint);
 							if (has_color) {
 								desc = desc_to_free = rz_print_colorize_opcode (core->print, str,
-										core->cons->context->pal.reg, core->cons->context->pal.num, false, fcn ? fcn->addr : 0);
+										rz_cons_context ()->pal.reg, rz_cons_context ()->pal.num, false, fcn ? fcn->addr : 0);
 							} else {
 								desc = str;
 							}
@@ -809,12 +809,11 @@ static void fill_usage_strbuf(RzCmd *cmd, RzStrBuf *sb, RzCmdDesc *cd, bool use_
 		*pal_reset = "";
 
 	if (cmd->has_cons && use_color) {
-		RzCons *cons = rz_cons_singleton ();
-		pal_label_color = cons->context->pal.label;
-		pal_args_color = cons->context->pal.args;
-		pal_input_color = cons->context->pal.input;
-		pal_help_color = cons->context->pal.help;
-		pal_reset = cons->context->pal.reset;
+		pal_label_color = rz_cons_context ()->pal.label;
+		pal_args_color = rz_cons_context ()->pal.args;
+		pal_input_color = rz_cons_context ()->pal.input;
+		pal_help_color = rz_cons_context ()->pal.help;
+		pal_reset = rz_cons_context ()->pal.reset;
 	}
 
 	size_t columns = 0;
@@ -887,12 +886,11 @@ static void do_print_child_help(RzCmd *cmd, RzStrBuf *sb, RzCmdDesc *cd, const c
 		*pal_reset = "";
 
 	if (cmd->has_cons && use_color) {
-		RzCons *cons = rz_cons_singleton ();
-		pal_args_color = cons->context->pal.args;
-		pal_opt_color = cons->context->pal.reset;
-		pal_help_color = cons->context->pal.help;
-		pal_input_color = cons->context->pal.input;
-		pal_reset = cons->context->pal.reset;
+		pal_args_color = rz_cons_context ()->pal.args;
+		pal_opt_color = rz_cons_context ()->pal.reset;
+		pal_help_color = rz_cons_context ()->pal.help;
+		pal_input_color = rz_cons_context ()->pal.input;
+		pal_reset = rz_cons_context ()->pal.reset;
 	}
 
 	size_t columns = 0;
@@ -978,12 +976,11 @@ static void fill_details(RzCmd *cmd, RzCmdDesc *cd, RzStrBuf *sb, bool use_color
 		*pal_args_color = "",
 		*pal_reset = "";
 	if (cmd->has_cons && use_color) {
-		RzCons *cons = rz_cons_singleton ();
-		pal_help_color = cons->context->pal.help;
-		pal_input_color = cons->context->pal.input;
-		pal_label_color = cons->context->pal.label;
-		pal_args_color = cons->context->pal.args;
-		pal_reset = cons->context->pal.reset;
+		pal_help_color = rz_cons_context ()->pal.help;
+		pal_input_color = rz_cons_context ()->pal.input;
+		pal_label_color = rz_cons_context ()->pal.label;
+		pal_args_color = rz_cons_context ()->pal.args;
+		pal_reset = rz_cons_context ()->pal.reset;
 	}
 
 	const RzCmdDescDetail *detail_it = cd->help->details;
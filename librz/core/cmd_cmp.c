@@ -151,7 +151,7 @@ static int rizin_compare_words(RzCore *core, ut64 of, ut64 od, int len, int ws)
 	int i;
 	bool useColor = rz_config_get_i (core->config, "scr.color") != 0;
 	utAny v0, v1;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	for (i = 0; i < len; i+=ws) {
 		memset (&v0, 0, sizeof (v0));
 		memset (&v1, 0, sizeof (v1));
@@ -355,7 +355,7 @@ static int cmd_cmp_disasm(RzCore *core, const char *input, int mode) {
 	int cols = rz_config_get_i (core->config, "hex.cols") * 2;
 	ut64 off = rz_num_math (core->num, input);
 	ut8 *buf = calloc (core->blocksize + 32, 1);
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	if (!buf) {
 		return false;
 	}
@@ -484,7 +484,7 @@ static void __core_cmp_bits (RzCore *core, ut64 addr) {
 	ut8 a, b;
 	rz_io_read_at (core->io, core->offset, &a, 1);
 	rz_io_read_at (core->io, addr, &b, 1);
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	const char *color = scr_color? pal->offset: "";
 	const char *color_end = scr_color? Color_RESET: "";
 	if (rz_config_get_i (core->config, "hex.header")) {
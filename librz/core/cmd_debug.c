@@ -1895,7 +1895,7 @@ RZ_API void rz_core_debug_rr(RzCore *core, RzReg *reg, int mode) {
 
 	if (use_colors) {
 #undef ConsP
-#define ConsP(x) (core->cons && core->cons->context->pal.x) ? core->cons->context->pal.x
+#define ConsP(x) (core->cons && rz_cons_context ()->pal.x) ? rz_cons_context ()->pal.x
 		color = ConsP(creg): Color_BWHITE;
 		colorend = Color_RESET;
 	}
@@ -2253,7 +2253,7 @@ static void cmd_debug_reg(RzCore *core, const char *str) {
 	}
 	if (use_colors) {
 #undef ConsP
-#define ConsP(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
+#define ConsP(x) (core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 		use_color = ConsP(creg): Color_BWHITE;
 	} else {
 		use_color = NULL;
@@ -25,6 +25,7 @@ static const RzCmdDescDetail grep_details[5];
 static const RzCmdDescArg hash_bang_args[3];
 static const RzCmdDescArg tasks_args[2];
 static const RzCmdDescArg tasks_transient_args[2];
+static const RzCmdDescArg tasks_parallel_args[2];
 static const RzCmdDescArg tasks_output_args[2];
 static const RzCmdDescArg tasks_break_args[2];
 static const RzCmdDescArg tasks_delete_args[2];
@@ -49,6 +50,8 @@ static const RzCmdDescArg push_escaped_args[2];
 static const RzCmdDescArg env_args[3];
 static const RzCmdDescArg ls_args[2];
 static const RzCmdDescArg project_save_args[2];
+static const RzCmdDescArg project_save_bin_args[2];
+static const RzCmdDescArg project_convert_args[3];
 static const RzCmdDescArg project_open_args[2];
 static const RzCmdDescArg project_open_no_bin_io_args[2];
 static const RzCmdDescArg uniq_args[2];
@@ -158,6 +161,15 @@ static const RzCmdDescHelp tasks_transient_help = {
 	.args = tasks_transient_args,
 };
 
+static const RzCmdDescArg tasks_parallel_args[] = {
+	{ .name = "cmd", .type = RZ_CMD_ARG_TYPE_CMD_LAST, },
+	{ 0 },
+};
+static const RzCmdDescHelp tasks_parallel_help = {
+	.summary = "Run <cmd> in a new background task in parallel with the others, only for ?e, afl, aflj, aflc, afll, ax, axj, f and fj",
+	.args = tasks_parallel_args,
+};
+
 static const RzCmdDescArg tasks_output_args[] = {
 	{ .name = "n", .type = RZ_CMD_ARG_TYPE_NUM, },
 	{ 0 },
@@ -576,6 +588,26 @@ static const RzCmdDescHelp project_save_help = {
 	.args = project_save_args,
 };
 
+static const RzCmdDescArg project_save_bin_args[] = {
+	{ .name = "project.rzpb", .type = RZ_CMD_ARG_TYPE_FILE, },
+	{ 0 },
+};
+static const RzCmdDescHelp project_save_bin_help = {
+	.summary = "Save a project in the binary format, which can be loaded lazily",
+	.args = project_save_bin_args,
+};
+
+
+static const RzCmdDescArg project_convert_args[] = {
+	{ .name = "project.rzdb", .type = RZ_CMD_ARG_TYPE_FILE, },
+	{ .name = "project.rzpb", .type = RZ_CMD_ARG_TYPE_FILE, },
+	{ 0 },
+};
+static const RzCmdDescHelp project_convert_help = {
+	.summary = "Convert a project file to the binary format",
+	.args = project_convert_args,
+};
+
 static const RzCmdDescArg project_open_args[] = {
 	{ .name = "project.rzdb", .type = RZ_CMD_ARG_TYPE_FILE, },
 	{ 0 },
@@ -1493,6 +1525,8 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *and__cd = rz_cmd_desc_group_modes_new (core->rcmd, root_cd, "&", RZ_OUTPUT_MODE_STANDARD | RZ_OUTPUT_MODE_JSON, rz_tasks_handler, &tasks_help, &and__help);
 	rz_warn_if_fail (and__cd);	RzCmdDesc *tasks_transient_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&t", rz_tasks_transient_handler, &tasks_transient_help);
 	rz_warn_if_fail (tasks_transient_cd);
+	RzCmdDesc *tasks_parallel_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&r", rz_tasks_parallel_handler, &tasks_parallel_help);
+	rz_warn_if_fail (tasks_parallel_cd);
 	RzCmdDesc *tasks_output_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&=", rz_tasks_output_handler, &tasks_output_help);
 	rz_warn_if_fail (tasks_output_cd);
 	RzCmdDesc *tasks_break_cd = rz_cmd_desc_argv_new (core->rcmd, and__cd, "&b", rz_tasks_break_handler, &tasks_break_help);
@@ -1593,6 +1627,10 @@ RZ_IPI void newshell_cmddescs_init(RzCore *core) {
 	RzCmdDesc *P_cd = rz_cmd_desc_group_new (core->rcmd, root_cd, "P", NULL, NULL, &P_help);
 	rz_warn_if_fail (P_cd);	RzCmdDesc *project_save_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Ps", rz_project_save_handler, &project_save_help);
 	rz_warn_if_fail (project_save_cd);
+	RzCmdDesc *project_save_bin_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Psb", rz_project_save_bin_handler, &project_save_bin_help);
+	rz_warn_if_fail (project_save_bin_cd);
+	RzCmdDesc *project_convert_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Pc", rz_project_convert_handler, &project_convert_help);
+	rz_warn_if_fail (project_convert_cd);
 	RzCmdDesc *project_open_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Po", rz_project_open_handler, &project_open_help);
 	rz_warn_if_fail (project_open_cd);
 	RzCmdDesc *project_open_no_bin_io_cd = rz_cmd_desc_argv_new (core->rcmd, P_cd, "Poo", rz_project_open_no_bin_io_handler, &project_open_no_bin_io_help);
@@ -16,6 +16,7 @@ RZ_IPI int rz_cmd_alias(void *data, const char *input);
 RZ_IPI RzCmdStatus rz_env_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_tasks_handler(RzCore *core, int argc, const char **argv, RzOutputMode mode);
 RZ_IPI RzCmdStatus rz_tasks_transient_handler(RzCore *core, int argc, const char **argv);
+RZ_IPI RzCmdStatus rz_tasks_parallel_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_tasks_output_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_tasks_break_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_tasks_delete_handler(RzCore *core, int argc, const char **argv);
@@ -67,6 +68,8 @@ RZ_IPI int rz_cmd_plugins(void *data, const char *input);
 RZ_IPI int rz_cmd_open(void *data, const char *input);
 RZ_IPI int rz_cmd_print(void *data, const char *input);
 RZ_IPI RzCmdStatus rz_project_save_handler(RzCore *core, int argc, const char **argv);
+RZ_IPI RzCmdStatus rz_project_save_bin_handler(RzCore *core, int argc, const char **argv);
+RZ_IPI RzCmdStatus rz_project_convert_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_project_open_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI RzCmdStatus rz_project_open_no_bin_io_handler(RzCore *core, int argc, const char **argv);
 RZ_IPI int rz_cmd_quit(void *data, const char *input);
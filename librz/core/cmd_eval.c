@@ -145,7 +145,7 @@ static bool cmd_load_theme(RzCore *core, const char *_arg) {
 	}
 	if (!rz_str_cmp (_arg, "default", strlen (_arg))) {
 		curtheme = strdup (_arg);
-		rz_cons_pal_init (core->cons->context);
+		rz_cons_pal_init (rz_cons_context ());
 		return true;
 	}
 	char *arg = strdup (_arg);
@@ -399,7 +399,7 @@ RZ_IPI int rz_cmd_eval(void *data, const char *input) {
 	case 'c': // "ec"
 		switch (input[1]) {
 		case 'd': // "ecd"
-			rz_cons_pal_init (core->cons->context);
+			rz_cons_pal_init (rz_cons_context ());
 			break;
 		case '?':
 			rz_core_cmd_help (core, help_msg_ec);
@@ -548,7 +548,7 @@ RZ_IPI int rz_cmd_eval(void *data, const char *input) {
 			}
 			rz_meta_set_string (core->analysis, RZ_META_TYPE_HIGHLIGHT, core->offset, "");
 			const char *str = rz_meta_get_string (core->analysis, RZ_META_TYPE_HIGHLIGHT, core->offset);
-			char *dup = rz_str_newf ("%s \"%s%s\"", str?str:"", word?word:"", color_code?color_code:rz_cons_singleton ()->context->pal.wordhl);
+			char *dup = rz_str_newf ("%s \"%s%s\"", str?str:"", word?word:"", color_code?color_code:rz_cons_context ()->pal.wordhl);
 			rz_meta_set_string (core->analysis, RZ_META_TYPE_HIGHLIGHT, core->offset, dup);
 			rz_str_argv_free (argv);
 			RZ_FREE (word);
@@ -323,6 +323,10 @@ static void rz_core_file_info(RzCore *core, int mode) {
 	}
 }
 
+static int bin_list_length(RzList *list) {
+	return list? rz_list_length (list): 0;
+}
+
 static int bin_is_executable(RzBinObject *obj){
 	RzListIter *it;
 	RzBinSection *sec;
@@ -743,8 +747,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			RBININFO ("fields", RZ_CORE_BIN_ACC_FIELDS, NULL, 0);
 			break;
 		case 'l': { // "il"
-			RzBinObject *obj = rz_bin_cur_object (core->bin);
-			RBININFO ("libs", RZ_CORE_BIN_ACC_LIBS, NULL, (obj && obj->libs)? rz_list_length (obj->libs): 0);
+			RBININFO ("libs", RZ_CORE_BIN_ACC_LIBS, NULL, bin_list_length (rz_bin_get_libs (core->bin)));
 			break;
 		}
 		case 'L': { // "iL"
@@ -764,19 +767,18 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			goto done;
 		}
 		case 's': { // "is"
-			RzBinObject *obj = rz_bin_cur_object (core->bin);
 			// Case for isj.
 			if (input[1] == 'j' && input[2] == '.') {
 				mode = RZ_MODE_JSON;
-				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 2, (obj && obj->symbols)? rz_list_length (obj->symbols): 0);
+				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 2, bin_list_length (rz_bin_get_symbols (core->bin)));
 			} else if (input[1] == 'q' && input[2] == 'q') {
 				mode = RZ_MODE_SIMPLEST;
-				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 1, (obj && obj->symbols)? rz_list_length (obj->symbols): 0);
+				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 1, bin_list_length (rz_bin_get_symbols (core->bin)));
 			} else if (input[1] == 'q' && input[2] == '.') {
 				mode = RZ_MODE_SIMPLE;
 				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 2, 0);
 			} else {
-				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 1, (obj && obj->symbols)? rz_list_length (obj->symbols): 0);
+				RBININFO ("symbols", RZ_CORE_BIN_ACC_SYMBOLS, input + 1, bin_list_length (rz_bin_get_symbols (core->bin)));
 			}
 			while (*(++input)) ;
 			input--;
@@ -911,9 +913,8 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 			}
 			break;
 		case 'i': { // "ii"
-			RzBinObject *obj = rz_bin_cur_object (core->bin);
 			RBININFO ("imports", RZ_CORE_BIN_ACC_IMPORTS, NULL,
-				(obj && obj->imports)? rz_list_length (obj->imports): 0);
+				bin_list_length (rz_bin_get_imports (core->bin)));
 			break;
 		}
 		case 'I': // "iI"
@@ -1008,7 +1009,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 				}
 				if (obj) {
 					RBININFO ("strings", RZ_CORE_BIN_ACC_STRINGS, NULL,
-						(obj && obj->strings)? rz_list_length (obj->strings): 0);
+						bin_list_length (rz_bin_get_strings (core->bin)));
 				}
 			}
 			break;
@@ -1023,9 +1024,10 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 				if (!obj) {
 					break;
 				}
+				RzList *classes = rz_bin_get_classes (core->bin);
 				bool fullGraph = true;
 				if (fullGraph) {
-					rz_list_foreach (obj->classes, iter, cls) {
+					rz_list_foreach (classes, iter, cls) {
 						if (cls->super) {
 							rz_cons_printf ("agn %s\n", cls->super);
 							rz_cons_printf ("agn %s\n", cls->name);
@@ -1035,7 +1037,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 						}
 					}
 				} else {
-					rz_list_foreach (obj->classes, iter, cls) {
+					rz_list_foreach (classes, iter, cls) {
 						if (cls->super && !strstr (cls->super, "NSObject")) {
 							rz_cons_printf ("agn %s\n", cls->super);
 							rz_cons_printf ("agn %s\n", cls->name);
@@ -1052,6 +1054,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 				if (!obj) {
 					break;
 				}
+				RzList *classes = rz_bin_get_classes (core->bin);
 				if (input[2] && input[2] != '*' && input[2] != 'j' && !strstr (input, "qq")) {
 					bool rizin = strstr (input, "**") != NULL;
 					int idx = -1;
@@ -1073,7 +1076,7 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 					}
 					int count = 0;
 					int mode = input[1];
-					rz_list_foreach (obj->classes, iter, cls) {
+					rz_list_foreach (classes, iter, cls) {
 						if (rizin) {
 							rz_cons_printf ("ac %s\n", cls->name);
 							rz_list_foreach (cls->methods, iter2, sym) {
@@ -1133,16 +1136,16 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 						goto done;
 					}
 					goto done;
-				} else if (obj->classes) {
-					playMsg (core, "classes", rz_list_length (obj->classes));
+				} else if (classes) {
+					playMsg (core, "classes", rz_list_length (classes));
 					if (strstr (input, "qq")) { // "icqq"
-						rz_list_foreach (obj->classes, iter, cls) {
+						rz_list_foreach (classes, iter, cls) {
 							if (!isKnownPackage (cls->name)) {
 								rz_cons_printf ("%s\n", cls->name);
 							}
 						}
 					} else if (input[1] == 'l') { // "icl"
-						rz_list_foreach (obj->classes, iter, cls) {
+						rz_list_foreach (classes, iter, cls) {
 							rz_list_foreach (cls->methods, iter2, sym) {
 								const char *comma = iter2->p? " ": "";
 								rz_cons_printf ("%s0x%"PFMT64d, comma, sym->vaddr);
@@ -1156,20 +1159,21 @@ RZ_IPI int rz_cmd_info(void *data, const char *input) {
 						if (input[2] == '*') {
 							mode |= RZ_MODE_RADARE;
 						}
-						RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, rz_list_length (obj->classes));
+						RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, rz_list_length (classes));
 						input = " ";
 					} else { // "icq"
 						if (input[2] == 'j') {
 							mode |= RZ_MODE_JSON; // default mode is RZ_MODE_SIMPLE
 						}
-						RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, rz_list_length (obj->classes));
+						RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, rz_list_length (classes));
 					}
 					goto done;
 				}
 			} else { // "ic"
 				RzBinObject *obj = rz_bin_cur_object (core->bin);
-				if (obj && obj->classes) {
-					int len = rz_list_length (obj->classes);
+				RzList *classes = obj? rz_bin_get_classes (core->bin): NULL;
+				if (classes) {
+					int len = rz_list_length (classes);
 					RBININFO ("classes", RZ_CORE_BIN_ACC_CLASSES, NULL, len);
 				}
 			}
@@ -141,6 +141,9 @@ static int remove_meta_offset(RzCore *core, ut64 offset) {
 		eprintf ("Failed to convert %"PFMT64x" to a key", offset);
 		return -1;
 	}
+	if (core->bin->cur->addrline) {
+		rz_bin_dwarf_line_table_del (core->bin->cur->addrline, offset);
+	}
 	return sdb_unset (core->bin->cur->sdb_addrinfo, aoffsetptr, 0);
 }
 
@@ -218,6 +221,39 @@ static bool print_addrinfo (void *user, const char *k, const char *v) {
 	return true;
 }
 
+static void print_addrline_entry(Sdb *s, const RzBinDwarfLineTable *table, const RzBinDwarfLineEntry *e) {
+	char aoffset[64];
+	char *aoffsetptr = sdb_itoa (e->address, aoffset, 16);
+	if (!e->address || e->address == UT64_MAX || sdb_const_get (s, aoffsetptr, 0)) {
+		// the ones set with CL take precedence and are already listed
+		return;
+	}
+	if (filter_format) {
+		rz_cons_printf ("CL %s %s:%u\n", aoffsetptr, table->files[e->file], e->line);
+	} else {
+		rz_cons_printf ("file: %s\nline: %u\n", table->files[e->file], e->line);
+	}
+	filter_count++;
+}
+
+static void print_addrline(RzBinFile *bf) {
+	const RzBinDwarfLineTable *table = bf->addrline;
+	if (!table) {
+		return;
+	}
+	if (filter_offset != UT64_MAX) {
+		const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (table, filter_offset);
+		if (e) {
+			print_addrline_entry (bf->sdb_addrinfo, table, e);
+		}
+		return;
+	}
+	size_t i;
+	for (i = 0; i < table->count; i++) {
+		print_addrline_entry (bf->sdb_addrinfo, table, &table->entries[i]);
+	}
+}
+
 static int cmd_meta_add_fileline(Sdb *s, char *fileline, ut64 offset) {
 	char aoffset[64];
 	char *aoffsetptr = sdb_itoa (offset, aoffset, 16);
@@ -275,8 +311,12 @@ static int cmd_meta_lineinfo(RzCore *core, const char *input) {
 	if (all) {
 		if (remove) {
 			sdb_reset (core->bin->cur->sdb_addrinfo);
+			rz_bin_dwarf_line_table_free (core->bin->cur->addrline);
+			core->bin->cur->addrline = NULL;
 		} else {
+			filter_offset = UT64_MAX;
 			sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, NULL);
+			print_addrline (core->bin->cur);
 		}
 		free (pheap);
 		return 0;
@@ -321,6 +361,7 @@ static int cmd_meta_lineinfo(RzCore *core, const char *input) {
 		filter_offset = offset;
 		filter_count = 0;
 		sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, NULL);
+		print_addrline (core->bin->cur);
 		if (filter_count == 0) {
 			print_meta_offset (core, offset);
 		}
@@ -237,7 +237,7 @@ static const char *help_msg_p[] = {
 	"pf", "[?][.nam] [fmt]", "print formatted data (pf.name, pf.name $<expr>)",
 	"pF", "[?][apx]", "print asn1, pkcs7 or x509",
 	"pg", "[?][x y w h] [cmd]", "create new visual gadget or print it (see pg? for details)",
-	"ph", "[?][=|hash] ([len])", "calculate hash for a block",
+	"ph", "[?][=|hash[,hash..]] ([len])", "calculate hash for a block",
 	"pi", "[?][bdefrj] [num]", "print instructions",
 	"pI", "[?][iI][df] [len]", "print N instructions/bytes (f=func)",
 	"pj", "[?] [len]", "print as indented JSON",
@@ -1730,7 +1730,7 @@ static void annotated_hexdump(RzCore *core, const char *str, int len) {
 		}
 
 		if (usecolor) {
-			append (ebytes, core->cons->context->pal.offset);
+			append (ebytes, rz_cons_context ()->pal.offset);
 		}
 		if (showSection) {
 			const char * name = rz_core_get_section_name (core, ea);
@@ -2177,7 +2177,7 @@ static void cmd_print_pwn(const RzCore *core) {
 }
 
 static int cmd_print_pxA(RzCore *core, int len, const char *input) {
-	RzConsPrintablePalette *pal = &core->cons->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	int show_offset = true;
 	int cols = rz_config_get_i (core->config, "hex.cols");
 	int show_color = rz_config_get_i (core->config, "scr.color");
@@ -2541,7 +2541,7 @@ static void disasm_strings(RzCore *core, const char *input, RzAnalysisFunction *
 	bool asm_emu = rz_config_get_i (core->config, "asm.emu");
 	bool emu_str = rz_config_get_i (core->config, "emu.str");
 	rz_config_set_i (core->config, "emu.str", true);
-	RzConsPrintablePalette *pal = &core->cons->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	// force defaults
 	rz_config_set_i (core->config, "asm.offset", true);
 	rz_config_set_i (core->config, "asm.dwarf", true);
@@ -2873,6 +2873,55 @@ static void algolist(int mode) {
 	}
 }
 
+static int ph_read(void *user, ut64 addr, ut8 *buf, int len) {
+	RzCore *core = user;
+	return rz_io_read_at (core->io, addr, buf, len)? len: -1;
+}
+
+// "ph md5,sha1 [len]", the range is read once for all the algorithms
+static bool cmd_print_ph_multi(RzCore *core, const char *algos, ut64 len) {
+	ut64 i, bits = rz_hash_name_to_bits (algos);
+	if (!bits) {
+		eprintf ("Unknown hash algorithm '%s'\n", algos);
+		return false;
+	}
+	RzHashMulti *mh = rz_hash_multi_new (bits, 0);
+	if (!mh) {
+		return false;
+	}
+	if (len) {
+		ut64 bsize = rz_hash_multi_streamable (bits)? RZ_MIN (len, 1024 * 1024): len;
+		if (bsize > ST32_MAX) {
+			eprintf ("Block too big to hash at once\n");
+			rz_hash_multi_free (mh);
+			return false;
+		}
+		if (!rz_hash_multi_stream (mh, ph_read, core, core->offset, core->offset + len, bsize)) {
+			eprintf ("Cannot allocate the buffers to hash\n");
+			rz_hash_multi_free (mh);
+			return false;
+		}
+	}
+	rz_hash_multi_end (mh);
+	for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
+		RzHash *ctx = rz_hash_multi_get (mh, i);
+		if (!ctx) {
+			continue;
+		}
+		int j, size = rz_hash_size (i);
+		rz_cons_printf ("%s ", rz_hash_name (i));
+		if (!size) {
+			rz_cons_printf ("%.8f", ctx->entropy);
+		}
+		for (j = 0; j < size; j++) {
+			rz_cons_printf ("%02x", ctx->digest[j]);
+		}
+		rz_cons_newline ();
+	}
+	rz_hash_multi_free (mh);
+	return true;
+}
+
 static bool cmd_print_ph(RzCore *core, const char *input) {
 	char algo[128];
 	ut32 osize = 0, len = core->blocksize;
@@ -2889,7 +2938,11 @@ static bool cmd_print_ph(RzCore *core, const char *input) {
 	}
 	input = rz_str_trim_head_ro (input);
 	ptr = strchr (input, ' ');
-	sscanf (input, "%31s", algo);
+	sscanf (input, "%127s", algo);
+	if (strchr (algo, ',')) {
+		ut64 mlen = ptr && ptr[1]? rz_num_math (core->num, ptr + 1): core->blocksize;
+		return cmd_print_ph_multi (core, algo, mlen);
+	}
 	if (ptr && ptr[1]) { // && rz_num_is_valid_input (core->num, ptr + 1)) {
 		int nlen = rz_num_math (core->num, ptr + 1);
 		if (nlen > 0) {
@@ -3269,12 +3322,12 @@ static bool cmd_print_blocks(RzCore *core, const char *input) {
 				if (use_color) {
 					if (s) {
 						if (s->perm & RZ_PERM_X) {
-							rz_cons_print (rz_cons_singleton ()->context->pal.graph_trufae);
+							rz_cons_print (rz_cons_context ()->pal.graph_trufae);
 						} else {
-							rz_cons_print (rz_cons_singleton ()->context->pal.graph_true);
+							rz_cons_print (rz_cons_context ()->pal.graph_true);
 						}
 					} else {
-						rz_cons_print (rz_cons_singleton ()->context->pal.graph_false);
+						rz_cons_print (rz_cons_context ()->pal.graph_false);
 					}
 				}
 				if (as->block[p].strings > 0) {
@@ -4162,7 +4215,7 @@ dsmap {
 }
 #endif
 
-#define P(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
+#define P(x) (core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 
 static void disasm_until_ret(RzCore *core, ut64 addr, char type_print, const char *arg) {
 	int p = 0;
@@ -4182,7 +4235,7 @@ static void disasm_until_ret(RzCore *core, ut64 addr, char type_print, const cha
 				rz_cons_printf ("%s\n", m);
 			} else {
 				if (show_color) {
-					const char *offsetColor = rz_cons_singleton ()->context->pal.offset; // TODO etooslow. must cache
+					const char *offsetColor = rz_cons_context ()->pal.offset; // TODO etooslow. must cache
 					rz_cons_printf ("%s0x%08"PFMT64x""Color_RESET"  %10s %s\n",
 							offsetColor, addr + p, "", m);
 				} else {
@@ -6838,7 +6891,7 @@ RZ_API void rz_print_offset_sg(RzPrint *p, ut64 off, int invert, int offseg, int
 	bool show_color = p->flags & RZ_PRINT_FLAGS_COLOR;
 	if (show_color) {
 		char rgbstr[32];
-		const char *k = rz_cons_singleton ()->context->pal.offset; // TODO etooslow. must cache
+		const char *k = rz_cons_context ()->pal.offset; // TODO etooslow. must cache
 		const char *inv = invert ? RZ_CONS_INVERT (true, true) : "";
 		if (p->flags & RZ_PRINT_FLAGS_RAINBOW) {
 			k = rz_cons_rgb_str_off (rgbstr, sizeof (rgbstr), off);
@@ -10,6 +10,22 @@ RZ_IPI RzCmdStatus rz_project_save_handler(RzCore *core, int argc, const char **
 	return RZ_CMD_STATUS_OK;
 }
 
+RZ_IPI RzCmdStatus rz_project_save_bin_handler(RzCore *core, int argc, const char **argv) {
+	RzProjectErr err = rz_project_save_file_bin (core, argv[1]);
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		eprintf ("Failed to save project: %s\n", rz_project_err_message (err));
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
+RZ_IPI RzCmdStatus rz_project_convert_handler(RzCore *core, int argc, const char **argv) {
+	RzProjectErr err = rz_project_convert_file (argv[1], argv[2]);
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		eprintf ("Failed to convert project: %s\n", rz_project_err_message (err));
+	}
+	return RZ_CMD_STATUS_OK;
+}
+
 static RzCmdStatus project_open(RzCore *core, int args, const char **argv, bool load_bin_io) {
 	RzSerializeResultInfo *res = rz_serialize_result_info_new ();
 	RzProjectErr err = rz_project_load_file (core, argv[1], load_bin_io, res);
@@ -1228,7 +1228,7 @@ static void print_rop(RzCore *core, RzList *hitlist, char mode, bool *json_first
 				rz_cons_printf ("%s\n", opstr);
 			} else if (colorize) {
 				buf_asm = rz_print_colorize_opcode (core->print, rz_asm_op_get_asm (&asmop),
-					core->cons->context->pal.reg, core->cons->context->pal.num, false, 0);
+					rz_cons_context ()->pal.reg, rz_cons_context ()->pal.num, false, 0);
 				rz_cons_printf (" %s%s;", buf_asm, Color_RESET);
 				free (buf_asm);
 			} else {
@@ -1268,7 +1268,7 @@ static void print_rop(RzCore *core, RzList *hitlist, char mode, bool *json_first
 			char *asm_op_hex = rz_asm_op_get_hex (&asmop);
 			if (colorize) {
 				char *buf_asm = rz_print_colorize_opcode (core->print, rz_asm_op_get_asm (&asmop),
-					core->cons->context->pal.reg, core->cons->context->pal.num, false, 0);
+					rz_cons_context ()->pal.reg, rz_cons_context ()->pal.num, false, 0);
 				otype = rz_print_color_op_type (core->print, analop.type);
 				if (comment) {
 					rz_cons_printf ("  0x%08"PFMT64x " %18s%s  %s%s ; %s\n",
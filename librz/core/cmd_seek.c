@@ -394,7 +394,7 @@ RZ_IPI int rz_cmd_seek(void *data, const char *input) {
 	{
 		ut64 addr = rz_num_math (core->num, input + 1);
 		if (core->num->nc.errors) {
-			if (rz_cons_singleton ()->context->is_interactive) {
+			if (rz_cons_context ()->is_interactive) {
 				eprintf ("Cannot seek to unknown address '%s'\n", core->num->nc.calc_buf);
 			}
 			break;
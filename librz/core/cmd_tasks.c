@@ -4,16 +4,49 @@
 #include <rz_core.h>
 #include "cmd_descs.h"
 
-static int task_enqueue(RzCore *core, const char *cmd, bool transient) {
+// Commands that &r runs: they only read the analysis, flags or their
+// arguments, without seek, block, numbers, temporary seeks, pipes or
+// subcommands, so they can share the core. The names are matched exactly and
+// only ?e takes arguments, the others would go through core->num.
+static bool task_cmd_pure(const char *cmd) {
+	static const char *names[] = {
+		"afl", "aflj", "aflc", "afll", "afllj", "ax", "axj", "f", "fj", NULL
+	};
+	if (strpbrk (cmd, ";|>@`$")) {
+		return false;
+	}
+	size_t len = strcspn (cmd, " ~");
+	if (len == 2 && !strncmp (cmd, "?e", 2)) {
+		return true;
+	}
+	const char *rest = rz_str_trim_head_ro (cmd + len);
+	if (*rest && *rest != '~') {
+		return false;
+	}
+	int i;
+	for (i = 0; names[i]; i++) {
+		if (strlen (names[i]) == len && !strncmp (cmd, names[i], len)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static int task_enqueue(RzCore *core, const char *cmd, bool transient, bool parallel) {
 	if (rz_sandbox_enable (0)) {
 		eprintf ("This command is disabled in sandbox mode\n");
 		return -1;
 	}
+	if (parallel && !task_cmd_pure (cmd)) {
+		eprintf ("Only commands that read the core without seeking can run in parallel, use & to run \"%s\"\n", cmd);
+		return -1;
+	}
 	RzCoreTask *task = rz_core_task_new (core, true, cmd, NULL, core);
 	if (!task) {
 		return -1;
 	}
 	task->transient = transient;
+	task->parallel = parallel;
 	rz_core_task_enqueue (&core->tasks, task);
 	return 0;
 }
@@ -40,7 +73,7 @@ static int task_break(RzCore *core, int tid) {
 		eprintf ("This command is disabled in sandbox mode\n");
 		return -1;
 	}
-	if (tid) {
+	if (!tid) {
 		return -1;
 	}
 	rz_core_task_break (&core->tasks, tid);
@@ -52,13 +85,17 @@ RZ_IPI RzCmdStatus rz_tasks_handler(RzCore *core, int argc, const char **argv, R
 		rz_core_task_list (core, mode == RZ_OUTPUT_MODE_STANDARD ? '\0' : 'j');
 		return RZ_CMD_STATUS_OK;
 	} else if (argc == 2) {
-		return rz_cmd_int2status (task_enqueue (core, argv[1], false));
+		return rz_cmd_int2status (task_enqueue (core, argv[1], false, false));
 	}
 	return RZ_CMD_STATUS_ERROR;
 }
 
 RZ_IPI RzCmdStatus rz_tasks_transient_handler(RzCore *core, int argc, const char **argv) {
-	return rz_cmd_int2status (task_enqueue (core, argv[1], true));
+	return rz_cmd_int2status (task_enqueue (core, argv[1], true, false));
+}
+
+RZ_IPI RzCmdStatus rz_tasks_parallel_handler(RzCore *core, int argc, const char **argv) {
+	return rz_cmd_int2status (task_enqueue (core, argv[1], false, true));
 }
 
 RZ_IPI RzCmdStatus rz_tasks_output_handler(RzCore *core, int argc, const char **argv) {
@@ -1,6 +1,7 @@
 /* rizin - LGPL - Copyright 2009-2020 - pancake */
 
 #include <rz_core.h>
+#include <rz_project.h>
 #include <rz_socket.h>
 #include <config.h>
 #include <rz_util.h>
@@ -1817,7 +1818,7 @@ RZ_API int rz_core_fgets(char *buf, int len, void *user) {
 	RzCore *core = (RzCore *)user;
 	RzCons *cons = rz_cons_singleton ();
 	RzLine *rzli = cons->line;
-	bool prompt = cons->context->is_interactive;
+	bool prompt = rz_cons_context ()->is_interactive;
 	buf[0] = '\0';
 	if (prompt) {
 		if (core->use_newshell_autocompletion) {
@@ -2167,7 +2168,7 @@ RZ_API char *rz_core_analysis_hasrefs_to_depth(RzCore *core, ut64 value, PJ *pj,
 	}
 	{
 		ut8 buf[128], widebuf[256];
-		const char *c = rz_config_get_i (core->config, "scr.color")? core->cons->context->pal.ai_ascii: "";
+		const char *c = rz_config_get_i (core->config, "scr.color")? rz_cons_context ()->pal.ai_ascii: "";
 		const char *cend = (c && *c) ? Color_RESET: "";
 		int len, r;
 		if (rz_io_read_at (core->io, value, buf, sizeof (buf))) {
@@ -2252,19 +2253,19 @@ RZ_API const char *rz_core_analysis_optype_colorfor(RzCore *core, ut64 addr, boo
 	}
 	type = rz_core_analysis_address (core, addr);
 	if (type & RZ_ANALYSIS_ADDR_TYPE_EXEC) {
-		return core->cons->context->pal.ai_exec; //Color_RED;
+		return rz_cons_context ()->pal.ai_exec; //Color_RED;
 	}
 	if (type & RZ_ANALYSIS_ADDR_TYPE_WRITE) {
-		return core->cons->context->pal.ai_write; //Color_BLUE;
+		return rz_cons_context ()->pal.ai_write; //Color_BLUE;
 	}
 	if (type & RZ_ANALYSIS_ADDR_TYPE_READ) {
-		return core->cons->context->pal.ai_read; //Color_GREEN;
+		return rz_cons_context ()->pal.ai_read; //Color_GREEN;
 	}
 	if (type & RZ_ANALYSIS_ADDR_TYPE_SEQUENCE) {
-		return core->cons->context->pal.ai_seq; //Color_MAGENTA;
+		return rz_cons_context ()->pal.ai_seq; //Color_MAGENTA;
 	}
 	if (type & RZ_ANALYSIS_ADDR_TYPE_ASCII) {
-		return core->cons->context->pal.ai_ascii; //Color_YELLOW;
+		return rz_cons_context ()->pal.ai_ascii; //Color_YELLOW;
 	}
 	return NULL;
 }
@@ -2452,16 +2453,39 @@ static int win_eprintf(const char *format, ...) {
 }
 #endif
 
+static void iowrite_vaddr(RzCore *core, ut64 addr, int len, bool detect) {
+	rz_analysis_op_cache_invalidate (core->analysis, addr, len);
+	if (detect) {
+		rz_analysis_update_analysis_range (core->analysis, addr, len);
+	}
+}
+
 static void ev_iowrite_cb(RzEvent *ev, int type, void *user, void *data) {
 	RzCore *core = user;
 	RzEventIOWrite *iow = data;
-	if (rz_config_get_i (core->config, "analysis.detectwrites")) {
-		rz_analysis_update_analysis_range (core->analysis, iow->addr, iow->len);
-		if (core->cons->event_resize && core->cons->event_data) {
-			// Force a reload of the graph
-			core->cons->event_resize (core->cons->event_data);
+	bool detect = rz_config_get_i (core->config, "analysis.detectwrites");
+	if (iow->fd < 0 || !core->io->va) {
+		iowrite_vaddr (core, iow->addr, iow->len, detect);
+	} else if (iow->len > 0) {
+		// the desc was written at a physical address, which shows up in
+		// every map of it covering the write
+		ut64 pend = iow->addr + iow->len;
+		void **it;
+		rz_pvector_foreach (&core->io->maps, it) {
+			RzIOMap *map = *it;
+			ut64 mend = map->delta + rz_itv_size (map->itv);
+			if (map->fd != iow->fd || map->delta >= pend || mend <= iow->addr) {
+				continue;
+			}
+			ut64 from = RZ_MAX (map->delta, iow->addr);
+			ut64 to = RZ_MIN (mend, pend);
+			iowrite_vaddr (core, rz_itv_begin (map->itv) + (from - map->delta), (int)(to - from), detect);
 		}
 	}
+	if (detect && core->cons->event_resize && core->cons->event_data) {
+		// Force a reload of the graph
+		core->cons->event_resize (core->cons->event_data);
+	}
 }
 
 RZ_API bool rz_core_init(RzCore *core) {
@@ -2706,6 +2730,7 @@ RZ_API void rz_core_fini(RzCore *c) {
 	//update_sdb (c);
 	// avoid double free
 	rz_list_free (c->ropchain);
+	rz_project_bin_free (c->prj_bin);
 	rz_event_free (c->ev);
 	free (c->cmdlog);
 	free (c->lastsearch);
@@ -2851,8 +2876,8 @@ static void set_prompt (RzCore *r) {
 	}
 
 	if (rz_config_get_i (r->config, "scr.color")) {
-		BEGIN = r->cons->context->pal.prompt;
-		END = r->cons->context->pal.reset;
+		BEGIN = rz_cons_context ()->pal.prompt;
+		END = rz_cons_context ()->pal.reset;
 	}
 
 	// TODO: also in visual prompt and disasm/hexdump ?
@@ -563,8 +563,8 @@ static RDisasmState * ds_init(RzCore *core) {
 	}
 	ds->core = core;
 	ds->strip = rz_config_get (core->config, "asm.strip");
-	ds->pal_comment = core->cons->context->pal.comment;
-	#define P(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
+	ds->pal_comment = rz_cons_context ()->pal.comment;
+	#define P(x) (core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 	ds->color_comment = P(comment): Color_CYAN;
 	ds->color_usrcmt = P(usercomment): Color_CYAN;
 	ds->color_fname = P(fname): Color_RED;
@@ -1658,7 +1658,7 @@ static void ds_show_functions_argvar(RDisasmState *ds, RzAnalysisFunction *fcn,
 }
 
 static void printVarSummary(RDisasmState *ds, RzList *list) {
-	const char *numColor = ds->core->cons->context->pal.num;
+	const char *numColor = rz_cons_context ()->pal.num;
 	RzAnalysisVar *var;
 	RzListIter *iter;
 	int bp_vars = 0;
@@ -3307,8 +3307,8 @@ static void ds_print_import_name(RDisasmState *ds) {
 	case RZ_ANALYSIS_OP_TYPE_JMP:
 	case RZ_ANALYSIS_OP_TYPE_CJMP:
 	case RZ_ANALYSIS_OP_TYPE_CALL:
-		if (core->bin->cur->o->imports && core->bin->cur->o->relocs) {
-			rz_list_foreach (core->bin->cur->o->relocs, iter, rel) {
+		if (rz_bin_file_get_imports (core->bin->cur) && rz_bin_file_get_relocs (core->bin->cur)) {
+			rz_list_foreach (rz_bin_file_get_relocs (core->bin->cur), iter, rel) {
 				if ((rel->vaddr == ds->analop.jump) &&
 					(rel->import != NULL)) {
 					if (ds->show_color) {
@@ -5235,6 +5235,9 @@ toro:
 			ds_free (ds);
 			return 0; //break;
 		}
+		if (!core->vmode) {
+			rz_cons_stream_flush ();
+		}
 		if (core->print->flags & RZ_PRINT_FLAGS_UNALLOC) {
 			if (!core->analysis->iob.is_valid_offset (core->analysis->iob.io, ds->at, 0)) {
 				ds_begin_line (ds);
@@ -6265,7 +6268,7 @@ RZ_API int rz_core_print_disasm_all(RzCore *core, ut64 addr, int l, int len, int
 					RzAnalysisFunction *f = fcnIn (ds, ds->vat, RZ_ANALYSIS_FCN_TYPE_NULL);
 					rz_analysis_op (core->analysis, &aop, addr, buf+i, l-i, RZ_ANALYSIS_OP_MASK_ALL);
 					char *buf_asm = rz_print_colorize_opcode (core->print, str,
-							core->cons->context->pal.reg, core->cons->context->pal.num, false, f ? f->addr : 0);
+							rz_cons_context ()->pal.reg, rz_cons_context ()->pal.num, false, f ? f->addr : 0);
 					if (buf_asm) {
 						rz_cons_printf ("%s%s\n", rz_print_color_op_type (core->print, aop.type), buf_asm);
 						free (buf_asm);
@@ -6613,22 +6616,14 @@ RZ_API int rz_core_disasm_pde(RzCore *core, int nb_opcodes, int mode) {
 		}
 	}
 	RzAnalysisEsil *esil = core->analysis->esil;
-	RzPVector ocache = core->io->cache;
 	RzCache *ocacheb = core->io->buffer;
 	const int ocached = core->io->cached;
-	if (ocache.v.a) {
-		if (ocacheb && ocacheb->len) {
-			RzCache *c = rz_cache_new ();
-			rz_cache_set (c, ocacheb->base, ocacheb->buf, ocacheb->len);
-			core->io->buffer = c;
-		}
-		RzPVector *vec = (RzPVector *)rz_vector_clone ((RzVector *)&ocache);
-		vec->v.free = NULL;
-		core->io->cache = *vec;
-		free (vec);
-	} else {
-		rz_io_cache_init (core->io);
+	if (ocacheb && ocacheb->len) {
+		RzCache *c = rz_cache_new ();
+		rz_cache_set (c, ocacheb->base, ocacheb->buf, ocacheb->len);
+		core->io->buffer = c;
 	}
+	rz_io_cache_push (core->io);
 	rz_reg_arena_push (reg);
 	RzConfigHold *chold = rz_config_hold_new (core->config);
 	rz_config_hold_i (chold, "io.cache", "asm.lines", NULL);
@@ -6727,22 +6722,9 @@ RZ_API int rz_core_disasm_pde(RzCore *core, int nb_opcodes, int mode) {
 	}
 	free (buf);
 	rz_reg_arena_pop (reg);
-	int len = rz_pvector_len (&ocache);
-	if (rz_pvector_len (&core->io->cache) > len) {
-		// TODO: Implement push/pop for IO.cache
-		while (len > 0) {
-			(void)rz_pvector_pop_front (&core->io->cache);
-			len--;
-		}
-		core->io->cache.v.free = ocache.v.free;
-	}
-	rz_io_cache_fini (core->io);
-	core->io->cache = ocache;
-	rz_skyline_clear (&core->io->cache_skyline);
-	void **it;
-	rz_pvector_foreach (&ocache, it) {
-		RzIOCache *c = (RzIOCache *)*it;
-		rz_skyline_add (&core->io->cache_skyline, c->itv, c);
+	rz_io_cache_pop (core->io);
+	if (core->io->buffer != ocacheb) {
+		rz_cache_free (core->io->buffer);
 	}
 	core->io->buffer = ocacheb;
 	core->io->cached = ocached;
@@ -22,6 +22,8 @@ RZ_API int rz_core_gdiff_fcn(RzCore *c, ut64 addr, ut64 addr2) {
 	rz_list_foreach (fb->bbs, iter, bb) {
 		rz_analysis_diff_fingerprint_bb (c->analysis, bb);
 	}
+	rz_analysis_diff_fingerprint_fcn (c->analysis, fa);
+	rz_analysis_diff_fingerprint_fcn (c->analysis, fb);
 	la = rz_list_new ();
 	rz_list_append (la, fa);
 	lb = rz_list_new ();
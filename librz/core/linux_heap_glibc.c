@@ -239,7 +239,7 @@ static void GH(print_arena_stats)(RzCore *core, GHT m_arena, MallocState *main_a
 	size_t i, j, k, start;
 	GHT align = 12 * SZ + sizeof (int) * 2;
 	const int tcache = rz_config_get_i (core->config, "dbg.glibc.tcache");
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (tcache) {
 		align = 16;
@@ -479,7 +479,7 @@ static bool GH(rz_resolve_main_arena)(RzCore *core, GHT *m_arena) {
 void GH(print_heap_chunk)(RzCore *core) {
 	GH(RzHeapChunk) *cnk = RZ_NEW0 (GH(RzHeapChunk));
 	GHT chunk = core->offset;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (!cnk) {
 		return;
@@ -564,7 +564,7 @@ static int GH(print_double_linked_list_bin_simple)(RzCore *core, GHT bin, Malloc
 	GHT next = GHT_MAX;
 	int ret = 1;
 	GH(RzHeapChunk) *cnk = RZ_NEW0 (GH(RzHeapChunk));
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (!cnk) {
 		return -1;
@@ -620,7 +620,7 @@ static int GH(print_double_linked_list_bin_graph)(RzCore *core, GHT bin, MallocS
 	char title[256], chunk[256];
 	RzANode *bin_node = NULL, *prev_node = NULL, *next_node = NULL;
 	GH(RzHeapChunk) *cnk = RZ_NEW0 (GH(RzHeapChunk));
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (!cnk || !g) {
 		free (cnk);
@@ -670,7 +670,7 @@ static int GH(print_double_linked_list_bin)(RzCore *core, MallocState *main_aren
 	}
 	int ret = 0;
 	GHT brk_start = GHT_MAX, brk_end = GHT_MAX, initial_brk = GHT_MAX;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (num_bin > 126) {
 		return -1;
@@ -722,7 +722,7 @@ static void GH(print_heap_bin)(RzCore *core, GHT m_arena, MallocState *main_aren
 	int i, j = 2;
 	GHT num_bin = GHT_MAX;
 	GHT offset;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	const int tcache = rz_config_get_i (core->config, "dbg.glibc.tcache");
 	if (tcache) {
@@ -760,7 +760,7 @@ static int GH(print_single_linked_list_bin)(RzCore *core, MallocState *main_aren
 		return -1;
 	}
 	GHT next = GHT_MAX, brk_start = GHT_MAX, brk_end = GHT_MAX;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	GH(RzHeapChunk) *cnk = RZ_NEW0 (GH(RzHeapChunk));
 	if (!cnk) {
@@ -844,7 +844,7 @@ void GH(print_heap_fastbin)(RzCore *core, GHT m_arena, MallocState *main_arena,
 	int i;
 	GHT num_bin = GHT_MAX, offset = sizeof (int) * 2;
 	const int tcache = rz_config_get_i (core->config, "dbg.glibc.tcache");
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (tcache) {
 		offset = 16;
@@ -929,7 +929,7 @@ static void GH (tcache_print) (RzCore *core, GH (RTcache)* tcache, bool demangle
 	rz_return_if_fail (core && tcache);
 	GHT tcache_fd = GHT_MAX;
 	GHT tcache_tmp = GHT_MAX;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	size_t i;
 	for (i = 0; i < TCACHE_MAX_BINS; i++) {
 		int count = GH (tcache_get_count) (tcache, i);
@@ -972,7 +972,7 @@ static void GH (print_tcache_instance)(RzCore *core, GHT m_arena, MallocState *m
 	GHT brk_start = GHT_MAX, brk_end = GHT_MAX, initial_brk = GHT_MAX;
 	GH (get_brks) (core, &brk_start, &brk_end);
 	GHT tcache_start = GHT_MAX;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	tcache_start = brk_start + 0x10;
 	GHT fc_offset = GH (tcache_chunk_size) (core, brk_start);
@@ -1041,7 +1041,7 @@ static void GH(print_heap_segment)(RzCore *core, MallocState *main_arena,
 
 	const int tcache = rz_config_get_i (core->config, "dbg.glibc.tcache");
 	const int offset = rz_config_get_i (core->config, "dbg.glibc.fc_offset");
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	int glibc_version = core->dbg->glibc_version;
 
 	if (m_arena == m_state) {
@@ -1364,7 +1364,7 @@ static void GH(print_heap_segment)(RzCore *core, MallocState *main_arena,
 
 void GH(print_malloc_states)( RzCore *core, GHT m_arena, MallocState *main_arena) {
 	MallocState *ta = RZ_NEW0 (MallocState);
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (!ta) {
 		return;
@@ -1391,7 +1391,7 @@ void GH(print_malloc_states)( RzCore *core, GHT m_arena, MallocState *main_arena
 }
 
 void GH(print_inst_minfo)(GH(RzHeapInfo) *heap_info, GHT hinfo) {
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	PRINT_YA ("malloc_info @ ");
 	PRINTF_BA ("0x%"PFMT64x, (ut64)hinfo);
@@ -1408,7 +1408,7 @@ void GH(print_inst_minfo)(GH(RzHeapInfo) *heap_info, GHT hinfo) {
 
 void GH(print_malloc_info)(RzCore *core, GHT m_state, GHT malloc_state) {
 	GHT h_info;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (malloc_state == m_state) {
 		PRINT_RA ("main_arena does not have an instance of malloc_info\n");
@@ -1470,7 +1470,7 @@ static const char* GH(help_msg)[] = {
 
 static int GH(cmd_dbg_map_heap_glibc)(RzCore *core, const char *input) {
 	static GHT m_arena = GHT_MAX, m_state = GHT_MAX;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	GHT global_max_fast = (64 * SZ / 4);
 
@@ -118,7 +118,7 @@ static bool GH(rz_resolve_jemalloc)(RzCore *core, char *symname, ut64 *symbol) {
 
 static void GH(jemalloc_get_chunks)(RzCore *core, const char *input) {
 	ut64 cnksz;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	if (!GH(rz_resolve_jemalloc)(core, "je_chunksize", &cnksz)) {
 		eprintf ("Fail at read symbol je_chunksize\n");
@@ -239,7 +239,7 @@ static void GH(jemalloc_print_narenas)(RzCore *core, const char *input) {
 	}
 	int i = 0;
 	GHT narenas = 0;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	switch (input[0]) {
 	case '\0':
@@ -329,7 +329,7 @@ static void GH(jemalloc_get_bins)(RzCore *core, const char *input) {
 	GHT arena = GHT_MAX; //, bin = GHT_MAX;
 	arena_t *ar = NULL;
 	arena_bin_info_t *b = NULL;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 
 	switch (input[0]) {
 	case ' ':
@@ -788,7 +788,7 @@ char *__search_db(RzCore *core, const char *title) {
 
 int __show_status(RzCore *core, const char *msg) {
 	rz_cons_gotoxy (0, 0);
-	rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, core->cons->context->pal.graph_box2, msg);
+	rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, rz_cons_context ()->pal.graph_box2, msg);
 	rz_cons_flush ();
 	return rz_cons_readchar ();
 }
@@ -796,11 +796,11 @@ int __show_status(RzCore *core, const char *msg) {
 bool __show_status_yesno(RzCore *core, int def, const char *msg) {
 	rz_cons_gotoxy (0, 0);
 	rz_cons_flush ();
-	return rz_cons_yesno (def, RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, core->cons->context->pal.graph_box2, msg);
+	return rz_cons_yesno (def, RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, rz_cons_context ()->pal.graph_box2, msg);
 }
 
 char *__show_status_input(RzCore *core, const char *msg) {
-	char *n_msg = rz_str_newf (RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, core->cons->context->pal.graph_box2, msg);
+	char *n_msg = rz_str_newf (RZ_CONS_CLEAR_LINE"%s[Status] %s"Color_RESET, rz_cons_context ()->pal.graph_box2, msg);
 	rz_cons_gotoxy (0, 0);
 	rz_cons_flush ();
 	char *out = rz_cons_input (n_msg);
@@ -990,9 +990,9 @@ void __panel_print(RzCore *core, RzConsCanvas *can, RzPanel *panel, int color) {
 	w = RZ_MIN (panel->view->pos.w, can->w - panel->view->pos.x);
 	h = RZ_MIN (panel->view->pos.h, can->h - panel->view->pos.y);
 	if (color) {
-		rz_cons_canvas_box (can, panel->view->pos.x, panel->view->pos.y, w, h, core->cons->context->pal.graph_box2);
+		rz_cons_canvas_box (can, panel->view->pos.x, panel->view->pos.y, w, h, rz_cons_context ()->pal.graph_box2);
 	} else {
-		rz_cons_canvas_box (can, panel->view->pos.x, panel->view->pos.y, w, h, core->cons->context->pal.graph_box);
+		rz_cons_canvas_box (can, panel->view->pos.x, panel->view->pos.y, w, h, rz_cons_context ()->pal.graph_box);
 	}
 }
 
@@ -1046,9 +1046,9 @@ void __update_help_title(RzCore *core, RzPanel *panel) {
 	RzStrBuf *cache_title = rz_strbuf_new (NULL);
 	if (__check_if_cur_panel (core, panel)) {
 		rz_strbuf_setf (title, "%s[X] %s"Color_RESET,
-				core->cons->context->pal.graph_box2, panel->model->title);
+				rz_cons_context ()->pal.graph_box2, panel->model->title);
 		rz_strbuf_setf (cache_title, "%s[Cache] N/A"Color_RESET,
-				core->cons->context->pal.graph_box2);
+				rz_cons_context ()->pal.graph_box2);
 	} else {
 		rz_strbuf_setf (title, "[X]   %s   ", panel->model->title);
 		rz_strbuf_setf (cache_title, "[Cache] N/A");
@@ -1115,11 +1115,11 @@ void __update_panel_title(RzCore *core, RzPanel *panel) {
 	char *cmd_title  = __apply_filter_cmd (core, panel);
 	if (__check_if_cur_panel (core, panel)) {
 		if (!strcmp (panel->model->title, cmd_title)) {
-			rz_strbuf_setf (title, "%s[X] %s"Color_RESET, core->cons->context->pal.graph_box2, panel->model->title);
+			rz_strbuf_setf (title, "%s[X] %s"Color_RESET, rz_cons_context ()->pal.graph_box2, panel->model->title);
 		}  else {
-			rz_strbuf_setf (title, "%s[X] %s (%s)"Color_RESET, core->cons->context->pal.graph_box2, panel->model->title, cmd_title);
+			rz_strbuf_setf (title, "%s[X] %s (%s)"Color_RESET, rz_cons_context ()->pal.graph_box2, panel->model->title, cmd_title);
 		}
-		rz_strbuf_setf (cache_title, "%s[Cache] %s"Color_RESET, core->cons->context->pal.graph_box2, panel->model->cache ? "On" : "Off");
+		rz_strbuf_setf (cache_title, "%s[Cache] %s"Color_RESET, rz_cons_context ()->pal.graph_box2, panel->model->cache ? "On" : "Off");
 	} else {
 		if (!strcmp (panel->model->title, cmd_title)) {
 			rz_strbuf_setf (title, "[X]   %s   ", panel->model->title);
@@ -4246,7 +4246,7 @@ RzStrBuf *__draw_menu(RzCore *core, RzPanelsMenuItem *item) {
 	for (i = 0; i < item->n_sub; i++) {
 		if (i == item->selectedIndex) {
 			rz_strbuf_appendf (buf, "%s> %s"Color_RESET,
-					core->cons->context->pal.graph_box2, item->sub[i]->name);
+					rz_cons_context ()->pal.graph_box2, item->sub[i]->name);
 		} else {
 			rz_strbuf_appendf (buf, "  %s", item->sub[i]->name);
 		}
@@ -4292,7 +4292,7 @@ void __init_menu_saved_layout (void *_core, const char *parent) {
 
 void __init_menu_color_settings_layout (void *_core, const char *parent) {
 	RzCore *core = (RzCore *)_core;
-	const char *color = core->cons->context->pal.graph_box2;
+	const char *color = rz_cons_context ()->pal.graph_box2;
 	char *now = rz_core_cmd_str (core, "eco.");
 	rz_str_split (now, '\n');
 	parent = "Settings.Colors";
@@ -4756,7 +4756,7 @@ void __panels_refresh(RzCore *core) {
 	}
 	(void) rz_cons_canvas_gotoxy (can, -can->sx, -can->sy);
 	rz_cons_canvas_fill (can, -can->sx, -can->sy, w, 1, ' ');
-	const char *color = core->cons->context->pal.graph_box2;
+	const char *color = rz_cons_context ()->pal.graph_box2;
 	if (panels->mode == PANEL_MODE_ZOOM) {
 		rz_strbuf_appendf (title, "%s Zoom Mode | Press Enter or q to quit"Color_RESET, color);
 	} else if (panels->mode == PANEL_MODE_WINDOW) {
@@ -5740,7 +5740,7 @@ void __update_modal(RzCore *core, Sdb *menu_db, RModal *modal) {
 	rz_cons_canvas_write (can, rz_strbuf_get (modal->data));
 	rz_strbuf_free (modal->data);
 
-	rz_cons_canvas_box (can, modal->pos.x, modal->pos.y, modal->pos.w + 2, modal->pos.h + 2, core->cons->context->pal.graph_box2);
+	rz_cons_canvas_box (can, modal->pos.x, modal->pos.y, modal->pos.w + 2, modal->pos.h + 2, rz_cons_context ()->pal.graph_box2);
 
 	rz_cons_canvas_print (can);
 	rz_cons_flush ();
@@ -5754,7 +5754,7 @@ bool __draw_modal (RzCore *core, RModal *modal, int range_end, int start, const
 		return false;
 	}
 	if (start == modal->idx) {
-		rz_strbuf_appendf (modal->data, ">  %s%s"Color_RESET, core->cons->context->pal.graph_box2, name);
+		rz_strbuf_appendf (modal->data, ">  %s%s"Color_RESET, rz_cons_context ()->pal.graph_box2, name);
 	} else {
 		rz_strbuf_appendf (modal->data, "   %s", name);
 	}
@@ -6158,11 +6158,11 @@ void __del_panels(RzCore *core) {
 void __handle_tab(RzCore *core) {
 	rz_cons_gotoxy (0, 0);
 	if (core->panels_root->n_panels <= 1) {
-		rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Tab] t:new T:new with current panel -:del =:name"Color_RESET, core->cons->context->pal.graph_box2);
+		rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Tab] t:new T:new with current panel -:del =:name"Color_RESET, rz_cons_context ()->pal.graph_box2);
 	} else {
 		int min = 1;
 		int max = core->panels_root->n_panels;
-		rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Tab] [%d..%d]:select; p:prev; n:next; t:new T:new with current panel -:del =:name"Color_RESET, core->cons->context->pal.graph_box2, min, max);
+		rz_cons_printf (RZ_CONS_CLEAR_LINE"%s[Tab] [%d..%d]:select; p:prev; n:next; t:new T:new with current panel -:del =:name"Color_RESET, rz_cons_context ()->pal.graph_box2, min, max);
 	}
 	rz_cons_flush ();
 	int ch = rz_cons_readchar ();
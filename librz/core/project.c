@@ -31,6 +31,8 @@ RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err) {
 }
 
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file) {
+	// also unmaps the binary project, which may be the file saved to
+	rz_project_bin_load_rest (core);
 	sdb_set (prj, RZ_DB_KEY_TYPE, RZ_DB_PROJECT_TYPE, 0);
 	sdb_set (prj, RZ_DB_KEY_VERSION, sdb_fmt ("%u", RZ_DB_PROJECT_VERSION), 0);
 	rz_serialize_core_save (sdb_ns (prj, "core", true), core, file);
@@ -54,7 +56,10 @@ RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file) {
 	return err;
 }
 
-RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_io, RZ_NULLABLE const char *file, RzSerializeResultInfo *res) {
+/**
+ * \brief Check the type and version of an sdb project
+ */
+RZ_API RzProjectErr rz_project_check(RzProject *prj) {
 	const char *type = sdb_const_get (prj, RZ_DB_KEY_TYPE, 0);
 	if (!type || strcmp (type, RZ_DB_PROJECT_TYPE) != 0) {
 		return RZ_PROJECT_ERR_INVALID_TYPE;
@@ -69,6 +74,17 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
 	} else if (version > RZ_DB_PROJECT_VERSION) {
 		return RZ_PROJECT_ERR_NEWER_VERSION;
 	}
+	return RZ_PROJECT_ERR_SUCCESS;
+}
+
+RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_io, RZ_NULLABLE const char *file, RzSerializeResultInfo *res) {
+	RzProjectErr err = rz_project_check (prj);
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		return err;
+	}
+
+	rz_project_bin_free (core->prj_bin);
+	core->prj_bin = NULL;
 
 	Sdb *core_db = sdb_ns (prj, "core", false);
 	if (!core_db) {
@@ -85,6 +101,21 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
 }
 
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res) {
+	if (rz_project_bin_is_file (file)) {
+		RzProjectErr err;
+		RzProjectBin *pb = rz_project_bin_open (file, &err);
+		if (!pb) {
+			SERIALIZE_ERR ("failed to read binary project file");
+			return err;
+		}
+		// read before the project config overwrites it
+		bool lazy = rz_config_get_i (core->config, "prj.lazy");
+		err = rz_project_bin_load (core, pb, load_bin_io, file, lazy, res);
+		if (err != RZ_PROJECT_ERR_SUCCESS) {
+			rz_project_bin_free (pb);
+		}
+		return err;
+	}
 	RzProject *prj = sdb_new0 ();
 	if (!prj) {
 		return RZ_PROJECT_ERR_UNKNOWN;
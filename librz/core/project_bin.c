@@ -0,0 +1,970 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_project.h>
+
+#include "../util/serialize_helper.h"
+
+/*
+ * Binary project format, the same contents as the sdb project laid out in
+ * fixed-size tables that can be used right from a mmapped file. All numbers
+ * are little endian, str is an offset into the STRINGS section.
+ *
+ * header:
+ *   "RZPB" version:ut32 nsections:ut32 reserved:ut32
+ *   nsections * {id:ut32 entsize:ut32 offset:ut64 count:ut64}
+ *
+ * sections, 8 byte aligned:
+ *   STRINGS   NUL-terminated strings, offset 0 is ""
+ *   SDB       {ns:str key:str value:str reserved:ut32}
+ *             every key of the sdb project that is not in a table below. ns is
+ *             the namespace path joined by '/', key 0 only marks the namespace.
+ *   XREFS     {from:ut64 to:ut64 type:ut32 reserved:ut32}
+ *   BLOCKS    {addr size jump fail cmpval:ut64 ninstr stackptr parent_stackptr:st32
+ *              colorize flags cmpreg:str op_pos npos:ut32 json:str reserved:ut32}
+ *             op_pos indexes npos entries of OP_POS. Blocks with a fingerprint,
+ *             diff or switch op keep their sdb json in json instead.
+ *   OP_POS    ut16
+ *   FUNCTIONS {addr:ut64 name:str json:str bbs nbbs:ut32}
+ *             json is the sdb json of the function, bbs indexes nbbs block
+ *             addresses of BBS
+ *   BBS       ut64
+ *   FLAGS     {offset size:ut64 name realname space color comment alias:str
+ *              demangled reserved:ut32}
+ *   META      {addr size:ut64 type:ut32 subtype:st32 str space:str}
+ *
+ * All the tables but SDB are sorted by their first field, so the records of
+ * an address range can be found with a binary search and loaded on their own.
+ */
+
+#define PB_MAGIC "RZPB"
+#define PB_VERSION 1
+#define PB_HEADER_SIZE 16
+#define PB_SECTION_SIZE 24
+
+typedef enum {
+	PB_STRINGS,
+	PB_SDB,
+	PB_XREFS,
+	PB_BLOCKS,
+	PB_OP_POS,
+	PB_FUNCTIONS,
+	PB_BBS,
+	PB_FLAGS,
+	PB_META,
+	PB_COUNT
+} PBSection;
+
+static const ut32 pb_entsize[PB_COUNT] = {
+	[PB_STRINGS] = 1,
+	[PB_SDB] = 16,
+	[PB_XREFS] = 24,
+	[PB_BLOCKS] = 80,
+	[PB_OP_POS] = 2,
+	[PB_FUNCTIONS] = 24,
+	[PB_BBS] = 8,
+	[PB_FLAGS] = 48,
+	[PB_META] = 32,
+};
+
+#define BLOCK_TRACED 1
+#define BLOCK_FOLDED 2
+
+struct rz_project_bin_t {
+	RMmap *map;
+	const ut8 *buf;
+	ut64 size;
+	const ut8 *sections[PB_COUNT];
+	ut64 counts[PB_COUNT];
+	// records already loaded by rz_project_bin_load_range (), per section
+	ut8 *loaded[PB_COUNT];
+};
+
+/* writer */
+
+typedef struct {
+	RzStrBuf strings;
+	HtPP *string_offs;
+	RzVector sections[PB_COUNT];
+	RJson *json;
+	char *json_str;
+} PBWriter;
+
+static ut32 pbw_str(PBWriter *w, const char *s) {
+	if (!s || !*s) {
+		return 0;
+	}
+	bool found = false;
+	ut32 off = (ut32)(size_t)ht_pp_find (w->string_offs, s, &found);
+	if (found) {
+		return off;
+	}
+	off = rz_strbuf_length (&w->strings);
+	rz_strbuf_append_n (&w->strings, s, strlen (s) + 1);
+	ht_pp_insert (w->string_offs, s, (void *)(size_t)off);
+	return off;
+}
+
+static ut8 *pbw_push(PBWriter *w, PBSection s) {
+	return rz_vector_push (&w->sections[s], NULL);
+}
+
+static const RJson *pbw_json(PBWriter *w, const char *v, RJsonType type) {
+	rz_json_free (w->json);
+	free (w->json_str);
+	w->json_str = strdup (v);
+	w->json = w->json_str? rz_json_parse (w->json_str): NULL;
+	return w->json && w->json->type == type? w->json: NULL;
+}
+
+static ut64 json_num(const RJson *json, const char *key, ut64 def) {
+	const RJson *child = rz_json_get (json, key);
+	return child && (child->type == RZ_JSON_INTEGER || child->type == RZ_JSON_BOOLEAN)? child->num.u_value: def;
+}
+
+static const char *json_str(const RJson *json, const char *key) {
+	const RJson *child = rz_json_get (json, key);
+	return child && child->type == RZ_JSON_STRING? child->str_value: NULL;
+}
+
+static bool pbw_xrefs(PBWriter *w, const char *k, const char *v) {
+	const RJson *json = pbw_json (w, v, RZ_JSON_ARRAY);
+	if (!json) {
+		return false;
+	}
+	ut64 from = strtoull (k, NULL, 0);
+	const RJson *child;
+	for (child = json->children.first; child; child = child->next) {
+		const char *type = json_str (child, "type");
+		ut8 *r = pbw_push (w, PB_XREFS);
+		if (!r) {
+			return false;
+		}
+		rz_write_le64 (r, from);
+		rz_write_le64 (r + 8, json_num (child, "to", 0));
+		rz_write_le32 (r + 16, type? (ut8)type[0]: 0);
+		rz_write_le32 (r + 20, 0);
+	}
+	return true;
+}
+
+static bool pbw_block(PBWriter *w, const char *k, const char *v) {
+	const RJson *json = pbw_json (w, v, RZ_JSON_OBJECT);
+	if (!json) {
+		return false;
+	}
+	ut8 *r = pbw_push (w, PB_BLOCKS);
+	if (!r) {
+		return false;
+	}
+	memset (r, 0, pb_entsize[PB_BLOCKS]);
+	rz_write_le64 (r, strtoull (k, NULL, 0));
+	if (rz_json_get (json, "fingerprint") || rz_json_get (json, "diff") || rz_json_get (json, "switch_op")) {
+		rz_write_le32 (r + 72, pbw_str (w, v));
+		return true;
+	}
+	rz_write_le64 (r + 8, json_num (json, "size", 0));
+	rz_write_le64 (r + 16, json_num (json, "jump", UT64_MAX));
+	rz_write_le64 (r + 24, json_num (json, "fail", UT64_MAX));
+	rz_write_le64 (r + 32, json_num (json, "cmpval", UT64_MAX));
+	rz_write_le32 (r + 40, (ut32)json_num (json, "ninstr", 0));
+	rz_write_le32 (r + 44, (ut32)json_num (json, "stackptr", 0));
+	rz_write_le32 (r + 48, (ut32)json_num (json, "parent_stackptr", INT_MAX));
+	rz_write_le32 (r + 52, (ut32)json_num (json, "colorize", 0));
+	rz_write_le32 (r + 56, (json_num (json, "traced", 0)? BLOCK_TRACED: 0) | (json_num (json, "folded", 0)? BLOCK_FOLDED: 0));
+	rz_write_le32 (r + 60, pbw_str (w, json_str (json, "cmpreg")));
+	const RJson *op_pos = rz_json_get (json, "op_pos");
+	if (op_pos && op_pos->type == RZ_JSON_ARRAY) {
+		rz_write_le32 (r + 64, (ut32)w->sections[PB_OP_POS].len);
+		rz_write_le32 (r + 68, (ut32)op_pos->children.count);
+		const RJson *child;
+		for (child = op_pos->children.first; child; child = child->next) {
+			ut8 *p = pbw_push (w, PB_OP_POS);
+			if (!p) {
+				return false;
+			}
+			rz_write_le16 (p, (ut16)child->num.u_value);
+		}
+	}
+	return true;
+}
+
+static bool pbw_function(PBWriter *w, const char *k, const char *v) {
+	const RJson *json = pbw_json (w, v, RZ_JSON_OBJECT);
+	if (!json) {
+		return false;
+	}
+	const RJson *bbs = rz_json_get (json, "bbs");
+	ut8 *r = pbw_push (w, PB_FUNCTIONS);
+	if (!r) {
+		return false;
+	}
+	rz_write_le64 (r, strtoull (k, NULL, 0));
+	rz_write_le32 (r + 8, pbw_str (w, json_str (json, "name")));
+	rz_write_le32 (r + 12, pbw_str (w, v));
+	rz_write_le32 (r + 16, (ut32)w->sections[PB_BBS].len);
+	rz_write_le32 (r + 20, 0);
+	if (bbs && bbs->type == RZ_JSON_ARRAY) {
+		rz_write_le32 (r + 20, (ut32)bbs->children.count);
+		const RJson *child;
+		for (child = bbs->children.first; child; child = child->next) {
+			ut8 *p = pbw_push (w, PB_BBS);
+			if (!p) {
+				return false;
+			}
+			rz_write_le64 (p, child->num.u_value);
+		}
+	}
+	return true;
+}
+
+static bool pbw_flag(PBWriter *w, const char *k, const char *v) {
+	const RJson *json = pbw_json (w, v, RZ_JSON_OBJECT);
+	if (!json || !rz_json_get (json, "offset") || !rz_json_get (json, "size")) {
+		return false;
+	}
+	ut8 *r = pbw_push (w, PB_FLAGS);
+	if (!r) {
+		return false;
+	}
+	rz_write_le64 (r, json_num (json, "offset", 0));
+	rz_write_le64 (r + 8, json_num (json, "size", 0));
+	rz_write_le32 (r + 16, pbw_str (w, k));
+	rz_write_le32 (r + 20, pbw_str (w, json_str (json, "realname")));
+	rz_write_le32 (r + 24, pbw_str (w, json_str (json, "space")));
+	rz_write_le32 (r + 28, pbw_str (w, json_str (json, "color")));
+	rz_write_le32 (r + 32, pbw_str (w, json_str (json, "comment")));
+	rz_write_le32 (r + 36, pbw_str (w, json_str (json, "alias")));
+	rz_write_le32 (r + 40, json_num (json, "demangled", 0)? 1: 0);
+	rz_write_le32 (r + 44, 0);
+	return true;
+}
+
+static bool pbw_meta(PBWriter *w, const char *k, const char *v) {
+	const RJson *json = pbw_json (w, v, RZ_JSON_ARRAY);
+	if (!json) {
+		return false;
+	}
+	ut64 addr = strtoull (k, NULL, 0);
+	const RJson *child;
+	for (child = json->children.first; child; child = child->next) {
+		const char *type = json_str (child, "type");
+		ut8 *r = pbw_push (w, PB_META);
+		if (!r) {
+			return false;
+		}
+		rz_write_le64 (r, addr);
+		rz_write_le64 (r + 8, json_num (child, "size", 1));
+		rz_write_le32 (r + 16, type? (ut8)type[0]: 0);
+		rz_write_le32 (r + 20, (ut32)json_num (child, "subtype", 0));
+		rz_write_le32 (r + 24, pbw_str (w, json_str (child, "str")));
+		rz_write_le32 (r + 28, pbw_str (w, json_str (child, "space")));
+	}
+	return true;
+}
+
+typedef bool (*PBWriteCb)(PBWriter *w, const char *k, const char *v);
+
+static const struct {
+	const char *ns;
+	PBWriteCb cb;
+} pb_tables[] = {
+	{ "core/analysis/xrefs", pbw_xrefs },
+	{ "core/analysis/blocks", pbw_block },
+	{ "core/analysis/functions", pbw_function },
+	{ "core/analysis/meta", pbw_meta },
+	{ "core/flags/flags", pbw_flag },
+};
+
+static bool pbw_sdb(PBWriter *w, Sdb *db, const char *path) {
+	PBWriteCb cb = NULL;
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (pb_tables); i++) {
+		if (!strcmp (path, pb_tables[i].ns)) {
+			cb = pb_tables[i].cb;
+		}
+	}
+	ut32 ns = pbw_str (w, path);
+	ut8 *r = pbw_push (w, PB_SDB);
+	if (!r) {
+		return false;
+	}
+	rz_write_le32 (r, ns);
+	memset (r + 4, 0, 12);
+
+	bool ret = true;
+	SdbList *kvs = sdb_foreach_list (db, true);
+	SdbListIter *it;
+	SdbKv *kv;
+	ls_foreach (kvs, it, kv) {
+		const char *k = sdbkv_key (kv);
+		const char *v = sdbkv_value (kv);
+		if (cb) {
+			if (!cb (w, k, v)) {
+				ret = false;
+				break;
+			}
+			continue;
+		}
+		r = pbw_push (w, PB_SDB);
+		if (!r) {
+			ret = false;
+			break;
+		}
+		rz_write_le32 (r, ns);
+		rz_write_le32 (r + 4, pbw_str (w, k));
+		rz_write_le32 (r + 8, pbw_str (w, v));
+		rz_write_le32 (r + 12, 0);
+	}
+	ls_free (kvs);
+	if (!ret) {
+		return false;
+	}
+
+	SdbNs *sub;
+	ls_foreach (db->ns, it, sub) {
+		if (strchr (sub->name, '/')) {
+			return false;
+		}
+		char *subpath = *path? rz_str_newf ("%s/%s", path, sub->name): strdup (sub->name);
+		if (!subpath) {
+			return false;
+		}
+		ret = pbw_sdb (w, sub->sdb, subpath);
+		free (subpath);
+		if (!ret) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int pb_addr_cmp(const void *a, const void *b, size_t size) {
+	ut64 x = rz_read_le64 (a);
+	ut64 y = rz_read_le64 (b);
+	if (x != y) {
+		return x < y? -1: 1;
+	}
+	return memcmp (a, b, size);
+}
+
+#define PB_CMP(name, section) \
+	static int name(const void *a, const void *b) { \
+		return pb_addr_cmp (a, b, pb_entsize[section]); \
+	}
+PB_CMP (pb_xrefs_cmp, PB_XREFS)
+PB_CMP (pb_blocks_cmp, PB_BLOCKS)
+PB_CMP (pb_flags_cmp, PB_FLAGS)
+PB_CMP (pb_meta_cmp, PB_META)
+#undef PB_CMP
+
+static int pb_functions_cmp(const void *a, const void *b) {
+	// only by address, the bbs indexes must not affect the order
+	ut64 x = rz_read_le64 (a);
+	ut64 y = rz_read_le64 (b);
+	return x < y? -1: x > y;
+}
+
+/**
+ * \brief Convert an sdb project, as made by rz_project_save (), to the binary format
+ * \param size set to the size of the returned buffer
+ */
+RZ_API RZ_OWN ut8 *rz_project_bin_from_sdb(RZ_NONNULL RzProject *prj, RZ_NONNULL ut64 *size) {
+	rz_return_val_if_fail (prj && size, NULL);
+	PBWriter w = { 0 };
+	ut8 *buf = NULL;
+	size_t i;
+	rz_strbuf_init (&w.strings);
+	rz_strbuf_append_n (&w.strings, "", 1);
+	w.string_offs = ht_pp_new0 ();
+	for (i = 0; i < PB_COUNT; i++) {
+		rz_vector_init (&w.sections[i], pb_entsize[i], NULL, NULL);
+	}
+	if (!w.string_offs || !pbw_sdb (&w, prj, "")) {
+		goto beach;
+	}
+	qsort (w.sections[PB_XREFS].a, w.sections[PB_XREFS].len, pb_entsize[PB_XREFS], pb_xrefs_cmp);
+	qsort (w.sections[PB_BLOCKS].a, w.sections[PB_BLOCKS].len, pb_entsize[PB_BLOCKS], pb_blocks_cmp);
+	qsort (w.sections[PB_FUNCTIONS].a, w.sections[PB_FUNCTIONS].len, pb_entsize[PB_FUNCTIONS], pb_functions_cmp);
+	qsort (w.sections[PB_FLAGS].a, w.sections[PB_FLAGS].len, pb_entsize[PB_FLAGS], pb_flags_cmp);
+	qsort (w.sections[PB_META].a, w.sections[PB_META].len, pb_entsize[PB_META], pb_meta_cmp);
+
+	ut64 offs[PB_COUNT];
+	ut64 off = PB_HEADER_SIZE + PB_COUNT * PB_SECTION_SIZE;
+	for (i = 0; i < PB_COUNT; i++) {
+		off = RZ_ROUND (off, 8);
+		offs[i] = off;
+		off += i == PB_STRINGS
+			? rz_strbuf_length (&w.strings)
+			: (ut64)w.sections[i].len * pb_entsize[i];
+	}
+	buf = calloc (1, off);
+	if (!buf) {
+		goto beach;
+	}
+	memcpy (buf, PB_MAGIC, 4);
+	rz_write_le32 (buf + 4, PB_VERSION);
+	rz_write_le32 (buf + 8, PB_COUNT);
+	for (i = 0; i < PB_COUNT; i++) {
+		ut8 *s = buf + PB_HEADER_SIZE + i * PB_SECTION_SIZE;
+		ut64 count = i == PB_STRINGS? rz_strbuf_length (&w.strings): w.sections[i].len;
+		rz_write_le32 (s, (ut32)i);
+		rz_write_le32 (s + 4, pb_entsize[i]);
+		rz_write_le64 (s + 8, offs[i]);
+		rz_write_le64 (s + 16, count);
+		if (i == PB_STRINGS) {
+			memcpy (buf + offs[i], rz_strbuf_getbin (&w.strings, NULL), count);
+		} else if (count) {
+			memcpy (buf + offs[i], w.sections[i].a, count * pb_entsize[i]);
+		}
+	}
+	*size = off;
+beach:
+	for (i = 0; i < PB_COUNT; i++) {
+		rz_vector_fini (&w.sections[i]);
+	}
+	ht_pp_free (w.string_offs);
+	rz_strbuf_fini (&w.strings);
+	rz_json_free (w.json);
+	free (w.json_str);
+	return buf;
+}
+
+/* reader */
+
+/**
+ * \brief Open a binary project from memory
+ * \param buf contents of the project, it must stay valid while the returned RzProjectBin is used
+ */
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_new(RZ_NONNULL const ut8 *buf, ut64 size, RZ_NULLABLE RzProjectErr *err) {
+	rz_return_val_if_fail (buf, NULL);
+	RzProjectErr e = RZ_PROJECT_ERR_INVALID_CONTENTS;
+	RzProjectBin *pb = NULL;
+	if (size < PB_HEADER_SIZE || memcmp (buf, PB_MAGIC, 4)) {
+		e = RZ_PROJECT_ERR_INVALID_TYPE;
+		goto beach;
+	}
+	ut32 version = rz_read_le32 (buf + 4);
+	if (!version) {
+		e = RZ_PROJECT_ERR_INVALID_VERSION;
+		goto beach;
+	} else if (version > PB_VERSION) {
+		e = RZ_PROJECT_ERR_NEWER_VERSION;
+		goto beach;
+	}
+	ut32 nsections = rz_read_le32 (buf + 8);
+	if (nsections > (size - PB_HEADER_SIZE) / PB_SECTION_SIZE) {
+		goto beach;
+	}
+	pb = RZ_NEW0 (RzProjectBin);
+	if (!pb) {
+		e = RZ_PROJECT_ERR_UNKNOWN;
+		goto beach;
+	}
+	pb->buf = buf;
+	pb->size = size;
+	ut32 i;
+	for (i = 0; i < nsections; i++) {
+		const ut8 *s = buf + PB_HEADER_SIZE + i * PB_SECTION_SIZE;
+		ut32 id = rz_read_le32 (s);
+		ut32 entsize = rz_read_le32 (s + 4);
+		ut64 off = rz_read_le64 (s + 8);
+		ut64 count = rz_read_le64 (s + 16);
+		if (id >= PB_COUNT) {
+			// from a newer minor revision, not needed to load the project
+			continue;
+		}
+		if (entsize != pb_entsize[id] || off > size || count > (size - off) / entsize) {
+			goto beach;
+		}
+		pb->sections[id] = buf + off;
+		pb->counts[id] = count;
+	}
+	// every string must be terminated inside the pool
+	if (!pb->counts[PB_STRINGS] || pb->sections[PB_STRINGS][pb->counts[PB_STRINGS] - 1]) {
+		goto beach;
+	}
+	if (err) {
+		*err = RZ_PROJECT_ERR_SUCCESS;
+	}
+	return pb;
+beach:
+	free (pb);
+	if (err) {
+		*err = e;
+	}
+	return NULL;
+}
+
+/**
+ * \brief Map a binary project file, nothing is loaded until asked for
+ */
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file, RZ_NULLABLE RzProjectErr *err) {
+	rz_return_val_if_fail (file, NULL);
+	RMmap *map = rz_file_mmap (file, false, 0);
+	if (!map || !map->buf) {
+		rz_file_mmap_free (map);
+		if (err) {
+			*err = RZ_PROJECT_ERR_FILE;
+		}
+		return NULL;
+	}
+	RzProjectBin *pb = rz_project_bin_new (map->buf, (ut64)map->len, err);
+	if (!pb) {
+		rz_file_mmap_free (map);
+		return NULL;
+	}
+	pb->map = map;
+	return pb;
+}
+
+RZ_API void rz_project_bin_free(RZ_NULLABLE RzProjectBin *pb) {
+	if (!pb) {
+		return;
+	}
+	size_t i;
+	for (i = 0; i < PB_COUNT; i++) {
+		free (pb->loaded[i]);
+	}
+	rz_file_mmap_free (pb->map);
+	free (pb);
+}
+
+static const char *pb_str(RzProjectBin *pb, ut32 off) {
+	return off && off < pb->counts[PB_STRINGS]? (const char *)pb->sections[PB_STRINGS] + off: NULL;
+}
+
+static const ut8 *pb_rec(RzProjectBin *pb, PBSection s, ut64 i) {
+	return pb->sections[s] + i * pb_entsize[s];
+}
+
+// index of the first record of a sorted section at or after addr
+static ut64 pb_lower_bound(RzProjectBin *pb, PBSection s, ut64 addr) {
+	ut64 lo = 0, hi = pb->counts[s];
+	while (lo < hi) {
+		ut64 mid = lo + (hi - lo) / 2;
+		if (rz_read_le64 (pb_rec (pb, s, mid)) < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+// marks record i of s as loaded, returns false if it already was
+static bool pb_take(RzProjectBin *pb, PBSection s, ut64 i) {
+	if (!pb->loaded[s]) {
+		pb->loaded[s] = calloc (1, pb->counts[s] / 8 + 1);
+		if (!pb->loaded[s]) {
+			return true;
+		}
+	}
+	ut8 bit = 1 << (i & 7);
+	if (pb->loaded[s][i >> 3] & bit) {
+		return false;
+	}
+	pb->loaded[s][i >> 3] |= bit;
+	return true;
+}
+
+/**
+ * \brief Rebuild the sdb project from the SDB section
+ *
+ * The namespaces of the tables are there but empty, their contents are
+ * loaded by rz_project_bin_load_range ().
+ */
+RZ_API RZ_OWN RzProject *rz_project_bin_sdb(RZ_NONNULL RzProjectBin *pb) {
+	rz_return_val_if_fail (pb, NULL);
+	RzProject *prj = sdb_new0 ();
+	if (!prj) {
+		return NULL;
+	}
+	Sdb *db = prj;
+	ut32 cur = UT32_MAX;
+	ut64 i;
+	for (i = 0; i < pb->counts[PB_SDB]; i++) {
+		const ut8 *r = pb_rec (pb, PB_SDB, i);
+		ut32 ns = rz_read_le32 (r);
+		if (ns != cur) {
+			cur = ns;
+			db = prj;
+			const char *path = pb_str (pb, ns);
+			if (path) {
+				char *p = strdup (path);
+				char *tok = p, *next;
+				for (; db && tok; tok = next) {
+					next = strchr (tok, '/');
+					if (next) {
+						*next++ = 0;
+					}
+					db = sdb_ns (db, tok, true);
+				}
+				free (p);
+			}
+			if (!db) {
+				sdb_free (prj);
+				return NULL;
+			}
+		}
+		const char *k = pb_str (pb, rz_read_le32 (r + 4));
+		if (k) {
+			const char *v = pb_str (pb, rz_read_le32 (r + 8));
+			sdb_set (db, k, v? v: "", 0);
+		}
+	}
+	return prj;
+}
+
+static RzAnalysisBlock *pb_block_load(RzProjectBin *pb, RzAnalysis *analysis, ut64 addr, RzSerializeAnalDiffParser diff_parser, RzSerializeResultInfo *res) {
+	ut64 i = pb_lower_bound (pb, PB_BLOCKS, addr);
+	if (i >= pb->counts[PB_BLOCKS]) {
+		return NULL;
+	}
+	const ut8 *r = pb_rec (pb, PB_BLOCKS, i);
+	if (rz_read_le64 (r) != addr) {
+		return NULL;
+	}
+	const char *json = pb_str (pb, rz_read_le32 (r + 72));
+	if (json) {
+		Sdb *db = sdb_new0 ();
+		if (!db) {
+			return NULL;
+		}
+		char key[0x20];
+		snprintf (key, sizeof (key), "0x%" PFMT64x, addr);
+		sdb_set (db, key, json, 0);
+		bool ok = rz_serialize_analysis_blocks_load (db, analysis, diff_parser, res);
+		sdb_free (db);
+		return ok? rz_analysis_get_block_at (analysis, addr): NULL;
+	}
+	ut32 npos = rz_read_le32 (r + 68);
+	ut32 pos = rz_read_le32 (r + 64);
+	int ninstr = (int)rz_read_le32 (r + 40);
+	if ((npos && npos != ninstr - 1) || pos > pb->counts[PB_OP_POS] || npos > pb->counts[PB_OP_POS] - pos) {
+		return NULL;
+	}
+	RzAnalysisBlock *block = rz_analysis_create_block (analysis, addr, rz_read_le64 (r + 8));
+	if (!block) {
+		return NULL;
+	}
+	block->jump = rz_read_le64 (r + 16);
+	block->fail = rz_read_le64 (r + 24);
+	block->cmpval = rz_read_le64 (r + 32);
+	block->ninstr = ninstr;
+	block->stackptr = (int)rz_read_le32 (r + 44);
+	block->parent_stackptr = (int)rz_read_le32 (r + 48);
+	block->colorize = rz_read_le32 (r + 52);
+	ut32 flags = rz_read_le32 (r + 56);
+	block->traced = flags & BLOCK_TRACED;
+	block->folded = flags & BLOCK_FOLDED;
+	const char *cmpreg = pb_str (pb, rz_read_le32 (r + 60));
+	block->cmpreg = cmpreg? rz_str_constpool_get (&analysis->constpool, cmpreg): NULL;
+	if (npos) {
+		ut16 *op_pos = calloc (npos, sizeof (ut16));
+		if (op_pos) {
+			ut32 j;
+			for (j = 0; j < npos; j++) {
+				op_pos[j] = rz_read_le16 (pb_rec (pb, PB_OP_POS, pos + j));
+			}
+			free (block->op_pos);
+			block->op_pos = op_pos;
+			block->op_pos_size = npos;
+		}
+	}
+	return block;
+}
+
+static bool pb_functions_load(RzProjectBin *pb, RzAnalysis *analysis, ut64 from, ut64 to, RzSerializeResultInfo *res) {
+	RzSerializeAnalDiffParser diff_parser = rz_serialize_analysis_diff_parser_new ();
+	Sdb *db = sdb_new0 ();
+	RzPVector blocks;
+	rz_pvector_init (&blocks, NULL);
+	void **it;
+	bool ret = false;
+	if (!diff_parser || !db) {
+		goto beach;
+	}
+	char key[0x20];
+	ut64 i;
+	for (i = pb_lower_bound (pb, PB_FUNCTIONS, from); i < pb->counts[PB_FUNCTIONS]; i++) {
+		const ut8 *r = pb_rec (pb, PB_FUNCTIONS, i);
+		ut64 addr = rz_read_le64 (r);
+		if (addr > to) {
+			break;
+		}
+		const char *json = pb_str (pb, rz_read_le32 (r + 12));
+		ut32 bbs = rz_read_le32 (r + 16);
+		ut32 nbbs = rz_read_le32 (r + 20);
+		if (!json || bbs > pb->counts[PB_BBS] || nbbs > pb->counts[PB_BBS] - bbs) {
+			SERIALIZE_ERR ("invalid function record at 0x%" PFMT64x, addr);
+			goto beach;
+		}
+		if (!pb_take (pb, PB_FUNCTIONS, i) || rz_analysis_get_function_at (analysis, addr)) {
+			continue;
+		}
+		// the blocks must be there before the function, each one created
+		// here holds an extra reference that is dropped below
+		ut32 j;
+		for (j = 0; j < nbbs; j++) {
+			ut64 bb = rz_read_le64 (pb_rec (pb, PB_BBS, bbs + j));
+			if (rz_analysis_get_block_at (analysis, bb)) {
+				continue;
+			}
+			RzAnalysisBlock *block = pb_block_load (pb, analysis, bb, diff_parser, res);
+			if (block) {
+				rz_pvector_push (&blocks, block);
+			}
+		}
+		snprintf (key, sizeof (key), "0x%" PFMT64x, addr);
+		sdb_set (db, key, json, 0);
+	}
+	ret = rz_serialize_analysis_functions_load (db, analysis, diff_parser, res);
+beach:
+	rz_pvector_foreach (&blocks, it) {
+		rz_analysis_block_unref (*it);
+	}
+	rz_pvector_fini (&blocks);
+	sdb_free (db);
+	rz_serialize_analysis_diff_parser_free (diff_parser);
+	return ret;
+}
+
+static RzAnalysisMetaType meta_type(ut32 c) {
+	switch (c) {
+	case 'd': return RZ_META_TYPE_DATA;
+	case 'c': return RZ_META_TYPE_CODE;
+	case 's': return RZ_META_TYPE_STRING;
+	case 'f': return RZ_META_TYPE_FORMAT;
+	case 'm': return RZ_META_TYPE_MAGIC;
+	case 'h': return RZ_META_TYPE_HIDE;
+	case 'C': return RZ_META_TYPE_COMMENT;
+	case 'r': return RZ_META_TYPE_RUN;
+	case 'H': return RZ_META_TYPE_HIGHLIGHT;
+	case 't': return RZ_META_TYPE_VARTYPE;
+	default: return RZ_META_TYPE_ANY;
+	}
+}
+
+static void pb_meta_load(RzProjectBin *pb, RzAnalysis *analysis, ut64 from, ut64 to) {
+	ut64 i;
+	for (i = pb_lower_bound (pb, PB_META, from); i < pb->counts[PB_META]; i++) {
+		const ut8 *r = pb_rec (pb, PB_META, i);
+		ut64 addr = rz_read_le64 (r);
+		if (addr > to) {
+			break;
+		}
+		RzAnalysisMetaType type = meta_type (rz_read_le32 (r + 16));
+		const char *str = pb_str (pb, rz_read_le32 (r + 24));
+		if (!pb_take (pb, PB_META, i) || type == RZ_META_TYPE_ANY || (type == RZ_META_TYPE_COMMENT && !str)) {
+			continue;
+		}
+		RzAnalysisMetaItem *item = RZ_NEW0 (RzAnalysisMetaItem);
+		if (!item) {
+			break;
+		}
+		const char *space = pb_str (pb, rz_read_le32 (r + 28));
+		item->type = type;
+		item->subtype = (int)rz_read_le32 (r + 20);
+		item->space = space? rz_spaces_add (&analysis->meta_spaces, space): NULL;
+		item->str = str? strdup (str): NULL;
+		ut64 end = addr + rz_read_le64 (r + 8) - 1;
+		if (end < addr) {
+			end = UT64_MAX;
+		}
+		rz_interval_tree_insert (&analysis->meta, addr, end, item);
+	}
+}
+
+static void pb_flags_load(RzProjectBin *pb, RzFlag *flag, ut64 from, ut64 to) {
+	ut64 i;
+	for (i = pb_lower_bound (pb, PB_FLAGS, from); i < pb->counts[PB_FLAGS]; i++) {
+		const ut8 *r = pb_rec (pb, PB_FLAGS, i);
+		ut64 offset = rz_read_le64 (r);
+		if (offset > to) {
+			break;
+		}
+		const char *name = pb_str (pb, rz_read_le32 (r + 16));
+		if (!name || !pb_take (pb, PB_FLAGS, i)) {
+			continue;
+		}
+		RzFlagItem *item = rz_flag_set (flag, name, offset - flag->base, rz_read_le64 (r + 8));
+		if (!item) {
+			continue;
+		}
+		const char *s = pb_str (pb, rz_read_le32 (r + 20));
+		if (s) {
+			rz_flag_item_set_realname (item, s);
+		}
+		s = pb_str (pb, rz_read_le32 (r + 24));
+		item->space = s? rz_spaces_add (&flag->spaces, s): NULL;
+		s = pb_str (pb, rz_read_le32 (r + 28));
+		if (s) {
+			rz_flag_item_set_color (item, s);
+		}
+		s = pb_str (pb, rz_read_le32 (r + 32));
+		if (s) {
+			rz_flag_item_set_comment (item, s);
+		}
+		s = pb_str (pb, rz_read_le32 (r + 36));
+		if (s) {
+			rz_flag_item_set_alias (item, s);
+		}
+		item->demangled = rz_read_le32 (r + 40) != 0;
+	}
+}
+
+/**
+ * \brief Load the records of some tables in [from, to] on top of what is already there
+ *
+ * Records that were loaded before by the same RzProjectBin are skipped, so
+ * the project can be loaded piece by piece as it is needed. Functions come
+ * with all their basic blocks, wherever they are.
+ *
+ * \param tables RZ_PROJECT_BIN_* mask
+ * \param flag may be NULL if RZ_PROJECT_BIN_FLAGS is not set
+ */
+RZ_API bool rz_project_bin_load_range(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzFlag *flag,
+		int tables, ut64 from, ut64 to, RZ_NULLABLE RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (pb && analysis && (flag || !(tables & RZ_PROJECT_BIN_FLAGS)), false);
+	if (tables & RZ_PROJECT_BIN_XREFS) {
+		ut64 i;
+		for (i = pb_lower_bound (pb, PB_XREFS, from); i < pb->counts[PB_XREFS]; i++) {
+			const ut8 *r = pb_rec (pb, PB_XREFS, i);
+			ut64 addr = rz_read_le64 (r);
+			if (addr > to) {
+				break;
+			}
+			rz_analysis_xrefs_set (analysis, addr, rz_read_le64 (r + 8), (RzAnalysisRefType)rz_read_le32 (r + 16));
+		}
+	}
+	if (tables & RZ_PROJECT_BIN_FUNCTIONS && !pb_functions_load (pb, analysis, from, to, res)) {
+		return false;
+	}
+	if (tables & RZ_PROJECT_BIN_META) {
+		pb_meta_load (pb, analysis, from, to);
+	}
+	if (tables & RZ_PROJECT_BIN_FLAGS) {
+		pb_flags_load (pb, flag, from, to);
+	}
+	return true;
+}
+
+/**
+ * \brief Load a binary project, like rz_project_load () does for sdb ones
+ *
+ * \param lazy only load the tables around the current seek and keep pb in
+ * core->prj_bin to load the rest as it is needed, see rz_project_bin_load_at ().
+ * The core takes the ownership of pb if this succeeds.
+ */
+RZ_API RzProjectErr rz_project_bin_load(RzCore *core, RZ_NONNULL RzProjectBin *pb, bool load_bin_io, RZ_NULLABLE const char *file, bool lazy, RzSerializeResultInfo *res) {
+	rz_return_val_if_fail (core && pb, RZ_PROJECT_ERR_UNKNOWN);
+	RzProject *prj = rz_project_bin_sdb (pb);
+	if (!prj) {
+		return RZ_PROJECT_ERR_INVALID_CONTENTS;
+	}
+	RzProjectErr err = rz_project_load (core, prj, load_bin_io, file, res);
+	sdb_free (prj);
+	if (err != RZ_PROJECT_ERR_SUCCESS) {
+		return err;
+	}
+	if (lazy) {
+		core->prj_bin = pb;
+		rz_project_bin_load_at (core, core->offset);
+		return RZ_PROJECT_ERR_SUCCESS;
+	}
+	bool ok = rz_project_bin_load_range (pb, core->analysis, core->flags, RZ_PROJECT_BIN_ALL, 0, UT64_MAX, res);
+	rz_project_bin_free (pb);
+	return ok? RZ_PROJECT_ERR_SUCCESS: RZ_PROJECT_ERR_INVALID_CONTENTS;
+}
+
+/**
+ * \brief Load the records of core->prj_bin in the io map at addr, or in the block at addr if there is no map
+ *
+ * Called on every seek, does nothing if no binary project is being loaded lazily.
+ */
+RZ_API void rz_project_bin_load_at(RZ_NONNULL RzCore *core, ut64 addr) {
+	rz_return_if_fail (core);
+	if (!core->prj_bin) {
+		return;
+	}
+	ut64 from = addr;
+	ut64 to = addr + RZ_MAX (core->blocksize, 1) - 1;
+	RzIOMap *map = rz_io_map_get (core->io, addr);
+	if (map) {
+		from = map->itv.addr;
+		to = rz_itv_end (map->itv) - 1;
+	}
+	if (to < from) {
+		to = UT64_MAX;
+	}
+	rz_project_bin_load_range (core->prj_bin, core->analysis, core->flags, RZ_PROJECT_BIN_ALL, from, to, NULL);
+}
+
+/**
+ * \brief Load everything that is still missing from core->prj_bin and drop it
+ *
+ * Must be called before anything depends on the whole project, like saving it.
+ */
+RZ_API void rz_project_bin_load_rest(RZ_NONNULL RzCore *core) {
+	rz_return_if_fail (core);
+	if (!core->prj_bin) {
+		return;
+	}
+	rz_project_bin_load_range (core->prj_bin, core->analysis, core->flags, RZ_PROJECT_BIN_ALL, 0, UT64_MAX, NULL);
+	rz_project_bin_free (core->prj_bin);
+	core->prj_bin = NULL;
+}
+
+RZ_API bool rz_project_bin_is_file(RZ_NONNULL const char *file) {
+	int len = 0;
+	char *head = rz_file_slurp_range (file, 0, 4, &len);
+	bool ret = head && len == 4 && !memcmp (head, PB_MAGIC, 4);
+	free (head);
+	return ret;
+}
+
+static RzProjectErr pb_dump(RzProject *prj, const char *file) {
+	ut64 size = 0;
+	ut8 *buf = rz_project_bin_from_sdb (prj, &size);
+	if (!buf) {
+		return RZ_PROJECT_ERR_INVALID_CONTENTS;
+	}
+	RzProjectErr err = size <= INT_MAX && rz_file_dump (file, buf, (int)size, false)
+		? RZ_PROJECT_ERR_SUCCESS
+		: RZ_PROJECT_ERR_FILE;
+	free (buf);
+	return err;
+}
+
+RZ_API RzProjectErr rz_project_save_file_bin(RzCore *core, const char *file) {
+	RzProject *prj = sdb_new0 ();
+	if (!prj) {
+		return RZ_PROJECT_ERR_UNKNOWN;
+	}
+	RzProjectErr err = rz_project_save (core, prj, file);
+	if (err == RZ_PROJECT_ERR_SUCCESS) {
+		err = pb_dump (prj, file);
+	}
+	sdb_free (prj);
+	return err;
+}
+
+/**
+ * \brief Convert an sdb project file to a binary one
+ */
+RZ_API RzProjectErr rz_project_convert_file(RZ_NONNULL const char *sdb_file, RZ_NONNULL const char *bin_file) {
+	rz_return_val_if_fail (sdb_file && bin_file, RZ_PROJECT_ERR_UNKNOWN);
+	RzProject *prj = sdb_new0 ();
+	if (!prj) {
+		return RZ_PROJECT_ERR_UNKNOWN;
+	}
+	RzProjectErr err = RZ_PROJECT_ERR_FILE;
+	if (sdb_text_load (prj, sdb_file)) {
+		err = rz_project_check (prj);
+		if (err == RZ_PROJECT_ERR_SUCCESS) {
+			err = pb_dump (prj, bin_file);
+		}
+	}
+	sdb_free (prj);
+	return err;
+}
@@ -47,7 +47,7 @@ typedef struct {
 } RapThread;
 
 RZ_API void rz_core_wait(RzCore *core) {
-	rz_cons_singleton ()->context->breaked = true;
+	rz_cons_context ()->breaked = true;
 	rz_th_kill (httpthread, true);
 	rz_th_kill (rapthread, true);
 	rz_th_wait (httpthread);
@@ -110,7 +110,7 @@ RZ_API int rz_core_rtr_http_stop(RzCore *u) {
 	RzSocket* sock;
 
 #if __WINDOWS__
-	rz_socket_http_server_set_breaked (&rz_cons_singleton ()->context->breaked);
+	rz_socket_http_server_set_breaked (&rz_cons_context ()->breaked);
 #endif
 	if (((size_t)u) > 0xff) {
 		port = listenport? listenport: rz_config_get (
@@ -828,16 +828,16 @@ static bool rz_core_rtr_rap_run(RzCore *core, const char *input) {
 	if (fd) {
 		if (rz_io_is_listener (core->io)) {
 			if (!rz_core_serve (core, fd)) {
-				rz_cons_singleton ()->context->breaked = true;
+				rz_cons_context ()->breaked = true;
 			}
 			rz_io_desc_close (fd);
 			// avoid double free, we are not the owners of this fd so we can't destroy it
 			//rz_io_desc_free (fd);
 		}
 	} else {
-		rz_cons_singleton ()->context->breaked = true;
+		rz_cons_context ()->breaked = true;
 	}
-	return !rz_cons_singleton ()->context->breaked;
+	return !rz_cons_context ()->breaked;
 	// rz_core_cmdf (core, "o rap://%s", input);
 }
 
@@ -1,22 +1,547 @@
 // included from rtr.c
 
+enum {
+	HTTP_NEXT, // keep serving
+	HTTP_STOP, // =h-- was requested
+	HTTP_RESTART, // =h* was requested
+};
+
+typedef struct {
+	RzCore *core;
+	RzSocketHTTPOptions *so;
+	const char *port;
+	bool pool; // requests are served by worker threads, see http.workers
+	int chunk;
+	int status;
+	bool stop;
+	RzThreadLock *lock;
+	RzThreadCond *cond;
+	RzList *queue; // accepted RzSocket waiting for a worker
+	int readers;
+	bool writer;
+	int writers_waiting;
+	RzThread **threads;
+	int nthreads;
+} HttpServer;
+
+// The workers are not core tasks, so they must not yield to the scheduler
+static void *http_sleep_begin(HttpServer *srv) {
+	return srv->pool ? NULL : rz_cons_sleep_begin ();
+}
+
+static void http_sleep_end(HttpServer *srv, void *bed) {
+	if (!srv->pool) {
+		rz_cons_sleep_end (bed);
+	}
+}
+
+// Requests share the core while they only read from it, a request running
+// a command that may change it waits until it is the only one in flight.
+static void http_gate_enter(HttpServer *srv, bool exclusive) {
+	if (!srv->pool) {
+		return;
+	}
+	rz_th_lock_enter (srv->lock);
+	if (exclusive) {
+		srv->writers_waiting++;
+		while (srv->writer || srv->readers) {
+			rz_th_cond_wait (srv->cond, srv->lock);
+		}
+		srv->writers_waiting--;
+		srv->writer = true;
+	} else {
+		while (srv->writer || srv->writers_waiting) {
+			rz_th_cond_wait (srv->cond, srv->lock);
+		}
+		srv->readers++;
+	}
+	rz_th_lock_leave (srv->lock);
+}
+
+static void http_gate_leave(HttpServer *srv, bool exclusive) {
+	if (!srv->pool) {
+		return;
+	}
+	rz_th_lock_enter (srv->lock);
+	if (exclusive) {
+		srv->writer = false;
+	} else {
+		srv->readers--;
+	}
+	rz_th_cond_signal_all (srv->cond);
+	rz_th_lock_leave (srv->lock);
+}
+
+// Commands that only print, without temporary seeks, pipes or subcommands.
+// The names are matched exactly: e.g. idp and ik k=v start like i but load
+// and change things.
+static bool http_cmd_readonly(const char *cmd) {
+	static const char *names[] = {
+		"pd", "pdj", "pdf", "pdfj", "pi", "pij", "pif", "pifj",
+		"px", "pxj", "pxw", "pxq", "p8", "p8j", "pc", "ps", "psj", "pv", "pvj", "x",
+		"afl", "aflj", "afll", "afi", "afij", "axt", "axtj", "axf", "axfj", "axj",
+		"i", "ij", "iS", "iSj", "is", "isj", "ie", "iej", "ii", "iij", "iE", "iEj",
+		"iz", "izj", "il", "ilj", "iI", "iIj", "ir", "irj", NULL
+	};
+	if (strpbrk (cmd, ";|>@`$")) {
+		return false;
+	}
+	size_t len = strcspn (cmd, " ~");
+	int i;
+	for (i = 0; names[i]; i++) {
+		if (strlen (names[i]) == len && !strncmp (cmd, names[i], len)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void http_stream(const char *buf, size_t len, void *user) {
+	rz_socket_http_chunk (user, buf, (int)len);
+}
+
+static void http_cmd_pool(HttpServer *srv, RzSocketHTTPRequest *rs, const char *cmd, const char *headers) {
+	RzCore *core = srv->core;
+	bool quiet = *cmd == ':';
+	bool exclusive = !http_cmd_readonly (cmd);
+	if (exclusive) {
+		http_gate_leave (srv, false);
+		http_gate_enter (srv, true);
+	}
+	RzCoreTask *task = rz_core_task_new (core, true, quiet ? cmd + 1 : cmd, NULL, NULL);
+	if (!task) {
+		rz_socket_http_response (rs, 500, "", 0, headers);
+		goto beach;
+	}
+	// the task stays serial even for read-only commands: the print ones read
+	// and resize the block of the shared core, only the requests around the
+	// tasks are served side by side
+	char *newheaders = rz_str_newf ("Content-Type: text/plain\n%s", headers);
+	bool stream = srv->chunk > 0 && !quiet;
+	if (stream) {
+		rz_cons_context_stream (task->cons_context, srv->chunk, http_stream, rs);
+		rz_socket_http_response_begin (rs, 200, newheaders);
+	}
+	rz_core_task_incref (task);
+	rz_core_task_enqueue (&core->tasks, task);
+	rz_core_task_join (&core->tasks, NULL, task->id);
+	if (stream) {
+		rz_socket_http_response_end (rs);
+	} else if (!quiet && task->res && *task->res) {
+		rz_socket_http_response (rs, 200, task->res, 0, newheaders);
+	} else {
+		rz_socket_http_response (rs, 200, "", 0, headers);
+	}
+	free (newheaders);
+	rz_core_task_del (&core->tasks, task->id);
+	rz_core_task_decref (task);
+beach:
+	if (exclusive) {
+		http_gate_leave (srv, true);
+		http_gate_enter (srv, false);
+	}
+}
+
+static void http_cmd(HttpServer *srv, RzSocketHTTPRequest *rs, const char *cmd, const char *headers) {
+	if (srv->pool) {
+		http_cmd_pool (srv, rs, cmd, headers);
+		return;
+	}
+	RzCore *core = srv->core;
+	char *out;
+	rz_config_set (core->config, "scr.interactive", "false");
+	if (*cmd == ':') {
+		/* commands in /cmd/: starting with : do not show any output */
+		rz_core_cmd0 (core, cmd + 1);
+		out = NULL;
+	} else {
+		out = rz_core_cmd_str_pipe (core, cmd);
+	}
+	if (out) {
+		char *newheaders = rz_str_newf (
+				"Content-Type: text/plain\n%s", headers);
+		rz_socket_http_response (rs, 200, out, 0, newheaders);
+		free (out);
+		free (newheaders);
+	} else {
+		rz_socket_http_response (rs, 200, "", 0, headers);
+	}
+}
+
+// Serves rs, returns HTTP_NEXT to keep serving or what the client asked for
+static int rtr_http_request(HttpServer *srv, RzSocketHTTPRequest *rs) {
+	RzCore *core = srv->core;
+	const char *index = rz_config_get (core->config, "http.index");
+	const char *allow = rz_config_get (core->config, "http.allow");
+	const char *port = srv->port;
+	char headers[128] = RZ_EMPTY;
+	char *dir;
+	if (allow && *allow) {
+		bool accepted = false;
+		const char *allows_host;
+		char *p, *peer = rz_socket_to_string (rs->s);
+		char *allows = strdup (allow);
+		//eprintf ("Firewall (%s)\n", allows);
+		int i, count = rz_str_split (allows, ',');
+		p = strchr (peer, ':');
+		if (p) {
+			*p = 0;
+		}
+		for (i = 0; i < count; i++) {
+			allows_host = rz_str_word_get0 (allows, i);
+			//eprintf ("--- (%s) (%s)\n", host, peer);
+			if (!strcmp (allows_host, peer)) {
+				accepted = true;
+				break;
+			}
+		}
+		free (peer);
+		free (allows);
+		if (!accepted) {
+			rs->keepalive = false;
+			return HTTP_NEXT;
+		}
+	}
+	if (!rs->method || !rs->path) {
+		http_logf (core, "Invalid http headers received from client\n");
+		rs->keepalive = false;
+		return HTTP_NEXT;
+	}
+	dir = NULL;
+
+	if (!rs->auth) {
+		rz_socket_http_response (rs, 401, "", 0, NULL);
+		return HTTP_NEXT;
+	}
+
+	if (rz_config_get_i (core->config, "http.verbose")) {
+		char *peer = rz_socket_to_string (rs->s);
+		http_logf (core, "[HTTP] %s %s\n", peer, rs->path);
+		free (peer);
+	}
+	if (rz_config_get_i (core->config, "http.dirlist")) {
+		if (rz_file_is_directory (rs->path)) {
+			dir = strdup (rs->path);
+		}
+	}
+	if (rz_config_get_i (core->config, "http.cors")) {
+		strcpy (headers, "Access-Control-Allow-Origin: *\n"
+			"Access-Control-Allow-Headers: Origin, "
+			"X-Requested-With, Content-Type, Accept\n");
+	}
+	if (!strcmp (rs->method, "OPTIONS")) {
+		rz_socket_http_response (rs, 200, "", 0, headers);
+	} else if (!strcmp (rs->method, "GET")) {
+		if (!strncmp (rs->path, "/up/", 4)) {
+			if (rz_config_get_i (core->config, "http.upget")) {
+				const char *uproot = rz_config_get (core->config, "http.uproot");
+				if (!rs->path[3] || (rs->path[3]=='/' && !rs->path[4])) {
+					char *ptr = rtr_dir_files (uproot);
+					rz_socket_http_response (rs, 200, ptr, 0, headers);
+					free (ptr);
+				} else {
+					char *path = rz_file_root (uproot, rs->path + 4);
+					if (rz_file_exists (path)) {
+						size_t sz = 0;
+						char *f = rz_file_slurp (path, &sz);
+						if (f) {
+							rz_socket_http_response (rs, 200, f, (int)sz, headers);
+							free (f);
+						} else {
+							rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
+							http_logf (core, "http: Cannot open '%s'\n", path);
+						}
+					} else {
+						if (dir) {
+							char *resp = rtr_dir_files (dir);
+							rz_socket_http_response (rs, 404, resp, 0, headers);
+							free (resp);
+						} else {
+							http_logf (core, "File '%s' not found\n", path);
+							rz_socket_http_response (rs, 404, "File not found\n", 0, headers);
+						}
+					}
+					free (path);
+				}
+			} else {
+				rz_socket_http_response (rs, 403, "", 0, NULL);
+			}
+		} else if (!strncmp (rs->path, "/cmd/", 5)) {
+			const bool colon = rz_config_get_i (core->config, "http.colon");
+			if (colon && rs->path[5] != ':') {
+				rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
+			} else {
+				char *cmd = rs->path + 5;
+				const char *httpcmd = rz_config_get (core->config, "http.uri");
+				const char *httpref = rz_config_get (core->config, "http.referer");
+				const bool httpref_enabled = (httpref && *httpref);
+				char *refstr = NULL;
+				if (httpref_enabled) {
+					if (strstr (httpref, "http")) {
+						refstr = strdup (httpref);
+					} else {
+						refstr = rz_str_newf ("http://localhost:%d/", atoi (port));
+					}
+				}
+
+				while (*cmd == '/') {
+					cmd++;
+				}
+				if (httpref_enabled && (!rs->referer || (refstr && !strstr (rs->referer, refstr)))) {
+					rz_socket_http_response (rs, 503, "", 0, headers);
+				} else {
+					if (httpcmd && *httpcmd) {
+						int len; // do remote http query and proxy response
+						char *res, *bar = rz_str_newf ("%s/%s", httpcmd, cmd);
+						void *bed = http_sleep_begin (srv);
+						res = rz_socket_http_get (bar, NULL, &len);
+						http_sleep_end (srv, bed);
+						if (res) {
+							res[len] = 0;
+							rz_socket_http_response (rs, 200, res, len, headers);
+							free (res);
+						} else {
+							rz_socket_http_response (rs, 404, "", 0, headers);
+						}
+						free (bar);
+					} else {
+						char *cmd = rs->path + 5;
+						rz_str_uri_decode (cmd);
+						if (!rz_sandbox_enable (0) &&
+								(!strcmp (cmd, "=h*") ||
+								 !strcmp (cmd, "=h--"))) {
+							rz_socket_http_response (rs, 200, "", 0, headers);
+							free (dir);
+							free (refstr);
+							return !strcmp (cmd, "=h*")? HTTP_RESTART: HTTP_STOP;
+						}
+						http_cmd (srv, rs, cmd, headers);
+					}
+				}
+				free (refstr);
+			}
+		} else {
+			const char *root = rz_config_get (core->config, "http.root");
+			const char *homeroot = rz_config_get (core->config, "http.homeroot");
+			char *path = NULL;
+			if (!strcmp (rs->path, "/")) {
+				free (rs->path);
+				if (*index == '/') {
+					rs->path = strdup (index);
+					path = strdup (index);
+				} else {
+					rs->path = rz_str_newf ("/%s", index);
+					path = rz_file_root (root, rs->path);
+				}
+			} else if (homeroot && *homeroot) {
+				char *homepath = rz_file_abspath (homeroot);
+				path = rz_file_root (homepath, rs->path);
+				free (homepath);
+				if (!rz_file_exists (path) && !rz_file_is_directory (path)) {
+					free (path);
+					path = rz_file_root (root, rs->path);
+				}
+			} else {
+				if (*index == '/') {
+					path = strdup (index);
+				} else {
+				}
+			}
+			// FD IS OK HERE
+			if (rs->path [strlen (rs->path) - 1] == '/') {
+				path = (*index == '/')? strdup (index): rz_str_append (path, index);
+			} else {
+				//snprintf (path, sizeof (path), "%s/%s", root, rs->path);
+				if (rz_file_is_directory (path)) {
+					char *res = rz_str_newf ("Location: %s/\n%s", rs->path, headers);
+					rz_socket_http_response (rs, 302, NULL, 0, res);
+					free (path);
+					free (res);
+					free (dir);
+					return HTTP_NEXT;
+				}
+			}
+			if (rz_file_exists (path)) {
+				size_t sz = 0;
+				char *f = rz_file_slurp (path, &sz);
+				if (f) {
+					const char *ct = NULL;
+					if (strstr (path, ".js")) {
+						ct = "Content-Type: application/javascript\n";
+					}
+					if (strstr (path, ".css")) {
+						ct = "Content-Type: text/css\n";
+					}
+					if (strstr (path, ".html")) {
+						ct = "Content-Type: text/html\n";
+					}
+					char *hdr = rz_str_newf ("%s%s", ct, headers);
+					rz_socket_http_response (rs, 200, f, (int)sz, hdr);
+					free (hdr);
+					free (f);
+				} else {
+					rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
+					http_logf (core, "http: Cannot open '%s'\n", path);
+				}
+			} else {
+				if (dir) {
+					char *resp = rtr_dir_files (dir);
+					http_logf (core, "Dirlisting %s\n", dir);
+					rz_socket_http_response (rs, 404, resp, 0, headers);
+					free (resp);
+				} else {
+					http_logf (core, "File '%s' not found\n", path);
+					rz_socket_http_response (rs, 404, "File not found\n", 0, headers);
+				}
+			}
+			free (path);
+		}
+	} else if (!strcmp (rs->method, "POST")) {
+		ut8 *ret;
+		int retlen;
+		char buf[128];
+		if (rz_config_get_i (core->config, "http.upload")) {
+			ret = rz_socket_http_handle_upload (rs->data, rs->data_length, &retlen);
+			if (ret) {
+				ut64 size = rz_config_get_i (core->config, "http.maxsize");
+				if (size && retlen > size) {
+					rz_socket_http_response (rs, 403, "403 File too big\n", 0, headers);
+				} else {
+					char *filename = rz_file_root (
+						rz_config_get (core->config, "http.uproot"),
+						rs->path + 4);
+					http_logf (core, "UPLOADED '%s'\n", filename);
+					rz_file_dump (filename, ret, retlen, 0);
+					free (filename);
+					snprintf (buf, sizeof (buf),
+						"<html><body><h2>uploaded %d byte(s). Thanks</h2>\n", retlen);
+						rz_socket_http_response (rs, 200, buf, 0, headers);
+				}
+				free (ret);
+			}
+		} else {
+			rz_socket_http_response (rs, 403, "403 Forbidden\n", 0, headers);
+		}
+	} else {
+		rz_socket_http_response (rs, 404, "Invalid protocol", 0, headers);
+	}
+	free (dir);
+	return HTTP_NEXT;
+}
+
+static RzThreadFunctionRet http_worker(RzThread *th) {
+	HttpServer *srv = th->user;
+	rz_th_lock_enter (srv->lock);
+	for (;;) {
+		while (!srv->stop && rz_list_empty (srv->queue)) {
+			rz_th_cond_wait (srv->cond, srv->lock);
+		}
+		if (srv->stop) {
+			break;
+		}
+		RzSocket *client = rz_list_pop_head (srv->queue);
+		rz_th_lock_leave (srv->lock);
+		RzSocketHTTPRequest *rs = rz_socket_http_read (client, srv->so);
+		while (rs) {
+			http_gate_enter (srv, false);
+			int status = rtr_http_request (srv, rs);
+			http_gate_leave (srv, false);
+			rz_th_lock_enter (srv->lock);
+			if (status != HTTP_NEXT && !srv->stop) {
+				srv->status = status;
+				srv->stop = true;
+				rz_th_cond_signal_all (srv->cond);
+			}
+			bool stop = srv->stop;
+			rz_th_lock_leave (srv->lock);
+			if (stop) {
+				rz_socket_http_close (rs);
+				break;
+			}
+			rs = rz_socket_http_next (rs, srv->so);
+		}
+		rz_th_lock_enter (srv->lock);
+	}
+	rz_th_lock_leave (srv->lock);
+	return RZ_TH_STOP;
+}
+
+// Accepts connections and hands them to the workers until the server is
+// stopped, returns what rz_core_rtr_http_run () should return
+static int http_pool_run(HttpServer *srv, RzSocket *s, int workers) {
+	RzConsContext *ctx = rz_cons_context ();
+	int ret = 1;
+	srv->lock = rz_th_lock_new (false);
+	srv->cond = rz_th_cond_new ();
+	srv->queue = rz_list_newf ((RzListFree)rz_socket_free);
+	srv->threads = RZ_NEWS0 (RzThread *, workers);
+	if (!srv->lock || !srv->cond || !srv->queue || !srv->threads) {
+		goto beach;
+	}
+	int i;
+	for (i = 0; i < workers; i++) {
+		srv->threads[i] = rz_th_new (http_worker, srv, 0);
+		if (!srv->threads[i]) {
+			break;
+		}
+		srv->nthreads++;
+	}
+	if (!srv->nthreads) {
+		goto beach;
+	}
+	activateDieTime (srv->core);
+	// the workers run the commands as tasks while the main one sleeps here
+	void *bed = rz_cons_sleep_begin ();
+	while (!ctx->breaked) {
+		RzSocket *client = rz_socket_accept_timeout (s, 1);
+		rz_th_lock_enter (srv->lock);
+		bool stop = srv->stop;
+		if (client && !stop) {
+			rz_list_append (srv->queue, client);
+			rz_th_cond_signal_all (srv->cond);
+			client = NULL;
+		}
+		rz_th_lock_leave (srv->lock);
+		if (stop) {
+			rz_socket_free (client);
+			break;
+		}
+	}
+	rz_cons_sleep_end (bed);
+	ret = srv->status == HTTP_RESTART ? -2 : 0;
+beach:
+	if (srv->lock) {
+		rz_th_lock_enter (srv->lock);
+		srv->stop = true;
+		if (srv->cond) {
+			rz_th_cond_signal_all (srv->cond);
+		}
+		rz_th_lock_leave (srv->lock);
+	}
+	for (i = 0; i < srv->nthreads; i++) {
+		rz_th_wait (srv->threads[i]);
+		rz_th_free (srv->threads[i]);
+	}
+	rz_list_free (srv->queue);
+	rz_th_lock_free (srv->lock);
+	rz_th_cond_free (srv->cond);
+	free (srv->threads);
+	return ret;
+}
+
 // return 1 on error
 static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char *path) {
 	RzConfig *newcfg = NULL, *origcfg = NULL;
-	char headers[128] = RZ_EMPTY;
 	RzSocketHTTPRequest *rs;
 	char buf[32];
 	int ret = 0;
 	RzSocket *s;
 	RzSocketHTTPOptions so;
-	char *dir;
 	int iport;
 	const char *host = rz_config_get (core->config, "http.bind");
-	const char *index = rz_config_get (core->config, "http.index");
 	const char *root = rz_config_get (core->config, "http.root");
 	const char *homeroot = rz_config_get (core->config, "http.homeroot");
 	const char *port = rz_config_get (core->config, "http.port");
-	const char *allow = rz_config_get (core->config, "http.allow");
 	const char *httpui = rz_config_get (core->config, "http.ui");
 	const char *httpauthfile = rz_config_get (core->config, "http.authfile");
 	char *pfile = NULL;
@@ -151,8 +676,25 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 	memcpy (newblk, core->block, core->blocksize);
 
 	core->block = newblk;
-// TODO: handle mutex lock/unlock here
 	rz_cons_break_push ((RzConsBreak)rz_core_rtr_http_stop, core);
+	int workers = rz_config_get_i (core->config, "http.workers");
+	HttpServer srv = {
+		.core = core,
+		.so = &so,
+		.port = port,
+		.pool = workers > 0,
+		.chunk = rz_config_get_i (core->config, "http.chunk"),
+	};
+	if (srv.pool) {
+		// the http environment stays installed while the workers serve
+		so.keepalive = rz_config_get_i (core->config, "http.keepalive");
+		ret = http_pool_run (&srv, s, RZ_MIN (workers, 64));
+		free (core->block);
+		core->offset = origoff;
+		core->block = origblk;
+		core->blocksize = origblksz;
+		goto the_end;
+	}
 	while (!rz_cons_is_breaked ()) {
 		/* restore environment */
 		core->config = origcfg;
@@ -198,287 +740,12 @@ static int rz_core_rtr_http_run(RzCore *core, int launch, int browse, const char
 			rz_cons_sleep_end (bed);
 			continue;
 		}
-		if (allow && *allow) {
-			bool accepted = false;
-			const char *allows_host;
-			char *p, *peer = rz_socket_to_string (rs->s);
-			char *allows = strdup (allow);
-			//eprintf ("Firewall (%s)\n", allows);
-			int i, count = rz_str_split (allows, ',');
-			p = strchr (peer, ':');
-			if (p) {
-				*p = 0;
-			}
-			for (i = 0; i < count; i++) {
-				allows_host = rz_str_word_get0 (allows, i);
-				//eprintf ("--- (%s) (%s)\n", host, peer);
-				if (!strcmp (allows_host, peer)) {
-					accepted = true;
-					break;
-				}
-			}
-			free (peer);
-			free (allows);
-			if (!accepted) {
-				rz_socket_http_close (rs);
-				continue;
-			}
-		}
-		if (!rs->method || !rs->path) {
-			http_logf (core, "Invalid http headers received from client\n");
-			rz_socket_http_close (rs);
-			continue;
-		}
-		dir = NULL;
-
-		if (!rs->auth) {
-			rz_socket_http_response (rs, 401, "", 0, NULL);
-		}
-
-		if (rz_config_get_i (core->config, "http.verbose")) {
-			char *peer = rz_socket_to_string (rs->s);
-			http_logf (core, "[HTTP] %s %s\n", peer, rs->path);
-			free (peer);
-		}
-		if (rz_config_get_i (core->config, "http.dirlist")) {
-			if (rz_file_is_directory (rs->path)) {
-				dir = strdup (rs->path);
-			}
-		}
-		if (rz_config_get_i (core->config, "http.cors")) {
-			strcpy (headers, "Access-Control-Allow-Origin: *\n"
-				"Access-Control-Allow-Headers: Origin, "
-				"X-Requested-With, Content-Type, Accept\n");
-		}
-		if (!strcmp (rs->method, "OPTIONS")) {
-			rz_socket_http_response (rs, 200, "", 0, headers);
-		} else if (!strcmp (rs->method, "GET")) {
-			if (!strncmp (rs->path, "/up/", 4)) {
-				if (rz_config_get_i (core->config, "http.upget")) {
-					const char *uproot = rz_config_get (core->config, "http.uproot");
-					if (!rs->path[3] || (rs->path[3]=='/' && !rs->path[4])) {
-						char *ptr = rtr_dir_files (uproot);
-						rz_socket_http_response (rs, 200, ptr, 0, headers);
-						free (ptr);
-					} else {
-						char *path = rz_file_root (uproot, rs->path + 4);
-						if (rz_file_exists (path)) {
-							size_t sz = 0;
-							char *f = rz_file_slurp (path, &sz);
-							if (f) {
-								rz_socket_http_response (rs, 200, f, (int)sz, headers);
-								free (f);
-							} else {
-								rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
-								http_logf (core, "http: Cannot open '%s'\n", path);
-							}
-						} else {
-							if (dir) {
-								char *resp = rtr_dir_files (dir);
-								rz_socket_http_response (rs, 404, resp, 0, headers);
-								free (resp);
-							} else {
-								http_logf (core, "File '%s' not found\n", path);
-								rz_socket_http_response (rs, 404, "File not found\n", 0, headers);
-							}
-						}
-						free (path);
-					}
-				} else {
-					rz_socket_http_response (rs, 403, "", 0, NULL);
-				}
-			} else if (!strncmp (rs->path, "/cmd/", 5)) {
-				const bool colon = rz_config_get_i (core->config, "http.colon");
-				if (colon && rs->path[5] != ':') {
-					rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
-				} else {
-					char *cmd = rs->path + 5;
-					const char *httpcmd = rz_config_get (core->config, "http.uri");
-					const char *httpref = rz_config_get (core->config, "http.referer");
-					const bool httpref_enabled = (httpref && *httpref);
-					char *refstr = NULL;
-					if (httpref_enabled) {
-						if (strstr (httpref, "http")) {
-							refstr = strdup (httpref);
-						} else {
-							refstr = rz_str_newf ("http://localhost:%d/", atoi (port));
-						}
-					}
-
-					while (*cmd == '/') {
-						cmd++;
-					}
-					if (httpref_enabled && (!rs->referer || (refstr && !strstr (rs->referer, refstr)))) {
-						rz_socket_http_response (rs, 503, "", 0, headers);
-					} else {
-						if (httpcmd && *httpcmd) {
-							int len; // do remote http query and proxy response
-							char *res, *bar = rz_str_newf ("%s/%s", httpcmd, cmd);
-							bed = rz_cons_sleep_begin ();
-							res = rz_socket_http_get (bar, NULL, &len);
-							rz_cons_sleep_end (bed);
-							if (res) {
-								res[len] = 0;
-								rz_cons_println (res);
-							}
-							free (bar);
-						} else {
-							char *out, *cmd = rs->path + 5;
-							rz_str_uri_decode (cmd);
-							rz_config_set (core->config, "scr.interactive", "false");
-
-							if (!rz_sandbox_enable (0) &&
-									(!strcmp (cmd, "=h*") ||
-									 !strcmp (cmd, "=h--"))) {
-								out = NULL;
-							} else if (*cmd == ':') {
-								/* commands in /cmd/: starting with : do not show any output */
-								rz_core_cmd0 (core, cmd + 1);
-								out = NULL;
-							} else {
-								out = rz_core_cmd_str_pipe (core, cmd);
-							}
-
-							if (out) {
-								char *res = rz_str_uri_encode (out);
-								char *newheaders = rz_str_newf (
-										"Content-Type: text/plain\n%s", headers);
-								rz_socket_http_response (rs, 200, out, 0, newheaders);
-								free (out);
-								free (newheaders);
-								free (res);
-							} else {
-								rz_socket_http_response (rs, 200, "", 0, headers);
-							}
-
-							if (!rz_sandbox_enable (0)) {
-								if (!strcmp (cmd, "=h*")) {
-									/* do stuff */
-									rz_socket_http_close (rs);
-									free (dir);
-									free (refstr);
-									ret = -2;
-									goto the_end;
-								} else if (!strcmp (cmd, "=h--")) {
-									rz_socket_http_close (rs);
-									free (dir);
-									free (refstr);
-									ret = 0;
-									goto the_end;
-								}
-							}
-						}
-					}
-					free (refstr);
-				}
-			} else {
-				const char *root = rz_config_get (core->config, "http.root");
-				const char *homeroot = rz_config_get (core->config, "http.homeroot");
-				char *path = NULL;
-				if (!strcmp (rs->path, "/")) {
-					free (rs->path);
-					if (*index == '/') {
-						rs->path = strdup (index);
-						path = strdup (index);
-					} else {
-						rs->path = rz_str_newf ("/%s", index);
-						path = rz_file_root (root, rs->path);
-					}
-				} else if (homeroot && *homeroot) {
-					char *homepath = rz_file_abspath (homeroot);
-					path = rz_file_root (homepath, rs->path);
-					free (homepath);
-					if (!rz_file_exists (path) && !rz_file_is_directory (path)) {
-						free (path);
-						path = rz_file_root (root, rs->path);
-					}
-				} else {
-					if (*index == '/') {
-						path = strdup (index);
-					} else {
-					}
-				}
-				// FD IS OK HERE
-				if (rs->path [strlen (rs->path) - 1] == '/') {
-					path = (*index == '/')? strdup (index): rz_str_append (path, index);
-				} else {
-					//snprintf (path, sizeof (path), "%s/%s", root, rs->path);
-					if (rz_file_is_directory (path)) {
-						char *res = rz_str_newf ("Location: %s/\n%s", rs->path, headers);
-						rz_socket_http_response (rs, 302, NULL, 0, res);
-						rz_socket_http_close (rs);
-						free (path);
-						free (res);
-						RZ_FREE (dir);
-						continue;
-					}
-				}
-				if (rz_file_exists (path)) {
-					size_t sz = 0;
-					char *f = rz_file_slurp (path, &sz);
-					if (f) {
-						const char *ct = NULL;
-						if (strstr (path, ".js")) {
-							ct = "Content-Type: application/javascript\n";
-						}
-						if (strstr (path, ".css")) {
-							ct = "Content-Type: text/css\n";
-						}
-						if (strstr (path, ".html")) {
-							ct = "Content-Type: text/html\n";
-						}
-						char *hdr = rz_str_newf ("%s%s", ct, headers);
-						rz_socket_http_response (rs, 200, f, (int)sz, hdr);
-						free (hdr);
-						free (f);
-					} else {
-						rz_socket_http_response (rs, 403, "Permission denied", 0, headers);
-						http_logf (core, "http: Cannot open '%s'\n", path);
-					}
-				} else {
-					if (dir) {
-						char *resp = rtr_dir_files (dir);
-						http_logf (core, "Dirlisting %s\n", dir);
-						rz_socket_http_response (rs, 404, resp, 0, headers);
-						free (resp);
-					} else {
-						http_logf (core, "File '%s' not found\n", path);
-						rz_socket_http_response (rs, 404, "File not found\n", 0, headers);
-					}
-				}
-				free (path);
-			}
-		} else if (!strcmp (rs->method, "POST")) {
-			ut8 *ret;
-			int retlen;
-			char buf[128];
-			if (rz_config_get_i (core->config, "http.upload")) {
-				ret = rz_socket_http_handle_upload (rs->data, rs->data_length, &retlen);
-				if (ret) {
-					ut64 size = rz_config_get_i (core->config, "http.maxsize");
-					if (size && retlen > size) {
-						rz_socket_http_response (rs, 403, "403 File too big\n", 0, headers);
-					} else {
-						char *filename = rz_file_root (
-							rz_config_get (core->config, "http.uproot"),
-							rs->path + 4);
-						http_logf (core, "UPLOADED '%s'\n", filename);
-						rz_file_dump (filename, ret, retlen, 0);
-						free (filename);
-						snprintf (buf, sizeof (buf),
-							"<html><body><h2>uploaded %d byte(s). Thanks</h2>\n", retlen);
-							rz_socket_http_response (rs, 200, buf, 0, headers);
-					}
-					free (ret);
-				}
-			} else {
-				rz_socket_http_response (rs, 403, "403 Forbidden\n", 0, headers);
-			}
-		} else {
-			rz_socket_http_response (rs, 404, "Invalid protocol", 0, headers);
-		}
+		int status = rtr_http_request (&srv, rs);
 		rz_socket_http_close (rs);
-		free (dir);
+		if (status != HTTP_NEXT) {
+			ret = status == HTTP_RESTART ? -2 : 0;
+			goto the_end;
+		}
 	}
 the_end:
 	{
@@ -11,16 +11,33 @@ RZ_API void rz_core_task_scheduler_init (RzCoreTaskScheduler *tasks, RzCore *cor
 	tasks->lock = rz_th_lock_new (true);
 	tasks->tasks_running = 0;
 	tasks->oneshot_running = false;
+	tasks->gate_lock = rz_th_lock_new (false);
+	tasks->gate_cond = rz_th_cond_new ();
+	tasks->readers = 0;
+	tasks->readers_waiting = 0;
+	tasks->readers_pass = 0;
+	tasks->writers_waiting = 0;
+	tasks->writer = false;
+	tasks->workers = NULL;
+	tasks->workers_count = 0;
+	tasks->workers_next = 0;
+	tasks->workers_pending = 0;
+	tasks->workers_stop = false;
 	tasks->main_task = rz_core_task_new (core, false, NULL, NULL, NULL);
 	rz_list_append (tasks->tasks, tasks->main_task);
 	tasks->current_task = NULL;
 }
 
+static void workers_stop(RzCoreTaskScheduler *tasks);
+
 RZ_API void rz_core_task_scheduler_fini (RzCoreTaskScheduler *tasks) {
+	workers_stop (tasks);
 	rz_list_free (tasks->tasks);
 	rz_list_free (tasks->tasks_queue);
 	rz_list_free (tasks->oneshot_queue);
 	rz_th_lock_free (tasks->lock);
+	rz_th_cond_free (tasks->gate_cond);
+	rz_th_lock_free (tasks->gate_lock);
 }
 
 #if HAVE_PTHREAD
@@ -56,6 +73,80 @@ typedef struct oneshot_t {
 	void *user;
 } OneShot;
 
+// Worker thread running parallel tasks. It takes them from the head of its
+// own deque and, when that is empty, steals from the tail of the others.
+typedef struct rz_core_task_worker_t {
+	RzCoreTaskScheduler *scheduler;
+	RzThread *thread;
+	RzThreadLock *lock;
+	RzList *deque;
+} RzCoreTaskWorker;
+
+// Task and worker of the calling thread, when it is a worker
+static RZ_TH_LOCAL RzCoreTask *task_local = NULL;
+static RZ_TH_LOCAL RzCoreTaskWorker *worker_local = NULL;
+
+static ut64 task_cpu_time(void) {
+#if __WINDOWS__
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes (GetCurrentThread (), &creation, &exit, &kernel, &user)) {
+		return 0;
+	}
+	ut64 k = ((ut64)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	ut64 u = ((ut64)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (k + u) / 10;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+	struct timespec ts;
+	if (clock_gettime (CLOCK_THREAD_CPUTIME_ID, &ts)) {
+		return 0;
+	}
+	return (ut64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+	return 0;
+#endif
+}
+
+static void gate_write_enter(RzCoreTaskScheduler *scheduler) {
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->writers_waiting++;
+	while (scheduler->writer || scheduler->readers || scheduler->readers_pass) {
+		rz_th_cond_wait (scheduler->gate_cond, scheduler->gate_lock);
+	}
+	scheduler->writers_waiting--;
+	scheduler->writer = true;
+	rz_th_lock_leave (scheduler->gate_lock);
+}
+
+static void gate_write_leave(RzCoreTaskScheduler *scheduler) {
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->writer = false;
+	// the readers waiting now go before the next writer
+	scheduler->readers_pass = scheduler->readers_waiting;
+	rz_th_cond_signal_all (scheduler->gate_cond);
+	rz_th_lock_leave (scheduler->gate_lock);
+}
+
+static void gate_read_enter(RzCoreTaskScheduler *scheduler) {
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->readers_waiting++;
+	while (scheduler->writer || (scheduler->writers_waiting && !scheduler->readers_pass)) {
+		rz_th_cond_wait (scheduler->gate_cond, scheduler->gate_lock);
+	}
+	scheduler->readers_waiting--;
+	if (scheduler->readers_pass) {
+		scheduler->readers_pass--;
+	}
+	scheduler->readers++;
+	rz_th_lock_leave (scheduler->gate_lock);
+}
+
+static void gate_read_leave(RzCoreTaskScheduler *scheduler) {
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->readers--;
+	rz_th_cond_signal_all (scheduler->gate_cond);
+	rz_th_lock_leave (scheduler->gate_lock);
+}
+
 RZ_API void rz_core_task_print (RzCore *core, RzCoreTask *task, int mode) {
 	switch (mode) {
 	case 'j':
@@ -75,7 +166,18 @@ RZ_API void rz_core_task_print (RzCore *core, RzCoreTask *task, int mode) {
 			rz_cons_print ("done");
 			break;
 		}
-		rz_cons_printf ("\",\"transient\":%s,\"cmd\":", task->transient ? "true" : "false");
+		ut64 now = rz_time_now_mono ();
+		ut64 started = task->time_started ? task->time_started : now;
+		ut64 finished = task->time_finished ? task->time_finished : now;
+		rz_cons_printf ("\",\"transient\":%s,\"parallel\":%s", task->transient ? "true" : "false", task->parallel ? "true" : "false");
+		if (task->time_created) {
+			// msecs waiting to start and running, cpu time is known once done
+			rz_cons_printf (",\"wait\":%" PFMT64u ",\"run\":%" PFMT64u ",\"cpu\":%" PFMT64u,
+				(started - task->time_created) / 1000,
+				task->time_started ? (finished - started) / 1000 : 0,
+				task->cpu_time / 1000);
+		}
+		rz_cons_printf (",\"cmd\":");
 		if (task->cmd) {
 			rz_cons_printf ("\"%s\"}", task->cmd);
 		} else {
@@ -146,6 +248,10 @@ static void task_join(RzCoreTask *task) {
 }
 
 RZ_API void rz_core_task_join(RzCoreTaskScheduler *scheduler, RzCoreTask *current, int id) {
+	if (task_local && &task_local->core->tasks == scheduler) {
+		// on a worker the task going to sleep is always the one it runs
+		current = task_local;
+	}
 	if (current && id == current->id) {
 		return;
 	}
@@ -226,7 +332,7 @@ RZ_API RzCoreTask *rz_core_task_new(RzCore *core, bool create_cons, const char *
 	}
 
 	if (create_cons) {
-		task->cons_context = rz_cons_context_new (rz_cons_singleton ()->context);
+		task->cons_context = rz_cons_context_new (rz_cons_context ());
 		if (!task->cons_context) {
 			goto fail;
 		}
@@ -240,6 +346,7 @@ RZ_API RzCoreTask *rz_core_task_new(RzCore *core, bool create_cons, const char *
 	task->core = core;
 	task->user = user;
 	task->cb = cb;
+	task->time_created = rz_time_now_mono ();
 
 	return task;
 
@@ -272,16 +379,45 @@ RZ_API void rz_core_task_decref (RzCoreTask *task) {
 	tasks_lock_leave (scheduler, &old_sigset);
 }
 
+// Parallel tasks only step aside for the serial ones waiting for the core
+static void task_parallel_schedule(RzCoreTask *current, RTaskState next_state) {
+	RzCoreTaskScheduler *scheduler = &current->core->tasks;
+	if (next_state == RZ_CORE_TASK_STATE_RUNNING) {
+		if (scheduler->writers_waiting) {
+			gate_read_leave (scheduler);
+			gate_read_enter (scheduler);
+		}
+		return;
+	}
+	current->state = next_state;
+	if (current->core_held) {
+		current->core_held = false;
+		gate_read_leave (scheduler);
+	}
+}
+
 RZ_API void rz_core_task_schedule(RzCoreTask *current, RTaskState next_state) {
 	RzCore *core = current->core;
 	RzCoreTaskScheduler *scheduler = &core->tasks;
 	bool stop = next_state != RZ_CORE_TASK_STATE_RUNNING;
 
-	if (scheduler->oneshot_running || (!stop && scheduler->tasks_running == 1 && scheduler->oneshots_enqueued == 0)) {
+	if (current->parallel) {
+		task_parallel_schedule (current, next_state);
+		return;
+	}
+	if (scheduler->oneshot_running || (!stop && scheduler->tasks_running == 1 && scheduler->oneshots_enqueued == 0 && !scheduler->readers_waiting)) {
 		return;
 	}
 
 	scheduler->current_task = NULL;
+	if (stop) {
+		current->wakeups--;
+	}
+	// a nested run ending does not give up the core of the outer one
+	if (current->core_held && (next_state != RZ_CORE_TASK_STATE_DONE || current->wakeups <= 0)) {
+		current->core_held = false;
+		gate_write_leave (scheduler);
+	}
 
 	TASK_SIGSET_T old_sigset;
 	tasks_lock_enter (scheduler, &old_sigset);
@@ -328,6 +464,10 @@ RZ_API void rz_core_task_schedule(RzCoreTask *current, RTaskState next_state) {
 	}
 
 	if (!stop) {
+		if (!current->core_held) {
+			gate_write_enter (scheduler);
+			current->core_held = true;
+		}
 		scheduler->current_task = current;
 		if (current->cons_context) {
 			rz_cons_context_load (current->cons_context);
@@ -341,6 +481,13 @@ static void task_wakeup(RzCoreTask *current) {
 	RzCore *core = current->core;
 	RzCoreTaskScheduler *scheduler = &core->tasks;
 
+	if (current->parallel) {
+		gate_read_enter (scheduler);
+		current->core_held = true;
+		current->state = RZ_CORE_TASK_STATE_RUNNING;
+		return;
+	}
+
 	TASK_SIGSET_T old_sigset;
 	tasks_lock_enter (scheduler, &old_sigset);
 
@@ -369,6 +516,11 @@ static void task_wakeup(RzCoreTask *current) {
 
 	rz_th_lock_leave (current->dispatch_lock);
 
+	current->wakeups++;
+	if (!current->core_held) {
+		gate_write_enter (scheduler);
+		current->core_held = true;
+	}
 	scheduler->current_task = current;
 
 	if (current->cons_context) {
@@ -390,24 +542,23 @@ static void task_end(RzCoreTask *t) {
 	rz_core_task_schedule (t, RZ_CORE_TASK_STATE_DONE);
 }
 
-static RzThreadFunctionRet task_run(RzCoreTask *task) {
+static void task_cmd(RzCoreTask *task) {
 	RzCore *core = task->core;
-	RzCoreTaskScheduler *scheduler = &task->core->tasks;
-
-	task_wakeup (task);
-
-	if (task->cons_context && task->cons_context->breaked) {
-		// breaked in RZ_CORE_TASK_STATE_BEFORE_START
-		goto nonstart;
-	}
-
+	RzCoreTaskScheduler *scheduler = &core->tasks;
 	char *res_str;
+	task->time_started = rz_time_now_mono ();
 	if (task == scheduler->main_task) {
 		rz_core_cmd (core, task->cmd, task->cmd_log);
 		res_str = NULL;
+	} else if (task->cons_context && task->cons_context->stream_cb) {
+		// the output goes to the callback as it is produced
+		rz_core_cmd (core, task->cmd, task->cmd_log);
+		rz_cons_flush ();
+		res_str = NULL;
 	} else {
 		res_str = rz_core_cmd_str (core, task->cmd);
 	}
+	task->time_finished = rz_time_now_mono ();
 
 	free (task->res);
 	task->res = res_str;
@@ -415,13 +566,11 @@ static RzThreadFunctionRet task_run(RzCoreTask *task) {
 	if (task != scheduler->main_task && rz_cons_default_context_is_interactive ()) {
 		eprintf ("\nTask %d finished\n", task->id);
 	}
+}
 
-	TASK_SIGSET_T old_sigset;
-nonstart:
-	tasks_lock_enter (scheduler, &old_sigset);
-
-	task_end (task);
-
+// Called with the tasks lock held once task is done
+static int task_finish(RzCoreTask *task) {
+	RzCoreTaskScheduler *scheduler = &task->core->tasks;
 	if (task->cb) {
 		task->cb (task->user, task->res);
 	}
@@ -446,11 +595,178 @@ nonstart:
 			}
 		}
 	}
+	return ret;
+}
+
+static RzThreadFunctionRet task_run(RzCoreTask *task) {
+	RzCoreTaskScheduler *scheduler = &task->core->tasks;
+
+	task_wakeup (task);
+
+	// not when breaked in RZ_CORE_TASK_STATE_BEFORE_START
+	if (!task->cons_context || !task->cons_context->breaked) {
+		task_cmd (task);
+	}
+	if (task != scheduler->main_task) {
+		task->cpu_time = task_cpu_time ();
+	}
 
+	TASK_SIGSET_T old_sigset;
+	tasks_lock_enter (scheduler, &old_sigset);
+	task_end (task);
+	int ret = task_finish (task);
 	tasks_lock_leave (scheduler, &old_sigset);
 	return ret;
 }
 
+// Runs a parallel task on the calling worker
+static void task_run_parallel(RzCoreTask *task) {
+	RzCoreTaskScheduler *scheduler = &task->core->tasks;
+	ut64 cpu_time = task_cpu_time ();
+	task_local = task;
+	rz_cons_context_load_local (task->cons_context);
+
+	task_wakeup (task);
+	if (!task->cons_context->breaked) {
+		task_cmd (task);
+	}
+	task_parallel_schedule (task, RZ_CORE_TASK_STATE_DONE);
+
+	rz_cons_context_load_local (NULL);
+	task_local = NULL;
+	task->cpu_time += task_cpu_time () - cpu_time;
+
+	TASK_SIGSET_T old_sigset;
+	tasks_lock_enter (scheduler, &old_sigset);
+	task_finish (task);
+	tasks_lock_leave (scheduler, &old_sigset);
+}
+
+// Takes the next task from the head of the deque of w or, when it is
+// empty, from the tail of another one
+static RzCoreTask *worker_take(RzCoreTaskWorker *w) {
+	RzCoreTaskScheduler *scheduler = w->scheduler;
+	RzCoreTask *task = NULL;
+	int i, self = w - scheduler->workers;
+	for (i = 0; i < scheduler->workers_count && !task; i++) {
+		RzCoreTaskWorker *victim = &scheduler->workers[(self + i) % scheduler->workers_count];
+		rz_th_lock_enter (victim->lock);
+		task = victim == w
+			? rz_list_pop_head (victim->deque)
+			: rz_list_pop (victim->deque);
+		rz_th_lock_leave (victim->lock);
+	}
+	if (task) {
+		rz_th_lock_enter (scheduler->gate_lock);
+		scheduler->workers_pending--;
+		rz_th_lock_leave (scheduler->gate_lock);
+	}
+	return task;
+}
+
+static RzThreadFunctionRet worker_run(RzThread *th) {
+	RzCoreTaskWorker *w = th->user;
+	RzCoreTaskScheduler *scheduler = w->scheduler;
+	worker_local = w;
+	for (;;) {
+		RzCoreTask *task = worker_take (w);
+		if (task) {
+			task_run_parallel (task);
+			continue;
+		}
+		rz_th_lock_enter (scheduler->gate_lock);
+		while (!scheduler->workers_stop && !scheduler->workers_pending) {
+			rz_th_cond_wait (scheduler->gate_cond, scheduler->gate_lock);
+		}
+		bool stop = scheduler->workers_stop;
+		rz_th_lock_leave (scheduler->gate_lock);
+		if (stop) {
+			break;
+		}
+	}
+	worker_local = NULL;
+	return RZ_TH_STOP;
+}
+
+// Starts the workers running the parallel tasks, tasks.workers of them or
+// one per cpu, returns false if there are none
+static bool workers_start(RzCoreTaskScheduler *scheduler, RzCore *core) {
+	if (scheduler->workers) {
+		return true;
+	}
+	int count = rz_config_get_i (core->config, "tasks.workers");
+	if (count <= 0) {
+		count = rz_th_cpu_count ();
+	}
+	count = RZ_MIN (count, 64);
+	RzCoreTaskWorker *workers = RZ_NEWS0 (RzCoreTaskWorker, count);
+	if (!workers) {
+		return false;
+	}
+	scheduler->workers = workers;
+	int i;
+	for (i = 0; i < count; i++) {
+		RzCoreTaskWorker *w = &workers[i];
+		w->scheduler = scheduler;
+		w->lock = rz_th_lock_new (false);
+		w->deque = rz_list_new ();
+		if (!w->lock || !w->deque) {
+			rz_th_lock_free (w->lock);
+			rz_list_free (w->deque);
+			break;
+		}
+		scheduler->workers_count++;
+	}
+	// all the deques must exist before anyone tries to steal from them
+	bool started = false;
+	for (i = 0; i < scheduler->workers_count; i++) {
+		workers[i].thread = rz_th_new (worker_run, &workers[i], 0);
+		started |= workers[i].thread != NULL;
+	}
+	if (!started) {
+		workers_stop (scheduler);
+		scheduler->workers_stop = false;
+		return false;
+	}
+	return true;
+}
+
+static void workers_stop(RzCoreTaskScheduler *scheduler) {
+	if (!scheduler->workers) {
+		return;
+	}
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->workers_stop = true;
+	rz_th_cond_signal_all (scheduler->gate_cond);
+	rz_th_lock_leave (scheduler->gate_lock);
+	int i;
+	for (i = 0; i < scheduler->workers_count; i++) {
+		RzCoreTaskWorker *w = &scheduler->workers[i];
+		if (w->thread) {
+			rz_th_wait (w->thread);
+			rz_th_free (w->thread);
+		}
+		rz_th_lock_free (w->lock);
+		rz_list_free (w->deque);
+	}
+	RZ_FREE (scheduler->workers);
+	scheduler->workers_count = 0;
+}
+
+static void workers_push(RzCoreTaskScheduler *scheduler, RzCoreTask *task) {
+	// a task enqueued from a worker stays there unless it is stolen
+	RzCoreTaskWorker *w = worker_local && worker_local->scheduler == scheduler
+		? worker_local
+		: &scheduler->workers[scheduler->workers_next++ % scheduler->workers_count];
+	rz_th_lock_enter (w->lock);
+	rz_list_prepend (w->deque, task);
+	rz_th_lock_leave (w->lock);
+	rz_th_lock_enter (scheduler->gate_lock);
+	scheduler->workers_pending++;
+	rz_th_cond_signal_all (scheduler->gate_cond);
+	rz_th_lock_leave (scheduler->gate_lock);
+}
+
 static RzThreadFunctionRet task_run_thread(RzThread *th) {
 	RzCoreTask *task = (RzCoreTask *)th->user;
 	return task_run (task);
@@ -472,7 +788,15 @@ RZ_API void rz_core_task_enqueue(RzCoreTaskScheduler *scheduler, RzCoreTask *tas
 		rz_cons_context_break_push (task->cons_context, NULL, NULL, false);
 	}
 	rz_list_append (scheduler->tasks, task);
-	task->thread = rz_th_new (task_run_thread, task, 0);
+	if (task->parallel && (!task->cons_context || !workers_start (scheduler, task->core))) {
+		// it needs its own cons and a worker, run it like the others
+		task->parallel = false;
+	}
+	if (task->parallel) {
+		workers_push (scheduler, task);
+	} else {
+		task->thread = rz_th_new (task_run_thread, task, 0);
+	}
 	tasks_lock_leave (scheduler, &old_sigset);
 }
 
@@ -549,6 +873,9 @@ RZ_API const char *rz_core_task_status (RzCoreTask *task) {
 }
 
 RZ_API RzCoreTask *rz_core_task_self (RzCoreTaskScheduler *scheduler) {
+	if (task_local && &task_local->core->tasks == scheduler) {
+		return task_local;
+	}
 	return scheduler->current_task ? scheduler->current_task : scheduler->main_task;
 }
 
@@ -488,7 +488,7 @@ RZ_API int rz_core_visual_hud(RzCore *core) {
 	char *homehud = rz_str_home (RZ_HOME_HUD);
 	char *res = NULL;
 	char *p = 0;
-	rz_cons_singleton ()->context->color_mode = use_color;
+	rz_cons_context ()->color_mode = use_color;
 
 	rz_core_visual_showcursor (core, true);
 	if (c && *c && rz_file_exists (c)) {
@@ -542,7 +542,7 @@ RZ_API void rz_core_visual_jump(RzCore *core, ut8 ch) {
 
 RZ_API void rz_core_visual_append_help(RzStrBuf *p, const char *title, const char **help) {
 	int i, max_length = 0, padding = 0;
-	RzConsContext *cons_ctx = rz_cons_singleton ()->context;
+	RzConsContext *cons_ctx = rz_cons_context ();
 	const char *pal_args_color = cons_ctx->color_mode ? cons_ctx->pal.args : "",
 		   *pal_help_color = cons_ctx->color_mode ? cons_ctx->pal.help : "",
 		   *pal_reset = cons_ctx->color_mode ? cons_ctx->pal.reset : "";
@@ -3555,7 +3555,7 @@ RZ_API int rz_core_visual_cmd(RzCore *core, const char *arg) {
 RZ_API void rz_core_visual_title(RzCore *core, int color) {
 	bool showDelta = rz_config_get_i (core->config, "scr.slow");
 	static ut64 oldpc = 0;
-	const char *BEGIN = core->cons->context->pal.prompt;
+	const char *BEGIN = rz_cons_context ()->pal.prompt;
 	const char *filename;
 	char pos[512], bar[512], pcs[32];
 	if (!oldpc) {
@@ -3752,7 +3752,7 @@ RZ_API void rz_core_visual_title(RzCore *core, int color) {
 		}
 		const int tabsCount = __core_visual_tab_count (core);
 		if (tabsCount > 0) {
-			const char *kolor = core->cons->context->pal.prompt;
+			const char *kolor = rz_cons_context ()->pal.prompt;
 			char *tabstring = __core_visual_tab_string (core, kolor);
 			if (tabstring) {
 				title = rz_str_append (title, tabstring);
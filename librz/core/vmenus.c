@@ -65,8 +65,8 @@ static char *colorize_asm_string(RzCore *core, const char *buf_asm, int optype,
 	char *tmp, *spacer = NULL;
 	char *source = (char*)buf_asm;
 	bool use_color = core->print->flags & RZ_PRINT_FLAGS_COLOR;
-	const char *color_num = core->cons->context->pal.num;
-	const char *color_reg = core->cons->context->pal.reg;
+	const char *color_num = rz_cons_context ()->pal.num;
+	const char *color_reg = rz_cons_context ()->pal.reg;
 	RzAnalysisFunction* fcn = rz_analysis_get_fcn_in (core->analysis, addr, RZ_ANALYSIS_FCN_TYPE_NULL);
 
 	if (!use_color) {
@@ -326,7 +326,7 @@ RZ_API bool rz_core_visual_bit_editor(RzCore *core) {
 				rz_cons_print (" |");
 			}
 			if (use_color) {
-				rz_cons_printf (" %5s'%s%c"Color_RESET"'", " ", core->cons->context->pal.btext, ch);
+				rz_cons_printf (" %5s'%s%c"Color_RESET"'", " ", rz_cons_context ()->pal.btext, ch);
 			} else {
 				rz_cons_printf (" %5s'%c'", " ", ch);
 			}
@@ -545,7 +545,7 @@ static bool sdbforcb (void *p, const char *k, const char *v) {
 	const char *pre = " ";
 	RzCoreVisualTypes *vt = (RzCoreVisualTypes*)p;
 	bool use_color = vt->core->print->flags & RZ_PRINT_FLAGS_COLOR;
-	char *color_sel = vt->core->cons->context->pal.prompt;
+	char *color_sel = rz_cons_context ()->pal.prompt;
 	if (vt->optword) {
 		if (!strcmp (vt->type, "struct")) {
 			char *s = rz_str_newf ("struct.%s.", vt->optword);
@@ -661,10 +661,10 @@ RZ_API int rz_core_visual_types(RzCore *core) {
 		for (i = 0; opts[i]; i++) {
 			if (use_color) {
 				if (h_opt == i) {
-					rz_cons_printf ("%s[%s]%s ", core->cons->context->pal.call,
+					rz_cons_printf ("%s[%s]%s ", rz_cons_context ()->pal.call,
 						opts[i], Color_RESET);
 				} else {
-					rz_cons_printf ("%s%s%s  ", core->cons->context->pal.other,
+					rz_cons_printf ("%s%s%s  ", rz_cons_context ()->pal.other,
 						opts[i], Color_RESET);
 				}
 			} else {
@@ -999,7 +999,7 @@ static void *show_class(RzCore *core, int mode, int *idx, RzBinClass *_c, const
 						i, clr, c->addr, c->name);
 				} else {
 					rz_cons_printf ("-  %02d %s0x%08"PFMT64x Color_RESET"  %s\n",
-						i, core->cons->context->pal.offset, c->addr, c->name);
+						i, rz_cons_context ()->pal.offset, c->addr, c->name);
 				}
 			} else {
 				rz_cons_printf ("%s %02d 0x%08"PFMT64x"  %s\n",
@@ -1052,7 +1052,7 @@ static void *show_class(RzCore *core, int mode, int *idx, RzBinClass *_c, const
 						i, clr, f->vaddr, mflags, name);
 				} else {
 					rz_cons_printf ("-  %02d %s0x%08"PFMT64x Color_RESET" %s %s\n",
-						i, core->cons->context->pal.offset, f->vaddr, mflags, name);
+						i, rz_cons_context ()->pal.offset, f->vaddr, mflags, name);
 				}
 			} else {
 				rz_cons_printf ("%s %02d 0x%08"PFMT64x" %s %s\n",
@@ -1113,7 +1113,7 @@ static void *show_class(RzCore *core, int mode, int *idx, RzBinClass *_c, const
 						i, clr, m->vaddr, mflags, name);
 				} else {
 					rz_cons_printf ("-  %02d %s0x%08"PFMT64x Color_RESET" %s %s\n",
-						i, core->cons->context->pal.offset, m->vaddr, mflags, name);
+						i, rz_cons_context ()->pal.offset, m->vaddr, mflags, name);
 				}
 			} else {
 				rz_cons_printf ("%s %02d 0x%08"PFMT64x" %s %s\n",
@@ -1789,7 +1789,7 @@ RZ_API int rz_core_visual_view_rop(RzCore *core) {
 				rz_str_replace_char (line, '\n', ';');
 				if (show_color) {
 					// XXX parsing fails to read this ansi-offset
-					// const char *offsetColor = rz_cons_singleton ()->context->pal.offset; // TODO etooslow. must cache
+					// const char *offsetColor = rz_cons_context ()->pal.offset; // TODO etooslow. must cache
 					// rz_list_push (core->ropchain, rz_str_newf ("%s0x%08"PFMT64x""Color_RESET"  %s", offsetColor, addr + delta, line));
 					rz_list_push (core->ropchain, rz_str_newf ("0x%08"PFMT64x"  %s", addr + delta, line));
 				} else {
@@ -2547,8 +2547,8 @@ static ut64 var_functions_show(RzCore *core, int idx, int show, int cols) {
 	(void)rz_cons_get_size (&window);
 	window -= 8; // Size of printed things
 	bool color = rz_config_get_i (core->config, "scr.color");
-	const char *color_addr = core->cons->context->pal.offset;
-	const char *color_fcn = core->cons->context->pal.fname;
+	const char *color_addr = rz_cons_context ()->pal.offset;
+	const char *color_fcn = rz_cons_context ()->pal.fname;
 
 	rz_list_foreach (core->analysis->fcns, iter, fcn) {
 		print_full_func = true;
@@ -2746,7 +2746,7 @@ static const char *help_vv_actions_visual[] = {
 
 static void rz_core_vmenu_append_help (RzStrBuf *p, const char **help) {
 	int i;
-	RzConsContext *cons_ctx = rz_cons_singleton ()->context;
+	RzConsContext *cons_ctx = rz_cons_context ();
 	const char *pal_args_color = cons_ctx->color_mode ? cons_ctx->pal.args : "",
 		   *pal_help_color = cons_ctx->color_mode ? cons_ctx->pal.help : "",
 		   *pal_reset = cons_ctx->color_mode ? cons_ctx->pal.reset : "";
@@ -2784,7 +2784,7 @@ static ut64 rz_core_visual_analysis_refresh (RzCore *core) {
 	case 0:
 		buf = rz_strbuf_new ("");
 		if (color) {
-			rz_cons_strcat (core->cons->context->pal.prompt);
+			rz_cons_strcat (rz_cons_context ()->pal.prompt);
 		}
 		if (selectPanel) {
 			rz_cons_printf ("-- functions -----------------[ %s ]-->>", printCmds[printMode]);
@@ -2801,7 +2801,7 @@ static ut64 rz_core_visual_analysis_refresh (RzCore *core) {
 	case 1:
 		buf = rz_strbuf_new ("");
 		if (color) {
-			rz_cons_strcat (core->cons->context->pal.prompt);
+			rz_cons_strcat (rz_cons_context ()->pal.prompt);
 		}
 		rz_cons_printf ("-[ variables ]----- 0x%08"PFMT64x"", addr);
 		if (color) {
@@ -2817,7 +2817,7 @@ static ut64 rz_core_visual_analysis_refresh (RzCore *core) {
 	case 2:
 		rz_cons_printf ("Press 'q' to quit call refs\n");
 		if (color) {
-			rz_cons_strcat (core->cons->context->pal.prompt);
+			rz_cons_strcat (rz_cons_context ()->pal.prompt);
 		}
 		rz_cons_printf ("-[ calls ]----------------------- 0x%08"PFMT64x" (TODO)\n", addr);
 		if (color) {
@@ -3927,7 +3927,7 @@ RZ_API void rz_core_visual_colors(RzCore *core) {
 	char *color = calloc (1, 64), cstr[32];
 	char preview_cmd[128] = "pd $r";
 	int ch, opt = 0, oopt = -1;
-	bool truecolor = rz_cons_singleton ()->context->color_mode == COLOR_MODE_16M;
+	bool truecolor = rz_cons_context ()->color_mode == COLOR_MODE_16M;
 	char *rgb_xxx_fmt = truecolor ? "rgb:%2.2x%2.2x%2.2x ":"rgb:%x%x%x ";
 	const char *k;
 	RzColor rcolor;
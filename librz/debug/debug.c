@@ -1513,7 +1513,7 @@ RZ_API int rz_debug_continue_syscalls(RzDebug *dbg, int *sc, int n_sc) {
 	for (;;) {
 		RzDebugReasonType reason;
 
-		if (rz_cons_singleton ()->context->breaked) {
+		if (rz_cons_context ()->breaked) {
 			break;
 		}
 #if __linux__
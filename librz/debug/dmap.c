@@ -189,7 +189,7 @@ static void print_debug_maps_ascii_art(RzDebug *dbg, RzList *maps, ut64 addr, in
 	int width = rz_cons_get_size (NULL) - 90;
 	RzListIter *iter;
 	RzDebugMap *map;
-	RzConsPrintablePalette *pal = &rz_cons_singleton ()->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	if (width < 1) {
 		width = 30;
 	}
@@ -1,30 +1,51 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
 #include <rz_debug.h>
-#include <rz_util/rz_json.h>
 
 #define CMP_CNUM_REG(x, y) ((x) >= ((RzDebugChangeReg *)y)->cnum ? 1 : -1)
 #define CMP_CNUM_MEM(x, y) ((x) >= ((RzDebugChangeMem *)y)->cnum ? 1 : -1)
+#define CMP_CNUM_PAGE(x, y) ((x) >= ((RzDebugPageVersion *)y)->cnum ? 1 : -1)
 #define CMP_CNUM_CHKPT(x, y) ((x) >= ((RzDebugCheckpoint *)y)->cnum ? 1 : -1)
 
+#define SESSION_PAGE RZ_DEBUG_SESSION_PAGE_SIZE
+#define SESSION_PAGE_MASK ((ut64)SESSION_PAGE - 1)
+// Runs of changed arena bytes closer than this are merged into one
+#define DELTA_GAP 8
+
 RZ_API void rz_debug_session_free(RzDebugSession *session) {
 	if (session) {
 		rz_vector_free (session->checkpoints);
 		ht_up_free (session->registers);
 		ht_up_free (session->memory);
+		ht_up_free (session->pages);
+		rz_list_free (session->snaps);
 		RZ_FREE (session);
 	}
 }
 
+static void arena_delta_free(RzDebugArenaDelta *delta) {
+	if (delta) {
+		rz_vector_fini (&delta->runs);
+		free (delta->data);
+		free (delta);
+	}
+}
+
 static void rz_debug_checkpoint_fini(void *element, void *user) {
 	RzDebugCheckpoint *checkpoint = element;
 	size_t i;
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		rz_reg_arena_free (checkpoint->arena[i]);
+		arena_delta_free (checkpoint->delta[i]);
 	}
 	rz_list_free (checkpoint->snaps);
 }
 
+static void page_version_fini(void *element, void *user) {
+	RzDebugPageVersion *version = element;
+	free (version->data);
+}
+
 static void htup_vector_free(HtUPKv *kv) {
 	rz_vector_free (kv->value);
 }
@@ -50,43 +71,327 @@ RZ_API RzDebugSession *rz_debug_session_new(void) {
 		rz_debug_session_free (session);
 		return NULL;
 	}
+	session->pages = ht_up_new (NULL, htup_vector_free, NULL);
+	if (!session->pages) {
+		rz_debug_session_free (session);
+		return NULL;
+	}
 
 	return session;
 }
 
-RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
-	rz_return_val_if_fail (dbg->session, false);
-	size_t i;
+static RzDebugArenaDelta *arena_delta_new(RzRegArena *prev, RzRegArena *cur) {
+	RzDebugArenaDelta *delta = RZ_NEW0 (RzDebugArenaDelta);
+	if (!delta) {
+		return NULL;
+	}
+	delta->size = cur->size;
+	rz_vector_init (&delta->runs, sizeof (RzDebugArenaRun), NULL, NULL);
+	ut32 i = 0, size = cur->size, total = 0;
+	while (i < size) {
+		if (prev->bytes[i] == cur->bytes[i]) {
+			i++;
+			continue;
+		}
+		RzDebugArenaRun run = { i, 0 };
+		ut32 same = 0;
+		for (; i < size && same < DELTA_GAP; i++) {
+			same = prev->bytes[i] == cur->bytes[i] ? same + 1 : 0;
+		}
+		run.len = i - same - run.off;
+		if (!rz_vector_push (&delta->runs, &run)) {
+			arena_delta_free (delta);
+			return NULL;
+		}
+		total += run.len;
+	}
+	if (total) {
+		delta->data = malloc (total);
+		if (!delta->data) {
+			arena_delta_free (delta);
+			return NULL;
+		}
+		ut8 *p = delta->data;
+		RzDebugArenaRun *run;
+		rz_vector_foreach (&delta->runs, run) {
+			memcpy (p, cur->bytes + run->off, run->len);
+			p += run->len;
+		}
+	}
+	return delta;
+}
+
+static void arena_delta_apply(RzRegArena *arena, RzDebugArenaDelta *delta) {
+	const ut8 *p = delta->data;
+	RzDebugArenaRun *run;
+	rz_vector_foreach (&delta->runs, run) {
+		memcpy (arena->bytes + run->off, p, run->len);
+		p += run->len;
+	}
+}
+
+// Rebuilds the arena of the given type saved by the chkpt_idx-th checkpoint,
+// from the closest full copy before it and the deltas in between.
+RZ_API RzRegArena *rz_debug_session_get_arena(RzDebugSession *session, size_t chkpt_idx, int type) {
+	rz_return_val_if_fail (session && type >= 0 && type < RZ_REG_TYPE_LAST, NULL);
+	if (chkpt_idx >= rz_vector_len (session->checkpoints)) {
+		return NULL;
+	}
+	size_t k = chkpt_idx;
+	RzDebugCheckpoint *chkpt = rz_vector_index_ptr (session->checkpoints, k);
+	while (!chkpt->arena[type] && chkpt->delta[type] && k > 0) {
+		chkpt = rz_vector_index_ptr (session->checkpoints, --k);
+	}
+	RzRegArena *full = chkpt->arena[type];
+	if (!full) {
+		return NULL;
+	}
+	RzRegArena *a = rz_reg_arena_new (full->size);
+	if (!a) {
+		return NULL;
+	}
+	memcpy (a->bytes, full->bytes, full->size);
+	for (k++; k <= chkpt_idx; k++) {
+		chkpt = rz_vector_index_ptr (session->checkpoints, k);
+		RzDebugArenaDelta *delta = chkpt->delta[type];
+		if (!delta || delta->size != a->size) {
+			rz_reg_arena_free (a);
+			return NULL;
+		}
+		arena_delta_apply (a, delta);
+	}
+	return a;
+}
+
+static RzVector *page_versions(RzDebugSession *session, ut64 page) {
+	RzVector *versions = ht_up_find (session->pages, page, NULL);
+	if (!versions) {
+		versions = rz_vector_new (sizeof (RzDebugPageVersion), page_version_fini, NULL);
+		if (!versions) {
+			return NULL;
+		}
+		ht_up_insert (session->pages, page, versions);
+	}
+	return versions;
+}
+
+// Records the contents of [addr, addr + size) as seen by the checkpoint at
+// cnum, adding a version only for the pages that changed since the last one.
+static bool pages_update(RzDebugSession *session, int cnum, ut64 addr, const ut8 *data, ut64 size) {
+	ut64 end = addr + size;
+	ut64 page;
+	for (page = addr & ~SESSION_PAGE_MASK; page < end && page >= (addr & ~SESSION_PAGE_MASK); page += SESSION_PAGE) {
+		ut64 from = RZ_MAX (addr, page);
+		ut64 to = RZ_MIN (end, page + SESSION_PAGE);
+		const ut8 *src = data + (from - addr);
+		size_t off = from - page, len = to - from;
+		RzVector *versions = page_versions (session, page);
+		if (!versions) {
+			return false;
+		}
+		RzDebugPageVersion *last = rz_vector_empty (versions) ? NULL : rz_vector_index_ptr (versions, rz_vector_len (versions) - 1);
+		if (last && !memcmp (last->data + off, src, len)) {
+			continue;
+		}
+		if (!last || last->cnum != cnum) {
+			RzDebugPageVersion version = { cnum, last ? rz_mem_dup (last->data, SESSION_PAGE) : calloc (1, SESSION_PAGE) };
+			if (!version.data) {
+				return false;
+			}
+			last = rz_vector_push (versions, &version);
+			if (!last) {
+				free (version.data);
+				return false;
+			}
+		}
+		memcpy (last->data + off, src, len);
+	}
+	return true;
+}
+
+static const ut8 *page_at(RzDebugSession *session, ut64 page, int cnum) {
+	RzVector *versions = ht_up_find (session->pages, page, NULL);
+	if (!versions) {
+		return NULL;
+	}
+	size_t index;
+	rz_vector_upper_bound (versions, cnum, index, CMP_CNUM_PAGE);
+	if (!index) {
+		return NULL;
+	}
+	RzDebugPageVersion *version = rz_vector_index_ptr (versions, index - 1);
+	return version->data;
+}
+
+// Fills buf with the bytes of the pages as they were at the checkpoint at cnum
+static void pages_read(RzDebugSession *session, int cnum, ut64 addr, ut8 *buf, ut64 len) {
+	ut64 end = addr + len;
+	ut64 page;
+	for (page = addr & ~SESSION_PAGE_MASK; page < end && page >= (addr & ~SESSION_PAGE_MASK); page += SESSION_PAGE) {
+		const ut8 *data = page_at (session, page, cnum);
+		if (data) {
+			ut64 from = RZ_MAX (addr, page);
+			ut64 to = RZ_MIN (end, page + SESSION_PAGE);
+			memcpy (buf + (from - addr), data + (from - page), to - from);
+		}
+	}
+}
+
+// Applies to page the changes of vmem done in (from, to], marking them in dirty
+static size_t page_replay(RzVector *vmem, int from, int to, ut8 *page, ut8 *dirty) {
+	size_t i, n = 0;
+	rz_vector_upper_bound (vmem, from, i, CMP_CNUM_MEM);
+	for (; i < rz_vector_len (vmem); i++, n++) {
+		RzDebugChangeMem *mem = rz_vector_index_ptr (vmem, i);
+		if (mem->cnum > to) {
+			break;
+		}
+		page[mem->off] = mem->data;
+		dirty[mem->off] = 1;
+	}
+	return n;
+}
+
+static RzDebugSnap *snap_info_dup(RzDebugSnap *snap) {
+	RzDebugSnap *dup = RZ_NEW0 (RzDebugSnap);
+	if (!dup) {
+		return NULL;
+	}
+	dup->name = strdup (snap->name ? snap->name : "");
+	dup->addr = snap->addr;
+	dup->addr_end = snap->addr_end;
+	dup->size = snap->size;
+	dup->perm = snap->perm;
+	dup->user = snap->user;
+	dup->shared = snap->shared;
+	return dup;
+}
+
+// Saves the contents of snap in the pages of the session, looking only at
+// the pages it marks as changed when it was updated incrementally
+static bool snap_save(RzDebugSession *session, int cnum, RzDebugSnap *snap) {
+	if (!snap->changed) {
+		return pages_update (session, cnum, snap->addr, snap->data, snap->size);
+	}
+	ut32 i = 0, j, n = (snap->size + RZ_DEBUG_SNAP_PAGE_SIZE - 1) / RZ_DEBUG_SNAP_PAGE_SIZE;
+	while (i < n) {
+		if (!snap->changed[i]) {
+			i++;
+			continue;
+		}
+		for (j = i; j < n && snap->changed[j]; j++) {
+		}
+		ut64 off = (ut64)i * RZ_DEBUG_SNAP_PAGE_SIZE;
+		ut64 end = RZ_MIN ((ut64)j * RZ_DEBUG_SNAP_PAGE_SIZE, snap->size);
+		if (!pages_update (session, cnum, snap->addr + off, snap->data + off, end - off)) {
+			return false;
+		}
+		i = j;
+	}
+	return true;
+}
+
+// Adds a checkpoint at the current cnum with a copy of the given register
+// arenas and of the memory in snaps, which is saved in the session pages.
+// snaps are left to the caller.
+RZ_API bool rz_debug_session_add_checkpoint(RzDebugSession *session, RzRegArena **arenas, RzList *snaps) {
+	rz_return_val_if_fail (session && arenas && snaps, false);
+	size_t i, idx = rz_vector_len (session->checkpoints);
 	RzDebugCheckpoint checkpoint = { 0 };
+	checkpoint.cnum = session->cnum;
 
-	// Save current registers arena iter
-	rz_debug_reg_sync (dbg, RZ_REG_TYPE_ALL, 0);
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = dbg->reg->regset[i].arena;
-		RzRegArena *b = rz_reg_arena_new (a->size);
-		memcpy (b->bytes, a->bytes, b->size);
-		checkpoint.arena[i] = b;
+		RzRegArena *a = arenas[i];
+		if (!a || !a->bytes) {
+			continue;
+		}
+		RzRegArena *prev = idx % RZ_DEBUG_SESSION_KEYFRAME ? rz_debug_session_get_arena (session, idx - 1, i) : NULL;
+		if (prev && prev->size == a->size) {
+			checkpoint.delta[i] = arena_delta_new (prev, a);
+		}
+		rz_reg_arena_free (prev);
+		if (!checkpoint.delta[i]) {
+			RzRegArena *b = rz_reg_arena_new (a->size);
+			if (!b) {
+				rz_debug_checkpoint_fini (&checkpoint, NULL);
+				return false;
+			}
+			memcpy (b->bytes, a->bytes, b->size);
+			checkpoint.arena[i] = b;
+		}
 	}
 
-	// Save current memory maps
 	checkpoint.snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
 	if (!checkpoint.snaps) {
+		rz_debug_checkpoint_fini (&checkpoint, NULL);
 		return false;
 	}
 	RzListIter *iter;
+	RzDebugSnap *snap;
+	rz_list_foreach (snaps, iter, snap) {
+		RzDebugSnap *info = snap_info_dup (snap);
+		if (!info) {
+			rz_debug_checkpoint_fini (&checkpoint, NULL);
+			return false;
+		}
+		rz_list_append (checkpoint.snaps, info);
+		if (snap->data && !snap_save (session, checkpoint.cnum, snap)) {
+			eprintf ("Error: failed to save the pages of %s\n", snap->name);
+		}
+	}
+	rz_vector_push (session->checkpoints, &checkpoint);
+	return true;
+}
+
+// Whether snaps still cover the same maps of dbg having at least perm
+static bool snaps_match_maps(RzDebug *dbg, RzList *snaps, int perm) {
+	RzListIter *iter, *it = rz_list_iterator (snaps);
 	RzDebugMap *map;
-	rz_debug_map_sync (dbg);
 	rz_list_foreach (dbg->maps, iter, map) {
-		if ((map->perm & RZ_PERM_RW) == RZ_PERM_RW) {
-			RzDebugSnap *snap = rz_debug_snap_map (dbg, map);
-			if (snap) {
-				rz_list_append (checkpoint.snaps, snap);
-			}
+		if ((map->perm & perm) != perm || map->size < 1) {
+			continue;
+		}
+		if (!it) {
+			return false;
 		}
+		RzDebugSnap *snap = it->data;
+		if (snap->addr != map->addr || snap->size != map->size || snap->perm != map->perm) {
+			return false;
+		}
+		it = it->n;
+	}
+	return !it;
+}
+
+// Brings the snapshot of the RW maps kept by the session up to date, reading
+// back only what changed when the maps are the same as last time
+static bool session_snaps_sync(RzDebug *dbg) {
+	RzDebugSession *session = dbg->session;
+	if (session->snaps && snaps_match_maps (dbg, session->snaps, RZ_PERM_RW) &&
+		rz_debug_snap_update (dbg, session->snaps) >= 0) {
+		return true;
+	}
+	rz_list_free (session->snaps);
+	session->snaps = rz_debug_snap_maps (dbg, RZ_PERM_RW);
+	return session->snaps != NULL;
+}
+
+RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
+	rz_return_val_if_fail (dbg->session, false);
+	RzRegArena *arenas[RZ_REG_TYPE_LAST];
+	size_t i;
+
+	// Save current registers arena iter
+	rz_debug_reg_sync (dbg, RZ_REG_TYPE_ALL, 0);
+	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		arenas[i] = dbg->reg->regset[i].arena;
 	}
 
-	checkpoint.cnum = dbg->session->cnum;
-	rz_vector_push (dbg->session->checkpoints, &checkpoint);
+	// Save current memory maps
+	rz_debug_map_sync (dbg);
+	if (!session_snaps_sync (dbg) || !rz_debug_session_add_checkpoint (dbg->session, arenas, dbg->session->snaps)) {
+		return false;
+	}
 
 	// Add PC register change so we can check for breakpoints when continue [back]
 	RzRegItem *ripc = rz_reg_get (dbg->reg, dbg->reg->name[RZ_REG_NAME_PC], RZ_REG_TYPE_GPR);
@@ -97,13 +402,15 @@ RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg) {
 }
 
 static void _set_initial_registers(RzDebug *dbg) {
-	size_t i;
+	RzDebugSession *session = dbg->session;
+	size_t i, idx = session->cur_chkpt - (RzDebugCheckpoint *)session->checkpoints->a;
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = dbg->session->cur_chkpt->arena[i];
+		RzRegArena *a = rz_debug_session_get_arena (session, idx, i);
 		RzRegArena *b = dbg->reg->regset[i].arena;
 		if (a && b && a->bytes && b->bytes) {
-			memcpy (b->bytes, a->bytes, a->size);
+			memcpy (b->bytes, a->bytes, RZ_MIN (a->size, b->size));
 		}
+		rz_reg_arena_free (a);
 	}
 }
 
@@ -132,24 +439,40 @@ RZ_API void _restore_registers(RzDebug *dbg, ut32 cnum) {
 }
 
 static void _set_initial_memory(RzDebug *dbg) {
+	RzDebugSession *session = dbg->session;
 	RzListIter *iter;
 	RzDebugSnap *snap;
-	rz_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
-		dbg->iob.write_at (dbg->iob.io, snap->addr, snap->data, snap->size);
+	rz_list_foreach (session->cur_chkpt->snaps, iter, snap) {
+		ut8 *buf = malloc (snap->size);
+		if (!buf) {
+			continue;
+		}
+		memset (buf, 0xff, snap->size);
+		pages_read (session, session->cur_chkpt->cnum, snap->addr, buf, snap->size);
+		dbg->iob.write_at (dbg->iob.io, snap->addr, buf, snap->size);
+		free (buf);
 	}
 }
 
 static bool _restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
 	RzDebug *dbg = user;
 	RzVector *vmem = (RzVector *)value;
-
-	rz_vector_upper_bound (vmem, dbg->session->cnum, index, CMP_CNUM_MEM);
-	if (index > 0 && index <= vmem->len) {
-		RzDebugChangeMem *mem = rz_vector_index_ptr (vmem, index - 1);
-		if (mem->cnum > dbg->session->cur_chkpt->cnum) {
-			dbg->iob.write_at (dbg->iob.io, key, &mem->data, 1);
+	ut8 page[SESSION_PAGE];
+	ut8 dirty[SESSION_PAGE] = { 0 };
+	if (!page_replay (vmem, dbg->session->cur_chkpt->cnum, dbg->session->cnum, page, dirty)) {
+		return true;
+	}
+	// Write back the runs of changed bytes
+	size_t i = 0, j;
+	while (i < SESSION_PAGE) {
+		if (!dirty[i]) {
+			i++;
+			continue;
+		}
+		for (j = i; j < SESSION_PAGE && dirty[j]; j++) {
 		}
+		dbg->iob.write_at (dbg->iob.io, key + i, page + i, j - i);
+		i = j;
 	}
 	return true;
 }
@@ -172,6 +495,10 @@ static RzDebugCheckpoint *_get_checkpoint_before(RzDebugSession *session, ut32 c
 RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum) {
 	// Set checkpoint for initial registers and memory
 	dbg->session->cur_chkpt = _get_checkpoint_before (dbg->session, cnum);
+	if (!dbg->session->cur_chkpt) {
+		eprintf ("Error: no checkpoint before cnum %u\n", cnum);
+		return;
+	}
 
 	// Restore registers
 	_restore_registers (dbg, cnum);
@@ -181,6 +508,40 @@ RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum) {
 	_restore_memory (dbg, cnum);
 }
 
+// Reads the memory at addr as it was at cnum, from the last checkpoint before
+// it and the changes recorded since. Bytes the session knows nothing about are
+// left untouched in buf.
+RZ_API bool rz_debug_session_read_at(RzDebugSession *session, ut32 cnum, ut64 addr, ut8 *buf, size_t len) {
+	rz_return_val_if_fail (session && buf, false);
+	RzDebugCheckpoint *chkpt = _get_checkpoint_before (session, cnum);
+	int from = -1;
+	if (chkpt) {
+		from = chkpt->cnum;
+		pages_read (session, from, addr, buf, len);
+	}
+	ut8 page_buf[SESSION_PAGE];
+	ut8 dirty[SESSION_PAGE];
+	ut64 end = addr + len;
+	ut64 page;
+	for (page = addr & ~SESSION_PAGE_MASK; page < end && page >= (addr & ~SESSION_PAGE_MASK); page += SESSION_PAGE) {
+		RzVector *vmem = ht_up_find (session->memory, page, NULL);
+		if (!vmem) {
+			continue;
+		}
+		memset (dirty, 0, sizeof (dirty));
+		if (!page_replay (vmem, from, cnum, page_buf, dirty)) {
+			continue;
+		}
+		ut64 a;
+		for (a = RZ_MAX (addr, page); a < RZ_MIN (end, page + SESSION_PAGE); a++) {
+			if (dirty[a - page]) {
+				buf[a - addr] = page_buf[a - page];
+			}
+		}
+	}
+	return true;
+}
+
 RZ_API void rz_debug_session_list_memory(RzDebug *dbg) {
 	RzListIter *iter;
 	RzDebugMap *map;
@@ -228,499 +589,507 @@ RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena,
 	return true;
 }
 
-RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data) {
-	RzVector *vmem = ht_up_find (session->memory, addr, NULL);
+static RzVector *mem_changes(RzDebugSession *session, ut64 page) {
+	RzVector *vmem = ht_up_find (session->memory, page, NULL);
 	if (!vmem) {
 		vmem = rz_vector_new (sizeof (RzDebugChangeMem), NULL, NULL);
 		if (!vmem) {
 			eprintf ("Error: creating a memory vector.\n");
-			return false;
+			return NULL;
+		}
+		ht_up_insert (session->memory, page, vmem);
+	}
+	return vmem;
+}
+
+RZ_API bool rz_debug_session_add_mem_changes(RzDebugSession *session, ut64 addr, const ut8 *buf, size_t len) {
+	rz_return_val_if_fail (session && (buf || !len), false);
+	RzVector *vmem = NULL;
+	ut64 cur = 0;
+	size_t i;
+	for (i = 0; i < len; i++) {
+		ut64 page = (addr + i) & ~SESSION_PAGE_MASK;
+		if (!vmem || page != cur) {
+			vmem = mem_changes (session, page);
+			if (!vmem) {
+				return false;
+			}
+			cur = page;
 		}
-		ht_up_insert (session->memory, addr, vmem);
+		RzDebugChangeMem mem = { session->cnum, (addr + i) & SESSION_PAGE_MASK, buf[i] };
+		rz_vector_push (vmem, &mem);
 	}
-	RzDebugChangeMem mem = { session->cnum, data };
-	rz_vector_push (vmem, &mem);
 	return true;
 }
 
+RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data) {
+	return rz_debug_session_add_mem_changes (session, addr, &data, 1);
+}
+
 /* Save and Load Session */
 
-// 0x<addr>=[<RzDebugChangeReg>]
-static bool serialize_register_cb(void *db, const ut64 k, const void *v) {
-	RzDebugChangeReg *reg;
-	RzVector *vreg = (RzVector *)v;
-	PJ *j = pj_new ();
-	if (!j) {
+/*
+ * Binary format, all the integers are little endian:
+ *
+ *   "RZDBGSES" <version:ut32> <page size:ut32> <maxcnum:ut32>
+ *   <count:ut32> registers: <key:ut64> <n:ut32> n * (<cnum:ut32> <data:ut64>)
+ *   <count:ut32> memory: <page:ut64> <n:ut32> n * (<cnum:ut32> <off:ut16> <data:ut8>)
+ *   <count:ut32> pages: <page:ut64> <n:ut32> n * (<cnum:ut32> <page size bytes>)
+ *   <count:ut32> checkpoints: <cnum:ut32>
+ *     RZ_REG_TYPE_LAST * arena: <kind:ut8> (0 none, 1 full, 2 delta)
+ *       full: <size:ut32> <bytes>
+ *       delta: <size:ut32> <n:ut32> n * (<off:ut32> <len:ut32>) <len:ut32> <bytes>
+ *     <n:ut32> snaps: <namelen:ut32> <name> <addr:ut64> <addr_end:ut64>
+ *       <size:ut32> <perm:ut32> <user:ut32> <shared:ut8>
+ */
+
+#define SESSION_MAGIC "RZDBGSES"
+#define SESSION_VERSION 1
+#define SESSION_FILE "session.bin"
+
+enum {
+	ARENA_NONE,
+	ARENA_FULL,
+	ARENA_DELTA
+};
+
+static bool write_ut8(RzBuffer *b, ut8 v) {
+	return rz_buf_append_bytes (b, &v, sizeof (v));
+}
+
+static bool write_ut16(RzBuffer *b, ut16 v) {
+	ut8 tmp[sizeof (v)];
+	rz_write_le16 (tmp, v);
+	return rz_buf_append_bytes (b, tmp, sizeof (tmp));
+}
+
+static bool write_ut32(RzBuffer *b, ut32 v) {
+	ut8 tmp[sizeof (v)];
+	rz_write_le32 (tmp, v);
+	return rz_buf_append_bytes (b, tmp, sizeof (tmp));
+}
+
+static bool write_ut64(RzBuffer *b, ut64 v) {
+	ut8 tmp[sizeof (v)];
+	rz_write_le64 (tmp, v);
+	return rz_buf_append_bytes (b, tmp, sizeof (tmp));
+}
+
+static bool read_bytes(RzBuffer *b, ut8 *buf, ut64 len) {
+	return !len || rz_buf_read (b, buf, len) == len;
+}
+
+static bool read_ut8(RzBuffer *b, ut8 *v) {
+	return read_bytes (b, v, sizeof (*v));
+}
+
+static bool read_ut16(RzBuffer *b, ut16 *v) {
+	ut8 tmp[sizeof (*v)];
+	if (!read_bytes (b, tmp, sizeof (tmp))) {
 		return false;
 	}
-	pj_a (j);
+	*v = rz_read_le16 (tmp);
+	return true;
+}
 
-	rz_vector_foreach (vreg, reg) {
-		pj_o (j);
-		pj_kN (j, "cnum", reg->cnum);
-		pj_kn (j, "data", reg->data);
-		pj_end (j);
+static bool read_ut32(RzBuffer *b, ut32 *v) {
+	ut8 tmp[sizeof (*v)];
+	if (!read_bytes (b, tmp, sizeof (tmp))) {
+		return false;
 	}
+	*v = rz_read_le32 (tmp);
+	return true;
+}
 
-	pj_end (j);
-	sdb_set (db, sdb_fmt ("0x%"PFMT64x, k), pj_string (j), 0);
-	pj_free (j);
+static bool read_ut64(RzBuffer *b, ut64 *v) {
+	ut8 tmp[sizeof (*v)];
+	if (!read_bytes (b, tmp, sizeof (tmp))) {
+		return false;
+	}
+	*v = rz_read_le64 (tmp);
 	return true;
 }
 
-static void serialize_registers(Sdb *db, HtUP *registers) {
-	ht_up_foreach (registers, serialize_register_cb, db);
+// Whether b has room left for n records of at least size bytes
+static bool read_fits(RzBuffer *b, ut64 n, ut64 size) {
+	ut64 left = rz_buf_size (b) - rz_buf_tell (b);
+	return n <= left / size;
 }
 
-// 0x<addr>={"size":<size_t>, "a":[<RzDebugChangeMem>]}},
-static bool serialize_memory_cb(void *db, const ut64 k, const void *v) {
-	RzDebugChangeMem *mem;
-	RzVector *vmem = (RzVector *)v;
-	PJ *j = pj_new ();
-	if (!j) {
-		return false;
+typedef struct {
+	RzBuffer *b;
+	ut32 count;
+	bool ok;
+} SerializeCtx;
+
+static bool serialize_register_cb(void *user, const ut64 k, const void *v) {
+	SerializeCtx *ctx = user;
+	RzVector *vreg = (RzVector *)v;
+	RzDebugChangeReg *reg;
+	ctx->ok = write_ut64 (ctx->b, k) && write_ut32 (ctx->b, rz_vector_len (vreg));
+	rz_vector_foreach (vreg, reg) {
+		ctx->ok = ctx->ok && write_ut32 (ctx->b, reg->cnum) && write_ut64 (ctx->b, reg->data);
 	}
-	pj_a (j);
+	ctx->count++;
+	return ctx->ok;
+}
 
+static bool serialize_memory_cb(void *user, const ut64 k, const void *v) {
+	SerializeCtx *ctx = user;
+	RzVector *vmem = (RzVector *)v;
+	RzDebugChangeMem *mem;
+	ctx->ok = write_ut64 (ctx->b, k) && write_ut32 (ctx->b, rz_vector_len (vmem));
 	rz_vector_foreach (vmem, mem) {
-		pj_o (j);
-		pj_kN (j, "cnum", mem->cnum);
-		pj_kn (j, "data", mem->data);
-		pj_end (j);
+		ctx->ok = ctx->ok && write_ut32 (ctx->b, mem->cnum) && write_ut16 (ctx->b, mem->off) && write_ut8 (ctx->b, mem->data);
 	}
+	ctx->count++;
+	return ctx->ok;
+}
 
-	pj_end (j);
-	sdb_set (db, sdb_fmt ("0x%"PFMT64x, k), pj_string (j), 0);
-	pj_free (j);
-	return true;
+static bool serialize_page_cb(void *user, const ut64 k, const void *v) {
+	SerializeCtx *ctx = user;
+	RzVector *versions = (RzVector *)v;
+	RzDebugPageVersion *version;
+	ctx->ok = write_ut64 (ctx->b, k) && write_ut32 (ctx->b, rz_vector_len (versions));
+	rz_vector_foreach (versions, version) {
+		ctx->ok = ctx->ok && write_ut32 (ctx->b, version->cnum) && rz_buf_append_bytes (ctx->b, version->data, SESSION_PAGE);
+	}
+	ctx->count++;
+	return ctx->ok;
 }
 
-static void serialize_memory(Sdb *db, HtUP *memory) {
-	ht_up_foreach (memory, serialize_memory_cb, db);
+// Writes the entries of ht with cb, prefixed by their count
+static bool serialize_ht(RzBuffer *b, HtUP *ht, HtUPForeachCallback cb) {
+	ut64 at = rz_buf_size (b);
+	SerializeCtx ctx = { b, 0, true };
+	if (!write_ut32 (b, 0)) {
+		return false;
+	}
+	ht_up_foreach (ht, cb, &ctx);
+	ut8 tmp[sizeof (ut32)];
+	rz_write_le32 (tmp, ctx.count);
+	return ctx.ok && rz_buf_write_at (b, at, tmp, sizeof (tmp)) == sizeof (tmp);
 }
 
-static void serialize_checkpoints(Sdb *db, RzVector *checkpoints) {
-	size_t i;
-	RzDebugCheckpoint *chkpt;
-	RzDebugSnap *snap;
-	RzListIter *iter;
+static bool serialize_arena(RzBuffer *b, RzDebugCheckpoint *chkpt, int type) {
+	RzRegArena *arena = chkpt->arena[type];
+	RzDebugArenaDelta *delta = chkpt->delta[type];
+	if (arena) {
+		return write_ut8 (b, ARENA_FULL) && write_ut32 (b, arena->size) && rz_buf_append_bytes (b, arena->bytes, arena->size);
+	}
+	if (!delta) {
+		return write_ut8 (b, ARENA_NONE);
+	}
+	ut32 total = 0;
+	RzDebugArenaRun *run;
+	if (!write_ut8 (b, ARENA_DELTA) || !write_ut32 (b, delta->size) || !write_ut32 (b, rz_vector_len (&delta->runs))) {
+		return false;
+	}
+	rz_vector_foreach (&delta->runs, run) {
+		if (!write_ut32 (b, run->off) || !write_ut32 (b, run->len)) {
+			return false;
+		}
+		total += run->len;
+	}
+	return write_ut32 (b, total) && (!total || rz_buf_append_bytes (b, delta->data, total));
+}
 
+static bool serialize_checkpoints(RzBuffer *b, RzVector *checkpoints) {
+	RzDebugCheckpoint *chkpt;
+	if (!write_ut32 (b, rz_vector_len (checkpoints))) {
+		return false;
+	}
 	rz_vector_foreach (checkpoints, chkpt) {
-		// 0x<cnum>={
-		//   registers:{"<RzRegisterType>":<RzRegArena>, ...},
-		//   snaps:{"size":<size_t>, "a":[<RzDebugSnap>]}
-		// }
-		PJ *j = pj_new ();
-		if (!j) {
-			return;
-		}
-		pj_o (j);
-
-		// Serialize RzRegArena to "registers"
-		// {"size":<int>, "bytes":"<base64>"}
-		pj_ka (j, "registers");
+		size_t i;
+		if (!write_ut32 (b, chkpt->cnum)) {
+			return false;
+		}
 		for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-			RzRegArena *arena = chkpt->arena[i];
-			if (arena->bytes) {
-				pj_o (j);
-				pj_kn (j, "arena", i);
-				char *ebytes = sdb_encode ((const void *)arena->bytes, arena->size);
-				pj_ks (j, "bytes", ebytes);
-				free (ebytes);
-				pj_kn (j, "size", arena->size);
-				pj_end (j);
+			if (!serialize_arena (b, chkpt, i)) {
+				return false;
 			}
 		}
-		pj_end (j);
-
-		// Serialize RzDebugSnap to "snaps"
-		// {"name":<str>, "addr":<ut64>, "addr_end":<ut64>, "size":<ut64>,
-		//  "data":"<base64>", "perm":<int>, "user":<int>, "shared":<bool>}
-		pj_ka (j, "snaps");
+		RzListIter *iter;
+		RzDebugSnap *snap;
+		if (!write_ut32 (b, rz_list_length (chkpt->snaps))) {
+			return false;
+		}
 		rz_list_foreach (chkpt->snaps, iter, snap) {
-			pj_o (j);
-			pj_ks (j, "name", snap->name);
-			pj_kn (j, "addr", snap->addr);
-			pj_kn (j, "addr_end", snap->addr_end);
-			pj_kn (j, "size", snap->size);
-			char *edata = sdb_encode ((const void *)snap->data, snap->size);
-			if (!edata) {
-				pj_free (j);
-				return;
+			const char *name = snap->name ? snap->name : "";
+			ut32 len = strlen (name);
+			if (!write_ut32 (b, len) || !rz_buf_append_bytes (b, (const ut8 *)name, len) ||
+				!write_ut64 (b, snap->addr) || !write_ut64 (b, snap->addr_end) ||
+				!write_ut32 (b, snap->size) || !write_ut32 (b, snap->perm) ||
+				!write_ut32 (b, snap->user) || !write_ut8 (b, snap->shared)) {
+				return false;
 			}
-			pj_ks (j, "data", edata);
-			free (edata);
-			pj_kn (j, "perm", snap->perm);
-			pj_kn (j, "user", snap->user);
-			pj_kb (j, "shared", snap->shared);
-			pj_end (j);
 		}
-		pj_end (j);
-
-		pj_end (j);
-		sdb_set (db, sdb_fmt ("0x%x", chkpt->cnum), pj_string (j), 0);
-		pj_free (j);
 	}
+	return true;
 }
 
-/*
- * SDB Format:
- *
- * /
- *   maxcnum=<maxcnum>
- *
- *   /registers
- *     0x<addr>={"size":<size_t>, "a":[<RzDebugChangeReg>]}
- *
- *   /memory
- *     0x<addr>={"size":<size_t>, "a":[<RzDebugChangeMem>]}
- *
- *   /checkpoints
- *     0x<cnum>={
- *       registers:{"<RzRegisterType>":<RzRegArena>, ...},
- *       snaps:{"size":<size_t>, "a":[<RzDebugSnap>]}
- *     }
- *
- * RzDebugChangeReg JSON:
- * {"cnum":<int>, "data":<ut64>}
- *
- * RzDebugChangeMem JSON:
- * {"cnum":<int>, "data":<ut8>}
- *
- * RzRegArena JSON:
- * {"size":<int>, "bytes":"<base64>"}
- *
- * RzDebugSnap JSON:
- * {"name":<str>, "addr":<ut64>, "addr_end":<ut64>, "size":<ut64>,
- *  "data":"<base64>", "perm":<int>, "user":<int>, "shared":<bool>}
- *
- * Notes:
- * - This mostly follows rz-db-style serialization and uses sdb_json as the parser.
- */
-RZ_API void rz_debug_session_serialize(RzDebugSession *session, Sdb *db) {
-	sdb_num_set (db, "maxcnum", session->maxcnum, 0);
-	serialize_registers (sdb_ns (db, "registers", true), session->registers);
-	serialize_memory (sdb_ns (db, "memory", true), session->memory);
-	serialize_checkpoints (sdb_ns (db, "checkpoints", true), session->checkpoints);
+RZ_API bool rz_debug_session_serialize(RzDebugSession *session, RzBuffer *b) {
+	rz_return_val_if_fail (session && b, false);
+	return rz_buf_append_bytes (b, (const ut8 *)SESSION_MAGIC, 8) &&
+		write_ut32 (b, SESSION_VERSION) &&
+		write_ut32 (b, SESSION_PAGE) &&
+		write_ut32 (b, session->maxcnum) &&
+		serialize_ht (b, session->registers, serialize_register_cb) &&
+		serialize_ht (b, session->memory, serialize_memory_cb) &&
+		serialize_ht (b, session->pages, serialize_page_cb) &&
+		serialize_checkpoints (b, session->checkpoints);
 }
 
-static bool session_sdb_save(Sdb *db, const char *path) {
-	char *filename;
+RZ_API bool rz_debug_session_save(RzDebugSession *session, const char *path) {
 	if (!rz_file_is_directory (path)) {
 		eprintf ("Error: %s is not a directory\n", path);
 		return false;
 	}
-
-	filename = rz_str_newf ("%s%ssession.sdb", path, RZ_SYS_DIR);
-	sdb_file (db, filename);
-	if (!sdb_sync (db)) {
-		eprintf ("Failed to sync session to %s\n", filename);
-		free (filename);
-		sdb_close (db);
+	RzBuffer *b = rz_buf_new ();
+	if (!b) {
 		return false;
 	}
+	bool ret = false;
+	char *filename = rz_str_newf ("%s%s" SESSION_FILE, path, RZ_SYS_DIR);
+	if (!rz_debug_session_serialize (session, b)) {
+		eprintf ("Error: failed to serialize the session\n");
+	} else if (!filename || !rz_buf_dump (b, filename)) {
+		eprintf ("Failed to save session to %s\n", filename);
+	} else {
+		ret = true;
+	}
 	free (filename);
-	sdb_close (db);
-
-	SdbListIter *it;
-	SdbNs *ns;
-	ls_foreach (db->ns, it, ns) {
-		char *filename = rz_str_newf ("%s%s%s.sdb", path, RZ_SYS_DIR, ns->name);
-		sdb_file (ns->sdb, filename);
-		if (!sdb_sync (ns->sdb)) {
-			eprintf ("Failed to sync %s to %s\n", ns->name, filename);
-			free (filename);
-			sdb_close (ns->sdb);
+	rz_buf_free (b);
+	return ret;
+}
+
+static bool deserialize_registers(RzBuffer *b, HtUP *registers) {
+	ut32 count, i, j, n;
+	if (!read_ut32 (b, &count) || !read_fits (b, count, 12)) {
+		return false;
+	}
+	for (i = 0; i < count; i++) {
+		ut64 key;
+		if (!read_ut64 (b, &key) || !read_ut32 (b, &n) || !read_fits (b, n, 12)) {
 			return false;
 		}
-		free (filename);
-		sdb_close (ns->sdb);
+		RzVector *vreg = rz_vector_new (sizeof (RzDebugChangeReg), NULL, NULL);
+		if (!vreg || !rz_vector_reserve (vreg, n)) {
+			rz_vector_free (vreg);
+			return false;
+		}
+		ht_up_update (registers, key, vreg);
+		for (j = 0; j < n; j++) {
+			ut32 cnum;
+			RzDebugChangeReg reg;
+			if (!read_ut32 (b, &cnum) || !read_ut64 (b, &reg.data)) {
+				return false;
+			}
+			reg.cnum = cnum;
+			rz_vector_push (vreg, &reg);
+		}
 	}
-
 	return true;
 }
 
-RZ_API bool rz_debug_session_save(RzDebugSession *session, const char *path) {
-	Sdb *db = sdb_new0 ();
-	if (!db) {
+static bool deserialize_memory(RzBuffer *b, HtUP *memory) {
+	ut32 count, i, j, n;
+	if (!read_ut32 (b, &count) || !read_fits (b, count, 12)) {
 		return false;
 	}
-	rz_debug_session_serialize (session, db);
-
-	if (!session_sdb_save (db, path)) {
-		sdb_free (db);
-		return false;
+	for (i = 0; i < count; i++) {
+		ut64 page;
+		if (!read_ut64 (b, &page) || !read_ut32 (b, &n) || !read_fits (b, n, 7)) {
+			return false;
+		}
+		RzVector *vmem = rz_vector_new (sizeof (RzDebugChangeMem), NULL, NULL);
+		if (!vmem || !rz_vector_reserve (vmem, n)) {
+			rz_vector_free (vmem);
+			return false;
+		}
+		ht_up_update (memory, page, vmem);
+		for (j = 0; j < n; j++) {
+			ut32 cnum;
+			RzDebugChangeMem mem;
+			if (!read_ut32 (b, &cnum) || !read_ut16 (b, &mem.off) || !read_ut8 (b, &mem.data) || mem.off >= SESSION_PAGE) {
+				return false;
+			}
+			mem.cnum = cnum;
+			rz_vector_push (vmem, &mem);
+		}
 	}
-	sdb_free (db);
 	return true;
 }
 
-
-#define CHECK_TYPE(v,t) \
-	if (!v || v->type != t) \
-		continue
-
-static bool deserialize_memory_cb(void *user, const char *addr, const char *v) {
-	RJson *child;
-	char *json_str = strdup (v);
-	if (!json_str) {
-		return true;
-	}
-	RJson *reg_json = rz_json_parse (json_str);
-	if (!reg_json || reg_json->type != RZ_JSON_ARRAY) {
-		free (json_str);
-		return true;
-	}
-
-	HtUP *memory = user;
-	// Insert a new vector into `memory` HtUP at `addr`
-	RzVector *vmem = rz_vector_new (sizeof (RzDebugChangeMem), NULL, NULL);
-	if (!vmem) {
-		eprintf ("Error: failed to allocate RzVector vmem.\n");
+static bool deserialize_pages(RzBuffer *b, HtUP *pages) {
+	ut32 count, i, j, n;
+	if (!read_ut32 (b, &count) || !read_fits (b, count, 12)) {
 		return false;
 	}
-	ht_up_insert (memory, sdb_atoi (addr), vmem);
-
-	// Extract <RzDebugChangeMem>'s into the new vector
-	for (child = reg_json->children.first; child; child = child->next) {
-		if (child->type != RZ_JSON_OBJECT) {
-			continue;
+	for (i = 0; i < count; i++) {
+		ut64 page;
+		if (!read_ut64 (b, &page) || !read_ut32 (b, &n) || !read_fits (b, n, 4 + SESSION_PAGE)) {
+			return false;
+		}
+		RzVector *versions = rz_vector_new (sizeof (RzDebugPageVersion), page_version_fini, NULL);
+		if (!versions || !rz_vector_reserve (versions, n)) {
+			rz_vector_free (versions);
+			return false;
+		}
+		ht_up_update (pages, page, versions);
+		for (j = 0; j < n; j++) {
+			ut32 cnum;
+			RzDebugPageVersion version = { 0, malloc (SESSION_PAGE) };
+			if (!version.data || !read_ut32 (b, &cnum) || !read_bytes (b, version.data, SESSION_PAGE)) {
+				free (version.data);
+				return false;
+			}
+			version.cnum = cnum;
+			rz_vector_push (versions, &version);
 		}
-		const RJson *baby = rz_json_get (child, "cnum");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		int cnum = baby->num.s_value;
-
-		baby = rz_json_get (child, "data");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		ut64 data = baby->num.u_value;
-
-		RzDebugChangeMem mem = { cnum, data };
-		rz_vector_push (vmem, &mem);
 	}
-
 	return true;
 }
 
-static void deserialize_memory(Sdb *db, HtUP *memory) {
-	sdb_foreach (db, deserialize_memory_cb, memory);
-}
-
-static bool deserialize_registers_cb(void *user, const char *addr, const char *v) {
-	RJson *child;
-	char *json_str = strdup (v);
-	if (!json_str) {
-		return true;
-	}
-	RJson *reg_json = rz_json_parse (json_str);
-	if (!reg_json || reg_json->type != RZ_JSON_ARRAY) {
-		free (json_str);
-		return true;
+static bool deserialize_arena(RzBuffer *b, RzDebugCheckpoint *chkpt, int type) {
+	ut8 kind;
+	ut32 size, n, total, i;
+	if (!read_ut8 (b, &kind)) {
+		return false;
 	}
-
-	// Insert a new vector into `registers` HtUP at `addr`
-	HtUP *registers = user;
-	RzVector *vreg = rz_vector_new (sizeof (RzDebugChangeReg), NULL, NULL);
-	if (!vreg) {
-		eprintf ("Error: failed to allocate RzVector vreg.\n");
-		rz_json_free (reg_json);
-		free (json_str);
+	switch (kind) {
+	case ARENA_NONE:
 		return true;
-	}
-	ht_up_insert (registers, sdb_atoi (addr), vreg);
-
-	// Extract <RzDebugChangeReg>'s into the new vector
-	for (child = reg_json->children.first; child; child = child->next) {
-		if (child->type != RZ_JSON_OBJECT) {
-			continue;
+	case ARENA_FULL:
+		if (!read_ut32 (b, &size) || !size || !read_fits (b, size, 1)) {
+			return false;
 		}
-		const RJson *baby = rz_json_get (child, "cnum");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		int cnum = baby->num.s_value;
-
-		baby = rz_json_get (child, "data");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		ut64 data = baby->num.u_value;
-
-		RzDebugChangeReg reg = { cnum, data };
-		rz_vector_push (vreg, &reg);
+		chkpt->arena[type] = rz_reg_arena_new (size);
+		return chkpt->arena[type] && read_bytes (b, chkpt->arena[type]->bytes, size);
+	case ARENA_DELTA:
+		if (!read_ut32 (b, &size) || !read_ut32 (b, &n) || !read_fits (b, n, 8) || size > ST32_MAX) {
+			return false;
+		}
+		chkpt->delta[type] = RZ_NEW0 (RzDebugArenaDelta);
+		if (!chkpt->delta[type]) {
+			return false;
+		}
+		RzDebugArenaDelta *delta = chkpt->delta[type];
+		delta->size = size;
+		rz_vector_init (&delta->runs, sizeof (RzDebugArenaRun), NULL, NULL);
+		ut64 sum = 0;
+		for (i = 0; i < n; i++) {
+			RzDebugArenaRun run;
+			if (!read_ut32 (b, &run.off) || !read_ut32 (b, &run.len) ||
+				run.off > size || run.len > size - run.off ||
+				!rz_vector_push (&delta->runs, &run)) {
+				return false;
+			}
+			sum += run.len;
+		}
+		if (!read_ut32 (b, &total) || total != sum || !read_fits (b, total, 1)) {
+			return false;
+		}
+		if (total) {
+			delta->data = malloc (total);
+			return delta->data && read_bytes (b, delta->data, total);
+		}
+		return true;
+	default:
+		return false;
 	}
-
-	rz_json_free (reg_json);
-	free (json_str);
-	return true;
-}
-
-static void deserialize_registers(Sdb *db, HtUP *registers) {
-	sdb_foreach (db, deserialize_registers_cb, registers);
 }
 
-#define SNAPATTR(ATTR) sdb_fmt ("snaps.a[%u]." ATTR, i)
-#define REGATTR(ATTR) sdb_fmt ("registers.%d." ATTR, i)
-
-static bool deserialize_checkpoints_cb(void *user, const char *cnum, const char *v) {
-	const RJson *child;
-	char *json_str = strdup (v);
-	if (!json_str) {
-		return true;
+static bool deserialize_snap(RzBuffer *b, RzList *snaps) {
+	ut32 len, size, perm, user;
+	ut8 shared;
+	if (!read_ut32 (b, &len) || !read_fits (b, len, 1)) {
+		return false;
 	}
-	RJson *chkpt_json = rz_json_parse (json_str);
-	if (!chkpt_json || chkpt_json->type != RZ_JSON_OBJECT) {
-		free (json_str);
-		return true;
+	RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
+	if (!snap) {
+		return false;
 	}
+	snap->name = malloc (len + 1);
+	if (!snap->name || !read_bytes (b, (ut8 *)snap->name, len) ||
+		!read_ut64 (b, &snap->addr) || !read_ut64 (b, &snap->addr_end) ||
+		!read_ut32 (b, &size) || !read_ut32 (b, &perm) ||
+		!read_ut32 (b, &user) || !read_ut8 (b, &shared)) {
+		rz_debug_snap_free (snap);
+		return false;
+	}
+	snap->name[len] = '\0';
+	snap->size = size;
+	snap->perm = perm;
+	snap->user = user;
+	snap->shared = shared;
+	rz_list_append (snaps, snap);
+	return true;
+}
 
-	RzVector *checkpoints = user;
-	RzDebugCheckpoint checkpoint = { 0 };
-	checkpoint.cnum = (int)sdb_atoi (cnum);
-
-	// Extract RzRegArena's from "registers"
-	const RJson *regs_json = rz_json_get (chkpt_json, "registers");
-	if (!regs_json || regs_json->type != RZ_JSON_ARRAY) {
-		return true;
+static bool deserialize_checkpoints(RzBuffer *b, RzVector *checkpoints) {
+	ut32 count, i, j, n;
+	if (!read_ut32 (b, &count) || !read_fits (b, count, 8 + RZ_REG_TYPE_LAST)) {
+		return false;
 	}
-	for (child = regs_json->children.first; child; child = child->next) {
-		const RJson *baby;
-		baby = rz_json_get (child, "arena");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		int arena = baby->num.s_value;
-		if (arena < RZ_REG_TYPE_GPR || arena > RZ_REG_TYPE_SEG) {
-			continue;
+	for (i = 0; i < count; i++) {
+		RzDebugCheckpoint checkpoint = { 0 };
+		ut32 cnum;
+		bool ok = read_ut32 (b, &cnum);
+		checkpoint.cnum = cnum;
+		for (j = 0; ok && j < RZ_REG_TYPE_LAST; j++) {
+			ok = deserialize_arena (b, &checkpoint, j);
 		}
-		baby = rz_json_get (child, "size");
-		CHECK_TYPE (baby, RZ_JSON_INTEGER);
-		int size = baby->num.s_value;
-		if (size < 0) {
-			continue;
+		checkpoint.snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+		ok = ok && checkpoint.snaps && read_ut32 (b, &n) && read_fits (b, n, 33);
+		for (j = 0; ok && j < n; j++) {
+			ok = deserialize_snap (b, checkpoint.snaps);
 		}
-		baby = rz_json_get (child, "bytes");
-		CHECK_TYPE (baby, RZ_JSON_STRING);
-		ut8 *bytes = sdb_decode (baby->str_value, NULL);
-
-		RzRegArena *a = rz_reg_arena_new (size);
-		if (!a) {
-			free (bytes);
-			continue;
-		}
-		memcpy (a->bytes, bytes, a->size);
-		checkpoint.arena[arena] = a;
-		free (bytes);
-	}
-
-	// Extract RzDebugSnap's from "snaps"
-	checkpoint.snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
-	const RJson *snaps_json = rz_json_get (chkpt_json, "snaps");
-	if (!snaps_json || snaps_json->type != RZ_JSON_ARRAY) {
-		goto end;
-	}
-	for (child = snaps_json->children.first; child; child = child->next) {
-		const RJson *namej = rz_json_get (child, "name");
-		CHECK_TYPE (namej, RZ_JSON_STRING);
-		const RJson *dataj = rz_json_get (child, "data");
-		CHECK_TYPE (dataj, RZ_JSON_STRING);
-		const RJson *sizej = rz_json_get (child, "size");
-		CHECK_TYPE (sizej, RZ_JSON_INTEGER);
-		const RJson *addrj = rz_json_get (child, "addr");
-		CHECK_TYPE (addrj, RZ_JSON_INTEGER);
-		const RJson *addr_endj = rz_json_get (child, "addr_end");
-		CHECK_TYPE (addr_endj, RZ_JSON_INTEGER);
-		const RJson *permj = rz_json_get (child, "perm");
-		CHECK_TYPE (permj, RZ_JSON_INTEGER);
-		const RJson *userj = rz_json_get (child, "user");
-		CHECK_TYPE (userj, RZ_JSON_INTEGER);
-		const RJson *sharedj = rz_json_get (child, "shared");
-		CHECK_TYPE (sharedj, RZ_JSON_BOOLEAN);
-
-		RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
-		if (!snap) {
-			eprintf ("Error: failed to allocate RzDebugSnap snap");
-			continue;
+		if (!ok) {
+			rz_debug_checkpoint_fini (&checkpoint, NULL);
+			return false;
 		}
-		snap->name = strdup (namej->str_value);
-		snap->addr = addrj->num.u_value;
-		snap->addr_end = addr_endj->num.u_value;
-		snap->size = sizej->num.u_value;
-		snap->data = sdb_decode (dataj->str_value, NULL);
-		snap->perm = permj->num.s_value;
-		snap->user = userj->num.s_value;
-		snap->shared = sharedj->num.u_value;
-
-		rz_list_append (checkpoint.snaps, snap);
+		rz_vector_push (checkpoints, &checkpoint);
 	}
-end:
-	rz_vector_push (checkpoints, &checkpoint);
 	return true;
 }
 
-static void deserialize_checkpoints(Sdb *db, RzVector *checkpoints) {
-	sdb_foreach (db, deserialize_checkpoints_cb, checkpoints);
-}
-
-static bool session_sdb_load_ns(Sdb *db, const char *nspath, const char *filename) {
-	Sdb *tmpdb = sdb_new0 ();
-	if (sdb_open (tmpdb, filename) == -1) {
-		eprintf ("Error: failed to load %s into sdb\n", filename);
-		sdb_free (tmpdb);
+RZ_API bool rz_debug_session_deserialize(RzDebugSession *session, RzBuffer *b) {
+	rz_return_val_if_fail (session && b, false);
+	ut8 magic[8];
+	ut32 version, page_size, maxcnum;
+	if (!read_bytes (b, magic, sizeof (magic)) || memcmp (magic, SESSION_MAGIC, sizeof (magic)) ||
+		!read_ut32 (b, &version) || version != SESSION_VERSION ||
+		!read_ut32 (b, &page_size) || page_size != SESSION_PAGE ||
+		!read_ut32 (b, &maxcnum)) {
+		eprintf ("Error: not a debug session or unsupported version\n");
 		return false;
 	}
-	Sdb *ns = sdb_ns_path (db, nspath, true);
-	sdb_copy (tmpdb, ns);
-	sdb_free (tmpdb);
-	return true;
-}
-
-static Sdb *session_sdb_load(const char *path) {
-	char *filename;
-	Sdb *db = sdb_new0 ();
-	if (!db) {
-		return NULL;
+	session->maxcnum = maxcnum;
+	if (!deserialize_registers (b, session->registers) ||
+		!deserialize_memory (b, session->memory) ||
+		!deserialize_pages (b, session->pages) ||
+		!deserialize_checkpoints (b, session->checkpoints)) {
+		eprintf ("Error: truncated or corrupted debug session\n");
+		return false;
 	}
-
-#define SDB_LOAD(fn, ns) do { \
-		filename = rz_str_newf ("%s%s" fn ".sdb", path, RZ_SYS_DIR); \
-		if (!session_sdb_load_ns (db, ns, filename)) { \
-			free (filename); \
-			goto error; \
-		} \
-		free (filename); \
-	} while (0)
-
-	SDB_LOAD ("session", "");
-	SDB_LOAD ("registers", "registers");
-	SDB_LOAD ("memory", "memory");
-	SDB_LOAD ("checkpoints", "checkpoints");
-	return db;
-error:
-	sdb_free (db);
-	return NULL;
-}
-
-RZ_API void rz_debug_session_deserialize(RzDebugSession *session, Sdb *db) {
-	Sdb *subdb;
-
-	session->maxcnum = sdb_num_get (db, "maxcnum", 0);
-
-#define DESERIALIZE(ns, func) do { \
-		subdb = sdb_ns (db, ns, false); \
-		if (!subdb) { \
-			eprintf ("Error: missing " ns " namespace\n"); \
-			return; \
-		} \
-		func; \
-	} while (0)
-
-	DESERIALIZE ("memory", deserialize_memory (subdb, session->memory));
-	DESERIALIZE ("registers", deserialize_registers (subdb, session->registers));
-	DESERIALIZE ("checkpoints", deserialize_checkpoints (subdb, session->checkpoints));
+	return true;
 }
 
 RZ_API bool rz_debug_session_load(RzDebug *dbg, const char *path) {
-	Sdb *db = session_sdb_load (path);
-	if (!db) {
+	char *filename = rz_str_newf ("%s%s" SESSION_FILE, path, RZ_SYS_DIR);
+	RzBuffer *b = filename ? rz_buf_new_slurp (filename) : NULL;
+	if (!b) {
+		eprintf ("Error: failed to load %s\n", filename);
+		free (filename);
 		return false;
 	}
-	rz_debug_session_deserialize (dbg->session, db);
-	// Restore debugger to the beginning of the session
-	rz_debug_session_restore_reg_mem (dbg, 0);
-	sdb_free (db);
-	return true;
+	free (filename);
+	bool ret = rz_debug_session_deserialize (dbg->session, b);
+	rz_buf_free (b);
+	if (ret) {
+		// Restore debugger to the beginning of the session
+		rz_debug_session_restore_reg_mem (dbg, 0);
+	}
+	return ret;
 }
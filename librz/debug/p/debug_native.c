@@ -1647,6 +1647,10 @@ RzDebugPlugin rz_debug_plugin_native = {
 	.breakpoint = rz_debug_native_bp,
 	.drx = rz_debug_native_drx,
 	.gcore = rz_debug_gcore,
+#if __linux__
+	.dirty_clear = linux_dirty_clear,
+	.dirty_pages = linux_dirty_pages,
+#endif
 };
 
 #ifndef RZ_PLUGIN_INCORE
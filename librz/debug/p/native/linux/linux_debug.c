@@ -1356,4 +1356,61 @@ RzList *linux_desc_list (int pid) {
 	return ret;
 }
 
+// Soft-dirty bits, see Documentation/admin-guide/mm/soft-dirty.rst
+#define PAGEMAP_SOFT_DIRTY (1ULL << 55)
+
+bool linux_dirty_clear(RzDebug *dbg) {
+	char path[64];
+	if (dbg->pid < 1) {
+		return false;
+	}
+	snprintf (path, sizeof (path), "/proc/%d/clear_refs", dbg->pid);
+	int fd = rz_sandbox_open (path, O_WRONLY, 0);
+	if (fd == -1) {
+		return false;
+	}
+	bool ret = rz_sandbox_write (fd, (const ut8 *)"4", 1) == 1;
+	rz_sandbox_close (fd);
+	return ret;
+}
+
+int linux_dirty_pages(RzDebug *dbg, ut64 addr, ut64 size, ut8 *dirty) {
+	char path[64];
+	long psize = sysconf (_SC_PAGESIZE);
+	if (dbg->pid < 1 || !size || psize < 1 || RZ_DEBUG_SNAP_PAGE_SIZE % psize) {
+		return -1;
+	}
+	snprintf (path, sizeof (path), "/proc/%d/pagemap", dbg->pid);
+	int fd = rz_sandbox_open (path, O_RDONLY, 0);
+	if (fd == -1) {
+		return -1;
+	}
+	ut64 first = addr / psize, last = (addr + size - 1) / psize;
+	ut64 n = last - first + 1;
+	ut64 *entries = RZ_NEWS (ut64, n);
+	if (!entries || pread (fd, entries, n * sizeof (ut64), first * sizeof (ut64)) != n * sizeof (ut64)) {
+		free (entries);
+		rz_sandbox_close (fd);
+		return -1;
+	}
+	rz_sandbox_close (fd);
+	int count = 0;
+	ut64 i, pages = (size + RZ_DEBUG_SNAP_PAGE_SIZE - 1) / RZ_DEBUG_SNAP_PAGE_SIZE;
+	for (i = 0; i < pages; i++) {
+		ut64 from = addr + i * RZ_DEBUG_SNAP_PAGE_SIZE;
+		ut64 to = RZ_MIN (from + RZ_DEBUG_SNAP_PAGE_SIZE, addr + size) - 1;
+		ut64 p;
+		dirty[i] = 0;
+		for (p = from / psize; p <= to / psize; p++) {
+			if (entries[p - first] & PAGEMAP_SOFT_DIRTY) {
+				dirty[i] = 1;
+				count++;
+				break;
+			}
+		}
+	}
+	free (entries);
+	return count;
+}
+
 #endif
@@ -135,6 +135,8 @@ bool linux_stop_threads(RzDebug *dbg, int except);
 int linux_handle_signals(RzDebug *dbg, int tid);
 int linux_dbg_wait(RzDebug *dbg, int pid);
 char *linux_reg_profile(RzDebug *dbg);
+bool linux_dirty_clear(RzDebug *dbg);
+int linux_dirty_pages(RzDebug *dbg, ut64 addr, ut64 size, ut8 *dirty);
 int match_pid(const void *pid_o, const void *th_o);
 
 #endif
@@ -3,21 +3,33 @@
 #include <rz_debug.h>
 #include <rz_hash.h>
 
+#define SNAP_PAGE RZ_DEBUG_SNAP_PAGE_SIZE
+
+typedef struct {
+	RzDebugSnap *snap;
+	ut8 *buf; // pages read back, laid out like snap->data
+	ut8 *pages; // pages to look at
+} SnapUpdate;
+
 RZ_API void rz_debug_snap_free(RzDebugSnap *snap) {
 	if (snap) {
 		free (snap->name);
 		free (snap->data);
+		free (snap->hashes);
+		free (snap->changed);
 		RZ_FREE (snap);
 	}
 }
 
-RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
-	rz_return_val_if_fail (dbg && map, NULL);
-	if (map->size < 1) {
-		eprintf ("Invalid map size\n");
-		return NULL;
-	}
+static ut32 snap_pages(RzDebugSnap *snap) {
+	return (snap->size + SNAP_PAGE - 1) / SNAP_PAGE;
+}
+
+static ut32 snap_page_len(RzDebugSnap *snap, ut32 page) {
+	return RZ_MIN (SNAP_PAGE, snap->size - page * SNAP_PAGE);
+}
 
+static RzDebugSnap *snap_new(RzDebugMap *map) {
 	RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
 	if (!snap) {
 		return NULL;
@@ -32,16 +44,272 @@ RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
 	snap->shared = map->shared;
 
 	snap->data = malloc (map->size);
-	if (!snap->data) {
+	snap->hashes = RZ_NEWS (ut32, snap_pages (snap));
+	if (!snap->data || !snap->hashes) {
 		rz_debug_snap_free (snap);
 		return NULL;
 	}
+	return snap;
+}
+
+static void snap_hash(RzDebugSnap *snap) {
+	ut32 i, n = snap_pages (snap);
+	for (i = 0; i < n; i++) {
+		snap->hashes[i] = rz_hash_xxhash (snap->data + i * SNAP_PAGE, snap_page_len (snap, i));
+	}
+}
+
+static void dirty_clear(RzDebug *dbg) {
+	if (!dbg->h->dirty_clear || !dbg->h->dirty_clear (dbg)) {
+		dbg->snap_dirty = -1;
+	}
+	dbg->snap_epoch++;
+}
+
+// Starts tracking the pages written after snaps were read, when the
+// debugger backend can tell which pages are dirty
+static void snaps_track(RzDebug *dbg, RzList *snaps) {
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	if (!dbg->snap_dirty && dbg->h && dbg->h->dirty_pages) {
+		// All the pages start out dirty: if none is, they are not tracked
+		dbg->snap_dirty = -1;
+		rz_list_foreach (snaps, iter, snap) {
+			ut8 *dirty = calloc (1, snap_pages (snap));
+			if (dirty && dbg->h->dirty_pages (dbg, snap->addr, snap->size, dirty) > 0) {
+				dbg->snap_dirty = 1;
+			}
+			free (dirty);
+			if (dbg->snap_dirty > 0) {
+				break;
+			}
+		}
+	}
+	if (dbg->snap_dirty > 0) {
+		dirty_clear (dbg);
+	}
+	rz_list_foreach (snaps, iter, snap) {
+		snap->epoch = dbg->snap_epoch;
+	}
+}
+
+// Marks the pages of snap that may have been written since it was read
+static void snap_dirty(RzDebug *dbg, RzDebugSnap *snap, ut8 *dirty) {
+	if (dbg->snap_dirty > 0 && snap->epoch == dbg->snap_epoch &&
+		dbg->h->dirty_pages (dbg, snap->addr, snap->size, dirty) >= 0) {
+		return;
+	}
+	memset (dirty, 1, snap_pages (snap));
+}
+
+static void snap_read(RzDebug *dbg, RzIOBatchRead *reqs, int count) {
+	if (dbg->iob.read_batch) {
+		dbg->iob.read_batch (dbg->iob.io, reqs, count);
+	} else {
+		int i;
+		for (i = 0; i < count; i++) {
+			dbg->iob.read_at (dbg->iob.io, reqs[i].addr, reqs[i].buf, reqs[i].len);
+		}
+	}
+}
+
+// Adds a read of every run of pages marked in pages into buf
+static bool snap_read_runs(RzVector *reqs, RzDebugSnap *snap, const ut8 *pages, ut8 *buf) {
+	ut32 i = 0, j, n = snap_pages (snap);
+	while (i < n) {
+		if (!pages[i]) {
+			i++;
+			continue;
+		}
+		for (j = i; j < n && pages[j]; j++) {
+		}
+		ut64 off = (ut64)i * SNAP_PAGE;
+		ut64 end = RZ_MIN ((ut64)j * SNAP_PAGE, snap->size);
+		RzIOBatchRead req = { snap->addr + off, buf + off, (int)(end - off), 0 };
+		if (!rz_vector_push (reqs, &req)) {
+			return false;
+		}
+		i = j;
+	}
+	return true;
+}
+
+RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map) {
+	rz_return_val_if_fail (dbg && map, NULL);
+	if (map->size < 1) {
+		eprintf ("Invalid map size\n");
+		return NULL;
+	}
+
+	RzDebugSnap *snap = snap_new (map);
+	if (!snap) {
+		return NULL;
+	}
 	eprintf ("Reading %d byte(s) from 0x%08"PFMT64x "...\n", snap->size, snap->addr);
 	dbg->iob.read_at (dbg->iob.io, snap->addr, snap->data, snap->size);
+	snap_hash (snap);
 
 	return snap;
 }
 
+// Snapshots all the maps of dbg having at least perm, reading their contents
+// with a single batch io request.
+RZ_API RzList *rz_debug_snap_maps(RzDebug *dbg, int perm) {
+	rz_return_val_if_fail (dbg, NULL);
+	RzList *snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+	if (!snaps) {
+		return NULL;
+	}
+	RzListIter *iter;
+	RzDebugMap *map;
+	rz_list_foreach (dbg->maps, iter, map) {
+		if ((map->perm & perm) == perm && map->size > 0) {
+			RzDebugSnap *snap = snap_new (map);
+			if (snap) {
+				rz_list_append (snaps, snap);
+			}
+		}
+	}
+	int i = 0, count = rz_list_length (snaps);
+	RzIOBatchRead *reqs = count ? RZ_NEWS0 (RzIOBatchRead, count) : NULL;
+	if (!reqs) {
+		return snaps;
+	}
+	RzDebugSnap *snap;
+	rz_list_foreach (snaps, iter, snap) {
+		reqs[i].addr = snap->addr;
+		reqs[i].buf = snap->data;
+		reqs[i].len = snap->size;
+		i++;
+	}
+	snap_read (dbg, reqs, count);
+	free (reqs);
+	rz_list_foreach (snaps, iter, snap) {
+		snap_hash (snap);
+	}
+	snaps_track (dbg, snaps);
+	return snaps;
+}
+
+/**
+ * Brings snaps taken with rz_debug_snap_maps up to date with the memory of
+ * the debuggee. Only the pages written since the last update are read back
+ * when the backend tracks dirty pages, and snap->changed tells which pages
+ * actually differ. Returns the number of changed pages, -1 on failure.
+ */
+RZ_API int rz_debug_snap_update(RzDebug *dbg, RzList *snaps) {
+	rz_return_val_if_fail (dbg && snaps, -1);
+	int count = 0, n = rz_list_length (snaps);
+	SnapUpdate *up = n ? RZ_NEWS0 (SnapUpdate, n) : NULL;
+	if (!up) {
+		return n ? -1 : 0;
+	}
+	RzVector reqs;
+	rz_vector_init (&reqs, sizeof (RzIOBatchRead), NULL, NULL);
+	RzListIter *iter;
+	RzDebugSnap *snap;
+	int i = 0;
+	rz_list_foreach (snaps, iter, snap) {
+		ut32 pages = snap_pages (snap);
+		up[i].snap = snap;
+		up[i].buf = malloc (snap->size);
+		up[i].pages = malloc (pages);
+		RZ_FREE (snap->changed);
+		snap->changed = calloc (1, pages);
+		if (!up[i].buf || !up[i].pages || !snap->changed) {
+			count = -1;
+			goto beach;
+		}
+		snap_dirty (dbg, snap, up[i].pages);
+		if (!snap_read_runs (&reqs, snap, up[i].pages, up[i].buf)) {
+			count = -1;
+			goto beach;
+		}
+		i++;
+	}
+	if (!rz_vector_empty (&reqs)) {
+		snap_read (dbg, reqs.a, rz_vector_len (&reqs));
+	}
+	for (i = 0; i < n; i++) {
+		snap = up[i].snap;
+		ut32 j, pages = snap_pages (snap);
+		for (j = 0; j < pages; j++) {
+			if (!up[i].pages[j]) {
+				continue;
+			}
+			ut32 len = snap_page_len (snap, j);
+			ut8 *cur = up[i].buf + j * SNAP_PAGE;
+			ut8 *old = snap->data + j * SNAP_PAGE;
+			ut32 hash = rz_hash_xxhash (cur, len);
+			if (hash != snap->hashes[j] || memcmp (cur, old, len)) {
+				memcpy (old, cur, len);
+				snap->hashes[j] = hash;
+				snap->changed[j] = 1;
+				count++;
+			}
+		}
+	}
+	snaps_track (dbg, snaps);
+beach:
+	for (i = 0; i < n; i++) {
+		free (up[i].buf);
+		free (up[i].pages);
+	}
+	free (up);
+	rz_vector_fini (&reqs);
+	return count;
+}
+
+/**
+ * Writes snap back to the memory of the debuggee. Only the pages that differ
+ * are written, and only the pages written since the snap was taken are
+ * compared when the backend tracks dirty pages. Returns the number of pages
+ * written, -1 on failure.
+ */
+RZ_API int rz_debug_snap_restore(RzDebug *dbg, RzDebugSnap *snap) {
+	rz_return_val_if_fail (dbg && snap && snap->data && snap->hashes, -1);
+	ut32 i, j, n = snap_pages (snap);
+	int count = -1;
+	ut8 *pages = malloc (n);
+	ut8 *buf = malloc (snap->size);
+	RzVector reqs;
+	rz_vector_init (&reqs, sizeof (RzIOBatchRead), NULL, NULL);
+	if (!pages || !buf) {
+		goto beach;
+	}
+	snap_dirty (dbg, snap, pages);
+	if (!snap_read_runs (&reqs, snap, pages, buf)) {
+		goto beach;
+	}
+	if (!rz_vector_empty (&reqs)) {
+		snap_read (dbg, reqs.a, rz_vector_len (&reqs));
+	}
+	for (i = 0; i < n; i++) {
+		ut32 len = snap_page_len (snap, i);
+		ut64 off = (ut64)i * SNAP_PAGE;
+		pages[i] = pages[i] && (rz_hash_xxhash (buf + off, len) != snap->hashes[i] || memcmp (buf + off, snap->data + off, len));
+	}
+	// Write back the runs of differing pages
+	count = 0;
+	for (i = 0; i < n; i = j) {
+		if (!pages[i]) {
+			j = i + 1;
+			continue;
+		}
+		for (j = i; j < n && pages[j]; j++) {
+		}
+		ut64 off = (ut64)i * SNAP_PAGE;
+		ut64 end = RZ_MIN ((ut64)j * SNAP_PAGE, snap->size);
+		dbg->iob.write_at (dbg->iob.io, snap->addr + off, snap->data + off, (int)(end - off));
+		count += j - i;
+	}
+beach:
+	rz_vector_fini (&reqs);
+	free (pages);
+	free (buf);
+	return count;
+}
+
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr) {
 	return (snap->addr <= addr && addr >= snap->addr_end);
 }
@@ -69,30 +337,12 @@ RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap) {
 }
 
 RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b) {
-	bool ret = false;
-	ut64 algobit = rz_hash_name_to_bits ("sha256");
-	RzHash *ctx = rz_hash_new (true, algobit);
-	if (!ctx) {
-		return ret;
+	rz_return_val_if_fail (a && b, false);
+	if (a->size != b->size) {
+		return false;
 	}
-
-	rz_hash_do_begin (ctx, algobit);
-	rz_hash_calculate (ctx, algobit, a->data, a->size);
-	rz_hash_do_end (ctx, algobit);
-
-	ut8 *temp = malloc (RZ_HASH_SIZE_SHA256);
-	if (!temp) {
-		rz_hash_free (ctx);
-		return ret;
+	if (a->hashes && b->hashes && memcmp (a->hashes, b->hashes, snap_pages (a) * sizeof (ut32))) {
+		return false;
 	}
-	memcpy (temp, ctx->digest, RZ_HASH_SIZE_SHA256);
-
-	rz_hash_do_begin (ctx, algobit);
-	rz_hash_calculate (ctx, algobit, b->data, b->size);
-	rz_hash_do_end (ctx, algobit);
-
-	ret = memcmp (temp, ctx->digest, RZ_HASH_SIZE_SHA256) == 0;
-	free (temp);
-	rz_hash_free (ctx);
-	return ret;
+	return a->data && b->data && !memcmp (a->data, b->data, a->size);
 }
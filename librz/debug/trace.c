@@ -136,10 +136,7 @@ RZ_API bool rz_debug_trace_ins_after(RzDebug *dbg) {
 			}
 
 			// add mem write
-			size_t i;
-			for (i = 0; i < val->memref; i++) {
-				rz_debug_session_add_mem_change (dbg->session, val->base + i, buf[i]);
-			}
+			rz_debug_session_add_mem_changes (dbg->session, val->base, buf, RZ_MIN (val->memref, sizeof (buf)));
 			break;
 		}
 		default:
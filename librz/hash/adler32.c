@@ -4,11 +4,19 @@
 
 RZ_API ut32 rz_hash_adler32(const ut8 *data, int len) {
 	static const int MOD_ADLER = 65521;
+	// largest n such that b cannot overflow before the modulo, as in zlib
+	static const int NMAX = 5552;
 	ut32 a = 1, b = 0;
-	int index;
-	for (index = 0; index < len; index++) {
-		a = (a + data[index]) % MOD_ADLER;
-		b = (b + a) % MOD_ADLER;
+	while (len > 0) {
+		int index, n = RZ_MIN (len, NMAX);
+		for (index = 0; index < n; index++) {
+			a += data[index];
+			b += a;
+		}
+		a %= MOD_ADLER;
+		b %= MOD_ADLER;
+		data += n;
+		len -= n;
 	}
 	return (b << 16) | a;
 }
@@ -3,6 +3,7 @@
 //some definitions and test cases borrowed from http://www.nightmare.com/~ryb/code/CrcMoose.py (Ray Burr)
 
 #include <rz_hash.h>
+#include "crca.h"
 
 void crc_init (RZ_CRC_CTX *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, utcrc xout) {
 	ctx->crc = crc;
@@ -12,10 +13,46 @@ void crc_init (RZ_CRC_CTX *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, u
 	ctx->xout = xout;
 }
 
+// Below this many bytes building the table costs more than it saves
+#define CRC_TABLE_MIN 1024
+
+static ut8 crc_reflect8(ut8 d) {
+	d = (d & 0xf0) >> 4 | (d & 0x0f) << 4;
+	d = (d & 0xcc) >> 2 | (d & 0x33) << 2;
+	return (d & 0xaa) >> 1 | (d & 0x55) << 1;
+}
+
+// Byte at a time through a 256 entries table of the polynomial, same
+// register layout as the bitwise loop so the results are identical
+static void crc_update_table(RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
+	utcrc table[256], crc;
+	ut8 rev[256];
+	ut32 i;
+	int j;
+
+	for (i = 0; i < 256; i++) {
+		crc = (utcrc)i << (ctx->size - 8);
+		for (j = 0; j < 8; j++) {
+			crc = ((crc >> (ctx->size - 1)) & 1? ctx->poly: 0) ^ (crc << 1);
+		}
+		table[i] = crc;
+		rev[i] = ctx->reflect? crc_reflect8 (i): i;
+	}
+	crc = ctx->crc;
+	for (i = 0; i < sz; i++) {
+		crc = (crc << 8) ^ table[((crc >> (ctx->size - 8)) ^ rev[data[i]]) & 0xff];
+	}
+	ctx->crc = crc;
+}
+
 void crc_update (RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
 	utcrc crc, d;
 	int i, j;
 
+	if (sz >= CRC_TABLE_MIN && ctx->size >= 8) {
+		crc_update_table (ctx, data, sz);
+		return;
+	}
 	crc = ctx->crc;
 	for (i = 0; i < sz; i++) {
 		d = data[i];
@@ -34,7 +71,7 @@ void crc_update (RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz) {
 	ctx->crc = crc;
 }
 
-static void crc_final (RZ_CRC_CTX *ctx, utcrc *r) {
+void crc_final (RZ_CRC_CTX *ctx, utcrc *r) {
 	utcrc crc;
 	int i;
 
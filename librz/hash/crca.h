@@ -0,0 +1,9 @@
+#ifndef _R_CRCA_H
+#define _R_CRCA_H
+
+void crc_init(RZ_CRC_CTX *ctx, utcrc crc, ut32 size, int reflect, utcrc poly, utcrc xout);
+void crc_init_preset(RZ_CRC_CTX *ctx, enum CRC_PRESETS preset);
+void crc_update(RZ_CRC_CTX *ctx, const ut8 *data, ut32 sz);
+void crc_final(RZ_CRC_CTX *ctx, utcrc *r);
+
+#endif
@@ -0,0 +1,650 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_hash.h>
+#include <rz_th.h>
+#include <rz_util.h>
+#include <math.h>
+#if USE_LIB_XXHASH
+#include <xxhash.h>
+#else
+#include "xxhash.h"
+#endif
+#include "crca.h"
+
+// Largest batch of blocks read at once by rz_hash_multi_blocks (), with
+// their contexts
+#define HASH_MULTI_BATCH (16 * 1024 * 1024)
+#define HASH_MULTI_THREADS 64
+
+typedef enum {
+	HASH_KIND_STREAM, // md5 and sha, incremental in RzHash
+	HASH_KIND_CRC,
+	HASH_KIND_XXHASH,
+	HASH_KIND_ENTROPY,
+	HASH_KIND_BLOCK, // no incremental form, the result is the one of the last block
+} HashKind;
+
+typedef struct {
+	ut64 bit;
+	HashKind kind;
+	RzHash ctx;
+	RZ_CRC_CTX crc;
+#if USE_LIB_XXHASH
+	XXH32_state_t *xxh;
+#else
+	void *xxh;
+#endif
+	ut64 counts[256];
+	ut64 total;
+} HashAlgo;
+
+// Worker threads running the same job at once, each one on its own part
+typedef struct hash_crew_t HashCrew;
+
+typedef struct {
+	HashCrew *crew;
+	int index;
+	RzThreadSemaphore *ready;
+	RzThread *thread;
+} HashWorker;
+
+struct hash_crew_t {
+	void (*job)(void *user, int index, int count);
+	void *user;
+	HashWorker *workers;
+	int count;
+	RzThreadSemaphore *done;
+	bool pending;
+	bool stop;
+};
+
+struct rz_hash_multi_t {
+	ut64 algobits;
+	HashAlgo *algos;
+	int nalgos;
+	int nthreads;
+	HashCrew *crew;
+	// block the crew is hashing
+	const ut8 *buf;
+	int len;
+};
+
+static const struct {
+	ut64 bit;
+	enum CRC_PRESETS preset;
+} crc_bits[] = {
+	{ RZ_HASH_CRC8_SMBUS, CRC_PRESET_8_SMBUS },
+#if RZ_HAVE_CRC8_EXTRA
+	{ RZ_HASH_CRC8_CDMA2000, CRC_PRESET_CRC8_CDMA2000 },
+	{ RZ_HASH_CRC8_DARC, CRC_PRESET_CRC8_DARC },
+	{ RZ_HASH_CRC8_DVB_S2, CRC_PRESET_CRC8_DVB_S2 },
+	{ RZ_HASH_CRC8_EBU, CRC_PRESET_CRC8_EBU },
+	{ RZ_HASH_CRC8_ICODE, CRC_PRESET_CRC8_ICODE },
+	{ RZ_HASH_CRC8_ITU, CRC_PRESET_CRC8_ITU },
+	{ RZ_HASH_CRC8_MAXIM, CRC_PRESET_CRC8_MAXIM },
+	{ RZ_HASH_CRC8_ROHC, CRC_PRESET_CRC8_ROHC },
+	{ RZ_HASH_CRC8_WCDMA, CRC_PRESET_CRC8_WCDMA },
+#endif /* #if RZ_HAVE_CRC8_EXTRA */
+#if RZ_HAVE_CRC15_EXTRA
+	{ RZ_HASH_CRC15_CAN, CRC_PRESET_15_CAN },
+#endif /* #if RZ_HAVE_CRC15_EXTRA */
+	{ RZ_HASH_CRC16, CRC_PRESET_16 },
+	{ RZ_HASH_CRC16_HDLC, CRC_PRESET_16_HDLC },
+	{ RZ_HASH_CRC16_USB, CRC_PRESET_16_USB },
+	{ RZ_HASH_CRC16_CITT, CRC_PRESET_16_CITT },
+#if RZ_HAVE_CRC16_EXTRA
+	{ RZ_HASH_CRC16_AUG_CCITT, CRC_PRESET_CRC16_AUG_CCITT },
+	{ RZ_HASH_CRC16_BUYPASS, CRC_PRESET_CRC16_BUYPASS },
+	{ RZ_HASH_CRC16_CDMA2000, CRC_PRESET_CRC16_CDMA2000 },
+	{ RZ_HASH_CRC16_DDS110, CRC_PRESET_CRC16_DDS110 },
+	{ RZ_HASH_CRC16_DECT_R, CRC_PRESET_CRC16_DECT_R },
+	{ RZ_HASH_CRC16_DECT_X, CRC_PRESET_CRC16_DECT_X },
+	{ RZ_HASH_CRC16_DNP, CRC_PRESET_CRC16_DNP },
+	{ RZ_HASH_CRC16_EN13757, CRC_PRESET_CRC16_EN13757 },
+	{ RZ_HASH_CRC16_GENIBUS, CRC_PRESET_CRC16_GENIBUS },
+	{ RZ_HASH_CRC16_MAXIM, CRC_PRESET_CRC16_MAXIM },
+	{ RZ_HASH_CRC16_MCRF4XX, CRC_PRESET_CRC16_MCRF4XX },
+	{ RZ_HASH_CRC16_RIELLO, CRC_PRESET_CRC16_RIELLO },
+	{ RZ_HASH_CRC16_T10_DIF, CRC_PRESET_CRC16_T10_DIF },
+	{ RZ_HASH_CRC16_TELEDISK, CRC_PRESET_CRC16_TELEDISK },
+	{ RZ_HASH_CRC16_TMS37157, CRC_PRESET_CRC16_TMS37157 },
+	{ RZ_HASH_CRCA, CRC_PRESET_CRCA },
+	{ RZ_HASH_CRC16_KERMIT, CRC_PRESET_CRC16_KERMIT },
+	{ RZ_HASH_CRC16_MODBUS, CRC_PRESET_CRC16_MODBUS },
+	{ RZ_HASH_CRC16_X25, CRC_PRESET_CRC16_X25 },
+	{ RZ_HASH_CRC16_XMODEM, CRC_PRESET_CRC16_XMODEM },
+#endif /* #if RZ_HAVE_CRC16_EXTRA */
+#if RZ_HAVE_CRC24
+	{ RZ_HASH_CRC24, CRC_PRESET_24 },
+#endif /* #if RZ_HAVE_CRC24 */
+	{ RZ_HASH_CRC32, CRC_PRESET_32 },
+	{ RZ_HASH_CRC32C, CRC_PRESET_32C },
+	{ RZ_HASH_CRC32_ECMA_267, CRC_PRESET_32_ECMA_267 },
+#if RZ_HAVE_CRC32_EXTRA
+	{ RZ_HASH_CRC32_BZIP2, CRC_PRESET_CRC32_BZIP2 },
+	{ RZ_HASH_CRC32D, CRC_PRESET_CRC32D },
+	{ RZ_HASH_CRC32_MPEG2, CRC_PRESET_CRC32_MPEG2 },
+	{ RZ_HASH_CRC32_POSIX, CRC_PRESET_CRC32_POSIX },
+	{ RZ_HASH_CRC32Q, CRC_PRESET_CRC32Q },
+	{ RZ_HASH_CRC32_JAMCRC, CRC_PRESET_CRC32_JAMCRC },
+	{ RZ_HASH_CRC32_XFER, CRC_PRESET_CRC32_XFER },
+#endif /* #if RZ_HAVE_CRC32_EXTRA */
+#if RZ_HAVE_CRC64
+	{ RZ_HASH_CRC64, CRC_PRESET_CRC64 },
+#endif /* #if RZ_HAVE_CRC64 */
+#if RZ_HAVE_CRC64_EXTRA
+	{ RZ_HASH_CRC64_ECMA182, CRC_PRESET_CRC64_ECMA182 },
+	{ RZ_HASH_CRC64_WE, CRC_PRESET_CRC64_WE },
+	{ RZ_HASH_CRC64_XZ, CRC_PRESET_CRC64_XZ },
+	{ RZ_HASH_CRC64_ISO, CRC_PRESET_CRC64_ISO },
+#endif /* #if RZ_HAVE_CRC64_EXTRA */
+};
+
+static int crc_preset(ut64 bit) {
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (crc_bits); i++) {
+		if (crc_bits[i].bit == bit) {
+			return crc_bits[i].preset;
+		}
+	}
+	return -1;
+}
+
+static HashKind hash_kind(ut64 bit) {
+	if (bit & (RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_SHA256 | RZ_HASH_SHA384 | RZ_HASH_SHA512)) {
+		return HASH_KIND_STREAM;
+	}
+	if (bit & RZ_HASH_XXHASH) {
+		return HASH_KIND_XXHASH;
+	}
+	if (bit & RZ_HASH_ENTROPY) {
+		return HASH_KIND_ENTROPY;
+	}
+	if (crc_preset (bit) >= 0) {
+		return HASH_KIND_CRC;
+	}
+	return HASH_KIND_BLOCK;
+}
+
+static RzThreadFunctionRet crew_worker(RzThread *th) {
+	HashWorker *w = th->user;
+	HashCrew *crew = w->crew;
+	for (;;) {
+		rz_th_sem_wait (w->ready);
+		if (crew->stop) {
+			break;
+		}
+		crew->job (crew->user, w->index, crew->count);
+		rz_th_sem_post (crew->done);
+	}
+	return RZ_TH_STOP;
+}
+
+static void crew_free(HashCrew *crew) {
+	if (!crew) {
+		return;
+	}
+	int i;
+	crew->stop = true;
+	for (i = 0; i < crew->count; i++) {
+		if (crew->workers[i].thread) {
+			rz_th_sem_post (crew->workers[i].ready);
+			rz_th_wait (crew->workers[i].thread);
+			rz_th_free (crew->workers[i].thread);
+		}
+		if (crew->workers[i].ready) {
+			rz_th_sem_free (crew->workers[i].ready);
+		}
+	}
+	if (crew->done) {
+		rz_th_sem_free (crew->done);
+	}
+	free (crew->workers);
+	free (crew);
+}
+
+// Returns NULL when there is nothing to share between threads, the jobs
+// then run on the calling thread
+static HashCrew *crew_new(int count, void (*job)(void *user, int index, int count), void *user) {
+	if (count < 2) {
+		return NULL;
+	}
+	HashCrew *crew = RZ_NEW0 (HashCrew);
+	if (!crew) {
+		return NULL;
+	}
+	crew->job = job;
+	crew->user = user;
+	crew->count = count;
+	crew->workers = RZ_NEWS0 (HashWorker, count);
+	crew->done = rz_th_sem_new (0);
+	if (!crew->workers || !crew->done) {
+		crew_free (crew);
+		return NULL;
+	}
+	int i;
+	for (i = 0; i < count; i++) {
+		HashWorker *w = &crew->workers[i];
+		w->crew = crew;
+		w->index = i;
+		w->ready = rz_th_sem_new (0);
+		w->thread = w->ready? rz_th_new (crew_worker, w, 0): NULL;
+		if (!w->thread) {
+			crew->count = i + 1;
+			crew_free (crew);
+			return NULL;
+		}
+	}
+	return crew;
+}
+
+// Starts the job on all the workers, which may read what the caller set
+// up before but nothing it writes until crew_wait ()
+static void crew_post(HashCrew *crew) {
+	int i;
+	for (i = 0; i < crew->count; i++) {
+		rz_th_sem_post (crew->workers[i].ready);
+	}
+	crew->pending = true;
+}
+
+static void crew_wait(HashCrew *crew) {
+	int i;
+	if (!crew->pending) {
+		return;
+	}
+	for (i = 0; i < crew->count; i++) {
+		rz_th_sem_wait (crew->done);
+	}
+	crew->pending = false;
+}
+
+static int thread_count(int nthreads, int jobs) {
+	if (nthreads <= 0) {
+		nthreads = rz_th_cpu_count ();
+	}
+	return RZ_MAX (1, RZ_MIN (RZ_MIN (nthreads, jobs), HASH_MULTI_THREADS));
+}
+
+static void algo_begin(HashAlgo *a) {
+	memset (&a->ctx, 0, sizeof (a->ctx));
+	a->total = 0;
+	switch (a->kind) {
+	case HASH_KIND_STREAM:
+		rz_hash_do_begin (&a->ctx, a->bit);
+		break;
+	case HASH_KIND_CRC:
+		crc_init_preset (&a->crc, crc_preset (a->bit));
+		break;
+	case HASH_KIND_XXHASH:
+#if USE_LIB_XXHASH
+		if (!a->xxh) {
+			a->xxh = XXH32_createState ();
+		}
+		if (a->xxh) {
+			XXH32_reset (a->xxh, 0);
+		}
+#else
+		free (a->xxh);
+		a->xxh = XXH32_init (0);
+#endif
+		break;
+	case HASH_KIND_ENTROPY:
+		memset (a->counts, 0, sizeof (a->counts));
+		break;
+	case HASH_KIND_BLOCK:
+		a->ctx.rst = true;
+		break;
+	}
+}
+
+static void algo_update(HashAlgo *a, const ut8 *buf, int len) {
+	int i;
+	if (len <= 0) {
+		return;
+	}
+	a->total += len;
+	switch (a->kind) {
+	case HASH_KIND_STREAM:
+	case HASH_KIND_BLOCK:
+		rz_hash_calculate (&a->ctx, a->bit, buf, len);
+		break;
+	case HASH_KIND_CRC:
+		crc_update (&a->crc, buf, len);
+		break;
+	case HASH_KIND_XXHASH:
+		if (a->xxh) {
+#if USE_LIB_XXHASH
+			XXH32_update (a->xxh, buf, len);
+#else
+			XXH32_feed (a->xxh, buf, len);
+#endif
+		}
+		break;
+	case HASH_KIND_ENTROPY:
+		for (i = 0; i < len; i++) {
+			a->counts[buf[i]]++;
+		}
+		break;
+	}
+}
+
+static void algo_end(HashAlgo *a) {
+	int i, size = rz_hash_size (a->bit);
+	switch (a->kind) {
+	case HASH_KIND_STREAM:
+		rz_hash_do_end (&a->ctx, a->bit);
+		break;
+	case HASH_KIND_CRC: {
+		// same as rz_hash_crc_preset (), which gives 0 for no data
+		utcrc r = 0;
+		if (a->total) {
+			crc_final (&a->crc, &r);
+		}
+		for (i = 0; i < size; i++) {
+			a->ctx.digest[i] = r >> (8 * (size - 1 - i));
+		}
+		break;
+	}
+	case HASH_KIND_XXHASH:
+		if (a->xxh) {
+#if USE_LIB_XXHASH
+			rz_write_le32 (a->ctx.digest, XXH32_digest (a->xxh));
+#else
+			rz_write_le32 (a->ctx.digest, XXH32_result (a->xxh));
+			a->xxh = NULL;
+#endif
+		}
+		break;
+	case HASH_KIND_ENTROPY:
+		a->ctx.entropy = 0;
+		for (i = 0; i < 256 && a->total; i++) {
+			if (a->counts[i]) {
+				double p = (double)a->counts[i] / a->total;
+				a->ctx.entropy -= p * log2 (p);
+			}
+		}
+		break;
+	case HASH_KIND_BLOCK:
+		if (!a->total) {
+			rz_hash_calculate (&a->ctx, a->bit, (const ut8 *)"", 0);
+		}
+		break;
+	}
+}
+
+static void multi_job(void *user, int index, int count) {
+	RzHashMulti *mh = user;
+	int i;
+	for (i = index; i < mh->nalgos; i += count) {
+		algo_update (&mh->algos[i], mh->buf, mh->len);
+	}
+}
+
+/**
+ * \brief Returns whether the result of all the algorithms in algobits
+ * stays the same however the data is split among rz_hash_multi_update ()
+ */
+RZ_API bool rz_hash_multi_streamable(ut64 algobits) {
+	ut64 bit;
+	for (bit = 1; bit && bit <= algobits; bit <<= 1) {
+		if ((algobits & bit) && hash_kind (bit) == HASH_KIND_BLOCK) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief Creates a context computing all the algorithms in algobits over
+ * the same data, on up to nthreads threads (0 for one per cpu)
+ */
+RZ_API RzHashMulti *rz_hash_multi_new(ut64 algobits, int nthreads) {
+	RzHashMulti *mh = RZ_NEW0 (RzHashMulti);
+	if (!mh) {
+		return NULL;
+	}
+	ut64 bit;
+	mh->algobits = algobits & RZ_HASH_ALL;
+	for (bit = 1; bit && bit <= mh->algobits; bit <<= 1) {
+		if ((mh->algobits & bit) && *rz_hash_name (bit)) {
+			mh->nalgos++;
+		}
+	}
+	mh->algos = RZ_NEWS0 (HashAlgo, RZ_MAX (mh->nalgos, 1));
+	if (!mh->algos) {
+		free (mh);
+		return NULL;
+	}
+	int i = 0;
+	for (bit = 1; bit && bit <= mh->algobits; bit <<= 1) {
+		if ((mh->algobits & bit) && *rz_hash_name (bit)) {
+			mh->algos[i].bit = bit;
+			mh->algos[i].kind = hash_kind (bit);
+			i++;
+		}
+	}
+	mh->nthreads = thread_count (nthreads, HASH_MULTI_THREADS);
+	mh->crew = crew_new (RZ_MIN (mh->nthreads, mh->nalgos), multi_job, mh);
+	rz_hash_multi_begin (mh);
+	return mh;
+}
+
+RZ_API void rz_hash_multi_free(RzHashMulti *mh) {
+	if (!mh) {
+		return;
+	}
+	crew_free (mh->crew);
+	int i;
+	for (i = 0; i < mh->nalgos; i++) {
+#if USE_LIB_XXHASH
+		XXH32_freeState (mh->algos[i].xxh);
+#else
+		free (mh->algos[i].xxh);
+#endif
+	}
+	free (mh->algos);
+	free (mh);
+}
+
+RZ_API void rz_hash_multi_begin(RzHashMulti *mh) {
+	rz_return_if_fail (mh);
+	int i;
+	for (i = 0; i < mh->nalgos; i++) {
+		algo_begin (&mh->algos[i]);
+	}
+}
+
+// Hands buf to the workers, it must stay untouched until multi_wait ()
+static void multi_post(RzHashMulti *mh, const ut8 *buf, int len) {
+	mh->buf = buf;
+	mh->len = len;
+	if (mh->crew) {
+		crew_post (mh->crew);
+	} else {
+		multi_job (mh, 0, 1);
+	}
+}
+
+static void multi_wait(RzHashMulti *mh) {
+	if (mh->crew) {
+		crew_wait (mh->crew);
+	}
+}
+
+/**
+ * \brief Feeds buf to all the algorithms, each one on its worker thread
+ */
+RZ_API void rz_hash_multi_update(RzHashMulti *mh, const ut8 *buf, int len) {
+	rz_return_if_fail (mh && (buf || len <= 0));
+	multi_post (mh, buf, len);
+	multi_wait (mh);
+}
+
+RZ_API void rz_hash_multi_end(RzHashMulti *mh) {
+	rz_return_if_fail (mh);
+	int i;
+	for (i = 0; i < mh->nalgos; i++) {
+		algo_end (&mh->algos[i]);
+	}
+}
+
+/**
+ * \brief Returns the context holding the result of algo after
+ * rz_hash_multi_end (), as rz_hash_calculate () would leave it
+ */
+RZ_API RzHash *rz_hash_multi_get(RzHashMulti *mh, ut64 algo) {
+	rz_return_val_if_fail (mh, NULL);
+	int i;
+	for (i = 0; i < mh->nalgos; i++) {
+		if (mh->algos[i].bit == algo) {
+			return &mh->algos[i].ctx;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * \brief Feeds [from, to) to all the algorithms, reading each block once.
+ *
+ * Two buffers of bsize bytes are used: the next block is read while the
+ * workers hash the current one.
+ */
+RZ_API bool rz_hash_multi_stream(RzHashMulti *mh, RzHashMultiRead read, void *user, ut64 from, ut64 to, int bsize) {
+	rz_return_val_if_fail (mh && read && bsize > 0, false);
+	if (from >= to) {
+		return true;
+	}
+	bsize = RZ_MIN (bsize, to - from);
+	// a single block needs no second buffer
+	bool single = bsize == to - from;
+	ut8 *bufs[2] = { malloc (bsize), single? NULL: malloc (bsize) };
+	if (!bufs[0] || (!single && !bufs[1])) {
+		free (bufs[0]);
+		free (bufs[1]);
+		return false;
+	}
+	int cur = 0;
+	ut64 at;
+	for (at = from; at < to; at += bsize) {
+		int len = RZ_MIN (bsize, to - at);
+		read (user, at, bufs[cur], len);
+		multi_wait (mh);
+		multi_post (mh, bufs[cur], len);
+		cur ^= 1;
+	}
+	multi_wait (mh);
+	free (bufs[0]);
+	free (bufs[1]);
+	return true;
+}
+
+typedef struct {
+	const RzHashMulti *mh;
+	ut8 *buf;
+	ut64 from;
+	ut64 to;
+	int bsize;
+	int nblocks;
+	RzHash *ctxs; // nblocks * mh->nalgos
+} HashBatch;
+
+static void blocks_job(void *user, int index, int count) {
+	HashBatch *b = user;
+	int i, j, nalgos = b->mh->nalgos;
+	for (i = index; i < b->nblocks; i += count) {
+		ut64 at = b->from + (ut64)i * b->bsize;
+		int len = RZ_MIN (b->bsize, b->to - at);
+		for (j = 0; j < nalgos; j++) {
+			RzHash *ctx = &b->ctxs[i * nalgos + j];
+			ctx->rst = true;
+			rz_hash_calculate (ctx, b->mh->algos[j].bit, b->buf + (ut64)i * b->bsize, len);
+		}
+	}
+}
+
+static int batch_read(HashBatch *b, RzHashMultiRead read, void *user, ut64 from, ut64 to, int nblocks) {
+	b->from = from;
+	b->to = RZ_MIN (to, from + (ut64)nblocks * b->bsize);
+	b->nblocks = (b->to - b->from + b->bsize - 1) / b->bsize;
+	ut64 len = b->to - b->from;
+	read (user, from, b->buf, len);
+	return b->nblocks;
+}
+
+/**
+ * \brief Hashes every bsize block of [from, to) on its own with all the
+ * algorithms of mh, spreading the blocks among the threads. cb gets the
+ * results in address order.
+ */
+RZ_API bool rz_hash_multi_blocks(RzHashMulti *mh, RzHashMultiRead read, void *user, ut64 from, ut64 to, int bsize, RzHashMultiBlock cb, void *cb_user) {
+	rz_return_val_if_fail (mh && read && cb && bsize > 0, false);
+	if (from >= to || !mh->nalgos) {
+		return true;
+	}
+	ut64 total = (to - from + bsize - 1) / bsize;
+	// a batch holds at most HASH_MULTI_BATCH bytes of data and contexts, or
+	// a single block: small blocks would otherwise need a context per algo
+	// for millions of them
+	ut64 block_size = (ut64)bsize + (ut64)mh->nalgos * sizeof (RzHash);
+	int nblocks = RZ_MIN (RZ_MAX (HASH_MULTI_BATCH / block_size, 1), total);
+	int nthreads = RZ_MIN (mh->nthreads, nblocks);
+	HashBatch batch[2] = { { 0 } };
+	bool ret = false;
+	int i, cur = 0;
+	for (i = 0; i < 2; i++) {
+		batch[i].mh = mh;
+		batch[i].bsize = bsize;
+		batch[i].buf = malloc ((ut64)nblocks * bsize);
+		batch[i].ctxs = RZ_NEWS0 (RzHash, (ut64)nblocks * mh->nalgos);
+		if (!batch[i].buf || !batch[i].ctxs) {
+			goto beach;
+		}
+	}
+	// the crews are told which batch to hash through their user pointer
+	HashCrew *crews[2] = {
+		crew_new (nthreads, blocks_job, &batch[0]),
+		crew_new (nthreads, blocks_job, &batch[1])
+	};
+	HashBatch *prev = NULL;
+	ut64 at = from;
+	while (at < to || prev) {
+		HashBatch *b = NULL;
+		if (at < to) {
+			b = &batch[cur];
+			batch_read (b, read, user, at, to, nblocks);
+			at = b->to;
+		}
+		if (prev) {
+			if (crews[prev - batch]) {
+				crew_wait (crews[prev - batch]);
+			}
+			int j, k;
+			for (j = 0; j < prev->nblocks; j++) {
+				ut64 addr = prev->from + (ut64)j * bsize;
+				int len = RZ_MIN (bsize, prev->to - addr);
+				for (k = 0; k < mh->nalgos; k++) {
+					cb (cb_user, addr, len, mh->algos[k].bit, &prev->ctxs[j * mh->nalgos + k]);
+				}
+			}
+		}
+		if (b) {
+			if (crews[cur]) {
+				crew_post (crews[cur]);
+			} else {
+				blocks_job (b, 0, 1);
+			}
+			cur ^= 1;
+		}
+		prev = b;
+	}
+	crew_free (crews[0]);
+	crew_free (crews[1]);
+	ret = true;
+beach:
+	for (i = 0; i < 2; i++) {
+		free (batch[i].buf);
+		free (batch[i].ctxs);
+	}
+	return ret;
+}
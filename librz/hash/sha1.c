@@ -35,6 +35,7 @@
 
 #include "rz_hash.h"
 #include "sha1.h"
+#include "sha_x86.h"
 
 #define SHA_ROT(X, n) (((X) << (n)) | ((X) >> (32 - (n))))
 
@@ -95,20 +96,48 @@ void SHA1_Init(RZ_SHA_CTX *ctx) {
 	}
 }
 
+// Hashes whole 64-byte blocks straight from the input, lenW must be 0
+static void shaHashBlocks(RZ_SHA_CTX *ctx, const ut8 *data, size_t nblocks) {
+#if HAVE_SHA_X86
+	if (sha_x86_available ()) {
+		sha1_x86_blocks (ctx->H, data, nblocks);
+		return;
+	}
+#endif
+	for (; nblocks; nblocks--, data += 64) {
+		int t;
+		for (t = 0; t < 16; t++) {
+			ctx->W[t] = rz_read_be32 (data + 4 * t);
+		}
+		shaHashBlock (ctx);
+	}
+}
+
 void SHA1_Update(RZ_SHA_CTX *ctx, const void *_dataIn, int len) {
 	const ut8 *dataIn = _dataIn;
 	int i;
 
+	if (len <= 0) {
+		return;
+	}
+	ut64 size = (((ut64)ctx->sizeHi << 32) | ctx->sizeLo) + ((ut64)len << 3);
+	ctx->sizeHi = (ut32) (size >> 32);
+	ctx->sizeLo = (ut32)size;
+
 	// Read the data into W and process blocks as they get full
-	for (i = 0; i < len; i++) {
+	for (i = 0; i < len;) {
+		if (!ctx->lenW && len - i >= 64) {
+			int n = (len - i) / 64;
+			shaHashBlocks (ctx, dataIn + i, n);
+			i += n * 64;
+			continue;
+		}
 		ctx->W[ctx->lenW / 4] <<= 8;
-		ctx->W[ctx->lenW / 4] |= (unsigned int) dataIn[i];
+		ctx->W[ctx->lenW / 4] |= (unsigned int) dataIn[i++];
 		if ((++ctx->lenW) % 64 == 0) {
 			shaHashBlock (ctx);
 			ctx->lenW = 0;
 		}
-		ctx->sizeLo += 8;
-		ctx->sizeHi += (ctx->sizeLo < 8);
 	}
 }
 
@@ -35,6 +35,7 @@
 #include <string.h>     /* memcpy()/memset() or bcopy()/bzero() */
 #include "rz_hash.h"
 #include "sha2.h"
+#include "sha_x86.h"
 
 #define WEAK_ALIASING 0
 
@@ -465,6 +466,17 @@ void SHA256_Transform(RZ_SHA256_CTX *context, const ut32 *data) {
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+// One block through the SHA extensions when the CPU has them
+static void sha256_block(RZ_SHA256_CTX *context, const ut32 *data) {
+#if HAVE_SHA_X86
+	if (sha_x86_available ()) {
+		sha256_x86_blocks (context->state, (const ut8 *)data, 1);
+		return;
+	}
+#endif
+	SHA256_Transform (context, data);
+}
+
 void SHA256_Update(RZ_SHA256_CTX *context, const ut8 *data, size_t len) {
 	unsigned int freespace, usedspace;
 
@@ -484,7 +496,7 @@ void SHA256_Update(RZ_SHA256_CTX *context, const ut8 *data, size_t len) {
 			context->bitcount += freespace << 3;
 			len -= freespace;
 			data += freespace;
-			SHA256_Transform (context, (ut32 *) context->buffer);
+			sha256_block (context, (ut32 *) context->buffer);
 		} else {
 			/* The buffer is not yet full */
 			memcpy (&context->buffer[usedspace], data, len);
@@ -494,6 +506,15 @@ void SHA256_Update(RZ_SHA256_CTX *context, const ut8 *data, size_t len) {
 			return;
 		}
 	}
+#if HAVE_SHA_X86
+	if (len >= SHA256_BLOCK_LENGTH && sha_x86_available ()) {
+		size_t n = len / SHA256_BLOCK_LENGTH;
+		sha256_x86_blocks (context->state, data, n);
+		context->bitcount += (ut64)n * SHA256_BLOCK_LENGTH << 3;
+		len -= n * SHA256_BLOCK_LENGTH;
+		data += n * SHA256_BLOCK_LENGTH;
+	}
+#endif
 	while (len >= SHA256_BLOCK_LENGTH) {
 		/* Process as many complete blocks as we can */
 		SHA256_Transform (context, (ut32 *) data);
@@ -538,7 +559,7 @@ void SHA256_Final(ut8 *digest, RZ_SHA256_CTX *context) {
 					memset (&context->buffer[usedspace], 0, SHA256_BLOCK_LENGTH - usedspace);
 				}
 				/* Do second-to-last transform: */
-				SHA256_Transform (context, (ut32 *) context->buffer);
+				sha256_block (context, (ut32 *) context->buffer);
 
 				/* And set-up for the last transform: */
 				memset (context->buffer, 0, SHA256_SHORT_BLOCK_LENGTH);
@@ -561,7 +582,7 @@ void SHA256_Final(ut8 *digest, RZ_SHA256_CTX *context) {
 #endif
 
 		/* Final transform: */
-		SHA256_Transform (context, (ut32 *) context->buffer);
+		sha256_block (context, (ut32 *) context->buffer);
 
 #if BYTE_ORDER == LITTLE_ENDIAN
 		{
@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include "sha_x86.h"
+
+#if HAVE_SHA_X86
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define SHA_X86_TARGET __attribute__((target ("sha,ssse3,sse4.1")))
+
+static const ut32 K256[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// -1 until the first call, the result is the same for every thread
+static int sha_x86 = -1;
+
+bool sha_x86_available(void) {
+	if (sha_x86 < 0) {
+		unsigned int a, b, c, d;
+		bool ok = __get_cpuid (1, &a, &b, &c, &d) && (c & bit_SSSE3) && (c & bit_SSE4_1);
+		ok = ok && __get_cpuid_count (7, 0, &a, &b, &c, &d) && (b & bit_SHA);
+		sha_x86 = ok;
+	}
+	return sha_x86;
+}
+
+// 4 rounds of SHA-1, w[] holds the last 16 words of the message schedule
+#define SHA1_ROUNDS4(g, f) \
+	do { \
+		if ((g) >= 4) { \
+			tmp = _mm_xor_si128 (_mm_sha1msg1_epu32 (w[(g)&3], w[((g) + 1) & 3]), w[((g) + 2) & 3]); \
+			w[(g)&3] = _mm_sha1msg2_epu32 (tmp, w[((g) + 3) & 3]); \
+		} \
+		e = (g) ? _mm_sha1nexte_epu32 (e, w[(g)&3]) : _mm_add_epi32 (e, w[0]); \
+		tmp = abcd; \
+		abcd = _mm_sha1rnds4_epu32 (abcd, e, (f)); \
+		e = tmp; \
+	} while (0)
+
+SHA_X86_TARGET void sha1_x86_blocks(ut32 state[5], const ut8 *data, size_t nblocks) {
+	const __m128i mask = _mm_set_epi64x (0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+	__m128i abcd = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)state), 0x1b);
+	__m128i e0 = _mm_set_epi32 (state[4], 0, 0, 0);
+	__m128i w[4], e, tmp;
+
+	for (; nblocks; nblocks--, data += 64) {
+		__m128i abcd_save = abcd;
+		e = e0;
+		w[0] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(data + 0)), mask);
+		w[1] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(data + 16)), mask);
+		w[2] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(data + 32)), mask);
+		w[3] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(data + 48)), mask);
+		SHA1_ROUNDS4 (0, 0);
+		SHA1_ROUNDS4 (1, 0);
+		SHA1_ROUNDS4 (2, 0);
+		SHA1_ROUNDS4 (3, 0);
+		SHA1_ROUNDS4 (4, 0);
+		SHA1_ROUNDS4 (5, 1);
+		SHA1_ROUNDS4 (6, 1);
+		SHA1_ROUNDS4 (7, 1);
+		SHA1_ROUNDS4 (8, 1);
+		SHA1_ROUNDS4 (9, 1);
+		SHA1_ROUNDS4 (10, 2);
+		SHA1_ROUNDS4 (11, 2);
+		SHA1_ROUNDS4 (12, 2);
+		SHA1_ROUNDS4 (13, 2);
+		SHA1_ROUNDS4 (14, 2);
+		SHA1_ROUNDS4 (15, 3);
+		SHA1_ROUNDS4 (16, 3);
+		SHA1_ROUNDS4 (17, 3);
+		SHA1_ROUNDS4 (18, 3);
+		SHA1_ROUNDS4 (19, 3);
+		e0 = _mm_sha1nexte_epu32 (e, e0);
+		abcd = _mm_add_epi32 (abcd, abcd_save);
+	}
+
+	_mm_storeu_si128 ((__m128i *)state, _mm_shuffle_epi32 (abcd, 0x1b));
+	state[4] = _mm_extract_epi32 (e0, 3);
+}
+
+SHA_X86_TARGET void sha256_x86_blocks(ut32 state[8], const ut8 *data, size_t nblocks) {
+	const __m128i mask = _mm_set_epi64x (0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	// the instructions want the state as ABEF and CDGH
+	__m128i tmp = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)&state[0]), 0xb1);
+	__m128i state1 = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i *)&state[4]), 0x1b);
+	__m128i state0 = _mm_alignr_epi8 (tmp, state1, 8);
+	state1 = _mm_blend_epi16 (state1, tmp, 0xf0);
+	__m128i w[4];
+	int g;
+
+	for (; nblocks; nblocks--, data += 64) {
+		__m128i abef_save = state0;
+		__m128i cdgh_save = state1;
+		for (g = 0; g < 16; g++) {
+			__m128i m;
+			if (g < 4) {
+				m = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *)(data + 16 * g)), mask);
+			} else {
+				m = _mm_sha256msg1_epu32 (w[g & 3], w[(g + 1) & 3]);
+				m = _mm_add_epi32 (m, _mm_alignr_epi8 (w[(g + 3) & 3], w[(g + 2) & 3], 4));
+				m = _mm_sha256msg2_epu32 (m, w[(g + 3) & 3]);
+			}
+			w[g & 3] = m;
+			m = _mm_add_epi32 (m, _mm_loadu_si128 ((const __m128i *)&K256[4 * g]));
+			state1 = _mm_sha256rnds2_epu32 (state1, state0, m);
+			state0 = _mm_sha256rnds2_epu32 (state0, state1, _mm_shuffle_epi32 (m, 0x0e));
+		}
+		state0 = _mm_add_epi32 (state0, abef_save);
+		state1 = _mm_add_epi32 (state1, cdgh_save);
+	}
+
+	tmp = _mm_shuffle_epi32 (state0, 0x1b);
+	state1 = _mm_shuffle_epi32 (state1, 0xb1);
+	_mm_storeu_si128 ((__m128i *)&state[0], _mm_blend_epi16 (tmp, state1, 0xf0));
+	_mm_storeu_si128 ((__m128i *)&state[4], _mm_alignr_epi8 (state1, tmp, 8));
+}
+
+#endif
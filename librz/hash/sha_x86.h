@@ -0,0 +1,22 @@
+#ifndef SHA_X86_H
+#define SHA_X86_H
+
+#include <rz_types.h>
+
+// SHA extensions kernels, only built with compilers that know the
+// sha target attribute and picked at runtime through sha_x86_available ()
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HAVE_SHA_X86 1
+#else
+#define HAVE_SHA_X86 0
+#endif
+
+#if HAVE_SHA_X86
+bool sha_x86_available(void);
+void sha1_x86_blocks(ut32 state[5], const ut8 *data, size_t nblocks);
+void sha256_x86_blocks(ut32 state[8], const ut8 *data, size_t nblocks);
+#else
+#define sha_x86_available() false
+#endif
+
+#endif
@@ -29,7 +29,7 @@ RZ_LIB_VERSION_HEADER(rz_analysis);
 
 /* dwarf processing context */
 typedef struct rz_analysis_dwarf_context {
-	const RzBinDwarfDebugInfo *info;
+	RzBinDwarfDebugInfo *info;
 	HtUP/*<offset, RzBinDwarfLocList*>*/  *loc;
 	// const RzBinDwarfCfa *cfa; TODO
 } RzAnalysisDwarfContext;
@@ -647,11 +647,13 @@ typedef struct rz_analysis_t {
 	int pcalign; // asm.pcalign
 	struct rz_analysis_esil_t *esil;
 	struct rz_analysis_plugin_t *cur;
+	void *plugin_data; // decoder state of cur, from cur->ctx_init
 	RzAnalysisRange *limit; // analysis.from, analysis.to
 	RzList *plugins;
 	Sdb *sdb_types;
 	Sdb *sdb_fmts;
 	Sdb *sdb_zigns;
+	struct rz_sign_index_t *zign_index; // compiled sdb_zigns, built on demand
 	HtUP *dict_refs;
 	HtUP *dict_xrefs;
 	bool recursive_noreturn; // analysis.rnr
@@ -686,6 +688,8 @@ typedef struct rz_analysis_t {
 	SetU *visited;
 	RzStrConstPool constpool;
 	RzList *leaddrs;
+	struct rz_analysis_op_table_t *op_table; // ops decoded ahead of rz_analysis_op, not owned
+	struct rz_analysis_op_cache_t *op_cache; // ops kept across rz_analysis_op calls, see analysis.opcache
 } RzAnalysis;
 
 typedef enum rz_analysis_addr_hint_type_t {
@@ -899,6 +903,54 @@ typedef struct rz_analysis_op_t {
 	RzAnalysisDataType datatype;
 } RzAnalysisOp;
 
+// The fields of RzAnalysisOp needed to walk code, with nothing to free,
+// see rz_analysis_op_lite ()
+typedef struct rz_analysis_op_lite_t {
+	ut64 addr;
+	ut32 type;
+	RzAnalysisStackOp stackop;
+	_RzAnalysisCond cond;
+	int size;
+	int cycles;
+	RzAnalysisOpFamily family;
+	bool eob;
+	int delay;
+	ut64 jump;
+	ut64 fail;
+	st64 ptr;
+	ut64 val;
+	st64 stackptr;
+	int refptr;
+	ut64 disp;
+} RzAnalysisOpLite;
+
+typedef struct rz_analysis_op_table_entry_t {
+	RzAnalysisOp op;
+	int ret;
+	ut8 bytes[32]; // the decoded bytes, checked on lookup
+} RzAnalysisOpTableEntry;
+
+// ops decoded ahead of time (e.g. by the analysis.threads workers), rz_analysis_op
+// serves them when plugin, bits, endianness and mask match the ones used to
+// decode them and no arch or bits hint applies at the address
+typedef struct rz_analysis_op_table_t {
+	HtUP *ops; // addr => RzAnalysisOpTableEntry
+	struct rz_analysis_plugin_t *cur;
+	int bits;
+	int big_endian;
+	RzAnalysisOpMask mask;
+	ut64 hits;
+} RzAnalysisOpTable;
+
+typedef struct rz_analysis_op_cache_stats_t {
+	ut64 hits;
+	ut64 misses;
+	ut64 flushes; // times the whole cache was dropped for going over max_size
+	ut32 entries;
+	size_t size; // approximate bytes held by the entries and their strings
+	size_t max_size;
+} RzAnalysisOpCacheStats;
+
 #define RZ_ANALYSIS_COND_SINGLE(x) (!x->arg[1] || x->arg[0]==x->arg[1])
 
 typedef struct rz_analysis_cond_t {
@@ -1086,6 +1138,33 @@ typedef struct rz_analysis_reil {
 #define ESIL_STACK_NAME "esil.ram"
 #define ESIL struct rz_analysis_esil_t
 
+typedef enum {
+	RZ_ANALYSIS_ESIL_VALUE_NONE = 0,
+	RZ_ANALYSIS_ESIL_VALUE_STR, // str
+	RZ_ANALYSIS_ESIL_VALUE_NUM, // num, str is the text it was parsed from if any
+	RZ_ANALYSIS_ESIL_VALUE_REG, // str is the name, reg the item it was resolved to
+} RzAnalysisEsilValueType;
+
+// an entry of the esil stack
+typedef struct rz_analysis_esil_value_t {
+	RzAnalysisEsilValueType type;
+	bool owned; // str must be freed with the value
+	ut64 num;
+	RzRegItem *reg;
+	char *str;
+} RzAnalysisEsilValue;
+
+typedef struct rz_analysis_esil_insn_t RzAnalysisEsilInsn;
+
+// an esil expression split in words, see rz_analysis_esil_compile
+typedef struct rz_analysis_esil_code_t {
+	char *expr;
+	char *words; // expr with the commas replaced by nul bytes
+	RzAnalysisEsilInsn *insns;
+	int count;
+	ut32 reg_gen; // RzReg.gen the registers were resolved with
+} RzAnalysisEsilCode;
+
 typedef struct rz_analysis_esil_source_t {
 	ut32 id;
 	ut32 claimed;
@@ -1157,7 +1236,7 @@ typedef struct rz_analysis_esil_callbacks_t {
 
 typedef struct rz_analysis_esil_t {
 	RzAnalysis *analysis;
-	char **stack;
+	RzAnalysisEsilValue *stack;
 	ut64 addrmask;
 	int stacksize;
 	int stackptr;
@@ -1185,7 +1264,12 @@ typedef struct rz_analysis_esil_t {
 	ut8 lastsz;	//in bits //used for signature-flag
 	/* native ops and custom ops */
 	HtPP *ops;
-	char *current_opstr;
+	const char *current_opstr;
+	/* compiled expressions */
+	HtPP *code_cache; // expr -> RzAnalysisEsilCode
+	ut32 code_gen; // RzReg.gen of the cached code
+	int code_depth; // nesting of running compiled code
+	bool nocompile; // always use the string parser
 	RzIDStorage *sources;
 	SdbMini *interrupts;
 	//this is a disgusting workaround, because we have no ht-like storage without magic keys, that you cannot use, with int-keys
@@ -1313,9 +1397,12 @@ typedef struct rz_analysis_plugin_t {
 	char *version;
 	int bits;
 	int esil; // can do esil or not
+	bool reentrant; // op only reads the RzAnalysis it gets, keeps no state across calls and can run concurrently, see rz_analysis_thread_init
 	int fileformat_type;
 	int (*init)(void *user);
 	int (*fini)(void *user);
+	void *(*ctx_init)(RzAnalysis *analysis); // per RzAnalysis decoder state, set as plugin_data while in use
+	void (*ctx_fini)(void *ctx);
 	//int (*reset_counter) (RzAnalysis *analysis, ut64 start_addr);
 	int (*archinfo)(RzAnalysis *analysis, int query);
 	ut8* (*analysis_mask)(RzAnalysis *analysis, int size, const ut8 *data, ut64 at);
@@ -1323,6 +1410,8 @@ typedef struct rz_analysis_plugin_t {
 
 	// legacy rz_analysis_functions
 	RzAnalysisOpCallback op;
+	// optional, fills only the RzAnalysisOpLite fields without allocating
+	int (*op_lite)(RzAnalysis *a, RzAnalysisOpLite *op, ut64 addr, const ut8 *data, int len);
 
 	// command extension to directly call any analysis functions
 	RzAnalysisCmdExt cmd_ext;
@@ -1534,6 +1623,8 @@ RZ_API void rz_analysis_plugin_free (RzAnalysisPlugin *p);
 RZ_API int rz_analysis_add(RzAnalysis *analysis, RzAnalysisPlugin *foo);
 RZ_API int rz_analysis_archinfo(RzAnalysis *analysis, int query);
 RZ_API bool rz_analysis_use(RzAnalysis *analysis, const char *name);
+RZ_API bool rz_analysis_thread_init(RzAnalysis *local, RzAnalysis *analysis);
+RZ_API void rz_analysis_thread_fini(RzAnalysis *local);
 RZ_API bool rz_analysis_set_reg_profile(RzAnalysis *analysis);
 RZ_API char *rz_analysis_get_reg_profile(RzAnalysis *analysis);
 RZ_API ut64 rz_analysis_get_bbaddr(RzAnalysis *analysis, ut64 addr);
@@ -1569,6 +1660,20 @@ RZ_API int rz_analysis_op_reg_delta(RzAnalysis *analysis, ut64 addr, const char
 RZ_API bool rz_analysis_op_is_eob(RzAnalysisOp *op);
 RZ_API RzList *rz_analysis_op_list_new(void);
 RZ_API int rz_analysis_op(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_API int rz_analysis_op_decode(RzAnalysis *analysis, RzAnalysisOp *op, ut64 addr, const ut8 *data, int len, RzAnalysisOpMask mask);
+RZ_API RzAnalysisOpTable *rz_analysis_op_table_new(RzAnalysis *analysis, RzAnalysisOpMask mask);
+RZ_API void rz_analysis_op_table_free(RzAnalysisOpTable *t);
+RZ_API bool rz_analysis_op_table_add(RzAnalysisOpTable *t, RzAnalysisOp *op, const ut8 *data, int ret);
+RZ_API bool rz_analysis_op_table_has(RzAnalysisOpTable *t, ut64 addr);
+RZ_API void rz_analysis_op_lite_init(RzAnalysisOpLite *op);
+RZ_API void rz_analysis_op_to_lite(const RzAnalysisOp *op, RzAnalysisOpLite *lite);
+RZ_API int rz_analysis_op_lite_decode(RzAnalysis *analysis, RzAnalysisOpLite *op, ut64 addr, const ut8 *data, int len);
+RZ_API int rz_analysis_op_lite(RzAnalysis *analysis, RzAnalysisOpLite *op, ut64 addr, const ut8 *data, int len);
+RZ_API int rz_analysis_op_lite_batch(RzAnalysis *analysis, RzAnalysisOpLite *ops, int n, ut64 addr, const ut8 *data, int len, int *used);
+RZ_API bool rz_analysis_op_cache_set_size(RzAnalysis *analysis, size_t max_size);
+RZ_API void rz_analysis_op_cache_invalidate(RzAnalysis *analysis, ut64 addr, ut64 len);
+RZ_API void rz_analysis_op_cache_clear(RzAnalysis *analysis);
+RZ_API bool rz_analysis_op_cache_stats(RzAnalysis *analysis, RzAnalysisOpCacheStats *stats);
 RZ_API RzAnalysisOp *rz_analysis_op_hexstr(RzAnalysis *analysis, ut64 addr, const char *hexstr);
 RZ_API char *rz_analysis_op_to_string(RzAnalysis *analysis, RzAnalysisOp *op);
 
@@ -1578,6 +1683,9 @@ RZ_API bool rz_analysis_esil_setup(RzAnalysisEsil *esil, RzAnalysis *analysis, i
 RZ_API void rz_analysis_esil_free(RzAnalysisEsil *esil);
 RZ_API bool rz_analysis_esil_runword(RzAnalysisEsil *esil, const char *word);
 RZ_API bool rz_analysis_esil_parse(RzAnalysisEsil *esil, const char *str);
+RZ_API RzAnalysisEsilCode *rz_analysis_esil_compile(RzAnalysisEsil *esil, const char *str);
+RZ_API bool rz_analysis_esil_run(RzAnalysisEsil *esil, RzAnalysisEsilCode *code);
+RZ_API void rz_analysis_esil_code_free(RzAnalysisEsilCode *code);
 RZ_API bool rz_analysis_esil_dumpstack(RzAnalysisEsil *esil);
 RZ_API int rz_analysis_esil_mem_read(RzAnalysisEsil *esil, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_analysis_esil_mem_write(RzAnalysisEsil *esil, ut64 addr, const ut8 *buf, int len);
@@ -2001,6 +2109,8 @@ RZ_API bool rz_analysis_noreturn_at_addr(RzAnalysis *analysis, ut64 addr);
 RZ_API int rz_sign_space_count_for(RzAnalysis *a, const RzSpace *space);
 RZ_API void rz_sign_space_unset_for(RzAnalysis *a, const RzSpace *space);
 RZ_API void rz_sign_space_rename_for(RzAnalysis *a, const RzSpace *space, const char *oname, const char *nname);
+RZ_API void rz_sign_index_free(struct rz_sign_index_t *idx);
+RZ_API void rz_sign_index_invalidate(RzAnalysis *a);
 
 /* vtables */
 typedef struct {
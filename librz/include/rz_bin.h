@@ -269,6 +269,7 @@ typedef struct rz_bin_object_t {
 	Sdb *kv;
 	Sdb *addrzklassmethod;
 	void *bin_obj; // internal pointer used by formats
+	ut64 loaded; // RZ_BIN_REQ_* of the items already loaded
 } RzBinObject;
 
 // XXX: RbinFile may hold more than one RzBinObject
@@ -295,6 +296,7 @@ typedef struct rz_bin_file_t {
 	Sdb *sdb;
 	Sdb *sdb_info;
 	Sdb *sdb_addrinfo;
+	RzBinDwarfLineTable *addrline; // DWARF line programs, sdb_addrinfo keeps the user ones
 	struct rz_bin_t *rbin;
 } RzBinFile;
 
@@ -344,6 +346,7 @@ struct rz_bin_t {
 	bool use_ldr; // use loader plugins when loading a file?
 	RzStrConstPool constpool;
 	bool is_reloc_patched; // used to indicate whether relocations were patched or not
+	bool lazy; // load the items of an object on first access, see rz_bin_object_load_items
 };
 
 typedef struct rz_bin_xtr_metadata_t {
@@ -753,6 +756,15 @@ RZ_API void rz_bin_file_free(void /*RzBinFile*/ *bf_);
 RZ_API RzBinFile *rz_bin_file_at(RzBin *bin, ut64 addr);
 RZ_API RzBinFile *rz_bin_file_find_by_object_id(RzBin *bin, ut32 binobj_id);
 RZ_API RzList *rz_bin_file_get_symbols(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_entries(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_fields(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_imports(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_libs(RzBinFile *bf);
+RZ_API RBNode *rz_bin_file_get_relocs(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_sections(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_strings(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_classes(RzBinFile *bf);
+RZ_API RzList *rz_bin_file_get_lines(RzBinFile *bf);
 //
 RZ_API ut64 rz_bin_file_get_vaddr(RzBinFile *bf, ut64 paddr, ut64 vaddr);
 // RzBinFile.add
@@ -780,6 +792,7 @@ RZ_API void rz_bin_file_hash_free(RzBinFileHash *fhash);
 
 // binobject functions
 RZ_API int rz_bin_object_set_items(RzBinFile *binfile, RzBinObject *o);
+RZ_API void rz_bin_object_load_items(RzBinFile *bf, RzBinObject *o, ut64 items);
 RZ_API bool rz_bin_object_delete(RzBin *bin, ut32 binfile_id);
 RZ_API void rz_bin_mem_free(void *data);
 
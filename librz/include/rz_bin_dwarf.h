@@ -655,6 +655,24 @@ typedef struct {
 	unsigned int column;
 } RzBinDwarfRow;
 
+typedef struct {
+	ut64 address;
+	ut32 file; // index in RzBinDwarfLineTable.files
+	ut32 line;
+	ut32 column;
+} RzBinDwarfLineEntry;
+
+/* line programs of all the units, one entry per address sorted by address */
+typedef struct {
+	size_t count;
+	size_t capacity;
+	RzBinDwarfLineEntry *entries;
+	size_t files_count;
+	size_t files_capacity;
+	char **files;
+	HtPP/*<char *path, ut32 index + 1>*/ *files_idx;
+} RzBinDwarfLineTable;
+
 #define DWARF_INIT_LEN_64	0xffffffff
 typedef union {
 	ut32 offset32;
@@ -759,7 +777,9 @@ typedef struct {
 	ut64	offset;
 	size_t	count;
 	size_t	capacity;
-	RzBinDwarfDie *dies;
+	RzBinDwarfDie *dies; // NULL until the unit is loaded
+	size_t	first_abbr_idx;
+	bool	loaded;
 } RzBinDwarfCompUnit;
 
 #define COMP_UNIT_CAPACITY	8
@@ -768,7 +788,13 @@ typedef struct {
 	size_t count;
 	size_t capacity;
 	RzBinDwarfCompUnit *comp_units;
-	HtUP/*<ut64 offset, DwarfDie *die>*/ *lookup_table;
+	// sections kept around to load the units on demand
+	ut8 *buf;
+	size_t len;
+	ut8 *debug_str;
+	size_t debug_str_len;
+	const struct rz_bin_dwarf_debug_abbrev_t *abbrevs;
+	bool big_endian;
 } RzBinDwarfDebugInfo;
 
 #define	ABBREV_DECL_CAP		8
@@ -785,7 +811,7 @@ typedef struct {
 
 #define DEBUG_ABBREV_CAP	32
 
-typedef struct {
+typedef struct rz_bin_dwarf_debug_abbrev_t {
 	size_t count;
 	size_t capacity;
 	RzBinDwarfAbbrevDecl *decls;
@@ -851,6 +877,14 @@ RZ_API RzList *rz_bin_dwarf_parse_aranges(RzBin *a, int mode);
 RZ_API RzList *rz_bin_dwarf_parse_line(RzBin *a, int mode);
 RZ_API RzBinDwarfDebugAbbrev *rz_bin_dwarf_parse_abbrev(RzBin *a, int mode);
 RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_parse_info(RzBinDwarfDebugAbbrev *da, RzBin *a, int mode);
+RZ_API RzBinDwarfDebugInfo *rz_bin_dwarf_index_info(RzBinDwarfDebugAbbrev *da, RzBin *a);
+RZ_API bool rz_bin_dwarf_info_load_unit(RzBinDwarfDebugInfo *info, size_t idx);
+RZ_API bool rz_bin_dwarf_info_load_all(RzBinDwarfDebugInfo *info);
+RZ_API RzBinDwarfDie *rz_bin_dwarf_info_get_die(RzBinDwarfDebugInfo *info, ut64 offset);
+RZ_API RzBinDwarfLineTable *rz_bin_dwarf_parse_line_table(RzBin *a, int mode);
+RZ_API const RzBinDwarfLineEntry *rz_bin_dwarf_line_table_get(const RzBinDwarfLineTable *table, ut64 addr);
+RZ_API bool rz_bin_dwarf_line_table_del(RzBinDwarfLineTable *table, ut64 addr);
+RZ_API void rz_bin_dwarf_line_table_free(RzBinDwarfLineTable *table);
 RZ_API HtUP/*<offset, RzBinDwarfLocList*>*/  *rz_bin_dwarf_parse_loc(RzBin *bin, int addr_size);
 RZ_API void rz_bin_dwarf_print_loc(HtUP /*<offset, RzBinDwarfLocList*>*/  *loc_table, int addr_size, PrintfCallback print);
 RZ_API void rz_bin_dwarf_free_loc(HtUP /*<offset, RzBinDwarfLocList*>*/  *loc_table);
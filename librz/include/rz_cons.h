@@ -106,6 +106,8 @@ typedef struct rz_cons_grep_t {
 	int begin;
 	int end;
 	int icase;
+	bool streamed; // part of the output was already written by rz_cons_stream_flush
+	bool show; // line range state carried between streamed chunks
 } RzConsGrep;
 
 #if 0
@@ -441,6 +443,8 @@ typedef void (*RzConsSleepEndCallback)(void *core, void *user);
 typedef void (*RzConsQueueTaskOneshot)(void *core, void *task, void *user);
 typedef void (*RzConsFunctionKey)(void *core, int fkey);
 
+typedef void (*RzConsStreamCallback)(const char *buf, size_t len, void *user);
+
 typedef enum { COLOR_MODE_DISABLED = 0, COLOR_MODE_16, COLOR_MODE_256, COLOR_MODE_16M } RzConsColorMode;
 
 typedef struct rz_cons_context_t {
@@ -469,6 +473,12 @@ typedef struct rz_cons_context_t {
 	int color_mode;
 	RzConsPalette cpal;
 	RzConsPrintablePalette pal;
+
+	// Output of this context goes to stream_cb instead of fdout, in chunks
+	// of stream bytes while it is produced, see rz_cons_context_stream ()
+	size_t stream;
+	RzConsStreamCallback stream_cb;
+	void *stream_user;
 } RzConsContext;
 
 #define HUD_BUF_SIZE 512
@@ -535,6 +545,7 @@ typedef struct rz_cons_t {
 	bool dotted_lines;
 	int linesleep;
 	int pagesize;
+	size_t stream; // write the output in chunks of this size while it is produced, 0 to disable
 	char *break_word;
 	int break_word_len;
 	ut64 timeout; // must come from rz_time_now_mono()
@@ -860,6 +871,9 @@ RZ_API void rz_cons_pop(void);
 RZ_API RzConsContext *rz_cons_context_new(RZ_NULLABLE RzConsContext *parent);
 RZ_API void rz_cons_context_free(RzConsContext *context);
 RZ_API void rz_cons_context_load(RzConsContext *context);
+RZ_API void rz_cons_context_load_local(RZ_NULLABLE RzConsContext *context);
+RZ_API RzConsContext *rz_cons_context(void);
+RZ_API void rz_cons_context_stream(RzConsContext *context, size_t size, RZ_NULLABLE RzConsStreamCallback cb, void *user);
 RZ_API void rz_cons_context_reset(void);
 RZ_API bool rz_cons_context_is_main(void);
 RZ_API void rz_cons_context_break(RzConsContext *context);
@@ -906,6 +920,8 @@ RZ_API int rz_cons_memcat(const char *str, int len);
 RZ_API void rz_cons_newline(void);
 RZ_API void rz_cons_filter(void);
 RZ_API void rz_cons_flush(void);
+RZ_API void rz_cons_stream_flush(void);
+RZ_API void rz_cons_pj_stream(PJ *pj);
 RZ_API void rz_cons_print_fps (int col);
 RZ_API void rz_cons_last(void);
 RZ_API int rz_cons_less_str(const char *str, const char *exitkeys);
@@ -967,6 +983,7 @@ RZ_API void rz_cons_grep_parsecmd(char *cmd, const char *quotestr);
 RZ_API char * rz_cons_grep_strip(char *cmd, const char *quotestr);
 RZ_API void rz_cons_grep_process(char * grep);
 RZ_API int rz_cons_grep_line(char *buf, int len); // must be static
+RZ_API bool rz_cons_grep_lines(const char *buf, int len, RzStrBuf *ob);
 RZ_API void rz_cons_grepbuf(void);
 
 RZ_API void rz_cons_rgb(ut8 r, ut8 g, ut8 b, ut8 a);
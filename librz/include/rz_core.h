@@ -72,7 +72,7 @@ RZ_LIB_VERSION_HEADER(rz_core);
 #define RZ_GRAPH_FORMAT_CMD          5
 
 ///
-#define RZ_CONS_COLOR_DEF(x, def) ((core->cons && core->cons->context->pal.x)? core->cons->context->pal.x: def)
+#define RZ_CONS_COLOR_DEF(x, def) ((core->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x: def)
 #define RZ_CONS_COLOR(x) RZ_CONS_COLOR_DEF (x, "")
 
 /* rtr */
@@ -221,6 +221,21 @@ typedef struct rz_core_tasks_t {
 	RzThreadLock *lock;
 	int tasks_running;
 	bool oneshot_running;
+	// Serial tasks hold the core alone while they run, parallel ones share
+	// it with each other (see rz_core_task_enqueue ()). gate_lock guards
+	// the counters below and the worker pool.
+	RzThreadLock *gate_lock;
+	RzThreadCond *gate_cond;
+	int readers;
+	int readers_waiting;
+	int readers_pass; // readers let in ahead of the waiting writers
+	int writers_waiting;
+	bool writer;
+	struct rz_core_task_worker_t *workers;
+	int workers_count;
+	int workers_next;
+	int workers_pending;
+	bool workers_stop;
 } RzCoreTaskScheduler;
 
 struct rz_core_t {
@@ -310,6 +325,7 @@ struct rz_core_t {
 	bool scr_gadgets;
 	bool log_events; // core.c:cb_event_handler : log actions from events if cfg.log.events is set
 	RzList *ropchain;
+	struct rz_project_bin_t *prj_bin; // binary project loaded piece by piece with prj.lazy
 	bool use_tree_sitter_rzcmd;
 	bool use_newshell_autocompletion;
 
@@ -594,6 +610,11 @@ RZ_API int rz_core_analysis_graph_fcn(RzCore *core, char *input, int opts);
 RZ_API RzList* rz_core_analysis_graph_to(RzCore *core, ut64 addr, int n);
 RZ_API int rz_core_analysis_ref_list(RzCore *core, int rad);
 RZ_API int rz_core_analysis_all(RzCore *core);
+/* analysis_prefetch.c */
+typedef struct rz_core_analysis_prefetch_t RzCoreAnalysisPrefetch;
+RZ_API RzCoreAnalysisPrefetch *rz_core_analysis_prefetch_new(RzCore *core, const ut64 *addrs, size_t count, int threads);
+RZ_API void rz_core_analysis_prefetch_use(RzCoreAnalysisPrefetch *pf, size_t idx);
+RZ_API void rz_core_analysis_prefetch_free(RzCoreAnalysisPrefetch *pf);
 RZ_API RzList* rz_core_analysis_cycles (RzCore *core, int ccl);
 RZ_API RzList *rz_core_analysis_fcn_get_calls (RzCore *core, RzAnalysisFunction *fcn); // get all calls from a function
 
@@ -838,6 +859,13 @@ typedef struct rz_core_task_t {
 	bool cmd_log;
 	RzConsContext *cons_context;
 	RzCoreTaskCallback cb;
+	bool parallel; // runs side by side with other parallel tasks, the command must only read the core and not use its seek or block, see &r
+	bool core_held; // holds the core in the scheduler gate
+	int wakeups; // a serial task can be woken again while it runs, see rz_core_task_run_sync ()
+	ut64 time_created; // rz_time_now_mono ()
+	ut64 time_started;
+	ut64 time_finished;
+	ut64 cpu_time; // usecs spent running
 } RzCoreTask;
 
 typedef void (*RzCoreTaskOneShot)(void *);
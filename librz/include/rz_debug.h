@@ -161,12 +161,18 @@ typedef struct rz_debug_desc_t {
 	ut64 off;
 } RzDebugDesc;
 
+// Snapshots hash and compare memory in pages of this size
+#define RZ_DEBUG_SNAP_PAGE_SIZE 0x1000
+
 typedef struct rz_debug_snap_t {
 	char *name;
 	ut64 addr;
 	ut64 addr_end;
 	ut32 size;
 	ut8 *data;
+	ut32 *hashes; // xxhash of every page of data
+	ut8 *changed; // pages changed by the last rz_debug_snap_update, NULL if all
+	ut32 epoch; // RzDebug.snap_epoch when data was last read
 	int perm;
 	int user;
 	bool shared;
@@ -177,15 +183,41 @@ typedef struct {
 	ut64 data;
 } RzDebugChangeReg;
 
+// Memory of a session is tracked per page: checkpoints keep a version of a
+// page only when it changed since the previous one, and steps in between log
+// the bytes they write in the page they belong to.
+#define RZ_DEBUG_SESSION_PAGE_SIZE RZ_DEBUG_SNAP_PAGE_SIZE
+// Register arenas of checkpoints are stored as deltas against the previous
+// checkpoint, with a full copy every RZ_DEBUG_SESSION_KEYFRAME checkpoints
+#define RZ_DEBUG_SESSION_KEYFRAME 16
+
 typedef struct {
 	int cnum;
+	ut16 off; // offset in the page
 	ut8 data;
 } RzDebugChangeMem;
 
+typedef struct {
+	int cnum;
+	ut8 *data; // RZ_DEBUG_SESSION_PAGE_SIZE bytes
+} RzDebugPageVersion;
+
+typedef struct {
+	ut32 off;
+	ut32 len;
+} RzDebugArenaRun;
+
+typedef struct {
+	int size; // size of the whole arena
+	RzVector runs; // RzDebugArenaRun
+	ut8 *data; // bytes of the runs, back to back
+} RzDebugArenaDelta;
+
 typedef struct rz_debug_checkpoint_t {
 	int cnum;
-	RzRegArena *arena[RZ_REG_TYPE_LAST];
-	RzList *snaps; // <RzDebugSnap>
+	RzRegArena *arena[RZ_REG_TYPE_LAST]; // full copy, only on keyframes
+	RzDebugArenaDelta *delta[RZ_REG_TYPE_LAST]; // otherwise
+	RzList *snaps; // <RzDebugSnap>, without data: it lives in the session pages
 } RzDebugCheckpoint;
 
 typedef struct rz_debug_session_t {
@@ -193,8 +225,10 @@ typedef struct rz_debug_session_t {
 	ut32 maxcnum;
 	RzDebugCheckpoint *cur_chkpt;
 	RzVector *checkpoints; /* RzVector<RzDebugCheckpoint> */
-	HtUP *memory; /* RzVector<RzDebugChangeMem> */
+	HtUP *memory; /* page -> RzVector<RzDebugChangeMem> */
+	HtUP *pages; /* page -> RzVector<RzDebugPageVersion> */
 	HtUP *registers; /* RzVector<RzDebugChangeReg> */
+	RzList *snaps; /* RzList<RzDebugSnap> of the last checkpoint, updated incrementally */
 	int reasontype /*RzDebugReasonType*/;
 	RzBreakpointItem *bp;
 } RzDebugSession;
@@ -321,6 +355,8 @@ typedef struct rz_debug_t {
 	bool verbose;
 	bool main_arena_resolved; /* is the main_arena resolved already? */
 	int glibc_version;
+	int snap_dirty; /* soft-dirty page tracking: 0 unknown, 1 usable, -1 unsupported */
+	ut32 snap_epoch; /* bumped every time the dirty bits are cleared */
 } RzDebug;
 
 typedef struct rz_debug_desc_plugin_t {
@@ -400,6 +436,9 @@ typedef struct rz_debug_plugin_t {
 	int (*map_protect)(RzDebug *dbg, ut64 addr, int size, int perms);
 	int (*init)(RzDebug *dbg);
 	int (*drx)(RzDebug *dbg, int n, ut64 addr, int size, int rwx, int g, int api_type);
+	/* pages written since the last dirty_clear, one byte per RZ_DEBUG_SNAP_PAGE_SIZE */
+	bool (*dirty_clear)(RzDebug *dbg);
+	int (*dirty_pages)(RzDebug *dbg, ut64 addr, ut64 size, ut8 *dirty);
 	RzDebugDescPlugin desc;
 	// TODO: use RzList here
 } RzDebugPlugin;
@@ -580,10 +619,14 @@ RZ_API void rz_debug_esil_prestep (RzDebug *d, int p);
 RZ_API bool rz_debug_add_checkpoint(RzDebug *dbg);
 RZ_API bool rz_debug_session_add_reg_change(RzDebugSession *session, int arena, ut64 offset, ut64 data);
 RZ_API bool rz_debug_session_add_mem_change(RzDebugSession *session, ut64 addr, ut8 data);
+RZ_API bool rz_debug_session_add_mem_changes(RzDebugSession *session, ut64 addr, const ut8 *buf, size_t len);
+RZ_API bool rz_debug_session_add_checkpoint(RzDebugSession *session, RzRegArena **arenas, RzList *snaps);
+RZ_API RzRegArena *rz_debug_session_get_arena(RzDebugSession *session, size_t chkpt_idx, int type);
+RZ_API bool rz_debug_session_read_at(RzDebugSession *session, ut32 cnum, ut64 addr, ut8 *buf, size_t len);
 RZ_API void rz_debug_session_restore_reg_mem(RzDebug *dbg, ut32 cnum);
 RZ_API void rz_debug_session_list_memory(RzDebug *dbg);
-RZ_API void rz_debug_session_serialize(RzDebugSession *session, Sdb *db);
-RZ_API void rz_debug_session_deserialize(RzDebugSession *session, Sdb *db);
+RZ_API bool rz_debug_session_serialize(RzDebugSession *session, RzBuffer *b);
+RZ_API bool rz_debug_session_deserialize(RzDebugSession *session, RzBuffer *b);
 RZ_API bool rz_debug_session_save(RzDebugSession *session, const char *file);
 RZ_API bool rz_debug_session_load(RzDebug *dbg, const char *file);
 RZ_API bool rz_debug_trace_ins_before(RzDebug *dbg);
@@ -593,6 +636,9 @@ RZ_API RzDebugSession *rz_debug_session_new(void);
 RZ_API void rz_debug_session_free(RzDebugSession *session);
 
 RZ_API RzDebugSnap *rz_debug_snap_map(RzDebug *dbg, RzDebugMap *map);
+RZ_API RzList *rz_debug_snap_maps(RzDebug *dbg, int perm);
+RZ_API int rz_debug_snap_update(RzDebug *dbg, RzList *snaps);
+RZ_API int rz_debug_snap_restore(RzDebug *dbg, RzDebugSnap *snap);
 RZ_API bool rz_debug_snap_contains(RzDebugSnap *snap, ut64 addr);
 RZ_API ut8 *rz_debug_snap_get_hash(RzDebugSnap *snap);
 RZ_API bool rz_debug_snap_is_equal(RzDebugSnap *a, RzDebugSnap *b);
@@ -189,6 +189,11 @@ typedef struct rz_hash_seed_t {
 	int len;
 } RzHashSeed;
 
+/* several algorithms over the same data, see multi.c */
+typedef struct rz_hash_multi_t RzHashMulti;
+typedef int (*RzHashMultiRead)(void *user, ut64 addr, ut8 *buf, int len);
+typedef void (*RzHashMultiBlock)(void *user, ut64 addr, int len, ut64 algo, RzHash *ctx);
+
 #define RZ_HASH_SIZE_CRC8_SMBUS 1
 #if RZ_HAVE_CRC8_EXTRA
 #define RZ_HASH_SIZE_CRC8_CDMA2000 1
@@ -526,6 +531,17 @@ RZ_API int rz_hash_pcprint(const ut8 *buffer, ut64 len);
 RZ_API void rz_hash_do_begin(RzHash *ctx, ut64 flags);
 RZ_API void rz_hash_do_end(RzHash *ctx, ut64 flags);
 RZ_API void rz_hash_do_spice(RzHash *ctx, ut64 algo, int loops, RzHashSeed *seed);
+
+/* multi */
+RZ_API bool rz_hash_multi_streamable(ut64 algobits);
+RZ_API RzHashMulti *rz_hash_multi_new(ut64 algobits, int nthreads);
+RZ_API void rz_hash_multi_free(RzHashMulti *mh);
+RZ_API void rz_hash_multi_begin(RzHashMulti *mh);
+RZ_API void rz_hash_multi_update(RzHashMulti *mh, const ut8 *buf, int len);
+RZ_API void rz_hash_multi_end(RzHashMulti *mh);
+RZ_API RzHash *rz_hash_multi_get(RzHashMulti *mh, ut64 algo);
+RZ_API bool rz_hash_multi_stream(RzHashMulti *mh, RzHashMultiRead read, void *user, ut64 from, ut64 to, int bsize);
+RZ_API bool rz_hash_multi_blocks(RzHashMulti *mh, RzHashMultiRead read, void *user, ut64 from, ut64 to, int bsize, RzHashMultiBlock cb, void *cb_user);
 #endif
 
 #ifdef __cplusplus
@@ -75,6 +75,28 @@ typedef struct rz_io_undo_w_t {
 	int len;  /* length */
 } RzIOUndoWrite;
 
+#define RZ_IO_PAGE_CACHE_PAGE_SIZE 0x1000
+
+typedef struct rz_io_page_cache_frame_t {
+	int fd;
+	ut64 page; // paddr / RZ_IO_PAGE_CACHE_PAGE_SIZE
+	ut32 size; // valid bytes, less than a page at the end of the desc
+	bool ref; // CLOCK reference bit
+	bool used;
+} RzIOPageCacheFrame;
+
+typedef struct rz_io_page_cache_t {
+	ut8 *data; // frames_count pages
+	RzIOPageCacheFrame *frames;
+	ut32 *table; // open addressing, frame index + 1 or 0 if empty
+	ut32 table_mask;
+	ut32 frames_count;
+	ut32 used;
+	ut32 hand;
+	ut64 hits;
+	ut64 misses;
+} RzIOPageCache;
+
 typedef struct rz_io_t {
 	struct rz_io_desc_t *desc; // XXX deprecate... we should use only the fd integer, not hold a weak pointer
 	ut64 off;
@@ -93,8 +115,12 @@ typedef struct rz_io_t {
 	RzSkyline map_skyline; // map parts that are not covered by others
 	RzIDStorage *files;
 	RzCache *buffer;
-	RzPVector cache;
-	RzSkyline cache_skyline;
+	RzIOPageCache page_cache;
+	RBTree cache; // RzIOCachePage sorted by addr
+	struct rz_io_cache_page_t *cache_last; // last page looked up
+	RzVector cache_writes; // RzIOCacheWrite, every write in order, see rz_io_cache_list
+	RzVector cache_bytes; // ut8, new and replaced bytes of cache_writes
+	RzList *cache_stack; // state saved by rz_io_cache_push
 	ut8 *write_mask;
 	int write_mask_len;
 	RzIOUndo undo;
@@ -132,6 +158,14 @@ typedef struct {
 	void *data;
 } RzIODescData;
 
+// one range of rz_io_read_batch
+typedef struct rz_io_batch_read_t {
+	ut64 addr;
+	ut8 *buf;
+	int len;
+	int ret; // length of the read prefix, filled by the read
+} RzIOBatchRead;
+
 // Move somewhere else?
 typedef struct {
 	RzSocket *fd;
@@ -156,6 +190,7 @@ typedef struct rz_io_plugin_t {
 	RzIODesc* (*open)(RzIO *io, const char *, int perm, int mode);
 	RzList* /*RzIODesc* */ (*open_many)(RzIO *io, const char *, int perm, int mode);
 	int (*read)(RzIO *io, RzIODesc *fd, ut8 *buf, int count);
+	int (*read_batch)(RzIO *io, RzIODesc *fd, RzIOBatchRead *reqs, int count); // reqs hold paddrs, returns the number of complete reqs
 	ut64 (*lseek)(RzIO *io, RzIODesc *fd, ut64 offset, int whence);
 	int (*write)(RzIO *io, RzIODesc *fd, const ut8 *buf, int count);
 	int (*close)(RzIODesc *desc);
@@ -187,6 +222,25 @@ typedef struct rz_io_cache_t {
 	int written;
 } RzIOCache;
 
+typedef struct rz_io_cache_write_t {
+	RzInterval itv;
+	size_t off; // of the written bytes in cache_bytes, the replaced ones follow them
+	bool written;
+} RzIOCacheWrite;
+
+#define RZ_IO_CACHE_PAGE_SIZE 0x1000
+
+typedef struct rz_io_cache_page_t {
+	RBNode rb;
+	ut64 addr; // aligned to RZ_IO_CACHE_PAGE_SIZE
+	ut8 mask[RZ_IO_CACHE_PAGE_SIZE / 8]; // one bit for every cached byte
+	ut8 wmask[RZ_IO_CACHE_PAGE_SIZE / 8]; // one bit for every cached byte committed to the underlying io
+	ut8 data[RZ_IO_CACHE_PAGE_SIZE];
+	ut8 odata[RZ_IO_CACHE_PAGE_SIZE]; // original bytes, read when the page is created
+} RzIOCachePage;
+
+typedef bool (*RzIOCacheForeachCallback)(void *user, const RzIOCache *range);
+
 #define RZ_IO_DESC_CACHE_SIZE (sizeof(ut64) * 8)
 typedef struct rz_io_desc_cache_t {
 	ut64 cached;
@@ -202,6 +256,7 @@ typedef RzIODesc *(*RzIOOpen) (RzIO *io, const char *uri, int flags, int mode);
 typedef RzIODesc *(*RzIOOpenAt) (RzIO *io, const  char *uri, int flags, int mode, ut64 at);
 typedef bool (*RzIOClose) (RzIO *io, int fd);
 typedef bool (*RzIOReadAt) (RzIO *io, ut64 addr, ut8 *buf, int len);
+typedef int (*RzIOReadBatch) (RzIO *io, RzIOBatchRead *reqs, int count);
 typedef bool (*RzIOWriteAt) (RzIO *io, ut64 addr, const ut8 *buf, int len);
 typedef char *(*RzIOSystem) (RzIO *io, const char* cmd);
 typedef int (*RzIOFdOpen) (RzIO *io, const char *uri, int flags, int mode);
@@ -239,6 +294,7 @@ typedef struct rz_io_bind_t {
 	RzIOOpenAt open_at;
 	RzIOClose close;
 	RzIOReadAt read_at;
+	RzIOReadBatch read_batch;
 	RzIOWriteAt write_at;
 	RzIOSystem system;
 	RzIOFdOpen fd_open;
@@ -324,6 +380,7 @@ RZ_API bool rz_io_vread_at_mapped(RzIO* io, ut64 vaddr, ut8* buf, int len);
 RZ_API bool rz_io_read_at (RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API bool rz_io_read_at_mapped(RzIO *io, ut64 addr, ut8 *buf, int len);
 RZ_API int rz_io_nread_at (RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API int rz_io_read_batch(RzIO *io, RzIOBatchRead *reqs, int count);
 RZ_API void rz_io_alprint(RzList *ls);
 RZ_API bool rz_io_write_at (RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_read (RzIO *io, ut8 *buf, int len);
@@ -416,6 +473,20 @@ RZ_API int rz_io_cache_list(RzIO *io, int rad);
 RZ_API void rz_io_cache_reset(RzIO *io, int set);
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len);
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len);
+RZ_API bool rz_io_cache_foreach(RzIO *io, RzIOCacheForeachCallback cb, void *user);
+RZ_API bool rz_io_cache_push(RzIO *io);
+RZ_API bool rz_io_cache_pop(RzIO *io);
+
+/* io/io_page_cache.c */
+RZ_API void rz_io_page_cache_init(RzIO *io);
+RZ_API void rz_io_page_cache_fini(RzIO *io);
+RZ_API bool rz_io_page_cache_resize(RzIO *io, ut64 size);
+RZ_API ut64 rz_io_page_cache_size(RzIO *io);
+RZ_API void rz_io_page_cache_reset(RzIO *io);
+RZ_API void rz_io_page_cache_invalidate(RzIO *io, int fd, ut64 paddr, ut64 len);
+RZ_API void rz_io_page_cache_invalidate_fd(RzIO *io, int fd);
+RZ_API bool rz_io_page_cache_usable(RzIODesc *desc);
+RZ_API int rz_io_page_cache_read(RzIODesc *desc, ut64 paddr, ut8 *buf, int len);
 
 /* io/p_cache.c */
 RZ_API bool rz_io_desc_cache_init(RzIODesc *desc);
@@ -24,6 +24,9 @@ typedef struct rz_pdb_t {
 	RzList *pdb_streams;
 	RzList *pdb_streams2;
 	RzBuffer *buf; // mmap of file
+	RMmap *mmap; // mapping wrapped by buf, when opened with init_pdb_parser ()
+	const ut8 *data; // contents of buf, the streams are copied from here
+	ut64 data_size;
 //	int curr;
 
 	void (*print_gvars)(struct rz_pdb_t *pdb, ut64 img_base, PJ *pj, int format);
@@ -11,6 +11,15 @@ extern "C" {
 #endif
 
 typedef Sdb RzProject;
+typedef struct rz_project_bin_t RzProjectBin;
+
+enum {
+	RZ_PROJECT_BIN_XREFS = 1 << 0,
+	RZ_PROJECT_BIN_FUNCTIONS = 1 << 1, ///< functions and their basic blocks
+	RZ_PROJECT_BIN_META = 1 << 2,
+	RZ_PROJECT_BIN_FLAGS = 1 << 3,
+	RZ_PROJECT_BIN_ALL = (1 << 4) - 1
+};
 
 typedef enum rz_project_err {
 	RZ_PROJECT_ERR_SUCCESS,
@@ -23,6 +32,7 @@ typedef enum rz_project_err {
 } RzProjectErr;
 
 RZ_API RZ_NONNULL const char *rz_project_err_message(RzProjectErr err);
+RZ_API RzProjectErr rz_project_check(RzProject *prj);
 RZ_API RzProjectErr rz_project_save(RzCore *core, RzProject *prj, const char *file);
 RZ_API RzProjectErr rz_project_save_file(RzCore *core, const char *file);
 
@@ -38,6 +48,21 @@ RZ_API RzProjectErr rz_project_load(RzCore *core, RzProject *prj, bool load_bin_
  */
 RZ_API RzProjectErr rz_project_load_file(RzCore *core, const char *file, bool load_bin_io, RzSerializeResultInfo *res);
 
+/* binary projects, see project_bin.c */
+RZ_API RZ_OWN ut8 *rz_project_bin_from_sdb(RZ_NONNULL RzProject *prj, RZ_NONNULL ut64 *size);
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_new(RZ_NONNULL const ut8 *buf, ut64 size, RZ_NULLABLE RzProjectErr *err);
+RZ_API RZ_OWN RzProjectBin *rz_project_bin_open(RZ_NONNULL const char *file, RZ_NULLABLE RzProjectErr *err);
+RZ_API void rz_project_bin_free(RZ_NULLABLE RzProjectBin *pb);
+RZ_API bool rz_project_bin_is_file(RZ_NONNULL const char *file);
+RZ_API RZ_OWN RzProject *rz_project_bin_sdb(RZ_NONNULL RzProjectBin *pb);
+RZ_API bool rz_project_bin_load_range(RZ_NONNULL RzProjectBin *pb, RZ_NONNULL RzAnalysis *analysis, RZ_NULLABLE RzFlag *flag,
+	int tables, ut64 from, ut64 to, RZ_NULLABLE RzSerializeResultInfo *res);
+RZ_API RzProjectErr rz_project_bin_load(RzCore *core, RZ_NONNULL RzProjectBin *pb, bool load_bin_io, RZ_NULLABLE const char *file, bool lazy, RzSerializeResultInfo *res);
+RZ_API void rz_project_bin_load_at(RZ_NONNULL RzCore *core, ut64 addr);
+RZ_API void rz_project_bin_load_rest(RZ_NONNULL RzCore *core);
+RZ_API RzProjectErr rz_project_save_file_bin(RzCore *core, const char *file);
+RZ_API RzProjectErr rz_project_convert_file(RZ_NONNULL const char *sdb_file, RZ_NONNULL const char *bin_file);
+
 #ifdef __cplusplus
 }
 #endif
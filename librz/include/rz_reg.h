@@ -127,6 +127,7 @@ typedef struct rz_reg_t {
 	int size;
 	bool is_thumb;
 	bool big_endian;
+	ut32 gen; // changes whenever the register items are replaced
 } RzReg;
 
 typedef struct rz_reg_flags_t {
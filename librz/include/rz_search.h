@@ -51,6 +51,8 @@ typedef struct rz_search_hit_t {
 
 typedef int (*RzSearchCallback)(RzSearchKeyword *kw, void *user, ut64 where);
 
+typedef struct rz_search_kwset_t RzSearchKwSet;
+
 typedef struct rz_search_t {
 	int n_kws; // hit${n_kws}_${count}
 	int mode;
@@ -70,6 +72,7 @@ typedef struct rz_search_t {
 	int align;
 	int (*update)(struct rz_search_t *s, ut64 from, const ut8 *buf, int len);
 	RzList *kws; // TODO: Use rz_search_kw_new ()
+	RzSearchKwSet *kwset; // kws compiled for RZ_SEARCH_KEYWORD, NULL when they change
 	RzIOBind iob;
 	char bckwrds;
 } RzSearch;
@@ -103,6 +103,8 @@ typedef struct {
 	RzSignItem *item;
 } RzSignCloseMatch;
 
+typedef struct rz_sign_index_t RzSignIndex;
+
 #ifdef RZ_API
 RZ_API bool rz_sign_add_bytes(RzAnalysis *a, const char *name, ut64 size, const ut8 *bytes, const ut8 *mask);
 RZ_API bool rz_sign_add_analysis(RzAnalysis *a, const char *name, ut64 size, const ut8 *bytes, ut64 at);
@@ -158,6 +160,12 @@ RZ_API void rz_sign_close_match_free(RzSignCloseMatch *match);
 RZ_API bool rz_sign_diff(RzAnalysis *a, RzSignOptions *options, const char *other_space_name);
 RZ_API bool rz_sign_diff_by_name(RzAnalysis *a, RzSignOptions *options, const char *other_space_name, bool not_matching);
 
+RZ_API RzSignIndex *rz_sign_index_new(RzAnalysis *a);
+RZ_API RzSignIndex *rz_sign_index_get(RzAnalysis *a);
+RZ_API size_t rz_sign_index_count(RzSignIndex *idx);
+RZ_API RzSignItem *rz_sign_index_item(RzSignIndex *idx, size_t n);
+RZ_API bool rz_sign_index_save(RzAnalysis *a, const char *file);
+
 RZ_API RzSignOptions *rz_sign_options_new(const char *bytes_thresh, const char *graph_thresh);
 RZ_API void rz_sign_options_free(RzSignOptions *options);
 #endif
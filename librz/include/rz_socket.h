@@ -80,6 +80,7 @@ typedef struct rz_socket_http_options {
 	bool accept_timeout;
 	int timeout;
 	bool httpauth;
+	int keepalive; // seconds to wait for the next request on a connection, 0 closes it
 } RzSocketHTTPOptions;
 
 #define RZ_SOCKET_PROTO_TCP IPPROTO_TCP
@@ -151,10 +152,18 @@ typedef struct rz_socket_http_request {
 	ut8 *data;
 	int data_length;
 	bool auth;
+	bool http11;
+	bool keepalive;
+	bool chunked;
 } RzSocketHTTPRequest;
 
 RZ_API RzSocketHTTPRequest *rz_socket_http_accept(RzSocket *s, RzSocketHTTPOptions *so);
+RZ_API RzSocketHTTPRequest *rz_socket_http_read(RzSocket *s, RzSocketHTTPOptions *so);
+RZ_API RzSocketHTTPRequest *rz_socket_http_next(RzSocketHTTPRequest *rs, RzSocketHTTPOptions *so);
 RZ_API void rz_socket_http_response(RzSocketHTTPRequest *rs, int code, const char *out, int x, const char *headers);
+RZ_API void rz_socket_http_response_begin(RzSocketHTTPRequest *rs, int code, const char *headers);
+RZ_API void rz_socket_http_chunk(RzSocketHTTPRequest *rs, const char *out, int len);
+RZ_API void rz_socket_http_response_end(RzSocketHTTPRequest *rs);
 RZ_API void rz_socket_http_close(RzSocketHTTPRequest *rs);
 RZ_API ut8 *rz_socket_http_handle_upload(const ut8 *str, int len, int *olen);
 
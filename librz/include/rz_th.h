@@ -48,6 +48,12 @@
 #error Threading library only supported for pthread and w32
 #endif
 
+#if defined(_MSC_VER)
+#define RZ_TH_LOCAL __declspec(thread)
+#else
+#define RZ_TH_LOCAL __thread
+#endif
+
 typedef enum { RZ_TH_FREED = -1, RZ_TH_STOP = 0, RZ_TH_REPEAT = 1 } RzThreadFunctionRet;
 #define RZ_TH_FUNCTION(x) RzThreadFunctionRet (*x)(struct rz_th_t *)
 
@@ -96,6 +102,7 @@ RZ_API RZ_TH_TID rz_th_self(void);
 RZ_API bool rz_th_setname(RzThread *th, const char *name);
 RZ_API bool rz_th_getname(RzThread *th, char *name, size_t len);
 RZ_API bool rz_th_setaffinity(RzThread *th, int cpuid);
+RZ_API int rz_th_cpu_count(void);
 
 RZ_API RzThreadSemaphore *rz_th_sem_new(unsigned int initial);
 RZ_API void rz_th_sem_free(RzThreadSemaphore *sem);
@@ -23,6 +23,8 @@ typedef enum PJEncodingNum {
 	PJ_ENCODING_NUM_HEX
 } PJEncodingNum;
 
+typedef void (*PJFlushCallback)(const char *buf, size_t len, void *user);
+
 typedef struct pj_t {
 	RzStrBuf sb;
 	bool is_first;
@@ -31,6 +33,9 @@ typedef struct pj_t {
 	int level;
 	PJEncodingStr str_encoding;
 	PJEncodingNum num_encoding;
+	PJFlushCallback flush;
+	void *flush_user;
+	size_t flush_size;
 } PJ;
 
 /* lifecycle */
@@ -40,6 +45,8 @@ RZ_API void pj_free(PJ *j);
 RZ_API void pj_reset(PJ *j); // clear the pj contents, but keep the buffer allocated to re-use it
 RZ_API char *pj_drain(PJ *j);
 RZ_API const char *pj_string(PJ *pj);
+RZ_API void pj_set_flush(PJ *j, size_t size, PJFlushCallback cb, void *user);
+RZ_API void pj_flush(PJ *j);
 // RZ_API void pj_print(PJ *j, PrintfCallback cb);
 
 /* nesting */
@@ -80,6 +80,7 @@ typedef struct rz_event_io_write_t {
 	ut64 addr;
 	const ut8 *buf;
 	int len;
+	int fd; // addr is a physical address of this desc, -1 for a virtual one
 } RzEventIOWrite;
 
 RZ_API RzEvent *rz_event_new(void *user);
@@ -110,6 +110,7 @@ RZ_API RzIO* rz_io_init(RzIO* io) {
 	rz_skyline_init (&io->map_skyline);
 	rz_io_map_init (io);
 	rz_io_cache_init (io);
+	rz_io_page_cache_init (io);
 	rz_io_plugin_init (io);
 	rz_io_undo_init (io);
 	io->event = rz_event_new (io);
@@ -245,6 +246,7 @@ RZ_API int rz_io_close_all(RzIO* io) { // what about undo?
 	rz_io_desc_init (io);
 	rz_io_map_init (io);
 	rz_io_cache_fini (io);
+	rz_io_page_cache_reset (io);
 	rz_io_plugin_init (io);
 	return true;
 }
@@ -338,6 +340,101 @@ RZ_API int rz_io_nread_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	return ret;
 }
 
+typedef struct {
+	RzIODesc *desc;
+	ut64 paddr;
+	bool batched;
+} BatchSlot;
+
+// Returns the desc serving the whole range of req if it can be handed to the
+// read_batch of its plugin as is, NULL if it has to go through rz_io_nread_at.
+static RzIODesc *batch_desc(RzIO *io, const RzIOBatchRead *req, ut64 *paddr) {
+	if (req->len < 1 || io->cachemode || io->p_cache) {
+		return NULL;
+	}
+	RzIODesc *desc;
+	if (io->va) {
+		const RzSkylineItem *part = rz_skyline_get_item (&io->map_skyline, req->addr);
+		if (!part || (ut64)(req->len - 1) > rz_itv_end (part->itv) - 1 - req->addr) {
+			return NULL;
+		}
+		RzIOMap *map = part->user;
+		if (!(map->perm & RZ_PERM_R)) {
+			return NULL;
+		}
+		desc = rz_io_desc_get (io, map->fd);
+		*paddr = map->delta + req->addr - map->itv.addr;
+	} else {
+		desc = io->desc;
+		*paddr = req->addr;
+	}
+	if (!desc || !desc->plugin || !desc->plugin->read_batch || !(desc->perm & RZ_PERM_R) || rz_io_page_cache_usable (desc)) {
+		return NULL;
+	}
+	return desc;
+}
+
+// Reads many ranges with as few plugin calls as possible: all the ranges
+// served by the same desc are passed to its read_batch at once, the others
+// are read with rz_io_nread_at. ret of every request is set to the length of
+// its read prefix. Returns the number of complete requests.
+RZ_API int rz_io_read_batch(RzIO *io, RzIOBatchRead *reqs, int count) {
+	rz_return_val_if_fail (io && (reqs || count < 1), -1);
+	int i, j, complete = 0;
+	if (count < 1) {
+		return 0;
+	}
+	BatchSlot *slots = RZ_NEWS0 (BatchSlot, count);
+	RzIOBatchRead *group = RZ_NEWS0 (RzIOBatchRead, count);
+	int *owner = RZ_NEWS0 (int, count);
+	for (i = 0; i < count; i++) {
+		reqs[i].ret = 0;
+		if (io->ff && reqs[i].len > 0) {
+			memset (reqs[i].buf, io->Oxff, reqs[i].len);
+		}
+		if (slots && group && owner) {
+			slots[i].desc = batch_desc (io, &reqs[i], &slots[i].paddr);
+		}
+	}
+	for (i = 0; slots && group && owner && i < count; i++) {
+		RzIODesc *desc = slots[i].desc;
+		if (!desc || slots[i].batched) {
+			continue;
+		}
+		int n = 0;
+		for (j = i; j < count; j++) {
+			if (slots[j].desc == desc && !slots[j].batched) {
+				group[n] = reqs[j];
+				group[n].addr = slots[j].paddr;
+				group[n].ret = 0;
+				owner[n++] = j;
+				slots[j].batched = true;
+			}
+		}
+		desc->plugin->read_batch (io, desc, group, n);
+		for (j = 0; j < n; j++) {
+			RzIOBatchRead *req = &reqs[owner[j]];
+			req->ret = group[j].ret;
+			if (req->ret > 0 && io->cached & RZ_PERM_R) {
+				(void)rz_io_cache_read (io, req->addr, req->buf, req->len);
+			}
+		}
+	}
+	for (i = 0; i < count; i++) {
+		RzIOBatchRead *req = &reqs[i];
+		if (!slots || !slots[i].batched) {
+			req->ret = req->len > 0 ? rz_io_nread_at (io, req->addr, req->buf, req->len) : 0;
+		}
+		if (req->ret == req->len) {
+			complete++;
+		}
+	}
+	free (slots);
+	free (group);
+	free (owner);
+	return complete;
+}
+
 RZ_API bool rz_io_write_at(RzIO* io, ut64 addr, const ut8* buf, int len) {
 	int i;
 	bool ret = false;
@@ -513,6 +610,7 @@ RZ_API void rz_io_bind(RzIO *io, RzIOBind *bnd) {
 	bnd->open_at = rz_io_open_at;
 	bnd->close = rz_io_fd_close;
 	bnd->read_at = rz_io_read_at;
+	bnd->read_batch = rz_io_read_batch;
 	bnd->write_at = rz_io_write_at;
 	bnd->system = rz_io_system;
 	bnd->fd_open = rz_io_fd_open;
@@ -668,6 +766,7 @@ RZ_API int rz_io_fini(RzIO* io) {
 	rz_io_map_fini (io);
 	ls_free (io->plugins);
 	rz_io_cache_fini (io);
+	rz_io_page_cache_fini (io);
 	rz_list_free (io->undo.w_list);
 	if (io->runprofile) {
 		RZ_FREE (io->runprofile);
@@ -1,151 +1,465 @@
 // SPDX-License-Identifier: LGPL-3.0-only
 
-// TODO: implement a more intelligent way to store cached memory
-
 #include "rz_io.h"
-#include <rz_skyline.h>
 
-#if 0
-#define CACHE_CONTAINER(x) container_of ((RBNode*)x, RzCache, rb)
+// The write cache keeps dirty pages of RZ_IO_CACHE_PAGE_SIZE bytes in a
+// red-black tree sorted by address. Each page holds the cached bytes, the
+// original bytes read once when the page is created and a bitmask of the
+// bytes that have been written, so overlapping and adjacent writes coalesce.
+// A second bitmask tells which of them have been committed. Reads, commits
+// and the dirty ranges only look at the pages. Every write is also appended,
+// with the bytes it replaced, to io->cache_writes, which is what wc lists and
+// undoes.
+
+#define PS RZ_IO_CACHE_PAGE_SIZE
+#define PAGE_ADDR(x) ((x) & ~(ut64)(PS - 1))
+#define unwrap(rbnode) container_of (rbnode, RzIOCachePage, rb)
+
+#define MASK_GET(p, i) ((p)->mask[(i) >> 3] & (1 << ((i) & 7)))
+#define MASK_SET(p, i) ((p)->mask[(i) >> 3] |= (1 << ((i) & 7)))
+#define MASK_CLR(p, i) ((p)->mask[(i) >> 3] &= ~(1 << ((i) & 7)))
+#define WMASK_GET(p, i) ((p)->wmask[(i) >> 3] & (1 << ((i) & 7)))
+#define WMASK_SET(p, i) ((p)->wmask[(i) >> 3] |= (1 << ((i) & 7)))
+#define WMASK_CLR(p, i) ((p)->wmask[(i) >> 3] &= ~(1 << ((i) & 7)))
+
+static int page_cmp(const void *incoming, const RBNode *in_tree, void *user) {
+	ut64 addr = *(ut64 *)incoming;
+	const RzIOCachePage *page = container_of (in_tree, const RzIOCachePage, rb);
+	if (addr < page->addr) {
+		return -1;
+	}
+	if (addr > page->addr) {
+		return 1;
+	}
+	return 0;
+}
 
-static void _fcn_tree_calc_max_addr(RBNode *node) {
-	RzIOCache *c = CACHE_CONTAINER (node);
+static void page_free(RBNode *node, void *user) {
+	free (unwrap (node));
 }
-#endif // 0
 
-static void cache_item_free(RzIOCache *cache) {
-	if (!cache) {
-		return;
+static bool page_is_empty(RzIOCachePage *page) {
+	size_t i;
+	for (i = 0; i < sizeof (page->mask); i++) {
+		if (page->mask[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static RzIOCachePage *page_find(RzIO *io, ut64 page_addr) {
+	if (io->cache_last && io->cache_last->addr == page_addr) {
+		return io->cache_last;
+	}
+	RBNode *node = rz_rbtree_find (io->cache, &page_addr, page_cmp, NULL);
+	if (!node) {
+		return NULL;
+	}
+	io->cache_last = unwrap (node);
+	return io->cache_last;
+}
+
+static RzIOCachePage *page_get(RzIO *io, ut64 page_addr) {
+	RzIOCachePage *page = page_find (io, page_addr);
+	if (page) {
+		return page;
+	}
+	page = RZ_NEW0 (RzIOCachePage);
+	if (!page) {
+		return NULL;
+	}
+	page->addr = page_addr;
+	// the original bytes are read only once, when the page becomes dirty
+	bool cm = io->cachemode;
+	int cached = io->cached;
+	io->cachemode = false;
+	io->cached = 0;
+	rz_io_read_at (io, page_addr, page->odata, PS);
+	io->cached = cached;
+	io->cachemode = cm;
+	memcpy (page->data, page->odata, PS);
+	rz_rbtree_insert (&io->cache, &page->addr, &page->rb, page_cmp, NULL);
+	io->cache_last = page;
+	return page;
+}
+
+static void page_delete(RzIO *io, RzIOCachePage *page) {
+	ut64 addr = page->addr;
+	if (io->cache_last == page) {
+		io->cache_last = NULL;
 	}
-	free (cache->data);
-	free (cache->odata);
-	free (cache);
+	rz_rbtree_delete (&io->cache, &addr, page_cmp, NULL, page_free, NULL);
+}
+
+static void cache_tree_free(RzIO *io) {
+	rz_rbtree_free (io->cache, page_free, NULL);
+	io->cache = NULL;
+	io->cache_last = NULL;
+}
+
+#define BIT_GET(m, i) ((m)[(i) >> 3] & (1 << ((i) & 7)))
+
+// writes the bytes of page in [lo, hi] that are set in mask, taken from src,
+// to the underlying io. With commit they are then marked as committed.
+static bool page_write_runs(RzIO *io, RzIOCachePage *page, const ut8 *mask, const ut8 *src, ut32 lo, ut32 hi, bool commit) {
+	bool ret = true;
+	ut32 i = lo;
+	while (i <= hi) {
+		if (!BIT_GET (mask, i)) {
+			i++;
+			continue;
+		}
+		ut32 start = i;
+		while (i <= hi && BIT_GET (mask, i)) {
+			i++;
+		}
+		if (!rz_io_write_at (io, page->addr + start, src + start, i - start)) {
+			eprintf ("Error writing change at 0x%08" PFMT64x "\n", page->addr + start);
+			ret = false;
+			continue;
+		}
+		if (commit) {
+			ut32 j;
+			for (j = start; j < i; j++) {
+				WMASK_SET (page, j);
+			}
+		}
+	}
+	return ret;
 }
 
 RZ_API bool rz_io_cache_at(RzIO *io, ut64 addr) {
 	rz_return_val_if_fail (io, false);
-	return rz_skyline_contains (&io->cache_skyline, addr);
+	RzIOCachePage *page = page_find (io, PAGE_ADDR (addr));
+	return page && MASK_GET (page, addr - page->addr);
 }
 
 RZ_API void rz_io_cache_init(RzIO *io) {
-	rz_pvector_init (&io->cache, (RzPVectorFree)cache_item_free);
-	rz_skyline_init (&io->cache_skyline);
+	io->cache = NULL;
+	io->cache_last = NULL;
+	rz_vector_init (&io->cache_writes, sizeof (RzIOCacheWrite), NULL, NULL);
+	rz_vector_init (&io->cache_bytes, 1, NULL, NULL);
+	io->cache_stack = NULL;
 	io->buffer = rz_cache_new ();
 	io->cached = 0;
 }
 
+// what rz_io_cache_push saves
+typedef struct {
+	RBTree cache;
+	RzVector writes;
+	RzVector bytes;
+} CacheState;
+
+static void cache_state_free(void *e) {
+	CacheState *st = e;
+	rz_rbtree_free (st->cache, page_free, NULL);
+	rz_vector_fini (&st->writes);
+	rz_vector_fini (&st->bytes);
+	free (st);
+}
+
+static void cache_clear(RzIO *io) {
+	cache_tree_free (io);
+	rz_vector_clear (&io->cache_writes);
+	rz_vector_clear (&io->cache_bytes);
+}
+
 RZ_API void rz_io_cache_fini(RzIO *io) {
-	rz_pvector_fini (&io->cache);
-	rz_skyline_fini (&io->cache_skyline);
+	cache_clear (io);
+	rz_list_free (io->cache_stack);
+	io->cache_stack = NULL;
 	rz_cache_free (io->buffer);
 	io->buffer = NULL;
 	io->cached = 0;
 }
 
+static inline ut8 *write_data(RzIO *io, RzIOCacheWrite *w) {
+	return (ut8 *)rz_vector_index_ptr (&io->cache_bytes, w->off);
+}
+
+static inline ut8 *write_odata(RzIO *io, RzIOCacheWrite *w) {
+	return (ut8 *)rz_vector_index_ptr (&io->cache_bytes, w->off + rz_itv_size (w->itv));
+}
+
+// the range of the write cache commands, to before from means up to the end
+static inline RzInterval cache_range(ut64 from, ut64 to) {
+	return (RzInterval){ from, to - from };
+}
+
+// commits the dirty bytes in [from, to) of every page and marks the writes
+// overlapping it as written
 RZ_API void rz_io_cache_commit(RzIO *io, ut64 from, ut64 to) {
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){from, to - from};
-	rz_pvector_foreach (&io->cache, iter) {
-		// if (from <= c->to - 1 && c->from <= to - 1) {
-		c = *iter;
-		if (rz_itv_overlap (c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			if (rz_io_write_at (io, rz_itv_begin (c->itv), c->data, rz_itv_size (c->itv))) {
-				c->written = true;
-			} else {
-				eprintf ("Error writing change at 0x%08"PFMT64x"\n", rz_itv_begin (c->itv));
-			}
-			io->cached = cached;
-			// break; // XXX old behavior, revisit this
+	rz_return_if_fail (io);
+	if (from == to) {
+		return;
+	}
+	ut64 last = to > from ? to - 1 : UT64_MAX;
+	ut64 start = PAGE_ADDR (from);
+	RzIOCachePage *page;
+	RBIter it = rz_rbtree_lower_bound_forward (io->cache, &start, page_cmp, NULL);
+	int cached = io->cached;
+	io->cached = 0;
+	rz_rbtree_iter_while (it, page, RzIOCachePage, rb) {
+		if (page->addr > last) {
+			break;
+		}
+		ut32 lo = from > page->addr ? from - page->addr : 0;
+		ut32 hi = last - page->addr < PS ? last - page->addr : PS - 1;
+		page_write_runs (io, page, page->mask, page->data, lo, hi, true);
+	}
+	io->cached = cached;
+	RzIOCacheWrite *w;
+	rz_vector_foreach (&io->cache_writes, w) {
+		if (rz_itv_overlap (w->itv, cache_range (from, to))) {
+			w->written = true;
 		}
 	}
 }
 
 RZ_API void rz_io_cache_reset(RzIO *io, int set) {
 	io->cached = set;
-	rz_pvector_clear (&io->cache);
-	rz_skyline_clear (&io->cache_skyline);
+	cache_clear (io);
+}
+
+// drops the cached bytes in [from, last] from the pages, writing back the
+// original ones where they were committed
+static void pages_drop(RzIO *io, ut64 from, ut64 last) {
+	ut64 start = PAGE_ADDR (from);
+	for (;;) {
+		RBNode *node = rz_rbtree_lower_bound (io->cache, &start, page_cmp, NULL);
+		if (!node) {
+			break;
+		}
+		RzIOCachePage *page = unwrap (node);
+		if (page->addr > last) {
+			break;
+		}
+		ut32 lo = from > page->addr ? from - page->addr : 0;
+		ut32 hi = last - page->addr < PS ? last - page->addr : PS - 1;
+		ut32 i;
+		page_write_runs (io, page, page->wmask, page->odata, lo, hi, false);
+		for (i = lo; i <= hi; i++) {
+			MASK_CLR (page, i);
+			WMASK_CLR (page, i);
+			page->data[i] = page->odata[i];
+		}
+		bool done = page->addr + PS - 1 >= last;
+		start = page->addr + PS;
+		if (page_is_empty (page)) {
+			page_delete (io, page);
+		}
+		if (done) {
+			break;
+		}
+	}
+}
+
+// puts the bytes of w in [from, last] in the pages again, and in the
+// underlying io if it was committed
+static void write_replay(RzIO *io, RzIOCacheWrite *w, ut64 from, ut64 last) {
+	ut64 lo = RZ_MAX (from, rz_itv_begin (w->itv));
+	ut64 hi = RZ_MIN (last, rz_itv_end (w->itv) - 1);
+	const ut8 *data = write_data (io, w);
+	ut64 addr;
+	for (addr = lo; addr >= lo && addr <= hi;) {
+		RzIOCachePage *page = page_get (io, PAGE_ADDR (addr));
+		if (!page) {
+			return;
+		}
+		ut32 off = addr - page->addr;
+		ut32 n = (ut32)RZ_MIN ((ut64)(PS - off), hi - addr + 1);
+		const ut8 *src = data + (addr - rz_itv_begin (w->itv));
+		memcpy (page->data + off, src, n);
+		ut32 i;
+		for (i = off; i < off + n; i++) {
+			MASK_SET (page, i);
+		}
+		if (w->written && rz_io_write_at (io, addr, src, n)) {
+			for (i = off; i < off + n; i++) {
+				WMASK_SET (page, i);
+			}
+		}
+		addr += n;
+	}
 }
 
+// undoes every write overlapping [from, to), restoring the original bytes if
+// they were already committed. Returns the number of writes undone.
 RZ_API int rz_io_cache_invalidate(RzIO *io, ut64 from, ut64 to) {
-	int invalidated = 0;
-	void **iter;
-	RzIOCache *c;
-	RzInterval range = (RzInterval){from, to - from};
-	rz_pvector_foreach_prev (&io->cache, iter) {
-		c = *iter;
-		if (rz_itv_overlap (c->itv, range)) {
-			int cached = io->cached;
-			io->cached = 0;
-			rz_io_write_at (io, rz_itv_begin (c->itv), c->odata, rz_itv_size (c->itv));
-			io->cached = cached;
-			c->written = false;
-			rz_pvector_remove_data (&io->cache, c);
-			invalidated++;
-		}
-	}
-	rz_skyline_clear (&io->cache_skyline);
-	rz_pvector_foreach (&io->cache, iter) {
-		c = *iter;
-		rz_skyline_add (&io->cache_skyline, c->itv, c);
+	rz_return_val_if_fail (io, 0);
+	RzVector *writes = &io->cache_writes;
+	RzVector dropped; // RzInterval
+	rz_vector_init (&dropped, sizeof (RzInterval), NULL, NULL);
+	int cached = io->cached;
+	io->cached = 0;
+	size_t i = 0;
+	while (i < rz_vector_len (writes)) {
+		RzIOCacheWrite *w = rz_vector_index_ptr (writes, i);
+		if (!rz_itv_overlap (w->itv, cache_range (from, to))) {
+			i++;
+			continue;
+		}
+		RzInterval itv = w->itv;
+		size_t off = w->off;
+		size_t nbytes = 2 * rz_itv_size (itv);
+		rz_vector_push (&dropped, &itv);
+		pages_drop (io, rz_itv_begin (itv), rz_itv_end (itv) - 1);
+		rz_vector_remove_at (writes, i, NULL);
+		// keep cache_bytes packed, the later writes move back
+		ut8 *b = rz_vector_index_ptr (&io->cache_bytes, off);
+		memmove (b, b + nbytes, rz_vector_len (&io->cache_bytes) - off - nbytes);
+		io->cache_bytes.len -= nbytes;
+		size_t j;
+		for (j = i; j < rz_vector_len (writes); j++) {
+			((RzIOCacheWrite *)rz_vector_index_ptr (writes, j))->off -= nbytes;
+		}
+	}
+	// the other writes show through where the dropped ones were, in order
+	RzIOCacheWrite *w;
+	rz_vector_foreach (writes, w) {
+		RzInterval *d;
+		rz_vector_foreach (&dropped, d) {
+			if (rz_itv_overlap (w->itv, *d)) {
+				write_replay (io, w, rz_itv_begin (*d), rz_itv_end (*d) - 1);
+			}
+		}
 	}
+	io->cached = cached;
+	int invalidated = (int)rz_vector_len (&dropped);
+	rz_vector_fini (&dropped);
 	return invalidated;
 }
 
-RZ_API int rz_io_cache_list(RzIO *io, int rad) {
-	size_t i, j = 0;
-	void **iter;
-	RzIOCache *c;
-	PJ *pj;
-	if (rad == 2) {
-		pj = pj_new ();
-		pj_a (pj);
-	}
-	rz_pvector_foreach (&io->cache, iter) {
-		c = *iter;
-		const ut64 dataSize = rz_itv_size (c->itv);
-		if (rad == 1) {
-			io->cb_printf ("wx ");
-			for (i = 0; i < dataSize; i++) {
-				io->cb_printf ("%02x", (ut8)(c->data[i] & 0xff));
+// calls cb for every maximal range of contiguous cached bytes in address
+// order, ranges never mix committed and uncommitted bytes
+RZ_API bool rz_io_cache_foreach(RzIO *io, RzIOCacheForeachCallback cb, void *user) {
+	rz_return_val_if_fail (io && cb, false);
+	RzIOCache range = { 0 };
+	ut64 cap = 0;
+	bool ret = true;
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache, it, page, RzIOCachePage, rb) {
+		ut32 i;
+		for (i = 0; i < PS; i++) {
+			if (!MASK_GET (page, i)) {
+				continue;
 			}
-			io->cb_printf (" @ 0x%08"PFMT64x, rz_itv_begin (c->itv));
-			io->cb_printf (" # replaces: ");
-		  	for (i = 0; i < dataSize; i++) {
-				io->cb_printf ("%02x", (ut8)(c->odata[i] & 0xff));
+			ut64 addr = page->addr + i;
+			ut64 size = rz_itv_size (range.itv);
+			bool written = WMASK_GET (page, i);
+			if (size && (rz_itv_end (range.itv) != addr || range.written != written)) {
+				if (!cb (user, &range)) {
+					ret = false;
+					goto beach;
+				}
+				size = 0;
 			}
-			io->cb_printf ("\n");
-		} else if (rad == 2) {
-			pj_o (pj);
-			pj_kn (pj, "idx", j);
-			pj_kn (pj, "addr", rz_itv_begin (c->itv));
-			pj_kn (pj, "size", dataSize);
-			char *hex = rz_hex_bin2strdup (c->odata, dataSize);
-			pj_ks (pj, "before", hex);
-			free (hex);
-			hex = rz_hex_bin2strdup (c->data, dataSize);
-			pj_ks (pj, "after", hex);
-			free (hex);
-			pj_kb (pj, "written", c->written);
-			pj_end (pj);
-		} else if (rad == 0) {
-			io->cb_printf ("idx=%"PFMTSZu" addr=0x%08"PFMT64x" size=%"PFMT64u" ", j, rz_itv_begin (c->itv), dataSize);
-			for (i = 0; i < dataSize; i++) {
-				io->cb_printf ("%02x", c->odata[i]);
+			if (!size) {
+				range.itv.addr = addr;
+				range.written = written;
 			}
-			io->cb_printf (" -> ");
-			for (i = 0; i < dataSize; i++) {
-				io->cb_printf ("%02x", c->data[i]);
+			if (size >= cap) {
+				ut64 ncap = cap ? cap * 2 : PS;
+				ut8 *data = realloc (range.data, ncap);
+				if (!data) {
+					ret = false;
+					goto beach;
+				}
+				range.data = data;
+				ut8 *odata = realloc (range.odata, ncap);
+				if (!odata) {
+					ret = false;
+					goto beach;
+				}
+				range.odata = odata;
+				cap = ncap;
 			}
-			io->cb_printf (" %s\n", c->written? "(written)": "(not written)");
+			range.data[size] = page->data[i];
+			range.odata[size] = page->odata[i];
+			range.itv.size = size + 1;
 		}
-		j++;
 	}
-	if (rad == 2) {
+	if (rz_itv_size (range.itv)) {
+		ret = cb (user, &range);
+	}
+beach:
+	free (range.data);
+	free (range.odata);
+	return ret;
+}
+
+typedef struct {
+	RzIO *io;
+	int rad;
+	size_t idx;
+	PJ *pj;
+} CacheListCtx;
+
+static bool cache_list_cb(void *user, const RzIOCache *c) {
+	CacheListCtx *ctx = user;
+	RzIO *io = ctx->io;
+	const ut64 dataSize = rz_itv_size (c->itv);
+	size_t i;
+	if (ctx->rad == 1) {
+		io->cb_printf ("wx ");
+		for (i = 0; i < dataSize; i++) {
+			io->cb_printf ("%02x", (ut8)(c->data[i] & 0xff));
+		}
+		io->cb_printf (" @ 0x%08"PFMT64x, rz_itv_begin (c->itv));
+		io->cb_printf (" # replaces: ");
+		for (i = 0; i < dataSize; i++) {
+			io->cb_printf ("%02x", (ut8)(c->odata[i] & 0xff));
+		}
+		io->cb_printf ("\n");
+	} else if (ctx->rad == 2) {
+		PJ *pj = ctx->pj;
+		pj_o (pj);
+		pj_kn (pj, "idx", ctx->idx);
+		pj_kn (pj, "addr", rz_itv_begin (c->itv));
+		pj_kn (pj, "size", dataSize);
+		char *hex = rz_hex_bin2strdup (c->odata, dataSize);
+		pj_ks (pj, "before", hex);
+		free (hex);
+		hex = rz_hex_bin2strdup (c->data, dataSize);
+		pj_ks (pj, "after", hex);
+		free (hex);
+		pj_kb (pj, "written", c->written);
 		pj_end (pj);
-		char *json = pj_drain (pj);
+	} else if (ctx->rad == 0) {
+		io->cb_printf ("idx=%"PFMTSZu" addr=0x%08"PFMT64x" size=%"PFMT64u" ", ctx->idx, rz_itv_begin (c->itv), dataSize);
+		for (i = 0; i < dataSize; i++) {
+			io->cb_printf ("%02x", c->odata[i]);
+		}
+		io->cb_printf (" -> ");
+		for (i = 0; i < dataSize; i++) {
+			io->cb_printf ("%02x", c->data[i]);
+		}
+		io->cb_printf (" %s\n", c->written? "(written)": "(not written)");
+	}
+	ctx->idx++;
+	return true;
+}
+
+RZ_API int rz_io_cache_list(RzIO *io, int rad) {
+	CacheListCtx ctx = { io, rad, 0, NULL };
+	if (rad == 2) {
+		ctx.pj = pj_new ();
+		if (!ctx.pj) {
+			return false;
+		}
+		pj_a (ctx.pj);
+	}
+	RzIOCacheWrite *w;
+	rz_vector_foreach (&io->cache_writes, w) {
+		RzIOCache c = { w->itv, write_data (io, w), write_odata (io, w), w->written };
+		cache_list_cb (&ctx, &c);
+	}
+	if (rad == 2) {
+		pj_end (ctx.pj);
+		char *json = pj_drain (ctx.pj);
 		io->cb_printf ("%s", json);
 		free (json);
 	}
@@ -153,66 +467,144 @@ RZ_API int rz_io_cache_list(RzIO *io, int rad) {
 }
 
 RZ_API bool rz_io_cache_write(RzIO *io, ut64 addr, const ut8 *buf, int len) {
-	RzIOCache *ch;
-	ch = RZ_NEW0 (RzIOCache);
-	if (!ch) {
-		return false;
+	rz_return_val_if_fail (io && buf && len >= 0, false);
+	if (!len) {
+		return true;
 	}
-	ch->itv = (RzInterval){addr, len};
-	ch->odata = (ut8*)calloc (1, len + 1);
-	if (!ch->odata) {
-		free (ch);
+	// the write is kept for listing and undoing it: its bytes, followed by
+	// the ones it replaces, which are filled in below
+	size_t boff = rz_vector_len (&io->cache_bytes);
+	ut8 *bytes = rz_vector_insert_range (&io->cache_bytes, boff, NULL, 2 * (size_t)len);
+	if (!bytes) {
 		return false;
 	}
-	ch->data = (ut8*)calloc (1, len + 1);
-	if (!ch->data) {
-		free (ch->odata);
-		free (ch);
+	memcpy (bytes, buf, len);
+	RzIOCacheWrite w = { { addr, len }, boff, false };
+	if (!rz_vector_push (&io->cache_writes, &w)) {
+		io->cache_bytes.len = boff;
 		return false;
 	}
-	ch->written = false;
-	{
-		bool cm = io->cachemode;
-		io->cachemode = false;
-		rz_io_read_at (io, addr, ch->odata, len);
-		io->cachemode = cm;
-	}
-	memcpy (ch->data, buf, len);
-	rz_pvector_push (&io->cache, ch);
-	rz_skyline_add (&io->cache_skyline, ch->itv, ch);
-	RzEventIOWrite iow = { addr, buf, len };
+	int done = 0;
+	while (done < len) {
+		ut64 cur = addr + done;
+		RzIOCachePage *page = page_get (io, PAGE_ADDR (cur));
+		if (!page) {
+			return false;
+		}
+		ut32 off = cur - page->addr;
+		ut32 n = RZ_MIN (PS - off, (ut32)(len - done));
+		memcpy (bytes + len + done, page->data + off, n);
+		memcpy (page->data + off, buf + done, n);
+		ut32 i;
+		for (i = off; i < off + n; i++) {
+			MASK_SET (page, i);
+			WMASK_CLR (page, i);
+		}
+		done += n;
+	}
+	RzEventIOWrite iow = { addr, buf, len, -1 };
 	rz_event_send (io->event, RZ_EVENT_IO_WRITE, &iow);
 	return true;
 }
 
 RZ_API bool rz_io_cache_read(RzIO *io, ut64 addr, ut8 *buf, int len) {
 	rz_return_val_if_fail (io, false);
-	RzSkyline *skyline = &io->cache_skyline;
-	const RzSkylineItem *iter = rz_skyline_get_item_intersect (skyline, addr, len);
-	if (!iter) {
+	if (!io->cache || len < 1) {
 		return false;
 	}
-	const RzSkylineItem *last = (RzSkylineItem *)skyline->v.a + skyline->v.len;
 	bool covered = false;
-	while (iter != last) {
-		const ut64 begin = rz_itv_begin (iter->itv);
-		const st64 addr_offset = begin - addr;
-		const ut64 buf_offset = addr_offset > 0 ? addr_offset : 0;
-		const ut64 cur_addr = addr + buf_offset;
-		const ut64 left = len - buf_offset;
-		if (begin > cur_addr + left) {
+	ut64 start = PAGE_ADDR (addr);
+	ut64 last = addr + len - 1;
+	if (last < addr) {
+		// wraps around the address space
+		int head = (int)(UT64_MAX - addr + 1);
+		bool a = rz_io_cache_read (io, addr, buf, head);
+		bool b = rz_io_cache_read (io, 0, buf + head, len - head);
+		return a || b;
+	}
+	RzIOCachePage *page;
+	RBIter it = rz_rbtree_lower_bound_forward (io->cache, &start, page_cmp, NULL);
+	rz_rbtree_iter_while (it, page, RzIOCachePage, rb) {
+		if (page->addr > last) {
 			break;
 		}
-		RzIOCache *cache = iter->user;
-		const ut64 cache_shift = addr_offset < 0 ? -addr_offset : 0;
-		const ut64 cache_offset = begin - rz_itv_begin (cache->itv) + cache_shift;
-		const ut64 read = RZ_MIN (left, rz_itv_size (iter->itv) - cache_shift);
-		memcpy (buf + buf_offset, cache->data + cache_offset, read);
-		covered = true;
-		if (left - read <= 0) {
-			break;
+		ut32 lo = addr > page->addr ? addr - page->addr : 0;
+		ut32 hi = last - page->addr < PS ? last - page->addr : PS - 1;
+		ut8 *dst = buf + (page->addr + lo - addr);
+		ut32 i = lo;
+		while (i <= hi) {
+			ut8 m = page->mask[i >> 3];
+			if (!(i & 7) && i + 7 <= hi && (m == 0 || m == 0xff)) {
+				// whole mask byte is either clean or dirty
+				if (m) {
+					memcpy (dst, page->data + i, 8);
+					covered = true;
+				}
+				dst += 8;
+				i += 8;
+				continue;
+			}
+			if (m & (1 << (i & 7))) {
+				*dst = page->data[i];
+				covered = true;
+			}
+			dst++;
+			i++;
 		}
-		iter++;
 	}
 	return covered;
 }
+
+static bool vector_copy(RzVector *dst, RzVector *src) {
+	return rz_vector_empty (src) || rz_vector_insert_range (dst, 0, src->a, rz_vector_len (src));
+}
+
+// saves a copy of the current write cache, to be restored by rz_io_cache_pop
+RZ_API bool rz_io_cache_push(RzIO *io) {
+	rz_return_val_if_fail (io, false);
+	if (!io->cache_stack) {
+		io->cache_stack = rz_list_newf (cache_state_free);
+		if (!io->cache_stack) {
+			return false;
+		}
+	}
+	CacheState *st = RZ_NEW0 (CacheState);
+	if (!st) {
+		return false;
+	}
+	rz_vector_init (&st->writes, sizeof (RzIOCacheWrite), NULL, NULL);
+	rz_vector_init (&st->bytes, 1, NULL, NULL);
+	RBIter it;
+	RzIOCachePage *page;
+	rz_rbtree_foreach (io->cache, it, page, RzIOCachePage, rb) {
+		RzIOCachePage *p = rz_mem_dup (page, sizeof (RzIOCachePage));
+		if (!p) {
+			goto fail;
+		}
+		memset (&p->rb, 0, sizeof (p->rb));
+		rz_rbtree_insert (&st->cache, &p->addr, &p->rb, page_cmp, NULL);
+	}
+	if (!vector_copy (&st->writes, &io->cache_writes) || !vector_copy (&st->bytes, &io->cache_bytes)
+		|| !rz_list_push (io->cache_stack, st)) {
+		goto fail;
+	}
+	return true;
+fail:
+	cache_state_free (st);
+	return false;
+}
+
+// discards the current write cache and restores the last pushed one
+RZ_API bool rz_io_cache_pop(RzIO *io) {
+	rz_return_val_if_fail (io, false);
+	if (rz_list_empty (io->cache_stack)) {
+		return false;
+	}
+	cache_clear (io);
+	CacheState *st = rz_list_pop (io->cache_stack);
+	io->cache = st->cache;
+	io->cache_writes = st->writes;
+	io->cache_bytes = st->bytes;
+	free (st);
+	return true;
+}
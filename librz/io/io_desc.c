@@ -35,6 +35,10 @@ RZ_API void rz_io_desc_free(RzIODesc* desc) {
 		free (desc->referer);
 		free (desc->name);
 		rz_io_desc_cache_fini (desc);
+		if (desc->io) {
+			// fds get recycled, stale pages must not survive the desc
+			rz_io_page_cache_invalidate_fd (desc->io, desc->fd);
+		}
 		if (desc->io && desc->io->files) {
 			rz_id_storage_delete (desc->io->files, desc->fd);
 		}
@@ -232,6 +236,9 @@ RZ_API ut64 rz_io_desc_size(RzIODesc* desc) {
 RZ_API bool rz_io_desc_resize(RzIODesc *desc, ut64 newsize) {
 	if (desc && desc->plugin && desc->plugin->resize) {
 		bool ret = desc->plugin->resize (desc->io, desc, newsize);
+		if (desc->io) {
+			rz_io_page_cache_invalidate_fd (desc->io, desc->fd);
+		}
 		if (desc->io && desc->io->p_cache) {
 			rz_io_desc_cache_cleanup (desc);
 		}
@@ -263,6 +270,8 @@ RZ_API bool rz_io_desc_exchange(RzIO* io, int fd, int fdx) {
 	descx->fd = fd;
 	rz_id_storage_set (io->files, desc,  fdx);
 	rz_id_storage_set (io->files, descx, fd);
+	rz_io_page_cache_invalidate_fd (io, fd);
+	rz_io_page_cache_invalidate_fd (io, fdx);
 	if (io->p_cache) {
 		HtUP* cache = desc->cache;
 		desc->cache = descx->cache;
@@ -331,6 +340,9 @@ RZ_API bool rz_io_desc_get_base (RzIODesc *desc, ut64 *base) {
 }
 
 RZ_API int rz_io_desc_read_at(RzIODesc *desc, ut64 addr, ut8 *buf, int len) {
+	if (desc && buf && len > 0 && rz_io_page_cache_usable (desc)) {
+		return rz_io_page_cache_read (desc, addr, buf, len);
+	}
 	if (desc && buf && (rz_io_desc_seek (desc, addr, RZ_IO_SEEK_SET) == addr)) {
 		return rz_io_desc_read (desc, buf, len);
 	}
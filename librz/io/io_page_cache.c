@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_io.h>
+
+// Page-granular read cache sitting between rz_io_desc_read_at and the plugins.
+// Pages are keyed by (fd, paddr / RZ_IO_PAGE_CACHE_PAGE_SIZE) in an open
+// addressing table with linear probing and evicted with the CLOCK algorithm.
+// RzIO is single threaded, so no locking is involved at all.
+
+#define PS RZ_IO_PAGE_CACHE_PAGE_SIZE
+#define SLOT_EMPTY 0
+
+static inline ut32 page_hash(int fd, ut64 page) {
+	ut64 h = (page ^ ((ut64)(ut32)fd << 48)) * 0x9e3779b97f4a7c15ULL;
+	return (ut32)(h >> 32);
+}
+
+static inline ut8 *frame_data(RzIOPageCache *pc, ut32 idx) {
+	return pc->data + (ut64)idx * PS;
+}
+
+// returns the table slot holding (fd, page) or UT32_MAX
+static ut32 slot_find(RzIOPageCache *pc, int fd, ut64 page) {
+	ut32 i = page_hash (fd, page) & pc->table_mask;
+	while (pc->table[i] != SLOT_EMPTY) {
+		RzIOPageCacheFrame *f = &pc->frames[pc->table[i] - 1];
+		if (f->page == page && f->fd == fd) {
+			return i;
+		}
+		i = (i + 1) & pc->table_mask;
+	}
+	return UT32_MAX;
+}
+
+static void slot_insert(RzIOPageCache *pc, ut32 frame) {
+	RzIOPageCacheFrame *f = &pc->frames[frame];
+	ut32 i = page_hash (f->fd, f->page) & pc->table_mask;
+	while (pc->table[i] != SLOT_EMPTY) {
+		i = (i + 1) & pc->table_mask;
+	}
+	pc->table[i] = frame + 1;
+}
+
+// backward shift deletion, keeps probe sequences intact without tombstones
+static void slot_remove(RzIOPageCache *pc, ut32 slot) {
+	ut32 i = slot;
+	ut32 j = slot;
+	pc->table[i] = SLOT_EMPTY;
+	for (;;) {
+		j = (j + 1) & pc->table_mask;
+		if (pc->table[j] == SLOT_EMPTY) {
+			break;
+		}
+		RzIOPageCacheFrame *f = &pc->frames[pc->table[j] - 1];
+		ut32 k = page_hash (f->fd, f->page) & pc->table_mask;
+		bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+		if (stays) {
+			continue;
+		}
+		pc->table[i] = pc->table[j];
+		pc->table[j] = SLOT_EMPTY;
+		i = j;
+	}
+}
+
+static void frame_drop(RzIOPageCache *pc, ut32 frame) {
+	RzIOPageCacheFrame *f = &pc->frames[frame];
+	if (!f->used) {
+		return;
+	}
+	ut32 slot = slot_find (pc, f->fd, f->page);
+	if (slot != UT32_MAX) {
+		slot_remove (pc, slot);
+	}
+	f->used = false;
+	f->ref = false;
+	pc->used--;
+}
+
+static ut32 clock_victim(RzIOPageCache *pc) {
+	for (;;) {
+		ut32 cur = pc->hand;
+		RzIOPageCacheFrame *f = &pc->frames[cur];
+		pc->hand = (cur + 1) % pc->frames_count;
+		if (!f->used) {
+			return cur;
+		}
+		if (f->ref) {
+			f->ref = false;
+			continue;
+		}
+		frame_drop (pc, cur);
+		return cur;
+	}
+}
+
+static RzIOPageCacheFrame *page_get(RzIODesc *desc, ut64 page, ut8 **data) {
+	RzIOPageCache *pc = &desc->io->page_cache;
+	ut32 slot = slot_find (pc, desc->fd, page);
+	if (slot != UT32_MAX) {
+		ut32 idx = pc->table[slot] - 1;
+		RzIOPageCacheFrame *f = &pc->frames[idx];
+		f->ref = true;
+		pc->hits++;
+		*data = frame_data (pc, idx);
+		return f;
+	}
+	pc->misses++;
+	ut32 idx = clock_victim (pc);
+	ut8 *d = frame_data (pc, idx);
+	int ret = rz_io_plugin_read_at (desc, page * PS, d, PS);
+	if (ret < 1) {
+		return NULL;
+	}
+	RzIOPageCacheFrame *f = &pc->frames[idx];
+	f->fd = desc->fd;
+	f->page = page;
+	f->size = (ut32)ret;
+	f->ref = true;
+	f->used = true;
+	pc->used++;
+	slot_insert (pc, idx);
+	*data = d;
+	return f;
+}
+
+RZ_API void rz_io_page_cache_init(RzIO *io) {
+	rz_return_if_fail (io);
+	memset (&io->page_cache, 0, sizeof (io->page_cache));
+}
+
+RZ_API void rz_io_page_cache_fini(RzIO *io) {
+	rz_return_if_fail (io);
+	RzIOPageCache *pc = &io->page_cache;
+	free (pc->data);
+	free (pc->frames);
+	free (pc->table);
+	memset (pc, 0, sizeof (*pc));
+}
+
+// (re)allocates the cache to hold at most size bytes, 0 disables it
+RZ_API bool rz_io_page_cache_resize(RzIO *io, ut64 size) {
+	rz_return_val_if_fail (io, false);
+	rz_io_page_cache_fini (io);
+	ut64 count = size / PS;
+	if (!count) {
+		return true;
+	}
+	if (count > UT32_MAX / 4) {
+		count = UT32_MAX / 4;
+	}
+	ut32 table_size = 1;
+	while (table_size < count * 2) {
+		table_size <<= 1;
+	}
+	RzIOPageCache *pc = &io->page_cache;
+	pc->data = malloc (count * PS);
+	pc->frames = RZ_NEWS0 (RzIOPageCacheFrame, count);
+	pc->table = RZ_NEWS0 (ut32, table_size);
+	if (!pc->data || !pc->frames || !pc->table) {
+		rz_io_page_cache_fini (io);
+		return false;
+	}
+	pc->frames_count = (ut32)count;
+	pc->table_mask = table_size - 1;
+	return true;
+}
+
+RZ_API ut64 rz_io_page_cache_size(RzIO *io) {
+	rz_return_val_if_fail (io, 0);
+	return (ut64)io->page_cache.frames_count * PS;
+}
+
+// drops all cached pages but keeps the allocated budget and counters
+RZ_API void rz_io_page_cache_reset(RzIO *io) {
+	rz_return_if_fail (io);
+	RzIOPageCache *pc = &io->page_cache;
+	if (!pc->frames_count) {
+		return;
+	}
+	memset (pc->frames, 0, sizeof (RzIOPageCacheFrame) * pc->frames_count);
+	memset (pc->table, 0, sizeof (ut32) * (pc->table_mask + 1));
+	pc->used = 0;
+	pc->hand = 0;
+}
+
+RZ_API void rz_io_page_cache_invalidate(RzIO *io, int fd, ut64 paddr, ut64 len) {
+	rz_return_if_fail (io);
+	RzIOPageCache *pc = &io->page_cache;
+	if (!pc->used || !len) {
+		return;
+	}
+	ut64 from = paddr / PS;
+	ut64 to = (paddr + len - 1 < paddr) ? UT64_MAX / PS : (paddr + len - 1) / PS;
+	ut32 i;
+	if (to - from < pc->used) {
+		ut64 page;
+		for (page = from;; page++) {
+			ut32 slot = slot_find (pc, fd, page);
+			if (slot != UT32_MAX) {
+				frame_drop (pc, pc->table[slot] - 1);
+			}
+			if (page == to) {
+				break;
+			}
+		}
+		return;
+	}
+	for (i = 0; i < pc->frames_count; i++) {
+		RzIOPageCacheFrame *f = &pc->frames[i];
+		if (f->used && f->fd == fd && f->page >= from && f->page <= to) {
+			frame_drop (pc, i);
+		}
+	}
+}
+
+RZ_API void rz_io_page_cache_invalidate_fd(RzIO *io, int fd) {
+	rz_return_if_fail (io);
+	RzIOPageCache *pc = &io->page_cache;
+	ut32 i;
+	for (i = 0; pc->used && i < pc->frames_count; i++) {
+		if (pc->frames[i].used && pc->frames[i].fd == fd) {
+			frame_drop (pc, i);
+		}
+	}
+}
+
+// debugger and character devices change behind our back, never cache them
+RZ_API bool rz_io_page_cache_usable(RzIODesc *desc) {
+	rz_return_val_if_fail (desc, false);
+	RzIO *io = desc->io;
+	return io && io->page_cache.frames_count && !io->cachemode && (desc->perm & RZ_PERM_R) && !rz_io_desc_is_dbg (desc) && !rz_io_desc_is_chardevice (desc);
+}
+
+// same semantics as rz_io_desc_read_at, but served from the page cache
+RZ_API int rz_io_page_cache_read(RzIODesc *desc, ut64 paddr, ut8 *buf, int len) {
+	rz_return_val_if_fail (desc && desc->io && buf, -1);
+	int done = 0;
+	while (done < len) {
+		ut64 addr = paddr + done;
+		ut32 off = addr % PS;
+		ut8 *data = NULL;
+		RzIOPageCacheFrame *f = page_get (desc, addr / PS, &data);
+		if (!f) {
+			// the page cannot be read as a whole, let the plugin decide
+			int ret = rz_io_plugin_read_at (desc, addr, buf + done, len - done);
+			if (!done) {
+				return ret;
+			}
+			done += RZ_MAX (ret, 0);
+			break;
+		}
+		if (f->size <= off) {
+			break;
+		}
+		int n = RZ_MIN ((int)(f->size - off), len - done);
+		memcpy (buf + done, data + off, n);
+		done += n;
+		if (f->size < PS) {
+			// short page, end of the desc
+			break;
+		}
+	}
+	if (done > 0 && (desc->io->p_cache & 1)) {
+		done = rz_io_desc_cache_read (desc, paddr, buf, done);
+	}
+	return done;
+}
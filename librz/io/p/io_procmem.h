@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#ifndef IO_PROCMEM_H
+#define IO_PROCMEM_H
+
+// Helpers shared by the plugins accessing the memory of a live linux process
+// (ptrace, procpid). process_vm_readv/writev move many ranges per syscall,
+// pread/pwrite on /proc/pid/mem is the fallback when they are unavailable or
+// the pages are not accessible to them (e.g. writing to r-x text).
+
+#include <rz_io.h>
+
+#if __linux__
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+
+#if defined(SYS_process_vm_readv) && defined(SYS_process_vm_writev)
+#define PROCMEM_HAVE_VM 1
+#else
+#define PROCMEM_HAVE_VM 0
+#endif
+
+// UIO_MAXIOV, the kernel rejects longer iovec arrays
+#define PROCMEM_IOV_MAX 1024
+
+// Reads the requests of pid using as few process_vm_readv calls as possible.
+// Sets ret of every request to the length of its read prefix and returns the
+// number of complete requests, or -1 if the syscall cannot be used at all.
+static inline int procmem_vm_read_batch(int pid, RzIOBatchRead *reqs, int count) {
+#if PROCMEM_HAVE_VM
+	struct iovec local[PROCMEM_IOV_MAX];
+	struct iovec remote[PROCMEM_IOV_MAX];
+	int idx[PROCMEM_IOV_MAX];
+	int i = 0, complete = 0;
+	for (i = 0; i < count; i++) {
+		reqs[i].ret = 0;
+	}
+	i = 0;
+	while (i < count) {
+		int n = 0, j;
+		for (j = i; j < count && n < PROCMEM_IOV_MAX; j++) {
+			if (reqs[j].len < 1) {
+				continue;
+			}
+			local[n].iov_base = reqs[j].buf;
+			local[n].iov_len = reqs[j].len;
+			remote[n].iov_base = (void *)(size_t)reqs[j].addr;
+			remote[n].iov_len = reqs[j].len;
+			idx[n++] = j;
+		}
+		if (!n) {
+			break;
+		}
+		ssize_t r = syscall (SYS_process_vm_readv, (pid_t)pid, local, (unsigned long)n, remote, (unsigned long)n, 0UL);
+		if (r < 0) {
+			if (errno == ENOSYS || errno == EPERM) {
+				return -1;
+			}
+			// the first range faults, skip it and go on with the rest
+			i = idx[0] + 1;
+			continue;
+		}
+		// transfers stop at the first faulting remote range
+		int k;
+		for (k = 0; k < n; k++) {
+			RzIOBatchRead *req = &reqs[idx[k]];
+			req->ret = (int)RZ_MIN ((ssize_t)req->len, r);
+			r -= req->ret;
+			if (req->ret != req->len) {
+				break;
+			}
+		}
+		// resume right after the faulting range, if any
+		i = k < n ? idx[k] + 1 : j;
+	}
+	for (i = 0; i < count; i++) {
+		if (reqs[i].ret == reqs[i].len) {
+			complete++;
+		}
+	}
+	return complete;
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+static inline int procmem_vm_write(int pid, ut64 addr, const ut8 *buf, int len) {
+#if PROCMEM_HAVE_VM
+	struct iovec local = { (void *)buf, (size_t)len };
+	struct iovec remote = { (void *)(size_t)addr, (size_t)len };
+	return (int)syscall (SYS_process_vm_writev, (pid_t)pid, &local, 1UL, &remote, 1UL, 0UL);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+// returns the length of the read prefix, -1 if nothing could be read
+static inline int procmem_pread(int fd, ut64 addr, ut8 *buf, int len) {
+	int done = 0;
+	if (fd == -1 || (st64)addr < 0) {
+		return -1;
+	}
+	while (done < len) {
+		ssize_t r = pread (fd, buf + done, len - done, (off_t)(addr + done));
+		if (r <= 0) {
+			break;
+		}
+		done += (int)r;
+	}
+	return done ? done : -1;
+}
+
+static inline int procmem_pwrite(int fd, ut64 addr, const ut8 *buf, int len) {
+	int done = 0;
+	if (fd == -1 || (st64)addr < 0) {
+		return -1;
+	}
+	while (done < len) {
+		ssize_t r = pwrite (fd, buf + done, len - done, (off_t)(addr + done));
+		if (r <= 0) {
+			break;
+		}
+		done += (int)r;
+	}
+	return done ? done : -1;
+}
+
+#endif
+#endif
@@ -12,10 +12,12 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <errno.h>
+#include "io_procmem.h"
 
 typedef struct {
 	int fd;
 	int pid;
+	bool vm; // process_vm_readv/writev are usable
 } RzIOProcpid;
 
 #define RzIOPROCPID_PID(x) (((RzIOProcpid*)(x)->data)->pid)
@@ -26,27 +28,45 @@ static int __waitpid(int pid) {
 	return (waitpid(pid, &st, 0) != -1);
 }
 
-static int debug_os_read_at(int fdn, void *buf, int sz, ut64 addr) {
-	if (lseek (fdn, addr, 0) < 0) {
+static int __read_batch(RzIO *io, RzIODesc *fd, RzIOBatchRead *reqs, int count) {
+	RzIOProcpid *iop = fd ? fd->data : NULL;
+	int i, complete = 0;
+	if (!iop) {
 		return -1;
 	}
-	return read (fdn, buf, sz);
+	int r = iop->vm ? procmem_vm_read_batch (iop->pid, reqs, count) : -1;
+	if (r < 0) {
+		iop->vm = false;
+	}
+	for (i = 0; i < count; i++) {
+		RzIOBatchRead *req = &reqs[i];
+		if (r < 0) {
+			req->ret = 0;
+		}
+		if (req->len > 0 && req->ret < req->len) {
+			int n = procmem_pread (iop->fd, req->addr + req->ret, req->buf + req->ret, req->len - req->ret);
+			req->ret += RZ_MAX (n, 0);
+			memset (req->buf + req->ret, 0xff, req->len - req->ret);
+		}
+		if (req->ret == req->len) {
+			complete++;
+		}
+	}
+	return complete;
 }
 
 static int __read(RzIO *io, RzIODesc *fd, ut8 *buf, int len) {
-	memset (buf, 0xff, len); // TODO: only memset the non-readed bytes
-	return debug_os_read_at (RzIOPROCPID_FD (fd), buf, len, io->off);
-}
-
-static int procpid_write_at(int fd, const ut8 *buf, int sz, ut64 addr) {
-	if (lseek (fd, addr, 0) < 0) {
-		return -1;
-	}
-	return write (fd, buf, sz);
+	RzIOBatchRead req = { io->off, buf, len, 0 };
+	__read_batch (io, fd, &req, 1);
+	return req.ret > 0 ? req.ret : -1;
 }
 
 static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
-	return procpid_write_at (RzIOPROCPID_FD (fd), buf, len, io->off);
+	RzIOProcpid *iop = fd->data;
+	if (iop->vm && procmem_vm_write (iop->pid, io->off, buf, len) == len) {
+		return len;
+	}
+	return procmem_pwrite (iop->fd, io->off, buf, len);
 }
 
 static bool __plugin_open(RzIO *io, const char *file, bool many) {
@@ -90,6 +110,7 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 			}
 			riop->pid = pid;
 			riop->fd = fd;
+			riop->vm = true;
 			RzIODesc *d = rz_io_desc_new (io, &rz_io_plugin_procpid, file, true, 0, riop);
 			d->name = rz_sys_pid_to_path (riop->pid);
 			return d;
@@ -102,11 +123,25 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 }
 
 static ut64 __lseek(RzIO *io, RzIODesc *fd, ut64 offset, int whence) {
-	return offset;
+	switch (whence) {
+	case RZ_IO_SEEK_SET:
+		io->off = offset;
+		break;
+	case RZ_IO_SEEK_CUR:
+		io->off += offset;
+		break;
+	case RZ_IO_SEEK_END:
+		io->off = ST64_MAX;
+		break;
+	}
+	return io->off;
 }
 
 static int __close(RzIODesc *fd) {
 	int ret = ptrace (PTRACE_DETACH, RzIOPROCPID_PID (fd), 0, 0);
+	if (RzIOPROCPID_FD (fd) != -1) {
+		close (RzIOPROCPID_FD (fd));
+	}
 	RZ_FREE (fd->data);
 	return ret;
 }
@@ -133,6 +168,7 @@ RzIOPlugin rz_io_plugin_procpid = {
 	.open = __open,
 	.close = __close,
 	.read = __read,
+	.read_batch = __read_batch,
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.system = __system,
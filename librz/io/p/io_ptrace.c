@@ -19,6 +19,7 @@ typedef struct {
 	int tid;
 	int fd;
 	int opid;
+	bool vm; // process_vm_readv/writev are usable
 } RzIOPtrace;
 #define RzIOPTRACE_OPID(x) (((RzIOPtrace*)(x)->data)->opid)
 #define RzIOPTRACE_PID(x) (((RzIOPtrace*)(x)->data)->pid)
@@ -40,12 +41,14 @@ extern int errno;
 #endif
 #endif
 
-#if 0
-procpidmem is buggy.. running this sometimes results in ffff
-
-	while : ; do rizin -qc 'oo;x' -d ls ; done
-#endif
+// reads go through process_vm_readv, then /proc/pid/mem and only then
+// word by word with PTRACE_PEEKTEXT
+#if __linux__
+#include "io_procmem.h"
+#define USE_PROC_PID_MEM 1
+#else
 #define USE_PROC_PID_MEM 0
+#endif
 
 static int __waitpid(int pid) {
 	int st = 0;
@@ -62,62 +65,96 @@ typedef size_t ptrace_word; // long ptrace(enum __ptrace_request request, pid_t
 // XXX. using long here breaks 'w AAAABBBBCCCCDDDD' in rizin -d
 #endif
 
-static int debug_os_read_at(RzIO *io, int pid, ut32 *buf, int sz, ut64 addr) {
-	ut32 words = sz / sizeof (ut32);
-	ut32 last = sz % sizeof (ut32);
-	ut32 x, lr, *at = (ut32*)(size_t)addr;
+// last resort, one syscall per word. Returns the length of the read prefix
+static int debug_os_read_at(RzIO *io, int pid, ut8 *buf, int sz, ut64 addr) {
+	ptrace_word *at = (ptrace_word *)(size_t)(addr & ~(ut64)(sizeof (ptrace_word) - 1));
+	int skip = addr % sizeof (ptrace_word);
+	int done = 0;
 	if (sz < 1 || addr == UT64_MAX) {
 		return -1;
 	}
-	for (x = 0; x < words; x++) {
-		buf[x] = (ut32)debug_read_raw (io, pid, (void *)(at++));
+	while (done < sz) {
+		errno = 0;
+		ptrace_word w = (ptrace_word)debug_read_raw (io, pid, (void *)(at++));
+		if (w == (ptrace_word)-1 && errno) {
+			break;
+		}
+		int n = RZ_MIN ((int)sizeof (ptrace_word) - skip, sz - done);
+		memcpy (buf + done, (ut8 *)&w + skip, n);
+		done += n;
+		skip = 0;
 	}
-	if (last) {
-		lr = (ut32)debug_read_raw (io, pid, at);
-		memcpy (buf+x, &lr, last) ;
+	return done ? done : -1;
+}
+
+static void reopen_pidmem(RzIODesc *desc) {
+	if (RzIOPTRACE_PID (desc) != RzIOPTRACE_OPID (desc)) {
+		if (RzIOPTRACE_FD (desc) != -1) {
+			close (RzIOPTRACE_FD (desc));
+		}
+		open_pidmem ((RzIOPtrace*)desc->data);
+		RzIOPTRACE_OPID (desc) = RzIOPTRACE_PID (desc);
 	}
-	return sz;
 }
 
-static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
+// completes the tail of a request process_vm_readv could not serve
+static int read_fallback(RzIO *io, RzIODesc *desc, RzIOBatchRead *req) {
+	int done = RZ_MAX (req->ret, 0);
+	int r;
 #if USE_PROC_PID_MEM
-	int ret, fd;
+	if (done < req->len) {
+		r = procmem_pread (RzIOPTRACE_FD (desc), req->addr + done, req->buf + done, req->len - done);
+		done += RZ_MAX (r, 0);
+	}
 #endif
-	ut64 addr = io->off;
-	if (!desc || !desc->data) {
+	if (done < req->len) {
+		r = debug_os_read_at (io, RzIOPTRACE_PID (desc), req->buf + done, req->len - done, req->addr + done);
+		done += RZ_MAX (r, 0);
+	}
+	if (done < req->len) {
+		memset (req->buf + done, 0xff, req->len - done);
+	}
+	req->ret = done;
+	return done;
+}
+
+static int __read_batch(RzIO *io, RzIODesc *desc, RzIOBatchRead *reqs, int count) {
+	RzIOPtrace *iop = desc ? desc->data : NULL;
+	int i, complete = 0;
+	if (!iop) {
 		return -1;
 	}
-	memset (buf, '\xff', len); // TODO: only memset the non-readed bytes
-	/* reopen procpidmem if necessary */
+	reopen_pidmem (desc);
+	int r = -1;
 #if USE_PROC_PID_MEM
-	fd = RzIOPTRACE_FD (desc);
-	if (RzIOPTRACE_PID (desc) != RzIOPTRACE_OPID (desc)) {
-		if (fd != -1) {
-			close (fd);
+	if (iop->vm) {
+		r = procmem_vm_read_batch (iop->pid, reqs, count);
+		if (r < 0) {
+			iop->vm = false;
 		}
-		open_pidmem ((RzIOPtrace*)desc->data);
-		fd = RzIOPTRACE_FD (desc);
-		RzIOPTRACE_OPID(desc) = RzIOPTRACE_PID(desc);
 	}
-	// /proc/pid/mem fails on latest linux
-	if (fd != -1) {
-		ret = lseek (fd, addr, SEEK_SET);
-		if (ret >=0) {
-			// Workaround for the buggy Debian Wheeze's /proc/pid/mem
-			if (read (fd, buf, len) != -1) {
-				return ret;
-			}
+#endif
+	for (i = 0; i < count; i++) {
+		if (r < 0) {
+			reqs[i].ret = 0;
+		}
+		if (reqs[i].len > 0 && reqs[i].ret < reqs[i].len) {
+			read_fallback (io, desc, &reqs[i]);
+		}
+		if (reqs[i].ret == reqs[i].len) {
+			complete++;
 		}
 	}
-#endif
-	ut32 *aligned_buf = (ut32*)rz_malloc_aligned (len, sizeof (ut32));
-	if (aligned_buf) {
-		int res = debug_os_read_at (io, RzIOPTRACE_PID (desc), (ut32*)aligned_buf, len, addr);
-		memcpy (buf, aligned_buf, len);
-		rz_free_aligned (aligned_buf);
-		return res;
+	return complete;
+}
+
+static int __read(RzIO *io, RzIODesc *desc, ut8 *buf, int len) {
+	if (!desc || !desc->data) {
+		return -1;
 	}
-	return -1;
+	RzIOBatchRead req = { io->off, buf, len, 0 };
+	__read_batch (io, desc, &req, 1);
+	return req.ret > 0 ? req.ret : -1;
 }
 
 static int ptrace_write_at(RzIO *io, int pid, const ut8 *pbuf, int sz, ut64 addr) {
@@ -149,6 +186,18 @@ static int __write(RzIO *io, RzIODesc *fd, const ut8 *buf, int len) {
 	if (!fd || !fd->data) {
 		return -1;
 	}
+#if USE_PROC_PID_MEM
+	RzIOPtrace *iop = fd->data;
+	reopen_pidmem (fd);
+	// process_vm_writev honours the page protections, so breakpoints in
+	// r-x text still need /proc/pid/mem or the pokes below
+	if (iop->vm && procmem_vm_write (iop->pid, io->off, buf, len) == len) {
+		return len;
+	}
+	if (procmem_pwrite (iop->fd, io->off, buf, len) == len) {
+		return len;
+	}
+#endif
 	return ptrace_write_at (io, RzIOPTRACE_PID (fd), buf, len, io->off);
 }
 
@@ -160,11 +209,6 @@ static void open_pidmem (RzIOPtrace *iop) {
 	if (iop->fd == -1) {
 		iop->fd = open (pidmem, O_RDONLY);
 	}
-#if 0
-	if (iop->fd == -1)
-		eprintf ("Warning: Cannot open /proc/%d/mem. "
-			"Fallback to ptrace io.\n", iop->pid);
-#endif
 #else
 	iop->fd = -1;
 #endif
@@ -249,7 +293,8 @@ static RzIODesc *__open(RzIO *io, const char *file, int rw, int mode) {
 		return NULL;
 	}
 
-	riop->pid = riop->tid = pid;
+	riop->pid = riop->tid = riop->opid = pid;
+	riop->vm = true;
 	open_pidmem (riop);
 	desc = rz_io_desc_new (io, &rz_io_plugin_ptrace, file, rw | RZ_PERM_X, mode, riop);
 	desc->name = rz_sys_pid_to_path (pid);
@@ -302,15 +347,18 @@ static char *__system(RzIO *io, RzIODesc *fd, const char *cmd) {
 	if (!strcmp (cmd, "help")) {
 		eprintf ("Usage: =!cmd args\n"
 			" =!ptrace   - use ptrace io\n"
-			" =!mem      - use /proc/pid/mem io if possible\n"
+			" =!mem      - use process_vm_readv and /proc/pid/mem io if possible\n"
 			" =!pid      - show targeted pid\n"
 			" =!pid <#>  - select new pid\n");
 	} else
 	if (!strcmp (cmd, "ptrace")) {
 		close_pidmem (iop);
+		iop->vm = false;
 	} else
 	if (!strcmp (cmd, "mem")) {
+		close_pidmem (iop);
 		open_pidmem (iop);
+		iop->vm = true;
 	} else
 	if (!strncmp (cmd, "pid", 3)) {
 		if (iop) {
@@ -349,6 +397,7 @@ RzIOPlugin rz_io_plugin_ptrace = {
 	.open = __open,
 	.close = __close,
 	.read = __read,
+	.read_batch = __read_batch,
 	.check = __plugin_open,
 	.lseek = __lseek,
 	.system = __system,
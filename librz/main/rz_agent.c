@@ -126,7 +126,7 @@ RZ_API int rz_main_rz_agent(int argc, const char **argv) {
 
 	(void)rz_cons_new ();
 
-	while (!rz_cons_singleton ()->context->breaked) {
+	while (!rz_cons_context ()->breaked) {
 		char *result_heap = NULL;
 		const char *result = page_index;
 
@@ -9,6 +9,9 @@
 #include <rz_util.h>
 #include <rz_crypto.h>
 
+// block size for the algorithms whose result does not depend on it
+#define HASH_STREAM_BLOCK (1024 * 1024)
+
 static ut64 from = 0LL;
 static ut64 to = 0LL;
 static bool incremental = true;
@@ -138,10 +141,32 @@ static int do_hash_internal(RzHash *ctx, ut64 hash, const ut8 *buf, int len, int
 	return 1;
 }
 
+typedef struct {
+	int rad;
+	int ule;
+} HashBlockOpts;
+
+static int do_hash_read(void *user, ut64 addr, ut8 *buf, int len) {
+	return rz_io_pread_at ((RzIO *)user, addr, buf, len);
+}
+
+static void do_hash_block(void *user, ut64 addr, int len, ut64 algo, RzHash *ctx) {
+	HashBlockOpts *opts = user;
+	ut64 ofrom = from, oto = to;
+	from = addr;
+	to = addr + len;
+	if (iterations > 0) {
+		rz_hash_do_spice (ctx, algo, iterations, _s);
+	}
+	do_hash_print (ctx, algo, rz_hash_size (algo), opts->rad, opts->ule);
+	from = ofrom;
+	to = oto;
+}
+
 static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int rad, int ule, const ut8 *compare) {
-	ut64 j, fsize, algobit = rz_hash_name_to_bits (algo);
+	ut64 fsize, algobit = rz_hash_name_to_bits (algo);
+	RzHashMulti *mh;
 	RzHash *ctx;
-	ut8 *buf;
 	int ret = 0;
 	ut64 i;
 	bool first = true;
@@ -171,56 +196,59 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 		eprintf ("rz-hash: Unknown file size\n");
 		return 1;
 	}
-	buf = calloc (1, bsize + 1);
-	if (!buf) {
+	// every block is read once for all the algorithms
+	mh = rz_hash_multi_new (algobit, 0);
+	if (!mh) {
 		return 1;
 	}
-	ctx = rz_hash_new (true, algobit);
 
 	if (rad == 'j') {
 		printf ("[");
 	}
 	if (incremental) {
+		// the block size only changes the result of the algorithms
+		// hashing the last block alone, the rest can use a smaller one
+		int sbsize = rz_hash_multi_streamable (algobit)? RZ_MIN (bsize, HASH_STREAM_BLOCK): bsize;
+		if (s.buf && s.prefix) {
+			rz_hash_multi_update (mh, s.buf, s.len);
+		}
+		if (!rz_hash_multi_stream (mh, do_hash_read, io, from, to, sbsize)) {
+			eprintf ("rz-hash: Cannot allocate the buffers to hash %s\n", file);
+			if (_s) {
+				free (_s->buf);
+			}
+			ret = 1;
+			goto beach;
+		}
+		if (s.buf && !s.prefix) {
+			rz_hash_multi_update (mh, s.buf, s.len);
+		}
+		rz_hash_multi_end (mh);
 		for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
-			if (algobit & i) {
-				ut64 hashbit = i & algobit;
-				int dlen = rz_hash_size (hashbit);
-				rz_hash_do_begin (ctx, i);
-				if (s.buf && s.prefix) {
-					do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
-				}
-				for (j = from; j < to; j += bsize) {
-					int len = ((j + bsize) > to)? (to - j): bsize;
-					rz_io_pread_at (io, j, buf, len);
-					do_hash_internal (ctx, hashbit, buf, len, rad, 0, ule);
-				}
-				if (s.buf && !s.prefix) {
-					do_hash_internal (ctx, hashbit, s.buf, s.len, rad, 0, ule);
-				}
-				rz_hash_do_end (ctx, i);
-				if (iterations > 0) {
-					rz_hash_do_spice (ctx, i, iterations, _s);
-				}
-				if (!*rz_hash_name (i)) {
-					continue;
-				}
-				if (rad == 'j') {
-					if (first) {
-						first = false;
-					} else {
-						printf (",");
-					}
-				}
-				if (!quiet && rad != 'j') {
-					printf ("%s: ", file);
-				}
-				do_hash_print (ctx, i, dlen, quiet? 'n': rad, ule);
-				if (quiet == 1) {
-					printf (" %s\n", file);
+			if (!(algobit & i) || !*rz_hash_name (i)) {
+				continue;
+			}
+			int dlen = rz_hash_size (i);
+			ctx = rz_hash_multi_get (mh, i);
+			if (iterations > 0) {
+				rz_hash_do_spice (ctx, i, iterations, _s);
+			}
+			if (rad == 'j') {
+				if (first) {
+					first = false;
 				} else {
-					if (quiet && !rad) {
-						printf ("\n");
-					}
+					printf (",");
+				}
+			}
+			if (!quiet && rad != 'j') {
+				printf ("%s: ", file);
+			}
+			do_hash_print (ctx, i, dlen, quiet? 'n': rad, ule);
+			if (quiet == 1) {
+				printf (" %s\n", file);
+			} else {
+				if (quiet && !rad) {
+					printf ("\n");
 				}
 			}
 		}
@@ -228,31 +256,21 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 			free (_s->buf);
 		}
 	} else {
-		/* iterate over all algorithm bits */
+		/* hash every block with all the algorithms, spread among the cpus */
+		HashBlockOpts opts = { rad, ule };
 		if (s.buf) {
 			eprintf ("Warning: Seed ignored on per-block hashing.\n");
 		}
+		if (!rz_hash_multi_blocks (mh, do_hash_read, io, from, to, bsize, do_hash_block, &opts)) {
+			eprintf ("rz-hash: Cannot allocate the buffers to hash %s\n", file);
+			ret = 1;
+			goto beach;
+		}
 		for (i = 1; i < RZ_HASH_ALL; i <<= 1) {
-			ut64 f, t, ofrom, oto;
 			if (algobit & i) {
-				ut64 hashbit = i & algobit;
-				ofrom = from;
-				oto = to;
-				f = from;
-				t = to;
-				for (j = f; j < t; j += bsize) {
-					int nsize = (j + bsize < fsize)? bsize: (fsize - j);
-					rz_io_pread_at (io, j, buf, bsize);
-					from = j;
-					to = j + bsize;
-					if (to > fsize) {
-						to = fsize;
-					}
-					do_hash_internal (ctx, hashbit, buf, nsize, rad, 1, ule);
-				}
-				do_hash_internal (ctx, hashbit, NULL, 0, rad, 1, ule);
-				from = ofrom;
-				to = oto;
+				ctx = rz_hash_new (true, i);
+				do_hash_internal (ctx, i, NULL, 0, rad, 1, ule);
+				rz_hash_free (ctx);
 			}
 		}
 	}
@@ -260,9 +278,12 @@ static int do_hash(const char *file, const char *algo, RzIO *io, int bsize, int
 		printf ("]\n");
 	}
 
-	compare_hashes (ctx, compare, rz_hash_size (algobit), &ret);
-	rz_hash_free (ctx);
-	free (buf);
+	ctx = rz_hash_multi_get (mh, algobit);
+	if (ctx) {
+		compare_hashes (ctx, compare, rz_hash_size (algobit), &ret);
+	}
+beach:
+	rz_hash_multi_free (mh);
 	return ret;
 }
 
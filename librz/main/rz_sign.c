@@ -5,16 +5,19 @@
 static void rasign_show_help(void) {
 	printf ("Usage: rz-sign [options] [file]\n"
 		" -a [-a]          add extra 'a' to analysis command\n"
+		" -c sigs.zdx      write a compiled index of the signatures (load it with zo)\n"
 		" -f               interpret the file as a FLIRT .sig file and dump signatures\n"
 		" -h               help menu\n"
 		" -j               show signatures in json\n"
+		" -l sigs.sdb      use the signatures in this file instead of generating them\n"
 		" -o sigs.sdb      add signatures to file, create if it does not exist\n"
 		" -q               quiet mode\n"
 		" -r               show output in rizin commands\n"
 		" -s signspace     save all signatures under this signspace\n"
 		" -v               show version information\n"
 		"Examples:\n"
-		"  rz_sign -o libc.sdb libc.so.6\n");
+		"  rz_sign -o libc.sdb libc.so.6\n"
+		"  rz_sign -c libc.zdx -l libc.sdb\n");
 }
 
 static RzCore *opencore(const char *fname) {
@@ -59,6 +62,8 @@ static void find_functions(RzCore *core, size_t count) {
 
 RZ_API int rz_main_rz_sign(int argc, const char **argv) {
 	const char *ofile = NULL;
+	const char *cfile = NULL;
+	const char *lfile = NULL;
 	const char *space = NULL;
 	int c;
 	size_t a_cnt = 0;
@@ -68,12 +73,18 @@ RZ_API int rz_main_rz_sign(int argc, const char **argv) {
 	bool flirt = false;
 	RzGetopt opt;
 
-	rz_getopt_init (&opt, argc, argv, "afhjo:qrs:v");
+	rz_getopt_init (&opt, argc, argv, "ac:fhjl:o:qrs:v");
 	while ((c = rz_getopt_next (&opt)) != -1) {
 		switch (c) {
 		case 'a':
 			a_cnt++;
 			break;
+		case 'c':
+			cfile = opt.arg;
+			break;
+		case 'l':
+			lfile = opt.arg;
+			break;
 		case 'o':
 			ofile = opt.arg;
 			break;
@@ -110,16 +121,18 @@ RZ_API int rz_main_rz_sign(int argc, const char **argv) {
 	}
 
 	const char *ifile = NULL;
-	if (opt.ind >= argc) {
+	if (opt.ind >= argc && !lfile) {
 		eprintf ("must provide a file\n");
 		rasign_show_help ();
 		return -1;
 	}
-	ifile = argv[opt.ind];
+	if (opt.ind < argc) {
+		ifile = argv[opt.ind];
+	}
 
 	RzCore *core = NULL;
 	if (flirt) {
-		if (rad || ofile || json) {
+		if (!ifile || rad || ofile || cfile || json) {
 			eprintf ("Only FLIRT output is supported for FLIRT files\n");
 			return -1;
 		}
@@ -148,17 +161,29 @@ RZ_API int rz_main_rz_sign(int argc, const char **argv) {
 		rz_spaces_set (&core->analysis->zign_spaces, space);
 	}
 
-	// run analysis to find functions
-	find_functions (core, a_cnt);
+	if (lfile) {
+		if (!rz_sign_load (core->analysis, lfile)) {
+			eprintf ("Could not load signatures from %s\n", lfile);
+			rz_core_free (core);
+			return -1;
+		}
+	} else {
+		// run analysis to find functions
+		find_functions (core, a_cnt);
 
-	// create zignatures
-	rz_core_cmd0 (core, "zg");
+		// create zignatures
+		rz_core_cmd0 (core, "zg");
+	}
 
 	// write sigs to file
 	if (ofile) {
 		rz_core_cmdf (core, "\"zos %s\"", ofile);
 	}
 
+	if (cfile && !rz_sign_index_save (core->analysis, cfile)) {
+		eprintf ("Could not write the signature index to %s\n", cfile);
+	}
+
 	if (rad) {
 		rz_core_flush (core, "z*");
 	}
@@ -160,10 +160,21 @@ RZ_API const char *rz_reg_get_role(int role) {
 	return NULL;
 }
 
+// source of RzReg.gen, unique among all the instances. Register profiles
+// are also set up from analysis worker threads, so it is bumped atomically
+#if defined(_MSC_VER)
+static volatile LONG reg_gen = 0;
+#define reg_gen_next() ((ut32)InterlockedIncrement (&reg_gen))
+#else
+static ut32 reg_gen = 0;
+#define reg_gen_next() __atomic_add_fetch (&reg_gen, 1, __ATOMIC_RELAXED)
+#endif
+
 RZ_API void rz_reg_free_internal(RzReg *reg, bool init) {
 	rz_return_if_fail (reg);
 	ut32 i;
 
+	reg->gen = reg_gen_next ();
 	rz_list_free (reg->roregs);
 	reg->roregs = NULL;
 	RZ_FREE (reg->reg_profile_str);
@@ -258,6 +269,7 @@ RZ_API RzReg *rz_reg_new(void) {
 	if (!reg) {
 		return NULL;
 	}
+	reg->gen = reg_gen_next ();
 	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
 		arena = rz_reg_arena_new (0);
 		if (!arena) {
@@ -0,0 +1,409 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include <ctype.h>
+#include "search_private.h"
+
+// Multi keyword matcher for RZ_SEARCH_KEYWORD. Every keyword contributes an
+// anchor, its longest run of unmasked bytes, and an Aho-Corasick automaton
+// over all the anchors finds the candidate offsets in a single pass over the
+// data, whatever the number of keywords. Case insensitive keywords get their
+// anchor lowercased and the input is lowercased while scanning, so the
+// candidates are a superset of the hits and are verified by the caller.
+// While no anchor is partially matched, the scan jumps to the next byte that
+// can start one with memchr when there is a single such byte, or with a table
+// of the first two bytes of every anchor when there are few of them.
+
+#define KWSET_ANCHOR_MAX 16
+#define KWSET_PAIRS_MAX 0x800 // more pairs than this and the table rarely skips
+#define KWSET_DENSE_MAX 1024 // states with a full transition table, 1 MB
+
+typedef struct {
+	RzSearchKeyword *kw;
+	int idx; // index of the keyword in the list
+	int kwlen;
+	int anchor; // offset of the anchor in the keyword
+	int len; // length of the anchor
+} KwsetEntry;
+
+typedef struct {
+	ut32 fail;
+	ut32 dict; // closest state on the fail chain with entries, 0 if none
+	ut32 edges; // first edge in ekeys/enext
+	ut32 nedges;
+	ut32 out; // first entry in outs
+	ut32 nout;
+} KwsetState;
+
+struct rz_search_kwset_t {
+	ut8 fold[256];
+	ut32 *dense; // full transitions of the first ndense states
+	ut32 ndense;
+	KwsetState *states;
+	ut32 nstates;
+	ut8 *ekeys; // edge bytes, sorted per state
+	ut32 *enext;
+	KwsetEntry *outs;
+	bool *anchored; // by keyword index
+	int nkws;
+	int first; // single byte starting all the anchors, -1 if none
+	ut8 *pairs; // bitmap of the first two bytes of the anchors, NULL if not worth it
+	ut8 starts[256 / 8]; // bytes starting an anchor
+};
+
+// temporary trie, children are kept sorted in sibling lists
+typedef struct {
+	ut32 child;
+	ut32 sibling;
+	ut8 key;
+} KwsetNode;
+
+typedef struct {
+	ut32 node;
+	KwsetEntry e;
+} KwsetOut;
+
+static bool kw_exact_at(RzSearchKeyword *kw, int j) {
+	return !kw->binmask_length || kw->bin_binmask[j % kw->binmask_length] == 0xff;
+}
+
+// longest run of unmasked bytes, up to KWSET_ANCHOR_MAX
+static int kw_anchor(RzSearchKeyword *kw, int *len) {
+	int j, best = -1, bestlen = 0, run = 0;
+	for (j = 0; j < (int)kw->keyword_length; j++) {
+		run = kw_exact_at (kw, j)? run + 1: 0;
+		if (run > bestlen) {
+			bestlen = run;
+			best = j - run + 1;
+			if (bestlen == KWSET_ANCHOR_MAX) {
+				break;
+			}
+		}
+	}
+	*len = bestlen;
+	return best;
+}
+
+static ut32 trie_child(RzVector *nodes, ut32 parent, ut8 key) {
+	KwsetNode *p = rz_vector_index_ptr (nodes, parent);
+	ut32 prev = 0, cur = p->child;
+	while (cur) {
+		KwsetNode *n = rz_vector_index_ptr (nodes, cur);
+		if (n->key == key) {
+			return cur;
+		}
+		if (n->key > key) {
+			break;
+		}
+		prev = cur;
+		cur = n->sibling;
+	}
+	KwsetNode node = { 0, cur, key };
+	ut32 idx = (ut32)rz_vector_len (nodes);
+	if (!rz_vector_push (nodes, &node)) {
+		return 0;
+	}
+	if (prev) {
+		((KwsetNode *)rz_vector_index_ptr (nodes, prev))->sibling = idx;
+	} else {
+		((KwsetNode *)rz_vector_index_ptr (nodes, parent))->child = idx;
+	}
+	return idx;
+}
+
+static int out_cmp(const void *a, const void *b) {
+	const KwsetOut *x = a, *y = b;
+	if (x->node != y->node) {
+		return x->node < y->node? -1: 1;
+	}
+	return x->e.idx - y->e.idx;
+}
+
+static inline ut32 kwset_goto(const RzSearchKwSet *set, ut32 s, ut8 c) {
+	const KwsetState *st = &set->states[s];
+	const ut8 *keys = set->ekeys + st->edges;
+	ut32 lo = 0, hi = st->nedges;
+	while (lo < hi) {
+		ut32 mid = (lo + hi) / 2;
+		if (keys[mid] < c) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo < st->nedges && keys[lo] == c? set->enext[st->edges + lo]: 0;
+}
+
+static inline ut32 kwset_step(const RzSearchKwSet *set, ut32 s, ut8 c) {
+	while (s >= set->ndense) {
+		ut32 n = kwset_goto (set, s, c);
+		if (n) {
+			return n;
+		}
+		s = set->states[s].fail;
+	}
+	return set->dense[(s << 8) | c];
+}
+
+static bool kwset_build(RzSearchKwSet *set, RzVector *nodes, RzVector *outs) {
+	ut32 i, n = (ut32)rz_vector_len (nodes);
+	// number the states in BFS order, so that fail links point backwards
+	ut32 *order = RZ_NEWS (ut32, n);
+	ut32 *map = RZ_NEWS (ut32, n);
+	set->states = RZ_NEWS0 (KwsetState, n);
+	set->ekeys = malloc (n);
+	set->enext = RZ_NEWS (ut32, n);
+	if (!order || !map || !set->states || !set->ekeys || !set->enext) {
+		free (order);
+		free (map);
+		return false;
+	}
+	ut32 head = 0, tail = 0, nedges = 0;
+	order[tail++] = 0;
+	map[0] = 0;
+	while (head < tail) {
+		ut32 node = order[head];
+		KwsetState *st = &set->states[head++];
+		st->edges = nedges;
+		ut32 c = ((KwsetNode *)rz_vector_index_ptr (nodes, node))->child;
+		while (c) {
+			KwsetNode *cn = rz_vector_index_ptr (nodes, c);
+			map[c] = tail;
+			set->ekeys[nedges] = cn->key;
+			set->enext[nedges++] = tail;
+			order[tail++] = c;
+			c = cn->sibling;
+		}
+		st->nedges = nedges - st->edges;
+	}
+	set->nstates = n;
+	// fail links, parents come before their children and the states of
+	// the first levels, the most visited ones, get all their transitions
+	set->ndense = RZ_MIN (n, KWSET_DENSE_MAX);
+	set->dense = RZ_NEWS (ut32, (size_t)set->ndense << 8);
+	if (!set->dense) {
+		free (order);
+		free (map);
+		return false;
+	}
+	for (i = 0; i < n; i++) {
+		KwsetState *st = &set->states[i];
+		ut32 e, c;
+		for (e = st->edges; e < st->edges + st->nedges; e++) {
+			ut32 child = set->enext[e];
+			set->states[child].fail = i? kwset_step (set, st->fail, set->ekeys[e]): 0;
+		}
+		if (i < set->ndense) {
+			for (c = 0; c < 256; c++) {
+				ut32 next = kwset_goto (set, i, c);
+				set->dense[(i << 8) | c] = next || !i? next: set->dense[(st->fail << 8) | c];
+			}
+		}
+	}
+	// entries, sorted by state
+	KwsetOut *o;
+	rz_vector_foreach (outs, o) {
+		o->node = map[o->node];
+	}
+	if (!rz_vector_empty (outs)) {
+		qsort (outs->a, outs->len, outs->elem_size, out_cmp);
+	}
+	set->outs = RZ_NEWS (KwsetEntry, RZ_MAX (rz_vector_len (outs), 1));
+	if (!set->outs) {
+		free (order);
+		free (map);
+		return false;
+	}
+	ut32 k = 0;
+	rz_vector_foreach (outs, o) {
+		KwsetState *st = &set->states[o->node];
+		if (!st->nout) {
+			st->out = k;
+		}
+		st->nout++;
+		set->outs[k++] = o->e;
+	}
+	for (i = 1; i < n; i++) {
+		ut32 f = set->states[i].fail;
+		set->states[i].dict = set->states[f].nout? f: set->states[f].dict;
+	}
+	free (order);
+	free (map);
+	return true;
+}
+
+static void kwset_prefilter(RzSearchKwSet *set) {
+	ut8 *pairs = calloc (1, 0x10000 / 8);
+	int c, npairs = 0, nfirst = 0;
+	if (!pairs) {
+		return;
+	}
+	ut32 e;
+	for (e = set->states[0].edges; e < set->states[0].edges + set->states[0].nedges; e++) {
+		ut8 a = set->ekeys[e];
+		ut32 s = set->enext[e];
+		set->starts[a >> 3] |= 1 << (a & 7);
+		if (set->states[s].nout || !set->states[s].nedges) {
+			// an anchor of a single byte, any byte can follow it
+			for (c = 0; c < 256; c++) {
+				pairs[(a << 5) | (c >> 3)] |= 1 << (c & 7);
+			}
+			npairs += 256;
+		}
+		ut32 f;
+		for (f = set->states[s].edges; f < set->states[s].edges + set->states[s].nedges; f++) {
+			ut8 b = set->ekeys[f];
+			for (c = 0; c < 256; c++) {
+				if (set->fold[c] == b) {
+					pairs[(a << 5) | (c >> 3)] |= 1 << (c & 7);
+					npairs++;
+				}
+			}
+		}
+	}
+	// the raw bytes starting an anchor
+	int first = -1;
+	for (c = 0; c < 256; c++) {
+		if (set->starts[set->fold[c] >> 3] & (1 << (set->fold[c] & 7))) {
+			first = c;
+			nfirst++;
+		}
+	}
+	set->first = nfirst == 1? first: -1;
+	if (npairs <= KWSET_PAIRS_MAX) {
+		set->pairs = pairs;
+	} else {
+		free (pairs);
+	}
+}
+
+RZ_IPI RzSearchKwSet *rz_search_kwset_new(RzList *kws) {
+	rz_return_val_if_fail (kws, NULL);
+	RzSearchKwSet *set = RZ_NEW0 (RzSearchKwSet);
+	if (!set) {
+		return NULL;
+	}
+	RzVector nodes, outs;
+	rz_vector_init (&nodes, sizeof (KwsetNode), NULL, NULL);
+	rz_vector_init (&outs, sizeof (KwsetOut), NULL, NULL);
+	KwsetNode root = { 0 };
+	rz_vector_push (&nodes, &root);
+	RzListIter *iter;
+	RzSearchKeyword *kw;
+	int c, idx = 0;
+	bool icase = false;
+	rz_list_foreach (kws, iter, kw) {
+		icase |= kw->icase;
+	}
+	for (c = 0; c < 256; c++) {
+		set->fold[c] = icase? tolower (c): c;
+	}
+	set->nkws = rz_list_length (kws);
+	set->anchored = RZ_NEWS0 (bool, RZ_MAX (set->nkws, 1));
+	if (!set->anchored) {
+		goto fail;
+	}
+	rz_list_foreach (kws, iter, kw) {
+		int j, len, anchor = kw_anchor (kw, &len);
+		if (anchor < 0) {
+			idx++;
+			continue;
+		}
+		ut32 node = 0;
+		for (j = 0; j < len; j++) {
+			if (!(node = trie_child (&nodes, node, set->fold[kw->bin_keyword[anchor + j]]))) {
+				goto fail;
+			}
+		}
+		KwsetOut o = { node, { kw, idx, kw->keyword_length, anchor, len } };
+		if (!rz_vector_push (&outs, &o)) {
+			goto fail;
+		}
+		set->anchored[idx++] = true;
+	}
+	if (!kwset_build (set, &nodes, &outs)) {
+		goto fail;
+	}
+	kwset_prefilter (set);
+	rz_vector_fini (&nodes);
+	rz_vector_fini (&outs);
+	return set;
+fail:
+	rz_vector_fini (&nodes);
+	rz_vector_fini (&outs);
+	rz_search_kwset_free (set);
+	return NULL;
+}
+
+RZ_IPI void rz_search_kwset_free(RzSearchKwSet *set) {
+	if (!set) {
+		return;
+	}
+	free (set->states);
+	free (set->dense);
+	free (set->ekeys);
+	free (set->enext);
+	free (set->outs);
+	free (set->anchored);
+	free (set->pairs);
+	free (set);
+}
+
+// whether the idx-th keyword is matched by rz_search_kwset_scan
+RZ_IPI bool rz_search_kwset_anchored(RzSearchKwSet *set, int idx) {
+	return idx >= 0 && idx < set->nkws && set->anchored[idx];
+}
+
+// first offset from i where an anchor can start
+static int kwset_skip(const RzSearchKwSet *set, const ut8 *buf, int i, int len) {
+	if (set->first >= 0) {
+		const ut8 *p = memchr (buf + i, set->first, len - i);
+		return p? p - buf: len;
+	}
+	const ut8 *pairs = set->pairs;
+	const ut8 *fold = set->fold;
+	for (; i + 1 < len; i++) {
+		ut8 a = fold[buf[i]];
+		if (pairs[(a << 5) | (buf[i + 1] >> 3)] & (1 << (buf[i + 1] & 7))) {
+			return i;
+		}
+	}
+	// the last byte can only be a whole anchor
+	return i;
+}
+
+/**
+ * Calls cb with the offset in buf of every possible match of the anchored
+ * keywords that fits in buf, in increasing order of the end of their anchor.
+ */
+RZ_IPI void rz_search_kwset_scan(RzSearchKwSet *set, const ut8 *buf, int len, RzSearchKwSetCallback cb, void *user) {
+	const bool skip = set->first >= 0 || set->pairs;
+	const ut8 *fold = set->fold;
+	ut32 s = 0;
+	int i;
+	if (!set->nstates || set->states[0].nedges == 0) {
+		return;
+	}
+	for (i = 0; i < len; i++) {
+		if (!s && skip) {
+			i = kwset_skip (set, buf, i, len);
+			if (i >= len) {
+				break;
+			}
+		}
+		s = kwset_step (set, s, fold[buf[i]]);
+		ut32 o = set->states[s].nout? s: set->states[s].dict;
+		while (o) {
+			const KwsetState *st = &set->states[o];
+			ut32 k;
+			for (k = st->out; k < st->out + st->nout; k++) {
+				const KwsetEntry *e = &set->outs[k];
+				int start = i + 1 - e->len - e->anchor;
+				if (start >= 0 && start + e->kwlen <= len) {
+					cb (user, e->kw, e->idx, start);
+				}
+			}
+			o = st->dict;
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include <rz_search.h>
 #include <rz_list.h>
 #include <ctype.h>
+#include "search_private.h"
 
 // Experimental search engine (fails, because stops at first hit of every block read
 #define USE_BMH 0
@@ -54,6 +55,7 @@ RZ_API RzSearch *rz_search_free(RzSearch *s) {
 	}
 	rz_list_free (s->hits);
 	rz_list_free (s->kws);
+	rz_search_kwset_free (s->kwset);
 	//rz_io_free(s->iob.io); this is supposed to be a weak reference
 	free (s->data);
 	free (s);
@@ -99,6 +101,8 @@ RZ_API int rz_search_begin(RzSearch *s) {
 		kw->count = 0;
 		kw->last = 0;
 	}
+	rz_search_kwset_free (s->kwset);
+	s->kwset = s->mode == RZ_SEARCH_KEYWORD? rz_search_kwset_new (s->kws): NULL;
 	return true;
 }
 
@@ -355,12 +359,77 @@ static bool brute_force_match(RzSearch *s, RzSearchKeyword *kw, const ut8 *buf,
 	return j == kw->keyword_length;
 }
 
+// matches found by s->kwset in a block
+typedef struct {
+	RzSearch *s;
+	RzVector cands; // SearchCand
+	const ut8 *data;
+	int region; // 0 for the leftover of the previous block, 1 for the block
+	int limit; // matches must start before it
+	size_t cur; // next candidate to look at
+} SearchScan;
+
+typedef struct {
+	int kw;
+	int region;
+	int at;
+} SearchCand;
+
+static int cand_cmp(const void *a, const void *b) {
+	const SearchCand *x = a, *y = b;
+	if (x->kw != y->kw) {
+		return x->kw - y->kw;
+	}
+	if (x->region != y->region) {
+		return x->region - y->region;
+	}
+	return x->at - y->at;
+}
+
+static void scan_cb(void *user, RzSearchKeyword *kw, int kwidx, int at) {
+	SearchScan *sc = user;
+	if (at < sc->limit && brute_force_match (sc->s, kw, sc->data, at)) {
+		SearchCand c = { kwidx, sc->region, at };
+		rz_vector_push (&sc->cands, &c);
+	}
+}
+
+static void scan_region(SearchScan *sc, int region, const ut8 *data, int len, int limit) {
+	sc->data = data;
+	sc->region = region;
+	sc->limit = limit;
+	rz_search_kwset_scan (sc->s->kwset, data, len, scan_cb, sc);
+}
+
+// first match of kw in data from i and before end, -1 if none
+static int next_match(RzSearch *s, SearchScan *sc, RzSearchKeyword *kw, int kwidx, int region, const ut8 *data, int i, int end) {
+	if (sc && rz_search_kwset_anchored (s->kwset, kwidx)) {
+		SearchCand *c = NULL;
+		while (sc->cur < rz_vector_len (&sc->cands)) {
+			c = rz_vector_index_ptr (&sc->cands, sc->cur);
+			if (c->kw > kwidx || (c->kw == kwidx && (c->region > region || (c->region == region && c->at >= i)))) {
+				break;
+			}
+			c = NULL;
+			sc->cur++;
+		}
+		return c && c->kw == kwidx && c->region == region && c->at < end? c->at: -1;
+	}
+	for (; i < end; i++) {
+		if (brute_force_match (s, kw, data, i) != s->inverse) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 // Supported search variants: backward, binmask, icase, inverse, overlap
 RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, int len) {
 	RzSearchKeyword *kw;
 	RzListIter *iter;
 	RzSearchLeftover *left;
-	int longest = 0, i;
+	SearchScan scan, *sc = NULL;
+	int longest = 0, i, idx = 0, ret;
 	const int old_nhits = s->nhits;
 
 	rz_list_foreach (s->kws, iter, kw) {
@@ -394,43 +463,64 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 
 	ut64 len1 = left->len + RZ_MIN (longest - 1, len);
 	memcpy (left->data + left->len, buf, len1 - left->len);
+	// find the candidates of all the keywords at once, they are then
+	// consumed keyword by keyword as the brute force search would
+	if (!s->inverse && !s->distance) {
+		if (!s->kwset) {
+			s->kwset = rz_search_kwset_new (s->kws);
+		}
+		if (s->kwset) {
+			sc = &scan;
+			sc->s = s;
+			sc->cur = 0;
+			rz_vector_init (&sc->cands, sizeof (SearchCand), NULL, NULL);
+			scan_region (sc, 0, left->data, len1, left->len);
+			scan_region (sc, 1, buf, len, len);
+			if (!rz_vector_empty (&sc->cands)) {
+				qsort (sc->cands.a, sc->cands.len, sc->cands.elem_size, cand_cmp);
+			}
+		}
+	}
 	rz_list_foreach (s->kws, iter, kw) {
+		int end = (int)RZ_MIN ((st64)left->len, (st64)len1 - (st64)kw->keyword_length + 1);
 		i = s->overlap || !kw->count ? 0 :
 				s->bckwrds
 				? kw->last - from < left->len ? from + left->len - kw->last : 0
 				: from - kw->last < left->len ? kw->last + left->len - from : 0;
-		for (; i + kw->keyword_length <= len1 && i < left->len; i++) {
-			if (brute_force_match (s, kw, left->data, i) != s->inverse) {
-				int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
+		for (; (i = next_match (s, sc, kw, idx, 0, left->data, i, end)) >= 0; i++) {
+			int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i + left->len : from + i - left->len);
+			if (!t) {
+				ret = -1;
+				goto beach;
+			}
+			if (t > 1) {
+				ret = s->nhits - old_nhits;
+				goto beach;
+			}
+			if (!s->overlap) {
+				i += kw->keyword_length - 1;
 			}
 		}
+		end = len - (int)kw->keyword_length + 1;
 		i = s->overlap || !kw->count ? 0 :
 				s->bckwrds
 				? from > kw->last ? from - kw->last : 0
 				: from < kw->last ? kw->last - from : 0;
-		for (; i + kw->keyword_length <= len; i++) {
-			if (brute_force_match (s, kw, buf, i) != s->inverse) {
-				int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
-				if (!t) {
-					return -1;
-				}
-				if (t > 1) {
-					return s->nhits - old_nhits;
-				}
-				if (!s->overlap) {
-					i += kw->keyword_length - 1;
-				}
+		for (; (i = next_match (s, sc, kw, idx, 1, buf, i, end)) >= 0; i++) {
+			int t = rz_search_hit_new (s, kw, s->bckwrds ? from - kw->keyword_length - i : from + i);
+			if (!t) {
+				ret = -1;
+				goto beach;
+			}
+			if (t > 1) {
+				ret = s->nhits - old_nhits;
+				goto beach;
+			}
+			if (!s->overlap) {
+				i += kw->keyword_length - 1;
 			}
 		}
+		idx++;
 	}
 	if (len < longest - 1) {
 		if (len1 < longest) {
@@ -444,8 +534,12 @@ RZ_API int rz_search_mybinparse_update(RzSearch *s, ut64 from, const ut8 *buf, i
 		memcpy (left->data, buf + len - longest + 1, longest - 1);
 	}
 	left->end = s->bckwrds ? from - len : from + len;
-
-	return s->nhits - old_nhits;
+	ret = s->nhits - old_nhits;
+beach:
+	if (sc) {
+		rz_vector_fini (&sc->cands);
+	}
+	return ret;
 }
 
 RZ_API void rz_search_set_distance(RzSearch *s, int dist) {
@@ -511,6 +605,8 @@ RZ_API int rz_search_kw_add(RzSearch *s, RzSearchKeyword *kw) {
 	}
 	kw->kwidx = s->n_kws++;
 	rz_list_append (s->kws, kw);
+	rz_search_kwset_free (s->kwset);
+	s->kwset = NULL;
 	return true;
 }
 
@@ -519,6 +615,8 @@ RZ_API void rz_search_string_prepare_backward(RzSearch *s) {
 	RzListIter *iter;
 	RzSearchKeyword *kw;
 	// Precondition: !kw->binmask_length || kw->keyword_length % kw->binmask_length == 0
+	rz_search_kwset_free (s->kwset);
+	s->kwset = NULL;
 	rz_list_foreach (s->kws, iter, kw) {
 		ut8 *i = kw->bin_keyword, *j = kw->bin_keyword + kw->keyword_length;
 		while (i < j) {
@@ -547,4 +645,6 @@ RZ_API void rz_search_kw_reset(RzSearch *s) {
 	rz_list_purge (s->kws);
 	rz_list_purge (s->hits);
 	RZ_FREE (s->data);
+	rz_search_kwset_free (s->kwset);
+	s->kwset = NULL;
 }
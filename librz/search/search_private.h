@@ -0,0 +1,11 @@
+#ifndef _SEARCH_PRIVATE_H_
+#define _SEARCH_PRIVATE_H_
+
+typedef void (*RzSearchKwSetCallback)(void *user, RzSearchKeyword *kw, int kwidx, int offset);
+
+RZ_IPI RzSearchKwSet *rz_search_kwset_new(RzList *kws);
+RZ_IPI void rz_search_kwset_free(RzSearchKwSet *set);
+RZ_IPI bool rz_search_kwset_anchored(RzSearchKwSet *set, int idx);
+RZ_IPI void rz_search_kwset_scan(RzSearchKwSet *set, const ut8 *buf, int len, RzSearchKwSetCallback cb, void *user);
+
+#endif
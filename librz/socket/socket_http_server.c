@@ -9,23 +9,34 @@ RZ_API void rz_socket_http_server_set_breaked(bool *b) {
 	breaked = b;
 }
 
-RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOptions *so) {
-	int content_length = 0, xx, yy;
-	int pxx = 1, first = 0;
-	char buf[1500], *p, *q;
-	RzSocketHTTPRequest *hr = RZ_NEW0 (RzSocketHTTPRequest);
-	if (!hr) {
-		return NULL;
-	}
-	if (so->accept_timeout) {
-		hr->s = rz_socket_accept_timeout (s, 1);
-	} else {
-		hr->s = rz_socket_accept (s);
+// Reads a line, without its "\r\n" or "\n", returns its length or -1
+static int http_gets(RzSocket *s, char *buf, int size) {
+	int i = 0;
+	while (i < size - 1) {
+		ut8 c;
+		if (rz_socket_read (s, &c, 1) != 1) {
+			if (!i) {
+				return -1;
+			}
+			break;
+		}
+		if (c == '\n') {
+			break;
+		}
+		buf[i++] = c;
 	}
-	if (!hr->s) {
-		free (hr);
-		return NULL;
+	if (i > 0 && buf[i - 1] == '\r') {
+		i--;
 	}
+	buf[i] = 0;
+	return i;
+}
+
+static bool http_read(RzSocketHTTPRequest *hr, RzSocketHTTPOptions *so) {
+	int content_length = 0, xx;
+	bool first = true;
+	bool keepalive = false, close = false;
+	char buf[1500], *p, *q;
 	if (so->timeout > 0) {
 		rz_socket_block_time (hr->s, true, so->timeout, 0);
 	}
@@ -33,24 +44,27 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOpti
 	for (;;) {
 #if __WINDOWS__
 		if (breaked && *breaked) {
-			rz_socket_http_close (hr);
-			return NULL;
+			return false;
 		}
 #endif
-		memset (buf, 0, sizeof (buf));
-		xx = rz_socket_gets (hr->s, buf, sizeof (buf));
-		yy = rz_socket_ready (hr->s, 0, 20 * 1000); //this function uses usecs as argument
-//		eprintf ("READ %d (%s) READY %d\n", xx, buf, yy);
-		if (!yy || (!xx && !pxx)) {
+		xx = http_gets (hr->s, buf, sizeof (buf));
+		if (xx < 0) {
+			if (first) {
+				return false;
+			}
 			break;
 		}
-		pxx = xx;
-
-		if (first == 0) {
-			first = 1;
+		if (!xx) {
+			// end of the headers, a pipelined request may follow
+			if (first) {
+				continue;
+			}
+			break;
+		}
+		if (first) {
+			first = false;
 			if (strlen (buf)<3) {
-				rz_socket_http_close (hr);
-				return NULL;
+				return false;
 			}
 			p = strchr (buf, ' ');
 			if (p) {
@@ -61,6 +75,7 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOpti
 				q = strstr (p+1, " HTTP"); //strchr (p+1, ' ');
 				if (q) {
 					*q = 0;
+					hr->http11 = !strcmp (q + 1, "HTTP/1.1");
 				}
 				hr->path = strdup (p+1);
 			}
@@ -73,6 +88,9 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOpti
 				hr->host = strdup (buf + 6);
 			} else if (!strncmp (buf, "Content-Length: ", 16)) {
 				content_length = atoi (buf + 16);
+			} else if (!rz_str_ncasecmp (buf, "Connection: ", 12)) {
+				keepalive = rz_str_casestr (buf + 12, "keep-alive");
+				close = rz_str_casestr (buf + 12, "close");
 			} else if (so->httpauth && !strncmp (buf, "Authorization: Basic ", 21)) {
 				char *authtoken = buf + 21;
 				size_t authlen = strlen (authtoken);
@@ -81,7 +99,7 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOpti
 				char *decauthtoken = calloc (4, authlen + 1);
 				if (!decauthtoken) {
 					eprintf ("Could not allocate decoding buffer\n");
-					return hr;
+					return true;
 				}
 
 				if (rz_base64_decode ((ut8 *)decauthtoken, authtoken, authlen) == -1) {
@@ -102,45 +120,142 @@ RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOpti
 				}
 			}
 		}
+		// the headers come right after each other, do not wait for a
+		// client that never sends the empty line
+		if (!rz_socket_ready (hr->s, 0, 20 * 1000)) { //this function uses usecs as argument
+			break;
+		}
 	}
+	// HTTP/1.1 keeps the connection by default, HTTP/1.0 only when asked to
+	hr->keepalive = so->keepalive > 0 && (hr->http11? !close: keepalive);
 	if (content_length>0) {
-		rz_socket_read_block (hr->s, (ut8*)buf, 1); // one missing byte
 		if (ST32_ADD_OVFCHK (content_length, 1)) {
-			rz_socket_http_close (hr);
 			eprintf ("Could not allocate hr data\n");
-			return NULL;
+			return false;
 		}
 		hr->data = malloc (content_length+1);
+		if (!hr->data) {
+			return false;
+		}
 		hr->data_length = content_length;
-		rz_socket_read_block (hr->s, hr->data, hr->data_length);
+		if (rz_socket_read_block (hr->s, hr->data, hr->data_length) != content_length) {
+			hr->keepalive = false;
+		}
 		hr->data[content_length] = 0;
 	}
+	return true;
+}
+
+/* read a request from a connected client, the request owns s from now on */
+RZ_API RzSocketHTTPRequest *rz_socket_http_read(RzSocket *s, RzSocketHTTPOptions *so) {
+	rz_return_val_if_fail (s && so, NULL);
+	RzSocketHTTPRequest *hr = RZ_NEW0 (RzSocketHTTPRequest);
+	if (!hr) {
+		rz_socket_free (s);
+		return NULL;
+	}
+	hr->s = s;
+	if (!http_read (hr, so)) {
+		rz_socket_http_close (hr);
+		return NULL;
+	}
 	return hr;
 }
 
-RZ_API void rz_socket_http_response (RzSocketHTTPRequest *rs, int code, const char *out, int len, const char *headers) {
-	const char *strcode = \
-		code==200?"ok":
+RZ_API RzSocketHTTPRequest *rz_socket_http_accept (RzSocket *s, RzSocketHTTPOptions *so) {
+	RzSocket *client = so->accept_timeout
+		? rz_socket_accept_timeout (s, 1)
+		: rz_socket_accept (s);
+	if (!client) {
+		return NULL;
+	}
+	return rz_socket_http_read (client, so);
+}
+
+/* close rs and read the next request of its connection if it is kept alive,
+ * waiting up to so->keepalive seconds for it */
+RZ_API RzSocketHTTPRequest *rz_socket_http_next(RzSocketHTTPRequest *rs, RzSocketHTTPOptions *so) {
+	rz_return_val_if_fail (rs && so, NULL);
+	if (!rs->keepalive) {
+		rz_socket_http_close (rs);
+		return NULL;
+	}
+	RzSocket *s = rs->s;
+	rs->s = NULL;
+	rz_socket_http_close (rs);
+	if (rz_socket_ready (s, so->keepalive, 0) <= 0) {
+		rz_socket_free (s);
+		return NULL;
+	}
+	return rz_socket_http_read (s, so);
+}
+
+static const char *http_status(int code) {
+	return code==200?"ok":
 		code==301?"Moved permanently":
 		code==302?"Found":
 		code==401?"Unauthorized":
 		code==403?"Permission denied":
 		code==404?"not found":
+		code==500?"Internal server error":
 		"UNKNOWN";
-	if (len < 1) {
-		len = out ? strlen (out) : 0;
-	}
+}
+
+static void http_header(RzSocketHTTPRequest *rs, int code, const char *headers, const char *length) {
 	if (!headers) {
 		headers = code == 401 ? "WWW-Authenticate: Basic realm=\"R2 Web UI Access\"\n" : "";
 	}
-	rz_socket_printf (rs->s, "HTTP/1.0 %d %s\r\n%s"
-		"Connection: close\r\nContent-Length: %d\r\n\r\n",
-		code, strcode, headers, len);
+	rz_socket_printf (rs->s, "HTTP/1.%d %d %s\r\n%s"
+		"Connection: %s\r\n%s\r\n",
+		rs->http11, code, http_status (code), headers,
+		rs->keepalive? "keep-alive": "close", length);
+}
+
+RZ_API void rz_socket_http_response (RzSocketHTTPRequest *rs, int code, const char *out, int len, const char *headers) {
+	char length[32];
+	if (len < 1) {
+		len = out ? strlen (out) : 0;
+	}
+	snprintf (length, sizeof (length), "Content-Length: %d\r\n", len);
+	http_header (rs, code, headers, length);
 	if (out && len > 0) {
 		rz_socket_write (rs->s, (void *)out, len);
 	}
 }
 
+/* start a response whose body is sent with rz_socket_http_chunk () as it
+ * is produced. HTTP/1.0 clients get it unframed and the connection closed. */
+RZ_API void rz_socket_http_response_begin(RzSocketHTTPRequest *rs, int code, const char *headers) {
+	rz_return_if_fail (rs);
+	if (!rs->http11) {
+		rs->keepalive = false;
+	}
+	http_header (rs, code, headers, rs->http11? "Transfer-Encoding: chunked\r\n": "");
+	rs->chunked = rs->http11;
+}
+
+RZ_API void rz_socket_http_chunk(RzSocketHTTPRequest *rs, const char *out, int len) {
+	rz_return_if_fail (rs && (out || len < 1));
+	if (len < 1) {
+		return;
+	}
+	if (rs->chunked) {
+		rz_socket_printf (rs->s, "%x\r\n", len);
+	}
+	rz_socket_write (rs->s, (void *)out, len);
+	if (rs->chunked) {
+		rz_socket_write (rs->s, "\r\n", 2);
+	}
+}
+
+RZ_API void rz_socket_http_response_end(RzSocketHTTPRequest *rs) {
+	rz_return_if_fail (rs);
+	if (rs->chunked) {
+		rz_socket_write (rs->s, "0\r\n\r\n", 5);
+		rs->chunked = false;
+	}
+}
+
 RZ_API ut8 *rz_socket_http_handle_upload(const ut8 *str, int len, int *retlen) {
 	if (retlen) {
 		*retlen = 0;
@@ -194,6 +309,7 @@ RZ_API void rz_socket_http_close (RzSocketHTTPRequest *rs) {
 	free (rs->host);
 	free (rs->agent);
 	free (rs->method);
+	free (rs->referer);
 	free (rs->data);
 	free (rs);
 }
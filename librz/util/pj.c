@@ -7,6 +7,9 @@ static void pj_raw(PJ *j, const char *msg) {
 	rz_return_if_fail (j && msg);
 	if (*msg) {
 		rz_strbuf_append (&j->sb, msg);
+		if (j->flush && rz_strbuf_length (&j->sb) >= j->flush_size) {
+			pj_flush (j);
+		}
 	}
 }
 
@@ -67,6 +70,25 @@ RZ_API const char *pj_string(PJ *j) {
 	return j? rz_strbuf_get (&j->sb): NULL;
 }
 
+// Streams the document: once size bytes are buffered they are handed to cb
+// and dropped, so pj_string () only returns what was written since the last
+// flush. A NULL cb disables it again.
+RZ_API void pj_set_flush(PJ *j, size_t size, PJFlushCallback cb, void *user) {
+	rz_return_if_fail (j);
+	j->flush = cb;
+	j->flush_user = user;
+	j->flush_size = size;
+}
+
+RZ_API void pj_flush(PJ *j) {
+	rz_return_if_fail (j);
+	int len = rz_strbuf_length (&j->sb);
+	if (j->flush && len > 0) {
+		j->flush (rz_strbuf_get (&j->sb), len, j->flush_user);
+		rz_strbuf_set (&j->sb, "");
+	}
+}
+
 static PJ *pj_begin(PJ *j, char type) {
 	if (j) {
 		if (!j || j->level >= RZ_PRINT_JSON_DEPTH_LIMIT) {
@@ -72,7 +72,7 @@ RZ_API void rz_print_columns(RzPrint *p, const ut8 *buf, int len, int height) {
 	int rows = height > 0 ? height : 10;
 	// int realrows = rows * 2;
 	bool colors = p->flags & RZ_PRINT_FLAGS_COLOR;
-	RzConsPrintablePalette *pal = &p->cons->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	const char *vline = p->cons->use_utf8 ? RUNE_LINE_VERT : "|";
 	const char *block = p->cons->use_utf8 ? UTF_BLOCK : "#";
 	const char *kol[5];
@@ -428,7 +428,7 @@ RZ_API void rz_print_addr(RzPrint *p, ut64 addr) {
 		0
 	};
 	const char *white = "";
-#define PREOFF(x) (p && p->cons && p->cons->context && p->cons->context->pal.x)? p->cons->context->pal.x
+#define PREOFF(x) (p && p->cons && rz_cons_context () && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 	PrintfCallback printfmt = (PrintfCallback) (p? p->cb_printf: libc_printf);
 #define print(x) printfmt("%s", x)
 	bool use_segoff = p? (p->flags & RZ_PRINT_FLAGS_SEGOFF): false;
@@ -526,7 +526,7 @@ RZ_API char* rz_print_hexpair(RzPrint *p, const char *str, int n) {
 	int ch, i;
 
 	if (colors) {
-#define P(x) (p->cons && p->cons->context->pal.x)? p->cons->context->pal.x
+#define P(x) (p->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 		color_0x00 = P (b0x00): Color_GREEN;
 		color_0x7f = P (b0x7f): Color_YELLOW;
 		color_0xff = P (b0xff): Color_RED;
@@ -600,7 +600,7 @@ RZ_API char* rz_print_hexpair(RzPrint *p, const char *str, int n) {
 }
 
 static char colorbuffer[64];
-#define P(x) (p->cons && p->cons->context->pal.x)? p->cons->context->pal.x
+#define P(x) (p->cons && rz_cons_context ()->pal.x)? rz_cons_context ()->pal.x
 RZ_API const char *rz_print_byte_color(RzPrint *p, int ch) {
 	if (p->flags & RZ_PRINT_FLAGS_RAINBOW) {
 		// EXPERIMENTAL
@@ -727,7 +727,7 @@ static bool isAllZeros(const ut8 *buf, int len) {
 	return true;
 }
 
-#define Pal(x,y) (x->cons && x->cons->context->pal.y)? x->cons->context->pal.y
+#define Pal(x,y) (x->cons && rz_cons_context ()->pal.y)? rz_cons_context ()->pal.y
 RZ_API void rz_print_hexii(RzPrint *rp, ut64 addr, const ut8 *buf, int len, int step) {
 	PrintfCallback p = (PrintfCallback) rp->cb_printf;
 	bool c = rp->flags & RZ_PRINT_FLAGS_COLOR;
@@ -1030,7 +1030,7 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 	bool isPxr = (p && p->flags & RZ_PRINT_FLAGS_REFS);
 
 	for (i = j = 0; i < len; i += (stride? stride: inc)) {
-		if (p && p->cons && p->cons->context && p->cons->context->breaked) {
+		if (p && p->cons && rz_cons_context () && rz_cons_context ()->breaked) {
 			break;
 		}
 		rowbytes = inc;
@@ -1126,7 +1126,7 @@ RZ_API void rz_print_hexdump(RzPrint *p, ut64 addr, const ut8 *buf, int len, int
 					// stub for colors
 					if (p && p->colorfor) {
 						if (!p->iob.addr_is_mapped (p->iob.io, addr + j)) {
-							a = p->cons->context->pal.ai_unmap;
+							a = rz_cons_context ()->pal.ai_unmap;
 						} else {
 							a = p->colorfor (p->user, n, true);
 						}
@@ -1374,9 +1374,9 @@ RZ_API void rz_print_hexdump_simple(const ut8 *buf, int len) {
 static const char* getbytediff(RzPrint *p, char *fmt, ut8 a, ut8 b) {
 	if (*fmt) {
 		if (a == b) {
-			sprintf (fmt, "%s%02x" Color_RESET, p->cons->context->pal.graph_true, a);
+			sprintf (fmt, "%s%02x" Color_RESET, rz_cons_context ()->pal.graph_true, a);
 		} else {
-			sprintf (fmt, "%s%02x" Color_RESET, p->cons->context->pal.graph_false, a);
+			sprintf (fmt, "%s%02x" Color_RESET, rz_cons_context ()->pal.graph_false, a);
 		}
 	} else {
 		sprintf (fmt, "%02x", a);
@@ -1388,9 +1388,9 @@ static const char* getchardiff(RzPrint *p, char *fmt, ut8 a, ut8 b) {
 	char ch = IS_PRINTABLE (a)? a: '.';
 	if (*fmt) {
 		if (a == b) {
-			sprintf (fmt, "%s%c" Color_RESET, p->cons->context->pal.graph_true, ch);
+			sprintf (fmt, "%s%c" Color_RESET, rz_cons_context ()->pal.graph_true, ch);
 		} else {
-			sprintf (fmt, "%s%c" Color_RESET, p->cons->context->pal.graph_false, ch);
+			sprintf (fmt, "%s%c" Color_RESET, rz_cons_context ()->pal.graph_false, ch);
 		}
 	} else {
 		sprintf (fmt, "%c", ch);
@@ -1653,7 +1653,7 @@ RZ_API void rz_print_zoom_buf(RzPrint *p, void *user, RzPrintZoomCallback cb, ut
 
 		// TODO: memoize blocks
 		for (i = 0; i < len; i++) {
-			if (p->cons->context->breaked) {
+			if (rz_cons_context ()->breaked) {
 				break;
 			}
 			p->iob.read_at (p->iob.io, from + j, bufz2, size);
@@ -1680,7 +1680,7 @@ RZ_API void rz_print_zoom(RzPrint *p, void *user, RzPrintZoomCallback cb, ut64 f
 }
 
 static inline void printHistBlock (RzPrint *p, int k, int cols) {
-	RzConsPrintablePalette *pal = &p->cons->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	const char *h_line = p->cons->use_utf8 ? RUNE_LONG_LINE_HORIZ : "-";
 	const char *block = p->cons->use_utf8 ? UTF_BLOCK : "#";
 	const char *kol[5];
@@ -1863,7 +1863,7 @@ RZ_API void rz_print_2bpp_tiles(RzPrint *p, ut8 *buf, ut32 tiles) {
 
 // probably move somewhere else. RzPrint doesnt needs to know about the RZ_ANALYSIS_ enums
 RZ_API const char* rz_print_color_op_type(RzPrint *p, ut32 analysis_type) {
-	RzConsPrintablePalette *pal = &p->cons->context->pal;
+	RzConsPrintablePalette *pal = &rz_cons_context ()->pal;
 	switch (analysis_type & RZ_ANALYSIS_OP_TYPE_MASK) {
 	case RZ_ANALYSIS_OP_TYPE_NOP:
 		return pal->nop;
@@ -1997,7 +1997,7 @@ RZ_API char* rz_print_colorize_opcode(RzPrint *print, char *p, const char *reg,
 	int is_jmp = p && (*p == 'j' || ((*p == 'c') && (p[1] == 'a')))? 1: 0;
 	ut32 opcode_sz = p && *p? strlen (p) * 10 + 1: 0;
 	char previous = '\0';
-	const char *color_flag = print->cons->context->pal.flag;
+	const char *color_flag = rz_cons_context ()->pal.flag;
 
 	if (!p || !*p) {
 		return NULL;
@@ -2081,7 +2081,7 @@ RZ_API char* rz_print_colorize_opcode(RzPrint *print, char *p, const char *reg,
 				j += strlen (reset);
 				o[j] = p[i];
 				if (!(p[i+1] == '$' || ((p[i+1] > '0') && (p[i+1] < '9')))) {
-					const char *color = found_var ? print->cons->context->pal.func_var_type : reg;
+					const char *color = found_var ? rz_cons_context ()->pal.func_var_type : reg;
 					ut32 color_len = strlen (color);
 					if (color_len + j + 10 >= COLORIZE_BUFSIZE) {
 						eprintf ("rz_print_colorize_opcode(): buffer overflow!\n");
@@ -190,6 +190,20 @@ RZ_API bool rz_th_setaffinity(RzThread *th, int cpuid) {
 	return true;
 }
 
+// Number of cpus online, at least 1
+RZ_API int rz_th_cpu_count(void) {
+#if __WINDOWS__
+	SYSTEM_INFO info;
+	GetSystemInfo (&info);
+	return RZ_MAX ((int)info.dwNumberOfProcessors, 1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf (_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (int)n : 1;
+#else
+	return 1;
+#endif
+}
+
 RZ_API RzThread *rz_th_new(RZ_TH_FUNCTION(fun), void *user, int delay) {
 	RzThread *th = RZ_NEW0 (RzThread);
 	if (th) {
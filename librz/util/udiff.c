@@ -169,215 +169,9 @@ RZ_API int rz_diff_buffers(RzDiff *d, const ut8 *a, ut32 la, const ut8 *b, ut32
 
 RZ_API bool rz_diff_buffers_distance_levenstein(RzDiff *d, const ut8 *a, ut32 la, const ut8 *b, ut32 lb, ut32 *distance, double *similarity) {
 	rz_return_val_if_fail (a && b, false);
-	const bool verbose = d? d->verbose: false;
-	/*
-	More memory efficient version on Levenshtein Distance from:
-	https://en.wikipedia.org/wiki/Levenshtein_distance
-	http://www.codeproject.com/Articles/13525/Fast-memory-efficient-Levenshtein-algorithm
-	ObM..
-
-	8/July/2016 - More time efficient Levenshtein Distance. Now runs in about O(N*sum(MDistance)) instead of O(NM)
-	In real world testing the speedups for similar files are immense. Processing of
-	rz_diff -sV routerA/firmware_extract/bin/httpd routerB/firmware_extract/bin/httpd
-	reduced from 28 hours to about 13 minutes.
-	*/
-	int i, j;
-	const ut8 *aBufPtr;
-	const ut8 *bBufPtr;
-	ut32 aLen;
-	ut32 bLen;
-
-	// temp pointer will be used to switch v0 and v1 after processing the inner loop.
-	int *temp;
-	int *v0, *v1;
-
-	// We need these variables outside the context of the loops as we need to
-	// survive multiple loop iterations.
-	// start and stop are used in our inner loop
-	// colMin tells us the current 'best' edit distance.
-	// extendStop & extendStart are used when we get 'double up' edge conditions
-	// that require us to keep some more data.
-	int start = 0;
-	int stop = 0;
-	int smallest;
-	int colMin = 0;
-	int extendStop = 0;
-	int extendStart = 0;
-
-	//we could move cost into the 'i' loop.
-	int cost = 0;
-
-	// loops can get very big, this can be removed, but it's currently in there for debugging
-	// and optimisation testing.
-	ut64 loops = 0;
-
-	// We need the longest file to be 'A' because our optimisation tries to stop and start
-	// around the diagonal.
-	//  AAAAAAA
-	// B*
-	// B *
-	// B  *____
-	// if we have them the other way around and we terminate on the diagonal, we won't have
-	// inspected all the bytes of file B..
-	//  AAAA
-	// B*
-	// B *
-	// B  *
-	// B   *
-	// B   ?
-
-	if (la < lb) {
-		aBufPtr = b;
-		bBufPtr = a;
-		aLen = lb;
-		bLen = la;
-	} else {
-		aBufPtr = a;
-		bBufPtr = b;
-		aLen = la;
-		bLen = lb;
-	}
-	stop = bLen;
-	// Preliminary tests
-
-	// one or both buffers empty?
-	if (aLen == 0 || bLen == 0) {
-		if (distance) {
-			*distance = RZ_MAX (aLen, bLen);
-		}
-		if (similarity) {
-			*similarity = aLen == bLen? 1.0: 0.0;
-		}
-		return true;
-	}
-
-	//IF the files are the same size and are identical, then we have matching files
-	if (aLen == bLen && !memcmp (aBufPtr, bBufPtr, aLen)) {
-		if (distance) {
-			*distance = 0;
-		}
-		if (similarity) {
-			*similarity = 1.0;
-		}
-		return true;
-	}
-	// Only calloc if we have to do some processing
-
-	// calloc v0 & v1 and check they initialised
-	v0 = (int*) calloc ((bLen + 3), sizeof (int));
-	if (!v0) {
-		eprintf ("Error: cannot allocate %i bytes.", bLen + 3);
-		return false;
-	}
-
-	v1 = (int*) calloc ((bLen + 3), sizeof (int));
-	if (!v1) {
-		eprintf ("Error: cannot allocate %i bytes", 2 * (bLen + 3));
-		free (v0);
-		return false;
-	}
-
-	// initialise v0 and v1.
-	// With optimisiation we only strictly we only need to initialise v0[0..2]=0..2 & v1[0] = 1;
-	for (i = 0; i < bLen + 1 ; i++) {
-		v0[i] = i;
-		v1[i] = i + 1;
-	}
-
-	// Outer loop = the length of the longest input file.
-	for (i = 0; i < aLen; i++) {
-
-		// We're going to stop the inner loop at:
-		// bLen (so we don't run off the end of our array)
-		// or 'two below the diagonal' PLUS any extension we need for 'double up' edge values
-		// (see extendStop for logic)
-		stop = RZ_MIN ((i + extendStop + 2), bLen);
-
-		// We need a value in the result column (v1[start]).
-		// If you look at the loop below, we need it because we look at v1[j] as one of the
-		// potential shortest edit distances.
-		// In all cases where the edit distance can't 'reach',
-		// the value of v1[start] simply increments.
-		if (start > bLen) {
-			break;
-		}
-		v1[start] = v0[start] + 1;
-
-		// need to have a bigger number in colMin than we'll ever encounter in the inner loop
-		colMin = aLen;
-
-		// Inner loop does all the work:
-		for (j = start; j <= stop; j++) {
-			loops++;
-
-			// The main levenshtein comparison:
-			cost = (aBufPtr[i] == bBufPtr[j]) ? 0 : 1;
-			smallest = RZ_MIN ((v1[j] + 1), (v0[j + 1] + 1));
-			smallest = RZ_MIN (smallest, (v0[j] + cost));
-
-			// populate the next two entries in v1.
-			// only really required if this is the last loop.
-			if (j + 2 > bLen + 3) {
-				break;
-			}
-			v1[j + 1] = smallest;
-			v1[j + 2] = smallest + 1;
-
-			// If we have seen a smaller number, it's the new column Minimum
-			colMin = RZ_MIN ((colMin), (smallest));
-
-		}
-
-		// We're going to start at i+1 next iteration
-		// The column minimum is the current edit distance
-		// This distance is the minimum 'search width' from the optimal 'i' diagonal
-		// The extendStart picks up an edge case where we have a match on the first iteration
-		// We update extendStart after we've set start for the next iteration.
-		start = i + 1 - colMin - extendStart;
-
-		// If the last processed entry is a match, AND
-		// the current byte in 'a' and the previous processed entry in 'b' aren't a match
-		// then we need to extend our search below the optimal 'i' diagonal. because we'll
-		// have a vertical double up condition in our last two values of the results column.
-		// j-2 is used because j++ increments prior to loop exit in the processing loop above.
-		if (!cost && aBufPtr[i] != bBufPtr[j - 2]) {
-			extendStop ++;
-		}
-
-		// If new start would be a match then we have a horizontal 'double up'
-		// which means we need to keep an extra row of data
-		// so don't increment the start counter this time, BUT keep
-		// extendStart up our sleeves for next iteration.
-		if (i + 1 < aLen && start < bLen && aBufPtr[i + 1] == bBufPtr[start]) {
-			start --;
-			extendStart ++;
-		}
-		//Switch v0 and v1 pointers via temp pointer
-		temp = v0;
-		v0 = v1;
-		v1 = temp;
-
-		//Print a processing update every 10K of outer loop
-		if (verbose && i % 10000==0) {
-			eprintf ("\rProcessing %d of %d\r", i, aLen);
-		}
-	}
-	//Clean up output on loop exit (purely aesthetic)
-	if (verbose) {
-		eprintf ("\rProcessing %d of %d (loops=%"PFMT64d")\n", i, aLen,loops);
-	}
-	if (distance) {
-		// the final distance is the last byte we processed in the inner loop.
-		// v0 is used instead of v1 because we switched the pointers before exiting the outer loop
-		*distance = v0[stop];
-	}
-	if (similarity) {
-		double diff = (double) (v0[stop]) / (double) (RZ_MAX (aLen, bLen));
-		*similarity = (double)1 - diff;
-	}
-	free (v0);
-	free (v1);
-	return true;
+	// the bit-vector kernel is exact and faster than the old diagonal
+	// cutoff heuristic this used to be
+	return rz_diff_buffers_distance_original (d, a, la, b, lb, distance, similarity);
 }
 
 // Eugene W. Myers' O(ND) diff algorithm
@@ -437,6 +231,140 @@ out:
 	return true;
 }
 
+// Above this many bytes in the shorter buffer the match masks of the
+// bit-vector kernel (2KB per 64 bytes) are not worth it, use the plain DP
+#define BITVECTOR_MAX_LEN (1 << 21)
+
+// Advances one 64 rows block of the bit-vector DP by one column, hin is
+// the horizontal delta entering at the top. Returns the horizontal delta
+// at row bit of the block, which is the one leaving at the bottom for
+// bit 63.
+static inline int bitvector_block(ut64 *pv, ut64 *mv, ut64 eq, int hin, int bit) {
+	ut64 Pv = *pv, Mv = *mv;
+	ut64 hneg = hin < 0;
+	ut64 Xv = eq | Mv;
+	eq |= hneg;
+	ut64 Xh = (((eq & Pv) + Pv) ^ Pv) | eq;
+	ut64 Ph = Mv | ~(Xh | Pv);
+	ut64 Mh = Pv & Xh;
+	int hout = (int)((Ph >> bit) & 1) - (int)((Mh >> bit) & 1);
+	Ph = (Ph << 1) | (hin > 0);
+	Mh = (Mh << 1) | hneg;
+	*pv = Mh | ~(Xv | Ph);
+	*mv = Ph & Xv;
+	return hout;
+}
+
+/*
+ * Levenshtein distance of a (la > 0) and b with Myers' bit-vector
+ * algorithm, in the multi-word form of Hyyrö: every column of the DP
+ * costs one pass over ceil(la / 64) words instead of la cells.
+ *
+ * When the distance is known to exceed k, *distance is set to k + 1 and
+ * the computation stops. Rows below the diagonal band of width k are
+ * only added when the band reaches them (Ukkonen), so a small k also
+ * means less work per column.
+ */
+static bool distance_bitvector(const ut8 *a, ut32 la, const ut8 *b, ut32 lb, ut32 k, bool verbose, ut32 *distance) {
+	const ut32 nblocks = (la + 63) / 64;
+	const int lastbit = (la - 1) % 64;
+	const bool banded = (ut64)k < (ut64)la + lb;
+	ut64 *peq = calloc ((size_t)nblocks * 256, sizeof (ut64));
+	ut64 *pv = malloc (nblocks * sizeof (ut64));
+	ut64 *mv = malloc (nblocks * sizeof (ut64));
+	st64 *score = malloc (nblocks * sizeof (st64));
+	ut32 i, j, w, last;
+	bool ret = false;
+	if (!peq || !pv || !mv || !score) {
+		goto beach;
+	}
+	for (i = 0; i < la; i++) {
+		peq[(size_t)a[i] * nblocks + i / 64] |= 1ULL << (i % 64);
+	}
+	// first column, D[i][0] = i
+	for (w = 0; w < nblocks; w++) {
+		pv[w] = UT64_MAX;
+		mv[w] = 0;
+		score[w] = RZ_MIN ((st64)w * 64 + 64, (st64)la);
+	}
+	last = RZ_MIN ((ut64)k / 64, nblocks - 1);
+	for (j = 0; j < lb; j++) {
+		// rows deeper than j + 1 + k cannot be on a path within k
+		ut64 need = ((ut64)j + k) / 64;
+		while (last + 1 < nblocks && last + 1 <= need) {
+			// still the first column, taken as the previous one: the
+			// values are upper bounds, exact wherever they are <= k
+			last++;
+			score[last] = score[last - 1] + RZ_MIN ((st64)last * 64 + 64, (st64)la) - (st64)last * 64;
+		}
+		const ut64 *eq = peq + (size_t)b[j] * nblocks;
+		int h = 1; // D[0][j + 1] - D[0][j]
+		for (w = 0; w <= last; w++) {
+			h = bitvector_block (&pv[w], &mv[w], eq[w], h, w == nblocks - 1 ? lastbit : 63);
+			score[w] += h;
+		}
+		if (banded && (j & 15) == 15) {
+			// every path crosses this column at some row i, from there
+			// it still needs |(la - i) - (lb - j - 1)| edits
+			st64 c = (st64)la - lb + j + 1, bound = ST64_MAX;
+			for (w = 0; w <= last; w++) {
+				st64 lo = w ? (st64)w * 64 + 1 : 0;
+				st64 bottom = RZ_MIN ((st64)w * 64 + 64, (st64)la);
+				st64 v = score[w] - bottom + (c >= lo ? c : 2 * lo - c);
+				bound = RZ_MIN (bound, v);
+			}
+			if (bound > (st64)k) {
+				*distance = k + 1;
+				ret = true;
+				goto beach;
+			}
+		}
+		if (verbose && j % 100000 == 0) {
+			eprintf ("\rProcessing %" PFMT32u " of %" PFMT32u "\r", j, lb);
+		}
+	}
+	if (verbose) {
+		eprintf ("\n");
+	}
+	*distance = last == nblocks - 1 ? (ut32)RZ_MIN (score[last], (st64)k + 1) : k + 1;
+	ret = true;
+beach:
+	free (peq);
+	free (pv);
+	free (mv);
+	free (score);
+	return ret;
+}
+
+// Two rows Levenshtein DP, for when the bit-vector masks would be too big
+static bool distance_dp(const ut8 *a, ut32 la, const ut8 *b, ut32 lb, bool verbose, ut32 *distance) {
+	ut32 *d, i, j;
+	if (sizeof (ut32) > SIZE_MAX / (lb + 1) || !(d = malloc ((lb + 1) * sizeof (ut32)))) {
+		return false;
+	}
+	for (i = 0; i <= lb; i++) {
+		d[i] = i;
+	}
+	for (i = 0; i < la; i++) {
+		ut32 ul = d[0];
+		d[0] = i + 1;
+		for (j = 0; j < lb; j++) {
+			ut32 u = d[j + 1];
+			d[j + 1] = a[i] == b[j] ? ul : RZ_MIN (ul, RZ_MIN (d[j], u)) + 1;
+			ul = u;
+		}
+		if (verbose && i % 10000 == 0) {
+			eprintf ("\rProcessing %" PFMT32u " of %" PFMT32u "\r", i, la);
+		}
+	}
+	if (verbose) {
+		eprintf ("\n");
+	}
+	*distance = d[lb];
+	free (d);
+	return true;
+}
+
 RZ_API bool rz_diff_buffers_distance_original(RzDiff *diff, const ut8 *a, ut32 la, const ut8 *b, ut32 lb, ut32 *distance, double *similarity) {
 	if (!a || !b) {
 		return false;
@@ -445,14 +373,14 @@ RZ_API bool rz_diff_buffers_distance_original(RzDiff *diff, const ut8 *a, ut32 l
 	const bool verbose = diff ? diff->verbose : false;
 	const ut32 length = RZ_MAX (la, lb);
 	const ut8 *ea = a + la, *eb = b + lb, *t;
-	ut32 *d, i, j;
+	ut32 i, d = 0, k = UT32_MAX;
 	// Strip prefix
 	for (; a < ea && b < eb && *a == *b; a++, b++) {}
 	// Strip suffix
 	for (; a < ea && b < eb && ea[-1] == eb[-1]; ea--, eb--) {}
 	la = ea - a;
 	lb = eb - b;
-	if (la < lb) {
+	if (la > lb) {
 		i = la;
 		la = lb;
 		lb = i;
@@ -461,35 +389,28 @@ RZ_API bool rz_diff_buffers_distance_original(RzDiff *diff, const ut8 *a, ut32 l
 		b = t;
 	}
 
-	if (sizeof (ut32) > SIZE_MAX / (lb + 1) || !(d = malloc ((lb + 1) * sizeof (ut32)))) {
-		return false;
+	if (diff && diff->threshold > 0 && length) {
+		// largest distance still at the threshold, plus one for rounding
+		k = (ut32)RZ_MIN ((1.0 - diff->threshold) * length + 1, (double)UT32_MAX - 1);
 	}
-	for (i = 0; i <= lb; i++) {
-		d[i] = i;
-	}
-	for (i = 0; i < la; i++) {
-		ut32 ul = d[0];
-		d[0] = i + 1;
-		for (j = 0; j < lb; j++) {
-			ut32 u = d[j + 1];
-			d[j + 1] = a[i] == b[j] ? ul : RZ_MIN (ul, RZ_MIN (d[j], u)) + 1;
-			ul = u;
-		}
-		if (verbose && i % 10000 == 0) {
-			eprintf ("\rProcessing %" PFMT32u " of %" PFMT32u "\r", i, la);
+	if (!la) {
+		d = lb;
+	} else if (lb - la > k) {
+		d = k + 1;
+	} else if (la <= BITVECTOR_MAX_LEN) {
+		if (!distance_bitvector (a, la, b, lb, k, verbose, &d)) {
+			return false;
 		}
+	} else if (!distance_dp (a, la, b, lb, verbose, &d)) {
+		return false;
 	}
 
-	if (verbose) {
-		eprintf ("\n");
-	}
 	if (distance) {
-		*distance = d[lb];
+		*distance = d;
 	}
 	if (similarity) {
-		*similarity = length ? 1.0 - (double)d[lb] / length : 1.0;
+		*similarity = length ? 1.0 - (double)d / length : 1.0;
 	}
-	free (d);
 	return true;
 }
 
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Compares the time to open binaries with and without bin.lazy, e.g.
+#   test/scripts/bench-bin-lazy.sh bins/elf/ls bins/pe/testapp-msvc64.exe bins/mach0/ls-osx-x86_64
+# Run it from test/ with the bins checked out. Every file is opened
+# RUNS times (default 5), then once more with `is` to time the first access.
+
+RUNS=${RUNS:-5}
+RIZIN=${RIZIN:-rizin}
+
+bench() {
+	start=$(date +%s%N)
+	i=0
+	while [ $i -lt "$RUNS" ]; do
+		"$RIZIN" -e "bin.lazy=$2" -qc "$3" "$1" > /dev/null 2>&1
+		i=$((i + 1))
+	done
+	end=$(date +%s%N)
+	echo $(((end - start) / RUNS / 1000000))
+}
+
+[ $# -gt 0 ] || set -- bins/elf/ls bins/pe/testapp-msvc64.exe bins/mach0/ls-osx-x86_64
+
+printf "%-40s %10s %10s %10s\n" file "eager(ms)" "lazy(ms)" "lazy+is(ms)"
+for f in "$@"; do
+	if [ ! -f "$f" ]; then
+		echo "$f: not found" >&2
+		continue
+	fi
+	printf "%-40s %10s %10s %10s\n" "$f" "$(bench "$f" false q)" "$(bench "$f" true q)" "$(bench "$f" true is)"
+done
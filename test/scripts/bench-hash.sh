@@ -0,0 +1,49 @@
+#!/bin/sh
+# Measures rz-hash throughput in ms per GB, with one algorithm, with all of
+# them and per block (-B), e.g.
+#   test/scripts/bench-hash.sh /path/to/big.img
+# Without arguments a SIZE_MB (default 1024) file of random data is made
+# in TMPDIR. Every run is repeated RUNS times (default 3).
+
+RUNS=${RUNS:-3}
+RZ_HASH=${RZ_HASH:-rz-hash}
+SIZE_MB=${SIZE_MB:-1024}
+
+bench() {
+	file=$1
+	shift
+	start=$(date +%s%N)
+	i=0
+	while [ $i -lt "$RUNS" ]; do
+		"$RZ_HASH" "$@" "$file" > /dev/null 2>&1
+		i=$((i + 1))
+	done
+	end=$(date +%s%N)
+	# the rate is computed in KB, so that files under 1MB work too
+	kb=$(($(wc -c < "$file") / 1024))
+	echo $(((end - start) / RUNS / 1000 * 1024 * 1024 / kb / 1000))
+}
+
+if [ $# -eq 0 ]; then
+	tmp="${TMPDIR:-/tmp}/bench-hash.$$"
+	dd if=/dev/urandom of="$tmp" bs=1M count="$SIZE_MB" 2> /dev/null
+	trap 'rm -f "$tmp"' EXIT
+	set -- "$tmp"
+fi
+
+printf "%-40s %12s %12s %12s %12s\n" file "sha256" "all" "md5,sha1,crc32" "-B sha256"
+for f in "$@"; do
+	if [ ! -f "$f" ]; then
+		echo "$f: not found" >&2
+		continue
+	fi
+	if [ "$(wc -c < "$f")" -lt 1024 ]; then
+		echo "$f: smaller than 1KB" >&2
+		continue
+	fi
+	printf "%-40s %12s %12s %12s %12s\n" "$f" \
+		"$(bench "$f" -a sha256)" \
+		"$(bench "$f" -a all)" \
+		"$(bench "$f" -a md5,sha1,crc32)" \
+		"$(bench "$f" -B -b 1M -a sha256)"
+done
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+# Hammers the webserver with keep-alive and pipelining clients, e.g.
+#   rizin -N -e http.port=9393 -e http.workers=4 -qq -c=h bins/elf/arg &
+#   python3 test/scripts/test-webserver-load.py -p 9393 -c 16 -n 200
+
+import argparse
+import http.client
+import socket
+import threading
+import time
+
+
+def keepalive_client(args, latencies, errors):
+    conn = http.client.HTTPConnection(args.host, args.port, timeout=30)
+    for _ in range(args.requests):
+        t = time.monotonic()
+        try:
+            conn.request("GET", "/cmd/" + args.cmd)
+            res = conn.getresponse()
+            res.read()
+            if res.status != 200:
+                errors.append(res.status)
+        except (OSError, http.client.HTTPException) as e:
+            errors.append(str(e))
+            conn.close()
+            conn = http.client.HTTPConnection(args.host, args.port, timeout=30)
+        latencies.append(time.monotonic() - t)
+    conn.close()
+
+
+def pipelined_client(args, errors):
+    req = "GET /cmd/%s HTTP/1.1\r\nHost: %s\r\n\r\n" % (args.cmd, args.host)
+    last = "GET /cmd/%s HTTP/1.1\r\nConnection: close\r\n\r\n" % args.cmd
+    with socket.create_connection((args.host, args.port), timeout=30) as s:
+        s.sendall((req * (args.pipeline - 1) + last).encode())
+        data = b""
+        while True:
+            chunk = s.recv(65536)
+            if not chunk:
+                break
+            data += chunk
+    responses = data.count(b"HTTP/1.1 200")
+    if responses != args.pipeline:
+        errors.append("pipelined %d/%d" % (responses, args.pipeline))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="rizin webserver load test")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("-p", "--port", type=int, default=9090)
+    parser.add_argument("-c", "--clients", type=int, default=8)
+    parser.add_argument("-n", "--requests", type=int, default=100, help="requests per client")
+    parser.add_argument("-P", "--pipeline", type=int, default=10, help="requests per pipelined connection")
+    parser.add_argument("--cmd", default="pd%2010")
+    args = parser.parse_args()
+
+    latencies, errors = [], []
+    threads = [threading.Thread(target=keepalive_client, args=(args, latencies, errors))
+               for _ in range(args.clients)]
+    start = time.monotonic()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.monotonic() - start
+    pipelined_client(args, errors)
+
+    latencies.sort()
+    total = len(latencies)
+    print("%d requests in %.2fs, %.1f req/s" % (total, elapsed, total / elapsed))
+    if total:
+        print("latency p50 %.1fms p99 %.1fms" % (latencies[total // 2] * 1000,
+                                                 latencies[min(total - 1, total * 99 // 100)] * 1000))
+    if errors:
+        print("%d errors, first: %s" % (len(errors), errors[0]))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
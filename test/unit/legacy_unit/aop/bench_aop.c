@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+// Linear sweep over x86-64 code with rz_analysis_op (), rz_analysis_op_lite ()
+// and rz_analysis_op_lite_batch (), counting the branches found.
+// usage: bench_aop [megabytes]
+
+#include <rz_analysis.h>
+
+// push rbp; mov rbp, rsp; sub rsp, 0x20; mov qword [rbp - 8], rdi; call $+5;
+// cmp eax, 1; jne +7; lea rax, [rip + 0x100]; mov eax, dword [rax];
+// add rsp, 0x20; leave; ret
+static const char code[] = "554889e54883ec2048897df8e80000000083f8017507488d05000100008b004883c420c9c3";
+
+typedef enum { SWEEP_OP, SWEEP_LITE, SWEEP_BATCH } Sweep;
+
+static const char *sweep_name[] = { "op", "lite", "batch" };
+
+static bool is_branch(ut32 type) {
+	switch (type & RZ_ANALYSIS_OP_TYPE_MASK) {
+	case RZ_ANALYSIS_OP_TYPE_JMP:
+	case RZ_ANALYSIS_OP_TYPE_CJMP:
+	case RZ_ANALYSIS_OP_TYPE_CALL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static double bench(RzAnalysis *analysis, const ut8 *buf, int len, Sweep sweep) {
+	ut64 ops = 0, branches = 0, t = rz_time_now_mono ();
+	int i = 0;
+	while (i < len) {
+		if (sweep == SWEEP_OP) {
+			RzAnalysisOp op;
+			int ret = rz_analysis_op (analysis, &op, i, buf + i, len - i, RZ_ANALYSIS_OP_MASK_BASIC);
+			branches += is_branch (op.type);
+			rz_analysis_op_fini (&op);
+			i += ret > 0 ? ret : 1;
+			ops++;
+		} else if (sweep == SWEEP_LITE) {
+			RzAnalysisOpLite op;
+			int ret = rz_analysis_op_lite (analysis, &op, i, buf + i, len - i);
+			branches += is_branch (op.type);
+			i += ret > 0 ? ret : 1;
+			ops++;
+		} else {
+			RzAnalysisOpLite batch[64];
+			int k, used, n = rz_analysis_op_lite_batch (analysis, batch, 64, i, buf + i, len - i, &used);
+			for (k = 0; k < n; k++) {
+				branches += is_branch (batch[k].type);
+			}
+			i += used;
+			ops += n;
+		}
+	}
+	double secs = (rz_time_now_mono () - t) / 1000000.0;
+	printf ("%-6s %10" PFMT64u " ops %9" PFMT64u " branches %8.3fs %6.1f MB/s\n",
+		sweep_name[sweep], ops, branches, secs, secs > 0 ? len / secs / (1 << 20) : 0.0);
+	return secs;
+}
+
+int main(int argc, char **argv) {
+	int mb = argc > 1 ? atoi (argv[1]) : 100;
+	ut8 snippet[64];
+	int slen = rz_hex_str2bin (code, snippet);
+	int i, len = mb << 20;
+	ut8 *buf = malloc (len);
+	if (!buf || slen < 1) {
+		return 1;
+	}
+	for (i = 0; i + slen <= len; i += slen) {
+		memcpy (buf + i, snippet, slen);
+	}
+	memset (buf + i, 0x90, len - i);
+	RzAnalysis *analysis = rz_analysis_new ();
+	rz_analysis_use (analysis, "x86");
+	rz_analysis_set_bits (analysis, 64);
+	double op = bench (analysis, buf, len, SWEEP_OP);
+	double lite = bench (analysis, buf, len, SWEEP_LITE);
+	double batch = bench (analysis, buf, len, SWEEP_BATCH);
+	if (lite > 0 && batch > 0) {
+		printf ("speedup lite %.2fx batch %.2fx\n", op / lite, op / batch);
+	}
+	rz_analysis_free (analysis);
+	free (buf);
+	return 0;
+}
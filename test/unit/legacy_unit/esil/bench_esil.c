@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+// Emulates a tight counting loop with ESIL, once with compiled expressions
+// and once with the string parser (esil->nocompile).
+// usage: bench_esil [instructions]
+
+#include <rz_core.h>
+
+typedef struct {
+	const char *name;
+	const char *arch;
+	int bits;
+	const char *code;
+	const char *counter;
+} Loop;
+
+static const Loop loops[] = {
+	// inc rax; cmp rax, rcx; jne 0
+	{ "x86", "x86", 64, "48ffc04839c875f8", "rax" },
+	// add r0, r0, 1; cmp r0, r1; bne 0
+	{ "arm", "arm", 32, "010080e2010050e1fcffff1a", "r0" },
+};
+
+static double bench(const Loop *l, ut64 count, bool nocompile) {
+	RzCore *core = rz_core_new ();
+	if (!core) {
+		return -1;
+	}
+	rz_config_set (core->config, "asm.arch", l->arch);
+	rz_config_set_i (core->config, "asm.bits", l->bits);
+	rz_core_cmd0 (core, "o malloc://0x1000 0");
+	rz_core_cmdf (core, "wx %s @ 0", l->code);
+	rz_core_cmd0 (core, "aei");
+	rz_core_cmd0 (core, "aeim");
+	rz_core_cmdf (core, "ar PC=0");
+	rz_core_cmdf (core, "ar %s=0", l->counter);
+	rz_core_cmdf (core, "ar %s=-1", !strcmp (l->arch, "arm")? "r1": "rcx");
+	core->analysis->esil->nocompile = nocompile;
+	ut64 i, t = rz_time_now_mono ();
+	for (i = 0; i < count; i++) {
+		if (!rz_core_esil_step (core, UT64_MAX, NULL, NULL, false)) {
+			eprintf ("%s: stopped after %" PFMT64u " instructions\n", l->name, i);
+			break;
+		}
+	}
+	double secs = (rz_time_now_mono () - t) / 1000000.0;
+	ut64 n = rz_reg_getv (core->analysis->reg, l->counter);
+	printf ("%s %-8s %10" PFMT64u " insns %8.3fs %12.0f insns/s (%s=0x%" PFMT64x ")\n",
+		l->name, nocompile? "string": "compiled", i, secs, secs > 0? i / secs: 0.0, l->counter, n);
+	rz_core_free (core);
+	return secs;
+}
+
+int main(int argc, char **argv) {
+	ut64 count = argc > 1? rz_num_math (NULL, argv[1]): 10000000;
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (loops); i++) {
+		double c = bench (&loops[i], count, false);
+		double s = bench (&loops[i], count, true);
+		if (c > 0) {
+			printf ("%s speedup %.2fx\n", loops[i].name, s / c);
+		}
+	}
+	return 0;
+}
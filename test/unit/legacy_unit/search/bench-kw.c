@@ -0,0 +1,64 @@
+#include <rz_search.h>
+
+// Keyword search throughput with 1, 100 and 10000 keywords.
+// usage: bench-kw [megabytes]
+
+#define BLOCK (1024 * 1024)
+
+static int hit(RzSearchKeyword *kw, void *user, ut64 addr) {
+	(*(ut64 *)user)++;
+	return 1;
+}
+
+static ut32 seed = 31337;
+
+static ut32 rnd(void) {
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static void bench(const ut8 *data, ut64 size, int nkws) {
+	RzSearch *rs = rz_search_new (RZ_SEARCH_KEYWORD);
+	ut64 hits = 0;
+	int i, j;
+	for (i = 0; i < nkws; i++) {
+		ut8 kw[8];
+		for (j = 0; j < sizeof (kw); j++) {
+			kw[j] = rnd ();
+		}
+		if (i % 16 == 0) {
+			// some of them are actually there
+			memcpy (kw, data + rnd () % (size - sizeof (kw)), sizeof (kw));
+		}
+		rz_search_kw_add (rs, rz_search_keyword_new (kw, sizeof (kw), NULL, 0, NULL));
+	}
+	rz_search_set_callback (rs, &hit, &hits);
+	ut64 t = rz_time_now_mono ();
+	rz_search_begin (rs);
+	ut64 off;
+	for (off = 0; off < size; off += BLOCK) {
+		rz_search_update (rs, off, data + off, RZ_MIN (BLOCK, size - off));
+	}
+	double secs = (rz_time_now_mono () - t) / 1000000.0;
+	printf ("%5d keywords: %8.3fs %8.1f MB/s %" PFMT64u " hits\n", nkws, secs, secs > 0? size / secs / BLOCK: 0.0, hits);
+	rz_search_free (rs);
+}
+
+int main(int argc, char **argv) {
+	ut64 size = (argc > 1? atoi (argv[1]): 256) * (ut64)BLOCK;
+	ut8 *data = malloc (size);
+	if (!data) {
+		return 1;
+	}
+	ut64 i;
+	for (i = 0; i < size; i++) {
+		data[i] = rnd ();
+	}
+	bench (data, size, 1);
+	bench (data, size, 100);
+	bench (data, size, 10000);
+	free (data);
+	return 0;
+}
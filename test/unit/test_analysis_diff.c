@@ -0,0 +1,104 @@
+#include <rz_analysis.h>
+#include "minunit.h"
+
+// Adds a function made of one block whose fingerprint is buf
+static RzAnalysisFunction *add_fcn(RzAnalysis *analysis, const char *name, ut64 addr, const ut8 *buf, size_t len) {
+	RzAnalysisFunction *fcn = rz_analysis_create_function (analysis, name, addr, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+	RzAnalysisBlock *bb = rz_analysis_create_block (analysis, addr, len);
+	bb->fingerprint = rz_mem_dup (buf, len);
+	rz_analysis_function_add_block (fcn, bb);
+	rz_analysis_block_unref (bb);
+	rz_analysis_diff_fingerprint_fcn (analysis, fcn);
+	return fcn;
+}
+
+static void fill(ut8 *buf, size_t len, ut32 seed) {
+	size_t i;
+	for (i = 0; i < len; i++) {
+		seed = seed * 1103515245 + 12345;
+		buf[i] = seed >> 16;
+	}
+}
+
+static bool test_analysis_diff_fcn(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	ut8 buf[0x40];
+
+	fill (buf, sizeof (buf), 1);
+	RzAnalysisFunction *main_a = add_fcn (a, "main", 0x1000, buf, sizeof (buf));
+	RzAnalysisFunction *main_b = add_fcn (b, "main", 0x5000, buf, sizeof (buf));
+	fill (buf, 0x30, 2);
+	RzAnalysisFunction *foo = add_fcn (a, "foo", 0x2000, buf, 0x30);
+	RzAnalysisFunction *bar = add_fcn (b, "bar", 0x6000, buf, 0x30);
+	fill (buf, 0x20, 3);
+	RzAnalysisFunction *sub_a = add_fcn (a, "sub.3000", 0x3000, buf, 0x20);
+	buf[0x10] ^= 0xff;
+	RzAnalysisFunction *sub_b = add_fcn (b, "sub.7000", 0x7000, buf, 0x20);
+	fill (buf, 0x10, 4);
+	RzAnalysisFunction *alone = add_fcn (a, "alone", 0x4000, buf, 0x10);
+
+	mu_assert_true (rz_analysis_diff_fcn (a, a->fcns, b->fcns), "diff");
+	mu_assert_eq (main_a->diff->type, RZ_ANALYSIS_DIFF_TYPE_MATCH, "same name");
+	mu_assert_eq (main_a->diff->addr, 0x5000, "same name addr");
+	mu_assert_eq (main_b->diff->addr, 0x1000, "same name addr back");
+	mu_assert_eq (foo->diff->type, RZ_ANALYSIS_DIFF_TYPE_MATCH, "same fingerprint");
+	mu_assert_eq (foo->diff->addr, 0x6000, "same fingerprint addr");
+	mu_assert_streq (foo->diff->name, "bar", "same fingerprint name");
+	mu_assert_streq (bar->diff->name, "foo", "same fingerprint name back");
+	mu_assert_neq (sub_a->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "similar");
+	mu_assert_eq (sub_a->diff->addr, 0x7000, "similar addr");
+	mu_assert_eq (sub_b->diff->addr, 0x3000, "similar addr back");
+	mu_assert_eq (alone->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "nothing to match");
+
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+static bool test_analysis_diff_fcn_many(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	ut8 buf[0x400];
+	char name[32];
+	int i;
+
+	// b has the functions of a renamed, in reverse order and every other
+	// one slightly changed
+	for (i = 0; i < 500; i++) {
+		fill (buf, 0x20 + i, i);
+		snprintf (name, sizeof (name), "fcn.%d", i);
+		add_fcn (a, name, 0x100000 + i * 0x1000, buf, 0x20 + i);
+	}
+	for (i = 499; i >= 0; i--) {
+		fill (buf, 0x20 + i, i);
+		if (i & 1) {
+			buf[i] ^= 0x55;
+		}
+		snprintf (name, sizeof (name), "sub.%d", i);
+		add_fcn (b, name, 0x800000 + i * 0x1000, buf, 0x20 + i);
+	}
+
+	mu_assert_true (rz_analysis_diff_fcn (a, a->fcns, b->fcns), "diff");
+	RzListIter *iter;
+	RzAnalysisFunction *fcn;
+	rz_list_foreach (a->fcns, iter, fcn) {
+		ut64 n = (fcn->addr - 0x100000) / 0x1000;
+		mu_assert_eq (fcn->diff->addr, 0x800000 + n * 0x1000, "counterpart");
+		mu_assert_neq (fcn->diff->type, RZ_ANALYSIS_DIFF_TYPE_NULL, "type");
+	}
+
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_analysis_diff_fcn);
+	mu_run_test (test_analysis_diff_fcn_many);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,307 @@
+#include <rz_analysis.h>
+#include <rz_th.h>
+#include "minunit.h"
+
+// mov rbp, rsp on 64 bits, dec eax; mov ebp, esp on 32 bits
+#define MOV_RBP_RSP "\x48\x89\xe5"
+
+static int op_size(RzAnalysis *analysis, const ut8 *buf, int len) {
+	RzAnalysisOp op;
+	int ret = rz_analysis_op_decode (analysis, &op, 0x1000, buf, len, RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini (&op);
+	return ret;
+}
+
+static bool test_analysis_plugin_ctx(void) {
+	RzAnalysis *a = rz_analysis_new ();
+	RzAnalysis *b = rz_analysis_new ();
+	rz_analysis_use (a, "x86");
+	rz_analysis_use (b, "x86");
+	rz_analysis_set_bits (a, 64);
+	rz_analysis_set_bits (b, 32);
+	mu_assert_notnull (a->plugin_data, "decoder state");
+	mu_assert_ptrneq (a->plugin_data, b->plugin_data, "one decoder state per RzAnalysis");
+
+	// interleaved decoding with different bits must not reopen a shared handle
+	int i;
+	for (i = 0; i < 3; i++) {
+		mu_assert_eq (op_size (a, (const ut8 *)MOV_RBP_RSP, 3), 3, "64 bits");
+		mu_assert_eq (op_size (b, (const ut8 *)MOV_RBP_RSP, 3), 1, "32 bits");
+	}
+
+	void *ctx = a->plugin_data;
+	rz_analysis_use (a, "x86");
+	mu_assert_ptreq (a->plugin_data, ctx, "kept while the plugin does not change");
+	rz_analysis_use (a, "null");
+	mu_assert_null (a->plugin_data, "released with the plugin");
+
+	RzAnalysis local;
+	mu_assert_true (rz_analysis_thread_init (&local, b), "thread copy");
+	mu_assert_notnull (local.plugin_data, "copy decoder state");
+	mu_assert_ptrneq (local.plugin_data, b->plugin_data, "own decoder state");
+	mu_assert_notnull (local.reg, "copy registers");
+	mu_assert_ptrneq (local.reg, b->reg, "own registers");
+	mu_assert_notnull (rz_reg_get (local.reg, "esp", -1), "same profile");
+	mu_assert_eq (op_size (&local, (const ut8 *)MOV_RBP_RSP, 3), 1, "decode on the copy");
+	rz_analysis_thread_fini (&local);
+	mu_assert_null (local.plugin_data, "copy released");
+	mu_assert_null (local.reg, "registers released");
+
+	rz_analysis_free (a);
+	rz_analysis_free (b);
+	mu_end;
+}
+
+typedef struct {
+	RzAnalysis analysis;
+	int bad;
+} DecodeWorker;
+
+static RzThreadFunctionRet decode_worker(RzThread *th) {
+	DecodeWorker *w = th->user;
+	const int expect = w->analysis.bits == 64 ? 3 : 1;
+	int i;
+	for (i = 0; i < 10000; i++) {
+		if (op_size (&w->analysis, (const ut8 *)MOV_RBP_RSP, 3) != expect) {
+			w->bad++;
+		}
+	}
+	return RZ_TH_STOP;
+}
+
+static bool test_analysis_op_threads(void) {
+	RzAnalysis *analysis = rz_analysis_new ();
+	rz_analysis_use (analysis, "x86");
+	mu_assert_true (analysis->cur->reentrant, "x86 is reentrant");
+	DecodeWorker w[4];
+	RzThread *th[4];
+	int i;
+	for (i = 0; i < 4; i++) {
+		rz_analysis_set_bits (analysis, i % 2 ? 32 : 64);
+		mu_assert_true (rz_analysis_thread_init (&w[i].analysis, analysis), "thread copy");
+		w[i].bad = 0;
+	}
+	for (i = 0; i < 4; i++) {
+		th[i] = rz_th_new (decode_worker, &w[i], 0);
+	}
+	for (i = 0; i < 4; i++) {
+		rz_th_wait (th[i]);
+		rz_th_free (th[i]);
+		mu_assert_eq (w[i].bad, 0, "concurrent decoding");
+		rz_analysis_thread_fini (&w[i].analysis);
+	}
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+// Decodes two bytes ops: the opcode and a relative jump, counting the calls
+static int decoded;
+
+static int fake_op(RzAnalysis *a, RzAnalysisOp *op, ut64 addr, const ut8 *buf, int len, RzAnalysisOpMask mask) {
+	decoded++;
+	op->size = 2;
+	op->type = RZ_ANALYSIS_OP_TYPE_JMP;
+	op->jump = addr + buf[1];
+	if (mask & RZ_ANALYSIS_OP_MASK_DISASM) {
+		op->mnemonic = rz_str_newf ("op%02x", buf[0]);
+	}
+	if (mask & RZ_ANALYSIS_OP_MASK_ESIL) {
+		rz_strbuf_setf (&op->esil, "%d,pc,+=", buf[1]);
+	}
+	if (mask & RZ_ANALYSIS_OP_MASK_VAL) {
+		op->dst = rz_analysis_value_new ();
+		op->dst->reg = rz_reg_get (a->reg, "pc", -1);
+	}
+	return 2;
+}
+
+static char *fake_regs(RzAnalysis *a) {
+	return strdup ("=PC\tpc\ngpr\tpc\t.32\t0\t0\n");
+}
+
+static RzAnalysisPlugin fake_plugin = {
+	.name = "fake",
+	.arch = "fake",
+	.bits = 32,
+	.op = fake_op,
+	.get_reg_profile = fake_regs,
+	.reentrant = true,
+};
+
+static RzAnalysis *fake_analysis(size_t cache_size) {
+	RzAnalysis *analysis = rz_analysis_new ();
+	rz_analysis_add (analysis, &fake_plugin);
+	rz_analysis_use (analysis, "fake");
+	rz_analysis_op_cache_set_size (analysis, cache_size);
+	decoded = 0;
+	return analysis;
+}
+
+static bool test_analysis_op_cache(void) {
+	RzAnalysis *analysis = fake_analysis (1 << 20);
+	RzAnalysisOpCacheStats st;
+	RzAnalysisOp op;
+	ut8 buf[] = { 0x90, 0x10 };
+	int i;
+	for (i = 0; i < 3; i++) {
+		mu_assert_eq (rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_BASIC), 2, "size");
+		mu_assert_eq (op.jump, 0x1010, "jump");
+		rz_analysis_op_fini (&op);
+	}
+	rz_analysis_op_cache_stats (analysis, &st);
+	mu_assert_eq (decoded, 1, "decoded once");
+	mu_assert_eq (st.hits, 2, "hits");
+	mu_assert_eq (st.misses, 1, "misses");
+	mu_assert_eq (st.entries, 1, "entries");
+
+	// asking for more decodes again, asking for less strips the cached op
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_DISASM | RZ_ANALYSIS_OP_MASK_ESIL);
+	mu_assert_streq (op.mnemonic, "op90", "mnemonic");
+	mu_assert_streq (rz_strbuf_get (&op.esil), "16,pc,+=", "esil");
+	rz_analysis_op_fini (&op);
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_ESIL);
+	mu_assert_null (op.mnemonic, "no mnemonic");
+	mu_assert_streq (rz_strbuf_get (&op.esil), "16,pc,+=", "cached esil");
+	rz_analysis_op_fini (&op);
+	mu_assert_eq (decoded, 2, "decoded again for the disasm");
+
+	// other bytes or bits at the same address are not served
+	buf[1] = 0x20;
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_BASIC);
+	mu_assert_eq (op.jump, 0x1020, "new bytes");
+	rz_analysis_op_fini (&op);
+	rz_analysis_set_bits (analysis, 16);
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini (&op);
+	mu_assert_eq (decoded, 4, "decoded for new bytes and bits");
+
+	rz_analysis_op_cache_invalidate (analysis, 0x1001, 1);
+	rz_analysis_op_cache_stats (analysis, &st);
+	mu_assert_eq (st.entries, 0, "invalidated");
+	rz_analysis_op_cache_clear (analysis);
+	rz_analysis_op_cache_stats (analysis, &st);
+	mu_assert_eq (st.size, 0, "cleared");
+
+	rz_analysis_op_cache_set_size (analysis, 0);
+	mu_assert_false (rz_analysis_op_cache_stats (analysis, &st), "disabled");
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+static bool test_analysis_op_cache_values(void) {
+	RzAnalysis *analysis = fake_analysis (1 << 20);
+	RzAnalysisOp op;
+	const ut8 buf[] = { 0x90, 0x10 };
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_VAL);
+	rz_analysis_op_fini (&op);
+	// the cached value must not point to the items of the old profile
+	rz_analysis_set_reg_profile (analysis);
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_VAL);
+	mu_assert_eq (decoded, 1, "cached");
+	mu_assert_notnull (op.dst, "dst");
+	mu_assert_ptreq (op.dst->reg, rz_reg_get (analysis->reg, "pc", -1), "register of the new profile");
+	rz_analysis_op_fini (&op);
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+static bool test_analysis_op_cache_size(void) {
+	RzAnalysis *analysis = fake_analysis (4096);
+	RzAnalysisOpCacheStats st;
+	RzAnalysisOp op;
+	const ut8 buf[] = { 0x90, 0x10 };
+	ut64 addr;
+	for (addr = 0; addr < 0x1000; addr += 2) {
+		rz_analysis_op (analysis, &op, addr, buf, 2, RZ_ANALYSIS_OP_MASK_ESIL);
+		rz_analysis_op_fini (&op);
+	}
+	rz_analysis_op_cache_stats (analysis, &st);
+	mu_assert_true (st.flushes > 0, "flushed");
+	mu_assert_true (st.size <= st.max_size, "capped");
+
+	// the state of the other plugins may change how the same bytes decode
+	fake_plugin.reentrant = false;
+	decoded = 0;
+	rz_analysis_op (analysis, &op, 0, buf, 2, RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini (&op);
+	rz_analysis_op (analysis, &op, 0, buf, 2, RZ_ANALYSIS_OP_MASK_BASIC);
+	rz_analysis_op_fini (&op);
+	fake_plugin.reentrant = true;
+	mu_assert_eq (decoded, 2, "not cached");
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+static int lite_decoded;
+
+static int fake_op_lite(RzAnalysis *a, RzAnalysisOpLite *op, ut64 addr, const ut8 *buf, int len) {
+	lite_decoded++;
+	op->size = 2;
+	op->type = RZ_ANALYSIS_OP_TYPE_JMP;
+	op->jump = addr + buf[1];
+	return 2;
+}
+
+static bool test_analysis_op_lite(void) {
+	RzAnalysis *analysis = fake_analysis (0);
+	RzAnalysisOpLite lite;
+	RzAnalysisOp op;
+	const ut8 buf[] = { 0x90, 0x10, 0x90, 0x20, 0x90, 0x30, 0x90 };
+	mu_assert_eq (rz_analysis_op_lite (analysis, &lite, 0x1000, buf, sizeof (buf)), 2, "lite size");
+	rz_analysis_op (analysis, &op, 0x1000, buf, sizeof (buf), RZ_ANALYSIS_OP_MASK_BASIC);
+	mu_assert_eq (lite.addr, op.addr, "addr");
+	mu_assert_eq (lite.type, op.type, "type");
+	mu_assert_eq (lite.size, op.size, "size");
+	mu_assert_eq (lite.jump, 0x1010, "jump");
+	mu_assert_eq (lite.fail, op.fail, "fail");
+	mu_assert_eq (lite.ptr, op.ptr, "ptr");
+	rz_analysis_op_fini (&op);
+
+	// the plugin op_lite is used when there is one
+	fake_plugin.op_lite = fake_op_lite;
+	decoded = lite_decoded = 0;
+	int used = 0;
+	RzAnalysisOpLite ops[8];
+	rz_analysis_hint_set_jump (analysis, 0x1002, 0x4242);
+	mu_assert_eq (rz_analysis_op_lite_batch (analysis, ops, 8, 0x1000, buf, 6, &used), 3, "batch count");
+	fake_plugin.op_lite = NULL;
+	mu_assert_eq (used, 6, "batch bytes");
+	mu_assert_eq (lite_decoded, 3, "native lite decoding");
+	mu_assert_eq (decoded, 0, "no full decoding");
+	mu_assert_eq (ops[1].addr, 0x1002, "second op");
+	mu_assert_eq (ops[1].jump, 0x4242, "jump hint");
+	mu_assert_eq (ops[2].jump, 0x1034, "third op");
+	mu_assert_eq (rz_analysis_op_lite_batch (analysis, ops, 2, 0x1000, buf, 6, &used), 2, "batch limit");
+	mu_assert_eq (used, 4, "batch limit bytes");
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+static bool test_analysis_op_lite_cache(void) {
+	RzAnalysis *analysis = fake_analysis (1 << 20);
+	RzAnalysisOpLite lite;
+	RzAnalysisOp op;
+	const ut8 buf[] = { 0x90, 0x10 };
+	rz_analysis_op (analysis, &op, 0x1000, buf, 2, RZ_ANALYSIS_OP_MASK_ESIL);
+	rz_analysis_op_fini (&op);
+	rz_analysis_op_lite (analysis, &lite, 0x1000, buf, 2);
+	mu_assert_eq (decoded, 1, "served from the op cache");
+	mu_assert_eq (lite.jump, 0x1010, "cached jump");
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_analysis_plugin_ctx);
+	mu_run_test (test_analysis_op_threads);
+	mu_run_test (test_analysis_op_cache);
+	mu_run_test (test_analysis_op_cache_values);
+	mu_run_test (test_analysis_op_cache_size);
+	mu_run_test (test_analysis_op_lite);
+	mu_run_test (test_analysis_op_lite_cache);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
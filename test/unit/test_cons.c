@@ -164,6 +164,63 @@ bool test_cons_to_html() {
 	mu_end;
 }
 
+bool test_cons_stream(void) {
+	char *name = NULL;
+	int fd = rz_file_mkstemp ("cons_stream", &name);
+	mu_assert ("tmp file", fd != -1);
+	RzCons *cons = rz_cons_new ();
+	int fdout = cons->fdout;
+	cons->fdout = fd;
+	cons->stream = 32;
+
+	// no filter, complete lines are written once enough is buffered
+	int i;
+	for (i = 0; i < 8; i++) {
+		rz_cons_printf ("line %d\n", i);
+		rz_cons_stream_flush ();
+	}
+	rz_cons_strcat ("partial");
+	rz_cons_stream_flush ();
+	char *out = rz_file_slurp (name, NULL);
+	mu_assert_streq_free (out, "line 0\nline 1\nline 2\nline 3\nline 4\n", "streamed lines");
+	mu_assert_eq (rz_cons_get_buffer_len (), strlen ("line 5\nline 6\nline 7\npartial"), "rest is buffered");
+	rz_cons_strcat ("\n");
+	rz_cons_flush ();
+	out = rz_file_slurp (name, NULL);
+	mu_assert_streq_free (out, "line 0\nline 1\nline 2\nline 3\nline 4\nline 5\nline 6\nline 7\npartial\n", "flushed");
+
+	// grep runs over every chunk and the buffer stays small
+	size_t done = strlen ("line 0\nline 1\nline 2\nline 3\nline 4\nline 5\nline 6\nline 7\npartial\n");
+	rz_cons_grep_process (strdup ("1"));
+	for (i = 0; i < 30; i++) {
+		rz_cons_printf ("line %d\n", i);
+		rz_cons_stream_flush ();
+		mu_assert ("bounded buffer", rz_cons_get_buffer_len () < 40);
+	}
+	rz_cons_flush ();
+	out = rz_file_slurp (name, NULL);
+	mu_assert_streq (out + done, "line 1\nline 10\nline 11\nline 12\nline 13\nline 14\n"
+		"line 15\nline 16\nline 17\nline 18\nline 19\nline 21\n", "grepped");
+	free (out);
+
+	// json filters need the whole output
+	rz_cons_grep_process (strdup ("{}"));
+	for (i = 0; i < 10; i++) {
+		rz_cons_printf ("[%d,", i);
+		rz_cons_stream_flush ();
+	}
+	mu_assert_eq (rz_cons_get_buffer_len (), 30, "not streamed");
+	rz_cons_reset ();
+
+	cons->stream = 0;
+	cons->fdout = fdout;
+	rz_cons_free ();
+	close (fd);
+	rz_file_rm (name);
+	free (name);
+	mu_end;
+}
+
 static RzLineNSCompletionResult *nocompletion_run(RzLineBuffer *buf, RzLinePromptType prompt_type, void *user) {
 	return rz_line_ns_completion_result_new (0, 0, NULL);
 }
@@ -279,6 +336,7 @@ bool test_line_multicompletion(void) {
 bool all_tests() {
 	mu_run_test (test_r_cons);
 	mu_run_test (test_cons_to_html);
+	mu_run_test (test_cons_stream);
 	mu_run_test (test_line_nocompletion);
 	mu_run_test (test_line_onecompletion);
 	mu_run_test (test_line_multicompletion);
@@ -3,95 +3,207 @@
 #include <rz_reg.h>
 #include "minunit.h"
 
-Sdb *ref_db() {
-	Sdb *db = sdb_new0 ();
-
-	sdb_num_set (db, "maxcnum", 1, 0);
-
-	Sdb *registers_db = sdb_ns (db, "registers", true);
-	sdb_set (registers_db, "0x100", "[{\"cnum\":0,\"data\":1094861636},{\"cnum\":1,\"data\":3735928559}]", 0);
-
-	Sdb *memory_sdb = sdb_ns (db, "memory", true);
-	sdb_set (memory_sdb, "0x7ffffffff000", "[{\"cnum\":0,\"data\":170},{\"cnum\":1,\"data\":187}]", 0);
-	sdb_set (memory_sdb, "0x7ffffffff001", "[{\"cnum\":0,\"data\":0},{\"cnum\":1,\"data\":1}]", 0);
-
-	Sdb *checkpoints_sdb = sdb_ns (db, "checkpoints", true);
-	sdb_set (checkpoints_sdb, "0x0", "{"
-		"\"registers\":["
-			"{\"arena\":0,\"bytes\":\"AAAAAAAAAAAAAAAAAAAAAA==\",\"size\":16},"
-			"{\"arena\":1,\"bytes\":\"AQEBAQEBAQEBAQEBAQEBAQ==\",\"size\":16},"
-			"{\"arena\":2,\"bytes\":\"AgICAgICAgICAgICAgICAg==\",\"size\":16},"
-			"{\"arena\":3,\"bytes\":\"AwMDAwMDAwMDAwMDAwMDAw==\",\"size\":16},"
-			"{\"arena\":4,\"bytes\":\"BAQEBAQEBAQEBAQEBAQEBA==\",\"size\":16},"
-			"{\"arena\":5,\"bytes\":\"BQUFBQUFBQUFBQUFBQUFBQ==\",\"size\":16},"
-			"{\"arena\":6,\"bytes\":\"BgYGBgYGBgYGBgYGBgYGBg==\",\"size\":16},"
-			"{\"arena\":7,\"bytes\":\"BwcHBwcHBwcHBwcHBwcHBw==\",\"size\":16}"
-		"],"
-		"\"snaps\":["
-			"{\"name\":\"[stack]\",\"addr\":8796092882944,\"addr_end\":8796092883200,\"size\":256,\"data\":\"8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8PDw8A==\",\"perm\":7,\"user\":0,\"shared\":true}"
-		"]"
-	"}", 0);
-
-	return db;
+#define STACK_ADDR 0x7fffffde000
+#define STACK_SIZE 0x2000
+
+static RzList *ref_snaps(ut8 fill) {
+	RzList *snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+	RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
+	snap->name = strdup ("[stack]");
+	snap->addr = STACK_ADDR;
+	snap->addr_end = STACK_ADDR + STACK_SIZE;
+	snap->size = STACK_SIZE;
+	snap->perm = 7;
+	snap->user = 0;
+	snap->shared = true;
+	snap->data = malloc (snap->size);
+	memset (snap->data, fill, snap->size);
+	rz_list_append (snaps, snap);
+	return snaps;
 }
 
-RzDebugSession *ref_session() {
+static void ref_arenas(RzRegArena **arenas, ut8 step) {
 	size_t i;
+	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		arenas[i] = rz_reg_arena_new (0x40);
+		memset (arenas[i]->bytes, i, arenas[i]->size);
+		arenas[i]->bytes[0x10] = step;
+		arenas[i]->bytes[0x30] = step * 3;
+	}
+}
+
+static void ref_arenas_free(RzRegArena **arenas) {
+	size_t i;
+	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
+		rz_reg_arena_free (arenas[i]);
+	}
+}
+
+// Checkpoints at cnum 0 and 2, with memory changes in between and after
+static RzDebugSession *ref_session(void) {
+	RzRegArena *arenas[RZ_REG_TYPE_LAST];
 	RzDebugSession *s = rz_debug_session_new ();
 
-	// Registers & Memory
+	RzList *snaps = ref_snaps (0xf0);
+	ref_arenas (arenas, 0);
+	rz_debug_session_add_checkpoint (s, arenas, snaps);
+	ref_arenas_free (arenas);
+	rz_list_free (snaps);
 	rz_debug_session_add_reg_change (s, 0, 0x100, 0x41424344);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff000, 0xaa);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff001, 0x00);
 	s->maxcnum++;
 	s->cnum++;
 
+	const ut8 bytes[] = { 0xaa, 0xbb, 0xcc, 0xdd };
 	rz_debug_session_add_reg_change (s, 0, 0x100, 0xdeadbeef);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff000, 0xbb);
-	rz_debug_session_add_mem_change (s, 0x7ffffffff001, 0x01);
+	rz_debug_session_add_mem_changes (s, STACK_ADDR + 0xffe, bytes, sizeof (bytes));
+	s->maxcnum++;
+	s->cnum++;
 
-	// Checkpoints
-	RzDebugCheckpoint checkpoint = { 0 };
-	for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-		RzRegArena *a = rz_reg_arena_new (0x10);
-		memset (a->bytes, i, a->size);
-		checkpoint.arena[i] = a;
-	}
-	checkpoint.snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
-	RzDebugSnap *snap = RZ_NEW0 (RzDebugSnap);
-	snap->name = strdup ("[stack]");
-	snap->addr = 0x7fffffde000;
-	snap->addr_end = 0x7fffffde100;
-	snap->size = 0x100;
-	snap->perm = 7;
-	snap->user = 0;
-	snap->shared = true;
-	snap->data = malloc (snap->size);
-	memset (snap->data, 0xf0, snap->size);
-	rz_list_append (checkpoint.snaps, snap);
-	rz_vector_push (s->checkpoints, &checkpoint);
+	snaps = ref_snaps (0xf0);
+	RzDebugSnap *snap = rz_list_first (snaps);
+	memcpy (snap->data + 0xffe, bytes, sizeof (bytes));
+	ref_arenas (arenas, 2);
+	rz_debug_session_add_checkpoint (s, arenas, snaps);
+	ref_arenas_free (arenas);
+	rz_list_free (snaps);
+	s->maxcnum++;
+	s->cnum++;
 
+	rz_debug_session_add_mem_change (s, STACK_ADDR + 0x1000, 0x11);
 	return s;
 }
 
-static void diff_cb(const SdbDiff *diff, void *user) {
-	char buf[2048];
-	if (sdb_diff_format (buf, sizeof(buf), diff) < 0) {
-		return;
-	}
-	printf ("%s\n", buf);
+static bool test_session_pages(void) {
+	RzDebugSession *s = ref_session ();
+	RzVector *versions = ht_up_find (s->pages, STACK_ADDR, NULL);
+	mu_assert_notnull (versions, "first page versions");
+	mu_assert_eq (rz_vector_len (versions), 2, "first page changed");
+	versions = ht_up_find (s->pages, STACK_ADDR + 0x1000, NULL);
+	mu_assert_notnull (versions, "second page versions");
+	mu_assert_eq (rz_vector_len (versions), 2, "second page changed");
+
+	// Checkpoint snaps do not keep their data
+	RzDebugCheckpoint *chkpt = rz_vector_index_ptr (s->checkpoints, 1);
+	RzDebugSnap *snap = rz_list_first (chkpt->snaps);
+	mu_assert_eq (chkpt->cnum, 2, "checkpoint cnum");
+	mu_assert_null (snap->data, "snap data moved to the pages");
+	mu_assert_eq (snap->size, STACK_SIZE, "snap size");
+
+	// Memory changes are grouped by page
+	RzVector *vmem = ht_up_find (s->memory, STACK_ADDR, NULL);
+	mu_assert_notnull (vmem, "first page changes");
+	mu_assert_eq (rz_vector_len (vmem), 2, "first page changes");
+	RzDebugChangeMem *mem = rz_vector_index_ptr (vmem, 1);
+	mu_assert_eq (mem->cnum, 1, "change cnum");
+	mu_assert_eq (mem->off, 0xfff, "change offset");
+	mu_assert_eq (mem->data, 0xbb, "change data");
+	vmem = ht_up_find (s->memory, STACK_ADDR + 0x1000, NULL);
+	mu_assert_eq (rz_vector_len (vmem), 3, "second page changes");
+
+	// Adding a checkpoint with the same contents shares all the pages
+	RzRegArena *arenas[RZ_REG_TYPE_LAST];
+	ut8 buf[4];
+	ref_arenas (arenas, 3);
+	s->cnum = 3;
+	RzList *snaps = ref_snaps (0xf0);
+	snap = rz_list_first (snaps);
+	rz_debug_session_read_at (s, 3, STACK_ADDR, snap->data, STACK_SIZE);
+	rz_debug_session_add_checkpoint (s, arenas, snaps);
+	ref_arenas_free (arenas);
+	rz_list_free (snaps);
+	mu_assert_eq (rz_vector_len (ht_up_find (s->pages, STACK_ADDR, NULL)), 2, "first page shared");
+	versions = ht_up_find (s->pages, STACK_ADDR + 0x1000, NULL);
+	mu_assert_eq (rz_vector_len (versions), 3, "second page changed again");
+	rz_debug_session_read_at (s, 3, STACK_ADDR + 0xffe, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\xaa\xbb\x11\xdd", sizeof (buf), "read at the last checkpoint");
+
+	rz_debug_session_free (s);
+	mu_end;
 }
 
-static bool test_session_save(void) {
-	Sdb *expected = ref_db ();
-	Sdb *actual = sdb_new0 ();
+static bool test_session_changed_pages(void) {
 	RzDebugSession *s = ref_session ();
-	rz_debug_session_serialize (s, actual);
+	RzRegArena *arenas[RZ_REG_TYPE_LAST];
+	ut8 buf[2];
+
+	// Only the pages marked as changed by an incremental update are saved
+	RzList *snaps = ref_snaps (0xf0);
+	RzDebugSnap *snap = rz_list_first (snaps);
+	rz_debug_session_read_at (s, 3, STACK_ADDR, snap->data, STACK_SIZE);
+	snap->data[0] = 0x22;
+	snap->data[0x1000] = 0x33;
+	snap->changed = calloc (1, STACK_SIZE / RZ_DEBUG_SNAP_PAGE_SIZE);
+	snap->changed[1] = 1;
+	s->cnum = 3;
+	ref_arenas (arenas, 3);
+	rz_debug_session_add_checkpoint (s, arenas, snaps);
+	ref_arenas_free (arenas);
+	rz_list_free (snaps);
 
-	mu_assert ("save", sdb_diff (expected, actual, diff_cb, NULL));
+	mu_assert_eq (rz_vector_len (ht_up_find (s->pages, STACK_ADDR, NULL)), 2, "first page not saved");
+	mu_assert_eq (rz_vector_len (ht_up_find (s->pages, STACK_ADDR + 0x1000, NULL)), 3, "second page saved");
+	rz_debug_session_read_at (s, 3, STACK_ADDR, buf, 1);
+	rz_debug_session_read_at (s, 3, STACK_ADDR + 0x1000, buf + 1, 1);
+	mu_assert_memeq (buf, (ut8 *)"\xf0\x33", sizeof (buf), "saved pages");
+
+	rz_debug_session_free (s);
+	mu_end;
+}
+
+static bool test_session_read_at(void) {
+	RzDebugSession *s = ref_session ();
+	ut8 buf[4];
+	memset (buf, 0, sizeof (buf));
+	mu_assert_true (rz_debug_session_read_at (s, 0, STACK_ADDR + 0xffe, buf, sizeof (buf)), "read");
+	mu_assert_memeq (buf, (ut8 *)"\xf0\xf0\xf0\xf0", sizeof (buf), "cnum 0");
+	rz_debug_session_read_at (s, 1, STACK_ADDR + 0xffe, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\xaa\xbb\xcc\xdd", sizeof (buf), "cnum 1");
+	rz_debug_session_read_at (s, 2, STACK_ADDR + 0xffe, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\xaa\xbb\xcc\xdd", sizeof (buf), "cnum 2");
+	rz_debug_session_read_at (s, 3, STACK_ADDR + 0xffe, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\xaa\xbb\x11\xdd", sizeof (buf), "cnum 3");
+
+	// Bytes out of the session are left alone
+	memset (buf, 0x42, sizeof (buf));
+	rz_debug_session_read_at (s, 3, STACK_ADDR + STACK_SIZE - 2, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\xf0\xf0\x42\x42", sizeof (buf), "end of the stack");
+
+	rz_debug_session_free (s);
+	mu_end;
+}
+
+static bool test_session_arenas(void) {
+	RzDebugSession *s = rz_debug_session_new ();
+	RzList *snaps = rz_list_newf ((RzListFree)rz_debug_snap_free);
+	RzRegArena *arenas[RZ_REG_TYPE_LAST];
+	size_t i, j;
+	for (i = 0; i < 40; i++) {
+		s->cnum = i;
+		ref_arenas (arenas, i);
+		rz_debug_session_add_checkpoint (s, arenas, snaps);
+		ref_arenas_free (arenas);
+	}
+	rz_list_free (snaps);
+	RzDebugCheckpoint *chkpt = rz_vector_index_ptr (s->checkpoints, 1);
+	mu_assert_null (chkpt->arena[RZ_REG_TYPE_GPR], "delta only");
+	mu_assert_notnull (chkpt->delta[RZ_REG_TYPE_GPR], "delta");
+	mu_assert_eq (rz_vector_len (&chkpt->delta[RZ_REG_TYPE_GPR]->runs), 2, "delta runs");
+	chkpt = rz_vector_index_ptr (s->checkpoints, RZ_DEBUG_SESSION_KEYFRAME);
+	mu_assert_notnull (chkpt->arena[RZ_REG_TYPE_GPR], "keyframe");
+
+	for (i = 0; i < 40; i++) {
+		ref_arenas (arenas, i);
+		for (j = 0; j < RZ_REG_TYPE_LAST; j++) {
+			RzRegArena *a = rz_debug_session_get_arena (s, i, j);
+			mu_assert_notnull (a, "arena");
+			mu_assert_eq (a->size, arenas[j]->size, "arena size");
+			mu_assert_memeq (a->bytes, arenas[j]->bytes, a->size, "arena bytes");
+			rz_reg_arena_free (a);
+		}
+		ref_arenas_free (arenas);
+	}
+	mu_assert_null (rz_debug_session_get_arena (s, 40, 0), "out of range");
 
-	sdb_free (actual);
-	sdb_free (expected);
 	rz_debug_session_free (s);
 	mu_end;
 }
@@ -114,31 +226,6 @@ static bool compare_registers_cb(void *user, const ut64 key, const void *value)
 	return true;
 }
 
-static bool compare_memory_cb(void *user, const ut64 key, const void *value) {
-	RzDebugChangeMem *actual_mem, *expected_mem;
-	HtUP *ref = user;
-	RzVector *actual_vmem = (RzVector *)value;
-
-	RzVector *expected_vmem = ht_up_find (ref, key, NULL);
-	mu_assert ("vmem not found", expected_vmem);
-	mu_assert_eq (actual_vmem->len, expected_vmem->len, "vmem length");
-
-	size_t i;
-	rz_vector_enumerate (actual_vmem, actual_mem, i) {
-		expected_mem = rz_vector_index_ptr (expected_vmem, i);
-		mu_assert_eq (actual_mem->cnum, expected_mem->cnum, "cnum");
-		mu_assert_eq (actual_mem->data, expected_mem->data, "data");
-	}
-	return true;
-}
-
-static bool arena_eq(RzRegArena *actual, RzRegArena *expected) {
-	mu_assert ("arena null", actual && expected);
-	mu_assert_eq (actual->size, expected->size, "arena size");
-	mu_assert_memeq (actual->bytes, expected->bytes, expected->size, "arena bytes");
-	return true;
-}
-
 static bool snap_eq(RzDebugSnap *actual, RzDebugSnap *expected) {
 	mu_assert ("snap null", actual && expected);
 	mu_assert_streq (actual->name, expected->name, "snap name");
@@ -148,51 +235,75 @@ static bool snap_eq(RzDebugSnap *actual, RzDebugSnap *expected) {
 	mu_assert_eq (actual->perm, expected->perm, "snap perm");
 	mu_assert_eq (actual->user, expected->user, "snap user");
 	mu_assert_eq (actual->shared, expected->shared, "snap shared");
-	mu_assert_memeq (actual->data, expected->data, expected->size, "snap data");
 	return true;
 }
 
-static bool test_session_load(void) {
+static bool test_session_save_load(void) {
 	RzDebugSession *ref = ref_session ();
-	RzDebugSession *s = rz_debug_session_new ();
-	Sdb *db = ref_db ();
-	rz_debug_session_deserialize (s, db);
+	RzBuffer *b = rz_buf_new ();
+	mu_assert_true (rz_debug_session_serialize (ref, b), "serialize");
 
+	RzDebugSession *s = rz_debug_session_new ();
+	rz_buf_seek (b, 0, RZ_BUF_SET);
+	mu_assert_true (rz_debug_session_deserialize (s, b), "deserialize");
 	mu_assert_eq (s->maxcnum, ref->maxcnum, "maxcnum");
-	// Registers
 	ht_up_foreach (s->registers, compare_registers_cb, ref->registers);
-	// Memory
-	ht_up_foreach (s->memory, compare_memory_cb, ref->memory);
-	// Checkpoints
+
+	ut8 actual[STACK_SIZE], expected[STACK_SIZE];
+	ut32 cnum;
+	for (cnum = 0; cnum < 4; cnum++) {
+		memset (actual, 0, sizeof (actual));
+		memset (expected, 0, sizeof (expected));
+		rz_debug_session_read_at (s, cnum, STACK_ADDR, actual, sizeof (actual));
+		rz_debug_session_read_at (ref, cnum, STACK_ADDR, expected, sizeof (expected));
+		mu_assert ("memory", !memcmp (actual, expected, sizeof (actual)));
+	}
+
 	size_t i, chkpt_idx;
 	RzDebugCheckpoint *chkpt, *ref_chkpt;
 	mu_assert_eq (s->checkpoints->len, ref->checkpoints->len, "checkpoints length");
 	rz_vector_enumerate (s->checkpoints, chkpt, chkpt_idx) {
 		ref_chkpt = rz_vector_index_ptr (ref->checkpoints, chkpt_idx);
-		// Registers
+		mu_assert_eq (chkpt->cnum, ref_chkpt->cnum, "checkpoint cnum");
 		for (i = 0; i < RZ_REG_TYPE_LAST; i++) {
-			arena_eq (chkpt->arena[i], ref_chkpt->arena[i]);
-		}	
-		// Snaps
-		RzListIter *actual_snaps_iter = rz_list_iterator (chkpt->snaps);
-		RzListIter *expected_snaps_iter = rz_list_iterator (ref_chkpt->snaps);
-		while (actual_snaps_iter && expected_snaps_iter) {
-			RzDebugSnap *actual_snap = rz_list_iter_get (actual_snaps_iter);
-			RzDebugSnap *expected_snap = rz_list_iter_get (expected_snaps_iter);
-			snap_eq (actual_snap, expected_snap);
+			RzRegArena *a = rz_debug_session_get_arena (s, chkpt_idx, i);
+			RzRegArena *e = rz_debug_session_get_arena (ref, chkpt_idx, i);
+			mu_assert ("arena null", a && e);
+			mu_assert_eq (a->size, e->size, "arena size");
+			mu_assert_memeq (a->bytes, e->bytes, e->size, "arena bytes");
+			rz_reg_arena_free (a);
+			rz_reg_arena_free (e);
 		}
+		mu_assert_eq (rz_list_length (chkpt->snaps), rz_list_length (ref_chkpt->snaps), "snaps length");
+		snap_eq (rz_list_first (chkpt->snaps), rz_list_first (ref_chkpt->snaps));
+	}
+	rz_debug_session_free (s);
 
+	// Truncated sessions are rejected
+	ut64 size = rz_buf_size (b);
+	ut8 *bytes = malloc (size);
+	rz_buf_read_at (b, 0, bytes, size);
+	ut64 len;
+	for (len = 0; len < size; len += 61) {
+		RzBuffer *t = rz_buf_new_with_bytes (bytes, len);
+		s = rz_debug_session_new ();
+		mu_assert_false (rz_debug_session_deserialize (s, t), "truncated");
+		rz_debug_session_free (s);
+		rz_buf_free (t);
 	}
+	free (bytes);
 
-	sdb_free (db);
-	rz_debug_session_free (s);
+	rz_buf_free (b);
 	rz_debug_session_free (ref);
 	mu_end;
 }
 
 int all_tests() {
-	mu_run_test (test_session_save);
-	mu_run_test (test_session_load);
+	mu_run_test (test_session_pages);
+	mu_run_test (test_session_changed_pages);
+	mu_run_test (test_session_read_at);
+	mu_run_test (test_session_arenas);
+	mu_run_test (test_session_save_load);
 	return tests_passed != tests_run;
 }
 
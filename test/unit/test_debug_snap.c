@@ -0,0 +1,168 @@
+#include <rz_debug.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#define MEM_ADDR 0x10000
+#define MEM_PAGES 8
+#define MEM_SIZE (MEM_PAGES * RZ_DEBUG_SNAP_PAGE_SIZE)
+
+// Debuggee memory, with the pages written since the last dirty_clear
+static ut8 mem[MEM_SIZE];
+static ut8 mem_dirty[MEM_PAGES];
+static int bytes_read;
+static int bytes_written;
+
+static bool mem_read_at(RzIO *io, ut64 addr, ut8 *buf, int len) {
+	memcpy (buf, mem + addr - MEM_ADDR, len);
+	bytes_read += len;
+	return true;
+}
+
+static bool mem_write_at(RzIO *io, ut64 addr, const ut8 *buf, int len) {
+	ut64 off = addr - MEM_ADDR;
+	memcpy (mem + off, buf, len);
+	memset (mem_dirty + off / RZ_DEBUG_SNAP_PAGE_SIZE, 1, (off + len - 1) / RZ_DEBUG_SNAP_PAGE_SIZE - off / RZ_DEBUG_SNAP_PAGE_SIZE + 1);
+	bytes_written += len;
+	return true;
+}
+
+static void poke(ut64 addr, ut8 v) {
+	mem[addr - MEM_ADDR] = v;
+	mem_dirty[(addr - MEM_ADDR) / RZ_DEBUG_SNAP_PAGE_SIZE] = 1;
+}
+
+static bool mem_dirty_clear(RzDebug *dbg) {
+	memset (mem_dirty, 0, sizeof (mem_dirty));
+	return true;
+}
+
+static int mem_dirty_pages(RzDebug *dbg, ut64 addr, ut64 size, ut8 *dirty) {
+	int i, count = 0;
+	for (i = 0; i < MEM_PAGES; i++) {
+		dirty[i] = mem_dirty[i];
+		count += dirty[i];
+	}
+	return count;
+}
+
+static RzDebugPlugin dirty_plugin = {
+	.name = "dirty",
+	.dirty_clear = mem_dirty_clear,
+	.dirty_pages = mem_dirty_pages,
+};
+
+static void dbg_init(RzDebug *dbg, RzDebugPlugin *h) {
+	memset (dbg, 0, sizeof (*dbg));
+	dbg->iob.read_at = mem_read_at;
+	dbg->iob.write_at = mem_write_at;
+	dbg->h = h;
+	dbg->maps = rz_list_newf ((RzListFree)rz_debug_map_free);
+	rz_list_append (dbg->maps, rz_debug_map_new ("heap", MEM_ADDR, MEM_ADDR + MEM_SIZE, RZ_PERM_RW, 0));
+	size_t i;
+	for (i = 0; i < MEM_SIZE; i++) {
+		mem[i] = i * 7;
+	}
+	memset (mem_dirty, 1, sizeof (mem_dirty));
+	bytes_read = bytes_written = 0;
+}
+
+static bool test_snap_update(void) {
+	RzDebug dbg;
+	dbg_init (&dbg, NULL);
+	RzList *snaps = rz_debug_snap_maps (&dbg, RZ_PERM_RW);
+	mu_assert_eq (rz_list_length (snaps), 1, "snaps");
+	RzDebugSnap *snap = rz_list_first (snaps);
+	mu_assert_eq (bytes_read, MEM_SIZE, "full read");
+	mu_assert_eq (dbg.snap_dirty, 0, "no dirty tracking");
+
+	poke (MEM_ADDR + 0x2010, 0x42);
+	bytes_read = 0;
+	mu_assert_eq (rz_debug_snap_update (&dbg, snaps), 1, "changed pages");
+	mu_assert_eq (bytes_read, MEM_SIZE, "everything read back");
+	mu_assert_notnull (snap->changed, "changed");
+	mu_assert_true (snap->changed[2] && !snap->changed[1] && !snap->changed[3], "changed page");
+	mu_assert ("snap data", !memcmp (snap->data, mem, MEM_SIZE));
+	mu_assert_eq (snap->hashes[2], rz_hash_xxhash (mem + 0x2000, RZ_DEBUG_SNAP_PAGE_SIZE), "page hash");
+
+	rz_list_free (snaps);
+	rz_list_free (dbg.maps);
+	mu_end;
+}
+
+static bool test_snap_update_dirty(void) {
+	RzDebug dbg;
+	dbg_init (&dbg, &dirty_plugin);
+	RzList *snaps = rz_debug_snap_maps (&dbg, RZ_PERM_RW);
+	RzDebugSnap *snap = rz_list_first (snaps);
+	mu_assert_eq (dbg.snap_dirty, 1, "dirty tracking");
+
+	poke (MEM_ADDR + 0x3000, 0x42);
+	poke (MEM_ADDR + 0x5000, mem[0x5000]);
+	bytes_read = 0;
+	mu_assert_eq (rz_debug_snap_update (&dbg, snaps), 1, "changed pages");
+	mu_assert_eq (bytes_read, 2 * RZ_DEBUG_SNAP_PAGE_SIZE, "only dirty pages read back");
+	mu_assert_true (snap->changed[3] && !snap->changed[5], "changed page");
+	mu_assert ("snap data", !memcmp (snap->data, mem, MEM_SIZE));
+
+	bytes_read = 0;
+	mu_assert_eq (rz_debug_snap_update (&dbg, snaps), 0, "nothing changed");
+	mu_assert_eq (bytes_read, 0, "nothing read back");
+
+	rz_list_free (snaps);
+	rz_list_free (dbg.maps);
+	mu_end;
+}
+
+static bool test_snap_restore(void) {
+	ut8 orig[MEM_SIZE];
+	RzDebugPlugin *plugins[] = { NULL, &dirty_plugin };
+	size_t i;
+	for (i = 0; i < RZ_ARRAY_SIZE (plugins); i++) {
+		RzDebug dbg;
+		dbg_init (&dbg, plugins[i]);
+		memcpy (orig, mem, MEM_SIZE);
+		RzList *snaps = rz_debug_snap_maps (&dbg, RZ_PERM_RW);
+		RzDebugSnap *snap = rz_list_first (snaps);
+
+		poke (MEM_ADDR + 0x1000, 0x11);
+		poke (MEM_ADDR + 0x1fff, 0x22);
+		poke (MEM_ADDR + 0x6000, 0x33);
+		poke (MEM_ADDR + 0x7000, mem[0x7000]);
+		bytes_read = bytes_written = 0;
+		mu_assert_eq (rz_debug_snap_restore (&dbg, snap), 2, "restored pages");
+		mu_assert ("memory restored", !memcmp (mem, orig, MEM_SIZE));
+		mu_assert_eq (bytes_written, 2 * RZ_DEBUG_SNAP_PAGE_SIZE, "only differing pages written");
+		mu_assert_eq (bytes_read, i ? 3 * RZ_DEBUG_SNAP_PAGE_SIZE : MEM_SIZE, "pages compared");
+
+		rz_list_free (snaps);
+		rz_list_free (dbg.maps);
+	}
+	mu_end;
+}
+
+static bool test_snap_is_equal(void) {
+	RzDebug dbg;
+	dbg_init (&dbg, NULL);
+	RzList *a = rz_debug_snap_maps (&dbg, RZ_PERM_RW);
+	RzList *b = rz_debug_snap_maps (&dbg, RZ_PERM_RW);
+	mu_assert_true (rz_debug_snap_is_equal (rz_list_first (a), rz_list_first (b)), "equal");
+	poke (MEM_ADDR + 0x4321, 0x99);
+	rz_debug_snap_update (&dbg, b);
+	mu_assert_false (rz_debug_snap_is_equal (rz_list_first (a), rz_list_first (b)), "not equal");
+	rz_list_free (a);
+	rz_list_free (b);
+	rz_list_free (dbg.maps);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_snap_update);
+	mu_run_test (test_snap_update_dirty);
+	mu_run_test (test_snap_restore);
+	mu_run_test (test_snap_is_equal);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -40,14 +40,13 @@ bool test_r_diff_buffers_distance(void) {
 		mu_assert_eq (distance, tests[i].dis_distance, msg);
 	}
 
-	// Broken rz_diff_buffers_distance_levenshtein, uncomment and see why it is incorrect
-	// diff->type = 'l';
-	// for (i = 0; i < RZ_ARRAY_SIZE (tests); i++) {
-	// 	size_t la = strlen (tests[i].a), lb = strlen ((const char *)tests[i].b);
-	// 	rz_diff_buffers_distance (diff, tests[i].a, la, tests[i].b, lb, &distance, NULL);
-	// 	snprintf (msg, sizeof msg, "levenshtein %s/%s distance", tests[i].a, tests[i].b);
-	// 	mu_assert_eq (distance, tests[i].dis_distance, msg);
-	// }
+	diff->type = 'l';
+	for (i = 0; tests[i].a; i++) {
+		size_t la = strlen ((const char *)tests[i].a), lb = strlen ((const char *)tests[i].b);
+		rz_diff_buffers_distance (diff, tests[i].a, la, tests[i].b, lb, &distance, NULL);
+		snprintf (msg, sizeof msg, "levenshtein %s/%s distance", tests[i].a, tests[i].b);
+		mu_assert_eq (distance, tests[i].dis_distance, msg);
+	}
 
 	// Eugene W. Myers' O(ND) diff algorithm, deletion/insertion edit distance
 	diff->type = 'm';
@@ -62,8 +61,96 @@ bool test_r_diff_buffers_distance(void) {
 	mu_end;
 }
 
+// Plain two rows DP to check the bit-vector kernel against
+static ut32 reference_distance(const ut8 *a, ut32 la, const ut8 *b, ut32 lb) {
+	ut32 *d = malloc ((lb + 1) * sizeof (ut32)), i, j;
+	for (i = 0; i <= lb; i++) {
+		d[i] = i;
+	}
+	for (i = 0; i < la; i++) {
+		ut32 ul = d[0];
+		d[0] = i + 1;
+		for (j = 0; j < lb; j++) {
+			ut32 u = d[j + 1];
+			d[j + 1] = a[i] == b[j] ? ul : RZ_MIN (ul, RZ_MIN (d[j], u)) + 1;
+			ul = u;
+		}
+	}
+	ut32 r = d[lb];
+	free (d);
+	return r;
+}
+
+static ut32 seed = 1;
+
+static ut32 rnd(void) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 16;
+}
+
+// b is a with a few random edits
+static ut32 mutate(const ut8 *a, ut32 la, ut8 *b, int alpha) {
+	ut32 i, lb = 0;
+	for (i = 0; i < la; i++) {
+		ut32 r = rnd () % 16;
+		if (r == 1) {
+			continue;
+		}
+		if (r == 2) {
+			b[lb++] = rnd () % alpha;
+		}
+		b[lb++] = r == 3 ? rnd () % alpha : a[i];
+	}
+	return lb;
+}
+
+bool test_r_diff_buffers_distance_bitvector(void) {
+	// lengths around the 64 bits words of the kernel
+	static const ut32 lens[] = { 1, 2, 63, 64, 65, 127, 128, 129, 200, 700 };
+	ut8 a[800], b[1700];
+	char msg[128];
+	size_t i, j;
+	RzDiff *diff = rz_diff_new ();
+	for (i = 0; i < RZ_ARRAY_SIZE (lens); i++) {
+		for (j = 0; j < 8; j++) {
+			int alpha = j & 1 ? 4 : 256;
+			ut32 k, la = lens[i], lb;
+			for (k = 0; k < la; k++) {
+				a[k] = rnd () % alpha;
+			}
+			if (j < 4) {
+				lb = mutate (a, la, b, alpha);
+			} else {
+				lb = rnd () % (2 * la + 1);
+				for (k = 0; k < lb; k++) {
+					b[k] = rnd () % alpha;
+				}
+			}
+			ut32 expect = reference_distance (a, la, b, lb), distance;
+			diff->threshold = 0;
+			rz_diff_buffers_distance (diff, a, la, b, lb, &distance, NULL);
+			snprintf (msg, sizeof msg, "distance %u/%u #%zu", la, lb, j);
+			mu_assert_eq (distance, expect, msg);
+
+			// exact when the threshold is reached, a lower bound otherwise
+			double sim, expect_sim = 1.0 - (double)expect / RZ_MAX (la, lb);
+			diff->threshold = 0.8;
+			rz_diff_buffers_distance (diff, a, la, b, lb, &distance, &sim);
+			snprintf (msg, sizeof msg, "threshold %u/%u #%zu", la, lb, j);
+			if (expect_sim >= diff->threshold) {
+				mu_assert_eq (distance, expect, msg);
+			} else {
+				mu_assert_true (distance <= expect && sim < diff->threshold, msg);
+			}
+		}
+	}
+	rz_diff_free (diff);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_r_diff_buffers_distance);
+	mu_run_test(test_r_diff_buffers_distance_bitvector);
 	return tests_passed != tests_run;
 }
 
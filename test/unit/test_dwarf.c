@@ -1279,6 +1279,49 @@ bool test_big_endian_dwarf2(void) {
 	mu_end;
 }
 
+bool test_dwarf_line_table(void) {
+	RzBin *bin = rz_bin_new ();
+	RzIO *io = rz_io_new ();
+	rz_io_bind (io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	bool res = rz_bin_open (bin, "bins/elf/dwarf4_many_comp_units.elf", &opt);
+	mu_assert ("couldn't open file", res);
+
+	RzList *line_list = rz_bin_dwarf_parse_line (bin, MODE);
+	const RzBinDwarfLineTable *table = bin->cur->addrline;
+	mu_assert_notnull (table, "Line table not stored in the bin file");
+	mu_assert_eq (table->count, rz_list_length (line_list), "Amount of line information doesn't match");
+
+	// one entry per address, sorted
+	size_t i;
+	for (i = 1; i < table->count; i++) {
+		mu_assert ("Line table not sorted", table->entries[i - 1].address < table->entries[i].address);
+	}
+	RzBinDwarfRow *row;
+	RzListIter *iter;
+	rz_list_foreach (line_list, iter, row) {
+		const RzBinDwarfLineEntry *e = rz_bin_dwarf_line_table_get (table, row->address);
+		mu_assert_notnull (e, "Line entry not found");
+		mu_assert_eq (e->line, row->line, "Wrong line");
+		mu_assert_streq (table->files[e->file], row->file, "Wrong file");
+	}
+	mu_assert_null (rz_bin_dwarf_line_table_get (table, 0x00401161), "Entry in the middle of an instruction");
+
+	char file[1024];
+	int line = 0;
+	mu_assert_true (rz_bin_addr2line (bin, 0x00401160, file, sizeof (file), &line), "addr2line");
+	mu_assert_eq (line, rz_bin_dwarf_line_table_get (table, 0x00401160)->line, "addr2line line");
+
+	mu_assert_true (rz_bin_dwarf_line_table_del (bin->cur->addrline, 0x00401160), "Entry not removed");
+	mu_assert_null (rz_bin_dwarf_line_table_get (table, 0x00401160), "Removed entry found");
+	mu_assert_eq (table->count, rz_list_length (line_list) - 1, "Amount of line information after removal");
+
+	rz_list_free (line_list);
+	rz_bin_free (bin);
+	rz_io_free (io);
+	mu_end;
+}
 
 bool all_tests() {
 	mu_run_test (test_dwarf_cpp_empty_line_info);
@@ -1288,6 +1331,7 @@ bool all_tests() {
 	mu_run_test (test_dwarf3_cpp_many_comp_units);
 	mu_run_test (test_dwarf4_cpp_many_comp_units);
 	mu_run_test (test_big_endian_dwarf2);
+	mu_run_test (test_dwarf_line_table);
 	return tests_passed != tests_run;
 }
 
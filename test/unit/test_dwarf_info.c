@@ -417,9 +417,56 @@ bool test_dwarf2_big_endian(void) {
 	mu_end;
 }
 
+bool test_dwarf_info_lazy(void) {
+	RzBin *bin = rz_bin_new ();
+	RzIO *io = rz_io_new ();
+	rz_io_bind (io, &bin->iob);
+
+	RzBinOptions opt = { 0 };
+	bool res = rz_bin_open (bin, "bins/elf/dwarf4_many_comp_units.elf", &opt);
+	mu_assert ("dwarf4_many_comp_units.elf binary could not be opened", res);
+
+	RzBinDwarfDebugAbbrev *da = rz_bin_dwarf_parse_abbrev (bin, MODE);
+	RzBinDwarfDebugInfo *info = rz_bin_dwarf_parse_info (da, bin, MODE);
+	RzBinDwarfDebugInfo *lazy = rz_bin_dwarf_index_info (da, bin);
+	mu_assert_notnull (lazy, "Units not indexed");
+	mu_assert_eq (lazy->count, info->count, "Incorrect number of info compilation units");
+	mu_assert_false (lazy->comp_units[0].loaded, "Unit loaded by the index");
+	mu_assert_false (lazy->comp_units[1].loaded, "Unit loaded by the index");
+
+	// a DIE of the second unit only loads that one
+	RzBinDwarfCompUnit *cu = &info->comp_units[1];
+	RzBinDwarfDie *die = rz_bin_dwarf_info_get_die (lazy, cu->dies[3].offset);
+	mu_assert_notnull (die, "DIE not found");
+	mu_assert_eq (die->offset, cu->dies[3].offset, "Wrong DIE offset");
+	mu_assert_eq (die->tag, cu->dies[3].tag, "Wrong DIE tag");
+	mu_assert_eq (die->count, cu->dies[3].count, "Wrong DIE length information");
+	mu_assert_false (lazy->comp_units[0].loaded, "Unrelated unit loaded");
+	mu_assert_true (lazy->comp_units[1].loaded, "Unit not loaded");
+	mu_assert_null (rz_bin_dwarf_info_get_die (lazy, cu->dies[3].offset + 1), "DIE in the middle of another one");
+
+	mu_assert_true (rz_bin_dwarf_info_load_all (lazy), "Units not loaded");
+	size_t i, j;
+	for (i = 0; i < info->count; i++) {
+		mu_assert_eq (lazy->comp_units[i].count, info->comp_units[i].count, "Wrong number of DIEs");
+		for (j = 0; j < info->comp_units[i].count; j++) {
+			die = rz_bin_dwarf_info_get_die (lazy, info->comp_units[i].dies[j].offset);
+			mu_assert_ptreq (die, &lazy->comp_units[i].dies[j], "Wrong DIE for offset");
+		}
+	}
+
+	rz_bin_dwarf_free_debug_info (lazy);
+	rz_bin_dwarf_free_debug_info (info);
+	rz_bin_dwarf_free_debug_abbrev (da);
+	rz_bin_free (bin);
+	rz_io_free (io);
+	mu_end;
+}
+
 bool all_tests() {
 	mu_run_test (test_dwarf3_c);
 	mu_run_test (test_dwarf4_cpp_multiple_modules);
+	mu_run_test (test_dwarf_info_lazy);
 	mu_run_test (test_dwarf2_big_endian);
 	return tests_passed != tests_run;
 }
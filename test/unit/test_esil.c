@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_analysis.h>
+#include <rz_reg.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+static const char *exprs[] = {
+	"1,rax,+=",
+	"rax,rbx,=",
+	"0x10,rbx,-=,rbx,0x8,+,rcx,=",
+	"rcx,rax,^=,$z,zf,:=,63,$c,cf,:=",
+	"zf,?{,0x1000,rip,=,}{,0x2000,rip,=,}",
+	"3,rcx,=,rcx,?{,1,rcx,-=,1,rax,+=,0,GOTO,}",
+	"rax,rbx,<,cf,:=",
+	"rax,rbx,DUP,+,rcx,=,rbx,=",
+	"1,2,SWAP,-,rcx,=",
+	"16,rax,=,8,rax,~,rbx,=",
+	"0x1234,eax,=,ah,rbx,=",
+	"1,rax,+=,rax,0x13,==,$z,?{,BREAK,},1,rbx,+=",
+	"rsp,rax,=,rax",
+	"foo,bar",
+	NULL
+};
+
+static char *run_exprs(bool nocompile) {
+	RzAnalysis *analysis = rz_analysis_new ();
+	rz_analysis_use (analysis, "x86");
+	rz_analysis_set_bits (analysis, 64);
+	rz_analysis_set_reg_profile (analysis);
+	RzAnalysisEsil *esil = rz_analysis_esil_new (4096, 0, 1);
+	esil->analysis = analysis;
+	esil->nocompile = nocompile;
+	RzStrBuf *sb = rz_strbuf_new ("");
+	int i, round;
+	for (round = 0; round < 3; round++) {
+		for (i = 0; exprs[i]; i++) {
+			bool ret = rz_analysis_esil_parse (esil, exprs[i]);
+			char *top = rz_analysis_esil_pop (esil);
+			rz_strbuf_appendf (sb, "%d %s rax=0x%" PFMT64x " rbx=0x%" PFMT64x " rcx=0x%" PFMT64x " rip=0x%" PFMT64x " zf=%d cf=%d\n",
+				ret, top? top: "-",
+				rz_reg_getv (analysis->reg, "rax"), rz_reg_getv (analysis->reg, "rbx"),
+				rz_reg_getv (analysis->reg, "rcx"), rz_reg_getv (analysis->reg, "rip"),
+				(int)rz_reg_getv (analysis->reg, "zf"), (int)rz_reg_getv (analysis->reg, "cf"));
+			free (top);
+			rz_analysis_esil_stack_free (esil);
+		}
+		// the register items are replaced, compiled code must not use the old ones
+		rz_analysis_set_reg_profile (analysis);
+	}
+	rz_analysis_esil_free (esil);
+	rz_analysis_free (analysis);
+	return rz_strbuf_drain (sb);
+}
+
+bool test_esil_compiled(void) {
+	char *string = run_exprs (true);
+	char *compiled = run_exprs (false);
+	mu_assert_streq (compiled, string, "compiled code must behave as the string parser");
+	free (string);
+	free (compiled);
+	mu_end;
+}
+
+bool test_esil_compile(void) {
+	RzAnalysis *analysis = rz_analysis_new ();
+	rz_analysis_use (analysis, "x86");
+	rz_analysis_set_bits (analysis, 64);
+	rz_analysis_set_reg_profile (analysis);
+	RzAnalysisEsil *esil = rz_analysis_esil_new (4096, 0, 1);
+	esil->analysis = analysis;
+
+	RzAnalysisEsilCode *code = rz_analysis_esil_compile (esil, "0x28,rsp,-=,rsp,rax,=");
+	mu_assert_notnull (code, "compiled");
+	mu_assert_eq (code->count, 5, "words");
+	mu_assert_null (rz_analysis_esil_compile (esil, "1,rax,=;2,rbx,="), "';' is left to the parser");
+	mu_assert_null (rz_analysis_esil_compile (esil, "1,,rax,="), "empty words are left to the parser");
+
+	rz_reg_setv (analysis->reg, "rax", 0);
+	rz_reg_setv (analysis->reg, "rsp", 0x1000);
+	mu_assert_true (rz_analysis_esil_run (esil, code), "run");
+	mu_assert_eq (rz_reg_getv (analysis->reg, "rsp"), 0xfd8, "rsp");
+	mu_assert_eq (rz_reg_getv (analysis->reg, "rax"), 0xfd8, "rax");
+	mu_assert_eq (esil->stackptr, 0, "stack");
+	rz_analysis_esil_code_free (code);
+
+	rz_analysis_esil_free (esil);
+	rz_analysis_free (analysis);
+	mu_end;
+}
+
+int main(int argc, char **argv) {
+	mu_run_test (test_esil_compiled);
+	mu_run_test (test_esil_compile);
+	return tests_passed != tests_run;
+}
@@ -0,0 +1,132 @@
+#include <rz_hash.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#define DATA_SIZE 100003
+
+static ut8 *data;
+
+static void data_init(void) {
+	size_t i;
+	data = malloc (DATA_SIZE);
+	for (i = 0; i < DATA_SIZE; i++) {
+		data[i] = (i * 2654435761u) >> 13;
+	}
+}
+
+static bool check_digest(ut8 *(*fn)(RzHash *, const ut8 *, int), ut64 bit, const ut8 *buf, int len, const char *hex, const char *msg) {
+	ut8 expect[64];
+	int size = rz_hex_str2bin (hex, expect);
+	RzHash *ctx = rz_hash_new (true, bit);
+	const ut8 *actual = fn (ctx, buf, len);
+	mu_assert_memeq (actual, expect, size, msg);
+	rz_hash_free (ctx);
+	return true;
+}
+
+static bool test_hash_sha1(void) {
+	const char *abc = "abc";
+	const char *abc448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	mu_assert_true (check_digest (rz_hash_do_sha1, RZ_HASH_SHA1, (const ut8 *)abc, 3,
+				"a9993e364706816aba3e25717850c26c9cd0d89d", "abc"),
+		"sha1 abc");
+	mu_assert_true (check_digest (rz_hash_do_sha1, RZ_HASH_SHA1, (const ut8 *)abc448, strlen (abc448),
+				"84983e441c3bd26ebaae4aa1f95129e5e54670f1", "448 bits"),
+		"sha1 448 bits");
+	ut8 *a = malloc (1000000);
+	memset (a, 'a', 1000000);
+	mu_assert_true (check_digest (rz_hash_do_sha1, RZ_HASH_SHA1, a, 1000000,
+				"34aa973cd4c4daa4f61eeb2bdbad27316534016f", "million a"),
+		"sha1 million a");
+	free (a);
+	mu_end;
+}
+
+static bool test_hash_sha256(void) {
+	const char *abc = "abc";
+	const char *abc448 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	mu_assert_true (check_digest (rz_hash_do_sha256, RZ_HASH_SHA256, (const ut8 *)abc, 3,
+				"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", "abc"),
+		"sha256 abc");
+	mu_assert_true (check_digest (rz_hash_do_sha256, RZ_HASH_SHA256, (const ut8 *)abc448, strlen (abc448),
+				"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", "448 bits"),
+		"sha256 448 bits");
+	ut8 *a = malloc (1000000);
+	memset (a, 'a', 1000000);
+	mu_assert_true (check_digest (rz_hash_do_sha256, RZ_HASH_SHA256, a, 1000000,
+				"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", "million a"),
+		"sha256 million a");
+	free (a);
+	mu_end;
+}
+
+// Feeds data to fn in updates of step bytes and returns the final digest
+static const ut8 *digest_split(RzHash *ctx, ut8 *(*fn)(RzHash *, const ut8 *, int), ut64 bit, int step) {
+	int off = 0;
+	rz_hash_do_begin (ctx, bit);
+	while (off < DATA_SIZE) {
+		int n = RZ_MIN (step, DATA_SIZE - off);
+		fn (ctx, data + off, n);
+		off += n;
+	}
+	rz_hash_do_end (ctx, bit);
+	return ctx->digest;
+}
+
+static bool test_hash_sha_split(void) {
+	// the same digest whichever way the input is cut into updates
+	static const int steps[] = { 1, 3, 63, 64, 65, 1000, DATA_SIZE };
+	ut8 sha1[RZ_HASH_SIZE_SHA1], sha256[RZ_HASH_SIZE_SHA256];
+	RzHash *one = rz_hash_new (true, RZ_HASH_SHA1 | RZ_HASH_SHA256);
+	memcpy (sha1, rz_hash_do_sha1 (one, data, DATA_SIZE), sizeof (sha1));
+	memcpy (sha256, rz_hash_do_sha256 (one, data, DATA_SIZE), sizeof (sha256));
+	rz_hash_free (one);
+	int i;
+	for (i = 0; i < RZ_ARRAY_SIZE (steps); i++) {
+		RzHash *ctx = rz_hash_new (false, RZ_HASH_SHA1 | RZ_HASH_SHA256);
+		mu_assert_memeq (digest_split (ctx, rz_hash_do_sha1, RZ_HASH_SHA1, steps[i]), sha1, sizeof (sha1), "sha1 split");
+		mu_assert_memeq (digest_split (ctx, rz_hash_do_sha256, RZ_HASH_SHA256, steps[i]), sha256, sizeof (sha256), "sha256 split");
+		rz_hash_free (ctx);
+	}
+	mu_end;
+}
+
+static bool test_hash_crc(void) {
+	// computed with the bitwise implementation, crc32 also matches zlib
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_8_SMBUS), 0xc7, "crc8");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_15_CAN), 0x75f5, "crc15");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_16), 0xccb5, "crc16");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_16_CITT), 0xdbc8, "crc16 citt");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_24), 0xaba88c, "crc24");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_32), 0x732376ce, "crc32");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_32C), 0x89ba2ae8, "crc32c");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_CRC64), 0x15a4eab9b24a9c8bULL, "crc64");
+	mu_assert_eq (rz_hash_crc_preset (data, DATA_SIZE, CRC_PRESET_CRC64_XZ), 0x49842a7fc7e872bfULL, "crc64 xz");
+	mu_assert_eq (rz_hash_crc_preset ((const ut8 *)"123456789", 9, CRC_PRESET_32), 0xcbf43926, "crc32 check");
+	mu_end;
+}
+
+static bool test_hash_checksums(void) {
+	mu_assert_eq (rz_hash_adler32 (data, DATA_SIZE), 0x4df49874, "adler32");
+	mu_assert_eq (rz_hash_adler32 ((const ut8 *)"Wikipedia", 9), 0x11e60398, "adler32 wikipedia");
+	mu_assert_eq (rz_hash_fletcher32 (data, DATA_SIZE), 0xa6653530, "fletcher32 odd");
+	mu_assert_eq (rz_hash_fletcher32 (data, DATA_SIZE - 1), 0x7135343b, "fletcher32 even");
+	mu_assert_eq (rz_hash_fletcher64 (data, DATA_SIZE), 0xad4d63b216f1ed6dULL, "fletcher64 tail");
+	mu_assert_eq (rz_hash_fletcher64 (data, DATA_SIZE - 2), 0xac582ab215fcb46dULL, "fletcher64 tail 1");
+	mu_end;
+}
+
+int all_tests() {
+	data_init ();
+	mu_run_test (test_hash_sha1);
+	mu_run_test (test_hash_sha256);
+	mu_run_test (test_hash_sha_split);
+	mu_run_test (test_hash_crc);
+	mu_run_test (test_hash_checksums);
+	free (data);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,120 @@
+#include <rz_hash.h>
+#include <rz_util.h>
+#include "minunit.h"
+
+#define DATA_SIZE (3 * 1024 * 1024 + 123)
+
+static ut8 *data;
+
+static int data_read(void *user, ut64 addr, ut8 *buf, int len) {
+	memcpy (buf, data + addr, len);
+	return len;
+}
+
+static void data_init(void) {
+	size_t i;
+	data = malloc (DATA_SIZE);
+	for (i = 0; i < DATA_SIZE; i++) {
+		data[i] = (i * 2654435761u) >> 13;
+	}
+}
+
+// Checks the result of every algorithm of mh against a single rz_hash_calculate ()
+static bool check_results(RzHashMulti *mh, ut64 bits, ut64 from, ut64 to, bool streamable_only) {
+	ut64 bit;
+	for (bit = 1; bit < RZ_HASH_ALL; bit <<= 1) {
+		if (!(bits & bit) || !*rz_hash_name (bit)) {
+			continue;
+		}
+		if (streamable_only && !rz_hash_multi_streamable (bit)) {
+			continue;
+		}
+		RzHash *expect = rz_hash_new (true, bit);
+		rz_hash_do_begin (expect, bit);
+		int size = rz_hash_calculate (expect, bit, data + from, to - from);
+		rz_hash_do_end (expect, bit);
+		RzHash *actual = rz_hash_multi_get (mh, bit);
+		mu_assert_notnull (actual, "algorithm result");
+		char msg[64];
+		snprintf (msg, sizeof (msg), "%s digest", rz_hash_name (bit));
+		mu_assert_memeq (actual->digest, expect->digest, size, msg);
+		mu_assert (msg, actual->entropy == expect->entropy);
+		rz_hash_free (expect);
+	}
+	return true;
+}
+
+static bool test_hash_multi_stream(void) {
+	ut64 bits = rz_hash_name_to_bits ("all");
+	RzHashMulti *mh = rz_hash_multi_new (bits, 4);
+	mu_assert_notnull (mh, "multi");
+	mu_assert_true (rz_hash_multi_stream (mh, data_read, NULL, 17, DATA_SIZE, 100000), "stream");
+	rz_hash_multi_end (mh);
+	mu_assert_true (check_results (mh, bits, 17, DATA_SIZE, true), "streamable results");
+
+	// a single block gives the same as before for everything
+	rz_hash_multi_begin (mh);
+	mu_assert_true (rz_hash_multi_stream (mh, data_read, NULL, 0, DATA_SIZE, DATA_SIZE), "stream");
+	rz_hash_multi_end (mh);
+	mu_assert_true (check_results (mh, bits, 0, DATA_SIZE, false), "all results");
+	rz_hash_multi_free (mh);
+	mu_end;
+}
+
+static bool test_hash_multi_streamable(void) {
+	mu_assert_true (rz_hash_multi_streamable (rz_hash_name_to_bits ("md5,sha512,crc32,xxhash,entropy")), "streamable");
+	mu_assert_false (rz_hash_multi_streamable (rz_hash_name_to_bits ("md5,adler32")), "adler32");
+	mu_end;
+}
+
+static ut64 blocks_addr;
+static int blocks_bad;
+
+static void block_check(void *user, ut64 addr, int len, ut64 algo, RzHash *ctx) {
+	if (algo == RZ_HASH_MD5) {
+		// results come in address order
+		blocks_bad += addr != blocks_addr;
+		blocks_addr += len;
+	}
+	RzHash *expect = rz_hash_new (true, algo);
+	int size = rz_hash_calculate (expect, algo, data + addr, len);
+	blocks_bad += memcmp (expect->digest, ctx->digest, size) != 0;
+	rz_hash_free (expect);
+}
+
+static bool test_hash_multi_blocks(void) {
+	RzHashMulti *mh = rz_hash_multi_new (RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_CRC32 | RZ_HASH_ADLER32, 4);
+	blocks_addr = 0x10;
+	blocks_bad = 0;
+	mu_assert_true (rz_hash_multi_blocks (mh, data_read, NULL, 0x10, DATA_SIZE, 4096, block_check, NULL), "blocks");
+	mu_assert_eq (blocks_addr, DATA_SIZE, "all blocks");
+	mu_assert_eq (blocks_bad, 0, "block results");
+	rz_hash_multi_free (mh);
+	mu_end;
+}
+
+static bool test_hash_multi_small_blocks(void) {
+	// tiny blocks take several batches, bounded by their contexts
+	RzHashMulti *mh = rz_hash_multi_new (RZ_HASH_MD5 | RZ_HASH_SHA1 | RZ_HASH_CRC32 | RZ_HASH_ADLER32, 4);
+	blocks_addr = 0x10;
+	blocks_bad = 0;
+	mu_assert_true (rz_hash_multi_blocks (mh, data_read, NULL, 0x10, 0x10010, 3, block_check, NULL), "blocks");
+	mu_assert_eq (blocks_addr, 0x10010, "all blocks");
+	mu_assert_eq (blocks_bad, 0, "block results");
+	rz_hash_multi_free (mh);
+	mu_end;
+}
+
+int all_tests() {
+	data_init ();
+	mu_run_test (test_hash_multi_stream);
+	mu_run_test (test_hash_multi_streamable);
+	mu_run_test (test_hash_multi_blocks);
+	mu_run_test (test_hash_multi_small_blocks);
+	free (data);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
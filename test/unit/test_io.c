@@ -50,6 +50,69 @@ bool test_rz_io_cache(void) {
 	mu_end;
 }
 
+bool test_rz_io_cache_invalidate(void) {
+	RzIO *io = rz_io_new ();
+	rz_io_open (io, "malloc://15", RZ_PERM_RW, 0);
+	rz_io_write (io, (ut8 *)"ZZZZZZZZZZZZZZZ", 15);
+	mu_assert_true (rz_io_cache_write (io, 0, (ut8 *)"AAAAA", 5), "Cache write at 0 failed");
+	mu_assert_true (rz_io_cache_write (io, 4, (ut8 *)"BBBB", 4), "Overlapped cache write at 4 failed");
+	mu_assert_true (rz_io_cache_write (io, 10, (ut8 *)"CC", 2), "Cache write at 10 failed");
+	io->cached = RZ_PERM_R;
+	// the whole write touching the range is undone, the older one shows again
+	mu_assert_eq (rz_io_cache_invalidate (io, 6, 7), 1, "one write should be invalidated");
+	ut8 buf[15];
+	memset (buf, 'Y', sizeof (buf));
+	rz_io_read_at (io, 0, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"AAAAAZZZZZCCZZZ", sizeof (buf), "IO read after cache invalidate doesn't match expected output");
+	mu_assert_true (rz_io_cache_at (io, 4), "Byte of the older write should still be cached");
+	mu_assert_false (rz_io_cache_at (io, 6), "Invalidated byte shouldn't be cached");
+	// committed bytes are written back when invalidated, only in the range
+	rz_io_cache_commit (io, 0, 3);
+	io->cached = 0;
+	rz_io_read_at (io, 0, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"AAAZZZZZZZZZZZZ", sizeof (buf), "IO read after partial commit doesn't match expected output");
+	mu_assert_eq (rz_io_cache_invalidate (io, 0, 1), 1, "one write should be invalidated");
+	rz_io_read_at (io, 0, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"ZZZZZZZZZZZZZZZ", sizeof (buf), "IO read after invalidating a commit doesn't match expected output");
+	io->cached = RZ_PERM_R;
+	rz_io_read_at (io, 0, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"ZZZZZZZZZZCCZZZ", sizeof (buf), "IO read with cache after invalidate doesn't match expected output");
+	rz_io_free (io);
+	mu_end;
+}
+
+static bool count_ranges_cb(void *user, const RzIOCache *range) {
+	(*(int *)user)++;
+	return true;
+}
+
+bool test_rz_io_cache_coalesce(void) {
+	RzIO *io = rz_io_new ();
+	rz_io_open (io, "malloc://0x2000", RZ_PERM_RW, 0);
+	int i, ranges = 0;
+	for (i = 0; i < 0x20; i++) {
+		ut8 b = i;
+		mu_assert_true (rz_io_cache_write (io, 0xff0 + i, &b, 1), "Cache write failed");
+	}
+	mu_assert_true (rz_io_cache_write (io, 0x1800, (ut8 *)"AB", 2), "Cache write failed");
+	rz_io_cache_foreach (io, count_ranges_cb, &ranges);
+	mu_assert_eq (ranges, 2, "adjacent writes across pages should be a single range");
+	mu_assert_true (rz_io_cache_push (io), "Cache push failed");
+	mu_assert_true (rz_io_cache_write (io, 0x1801, (ut8 *)"CD", 2), "Cache write failed");
+	ut8 buf[4] = { 0 };
+	rz_io_cache_read (io, 0x1800, buf, 3);
+	mu_assert_memeq (buf, (ut8 *)"ACD", 3, "overlapping write should be merged");
+	mu_assert_true (rz_io_cache_pop (io), "Cache pop failed");
+	memset (buf, 0, sizeof (buf));
+	rz_io_cache_read (io, 0x1800, buf, 3);
+	mu_assert_memeq (buf, (ut8 *)"AB\x00", 3, "pop should restore the pushed cache");
+	mu_assert_eq (rz_io_cache_invalidate (io, 0x1000, 0x2000), 0x11, "only the writes in the range should be undone");
+	mu_assert_false (rz_io_cache_at (io, 0x1800), "invalidated byte should not be cached");
+	mu_assert_true (rz_io_cache_at (io, 0xfff), "byte before the range should still be cached");
+	rz_io_free (io);
+	mu_end;
+}
+
 bool test_rz_io_mapsplit (void) {
 	RzIO *io = rz_io_new ();
 	io->va = true;
@@ -261,8 +324,89 @@ bool test_rz_io_priority2(void) {
 	mu_end;
 }
 
+bool test_rz_io_page_cache(void) {
+	RzIO *io = rz_io_new ();
+	ut8 buf[8];
+	io->va = true;
+	io->ff = true;
+	io->Oxff = 0xff;
+	RzIODesc *desc = rz_io_open_at (io, "malloc://0x3000", RZ_PERM_RW, 0644, 0x1000);
+	mu_assert_notnull (desc, "malloc should be opened");
+	rz_io_write_at (io, 0x1ffc, (const ut8 *)"AAAABBBB", 8);
+	mu_assert_true (rz_io_page_cache_resize (io, 2 * RZ_IO_PAGE_CACHE_PAGE_SIZE), "page cache should be allocated");
+
+	rz_io_read_at (io, 0x1ffc, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"AAAABBBB", sizeof (buf), "read across two pages");
+	mu_assert_eq (io->page_cache.misses, 2, "both pages should have been missed");
+	rz_io_read_at (io, 0x1ffe, buf, 4);
+	mu_assert_memeq (buf, (ut8 *)"AABB", 4, "cached read across two pages");
+	mu_assert_eq (io->page_cache.hits, 2, "both pages should have been hit");
+
+	rz_io_write_at (io, 0x2000, (const ut8 *)"CC", 2);
+	rz_io_read_at (io, 0x1ffc, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"AAAACCBB", sizeof (buf), "write should invalidate the page");
+
+	rz_io_read_at (io, 0x3ffc, buf, sizeof (buf));
+	mu_assert_memeq (buf, (ut8 *)"\x00\x00\x00\x00\xff\xff\xff\xff", sizeof (buf), "read past the end of the desc");
+	mu_assert_eq (io->page_cache.used, 2, "only two pages fit in the cache");
+
+	rz_io_desc_close (desc);
+	mu_assert_eq (io->page_cache.used, 0, "closing the desc should drop its pages");
+	rz_io_free (io);
+	mu_end;
+}
+
+static int batch_calls = 0;
+
+static int test_read_batch(RzIO *io, RzIODesc *desc, RzIOBatchRead *reqs, int count) {
+	int i, complete = 0;
+	batch_calls++;
+	for (i = 0; i < count; i++) {
+		reqs[i].ret = rz_io_plugin_read_at (desc, reqs[i].addr, reqs[i].buf, reqs[i].len);
+		complete += reqs[i].ret == reqs[i].len;
+	}
+	return complete;
+}
+
+bool test_rz_io_read_batch(void) {
+	RzIO *io = rz_io_new ();
+	ut8 a[4], b[4], c[4], d[4];
+	io->va = true;
+	io->ff = true;
+	io->Oxff = 0xff;
+	RzIODesc *desc = rz_io_open_at (io, "malloc://0x2000", RZ_PERM_RW, 0644, 0x1000);
+	mu_assert_notnull (desc, "malloc should be opened");
+	rz_io_write_at (io, 0x1000, (const ut8 *)"AAAA", 4);
+	rz_io_write_at (io, 0x2ffe, (const ut8 *)"BBCC", 2);
+	RzIOPlugin *plugin = desc->plugin;
+	RzIOPlugin batch_plugin = *plugin;
+	batch_plugin.read_batch = test_read_batch;
+	desc->plugin = &batch_plugin;
+
+	RzIOBatchRead reqs[] = {
+		{ 0x1000, a, 4 },
+		{ 0x2ffe, b, 4 }, // crosses the end of the map
+		{ 0x1000, c, 4 },
+		{ 0x8000, d, 4 }, // unmapped
+	};
+	int complete = rz_io_read_batch (io, reqs, 4);
+	mu_assert_eq (complete, 2, "two requests should be complete");
+	mu_assert_eq (batch_calls, 1, "mapped ranges should be read with one plugin call");
+	mu_assert_memeq (a, (ut8 *)"AAAA", 4, "first range");
+	mu_assert_memeq (c, (ut8 *)"AAAA", 4, "third range");
+	mu_assert_eq (reqs[1].ret, 2, "read prefix of the range crossing the end of the map");
+	mu_assert_memeq (b, (ut8 *)"BB\xff\xff", 4, "unmapped tail should be 0xff");
+	mu_assert_eq (reqs[3].ret, 0, "nothing read from unmapped memory");
+
+	desc->plugin = plugin;
+	rz_io_free (io);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_rz_io_cache);
+	mu_run_test(test_rz_io_cache_invalidate);
+	mu_run_test(test_rz_io_cache_coalesce);
 	mu_run_test(test_rz_io_mapsplit);
 	mu_run_test(test_rz_io_mapsplit2);
 	mu_run_test(test_rz_io_mapsplit3);
@@ -271,6 +415,8 @@ int all_tests() {
 	mu_run_test(test_rz_io_priority);
 	mu_run_test(test_rz_io_priority2);
 	mu_run_test(test_va_malloc_zero);
+	mu_run_test(test_rz_io_page_cache);
+	mu_run_test(test_rz_io_read_batch);
 	return tests_passed != tests_run;
 }
 
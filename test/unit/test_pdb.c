@@ -57,11 +57,20 @@ bool test_pdb_tpi_cpp(void) {
 	mu_assert_eq (tpi_stream->header.idx_begin, 0x1000, "Wrong beginning index");
 
 	// tpi_stream->header.
-	mu_assert_eq (tpi_stream->types->length, 1148, "Incorrect number of types");
-	RzListIter *it = rz_list_iterator (tpi_stream->types);
+	mu_assert_eq (tpi_stream->types_count, 1148, "Incorrect number of types");
 	SType *type;
-	while (rz_list_iter_next (it)) {
-		type = rz_list_iter_get (it);
+	// the records are parsed on demand
+	mu_assert_null (tpi_stream->types[0x1028 - 0x1000], "Type parsed before use");
+	mu_assert_eq (tpi_stream->get_leaf_type (tpi_stream, 0x1028), eLF_PROCEDURE, "Incorrect leaf type");
+	mu_assert_null (tpi_stream->types[0x1028 - 0x1000], "Type parsed by leaf type");
+	type = tpi_stream->get_type (tpi_stream, 0x1028);
+	mu_assert_notnull (type, "Type not parsed");
+	mu_assert_ptreq (tpi_stream->get_type (tpi_stream, 0x1028), type, "Type parsed twice");
+	mu_assert_null (tpi_stream->get_type (tpi_stream, 0x1000 + 1148), "Type out of the stream");
+	ut32 idx;
+	for (idx = tpi_stream->header.idx_begin; idx < tpi_stream->header.idx_begin + tpi_stream->types_count; idx++) {
+		type = tpi_stream->get_type (tpi_stream, idx);
+		mu_assert_notnull (type, "Type not parsed");
 		STypeInfo *type_info = &type->type_data;
 		if (type->tpi_idx == 0x1028) {
 			mu_assert_eq (type_info->leaf_type, eLF_PROCEDURE, "Incorrect data type");
@@ -266,11 +275,12 @@ bool test_pdb_tpi_rust(void) {
 	mu_assert_eq (tpi_stream->header.idx_begin, 0x1000, "Wrong beginning index");
 
 	// tpi_stream->header.
-	mu_assert_eq (tpi_stream->types->length, 4031, "Incorrect number of types");
-	RzListIter *it = rz_list_iterator (tpi_stream->types);
+	mu_assert_eq (tpi_stream->types_count, 4031, "Incorrect number of types");
 	SType *type;
-	while (rz_list_iter_next (it)) {
-		type = rz_list_iter_get (it);
+	ut32 idx;
+	for (idx = tpi_stream->header.idx_begin; idx < tpi_stream->header.idx_begin + tpi_stream->types_count; idx++) {
+		type = tpi_stream->get_type (tpi_stream, idx);
+		mu_assert_notnull (type, "Type not parsed");
 		STypeInfo *type_info = &type->type_data;
 		if (type->tpi_idx == 0x101B) {
 			mu_assert_eq (type_info->leaf_type, eLF_PROCEDURE, "Incorrect data type");
@@ -19,8 +19,34 @@ bool test_pj_reset() {
 	mu_end;
 }
 
+static void pj_flush_cb(const char *buf, size_t len, void *user) {
+	rz_strbuf_append_n (user, buf, len);
+}
+
+bool test_pj_flush() {
+	RzStrBuf *out = rz_strbuf_new ("");
+	PJ *j = pj_new ();
+	pj_set_flush (j, 8, pj_flush_cb, out);
+	pj_a (j);
+	int i;
+	for (i = 0; i < 4; i++) {
+		pj_o (j);
+		pj_kn (j, "n", i);
+		pj_end (j);
+		mu_assert ("bounded buffer", strlen (pj_string (j)) < 16);
+	}
+	pj_end (j);
+	mu_assert ("flushed", rz_strbuf_length (out) > 0);
+	rz_strbuf_append (out, pj_string (j));
+	mu_assert_streq (rz_strbuf_get (out), "[{\"n\":0},{\"n\":1},{\"n\":2},{\"n\":3}]", "whole document");
+	pj_free (j);
+	rz_strbuf_free (out);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test (test_pj_reset);
+	mu_run_test (test_pj_flush);
 	return tests_passed != tests_run;
 }
 
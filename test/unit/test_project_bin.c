@@ -0,0 +1,194 @@
+#include <rz_project.h>
+#include "minunit.h"
+#include "test_sdb.h"
+
+static void setup(RzCore *core) {
+	RzAnalysis *analysis = core->analysis;
+	RzAnalysisBlock *ba = rz_analysis_create_block (analysis, 0x1000, 0x10);
+	ba->jump = 0x1010;
+	ba->fail = 0x1020;
+	ba->ninstr = 3;
+	ba->stackptr = -8;
+	ba->cmpreg = rz_str_constpool_get (&analysis->constpool, "rax");
+	RzAnalysisBlock *bb = rz_analysis_create_block (analysis, 0x1010, 0x8);
+	bb->folded = true;
+	RzAnalysisBlock *bc = rz_analysis_create_block (analysis, 0x2000, 0x4);
+	bc->colorize = 0x1337;
+	RzAnalysisFunction *fa = rz_analysis_create_function (analysis, "main", 0x1000, RZ_ANALYSIS_FCN_TYPE_FCN, NULL);
+	rz_analysis_function_add_block (fa, ba);
+	rz_analysis_function_add_block (fa, bb);
+	RzAnalysisFunction *fb = rz_analysis_create_function (analysis, "sym." PERTURBATOR, 0x2000, RZ_ANALYSIS_FCN_TYPE_SYM, NULL);
+	rz_analysis_function_add_block (fb, bc);
+	// blocks and functions hold the references now
+	rz_analysis_block_unref (ba);
+	rz_analysis_block_unref (bb);
+	rz_analysis_block_unref (bc);
+
+	rz_analysis_xrefs_set (analysis, 0x1004, 0x2000, RZ_ANALYSIS_REF_TYPE_CALL);
+	rz_analysis_xrefs_set (analysis, 0x2002, 0x3000, RZ_ANALYSIS_REF_TYPE_DATA);
+	rz_meta_set_string (analysis, RZ_META_TYPE_COMMENT, 0x1004, "call " PERTURBATOR);
+	rz_meta_set (analysis, RZ_META_TYPE_DATA, 0x3000, 4, NULL);
+
+	RzFlagItem *fi = rz_flag_set (core->flags, "main", 0x1000, 0);
+	rz_flag_item_set_comment (fi, "entry");
+	rz_flag_space_push (core->flags, "strings");
+	fi = rz_flag_set (core->flags, "str.hello", 0x3000, 6);
+	rz_flag_item_set_realname (fi, "hello");
+	rz_flag_space_pop (core->flags);
+}
+
+static ut8 *save_bin(RzCore *core, Sdb *db, ut64 *size) {
+	rz_project_save (core, db, NULL);
+	return rz_project_bin_from_sdb (db, size);
+}
+
+static bool test_project_bin_roundtrip(void) {
+	RzCore *core = rz_core_new ();
+	setup (core);
+	Sdb *expected = sdb_new0 ();
+	ut64 size = 0;
+	ut8 *buf = save_bin (core, expected, &size);
+	mu_assert_notnull (buf, "converted");
+	rz_core_free (core);
+
+	RzProjectErr err;
+	RzProjectBin *pb = rz_project_bin_new (buf, size, &err);
+	mu_assert_notnull (pb, "open");
+	mu_assert_eq (err, RZ_PROJECT_ERR_SUCCESS, "open err");
+
+	core = rz_core_new ();
+	err = rz_project_bin_load (core, pb, false, NULL, false, NULL);
+	mu_assert_eq (err, RZ_PROJECT_ERR_SUCCESS, "load");
+
+	// config and offset are touched by loading, the tables must be the same
+	Sdb *actual = sdb_new0 ();
+	rz_project_save (core, actual, NULL);
+	Sdb *core_actual = sdb_ns (actual, "core", false);
+	Sdb *core_expected = sdb_ns (expected, "core", false);
+	assert_sdb_eq (sdb_ns (core_actual, "analysis", false), sdb_ns (core_expected, "analysis", false), "analysis round trip");
+	assert_sdb_eq (sdb_ns (core_actual, "flags", false), sdb_ns (core_expected, "flags", false), "flags round trip");
+
+	free (buf);
+	sdb_free (expected);
+	sdb_free (actual);
+	rz_core_free (core);
+	mu_end;
+}
+
+static bool test_project_bin_range(void) {
+	RzCore *core = rz_core_new ();
+	setup (core);
+	Sdb *db = sdb_new0 ();
+	ut64 size = 0;
+	ut8 *buf = save_bin (core, db, &size);
+	sdb_free (db);
+	rz_core_free (core);
+
+	RzProjectBin *pb = rz_project_bin_new (buf, size, NULL);
+	mu_assert_notnull (pb, "open");
+	RzAnalysis *analysis = rz_analysis_new ();
+	RzFlag *flag = rz_flag_new ();
+
+	mu_assert_true (rz_project_bin_load_range (pb, analysis, flag, RZ_PROJECT_BIN_ALL, 0x2000, 0x2fff, NULL), "load range");
+	mu_assert_eq (rz_list_length (analysis->fcns), 1, "one function");
+	RzAnalysisFunction *f = rz_analysis_get_function_at (analysis, 0x2000);
+	mu_assert_notnull (f, "function");
+	mu_assert_streq (f->name, "sym." PERTURBATOR, "function name");
+	mu_assert_eq (rz_list_length (f->bbs), 1, "function blocks");
+	mu_assert_null (rz_analysis_get_block_at (analysis, 0x1000), "other blocks not loaded");
+	mu_assert_eq (rz_analysis_xrefs_count (analysis), 1, "xrefs");
+	mu_assert_null (rz_flag_get (flag, "main"), "flag out of range");
+
+	mu_assert_true (rz_project_bin_load_range (pb, analysis, flag, RZ_PROJECT_BIN_FUNCTIONS | RZ_PROJECT_BIN_FLAGS, 0, 0x1fff, NULL), "load range");
+	mu_assert_eq (rz_list_length (analysis->fcns), 2, "two functions");
+	RzAnalysisBlock *block = rz_analysis_get_block_at (analysis, 0x1000);
+	mu_assert_notnull (block, "block");
+	mu_assert_eq (block->ref, 1, "block ref");
+	mu_assert_eq (block->jump, 0x1010, "block jump");
+	mu_assert_eq (block->stackptr, -8, "block stackptr");
+	mu_assert_streq (block->cmpreg, "rax", "block cmpreg");
+	mu_assert_true (rz_analysis_get_block_at (analysis, 0x1010)->folded, "block folded");
+	RzFlagItem *fi = rz_flag_get (flag, "main");
+	mu_assert_notnull (fi, "flag");
+	mu_assert_streq (fi->comment, "entry", "flag comment");
+	mu_assert_null (rz_meta_get_string (analysis, RZ_META_TYPE_COMMENT, 0x1004), "meta not loaded");
+
+	// loading again does not duplicate anything
+	mu_assert_true (rz_project_bin_load_range (pb, analysis, flag, RZ_PROJECT_BIN_ALL, 0, UT64_MAX, NULL), "load all");
+	mu_assert_eq (rz_list_length (analysis->fcns), 2, "still two functions");
+	mu_assert_streq (rz_meta_get_string (analysis, RZ_META_TYPE_COMMENT, 0x1004), "call " PERTURBATOR, "meta");
+	fi = rz_flag_get (flag, "str.hello");
+	mu_assert_notnull (fi, "flag");
+	mu_assert_streq (fi->space->name, "strings", "flag space");
+	mu_assert_eq (fi->size, 6, "flag size");
+
+	rz_project_bin_free (pb);
+	rz_flag_free (flag);
+	rz_analysis_free (analysis);
+	free (buf);
+	mu_end;
+}
+
+static bool test_project_bin_lazy(void) {
+	RzCore *core = rz_core_new ();
+	setup (core);
+	Sdb *db = sdb_new0 ();
+	ut64 size = 0;
+	ut8 *buf = save_bin (core, db, &size);
+	sdb_free (db);
+	rz_core_free (core);
+
+	RzProjectBin *pb = rz_project_bin_new (buf, size, NULL);
+	mu_assert_notnull (pb, "open");
+	core = rz_core_new ();
+	mu_assert_eq (rz_project_bin_load (core, pb, false, NULL, true, NULL), RZ_PROJECT_ERR_SUCCESS, "load");
+	mu_assert_ptreq (core->prj_bin, pb, "kept on the core");
+	mu_assert_eq (rz_list_length (core->analysis->fcns), 0, "nothing at the seek");
+
+	// no maps, so only the block at the seek is loaded
+	rz_core_seek (core, 0x2000, false);
+	mu_assert_eq (rz_list_length (core->analysis->fcns), 1, "one function");
+	mu_assert_notnull (rz_analysis_get_function_at (core->analysis, 0x2000), "function at the seek");
+	mu_assert_null (rz_flag_get (core->flags, "main"), "flag not seeked to");
+
+	// saving needs everything
+	db = sdb_new0 ();
+	rz_project_save (core, db, NULL);
+	mu_assert_null (core->prj_bin, "dropped");
+	mu_assert_eq (rz_list_length (core->analysis->fcns), 2, "two functions");
+	mu_assert_notnull (rz_flag_get (core->flags, "main"), "flag");
+	mu_assert_streq (rz_meta_get_string (core->analysis, RZ_META_TYPE_COMMENT, 0x1004), "call " PERTURBATOR, "meta");
+
+	sdb_free (db);
+	rz_core_free (core);
+	free (buf);
+	mu_end;
+}
+
+static bool test_project_bin_invalid(void) {
+	ut8 buf[0x100] = { 0 };
+	RzProjectErr err;
+	mu_assert_null (rz_project_bin_new (buf, sizeof (buf), &err), "no magic");
+	mu_assert_eq (err, RZ_PROJECT_ERR_INVALID_TYPE, "no magic err");
+	memcpy (buf, "RZPB\x02\0\0\0", 8);
+	mu_assert_null (rz_project_bin_new (buf, sizeof (buf), &err), "newer");
+	mu_assert_eq (err, RZ_PROJECT_ERR_NEWER_VERSION, "newer err");
+	memcpy (buf, "RZPB\x01\0\0\0\x01\0\0\0", 12);
+	// strings section past the end
+	memcpy (buf + 16, "\0\0\0\0\x01\0\0\0\xf0\0\0\0\0\0\0\0\x20\0\0\0\0\0\0\0", 24);
+	mu_assert_null (rz_project_bin_new (buf, sizeof (buf), &err), "out of bounds");
+	mu_assert_eq (err, RZ_PROJECT_ERR_INVALID_CONTENTS, "out of bounds err");
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_project_bin_roundtrip);
+	mu_run_test (test_project_bin_range);
+	mu_run_test (test_project_bin_lazy);
+	mu_run_test (test_project_bin_invalid);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-3.0-only
+
+#include <rz_search.h>
+#include "minunit.h"
+
+static const ut8 buf[] = "zzAbCzzabczz\x12\x34\x56zz\x12\xff\x56zzabcabc";
+
+static char *find(RzSearch *s) {
+	RzStrBuf *sb = rz_strbuf_new ("");
+	RzList *hits = rz_search_find (s, 0x100, buf, sizeof (buf) - 1);
+	hits->free = free;
+	RzListIter *it;
+	RzSearchHit *hit;
+	rz_list_foreach (hits, it, hit) {
+		rz_strbuf_appendf (sb, "%d:0x%" PFMT64x " ", hit->kw->kwidx, hit->addr);
+	}
+	rz_list_free (hits);
+	return rz_strbuf_drain (sb);
+}
+
+bool test_search_keywords(void) {
+	RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+	rz_search_kw_add (s, rz_search_keyword_new_str ("abc", NULL, NULL, true));
+	rz_search_kw_add (s, rz_search_keyword_new_hex ("123456", "ff00ff", NULL));
+	rz_search_kw_add (s, rz_search_keyword_new_str ("abc", NULL, NULL, false));
+	rz_search_begin (s);
+	char *res = find (s);
+	mu_assert_streq (res, "0:0x102 0:0x107 0:0x116 1:0x10c 1:0x111 2:0x107 2:0x116 ", "hits");
+	free (res);
+	rz_search_free (s);
+	mu_end;
+}
+
+bool test_search_many_keywords(void) {
+	RzSearch *s = rz_search_new (RZ_SEARCH_KEYWORD);
+	int i;
+	for (i = 0; i < 1000; i++) {
+		char kw[16];
+		snprintf (kw, sizeof (kw), "%03dzz", i);
+		rz_search_kw_add (s, rz_search_keyword_new_str (kw, NULL, NULL, false));
+	}
+	rz_search_kw_add (s, rz_search_keyword_new_str ("cabc", NULL, NULL, false));
+	rz_search_kw_add (s, rz_search_keyword_new_str ("zz", NULL, NULL, false));
+	s->overlap = true;
+	rz_search_begin (s);
+	char *res = find (s);
+	mu_assert_streq (res, "1000:0x118 1001:0x100 1001:0x105 1001:0x10a 1001:0x10f 1001:0x114 ", "hits");
+	free (res);
+	rz_search_free (s);
+	mu_end;
+}
+
+int main(int argc, char **argv) {
+	mu_run_test (test_search_keywords);
+	mu_run_test (test_search_many_keywords);
+	return tests_passed != tests_run;
+}
@@ -0,0 +1,131 @@
+#include <rz_socket.h>
+#include <rz_util.h>
+#include <sys/socket.h>
+#include "minunit.h"
+
+// Returns a server side socket whose client end is in *client
+static RzSocket *connected_pair(int *client) {
+	int fds[2];
+	if (socketpair (AF_UNIX, SOCK_STREAM, 0, fds)) {
+		return NULL;
+	}
+	*client = fds[1];
+	return rz_socket_new_from_fd (fds[0]);
+}
+
+static char *read_all(int fd) {
+	char buf[1024];
+	int len = read (fd, buf, sizeof (buf) - 1);
+	if (len < 0) {
+		return NULL;
+	}
+	buf[len] = 0;
+	return strdup (buf);
+}
+
+static bool test_socket_http_pipelined(void) {
+	int client;
+	RzSocket *s = connected_pair (&client);
+	mu_assert_notnull (s, "socketpair");
+	const char *reqs =
+		"GET /cmd/pd HTTP/1.1\r\nHost: localhost\r\n\r\n"
+		"POST /up/a HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello"
+		"GET /last HTTP/1.1\r\nConnection: close\r\n\r\n";
+	mu_assert_eq (write (client, reqs, strlen (reqs)), strlen (reqs), "write");
+	RzSocketHTTPOptions so = { 0 };
+	so.keepalive = 1;
+
+	RzSocketHTTPRequest *rs = rz_socket_http_read (s, &so);
+	mu_assert_notnull (rs, "first request");
+	mu_assert_streq (rs->method, "GET", "method");
+	mu_assert_streq (rs->path, "/cmd/pd", "path");
+	mu_assert_streq (rs->host, "localhost", "host");
+	mu_assert_true (rs->http11, "http/1.1");
+	mu_assert_true (rs->keepalive, "kept alive by default");
+
+	rs = rz_socket_http_next (rs, &so);
+	mu_assert_notnull (rs, "second request");
+	mu_assert_streq (rs->method, "POST", "method");
+	mu_assert_eq (rs->data_length, 5, "body length");
+	mu_assert_streq ((char *)rs->data, "hello", "body");
+	mu_assert_true (rs->keepalive, "kept alive");
+
+	rs = rz_socket_http_next (rs, &so);
+	mu_assert_notnull (rs, "third request");
+	mu_assert_streq (rs->path, "/last", "path");
+	mu_assert_false (rs->keepalive, "closed by the client");
+	mu_assert_null (rz_socket_http_next (rs, &so), "no more requests");
+	close (client);
+	mu_end;
+}
+
+static bool test_socket_http_keepalive_off(void) {
+	int client;
+	RzSocket *s = connected_pair (&client);
+	mu_assert_notnull (s, "socketpair");
+	const char *req = "GET / HTTP/1.1\r\n\r\n";
+	write (client, req, strlen (req));
+	RzSocketHTTPOptions so = { 0 };
+	RzSocketHTTPRequest *rs = rz_socket_http_read (s, &so);
+	mu_assert_notnull (rs, "request");
+	mu_assert_false (rs->keepalive, "keepalive disabled in the options");
+	rz_socket_http_response (rs, 200, "ok", 0, NULL);
+	char *res = read_all (client);
+	mu_assert_streq (res, "HTTP/1.1 200 ok\r\nConnection: close\r\nContent-Length: 2\r\n\r\nok", "response");
+	free (res);
+	rz_socket_http_close (rs);
+	close (client);
+	mu_end;
+}
+
+static bool test_socket_http_chunked(void) {
+	int client;
+	RzSocket *s = connected_pair (&client);
+	mu_assert_notnull (s, "socketpair");
+	const char *req = "GET /cmd/x HTTP/1.1\r\n\r\n";
+	write (client, req, strlen (req));
+	RzSocketHTTPOptions so = { 0 };
+	so.keepalive = 1;
+	RzSocketHTTPRequest *rs = rz_socket_http_read (s, &so);
+	mu_assert_notnull (rs, "request");
+	rz_socket_http_response_begin (rs, 200, "Content-Type: text/plain\n");
+	rz_socket_http_chunk (rs, "hello ", 6);
+	rz_socket_http_chunk (rs, "", 0);
+	rz_socket_http_chunk (rs, "world, this is 0x10", 19);
+	rz_socket_http_response_end (rs);
+	char *res = read_all (client);
+	mu_assert_streq (res, "HTTP/1.1 200 ok\r\nContent-Type: text/plain\n"
+		"Connection: keep-alive\r\nTransfer-Encoding: chunked\r\n\r\n"
+		"6\r\nhello \r\n13\r\nworld, this is 0x10\r\n0\r\n\r\n", "chunked response");
+	free (res);
+	rz_socket_http_close (rs);
+
+	// HTTP/1.0 clients cannot parse chunks, they read until the connection closes
+	s = connected_pair (&client);
+	req = "GET /cmd/x HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+	write (client, req, strlen (req));
+	rs = rz_socket_http_read (s, &so);
+	mu_assert_notnull (rs, "request");
+	mu_assert_true (rs->keepalive, "http/1.0 keep-alive");
+	rz_socket_http_response_begin (rs, 200, "");
+	rz_socket_http_chunk (rs, "hello", 5);
+	rz_socket_http_response_end (rs);
+	mu_assert_false (rs->keepalive, "closed after an unframed body");
+	res = read_all (client);
+	mu_assert_streq (res, "HTTP/1.0 200 ok\r\nConnection: close\r\n\r\nhello", "unframed response");
+	free (res);
+	rz_socket_http_close (rs);
+	close (client);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test (test_socket_http_pipelined);
+	mu_run_test (test_socket_http_keepalive_off);
+	mu_run_test (test_socket_http_chunked);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}